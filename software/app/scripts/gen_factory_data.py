@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Sprchuoi
+# SPDX-License-Identifier: Apache-2.0
+#
+# Generate the Matter factory data record for one device
+#
+# The SPAKE2+ verifier (PBKDF2 + one P-256 scalar multiplication), the QR
+# code payload and the manual pairing code are computed here, once per
+# device on the production line, and written to factory_partition. The
+# firmware only validates and maps the record, so opening a commissioning
+# window does no key derivation.
+#
+# Record layout (little-endian, 228 bytes) must match FactoryRecord in
+# src/sdk/protocol/matter/commission/factory_data.hpp.
+#
+# Usage:
+#   ./gen_factory_data.py --passcode 20202021 --discriminator 3840 \
+#       --serial MLT-2025-0001 -o factory.bin [--hex 0xFF000]
+#   nrfjprog --program factory.hex --sectorerase --verify
+#
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = 0x3144464D          # "MFD1"
+VERSION = 1
+RECORD_SIZE = 228
+VERIFIER_LEN = 97
+MIN_ITERATIONS = 1000
+MAX_ITERATIONS = 100000
+
+# Matter core spec 5.1.7.1
+INVALID_PASSCODES = {0, 11111111, 22222222, 33333333, 44444444, 55555555,
+                     66666666, 77777777, 88888888, 99999999, 12345678, 87654321}
+
+# ---------------------------------------------------------------------------
+# SPAKE2+ verifier (Matter core spec 3.10)
+# ---------------------------------------------------------------------------
+
+P256_P = 0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF
+P256_A = P256_P - 3
+P256_N = 0xFFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551
+P256_G = (0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296,
+          0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5)
+
+
+def _point_add(p, q):
+    if p is None:
+        return q
+    if q is None:
+        return p
+    if p[0] == q[0] and (p[1] + q[1]) % P256_P == 0:
+        return None
+    if p == q:
+        lam = (3 * p[0] * p[0] + P256_A) * pow(2 * p[1], -1, P256_P)
+    else:
+        lam = (q[1] - p[1]) * pow(q[0] - p[0], -1, P256_P)
+    x = (lam * lam - p[0] - q[0]) % P256_P
+    return (x, (lam * (p[0] - x) - p[1]) % P256_P)
+
+
+def _point_mul(k, p):
+    result = None
+    while k:
+        if k & 1:
+            result = _point_add(result, p)
+        p = _point_add(p, p)
+        k >>= 1
+    return result
+
+
+def spake2p_verifier(passcode, salt, iterations):
+    ws = hashlib.pbkdf2_hmac('sha256', struct.pack('<I', passcode), salt, iterations, 80)
+    w0 = int.from_bytes(ws[:40], 'big') % P256_N
+    w1 = int.from_bytes(ws[40:], 'big') % P256_N
+    lx, ly = _point_mul(w1, P256_G)
+    return w0.to_bytes(32, 'big') + b'\x04' + lx.to_bytes(32, 'big') + ly.to_bytes(32, 'big')
+
+# ---------------------------------------------------------------------------
+# Onboarding payloads (Matter core spec 5.1.3 / 5.1.4)
+# ---------------------------------------------------------------------------
+
+BASE38 = '0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-.'
+
+
+def _base38(data):
+    out = ''
+    for i in range(0, len(data), 3):
+        chunk = data[i:i + 3]
+        value = int.from_bytes(chunk, 'little')
+        for _ in range({1: 2, 2: 4, 3: 5}[len(chunk)]):
+            out += BASE38[value % 38]
+            value //= 38
+    return out
+
+
+def qr_code(vid, pid, discriminator, passcode, discovery=0x02):
+    bits = 0
+    shift = 0
+    for value, width in ((0, 3), (vid, 16), (pid, 16), (0, 2),
+                         (discovery, 8), (discriminator, 12), (passcode, 27), (0, 4)):
+        bits |= value << shift
+        shift += width
+    return 'MT:' + _base38(bits.to_bytes(11, 'little'))
+
+
+_VERHOEFF_D = [
+    [0, 1, 2, 3, 4, 5, 6, 7, 8, 9], [1, 2, 3, 4, 0, 6, 7, 8, 9, 5],
+    [2, 3, 4, 0, 1, 7, 8, 9, 5, 6], [3, 4, 0, 1, 2, 8, 9, 5, 6, 7],
+    [4, 0, 1, 2, 3, 9, 5, 6, 7, 8], [5, 9, 8, 7, 6, 0, 4, 3, 2, 1],
+    [6, 5, 9, 8, 7, 1, 0, 4, 3, 2], [7, 6, 5, 9, 8, 2, 1, 0, 4, 3],
+    [8, 7, 6, 5, 9, 3, 2, 1, 0, 4], [9, 8, 7, 6, 5, 4, 3, 2, 1, 0]]
+_VERHOEFF_P = [
+    [0, 1, 2, 3, 4, 5, 6, 7, 8, 9], [1, 5, 7, 6, 2, 8, 3, 0, 9, 4],
+    [5, 8, 0, 3, 7, 9, 6, 1, 4, 2], [8, 9, 1, 6, 0, 4, 3, 5, 2, 7],
+    [9, 4, 5, 3, 1, 2, 6, 8, 7, 0], [4, 2, 8, 6, 5, 7, 3, 9, 0, 1],
+    [2, 7, 9, 3, 8, 0, 6, 4, 1, 5], [7, 0, 4, 6, 9, 1, 3, 2, 5, 8]]
+_VERHOEFF_INV = [0, 4, 3, 2, 1, 5, 6, 7, 8, 9]
+
+
+def _verhoeff(digits):
+    c = 0
+    for i, d in enumerate(reversed(digits)):
+        c = _VERHOEFF_D[c][_VERHOEFF_P[(i + 1) % 8][int(d)]]
+    return str(_VERHOEFF_INV[c])
+
+
+def manual_code(discriminator, passcode):
+    short = discriminator >> 8
+    code = '%d%05d%04d' % (short >> 2, ((short & 0x3) << 14) | (passcode & 0x3FFF), passcode >> 14)
+    return code + _verhoeff(code)
+
+# ---------------------------------------------------------------------------
+# Record
+# ---------------------------------------------------------------------------
+
+
+def build_record(args, salt, verifier, qr, manual):
+    body = struct.pack('<HHHBBII32s97s24s12s32s3x',
+                       args.vendor_id, args.product_id, args.discriminator,
+                       len(salt), len(verifier),
+                       0 if args.omit_passcode else args.passcode,
+                       args.iterations, salt, verifier,
+                       qr.encode(), manual.encode(), args.serial.encode())
+    crc = zlib.crc32(body) & 0xFFFFFFFF
+    record = struct.pack('<IHHI', MAGIC, VERSION, RECORD_SIZE, crc) + body
+    assert len(record) == RECORD_SIZE
+    return record
+
+
+def write_hex(path, data, base):
+    with open(path, 'w') as f:
+        def line(kind, addr, payload):
+            raw = bytes([len(payload), (addr >> 8) & 0xFF, addr & 0xFF, kind]) + payload
+            f.write(':%s%02X\n' % (raw.hex().upper(), (-sum(raw)) & 0xFF))
+        upper = None
+        for off in range(0, len(data), 16):
+            addr = base + off
+            if addr >> 16 != upper:
+                upper = addr >> 16
+                line(0x04, 0, struct.pack('>H', upper))
+            line(0x00, addr & 0xFFFF, data[off:off + 16])
+        line(0x01, 0, b'')
+
+
+def parse_int(text):
+    return int(text, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--passcode', type=parse_int, required=True)
+    parser.add_argument('--discriminator', type=parse_int, required=True)
+    parser.add_argument('--vendor-id', type=parse_int, default=0x235A)
+    parser.add_argument('--product-id', type=parse_int, default=0x0001)
+    parser.add_argument('--serial', default='MLT-2025-0001')
+    parser.add_argument('--iterations', type=parse_int, default=1000)
+    parser.add_argument('--salt', help='hex, 16-32 bytes (random if omitted)')
+    parser.add_argument('--omit-passcode', action='store_true',
+                        help='store only the verifier (production)')
+    parser.add_argument('-o', '--output', required=True, help='binary record')
+    parser.add_argument('--hex', type=parse_int, metavar='ADDRESS',
+                        help='also write <output>.hex at this flash address')
+    args = parser.parse_args()
+
+    if args.passcode in INVALID_PASSCODES or not 1 <= args.passcode <= 99999998:
+        sys.exit('invalid passcode %d' % args.passcode)
+    if not 0 <= args.discriminator <= 0xFFF:
+        sys.exit('discriminator must be 12 bits')
+    if not MIN_ITERATIONS <= args.iterations <= MAX_ITERATIONS:
+        sys.exit('iterations must be %d..%d' % (MIN_ITERATIONS, MAX_ITERATIONS))
+    if len(args.serial) >= 32:
+        sys.exit('serial number too long')
+
+    salt = bytes.fromhex(args.salt) if args.salt else os.urandom(32)
+    if not 16 <= len(salt) <= 32:
+        sys.exit('salt must be 16-32 bytes')
+
+    verifier = spake2p_verifier(args.passcode, salt, args.iterations)
+    qr = qr_code(args.vendor_id, args.product_id, args.discriminator, args.passcode)
+    manual = manual_code(args.discriminator, args.passcode)
+    record = build_record(args, salt, verifier, qr, manual)
+
+    with open(args.output, 'wb') as f:
+        f.write(record)
+    if args.hex is not None:
+        write_hex(os.path.splitext(args.output)[0] + '.hex', record, args.hex)
+
+    print('QR code:     %s' % qr)
+    print('Manual code: %s' % manual)
+    print('Record:      %d bytes -> %s' % (len(record), args.output))
+
+
+if __name__ == '__main__':
+    main()
@@ -42,8 +42,46 @@ static const struct gpio_dt_spec leds[] = {
 };
 #define NUM_LEDS 4
 
-/* LED state tracking */
-static bool led_state[NUM_LEDS] = {false, false, false, false};
+static_assert(smarthome::protocol::matter::LIGHT_ENDPOINT_COUNT == NUM_LEDS,
+	      "one light endpoint per LED");
+
+/**
+ * @brief Light endpoint output - drives the LEDs of changed endpoints
+ * @note Called from the button ISR as well. LEDs sharing a port change in
+ *       one masked write, so a group command or scene recall lights them
+ *       together. The LEDs have no PWM: any level shows as on. A board
+ *       with warm/cool PWM channels takes its duties from
+ *       ColorTemperature::mix(attrs[i]).
+ */
+static void on_light_output(const smarthome::protocol::matter::LightAttributes *attrs,
+			    uint32_t changed_mask)
+{
+	gpio_port_pins_t mask = 0;
+	gpio_port_value_t value = 0;
+
+	for (int i = 0; i < NUM_LEDS; i++) {
+		if (!(changed_mask & BIT(i))) {
+			continue;
+		}
+
+		bool lit = attrs[i].on_off && attrs[i].current_level > 0;
+		if (leds[i].port != leds[0].port) {
+			gpio_pin_set_dt(&leds[i], lit ? 1 : 0);
+			continue;
+		}
+
+		/* Raw write: apply GPIO_ACTIVE_LOW as gpio_pin_set_dt() would */
+		bool high = lit != ((leds[i].dt_flags & GPIO_ACTIVE_LOW) != 0);
+		mask |= BIT(leds[i].pin);
+		if (high) {
+			value |= BIT(leds[i].pin);
+		}
+	}
+
+	if (mask) {
+		gpio_port_set_masked_raw(leds[0].port, mask, value);
+	}
+}
 
 /*=============================================================================
  * Button Event Handler - Uses ButtonManager Module
@@ -76,19 +114,27 @@ static void on_button_pressed(uint8_t button_id)
 		button0_press_time = k_uptime_get_32();
 	}
 	
-	/* Toggle LED state */
-	led_state[button_id] = !led_state[button_id];
-	gpio_pin_set_dt(&leds[button_id], led_state[button_id] ? 1 : 0);
+	/* Toggle the endpoint of this LED; the output callback drives the pin */
+	auto& lights = smarthome::protocol::matter::LightEndpoints::getInstance();
+	uint16_t endpoint_id = lights.endpointForLed(button_id);
+	smarthome::protocol::matter::LightAttributes attrs;
 	
-	LOG_INF("Button %d pressed - LED%d toggled to %s", 
-	        button_id, button_id, led_state[button_id] ? "ON" : "OFF");
-	
-	/* Notify Matter stack of state change */
-	smarthome::protocol::matter::LightEndpoint::getInstance().setLightState(led_state[button_id]);
+	lights.toggle(endpoint_id);
+	lights.getAttributes(endpoint_id, attrs);
+	LOG_INF("Button %d pressed - endpoint %u toggled to %s", 
+	        button_id, endpoint_id, attrs.on_off ? "ON" : "OFF");
+
+#ifdef CONFIG_APP_THREAD_SED
+	/* The report and its acknowledgement round-trip through the parent */
+	smarthome::protocol::thread::ThreadNetworkManager::getInstance().requestFastPoll(
+		CONFIG_APP_THREAD_SED_COMMAND_BURST_MS);
+#endif
 }
 
 /* Forward declarations */
-static int app_core_init_gpio(void);
+static int app_core_init_lights(void);
+
+static int app_core_init_buttons(void);
 
 static int app_core_init_apptask(void);
 
@@ -138,6 +184,11 @@ static int init_ipc(void) {
 	ipc.registerCallback(smarthome::ipc::MessageType::RADIO_RX, handle_radio_event);
 	LOG_INF("IPC initialized successfully");
 	
+#ifdef CONFIG_APP_NET_UPDATE
+	/* NET core firmware pushes (status replies arrive over IPC) */
+	smarthome::services::ota::NetUpdateClient::getInstance().init();
+#endif
+	
 	/* Send initial status request to NET core */
 	auto msg = smarthome::ipc::MessageBuilder(smarthome::ipc::MessageType::STATUS_REQUEST)
 	              .setPriority(smarthome::ipc::Priority::NORMAL)
@@ -171,18 +222,32 @@ static int app_core_init(void)
 	LOG_INF("  4 LEDs: P0.28-31");
 	LOG_INF("============================================");
 	
-	/* Initialize IPC first for inter-core communication */
+	/* Lights first: restored state on the LEDs before anything slow */
+	ret = app_core_init_lights();
+	if (ret < 0) {
+		LOG_ERR("Light initialization failed: %d", ret);
+	}
+	
+	/* IPC for inter-core communication */
 	ret = init_ipc();
 	if (ret < 0) {
 		LOG_ERR("IPC initialization failed: %d", ret);
 		/* Continue anyway - IPC is optional */
 	}
 	
-	ret = app_core_init_gpio();
-
 	ret = app_core_init_apptask();
-	
-	
+
+	if (app_core_init_buttons() < 0) {
+		LOG_WRN("Buttons unavailable, lights are network controlled only");
+	}
+
+#ifdef CONFIG_APP_OTA
+	/* Confirm the running image and start the OTA download thread */
+	if (smarthome::services::ota::OtaManager::getInstance().init() < 0) {
+		LOG_WRN("OTA manager initialization failed");
+	}
+#endif
+
 	LOG_INF("APP Core initialization complete!");
 	LOG_INF("Waiting for Matter commissioning...");
 	
@@ -198,49 +263,50 @@ static int app_core_init_apptask(void){
 		return ret;
 	}
 	LOG_INF("Matter stack initialized");
+	return 0;
 }
 
-
-
-static int app_core_init_gpio(void){
+/*
+ * Restore the lights before IPC and Matter: StartUpOnOff/StartUpCurrentLevel
+ * applied to the persisted attributes of every endpoint, read in one
+ * settings pass
+ */
+static int app_core_init_lights(void){
 	int ret;
-	/* Initialize all 4 LEDs and turn them ON to verify GPIO works */	
+
+	/* Dark until the restored state is known, never a flash of full on */
 	for (int i = 0; i < NUM_LEDS; i++) {
 		if (!device_is_ready(leds[i].port)) {
 			LOG_ERR("LED%d device not ready", i);
 			return -ENODEV;
 		}
 		
-		ret = gpio_pin_configure_dt(&leds[i], GPIO_OUTPUT_ACTIVE);
+		ret = gpio_pin_configure_dt(&leds[i], GPIO_OUTPUT_INACTIVE);
 		if (ret < 0) {
 			LOG_ERR("Failed to configure LED%d: %d", i, ret);
 			return ret;
 		}
-		
-		/* Turn LED ON */
-		led_state[i] = true;
-		gpio_pin_set_dt(&leds[i], 1);
-		LOG_INF("LED%d initialized and turned ON (P0.%d)", i, 28 + i);
 	}
-	LOG_INF("All 4 LEDs turned ON - verify all 4 green lights are visible");
 	
-	/* Initialize Matter application task */
-	LOG_INF("Initializing Matter stack...");
-	ret = smarthome::protocol::matter::AppTask::getInstance().init();
-	if (ret < 0) {
-		LOG_ERR("Failed to initialize Matter AppTask: %d", ret);
-		return ret;
+	ret = settings_subsys_init();
+	if (ret < 0 && ret != -EALREADY) {
+		LOG_ERR("Settings unavailable, lights keep their defaults: %d", ret);
 	}
-	LOG_INF("Matter stack initialized");
 	
-	/* Initialize Light Endpoint */
-	LOG_INF("Initializing Light Endpoint...");
-	ret = smarthome::protocol::matter::LightEndpoint::getInstance().init();
-	if (ret < 0) {
-		LOG_ERR("Failed to initialize Light Endpoint: %d", ret);
-		return ret;
-	}
-	LOG_INF("Light Endpoint initialized");
+	auto& lights = smarthome::protocol::matter::LightEndpoints::getInstance();
+	lights.init();
+	
+	/* Lights that are on fade in from dark rather than jump on */
+	smarthome::protocol::matter::LightEffects::getInstance().init();
+	smarthome::protocol::matter::LightEffects::getInstance().startup();
+	lights.setOutput(on_light_output);
+	LOG_INF("Light endpoints driving LED0-%d, %u us after kernel start",
+		NUM_LEDS - 1, lights.getStartupTimeUs());
+	return 0;
+}
+
+static int app_core_init_buttons(void){
+	int ret;
 	
 	/* Initialize Button Manager module */
 	LOG_INF("Initializing button manager...");
@@ -270,13 +336,9 @@ extern "C" int main(void)
 	LOG_INF("APP Core main loop started");
 	LOG_INF("Listening for Matter events and button input...");
 	
-	/* Main loop - process Matter events */
+	/* Main loop - sleeps until an event is posted */
 	while (1) {
-		/* Matter event processing */
-		smarthome::protocol::matter::AppTask::getInstance().dispatchEvent();
-		
-		/* Yield to other threads */
-		k_sleep(K_MSEC(10));
+		smarthome::protocol::matter::AppTask::getInstance().dispatchEvent(K_FOREVER);
 	}
 	
 	return 0;
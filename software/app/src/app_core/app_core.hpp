@@ -68,6 +68,14 @@
 /* IPC for inter-core communication */
 #include "sdk/ipc/ipc_core.hpp"
 
+#ifdef CONFIG_APP_OTA
+#include "sdk/services/ota/ota_manager.hpp"
+#endif
+
+#ifdef CONFIG_APP_NET_UPDATE
+#include "sdk/services/ota/net_update_client.hpp"
+#endif
+
 typedef enum {
     APP_OK = 1,
     APP_ERROR = 0,
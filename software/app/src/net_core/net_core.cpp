@@ -7,6 +7,9 @@
 #include "../sdk/ipc/ipc_core.hpp"
 #include "../sdk/protocol/ble/ble_manager.hpp"
 #include "../sdk/protocol/radio/radio_manager.hpp"
+#ifdef CONFIG_APP_NET_UPDATE
+#include "../sdk/services/ota/net_update_target.hpp"
+#endif
 #include <zephyr/logging/log.h>
 #include <string.h>
 
@@ -14,6 +17,9 @@ LOG_MODULE_REGISTER(net_core, CONFIG_LOG_DEFAULT_LEVEL);
 
 namespace net {
 
+/* Worker wakeup and stats log period (ACTIVE power mode) */
+static constexpr uint32_t STATS_INTERVAL_MS = 30000;
+
 /*=============================================================================
  * Singleton Implementation
  *===========================================================================*/
@@ -34,8 +40,10 @@ NetCoreManager::NetCoreManager()
     , m_radio_enabled(false)
     , m_stats{}
     , m_init_time_ms(0)
+    , m_low_power(false)
 {
     k_mutex_init(&m_state_mutex);
+    k_sem_init(&m_worker_wake, 0, 1);
     LOG_DBG("NetCoreManager constructed");
 }
 
@@ -116,17 +124,8 @@ int NetCoreManager::init() {
     transitionTo(NetCoreState::INITIALIZING);
     onStateEntry(NetCoreState::INITIALIZING);
     
-    /* Initialize IPC service */
+    /* Register IPC message handlers - before init, so the HELLO lists them */
     auto& ipc = smarthome::ipc::IPCCore::getInstance();
-    int ret = ipc.init();
-    if (ret < 0) {
-        LOG_ERR("IPC initialization failed: %d", ret);
-        transitionTo(NetCoreState::ERROR);
-        return ret;
-    }
-    LOG_INF("IPC initialized");
-    
-    /* Register IPC message handlers */
     ipc.registerCallback(smarthome::ipc::MessageType::STATUS_REQUEST,
                         [](const smarthome::ipc::Message& msg) {
                             NetCoreManager::getInstance().handleStatusRequest(msg);
@@ -157,8 +156,27 @@ int NetCoreManager::init() {
                             NetCoreManager::getInstance().handleRadioDisable(msg);
                         });
     
+    ipc.registerCallback(smarthome::ipc::MessageType::POWER_MODE,
+                        [](const smarthome::ipc::Message& msg) {
+                            NetCoreManager::getInstance().handlePowerMode(msg);
+                        });
+    
     LOG_INF("IPC callbacks registered");
     
+#ifdef CONFIG_APP_NET_UPDATE
+    /* Firmware image chunks from APP core */
+    smarthome::services::ota::NetUpdateTarget::getInstance().init();
+#endif
+    
+    /* Initialize IPC service */
+    int ret = ipc.init();
+    if (ret < 0) {
+        LOG_ERR("IPC initialization failed: %d", ret);
+        transitionTo(NetCoreState::ERROR);
+        return ret;
+    }
+    LOG_INF("IPC initialized");
+    
     /* Initialize BLE module */
     auto& ble_mgr = smarthome::protocol::ble::BLEManager::getInstance();
     int ble_ret = ble_mgr.init();
@@ -166,6 +184,7 @@ int NetCoreManager::init() {
         LOG_WRN("BLE init failed (err %d), continuing without BLE", ble_ret);
     } else {
         m_ble_enabled = true;
+        ble_mgr.setConnectionCallback(onBleConnection);
         LOG_INF("BLE module initialized");
         transitionTo(NetCoreState::BLE_READY);
         onStateEntry(NetCoreState::BLE_READY);
@@ -272,17 +291,23 @@ void NetCoreManager::handleBLEAdvStart(const smarthome::ipc::Message& msg) {
     uint16_t interval_ms = msg.payload.ble.adv_interval_ms;
     LOG_INF("Advertising interval: %u ms", interval_ms);
     
-    auto& ble_mgr = smarthome::protocol::ble::BLEManager::getInstance();
-    int ret = ble_mgr.startAdvertising(interval_ms);
+    /* The interval is checked by BLEManager, the data length here */
+    int ret = -EINVAL;
+    if (msg.payload.ble.adv_data_len <= sizeof(msg.payload.ble.adv_data)) {
+        auto& ble_mgr = smarthome::protocol::ble::BLEManager::getInstance();
+        ret = ble_mgr.startAdvertising(interval_ms);
+    }
     
     auto& ipc = smarthome::ipc::IPCCore::getInstance();
     if (ret == 0) {
         auto ack = smarthome::ipc::MessageBuilder(smarthome::ipc::MessageType::ACK)
+                     .setParam(0, (uint32_t)msg.type)
                      .setPriority(smarthome::ipc::Priority::NORMAL)
                      .build();
         ipc.send(ack);
     } else {
         auto nack = smarthome::ipc::MessageBuilder(smarthome::ipc::MessageType::NACK)
+                      .setParam(0, (uint32_t)msg.type)
                       .setPriority(smarthome::ipc::Priority::NORMAL)
                       .build();
         ipc.send(nack);
@@ -296,6 +321,7 @@ void NetCoreManager::handleBLEAdvStop(const smarthome::ipc::Message& msg) {
     ble_mgr.stopAdvertising();
     
     auto ack = smarthome::ipc::MessageBuilder(smarthome::ipc::MessageType::ACK)
+                 .setParam(0, (uint32_t)msg.type)
                  .setPriority(smarthome::ipc::Priority::NORMAL)
                  .build();
     
@@ -312,11 +338,13 @@ void NetCoreManager::handleRadioEnable(const smarthome::ipc::Message& msg) {
     auto& ipc = smarthome::ipc::IPCCore::getInstance();
     if (ret == 0) {
         auto ack = smarthome::ipc::MessageBuilder(smarthome::ipc::MessageType::ACK)
+                     .setParam(0, (uint32_t)msg.type)
                      .setPriority(smarthome::ipc::Priority::NORMAL)
                      .build();
         ipc.send(ack);
     } else {
         auto nack = smarthome::ipc::MessageBuilder(smarthome::ipc::MessageType::NACK)
+                      .setParam(0, (uint32_t)msg.type)
                       .setPriority(smarthome::ipc::Priority::NORMAL)
                       .build();
         ipc.send(nack);
@@ -327,17 +355,25 @@ void NetCoreManager::handleRadioTx(const smarthome::ipc::Message& msg) {
     uint8_t channel = msg.payload.radio.channel;
     int8_t power = msg.payload.radio.power_dbm;
     
-    LOG_DBG("Radio TX: channel=%u, power=%d dBm", channel, power);
+    uint16_t len = msg.payload.radio.data_len;
     
-    auto& radio_mgr = smarthome::protocol::radio::RadioManager::getInstance();
-    radio_mgr.transmit(channel, power, msg.payload.radio.data, 20);
+    LOG_DBG("Radio TX: channel=%u, power=%d dBm, len=%u", channel, power, len);
     
-    auto ack = smarthome::ipc::MessageBuilder(smarthome::ipc::MessageType::ACK)
-                 .setPriority(smarthome::ipc::Priority::NORMAL)
-                 .build();
+    /* Only what the message holds; channel and power are RadioManager's to check */
+    int ret = -EINVAL;
+    if (len > 0 && len <= sizeof(msg.payload.radio.data)) {
+        auto& radio_mgr = smarthome::protocol::radio::RadioManager::getInstance();
+        ret = radio_mgr.transmit(channel, power, msg.payload.radio.data, len);
+    }
+    
+    auto reply = smarthome::ipc::MessageBuilder(ret == 0 ? smarthome::ipc::MessageType::ACK
+                                                         : smarthome::ipc::MessageType::NACK)
+                   .setParam(0, (uint32_t)msg.type)
+                   .setPriority(smarthome::ipc::Priority::NORMAL)
+                   .build();
     
     auto& ipc = smarthome::ipc::IPCCore::getInstance();
-    ipc.send(ack);
+    ipc.send(reply);
 }
 
 void NetCoreManager::handleRadioDisable(const smarthome::ipc::Message& msg) {
@@ -347,6 +383,7 @@ void NetCoreManager::handleRadioDisable(const smarthome::ipc::Message& msg) {
     radio_mgr.disable();
     
     auto ack = smarthome::ipc::MessageBuilder(smarthome::ipc::MessageType::ACK)
+                 .setParam(0, (uint32_t)msg.type)
                  .setPriority(smarthome::ipc::Priority::NORMAL)
                  .build();
     
@@ -354,6 +391,39 @@ void NetCoreManager::handleRadioDisable(const smarthome::ipc::Message& msg) {
     ipc.send(ack);
 }
 
+void NetCoreManager::onBleConnection(bool connected) {
+    auto msg = smarthome::ipc::MessageBuilder(connected ? smarthome::ipc::MessageType::BLE_CONNECT
+                                                        : smarthome::ipc::MessageType::BLE_DISCONNECT)
+                 .setPriority(smarthome::ipc::Priority::HIGH)
+                 .build();
+    
+    auto& ipc = smarthome::ipc::IPCCore::getInstance();
+    ipc.send(msg);
+}
+
+void NetCoreManager::handlePowerMode(const smarthome::ipc::Message& msg) {
+    bool low_power = (msg.payload.params.param1 ==
+                      (uint32_t)smarthome::ipc::PowerMode::LOW_POWER);
+    
+    if (low_power == m_low_power) {
+        return;
+    }
+    
+    LOG_INF("Power mode: %s", low_power ? "LOW_POWER" : "ACTIVE");
+    m_low_power = low_power;
+    
+    /* Idle PINGs would wake both cores; a restarted peer still says HELLO */
+    using smarthome::ipc::IPCCore;
+    if (low_power) {
+        IPCCore::getInstance().setHeartbeat(0, 0);
+    } else {
+        IPCCore::getInstance().setHeartbeat(IPCCore::HEARTBEAT_IDLE_MS, IPCCore::LINK_TIMEOUT_MS);
+    }
+    
+    /* Re-evaluate the worker's wait */
+    k_sem_give(&m_worker_wake);
+}
+
 /*=============================================================================
  * Worker Thread
  *===========================================================================*/
@@ -369,11 +439,15 @@ void NetCoreManager::workerThreadLoop() {
     uint32_t last_stats_ms = 0;
     
     while (1) {
-        k_sleep(K_MSEC(5000));
+        /* One wakeup per stats period; none at all in low power mode */
+        k_sem_take(&m_worker_wake, m_low_power ? K_FOREVER : K_MSEC(STATS_INTERVAL_MS));
+        if (m_low_power) {
+            continue;
+        }
         
         /* Print stats periodically */
         uint32_t now_ms = k_uptime_get_32();
-        if (now_ms - last_stats_ms >= 30000) {
+        if (now_ms - last_stats_ms >= STATS_INTERVAL_MS) {
             k_mutex_lock(&m_state_mutex, K_FOREVER);
             
             LOG_INF("=== NET Core Stats (uptime: %u ms) ===",
@@ -399,6 +473,8 @@ void NetCoreManager::workerThreadLoop() {
  * C++ Entry Point
  *===========================================================================*/
 
+/* In a single-process simulation the harness starts the manager on its NET thread */
+#ifndef CONFIG_APP_IPC_LOOPBACK
 extern "C" int main(void) {
     LOG_INF("\n\n*** nRF5340 NET Core Starting ***\n");
     LOG_INF("CPU: Cortex-M33 @ 64 MHz");
@@ -415,10 +491,11 @@ extern "C" int main(void) {
     LOG_INF("NET Core main loop started");
     LOG_INF("Waiting for IPC commands from APP core...");
     
-    /* Main loop - keep running */
+    /* Everything runs from IPC callbacks and the worker thread */
     while (1) {
-        k_sleep(K_MSEC(1000));
+        k_sleep(K_FOREVER);
     }
     
     return 0;
 }
+#endif
@@ -164,6 +164,10 @@ private:
     void handleRadioEnable(const smarthome::ipc::Message& msg);
     void handleRadioTx(const smarthome::ipc::Message& msg);
     void handleRadioDisable(const smarthome::ipc::Message& msg);
+    void handlePowerMode(const smarthome::ipc::Message& msg);
+    
+    /* BLE events forwarded to the APP core */
+    static void onBleConnection(bool connected);
     
     /*=========================================================================
      * Internal State
@@ -179,6 +183,10 @@ private:
     
     uint32_t m_init_time_ms;
     
+    /* Low power: the worker sleeps until the APP core asks for ACTIVE */
+    bool m_low_power;
+    struct k_sem m_worker_wake;
+    
     /* Worker thread for async operations */
     struct k_thread m_worker_thread;
     K_KERNEL_STACK_MEMBER(m_worker_stack, 1024);
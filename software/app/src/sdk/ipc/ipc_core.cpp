@@ -11,37 +11,94 @@ LOG_MODULE_REGISTER(ipc_core, CONFIG_LOG_DEFAULT_LEVEL);
 
 namespace smarthome { namespace ipc {
 
+static void setTypeBit(uint8_t* types, MessageType type) {
+    uint8_t t = static_cast<uint8_t>(type);
+    if (t < sizeof(LinkInfo::types) * 8) {
+        types[t >> 3] |= 1U << (t & 7);
+    }
+}
+
+static bool hasTypeBit(const uint8_t* types, MessageType type) {
+    uint8_t t = static_cast<uint8_t>(type);
+    return t < sizeof(LinkInfo::types) * 8 && (types[t >> 3] & (1U << (t & 7)));
+}
+
 /*=============================================================================
  * Singleton Implementation
  *===========================================================================*/
 
+#ifndef CONFIG_APP_IPC_LOOPBACK
+
 IPCCore& IPCCore::getInstance() {
-    static IPCCore instance;
+#ifdef CONFIG_SOC_NRF5340_CPUNET
+    static IPCCore instance(Core::NET);
+#else
+    static IPCCore instance(Core::APP);
+#endif
     return instance;
 }
 
+#else
+
+IPCCore& IPCCore::getInstance(Core core) {
+    static IPCCore app_instance(Core::APP);
+    static IPCCore net_instance(Core::NET);
+    return (core == Core::NET) ? net_instance : app_instance;
+}
+
+IPCCore& IPCCore::getInstance() {
+    /* Custom data holds the core + 1, so untagged threads read as APP */
+    uintptr_t tag = reinterpret_cast<uintptr_t>(k_thread_custom_data_get());
+    return getInstance(tag == static_cast<uintptr_t>(Core::NET) + 1 ? Core::NET : Core::APP);
+}
+
+void IPCCore::bindThread(Core core) {
+    k_thread_custom_data_set(reinterpret_cast<void*>(static_cast<uintptr_t>(core) + 1));
+}
+
+#endif
+
 /*=============================================================================
  * Constructor - Initialize all static members
  *===========================================================================*/
 
-IPCCore::IPCCore() 
-    : m_ready(false)
+IPCCore::IPCCore(Core core)
+    : m_core(core)
+    , m_ready(false)
     , m_sequence_counter(0)
-    , m_endpoint{}
-    , m_endpoint_cfg{}
+    , m_transport(&OpenAmpTransport::getInstance())
     , m_stats{}
+    , m_peer_state(static_cast<atomic_val_t>(PeerState::UNKNOWN))
+    , m_peer{}
+    , m_link_caps(0)
+    , m_max_large(0)
+    , m_started(false)
+    , m_link_lost(false)
+    , m_bound(0)
+    , m_heartbeat_idle_ms(HEARTBEAT_IDLE_MS)
+    , m_link_timeout_ms(LINK_TIMEOUT_MS)
+    , m_last_rx_ms(0)
+    , m_last_tx_ms(0)
+    , m_last_hello_ms(0)
+    , m_down_since_ms(0)
 {
     /* Initialize message queues with static buffers */
     k_msgq_init(&m_tx_queue, m_tx_queue_buffer, sizeof(Message), MAX_MESSAGE_QUEUE);
     k_msgq_init(&m_rx_queue, m_rx_queue_buffer, sizeof(Message), MAX_MESSAGE_QUEUE);
+    k_msgq_init(&m_large_rx_queue, m_large_rx_queue_buffer, sizeof(LargeRxEntry),
+                LARGE_RX_QUEUE_DEPTH);
     
     /* Initialize synchronization primitives */
     k_mutex_init(&m_tx_mutex);
     k_sem_init(&m_ack_sem, 0, 1);
     k_sem_init(&m_ready_sem, 0, 1);
+    k_sem_init(&m_bound_sem, 0, 1);
+    k_sem_init(&m_rx_sem, 0, K_SEM_MAX_LIMIT);
     
     /* Clear callback registry */
     memset(m_callbacks, 0, sizeof(m_callbacks));
+    memset(m_large_callbacks, 0, sizeof(m_large_callbacks));
+    memset(m_link_callbacks, 0, sizeof(m_link_callbacks));
     
     LOG_DBG("IPCCore constructed");
 }
@@ -50,56 +107,83 @@ IPCCore::IPCCore()
  * Initialization
  *===========================================================================*/
 
+int IPCCore::setTransport(IpcTransport& transport)
+{
+    if (m_ready) {
+        return -EBUSY;
+    }
+
+    m_transport = &transport;
+    return 0;
+}
+
 int IPCCore::init()
 {
     if (m_ready) {
         LOG_WRN("IPC already initialized");
         return 0;
     }
+    if (m_started) {
+        /* Timed out earlier, the RX thread is still after the peer */
+        return -EALREADY;
+    }
 
-    LOG_INF("Initializing IPC service (OpenAMP)...");
+    LOG_INF("Initializing IPC service (%s)...", m_transport->name());
 
-    m_endpoint_cfg.name = "ipc_core";
-    m_endpoint_cfg.cb = {
+    static const TransportCallbacks callbacks = {
         .bound    = onEndpointBound,
         .received = onMessageReceived,
         .error    = onError,
     };
-    m_endpoint_cfg.priv = this;
 
-    /* Open OpenAMP instance (NO device) */
-    int ret = ipc_service_open_instance(NULL);
-    if (ret < 0 && ret != -EALREADY) {
-        LOG_ERR("Failed to open IPC instance: %d", ret);
-        return ret;
-    }
-
-    /* Register endpoint (instance = NULL for OpenAMP) */
-    ret = ipc_service_register_endpoint(NULL, &m_endpoint, &m_endpoint_cfg);
+    int ret = m_transport->open(callbacks, this);
     if (ret < 0) {
-        LOG_ERR("Failed to register endpoint: %d", ret);
         return ret;
     }
 
+    /*
+     * Monitoring runs from here whatever the handshake gives: a peer that
+     * says HELLO after the deadline still gets a watched link
+     */
+    m_last_tx_ms = k_uptime_get_32();
+    atomic_set(&m_last_rx_ms, m_last_tx_ms);
+    m_started = true;
+
     k_thread_create(&m_rx_thread, m_rx_stack,
                     K_KERNEL_STACK_SIZEOF(m_rx_stack),
                     rxThreadEntry, this, NULL, NULL,
                     K_PRIO_COOP(7), 0, K_NO_WAIT);
     k_thread_name_set(&m_rx_thread, "ipc_rx");
 
-    ret = k_sem_take(&m_ready_sem, K_MSEC(DEFAULT_WAIT_IPC_READY_MS));
+    int64_t deadline = k_uptime_get() + DEFAULT_WAIT_IPC_READY_MS;
+
+    ret = k_sem_take(&m_bound_sem, K_MSEC(DEFAULT_WAIT_IPC_READY_MS));
     if (ret < 0) {
         LOG_ERR("Timeout waiting for endpoint binding");
         return -ETIMEDOUT;
     }
 
-    m_ready = true;
-    LOG_INF("IPC initialized successfully (OpenAMP)");
+    /*
+     * Nothing but HELLO goes out until the peer has announced itself - the
+     * RX thread sends it every HELLO_RETRY_MS, past the deadline too
+     */
+    while (peerState() == PeerState::UNKNOWN && k_uptime_get() < deadline) {
+        k_sem_take(&m_ready_sem, K_MSEC(HELLO_RETRY_MS));
+    }
+
+    if (peerState() == PeerState::REFUSED) {
+        return -EPROTO;
+    }
+    if (!m_ready) {
+        LOG_ERR("Timeout waiting for the peer HELLO");
+        return -ETIMEDOUT;
+    }
+
+    LOG_INF("IPC initialized successfully (%s)", m_transport->name());
     return 0;
 }
 
 
-
 /*=============================================================================
  * Send Operations
  *===========================================================================*/
@@ -123,8 +207,8 @@ int IPCCore::send(const Message& msg, uint32_t timeout_ms) {
     tx_msg.sequence_id = m_sequence_counter++;
     tx_msg.timestamp = k_uptime_get_32();
     
-    /* Send via IPC service */
-    int ret = ipc_service_send(&m_endpoint, &tx_msg, sizeof(Message));
+    /* Send via the transport */
+    int ret = m_transport->send(&tx_msg, sizeof(Message));
     
     k_mutex_unlock(&m_tx_mutex);
     
@@ -134,6 +218,7 @@ int IPCCore::send(const Message& msg, uint32_t timeout_ms) {
         return ret;
     }
     
+    m_last_tx_ms = k_uptime_get_32();
     updateStats(true, false);
     LOG_DBG("Sent message type=0x%02x seq=%d", (uint8_t)tx_msg.type, tx_msg.sequence_id);
     
@@ -160,11 +245,136 @@ int IPCCore::sendSync(const Message& msg, uint32_t timeout_ms) {
     return 0;
 }
 
+int IPCCore::sendLarge(const Message& header, const void* data, size_t len,
+                       uint32_t timeout_ms) {
+    if (!m_ready) {
+        LOG_ERR("IPC not ready");
+        return -ENOTCONN;
+    }
+    
+    if (!linkHas(IPC_CAP_LARGE)) {
+        return -ENOTSUP;
+    }
+    
+    if (len > m_max_large) {
+        return -EMSGSIZE;
+    }
+    
+    if (!validateMessage(header)) {
+        LOG_ERR("Invalid message");
+        return -EINVAL;
+    }
+    
+    k_mutex_lock(&m_tx_mutex, K_FOREVER);
+    
+    /* Frame is assembled in a static buffer - TX path is serialized */
+    m_large_tx_frame.header = header;
+    m_large_tx_frame.header.flags |= MSG_FLAG_LARGE;
+    m_large_tx_frame.header.sequence_id = m_sequence_counter++;
+    m_large_tx_frame.header.timestamp = k_uptime_get_32();
+    memcpy(m_large_tx_frame.data, data, len);
+    
+    int ret = transmit(&m_large_tx_frame, sizeof(Message) + len, timeout_ms);
+    
+    k_mutex_unlock(&m_tx_mutex);
+    
+    if (ret < 0) {
+        LOG_ERR("IPC large send failed: %d", ret);
+        updateStats(true, true);
+        return ret;
+    }
+    
+    updateStats(true, false);
+    m_stats.large_tx_count++;
+    return 0;
+}
+
+int IPCCore::sendBatch(const Message* msgs, size_t count, uint32_t timeout_ms) {
+    if (!m_ready) {
+        LOG_ERR("IPC not ready");
+        return -ENOTCONN;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (!validateMessage(msgs[i])) {
+            LOG_ERR("Invalid message");
+            return -EINVAL;
+        }
+    }
+    
+    /* Peer without batch frames: one frame each */
+    if (!linkHas(IPC_CAP_BATCH)) {
+        for (size_t i = 0; i < count; i++) {
+            int ret = send(msgs[i], timeout_ms);
+            if (ret < 0) {
+                return ret;
+            }
+        }
+        return 0;
+    }
+    
+    while (count > 0) {
+        size_t n = MIN(count, (size_t)MAX_BATCH);
+        
+        k_mutex_lock(&m_tx_mutex, K_FOREVER);
+        
+        uint32_t now = k_uptime_get_32();
+        for (size_t i = 0; i < n; i++) {
+            Message& tx_msg = m_batch_tx_frame[i];
+            tx_msg = msgs[i];
+            tx_msg.flags = (n > 1) ? (msgs[i].flags | MSG_FLAG_BATCH) : msgs[i].flags;
+            tx_msg.sequence_id = m_sequence_counter++;
+            tx_msg.timestamp = now;
+        }
+        
+        int ret = transmit(m_batch_tx_frame, n * sizeof(Message), timeout_ms);
+        
+        k_mutex_unlock(&m_tx_mutex);
+        
+        if (ret < 0) {
+            LOG_ERR("IPC batch send failed: %d", ret);
+            updateStats(true, true);
+            return ret;
+        }
+        
+        m_stats.tx_count += n;
+        if (n > 1) {
+            m_stats.batch_tx_count++;
+        }
+        msgs += n;
+        count -= n;
+    }
+    
+    return 0;
+}
+
+/* Caller holds m_tx_mutex */
+int IPCCore::transmit(const void* frame, size_t len, uint32_t timeout_ms) {
+    int64_t deadline = k_uptime_get() + timeout_ms;
+    int ret;
+    
+    /* RPMsg returns -ENOMEM while all shared TX buffers are in flight */
+    while ((ret = m_transport->send(frame, len)) == -ENOMEM) {
+        m_stats.tx_busy_retries++;
+        if (k_uptime_get() >= deadline) {
+            return -EAGAIN;
+        }
+        k_sleep(K_MSEC(1));
+    }
+    
+    if (ret >= 0) {
+        m_last_tx_ms = k_uptime_get_32();
+    }
+    return ret;
+}
+
 /*=============================================================================
  * Callback Management
  *===========================================================================*/
 
 void IPCCore::registerCallback(MessageType type, MessageCallback callback) {
+    bool announced = handlesType(type);
+    
     /* Find free slot */
     for (int i = 0; i < MAX_CALLBACKS; i++) {
         if (!m_callbacks[i].active) {
@@ -172,6 +382,11 @@ void IPCCore::registerCallback(MessageType type, MessageCallback callback) {
             m_callbacks[i].callback = callback;
             m_callbacks[i].active = true;
             LOG_DBG("Registered callback for message type 0x%02x", (uint8_t)type);
+            
+            /* Peer already has our HELLO - tell it about the new type */
+            if (m_ready && !announced) {
+                sendHello(false);
+            }
             return;
         }
     }
@@ -184,11 +399,294 @@ void IPCCore::unregisterCallback(MessageType type) {
         if (m_callbacks[i].active && m_callbacks[i].type == type) {
             m_callbacks[i].active = false;
             LOG_DBG("Unregistered callback for message type 0x%02x", (uint8_t)type);
+            
+            if (m_ready && !handlesType(type)) {
+                sendHello(false);
+            }
             return;
         }
     }
 }
 
+void IPCCore::registerLargeCallback(MessageType type, LargeMessageCallback callback) {
+    bool announced = handlesType(type);
+    
+    for (int i = 0; i < MAX_LARGE_CALLBACKS; i++) {
+        if (!m_large_callbacks[i].active) {
+            m_large_callbacks[i].type = type;
+            m_large_callbacks[i].callback = callback;
+            m_large_callbacks[i].active = true;
+            LOG_DBG("Registered large callback for message type 0x%02x", (uint8_t)type);
+            
+            if (m_ready && !announced) {
+                sendHello(false);
+            }
+            return;
+        }
+    }
+    
+    LOG_ERR("No free large callback slots (max %d)", MAX_LARGE_CALLBACKS);
+}
+
+void IPCCore::registerLinkCallback(LinkCallback callback) {
+    for (int i = 0; i < MAX_LINK_CALLBACKS; i++) {
+        if (!m_link_callbacks[i]) {
+            m_link_callbacks[i] = callback;
+            return;
+        }
+    }
+    
+    LOG_ERR("No free link callback slots (max %d)", MAX_LINK_CALLBACKS);
+}
+
+bool IPCCore::handlesType(MessageType type) const {
+    /* Taken by processReceivedMessage itself */
+    if (type == MessageType::ACK || type == MessageType::NACK ||
+        type == MessageType::HELLO || type == MessageType::PING) {
+        return true;
+    }
+    
+    for (int i = 0; i < MAX_CALLBACKS; i++) {
+        if (m_callbacks[i].active && m_callbacks[i].type == type) {
+            return true;
+        }
+    }
+    for (int i = 0; i < MAX_LARGE_CALLBACKS; i++) {
+        if (m_large_callbacks[i].active && m_large_callbacks[i].type == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*=============================================================================
+ * Handshake
+ *===========================================================================*/
+
+/* Every core takes large and batch frames - announced for peers that do not */
+uint32_t IPCCore::localCaps() const {
+    return IPC_CAP_LARGE | IPC_CAP_BATCH | (m_heartbeat_idle_ms ? IPC_CAP_HEARTBEAT : 0);
+}
+
+int IPCCore::sendHello(bool want_reply, uint32_t timeout_ms) {
+    Message hello = MessageBuilder(MessageType::HELLO)
+                        .setPriority(Priority::HIGH)
+                        .build();
+    LinkInfo& info = hello.payload.hello;
+    
+    if (want_reply) {
+        hello.flags |= MSG_FLAG_REPLY;
+    }
+    info.version_major = IPC_PROTOCOL_MAJOR;
+    info.version_minor = IPC_PROTOCOL_MINOR;
+    info.max_payload = MAX_LARGE_PAYLOAD;
+    info.caps = localCaps();
+    for (uint16_t t = 0; t < sizeof(info.types) * 8; t++) {
+        if (handlesType(static_cast<MessageType>(t))) {
+            setTypeBit(info.types, static_cast<MessageType>(t));
+        }
+    }
+    
+    k_mutex_lock(&m_tx_mutex, K_FOREVER);
+    hello.sequence_id = m_sequence_counter++;
+    int ret = transmit(&hello, sizeof(hello), timeout_ms);
+    k_mutex_unlock(&m_tx_mutex);
+    
+    if (ret < 0) {
+        LOG_WRN("HELLO send failed: %d", ret);
+        updateStats(true, true);
+        return ret;
+    }
+    
+    updateStats(true, false);
+    return 0;
+}
+
+void IPCCore::handleHello(const Message& msg) {
+    const LinkInfo& info = msg.payload.hello;
+    bool want_reply = (msg.flags & MSG_FLAG_REPLY) != 0;
+    
+    /* Answer even a peer we refuse, so it refuses us as early */
+    if (want_reply) {
+        sendHello(false);
+    }
+    
+    m_peer = info;
+    
+    if (info.version_major != IPC_PROTOCOL_MAJOR) {
+        LOG_ERR("Peer speaks IPC protocol %u.%u, this core %u.%u - link refused",
+                info.version_major, info.version_minor,
+                IPC_PROTOCOL_MAJOR, IPC_PROTOCOL_MINOR);
+        m_stats.refused_peers++;
+        linkDown(PeerState::REFUSED);
+        k_sem_give(&m_ready_sem);
+        return;
+    }
+    
+    m_link_caps = localCaps() & info.caps;
+    m_max_large = linkHas(IPC_CAP_LARGE) ? MIN(MAX_LARGE_PAYLOAD, info.max_payload) : 0;
+    
+    /* A HELLO asking for ours only comes from a peer that starts over */
+    bool recovered = m_link_lost;
+    bool restarted = peerState() == PeerState::ACCEPTED && want_reply;
+    
+    if (peerState() != PeerState::ACCEPTED) {
+        LOG_INF("Peer IPC protocol %u.%u, caps 0x%02x, large frames up to %u bytes",
+                info.version_major, info.version_minor, m_link_caps, m_max_large);
+    }
+    atomic_set(&m_peer_state, static_cast<atomic_val_t>(PeerState::ACCEPTED));
+    m_ready = true;
+    m_link_lost = false;
+    k_sem_give(&m_ready_sem);
+    
+    if (recovered) {
+        uint32_t down_ms = k_uptime_get_32() - m_down_since_ms;
+        
+        m_stats.link_down_ms += down_ms;
+        LOG_INF("IPC link back after %u ms", down_ms);
+        notifyLink(true);
+    } else if (restarted) {
+        m_stats.rebinds++;
+        LOG_WRN("Peer core restarted its IPC - resyncing");
+        notifyLink(true);
+    }
+}
+
+bool IPCCore::peerSupports(MessageType type) const {
+    return peerState() == PeerState::ACCEPTED && hasTypeBit(m_peer.types, type);
+}
+
+/*=============================================================================
+ * Link Monitoring
+ *===========================================================================*/
+
+int IPCCore::setHeartbeat(uint32_t idle_ms, uint32_t timeout_ms) {
+    if (idle_ms > 0 && timeout_ms <= idle_ms) {
+        return -EINVAL;
+    }
+    
+    m_heartbeat_idle_ms = idle_ms;
+    m_link_timeout_ms = timeout_ms;
+    m_link_caps = localCaps() & m_peer.caps;
+    
+    /* The peer monitors us only while we announce the heartbeat */
+    if (m_ready) {
+        sendHello(false);
+    }
+    k_sem_give(&m_rx_sem);
+    return 0;
+}
+
+/* How long the RX thread may wait for a frame before checkLink() */
+k_timeout_t IPCCore::checkPeriod() const {
+    if (!m_started) {
+        return K_FOREVER;
+    }
+    
+    switch (peerState()) {
+        case PeerState::UNKNOWN:
+            return K_MSEC(HELLO_RETRY_MS);
+        case PeerState::ACCEPTED:
+            if (linkHas(IPC_CAP_HEARTBEAT)) {
+                return K_MSEC(MAX(m_heartbeat_idle_ms / 2, 1U));
+            }
+            return K_FOREVER;
+        default:
+            /* A replacement peer sends its own HELLO */
+            return K_FOREVER;
+    }
+}
+
+void IPCCore::checkLink() {
+    if (!m_started) {
+        return;
+    }
+    
+    uint32_t now = k_uptime_get_32();
+    PeerState state = peerState();
+    
+    if (state == PeerState::UNKNOWN) {
+        /* Lost or not met yet: ask until the peer is there, without waiting for TX buffers */
+        if (atomic_get(&m_bound) && now - m_last_hello_ms >= HELLO_RETRY_MS) {
+            m_last_hello_ms = now;
+            sendHello(true, 0);
+        }
+        return;
+    }
+    
+    if (state != PeerState::ACCEPTED || !linkHas(IPC_CAP_HEARTBEAT)) {
+        return;
+    }
+    
+    uint32_t silent_ms = now - static_cast<uint32_t>(atomic_get(&m_last_rx_ms));
+    
+    if (silent_ms >= m_link_timeout_ms) {
+        LOG_WRN("Nothing from the peer core for %u ms - IPC link down", silent_ms);
+        linkDown(PeerState::UNKNOWN);
+        return;
+    }
+    
+    if (now - m_last_tx_ms >= m_heartbeat_idle_ms) {
+        sendPing();
+    }
+}
+
+void IPCCore::sendPing() {
+    Message ping = MessageBuilder(MessageType::PING).build();
+    
+    /* TX held by someone else: traffic is going out anyway */
+    if (k_mutex_lock(&m_tx_mutex, K_NO_WAIT) < 0) {
+        return;
+    }
+    ping.sequence_id = m_sequence_counter++;
+    int ret = transmit(&ping, sizeof(ping), 0);
+    k_mutex_unlock(&m_tx_mutex);
+    
+    if (ret < 0) {
+        updateStats(true, true);
+        return;
+    }
+    
+    updateStats(true, false);
+    m_stats.heartbeats++;
+}
+
+void IPCCore::linkDown(PeerState state) {
+    bool was_up = static_cast<PeerState>(atomic_set(&m_peer_state,
+                  static_cast<atomic_val_t>(state))) == PeerState::ACCEPTED;
+    
+    m_ready = false;
+    m_link_caps = 0;
+    m_max_large = 0;
+    
+    if (!m_started || !was_up) {
+        return;
+    }
+    
+    m_stats.link_outages++;
+    m_link_lost = true;
+    m_down_since_ms = k_uptime_get_32();
+    
+    /* A reset peer registers a new endpoint - meet it with a new one */
+    if (state == PeerState::UNKNOWN) {
+        int ret = m_transport->reopen();
+        if (ret < 0) {
+            LOG_ERR("Failed to reopen %s: %d", m_transport->name(), ret);
+        }
+        m_last_hello_ms = 0;
+    }
+    
+    notifyLink(false);
+}
+
+void IPCCore::notifyLink(bool up) {
+    for (int i = 0; i < MAX_LINK_CALLBACKS; i++) {
+        if (m_link_callbacks[i]) {
+            m_link_callbacks[i](up);
+        }
+    }
+}
+
 /*=============================================================================
  * Statistics
  *===========================================================================*/
@@ -215,20 +713,59 @@ void IPCCore::updateStats(bool tx, bool error) {
 }
 
 /*=============================================================================
- * IPC Service Callbacks
+ * Transport Callbacks
  *===========================================================================*/
 
 void IPCCore::onEndpointBound(void *priv) {
     IPCCore *ipc = static_cast<IPCCore*>(priv);
     LOG_INF("IPC endpoint bound");
     
-    ipc->m_ready = true;
-    k_sem_give(&ipc->m_ready_sem);
+    /* Ready once the peer HELLO is in, see init() - the RX thread sends ours */
+    atomic_set(&ipc->m_bound, 1);
+    k_sem_give(&ipc->m_bound_sem);
+    k_sem_give(&ipc->m_rx_sem);
 }
 
 void IPCCore::onMessageReceived(const void *data, size_t len, void *priv) {
     IPCCore *ipc = static_cast<IPCCore*>(priv);
     
+    const Message *msg = static_cast<const Message*>(data);
+    
+    /* Any frame shows the peer is alive - the heartbeat rides on traffic */
+    atomic_set(&ipc->m_last_rx_ms, k_uptime_get_32());
+    
+    if (len > sizeof(Message) && !(msg->flags & MSG_FLAG_LARGE) &&
+        (msg->flags & MSG_FLAG_BATCH)) {
+        if (len % sizeof(Message) != 0 || len > MAX_BATCH * sizeof(Message)) {
+            LOG_ERR("Received invalid batch size: %u", (unsigned)len);
+            ipc->updateStats(false, true);
+            return;
+        }
+        
+        ipc->m_stats.batch_rx_count++;
+        for (size_t i = 0; i < len / sizeof(Message); i++) {
+            ipc->queueMessage(&msg[i]);
+        }
+        return;
+    }
+    
+    if (len > sizeof(Message) && len <= sizeof(LargeFrame) &&
+        (msg->flags & MSG_FLAG_LARGE)) {
+        /* Copy out of the shared buffer - it is released on return */
+        LargeRxEntry& entry = ipc->m_large_rx_in;
+        entry.len = static_cast<uint16_t>(len - sizeof(Message));
+        memcpy(&entry.frame, data, len);
+        
+        if (k_msgq_put(&ipc->m_large_rx_queue, &entry, K_NO_WAIT) < 0) {
+            LOG_ERR("Large RX queue full, dropping frame");
+            ipc->m_stats.dropped_messages++;
+            ipc->updateStats(false, true);
+            return;
+        }
+        k_sem_give(&ipc->m_rx_sem);
+        return;
+    }
+    
     if (len != sizeof(Message)) {
         LOG_ERR("Received invalid message size: %u (expected %u)", 
                 len, sizeof(Message));
@@ -236,15 +773,24 @@ void IPCCore::onMessageReceived(const void *data, size_t len, void *priv) {
         return;
     }
     
-    const Message *msg = static_cast<const Message*>(data);
-    
-    /* Queue message for processing in RX thread */
-    int ret = k_msgq_put(&ipc->m_rx_queue, msg, K_NO_WAIT);
+    ipc->queueMessage(msg);
+}
+
+/* Queue message for processing in RX thread */
+void IPCCore::queueMessage(const Message* msg) {
+    int ret = k_msgq_put(&m_rx_queue, msg, K_NO_WAIT);
     if (ret < 0) {
         LOG_ERR("RX queue full, dropping message");
-        ipc->m_stats.dropped_messages++;
-        ipc->updateStats(false, true);
+        m_stats.dropped_messages++;
+        updateStats(false, true);
+        return;
+    }
+
+    uint32_t queued = k_msgq_num_used_get(&m_rx_queue);
+    if (queued > m_stats.rx_queue_peak) {
+        m_stats.rx_queue_peak = queued;
     }
+    k_sem_give(&m_rx_sem);
 }
 
 void IPCCore::onError(const char *message, void *priv) {
@@ -261,24 +807,46 @@ void IPCCore::processReceivedMessage(const Message& msg) {
     LOG_DBG("Processing message type=0x%02x seq=%d", 
             (uint8_t)msg.type, msg.sequence_id);
     
+    /* The peer is not trusted to have checked what it sent */
+    if (!validateMessage(msg)) {
+        LOG_WRN("Dropping invalid message type=0x%02x", (uint8_t)msg.type);
+        updateStats(false, true);
+        return;
+    }
+    
+    /* Until a HELLO is accepted the payload layout is not agreed on */
+    if (msg.type != MessageType::HELLO && peerState() != PeerState::ACCEPTED) {
+        LOG_WRN("Dropping type=0x%02x from a peer without HELLO", (uint8_t)msg.type);
+        updateStats(false, true);
+        return;
+    }
+    
     updateStats(false, false);
     
     /* Handle special messages */
     switch (msg.type) {
+        case MessageType::HELLO:
+            handleHello(msg);
+            return;
+            
+        case MessageType::PING:
+            return;
+            
         case MessageType::ACK:
             k_sem_give(&m_ack_sem);
-            return;
+            break;
             
         case MessageType::NACK:
             LOG_WRN("Received NACK from remote core");
             k_sem_give(&m_ack_sem);
-            return;
+            break;
             
         default:
-            /* Dispatch to registered callbacks */
-            dispatchMessage(msg);
             break;
     }
+    
+    /* Dispatch to registered callbacks - ACK/NACK too (param1: which request) */
+    dispatchMessage(msg);
 }
 
 void IPCCore::dispatchMessage(const Message& msg) {
@@ -299,6 +867,38 @@ void IPCCore::dispatchMessage(const Message& msg) {
     }
 }
 
+void IPCCore::dispatchLargeMessage(const LargeRxEntry& entry) {
+    const Message& header = entry.frame.header;
+    bool handled = false;
+    
+    if (!validateMessage(header)) {
+        LOG_WRN("Dropping invalid large frame type=0x%02x", (uint8_t)header.type);
+        updateStats(false, true);
+        return;
+    }
+    
+    if (peerState() != PeerState::ACCEPTED) {
+        LOG_WRN("Dropping large frame from a peer without HELLO");
+        updateStats(false, true);
+        return;
+    }
+    
+    updateStats(false, false);
+    m_stats.large_rx_count++;
+    
+    for (int i = 0; i < MAX_LARGE_CALLBACKS; i++) {
+        if (m_large_callbacks[i].active && m_large_callbacks[i].type == header.type &&
+            m_large_callbacks[i].callback) {
+            m_large_callbacks[i].callback(header, entry.frame.data, entry.len);
+            handled = true;
+        }
+    }
+    
+    if (!handled) {
+        LOG_DBG("No large handler for message type 0x%02x", (uint8_t)header.type);
+    }
+}
+
 /*=============================================================================
  * RX Thread
  *===========================================================================*/
@@ -309,16 +909,28 @@ void IPCCore::rxThreadEntry(void *p1, void *p2, void *p3) {
 }
 
 void IPCCore::rxThreadLoop() {
+#ifdef CONFIG_APP_IPC_LOOPBACK
+    /* Handlers call getInstance() - they must get this core's instance */
+    bindThread(m_core);
+#endif
     LOG_INF("IPC RX thread started");
     
     Message msg;
     
     while (1) {
-        /* Block waiting for messages */
-        int ret = k_msgq_get(&m_rx_queue, &msg, K_FOREVER);
-        if (ret == 0) {
-            processReceivedMessage(msg);
+        /*
+         * Block until either queue has a frame (control messages go
+         * first), or until the link is due for a check
+         */
+        if (k_sem_take(&m_rx_sem, checkPeriod()) == 0) {
+            if (k_msgq_get(&m_rx_queue, &msg, K_NO_WAIT) == 0) {
+                processReceivedMessage(msg);
+            } else if (k_msgq_get(&m_large_rx_queue, &m_large_rx_out, K_NO_WAIT) == 0) {
+                dispatchLargeMessage(m_large_rx_out);
+            }
         }
+        
+        checkLink();
     }
 }
 
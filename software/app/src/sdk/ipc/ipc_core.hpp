@@ -23,15 +23,28 @@
  *   - Automatic acknowledgment handling
  *   - Callback-based event handling
  *   - Memory pooling for zero fragmentation
+ *   - Large-payload frames (32-byte header + up to MAX_LARGE_PAYLOAD bytes)
+ *     for bulk transfers such as NET core firmware images
+ *   - Pluggable transport (ipc_transport.hpp): OpenAMP on the nRF5340, an
+ *     in-process loopback with CONFIG_APP_IPC_LOOPBACK for simulation
+ *   - HELLO handshake at bind time: protocol version, largest data block,
+ *     capabilities and handled message types, so separately flashed APP
+ *     and NET images refuse each other instead of misparsing payloads
+ *   - Batch frames: several messages in one transport frame
+ *   - Link monitoring: any frame from the peer counts as a heartbeat, a
+ *     PING goes out only when TX is idle; a silent peer takes the link
+ *     down, the endpoint is registered again and HELLO resent until the
+ *     peer is back, then link callbacks resync state
  */
 
 #ifndef IPC_CORE_HPP
 #define IPC_CORE_HPP
 
 #include <zephyr/kernel.h>
-#include <zephyr/ipc/ipc_service.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/ring_buffer.h>
 #include <stdint.h>
+#include "ipc_transport.hpp"
 
 
 #define DEFAULT_WAIT_IPC_READY_MS 5000
@@ -52,22 +65,40 @@ enum class MessageType : uint8_t {
     /* BLE operations */
     BLE_ADV_START = 0x10,
     BLE_ADV_STOP = 0x11,
-    BLE_CONNECT = 0x12,
-    BLE_DISCONNECT = 0x13,
+    BLE_CONNECT = 0x12,         // NET -> APP: central connected
+    BLE_DISCONNECT = 0x13,      // NET -> APP: connection lost
     
     /* Thread/Matter networking */
     THREAD_START = 0x20,
     THREAD_STOP = 0x21,
     THREAD_ATTACH = 0x22,
+    THREAD_DIAG_REQUEST = 0x23,     // param1: history age (0 = newest)
+    THREAD_DIAG_REPORT = 0x24,      // param1: result, param2: age; data: diag record
     
     /* Status/Control */
     STATUS_REQUEST = 0x30,
     STATUS_RESPONSE = 0x31,
-    ACK = 0x32,
-    NACK = 0x33,
+    ACK = 0x32,                 // param1: acknowledged MessageType
+    NACK = 0x33,                // param1: refused MessageType
+    POWER_MODE = 0x34,          // APP -> NET, param1: PowerMode
+    HELLO = 0x35,               // Both ways at bind time, payload.hello
+    PING = 0x36,                // Heartbeat while TX is idle, no payload
     
     /* Custom user messages */
-    USER_MSG = 0x40
+    USER_MSG = 0x40,
+    
+    /* NET core firmware update (see services/ota/net_update_protocol.hpp) */
+    NET_DFU_BEGIN = 0x50,
+    NET_DFU_CHUNK = 0x51,
+    NET_DFU_END = 0x52,
+    NET_DFU_ABORT = 0x53,
+    NET_DFU_STATUS = 0x54
+};
+
+/* POWER_MODE param1 */
+enum class PowerMode : uint8_t {
+    ACTIVE = 0,         // Periodic housekeeping and stats logging, link heartbeat
+    LOW_POWER = 1       // Event driven only - APP is a sleepy Thread device
 };
 
 enum class Priority : uint8_t {
@@ -77,6 +108,29 @@ enum class Priority : uint8_t {
     CRITICAL = 3
 };
 
+/*=============================================================================
+ * Link protocol - checked by the HELLO handshake
+ *===========================================================================*/
+
+/* Major changes with the Message layout or the meaning of a payload */
+constexpr uint8_t IPC_PROTOCOL_MAJOR = 1;
+constexpr uint8_t IPC_PROTOCOL_MINOR = 1;    // 1: PING, IPC_CAP_HEARTBEAT
+
+/* LinkInfo::caps bits */
+constexpr uint32_t IPC_CAP_LARGE = 0x01;    // Takes large frames (MSG_FLAG_LARGE)
+constexpr uint32_t IPC_CAP_BATCH = 0x02;    // Takes batch frames (MSG_FLAG_BATCH)
+constexpr uint32_t IPC_CAP_HEARTBEAT = 0x04; // Sends PING when idle, may be monitored
+
+#pragma pack(push, 1)
+struct LinkInfo {
+    uint8_t version_major;     // Must match, or the link is refused
+    uint8_t version_minor;     // May differ
+    uint16_t max_payload;      // Largest data block taken in a large frame
+    uint32_t caps;             // IPC_CAP_* bits
+    uint8_t types[16];         // Bitmap of MessageTypes 0x00..0x7F handled
+};
+#pragma pack(pop)
+
 /*=============================================================================
  * Message Structure - Fixed size for memory efficiency
  * Total: 32 bytes (cache-line friendly on Cortex-M33)
@@ -105,14 +159,14 @@ struct Message {
         struct {
             uint8_t channel;
             uint8_t power_dbm;
-            uint16_t reserved;
+            uint16_t data_len;  // Bytes of data used, 1..20
             uint8_t data[20];
         } radio;
         
         struct {
             uint16_t adv_interval_ms;
             uint8_t adv_type;
-            uint8_t adv_data_len;
+            uint8_t adv_data_len;   // 0..20
             uint8_t adv_data[20];
         } ble;
         
@@ -120,17 +174,49 @@ struct Message {
             uint32_t status_code;
             uint8_t info[20];
         } status;
+        
+        LinkInfo hello;
     } payload;
 };
 #pragma pack(pop)
 
 static_assert(sizeof(Message) == 32, "Message must be 32 bytes for alignment");
+
+/* Message::flags bits */
+constexpr uint8_t MSG_FLAG_LARGE = 0x01;    // Header is followed by a data block
+constexpr uint8_t MSG_FLAG_BATCH = 0x02;    // Frame holds 2..MAX_BATCH messages back to back
+constexpr uint8_t MSG_FLAG_REPLY = 0x04;    // HELLO: answer with your own
+
+/*=============================================================================
+ * Logical cores - one IPCCore each
+ *===========================================================================*/
+
+enum class Core : uint8_t {
+    APP = 0,
+    NET = 1
+};
+
 /*=============================================================================
  * Message Callback Interface - Observer pattern
  *===========================================================================*/
 
 using MessageCallback = void (*)(const Message&);
 
+/**
+ * Large-payload callback
+ * @param header Frame header (type, sequence, payload params as metadata)
+ * @param data Data block following the header (valid during the call only)
+ * @param len Data block length
+ */
+using LargeMessageCallback = void (*)(const Message& header, const uint8_t* data, size_t len);
+
+/**
+ * Link state callback, from the RX thread - must not wait for IPC replies
+ * @param up false when the link is lost, true when it is back after an
+ *           outage or the peer restarted: push state the peer may have lost
+ */
+using LinkCallback = void (*)(bool up);
+
 /*=============================================================================
  * IPC Core Class - Singleton pattern for resource control
  *===========================================================================*/
@@ -143,9 +229,38 @@ public:
     static constexpr uint16_t RX_BUFFER_SIZE = 512;
     static constexpr uint32_t IPC_TIMEOUT_MS = 1000;
     
+    /* Large-payload path: header + data must fit one RPMsg buffer */
+    static constexpr uint16_t MAX_LARGE_PAYLOAD = 448;
+    static constexpr uint8_t LARGE_RX_QUEUE_DEPTH = 4;
+    
+    /* Batch frames - at most half the peer's RX queue in one go */
+    static constexpr uint8_t MAX_BATCH = MAX_MESSAGE_QUEUE / 2;
+    
+    /* Handshake: HELLO resent at this period until the peer answers */
+    static constexpr uint32_t HELLO_RETRY_MS = 100;
+    
+    /* Link monitoring defaults, see setHeartbeat() - off in PowerMode::LOW_POWER */
+    static constexpr uint32_t HEARTBEAT_IDLE_MS = 500;
+    static constexpr uint32_t LINK_TIMEOUT_MS = 2000;
+    
     /* Singleton access */
     static IPCCore& getInstance();
     
+#ifdef CONFIG_APP_IPC_LOOPBACK
+    /*
+     * Both cores in one process: one instance per logical core. Threads
+     * are tagged with their core, and getInstance() returns the calling
+     * thread's instance so APP and NET code runs unchanged. Untagged
+     * threads (system work queue, timers) belong to the APP core.
+     */
+    static IPCCore& getInstance(Core core);
+    
+    /**
+     * @brief Tag the calling thread with a logical core
+     */
+    static void bindThread(Core core);
+#endif
+    
     /* Delete copy/move constructors for singleton */
     IPCCore(const IPCCore&) = delete;
     IPCCore& operator=(const IPCCore&) = delete;
@@ -156,12 +271,33 @@ public:
      * Core Operations
      *=======================================================================*/
     
+    /**
+     * @brief Replace the transport (OpenAMP by default)
+     * @param transport Link to the peer core, must outlive the instance
+     * @return 0 on success, -EBUSY once initialized
+     */
+    int setTransport(IpcTransport& transport);
+    
     /**
      * @brief Initialize IPC subsystem
-     * @return 0 on success, negative errno on failure
+     *
+     * Opens the transport and exchanges HELLO with the peer core. Handlers
+     * registered before init are announced in the first HELLO; later
+     * registrations are announced again. The link is monitored from here
+     * on: after a timeout the RX thread keeps sending HELLO and a late peer
+     * still brings the link up (isReady(), no link callback).
+     *
+     * @return 0 on success, -EPROTO if the peer speaks another protocol
+     *         version, -ETIMEDOUT without binding or HELLO, -EALREADY if an
+     *         earlier call timed out, negative errno on failure
      */
     int init();
     
+    /**
+     * @brief Logical core this instance speaks for
+     */
+    Core getCore() const { return m_core; }
+    
     /**
      * @brief Send message to remote core
      * @param msg Message to send
@@ -178,6 +314,37 @@ public:
      */
     int sendSync(const Message& msg, uint32_t timeout_ms = IPC_TIMEOUT_MS);
     
+    /**
+     * @brief Send a header followed by a data block in one frame
+     *
+     * Retries while the transport has no free TX buffer, up to timeout_ms.
+     * The receiver queues at most LARGE_RX_QUEUE_DEPTH frames, so bulk
+     * senders must bound the number of unacknowledged frames accordingly.
+     *
+     * @param header Frame header (MSG_FLAG_LARGE is set automatically)
+     * @param data Data block
+     * @param len Data length (max MAX_LARGE_PAYLOAD)
+     * @param timeout_ms Time to wait for a TX buffer
+     * @return 0 on success, -EMSGSIZE if len is above maxLargePayload(),
+     *         -ENOTSUP if the peer takes no large frames, negative errno on failure
+     */
+    int sendLarge(const Message& header, const void* data, size_t len,
+                  uint32_t timeout_ms = IPC_TIMEOUT_MS);
+    
+    /**
+     * @brief Send several messages, packed MAX_BATCH to a frame
+     *
+     * One transport frame (one RPMsg buffer and mailbox interrupt) per
+     * MAX_BATCH messages when the peer takes batch frames, one per message
+     * otherwise. The peer queues and handles them one by one, in order.
+     *
+     * @param msgs Messages to send
+     * @param count Number of messages
+     * @param timeout_ms Time to wait for a TX buffer, per frame
+     * @return 0 on success, negative errno on failure (earlier frames sent)
+     */
+    int sendBatch(const Message* msgs, size_t count, uint32_t timeout_ms = IPC_TIMEOUT_MS);
+    
     /**
      * @brief Register callback for specific message type
      * @param type Message type to listen for
@@ -191,12 +358,62 @@ public:
      */
     void unregisterCallback(MessageType type);
     
+    /**
+     * @brief Register callback for large frames of a message type
+     * @param type Message type to listen for
+     * @param callback Function to call with header and data block
+     */
+    void registerLargeCallback(MessageType type, LargeMessageCallback callback);
+    
+    /**
+     * @brief Register a callback for link loss and recovery
+     *
+     * Not called for the first binding in init().
+     */
+    void registerLinkCallback(LinkCallback callback);
+    
+    /**
+     * @brief Tune link monitoring - both cores should use the same values
+     *
+     * The link is monitored when both cores announce IPC_CAP_HEARTBEAT.
+     * A peer silent for timeout_ms is declared down, so a reset is seen
+     * within timeout_ms plus idle_ms / 2.
+     *
+     * @param idle_ms PING after this long without TX (0 = not monitored)
+     * @param timeout_ms Link down after this long without RX
+     * @return 0 on success, -EINVAL if monitored and timeout_ms <= idle_ms
+     */
+    int setHeartbeat(uint32_t idle_ms, uint32_t timeout_ms);
+    
     /**
      * @brief Check if IPC is ready for communication
      * @return true if ready, false otherwise
      */
     bool isReady() const { return m_ready; }
     
+    /**
+     * @brief What the peer announced in its last HELLO
+     */
+    const LinkInfo& getPeerInfo() const { return m_peer; }
+    
+    /**
+     * @brief Check if the peer has a handler for a message type
+     *
+     * Advisory: send() does not check it, since the peer may register
+     * handlers after its first HELLO.
+     */
+    bool peerSupports(MessageType type) const;
+    
+    /**
+     * @brief Check a capability both cores have (IPC_CAP_*)
+     */
+    bool linkHas(uint32_t cap) const { return (m_link_caps & cap) != 0; }
+    
+    /**
+     * @brief Largest data block both cores take in a large frame
+     */
+    uint16_t maxLargePayload() const { return m_max_large; }
+    
     /**
      * @brief Get statistics for monitoring
      */
@@ -207,6 +424,17 @@ public:
         uint32_t rx_errors;
         uint32_t dropped_messages;
         uint32_t buffer_overruns;
+        uint32_t large_tx_count;
+        uint32_t large_rx_count;
+        uint32_t tx_busy_retries;     // Large, batch and HELLO sends that waited for a TX buffer
+        uint32_t rx_queue_peak;       // Most messages waiting for the RX thread
+        uint32_t batch_tx_count;      // Batch frames sent
+        uint32_t batch_rx_count;      // Batch frames received
+        uint32_t refused_peers;       // HELLOs with another protocol major
+        uint32_t heartbeats;          // PINGs sent on an idle link
+        uint32_t link_outages;        // Times the link went down after init
+        uint32_t link_down_ms;        // Time spent down, outages that ended
+        uint32_t rebinds;             // Peer asked for HELLO on a live link (it restarted)
     };
     
     const Statistics& getStats() const { return m_stats; }
@@ -214,29 +442,73 @@ public:
     
 private:
     /* Private constructor for singleton */
-    IPCCore();
+    explicit IPCCore(Core core);
     ~IPCCore() = default;
     
     /*=========================================================================
      * Internal State
      *=======================================================================*/
     
+    /* Where the HELLO exchange stands */
+    enum class PeerState : uint8_t {
+        UNKNOWN,        // No HELLO yet - only HELLOs are taken
+        ACCEPTED,
+        REFUSED         // Protocol major differs - only HELLOs are taken
+    };
+    
+    Core m_core;
     bool m_ready;
     uint8_t m_sequence_counter;
-    struct ipc_ept m_endpoint;
-    struct ipc_ept_cfg m_endpoint_cfg;
+    IpcTransport* m_transport;
     Statistics m_stats;
     
+    /* Peer from the HELLO handshake - state set on the RX thread, read by senders */
+    atomic_t m_peer_state;            // PeerState
+    LinkInfo m_peer;
+    uint32_t m_link_caps;             // Local caps the peer has too
+    uint16_t m_max_large;
+    
+    /* Link monitoring - timestamps are k_uptime_get_32() */
+    bool m_started;                   // RX thread running, link monitored
+    bool m_link_lost;                 // Was up, down since m_down_since_ms
+    atomic_t m_bound;                 // Endpoint bound at least once
+    uint32_t m_heartbeat_idle_ms;
+    uint32_t m_link_timeout_ms;
+    atomic_t m_last_rx_ms;            // Set by the transport callback
+    uint32_t m_last_tx_ms;
+    uint32_t m_last_hello_ms;
+    uint32_t m_down_since_ms;
+    
     /* Message queues - static allocation */
     struct k_msgq m_tx_queue;
     struct k_msgq m_rx_queue;
     char m_tx_queue_buffer[MAX_MESSAGE_QUEUE * sizeof(Message)];
     char m_rx_queue_buffer[MAX_MESSAGE_QUEUE * sizeof(Message)];
     
+    /* Large frames - separate queue so bulk data never starves control messages */
+#pragma pack(push, 1)
+    struct LargeFrame {
+        Message header;
+        uint8_t data[MAX_LARGE_PAYLOAD];
+    };
+#pragma pack(pop)
+    struct LargeRxEntry {
+        uint16_t len;
+        LargeFrame frame;
+    };
+    struct k_msgq m_large_rx_queue;
+    char m_large_rx_queue_buffer[LARGE_RX_QUEUE_DEPTH * sizeof(LargeRxEntry)];
+    LargeRxEntry m_large_rx_in;       // Copied out of the transport buffer
+    LargeRxEntry m_large_rx_out;      // Being dispatched by the RX thread
+    LargeFrame m_large_tx_frame;
+    Message m_batch_tx_frame[MAX_BATCH];
+    struct k_sem m_rx_sem;            // Counts queued frames of both kinds, and wakeups
+    
     /* Synchronization primitives */
     struct k_mutex m_tx_mutex;
     struct k_sem m_ack_sem;
-    struct k_sem m_ready_sem;
+    struct k_sem m_ready_sem;         // Peer HELLO handled
+    struct k_sem m_bound_sem;
     
     /* Callback registry - fixed size for memory efficiency */
     static constexpr uint8_t MAX_CALLBACKS = 16;
@@ -247,28 +519,59 @@ private:
     };
     CallbackEntry m_callbacks[MAX_CALLBACKS];
     
-    /* Worker thread for RX processing */
+    static constexpr uint8_t MAX_LARGE_CALLBACKS = 4;
+    struct LargeCallbackEntry {
+        MessageType type;
+        LargeMessageCallback callback;
+        bool active;
+    };
+    LargeCallbackEntry m_large_callbacks[MAX_LARGE_CALLBACKS];
+    
+    static constexpr uint8_t MAX_LINK_CALLBACKS = 4;
+    LinkCallback m_link_callbacks[MAX_LINK_CALLBACKS];
+    
+    /* Worker thread for RX processing (large handlers may write flash) */
+    static constexpr size_t RX_STACK_SIZE = 2048;
     struct k_thread m_rx_thread;
-    K_KERNEL_STACK_MEMBER(m_rx_stack, 1024);
+    K_KERNEL_STACK_MEMBER(m_rx_stack, RX_STACK_SIZE);
     
     /*=========================================================================
      * Internal Methods
      *=======================================================================*/
     
-    /* IPC service callbacks (static - called by Zephyr) */
+    /* Transport callbacks (static - ipc_service signatures) */
     static void onEndpointBound(void *priv);
     static void onMessageReceived(const void *data, size_t len, void *priv);
     static void onError(const char *message, void *priv);
     
     /* Message processing */
+    void queueMessage(const Message* msg);
     void processReceivedMessage(const Message& msg);
     void dispatchMessage(const Message& msg);
+    void dispatchLargeMessage(const LargeRxEntry& entry);
     
     /* Worker thread entry point */
     static void rxThreadEntry(void *p1, void *p2, void *p3);
     void rxThreadLoop();
     
+    /* Handshake */
+    PeerState peerState() const {
+        return static_cast<PeerState>(atomic_get(&m_peer_state));
+    }
+    int sendHello(bool want_reply, uint32_t timeout_ms = IPC_TIMEOUT_MS);
+    void handleHello(const Message& msg);
+    bool handlesType(MessageType type) const;
+    uint32_t localCaps() const;
+    
+    /* Link monitoring (RX thread) */
+    k_timeout_t checkPeriod() const;
+    void checkLink();
+    void sendPing();
+    void linkDown(PeerState state);
+    void notifyLink(bool up);
+    
     /* Helper methods */
+    int transmit(const void* frame, size_t len, uint32_t timeout_ms);
     bool validateMessage(const Message& msg) const;
     void updateStats(bool tx, bool error);
 };
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ipc_loopback.hpp"
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(ipc_loopback, CONFIG_LOG_DEFAULT_LEVEL);
+
+/* Pairing and binding of all links */
+static K_MUTEX_DEFINE(loopback_link_mutex);
+
+namespace smarthome { namespace ipc {
+
+/*=============================================================================
+ * Constructor
+ *===========================================================================*/
+
+LoopbackTransport::LoopbackTransport()
+    : m_peer(nullptr)
+    , m_open(false)
+    , m_cb{}
+    , m_priv(nullptr)
+    , m_config{}
+    , m_rand(0)
+    , m_last_due_ms(0)
+    , m_stats{}
+{
+    k_msgq_init(&m_inbound, m_inbound_buffer, sizeof(Frame), QUEUE_DEPTH);
+    k_sem_init(&m_inbound_free, QUEUE_DEPTH, QUEUE_DEPTH);
+    k_mutex_init(&m_tx_mutex);
+    configure(m_config);
+}
+
+void LoopbackTransport::connect(LoopbackTransport& a, LoopbackTransport& b) {
+    k_mutex_lock(&loopback_link_mutex, K_FOREVER);
+    a.m_peer = &b;
+    b.m_peer = &a;
+    k_mutex_unlock(&loopback_link_mutex);
+}
+
+void LoopbackTransport::configure(const LoopbackConfig& config) {
+    k_mutex_lock(&m_tx_mutex, K_FOREVER);
+    m_config = config;
+    m_rand = config.seed ? config.seed : 0x2545F491;
+    k_mutex_unlock(&m_tx_mutex);
+}
+
+void LoopbackTransport::resetStats() {
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/*=============================================================================
+ * Link
+ *===========================================================================*/
+
+int LoopbackTransport::open(const TransportCallbacks& cb, void *priv) {
+    k_mutex_lock(&loopback_link_mutex, K_FOREVER);
+
+    if (!m_peer) {
+        k_mutex_unlock(&loopback_link_mutex);
+        LOG_ERR("Loopback end not connected");
+        return -ENOTCONN;
+    }
+
+    if (m_open) {
+        k_mutex_unlock(&loopback_link_mutex);
+        return -EALREADY;
+    }
+
+    m_cb = cb;
+    m_priv = priv;
+    m_open = true;
+
+    k_thread_create(&m_thread, m_stack, K_KERNEL_STACK_SIZEOF(m_stack),
+                    deliveryThreadEntry, this, NULL, NULL,
+                    K_PRIO_COOP(6), 0, K_NO_WAIT);
+    k_thread_name_set(&m_thread, "ipc_loopback");
+
+    /* The second end to open brings the link up for both */
+    bool both = m_peer->m_open;
+
+    k_mutex_unlock(&loopback_link_mutex);
+
+    if (both) {
+        m_peer->bind();
+        bind();
+    }
+    return 0;
+}
+
+void LoopbackTransport::bind() {
+    if (m_cb.bound) {
+        m_cb.bound(m_priv);
+    }
+}
+
+int LoopbackTransport::send(const void *data, size_t len) {
+    if (!m_open || !m_peer->m_open) {
+        return -ENOTCONN;
+    }
+
+    if (len == 0 || len > MAX_FRAME) {
+        return -EMSGSIZE;
+    }
+
+    k_mutex_lock(&m_tx_mutex, K_FOREVER);
+
+    /* Lost on the wire: the sender never finds out */
+    if (m_config.loss_permille && nextRandom() % 1000 < m_config.loss_permille) {
+        m_stats.lost++;
+        k_mutex_unlock(&m_tx_mutex);
+        return static_cast<int>(len);
+    }
+
+    /* A slot stays taken until the peer has handled the frame */
+    if (k_sem_take(&m_peer->m_inbound_free, K_NO_WAIT) < 0) {
+        m_stats.busy++;
+        k_mutex_unlock(&m_tx_mutex);
+        return -ENOMEM;
+    }
+
+    int64_t due = k_uptime_get() + m_config.latency_ms;
+    if (m_config.jitter_ms) {
+        due += nextRandom() % (m_config.jitter_ms + 1);
+    }
+    m_tx_frame.due_ms = MAX(due, m_last_due_ms);
+    m_tx_frame.len = static_cast<uint16_t>(len);
+    memcpy(m_tx_frame.data, data, len);
+
+    (void)k_msgq_put(&m_peer->m_inbound, &m_tx_frame, K_NO_WAIT);
+    m_last_due_ms = m_tx_frame.due_ms;
+    m_stats.sent++;
+
+    k_mutex_unlock(&m_tx_mutex);
+    return static_cast<int>(len);
+}
+
+/* xorshift32 - repeatable, and cheap enough for every frame */
+uint32_t LoopbackTransport::nextRandom() {
+    m_rand ^= m_rand << 13;
+    m_rand ^= m_rand >> 17;
+    m_rand ^= m_rand << 5;
+    return m_rand;
+}
+
+/*=============================================================================
+ * Delivery Thread
+ *===========================================================================*/
+
+void LoopbackTransport::deliveryThreadEntry(void *p1, void *p2, void *p3) {
+    LoopbackTransport *end = static_cast<LoopbackTransport*>(p1);
+    end->deliveryThreadLoop();
+}
+
+void LoopbackTransport::deliveryThreadLoop() {
+    while (1) {
+        k_msgq_get(&m_inbound, &m_rx_frame, K_FOREVER);
+
+        int64_t wait_ms = m_rx_frame.due_ms - k_uptime_get();
+        if (wait_ms > 0) {
+            k_sleep(K_MSEC(wait_ms));
+        }
+
+        m_stats.delivered++;
+        m_cb.received(m_rx_frame.data, m_rx_frame.len, m_priv);
+        k_sem_give(&m_inbound_free);
+    }
+}
+
+}  // namespace ipc
+}  // namespace smarthome
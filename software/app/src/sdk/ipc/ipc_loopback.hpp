@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * Loopback IPC Transport - Both cores in one process
+ * ============================================================================
+ *
+ * Purpose:
+ *   Links two IPCCore instances (IPCCore::getInstance(Core::APP) and
+ *   Core::NET) inside one native_sim image, so APP-side and NET-side logic
+ *   run against each other without nRF5340 hardware.
+ *
+ * Behaviour (matches the RPMsg link the code runs on):
+ *   - Both ends bind once both are open
+ *   - Each direction holds QUEUE_DEPTH frames in flight, a frame until
+ *     the receiver's callback returns; send returns -ENOMEM while they
+ *     are all taken, like the shared TX buffers
+ *   - Frames arrive in order from a delivery thread per end, standing in
+ *     for the mailbox interrupt
+ *
+ * Fault injection (LoopbackConfig), per direction:
+ *   - latency_ms + up to jitter_ms added to every frame, order kept
+ *   - loss_permille of the frames silently dropped on the wire
+ *   - seeded PRNG, so a failing stress run repeats exactly
+ *
+ * Usage:
+ *   static LoopbackTransport app_end, net_end;
+ *   LoopbackTransport::connect(app_end, net_end);
+ *   IPCCore::getInstance(Core::APP).setTransport(app_end);
+ *   IPCCore::getInstance(Core::NET).setTransport(net_end);
+ */
+
+#ifndef IPC_LOOPBACK_HPP
+#define IPC_LOOPBACK_HPP
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include "ipc_core.hpp"
+#include "ipc_transport.hpp"
+
+namespace smarthome { namespace ipc {
+
+struct LoopbackConfig {
+    uint32_t latency_ms;        // Added to every frame sent from this end
+    uint32_t jitter_ms;         // Up to this much more, frames stay in order
+    uint16_t loss_permille;     // Frames dropped per 1000 sent
+    uint32_t seed;              // Jitter/loss PRNG seed (0: fixed default)
+};
+
+class LoopbackTransport : public IpcTransport {
+public:
+    /* Frames in flight per direction (the RPMsg link has as many TX buffers) */
+    static constexpr uint8_t QUEUE_DEPTH = 8;
+    static constexpr size_t MAX_FRAME = sizeof(Message) + IPCCore::MAX_LARGE_PAYLOAD;
+
+    LoopbackTransport();
+    ~LoopbackTransport() = default;
+
+    LoopbackTransport(const LoopbackTransport&) = delete;
+    LoopbackTransport& operator=(const LoopbackTransport&) = delete;
+
+    /**
+     * @brief Pair two ends - before either is opened
+     */
+    static void connect(LoopbackTransport& a, LoopbackTransport& b);
+
+    /**
+     * @brief Set latency and loss for frames sent from this end
+     *
+     * Takes effect from the next send; frames already in flight keep
+     * their delivery time.
+     */
+    void configure(const LoopbackConfig& config);
+
+    int open(const TransportCallbacks& cb, void *priv) override;
+    int send(const void *data, size_t len) override;
+    const char* name() const override { return "loopback"; }
+
+    struct Statistics {
+        uint32_t sent;          // Frames accepted by send()
+        uint32_t delivered;     // Frames handed to this end's receiver
+        uint32_t lost;          // Frames sent from this end and dropped
+        uint32_t busy;          // Sends refused with -ENOMEM
+    };
+
+    const Statistics& getStats() const { return m_stats; }
+    void resetStats();
+
+private:
+    struct Frame {
+        int64_t due_ms;
+        uint16_t len;
+        uint8_t data[MAX_FRAME];
+    };
+
+    LoopbackTransport* m_peer;
+    bool m_open;
+    TransportCallbacks m_cb;
+    void* m_priv;
+
+    LoopbackConfig m_config;
+    uint32_t m_rand;
+    int64_t m_last_due_ms;      // Of the last frame sent, keeps order under jitter
+    Statistics m_stats;
+
+    /* Frames on their way to this end, and the free slots for more */
+    struct k_msgq m_inbound;
+    struct k_sem m_inbound_free;
+    char m_inbound_buffer[QUEUE_DEPTH * sizeof(Frame)];
+    Frame m_rx_frame;
+    Frame m_tx_frame;           // Assembled under m_tx_mutex
+
+    struct k_mutex m_tx_mutex;
+    struct k_thread m_thread;
+    K_KERNEL_STACK_MEMBER(m_stack, 2048);
+
+    uint32_t nextRandom();
+    void bind();
+
+    static void deliveryThreadEntry(void *p1, void *p2, void *p3);
+    void deliveryThreadLoop();
+};
+
+}  // namespace ipc
+}  // namespace smarthome
+
+#endif  // IPC_LOOPBACK_HPP
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ipc_transport.hpp"
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(ipc_transport, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace ipc {
+
+/*=============================================================================
+ * OpenAMP Transport
+ *===========================================================================*/
+
+OpenAmpTransport& OpenAmpTransport::getInstance() {
+    static OpenAmpTransport instance;
+    return instance;
+}
+
+OpenAmpTransport::OpenAmpTransport()
+    : m_endpoint{}
+    , m_endpoint_cfg{}
+{
+}
+
+int OpenAmpTransport::open(const TransportCallbacks& cb, void *priv) {
+    m_endpoint_cfg.name = "ipc_core";
+    m_endpoint_cfg.cb = {
+        .bound    = cb.bound,
+        .received = cb.received,
+        .error    = cb.error,
+    };
+    m_endpoint_cfg.priv = priv;
+
+    /* Open OpenAMP instance (NO device) */
+    int ret = ipc_service_open_instance(NULL);
+    if (ret < 0 && ret != -EALREADY) {
+        LOG_ERR("Failed to open IPC instance: %d", ret);
+        return ret;
+    }
+
+    /* Register endpoint (instance = NULL for OpenAMP) */
+    ret = ipc_service_register_endpoint(NULL, &m_endpoint, &m_endpoint_cfg);
+    if (ret < 0) {
+        LOG_ERR("Failed to register endpoint: %d", ret);
+        return ret;
+    }
+
+    return 0;
+}
+
+int OpenAmpTransport::send(const void *data, size_t len) {
+    return ipc_service_send(&m_endpoint, data, len);
+}
+
+int OpenAmpTransport::reopen() {
+    /* The old endpoint points at RPMsg state the peer dropped on reset */
+    int ret = ipc_service_deregister_endpoint(&m_endpoint);
+    if (ret < 0 && ret != -ENOENT) {
+        LOG_WRN("Failed to deregister endpoint: %d", ret);
+    }
+
+    ret = ipc_service_register_endpoint(NULL, &m_endpoint, &m_endpoint_cfg);
+    if (ret < 0) {
+        LOG_ERR("Failed to register endpoint again: %d", ret);
+        return ret;
+    }
+
+    return 0;
+}
+
+}  // namespace ipc
+}  // namespace smarthome
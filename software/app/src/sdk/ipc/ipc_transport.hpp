@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * IPC Transport - Link layer under IPCCore
+ * ============================================================================
+ *
+ * Purpose:
+ *   IPCCore frames messages; a transport moves the frames to the other core.
+ *   OpenAmpTransport is the RPMsg endpoint on the nRF5340 and the default.
+ *   LoopbackTransport (ipc_loopback.hpp) links two IPCCore instances in one
+ *   process so both cores run together on native_sim.
+ *
+ * Contract (the ipc_service endpoint semantics IPCCore was written against):
+ *   - bound is called once the peer endpoint is up, from any context
+ *   - received is called once per frame; data is valid during the call only
+ *   - send returns the bytes sent, -ENOMEM while no TX buffer is free
+ */
+
+#ifndef IPC_TRANSPORT_HPP
+#define IPC_TRANSPORT_HPP
+
+#include <zephyr/kernel.h>
+#include <zephyr/ipc/ipc_service.h>
+#include <stddef.h>
+
+namespace smarthome { namespace ipc {
+
+/* Same signatures as struct ipc_service_cb, so both plug in unchanged */
+struct TransportCallbacks {
+    void (*bound)(void *priv);
+    void (*received)(const void *data, size_t len, void *priv);
+    void (*error)(const char *message, void *priv);
+};
+
+class IpcTransport {
+public:
+    /**
+     * @brief Open the link to the peer core
+     * @param cb Link callbacks
+     * @param priv Passed back to every callback
+     * @return 0 on success, negative errno on failure
+     */
+    virtual int open(const TransportCallbacks& cb, void *priv) = 0;
+
+    /**
+     * @brief Send one frame
+     * @return Bytes sent, -ENOMEM while no TX buffer is free, negative errno on failure
+     */
+    virtual int send(const void *data, size_t len) = 0;
+
+    /**
+     * @brief Register the endpoint again after the peer core reset
+     *
+     * The bound callback runs again once the peer has registered its own.
+     * Links that survive a peer reset need nothing.
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    virtual int reopen() { return 0; }
+
+    /**
+     * @brief Transport name for logs
+     */
+    virtual const char* name() const = 0;
+
+protected:
+    /* Transports are static objects - never deleted through the interface */
+    ~IpcTransport() = default;
+};
+
+/*=============================================================================
+ * OpenAMP Transport - RPMsg endpoint over the shared-memory IPC service
+ *===========================================================================*/
+
+class OpenAmpTransport : public IpcTransport {
+public:
+    static OpenAmpTransport& getInstance();
+
+    OpenAmpTransport(const OpenAmpTransport&) = delete;
+    OpenAmpTransport& operator=(const OpenAmpTransport&) = delete;
+
+    int open(const TransportCallbacks& cb, void *priv) override;
+    int send(const void *data, size_t len) override;
+    int reopen() override;
+    const char* name() const override { return "OpenAMP"; }
+
+private:
+    OpenAmpTransport();
+    ~OpenAmpTransport() = default;
+
+    struct ipc_ept m_endpoint;
+    struct ipc_ept_cfg m_endpoint_cfg;
+};
+
+}  // namespace ipc
+}  // namespace smarthome
+
+#endif  // IPC_TRANSPORT_HPP
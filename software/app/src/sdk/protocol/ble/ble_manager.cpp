@@ -9,6 +9,7 @@
 
 #ifdef CONFIG_BT
 #include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
 #endif
 
 LOG_MODULE_REGISTER(ble_manager, CONFIG_LOG_DEFAULT_LEVEL);
@@ -25,6 +26,7 @@ BLEManager::BLEManager()
     , m_enabled(false)
     , m_advertising(false)
     , m_adv_interval_ms(0)
+    , m_conn_callback(nullptr)
 {
     k_mutex_init(&m_mutex);
 }
@@ -77,6 +79,10 @@ int BLEManager::init() {
 }
 
 int BLEManager::startAdvertising(uint16_t interval_ms) {
+    if (interval_ms < ADV_INTERVAL_MIN_MS || interval_ms > ADV_INTERVAL_MAX_MS) {
+        return -EINVAL;
+    }
+    
     k_mutex_lock(&m_mutex, K_FOREVER);
     
     if (!m_enabled) {
@@ -120,6 +126,42 @@ int BLEManager::stopAdvertising() {
     return 0;
 }
 
+void BLEManager::onConnectionChanged(bool connected) {
+    k_mutex_lock(&m_mutex, K_FOREVER);
+    
+    if (connected) {
+        LOG_INF("BLE Manager: Central connected");
+        m_state = BLEState::CONNECTED;
+    } else {
+        LOG_INF("BLE Manager: Connection closed");
+        m_state = m_advertising ? BLEState::ADVERTISING : BLEState::IDLE;
+    }
+    ConnectionCallback callback = m_conn_callback;
+    
+    k_mutex_unlock(&m_mutex);
+    
+    if (callback) {
+        callback(connected);
+    }
+}
+
 } // namespace ble
 } // namespace protocol
 } // namespace smarthome
+
+#ifdef CONFIG_BT
+static void ble_connected(struct bt_conn* conn, uint8_t err) {
+    if (err == 0) {
+        smarthome::protocol::ble::BLEManager::getInstance().onConnectionChanged(true);
+    }
+}
+
+static void ble_disconnected(struct bt_conn* conn, uint8_t reason) {
+    smarthome::protocol::ble::BLEManager::getInstance().onConnectionChanged(false);
+}
+
+BT_CONN_CB_DEFINE(ble_manager_conn_callbacks) = {
+    .connected = ble_connected,
+    .disconnected = ble_disconnected,
+};
+#endif
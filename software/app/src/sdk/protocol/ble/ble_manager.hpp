@@ -26,8 +26,15 @@ enum class BLEState : uint8_t {
     ERROR = 5
 };
 
+/// Connection state change (Bluetooth RX thread)
+using ConnectionCallback = void (*)(bool connected);
+
 class BLEManager {
 public:
+    /* Advertising interval range of the Core specification (20 ms - 10.24 s) */
+    static constexpr uint16_t ADV_INTERVAL_MIN_MS = 20;
+    static constexpr uint16_t ADV_INTERVAL_MAX_MS = 10240;
+    
     static BLEManager& getInstance();
     
     BLEManager(const BLEManager&) = delete;
@@ -41,6 +48,8 @@ public:
     /**
      * @brief Start BLE advertising
      * @param interval_ms Advertising interval in milliseconds
+     * @return 0 on success (also if already advertising), -EINVAL for an
+     *         interval out of range, -ENOTSUP while BLE is disabled
      */
     int startAdvertising(uint16_t interval_ms);
     
@@ -69,6 +78,16 @@ public:
      */
     const char* getStateString() const;
     
+    /**
+     * @brief Set the callback for connections and disconnections
+     */
+    void setConnectionCallback(ConnectionCallback callback) { m_conn_callback = callback; }
+    
+    /**
+     * @brief Track a connection change (from the Bluetooth connection callbacks)
+     */
+    void onConnectionChanged(bool connected);
+    
 private:
     BLEManager();
     ~BLEManager() = default;
@@ -77,6 +96,7 @@ private:
     bool m_enabled;
     bool m_advertising;
     uint16_t m_adv_interval_ms;
+    ConnectionCallback m_conn_callback;
     struct k_mutex m_mutex;
 };
 
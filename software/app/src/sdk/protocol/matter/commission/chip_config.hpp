@@ -40,14 +40,19 @@ constexpr const char* SERIAL_NUMBER = "MLT-2024-0001";
  * Matter Commissioning Parameters
  * =========================================================================== */
 
-// Default PIN code for manual commissioning (0-99999999)
-// NOTE: Should be unique per device, stored in factory data
-constexpr uint32_t COMMISSIONABLE_PIN_CODE = 12345678;
+// Development PIN code, used only without factory data (0-99999999)
+// Matter test passcode; sequences such as 12345678 are invalid by spec.
+// Production devices get theirs from factory_partition (gen_factory_data.py)
+constexpr uint32_t COMMISSIONABLE_PIN_CODE = 20202021;
 
 // Discriminator for BLE commissioning (12-bit value: 0-4095)
 // Used to identify device during commissioning
-// NOTE: Should be unique per device
-constexpr uint16_t COMMISSIONING_DISCRIMINATOR = 0xF00D;  // 61453
+// NOTE: Should be unique per device, stored in factory data
+constexpr uint16_t COMMISSIONING_DISCRIMINATOR = 3840;  // 0xF00
+
+// SPAKE2+ PBKDF2 iteration bounds accepted in factory data
+constexpr uint32_t SPAKE2P_MIN_ITERATIONS = 1000;
+constexpr uint32_t SPAKE2P_MAX_ITERATIONS = 100000;
 
 // BLE advertising interval for commissioning (ms)
 constexpr uint32_t COMMISSIONING_BLE_INTERVAL_MS = 100;
@@ -55,10 +60,32 @@ constexpr uint32_t COMMISSIONING_BLE_INTERVAL_MS = 100;
 // Commissioning window timeout (seconds)
 // How long commissioning window stays open before closing
 constexpr uint32_t COMMISSIONING_WINDOW_TIMEOUT_SEC = 600;  // 10 minutes
+
+// Sleepy devices poll fast for this long after the window opens (ms), so
+// the commissioner's messages are not held at the parent for a slow poll.
+// Also the longest fast-poll burst accepted.
+constexpr uint32_t COMMISSIONING_FAST_POLL_MS = COMMISSIONING_WINDOW_TIMEOUT_SEC * 1000;
     
 // Maximum commissioning attempts before lockout
 constexpr uint8_t MAX_COMMISSIONING_ATTEMPTS = 10;
 
+// Commissioning attempts whose stage timings are kept (persisted, oldest overwritten)
+constexpr uint8_t COMMISSIONING_HISTORY_DEPTH = 8;
+
+// Fabrics the device can join at once (spec minimum: 5 -
+// e.g. Google Home, Apple Home and our own controller, with room to spare)
+constexpr uint8_t FABRIC_TABLE_CAPACITY = 5;
+
+// Fabrics whose certificates are held in RAM at once; the rest are read
+// from storage when a session for them is established
+constexpr uint8_t FABRIC_CREDENTIAL_CACHE_SLOTS = 2;
+
+// Largest Matter TLV certificate (NOC, ICAC or RCAC), bytes
+constexpr uint16_t FABRIC_CERT_MAX_LEN = 400;
+
+// Longest fabric label (Operational Credentials cluster), characters
+constexpr uint8_t FABRIC_LABEL_MAX_LEN = 32;
+
 /* ===========================================================================
  * Endpoint & Cluster Configuration
  * =========================================================================== */
@@ -69,8 +96,31 @@ constexpr uint8_t ROOT_ENDPOINT_ID = 0;
 // Light endpoint ID (first custom endpoint)
 constexpr uint8_t LIGHT_ENDPOINT_ID = 1;
 
-// Maximum number of endpoints
-constexpr uint8_t MAX_ENDPOINTS = 2;
+// Light endpoints, one per LED: IDs LIGHT_ENDPOINT_ID .. LIGHT_ENDPOINT_ID + count - 1
+constexpr uint8_t LIGHT_ENDPOINT_COUNT = 4;
+
+// Maximum number of endpoints (root + lights)
+constexpr uint8_t MAX_ENDPOINTS = 1 + LIGHT_ENDPOINT_COUNT;
+
+// Delay before changed light attributes are written to flash (ms);
+// changes within the window share one write per endpoint
+constexpr uint32_t LIGHT_PERSIST_DELAY_MS = 1000;
+
+// Distinct groups across the light endpoints (spec minimum: 4 per endpoint
+// with the same groups typically shared by all of them)
+constexpr uint8_t GROUP_TABLE_CAPACITY = 8;
+
+// Scenes across the light endpoints (one entry per endpoint and scene)
+constexpr uint8_t SCENE_TABLE_CAPACITY = 16;
+
+// Identify cluster ID
+constexpr uint16_t IDENTIFY_CLUSTER_ID = 0x0003;
+
+// Groups cluster ID
+constexpr uint16_t GROUPS_CLUSTER_ID = 0x0004;
+
+// Scenes cluster ID
+constexpr uint16_t SCENES_CLUSTER_ID = 0x0005;
 
 // OnOff cluster ID
 constexpr uint16_t ON_OFF_CLUSTER_ID = 0x0006;
@@ -78,9 +128,24 @@ constexpr uint16_t ON_OFF_CLUSTER_ID = 0x0006;
 // Level Control cluster ID
 constexpr uint16_t LEVEL_CONTROL_CLUSTER_ID = 0x0008;
 
-// Color Control cluster ID (optional)
+// Color Control cluster ID (color temperature only)
 constexpr uint16_t COLOR_CONTROL_CLUSTER_ID = 0x0300;
 
+// Color temperature range of the warm/cool white channels (mireds):
+// 153 = 6500 K cool channel, 500 = 2000 K warm channel
+constexpr uint16_t COLOR_TEMP_MIN_MIREDS = 153;
+constexpr uint16_t COLOR_TEMP_MAX_MIREDS = 500;
+
+// Color temperature of a light never set (mireds, 4000 K)
+constexpr uint16_t COLOR_TEMP_DEFAULT_MIREDS = 250;
+
+// Step of level / color temperature transitions and light effects (ms);
+// all endpoints in a transition or effect move together on one tick
+constexpr uint32_t LIGHT_TRANSITION_TICK_MS = 20;
+
+// Length of the fade on / fade off effects and of the fade-in at boot (ms)
+constexpr uint32_t LIGHT_FADE_MS = 500;
+
 /* ===========================================================================
  * Thread/OpenThread Configuration
  * =========================================================================== */
@@ -110,20 +175,36 @@ constexpr uint32_t THREAD_ROUTER_DOWNGRADE_TIMEOUT_SEC = 900;
 // Network reconnection retry attempts
 constexpr uint8_t MAX_RECONNECT_ATTEMPTS = 15;
 
-// Initial reconnection delay (ms)
-constexpr uint32_t INITIAL_RECONNECT_DELAY_MS = 1000;
+// Initial reconnection delay (ms). The first Thread restart comes no
+// sooner than half of it, after OpenThread's own attach cycle (a few s)
+constexpr uint32_t INITIAL_RECONNECT_DELAY_MS = 20000;
 
 // Maximum reconnection delay (ms) with exponential backoff
 constexpr uint32_t MAX_RECONNECT_DELAY_MS = 60000;  // 60 seconds
 
-// Exponential backoff multiplier for reconnection delay
-constexpr float RECONNECT_BACKOFF_MULTIPLIER = 1.5f;
+// Exponential backoff multiplier for reconnection delay (Q8.8, 384 = 1.5x)
+constexpr uint16_t RECONNECT_BACKOFF_MULTIPLIER_Q8 = 384;
 
 // Link down timeout before attempting reconnect (ms)
 constexpr uint32_t LINK_DOWN_TIMEOUT_MS = 30000;
 
-// Network health check interval (seconds)
-constexpr uint32_t NETWORK_HEALTH_CHECK_INTERVAL_SEC = 60;
+// Network health check / link sampling interval (seconds)
+// Six samples make the one-minute packet loss window
+constexpr uint32_t NETWORK_HEALTH_CHECK_INTERVAL_SEC = 10;
+
+// Lateness allowed for a link sample (ms), so it shares a wakeup with
+// other timers on the timer wheel
+constexpr uint32_t NETWORK_HEALTH_CHECK_SLACK_MS = 1000;
+
+// Proactive parent switching: POOR this long (ms) before a parent search,
+// well inside LINK_DOWN_TIMEOUT_MS so the switch beats a full detach
+constexpr uint32_t PARENT_SWITCH_POOR_WINDOW_MS = 10000;
+
+// Time allowed for Parent Responses after a search (ms)
+constexpr uint32_t PARENT_SEARCH_WINDOW_MS = 5000;
+
+// Parent searches per POOR episode
+constexpr uint8_t PARENT_SWITCH_MAX_SEARCHES = 3;
 
 /* ===========================================================================
  * Persistent Storage (NVS) Configuration
@@ -170,6 +251,9 @@ constexpr uint32_t UPTIME_TRACK_INTERVAL_SEC = 3600;  // 1 hour
 // Network diagnostic collection interval (seconds)
 constexpr uint32_t NETWORK_DIAG_INTERVAL_SEC = 300;  // 5 minutes
 
+// Network diagnostic snapshots kept in RAM (oldest overwritten)
+constexpr uint8_t NETWORK_DIAG_HISTORY_DEPTH = 8;
+
 // Memory usage report threshold (MB)
 constexpr uint32_t MEMORY_WARN_THRESHOLD_PERCENT = 85;
 
@@ -7,15 +7,25 @@
 
 #include "commissioning_delegate.hpp"
 #include "chip_config.hpp"
+#include "factory_data.hpp"
 #include "../ipc/ipc_core.hpp"
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/settings/settings.h>
+#include <cstdlib>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
 
 LOG_MODULE_REGISTER(commish_delegate, CONFIG_LOG_DEFAULT_LEVEL);
 
 using namespace smarthome::ipc;
 
+#define TIMELINE_KEY "matter/commish/history"
+#define COMMISSIONED_KEY "matter/fabric/commissioned"
+#define FABRIC_COUNT_KEY "matter/fabric/count"
+
 namespace smarthome { namespace protocol { namespace matter {
 
 CommissioningDelegate& CommissioningDelegate::getInstance() {
@@ -29,9 +39,12 @@ CommissioningDelegate::CommissioningDelegate()
     , commissioning_timeout_sec_(0)
     , commissioning_passcode_(COMMISSIONABLE_PIN_CODE)
     , commissioning_discriminator_(COMMISSIONING_DISCRIMINATOR)
+    , factory_(nullptr)
     , completion_callback_(nullptr)
 {
-    k_timer_init(&commissioning_timer_, nullptr, nullptr);
+    k_mutex_init(&timeline_mutex_);
+    k_mutex_init(&fabric_mutex_);
+    k_work_init(&persist_work_, persistWorkHandler);
 }
 
 CommissioningDelegate::~CommissioningDelegate() {
@@ -39,8 +52,40 @@ CommissioningDelegate::~CommissioningDelegate() {
 
 int CommissioningDelegate::init() {
     LOG_INF("Initializing Commissioning Delegate");
-    LOG_INF("Passcode: %08d", commissioning_passcode_);
-    LOG_INF("Discriminator: %04x", commissioning_discriminator_);
+
+    int ret = FactoryData::getInstance().load();
+    if (ret == 0) {
+        factory_ = FactoryData::getInstance().get();
+        commissioning_passcode_ = factory_->passcode;
+        commissioning_discriminator_ = factory_->discriminator;
+        LOG_INF("Setup payload: %s, manual code: %s",
+                factory_->qr_code, factory_->manual_code);
+    } else {
+        /* Development boards: test credentials, verifier derived at PASE time */
+        LOG_WRN("No factory data (%d) - using development passcode", ret);
+        LOG_INF("Passcode: %08u", commissioning_passcode_);
+    }
+    LOG_INF("Discriminator: %u", commissioning_discriminator_);
+
+    loadTimeline();
+
+    // Records only; certificates wait for a session on their fabric
+    k_mutex_lock(&fabric_mutex_, K_FOREVER);
+    int fabrics = fabrics_.load();
+    k_mutex_unlock(&fabric_mutex_);
+    if (fabrics < 0) {
+        LOG_ERR("Failed to load fabric table: %d", fabrics);
+    } else if (fabrics > 0) {
+        LOG_INF("Fabric table: %d of %u fabrics", fabrics, FabricTable::CAPACITY);
+    }
+
+    // Stage events from the NET core
+    IPCCore& ipc = IPCCore::getInstance();
+    ipc.registerCallback(MessageType::ACK, onIpcAck);
+    ipc.registerCallback(MessageType::NACK, onIpcAck);
+    ipc.registerCallback(MessageType::BLE_CONNECT, onIpcBleConnect);
+    ipc.registerLinkCallback(onIpcLink);
+
     LOG_INF("Device ready for commissioning");
     
     return 0;
@@ -53,31 +98,21 @@ int CommissioningDelegate::openCommissioningWindow(uint32_t timeout_sec) {
     }
     
     LOG_INF("Opening commissioning window for %d seconds", timeout_sec);
-    LOG_INF("Discriminator: %04x, Passcode: %08d", 
-            commissioning_discriminator_, commissioning_passcode_);
+    LOG_INF("Discriminator: %u", commissioning_discriminator_);
     
     commissioning_open_ = true;
     commissioning_start_time_ = k_uptime_get_32();
     commissioning_timeout_sec_ = timeout_sec;
     
-    k_timer_start(&commissioning_timer_, K_SECONDS(timeout_sec), K_NO_WAIT);
+    k_mutex_lock(&timeline_mutex_, K_FOREVER);
+    timeline_.begin(commissioning_start_time_);
+    k_mutex_unlock(&timeline_mutex_);
     
-    // Send IPC message to NET core to start BLE advertisement
-    Message ble_msg;
-    ble_msg.type = MessageType::BLE_ADV_START;
-    ble_msg.priority = Priority::HIGH;
-    ble_msg.flags = 0x06; // Connectable + Discoverable
-    ble_msg.sequence_id = 0;
-    ble_msg.timestamp = k_uptime_get_32();
-    ble_msg.payload.ble.adv_interval_ms = 100;
-    ble_msg.payload.ble.adv_type = 0;
-    ble_msg.payload.ble.adv_data_len = 0;
-    
-    int ret = IPCCore::getInstance().send(ble_msg);
+    int ret = sendAdvertising(true);
     if (ret < 0) {
         LOG_ERR("Failed to start BLE advertising: %d", ret);
         commissioning_open_ = false;
-        k_timer_stop(&commissioning_timer_);
+        finishAttempt(AttemptOutcome::FAILED);
         return ret;
     }
     
@@ -92,18 +127,12 @@ int CommissioningDelegate::closeCommissioningWindow() {
     
     LOG_INF("Closing commissioning window");
     
-    k_timer_stop(&commissioning_timer_);
-    commissioning_open_ = false;
+    // A completed attempt has its outcome already
+    finishAttempt(getTimeRemaining() == 0 ? AttemptOutcome::TIMEOUT : AttemptOutcome::CANCELLED);
     
-    // Send IPC message to NET core to stop BLE advertisement
-    Message ble_msg;
-    ble_msg.type = MessageType::BLE_ADV_STOP;
-    ble_msg.priority = Priority::NORMAL;
-    ble_msg.flags = 0;
-    ble_msg.sequence_id = 0;
-    ble_msg.timestamp = k_uptime_get_32();
+    commissioning_open_ = false;
     
-    int ret = IPCCore::getInstance().send(ble_msg);
+    int ret = sendAdvertising(false);
     if (ret < 0) {
         LOG_ERR("Failed to stop BLE advertising: %d", ret);
     }
@@ -111,6 +140,23 @@ int CommissioningDelegate::closeCommissioningWindow() {
     return 0;
 }
 
+int CommissioningDelegate::sendAdvertising(bool start) {
+    // IPC message to the NET core to start or stop BLE advertisement
+    Message ble_msg;
+    ble_msg.type = start ? MessageType::BLE_ADV_START : MessageType::BLE_ADV_STOP;
+    ble_msg.priority = start ? Priority::HIGH : Priority::NORMAL;
+    ble_msg.flags = start ? 0x06 : 0; // Connectable + Discoverable
+    ble_msg.sequence_id = 0;
+    ble_msg.timestamp = k_uptime_get_32();
+    if (start) {
+        ble_msg.payload.ble.adv_interval_ms = 100;
+        ble_msg.payload.ble.adv_type = 0;
+        ble_msg.payload.ble.adv_data_len = 0;
+    }
+    
+    return IPCCore::getInstance().send(ble_msg);
+}
+
 bool CommissioningDelegate::isCommissioningOpen() const {
     return commissioning_open_;
 }
@@ -118,29 +164,37 @@ bool CommissioningDelegate::isCommissioningOpen() const {
 bool CommissioningDelegate::isCommissioned() const {
     // Check if device has fabric info stored
     // Use settings_get_val_len to check if the key exists
-    ssize_t len = settings_get_val_len("matter/fabric/commissioned");
+    ssize_t len = settings_get_val_len(COMMISSIONED_KEY);
     // If length > 0, the key exists and device is commissioned
     return (len > 0);
 }
 
-void CommissioningDelegate::onFabricAdded() {
-    LOG_INF("=== FABRIC ADDED - Device Commissioned ===");
+int CommissioningDelegate::onFabricAdded(const FabricDescriptor& fabric,
+                                         const CertificateChain& chain) {
+    k_mutex_lock(&fabric_mutex_, K_FOREVER);
+    int index = fabrics_.add(fabric, chain);
+    uint8_t count = fabrics_.size();
+    k_mutex_unlock(&fabric_mutex_);
+
+    if (index < 0) {
+        LOG_ERR("Failed to add fabric: %d", index);
+        return index;
+    }
+
+    LOG_INF("=== FABRIC ADDED - index %d (%u/%u) ===", index, count, FabricTable::CAPACITY);
+    markStage(CommissioningStage::FABRIC_ADDED);
     
     // Close commissioning window
     closeCommissioningWindow();
     
     // Save commissioning state to persistent storage
     uint8_t commissioned = 1;
-    int ret = settings_save_one("matter/fabric/commissioned", &commissioned, sizeof(commissioned));
+    int ret = settings_save_one(COMMISSIONED_KEY, &commissioned, sizeof(commissioned));
     if (ret < 0) {
         LOG_ERR("Failed to save commissioned state: %d", ret);
     }
     
-    uint8_t fabric_count = 1;
-    ret = settings_save_one("matter/fabric/count", &fabric_count, sizeof(fabric_count));
-    if (ret < 0) {
-        LOG_ERR("Failed to save fabric count: %d", ret);
-    }
+    saveFabricCount(count);
     
     ret = settings_save();
     if (ret < 0) {
@@ -148,18 +202,43 @@ void CommissioningDelegate::onFabricAdded() {
     }
     
     LOG_INF("Fabric info saved, starting network join");
+    return index;
+}
+
+int CommissioningDelegate::removeFabric(uint8_t fabric_index) {
+    k_mutex_lock(&fabric_mutex_, K_FOREVER);
+    int ret = fabrics_.remove(fabric_index);
+    uint8_t count = fabrics_.size();
+    k_mutex_unlock(&fabric_mutex_);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    LOG_INF("Fabric %u removed, %u left", fabric_index, count);
+
+    // The last fabric takes the commissioned state with it
+    if (count == 0) {
+        settings_delete(COMMISSIONED_KEY);
+        settings_delete(FABRIC_COUNT_KEY);
+    } else {
+        saveFabricCount(count);
+    }
+    return 0;
 }
 
 void CommissioningDelegate::onFabricRemoved() {
     LOG_INF("=== FABRIC REMOVED - Factory Reset ===");
     
     // Clear commissioning data from persistent storage
-    int ret = settings_delete("matter/fabric");
-    if (ret < 0 && ret != -ENOENT) {
-        LOG_ERR("Failed to delete fabric settings: %d", ret);
-    }
+    k_mutex_lock(&fabric_mutex_, K_FOREVER);
+    fabrics_.clear();
+    k_mutex_unlock(&fabric_mutex_);
     
-    ret = settings_save();
+    settings_delete(COMMISSIONED_KEY);
+    settings_delete(FABRIC_COUNT_KEY);
+    
+    int ret = settings_save();
     if (ret < 0) {
         LOG_ERR("Failed to commit settings: %d", ret);
     }
@@ -167,9 +246,51 @@ void CommissioningDelegate::onFabricRemoved() {
     LOG_INF("All commissioning data cleared");
 }
 
+uint8_t CommissioningDelegate::getFabricCount() {
+    k_mutex_lock(&fabric_mutex_, K_FOREVER);
+    uint8_t count = fabrics_.size();
+    k_mutex_unlock(&fabric_mutex_);
+    return count;
+}
+
+bool CommissioningDelegate::getFabric(uint8_t slot, FabricRecord& out) {
+    k_mutex_lock(&fabric_mutex_, K_FOREVER);
+    const FabricRecord* rec = fabrics_.at(slot);
+    if (rec) {
+        out = *rec;
+    }
+    k_mutex_unlock(&fabric_mutex_);
+    return rec != nullptr;
+}
+
+const FabricCredentials* CommissioningDelegate::getFabricCredentials(uint8_t fabric_index) {
+    k_mutex_lock(&fabric_mutex_, K_FOREVER);
+    const FabricCredentials* creds = fabrics_.getCredentials(fabric_index);
+    k_mutex_unlock(&fabric_mutex_);
+    return creds;
+}
+
+FabricTable::Stats CommissioningDelegate::getFabricStats() {
+    k_mutex_lock(&fabric_mutex_, K_FOREVER);
+    FabricTable::Stats stats = fabrics_.getStats();
+    k_mutex_unlock(&fabric_mutex_);
+    return stats;
+}
+
+void CommissioningDelegate::saveFabricCount(uint8_t count) {
+    // Kept for firmware that reads the count alone
+    int ret = settings_save_one(FABRIC_COUNT_KEY, &count, sizeof(count));
+    if (ret < 0) {
+        LOG_ERR("Failed to save fabric count: %d", ret);
+    }
+}
+
 void CommissioningDelegate::onCommissioningComplete() {
     LOG_INF("=== Commissioning Complete ===");
     
+    markStage(CommissioningStage::COMPLETE);
+    finishAttempt(AttemptOutcome::COMPLETE);
+    
     // Close commissioning window and stop BLE advertising
     closeCommissioningWindow();
     
@@ -207,6 +328,245 @@ uint32_t CommissioningDelegate::getTimeRemaining() const {
     return commissioning_timeout_sec_ - elapsed_sec;
 }
 
+/*=============================================================================
+ * Stage Timing
+ *===========================================================================*/
+
+void CommissioningDelegate::onPaseEstablished() {
+    markStage(CommissioningStage::PASE_ESTABLISHED);
+}
+
+void CommissioningDelegate::onThreadAttached() {
+    markStage(CommissioningStage::THREAD_ATTACHED);
+}
+
+void CommissioningDelegate::onOperationalMessage() {
+    markStage(CommissioningStage::FIRST_OPERATIONAL);
+}
+
+bool CommissioningDelegate::getAttempt(uint8_t age, CommissioningAttempt& out) {
+    k_mutex_lock(&timeline_mutex_, K_FOREVER);
+    const CommissioningAttempt* attempt = timeline_.get(age);
+    if (attempt) {
+        out = *attempt;
+    }
+    k_mutex_unlock(&timeline_mutex_);
+    return attempt != nullptr;
+}
+
+void CommissioningDelegate::clearTimeline() {
+    k_mutex_lock(&timeline_mutex_, K_FOREVER);
+    timeline_.clear();
+    k_mutex_unlock(&timeline_mutex_);
+    settings_delete(TIMELINE_KEY);
+}
+
+void CommissioningDelegate::markStage(CommissioningStage stage) {
+    uint32_t now = k_uptime_get_32();
+
+    k_mutex_lock(&timeline_mutex_, K_FOREVER);
+    bool recorded = timeline_.mark(stage, now);
+    bool ended = recorded && !timeline_.isTracking();
+    uint32_t offset = recorded ? timeline_.get(0)->stage_ms[static_cast<size_t>(stage)] : 0;
+    k_mutex_unlock(&timeline_mutex_);
+
+    if (recorded) {
+        LOG_INF("Commissioning stage %s at +%u ms",
+                CommissioningTimeline::stageName(stage), offset);
+    }
+    if (ended) {
+        k_work_submit(&persist_work_);
+    }
+}
+
+void CommissioningDelegate::finishAttempt(AttemptOutcome outcome) {
+    CommissioningAttempt attempt;
+
+    k_mutex_lock(&timeline_mutex_, K_FOREVER);
+    bool finished = timeline_.finish(outcome);
+    if (finished) {
+        attempt = *timeline_.get(0);
+    }
+    k_mutex_unlock(&timeline_mutex_);
+
+    if (!finished) {
+        return;
+    }
+
+    char line[160];
+    CommissioningTimeline::format(attempt, line, sizeof(line));
+    LOG_INF("Commissioning %s", line);
+
+    k_work_submit(&persist_work_);
+}
+
+static int timelineLoadCb(const char* key, size_t len, settings_read_cb read_cb,
+                          void* cb_arg, void* param) {
+    if (key != nullptr) {
+        return 0;
+    }
+    ssize_t rd = read_cb(cb_arg, param, len);
+    return (rd < 0) ? (int)rd : 0;
+}
+
+void CommissioningDelegate::loadTimeline() {
+    static CommissioningTimeline::History stored;
+
+    if (settings_get_val_len(TIMELINE_KEY) != sizeof(stored) ||
+        settings_load_subtree_direct(TIMELINE_KEY, timelineLoadCb, &stored) < 0) {
+        return;
+    }
+
+    k_mutex_lock(&timeline_mutex_, K_FOREVER);
+    bool ok = timeline_.restore(&stored, sizeof(stored));
+    uint8_t count = timeline_.size();
+    k_mutex_unlock(&timeline_mutex_);
+
+    if (ok) {
+        LOG_INF("Restored %u commissioning attempts", count);
+    }
+}
+
+/**
+ * Runs in the system work queue - settings writes stay off the IPC thread
+ */
+void CommissioningDelegate::persistWorkHandler(struct k_work* work) {
+    CommissioningDelegate& self = getInstance();
+
+    k_mutex_lock(&self.timeline_mutex_, K_FOREVER);
+    int ret = settings_save_one(TIMELINE_KEY, &self.timeline_.getHistory(),
+                                sizeof(CommissioningTimeline::History));
+    k_mutex_unlock(&self.timeline_mutex_);
+
+    if (ret < 0) {
+        LOG_WRN("Failed to save commissioning history: %d", ret);
+    }
+}
+
+/**
+ * Runs in the IPC RX thread
+ */
+void CommissioningDelegate::onIpcAck(const Message& msg) {
+    if (msg.payload.params.param1 != static_cast<uint32_t>(MessageType::BLE_ADV_START)) {
+        return;
+    }
+
+    if (msg.type == MessageType::ACK) {
+        getInstance().markStage(CommissioningStage::ADV_STARTED);
+    } else {
+        LOG_WRN("NET core refused BLE advertising");
+    }
+}
+
+void CommissioningDelegate::onIpcBleConnect(const Message& msg) {
+    getInstance().markStage(CommissioningStage::BLE_CONNECTED);
+}
+
+/**
+ * Runs in the IPC RX thread. A NET core back from a reset advertises
+ * nothing, whatever the window was when the link went down.
+ */
+void CommissioningDelegate::onIpcLink(bool up) {
+    CommissioningDelegate& self = getInstance();
+
+    if (!up) {
+        return;
+    }
+
+    int ret = self.sendAdvertising(self.commissioning_open_);
+    if (ret < 0) {
+        LOG_WRN("Failed to resync BLE advertising: %d", ret);
+    }
+}
+
 }  // namespace matter
 }  // namespace protocol
 }  // namespace smarthome
+
+/*=============================================================================
+ * Shell Commands
+ *===========================================================================*/
+
+#ifdef CONFIG_SHELL
+using smarthome::protocol::matter::CommissioningAttempt;
+using smarthome::protocol::matter::CommissioningDelegate;
+using smarthome::protocol::matter::CommissioningTimeline;
+
+static int cmd_commish_history(const struct shell* sh, size_t argc, char** argv) {
+    CommissioningAttempt attempt;
+    char line[160];
+    uint8_t age = 0;
+
+    while (CommissioningDelegate::getInstance().getAttempt(age++, attempt)) {
+        CommissioningTimeline::format(attempt, line, sizeof(line));
+        shell_print(sh, "%s", line);
+    }
+    if (age == 1) {
+        shell_print(sh, "No commissioning attempts recorded");
+    }
+    return 0;
+}
+
+static int cmd_commish_clear(const struct shell* sh, size_t argc, char** argv) {
+    CommissioningDelegate::getInstance().clearTimeline();
+    shell_print(sh, "Commissioning history cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_commish,
+    SHELL_CMD(history, NULL, "Stage timings of recent attempts (ms from window open)", cmd_commish_history),
+    SHELL_CMD(clear, NULL, "Clear the attempt history", cmd_commish_clear),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(commish, &sub_commish, "Commissioning timing", NULL);
+
+using smarthome::protocol::matter::FabricRecord;
+using smarthome::protocol::matter::FabricTable;
+
+static int cmd_fabric_list(const struct shell* sh, size_t argc, char** argv) {
+    CommissioningDelegate& delegate = CommissioningDelegate::getInstance();
+    FabricRecord rec;
+
+    for (uint8_t slot = 0; slot < FabricTable::CAPACITY; slot++) {
+        if (!delegate.getFabric(slot, rec)) {
+            continue;
+        }
+        shell_print(sh, "[%u] fabric %08x%08x node %08x%08x vendor 0x%04x \"%s\"",
+                    rec.fabric_index,
+                    (uint32_t)(rec.fabric_id >> 32), (uint32_t)rec.fabric_id,
+                    (uint32_t)(rec.node_id >> 32), (uint32_t)rec.node_id,
+                    rec.vendor_id, rec.label);
+    }
+
+    FabricTable::Stats stats = delegate.getFabricStats();
+    shell_print(sh, "%u/%u fabrics, credentials: %u loads, %u cache hits",
+                delegate.getFabricCount(), FabricTable::CAPACITY,
+                stats.credential_loads, stats.credential_hits);
+    return 0;
+}
+
+static int cmd_fabric_remove(const struct shell* sh, size_t argc, char** argv) {
+    int index = atoi(argv[1]);
+    int ret = -ENOENT;
+
+    if (index >= FabricTable::MIN_INDEX && index <= FabricTable::MAX_INDEX) {
+        ret = CommissioningDelegate::getInstance().removeFabric((uint8_t)index);
+    }
+
+    if (ret < 0) {
+        shell_error(sh, "No fabric %d", index);
+        return ret;
+    }
+    shell_print(sh, "Fabric %d removed", index);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_fabric,
+    SHELL_CMD(list, NULL, "Installed fabrics", cmd_fabric_list),
+    SHELL_CMD_ARG(remove, NULL, "Remove a fabric: <index>", cmd_fabric_remove, 2, 0),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(fabric, &sub_fabric, "Fabric table", NULL);
+#endif
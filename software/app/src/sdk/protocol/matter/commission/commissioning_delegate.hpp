@@ -9,6 +9,10 @@
 
 #include <cstdint>
 #include <zephyr/kernel.h>
+#include "factory_data.hpp"
+#include "commissioning_timeline.hpp"
+#include "fabric_table.hpp"
+#include "../ipc/ipc_core.hpp"
 
 namespace smarthome { namespace protocol { namespace matter {
 
@@ -21,8 +25,10 @@ using CommissioningCompleteCallback = void (*)(void);
  * Handles:
  *  - Commissioning window open/close
  *  - BLE advertisement during commissioning
- *  - Passcode and discriminator validation
+ *  - Passcode, discriminator and PASE verifier from factory data
  *  - Commissioning state callbacks
+ *  - Stage timing of the last attempts (persisted)
+ *  - Fabric table (up to FABRIC_TABLE_CAPACITY fabrics)
  */
 class CommissioningDelegate {
 public:
@@ -43,6 +49,9 @@ public:
     /**
      * Open commissioning window for Matter
      * 
+     * The caller closes the window when timeout_sec runs out (AppTask
+     * keeps the timer); getTimeRemaining() counts down from here.
+     * 
      * @param timeout_sec Duration to keep commissioning open (seconds)
      * @return 0 on success
      */
@@ -70,15 +79,56 @@ public:
     bool isCommissioned() const;
 
     /**
-     * Callback when fabric is added (device commissioned)
+     * Callback when AddNOC installs a fabric (first one = device commissioned)
+     * 
+     * @param fabric IDs and label of the new fabric
+     * @param chain NOC, ICAC and RCAC, copied to storage
+     * @return Fabric index, or negative errno (see FabricTable::add())
+     */
+    int onFabricAdded(const FabricDescriptor& fabric, const CertificateChain& chain);
+
+    /**
+     * Remove one fabric (RemoveFabric command); the device stays
+     * commissioned while other fabrics remain
+     * 
+     * @return 0 on success, -ENOENT for an unknown index
      */
-    void onFabricAdded();
+    int removeFabric(uint8_t fabric_index);
 
     /**
-     * Callback when fabric is removed (factory reset)
+     * Callback when fabric is removed (factory reset): drops every fabric
      */
     void onFabricRemoved();
 
+    /**
+     * @return Number of installed fabrics
+     */
+    uint8_t getFabricCount();
+
+    /**
+     * Copy the record of an installed fabric
+     * 
+     * @param slot 0..FABRIC_TABLE_CAPACITY-1
+     * @return false if the slot is free
+     */
+    bool getFabric(uint8_t slot, FabricRecord& out);
+
+    /**
+     * Certificates of a fabric, loaded on first use
+     * 
+     * Call when a CASE session for the fabric is established; chains of
+     * fabrics without sessions stay in flash.
+     * 
+     * @return Credentials (valid until other fabrics are loaded), nullptr
+     *         for an unknown index
+     */
+    const FabricCredentials* getFabricCredentials(uint8_t fabric_index);
+
+    /**
+     * Get fabric table counters
+     */
+    FabricTable::Stats getFabricStats();
+
     /**
      * Callback for commissioning completion
      */
@@ -87,7 +137,8 @@ public:
     /**
      * Get current passcode for display/logging
      * 
-     * @return Passcode (8-digit number)
+     * @return Passcode (8-digit number), 0 if factory data holds only
+     *         the verifier
      */
     uint32_t getPasscode() const { return commissioning_passcode_; }
 
@@ -98,6 +149,43 @@ public:
      */
     uint16_t getDiscriminator() const { return commissioning_discriminator_; }
 
+    /**
+     * Get the factory commissioning record (verifier, salt, setup payload)
+     * 
+     * @return Record on factory_partition, nullptr on development boards
+     */
+    const FactoryRecord* getFactoryData() const { return factory_; }
+
+    /**
+     * Callback when the PASE session is established (commissioner proved
+     * the passcode)
+     */
+    void onPaseEstablished();
+
+    /**
+     * Callback when the device attaches to the Thread network
+     */
+    void onThreadAttached();
+
+    /**
+     * Callback for messages on the operational session; only the first one
+     * after commissioning is recorded
+     */
+    void onOperationalMessage();
+
+    /**
+     * Copy a recorded commissioning attempt
+     * 
+     * @param age 0 = newest (possibly in progress)
+     * @return false past the recorded attempts
+     */
+    bool getAttempt(uint8_t age, CommissioningAttempt& out);
+
+    /**
+     * Forget all recorded attempts (RAM and settings)
+     */
+    void clearTimeline();
+
     /**
      * Get commissioning window remaining time
      * 
@@ -118,6 +206,16 @@ private:
     CommissioningDelegate();
     ~CommissioningDelegate();
 
+    void markStage(CommissioningStage stage);
+    void finishAttempt(AttemptOutcome outcome);
+    void loadTimeline();
+    void saveFabricCount(uint8_t count);
+    int sendAdvertising(bool start);
+    static void persistWorkHandler(struct k_work* work);
+    static void onIpcAck(const smarthome::ipc::Message& msg);
+    static void onIpcBleConnect(const smarthome::ipc::Message& msg);
+    static void onIpcLink(bool up);
+
     // Commissioning state
     bool commissioning_open_ = false;
     uint32_t commissioning_start_time_ = 0;
@@ -126,9 +224,16 @@ private:
     // Commissioning parameters
     uint32_t commissioning_passcode_ = 0;
     uint16_t commissioning_discriminator_ = 0;
+    const FactoryRecord* factory_ = nullptr;
+
+    // Stage timing, marked from the app, IPC and OpenThread contexts
+    CommissioningTimeline timeline_;
+    struct k_mutex timeline_mutex_;
+    struct k_work persist_work_;
 
-    // Timeout timer
-    struct k_timer commissioning_timer_;
+    // Fabrics, added from the CHIP thread and listed from the shell
+    FabricTable fabrics_;
+    struct k_mutex fabric_mutex_;
     
     // Completion callback
     CommissioningCompleteCallback completion_callback_;
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Commissioning Timeline Implementation
+ */
+
+#include "commissioning_timeline.hpp"
+#include <cstdio>
+#include <cstring>
+
+namespace smarthome { namespace protocol { namespace matter {
+
+static constexpr size_t STAGE_COUNT = static_cast<size_t>(CommissioningStage::COUNT);
+
+/* Short keys for format(), one per stage after WINDOW_OPEN */
+static const char* const STAGE_KEYS[STAGE_COUNT] = {
+    "open", "adv", "ble", "pase", "fabric", "attach", "done", "op"
+};
+
+CommissioningTimeline::CommissioningTimeline()
+    : start_ms_(0)
+    , tracking_(false)
+{
+    clear();
+}
+
+void CommissioningTimeline::clear() {
+    memset(&history_, 0, sizeof(history_));
+    history_.version = HISTORY_VERSION;
+    history_.next_seq = 1;
+    tracking_ = false;
+}
+
+CommissioningAttempt* CommissioningTimeline::current() {
+    if (history_.count == 0) {
+        return nullptr;
+    }
+    return &history_.attempts[(history_.head + DEPTH - 1) % DEPTH];
+}
+
+void CommissioningTimeline::begin(uint32_t now_ms) {
+    finish(AttemptOutcome::CANCELLED);
+
+    CommissioningAttempt& attempt = history_.attempts[history_.head];
+    memset(&attempt, 0, sizeof(attempt));
+    attempt.seq = history_.next_seq++;
+    attempt.outcome = static_cast<uint8_t>(AttemptOutcome::IN_PROGRESS);
+    attempt.reached = 1U << static_cast<uint8_t>(CommissioningStage::WINDOW_OPEN);
+
+    history_.head = (history_.head + 1) % DEPTH;
+    if (history_.count < DEPTH) {
+        history_.count++;
+    }
+
+    start_ms_ = now_ms;
+    tracking_ = true;
+}
+
+bool CommissioningTimeline::mark(CommissioningStage stage, uint32_t now_ms) {
+    if (!tracking_ || stage >= CommissioningStage::COUNT) {
+        return false;
+    }
+
+    CommissioningAttempt* attempt = current();
+    uint8_t bit = 1U << static_cast<uint8_t>(stage);
+    if (attempt->reached & bit) {
+        return false;
+    }
+
+    attempt->reached |= bit;
+    attempt->stage_ms[static_cast<size_t>(stage)] = now_ms - start_ms_;
+
+    /* Last stage of a successful attempt */
+    if (stage == CommissioningStage::FIRST_OPERATIONAL &&
+        attempt->outcome == static_cast<uint8_t>(AttemptOutcome::COMPLETE)) {
+        tracking_ = false;
+    }
+    return true;
+}
+
+bool CommissioningTimeline::finish(AttemptOutcome outcome) {
+    CommissioningAttempt* attempt = current();
+    if (!tracking_ ||
+        attempt->outcome != static_cast<uint8_t>(AttemptOutcome::IN_PROGRESS)) {
+        return false;
+    }
+
+    attempt->outcome = static_cast<uint8_t>(outcome);
+    tracking_ = (outcome == AttemptOutcome::COMPLETE) &&
+                !(attempt->reached & (1U << static_cast<uint8_t>(CommissioningStage::FIRST_OPERATIONAL)));
+    return true;
+}
+
+const CommissioningAttempt* CommissioningTimeline::get(uint8_t age) const {
+    if (age >= history_.count) {
+        return nullptr;
+    }
+    return &history_.attempts[(history_.head + DEPTH - 1 - age) % DEPTH];
+}
+
+bool CommissioningTimeline::restore(const void* data, size_t len) {
+    const History* stored = static_cast<const History*>(data);
+
+    if (len != sizeof(History) || stored->version != HISTORY_VERSION ||
+        stored->head >= DEPTH || stored->count > DEPTH) {
+        clear();
+        return false;
+    }
+
+    memcpy(&history_, stored, sizeof(history_));
+    tracking_ = false;
+
+    /* An attempt cut short by a reset did not complete */
+    for (uint8_t i = 0; i < history_.count; i++) {
+        CommissioningAttempt& attempt = history_.attempts[(history_.head + DEPTH - 1 - i) % DEPTH];
+        if (attempt.outcome == static_cast<uint8_t>(AttemptOutcome::IN_PROGRESS)) {
+            attempt.outcome = static_cast<uint8_t>(AttemptOutcome::FAILED);
+        }
+    }
+    return true;
+}
+
+/*=============================================================================
+ * Reporting
+ *===========================================================================*/
+
+const char* CommissioningTimeline::stageName(CommissioningStage stage) {
+    switch (stage) {
+        case CommissioningStage::WINDOW_OPEN: return "WINDOW_OPEN";
+        case CommissioningStage::ADV_STARTED: return "ADV_STARTED";
+        case CommissioningStage::BLE_CONNECTED: return "BLE_CONNECTED";
+        case CommissioningStage::PASE_ESTABLISHED: return "PASE_ESTABLISHED";
+        case CommissioningStage::FABRIC_ADDED: return "FABRIC_ADDED";
+        case CommissioningStage::THREAD_ATTACHED: return "THREAD_ATTACHED";
+        case CommissioningStage::COMPLETE: return "COMPLETE";
+        case CommissioningStage::FIRST_OPERATIONAL: return "FIRST_OPERATIONAL";
+        default: return "UNKNOWN";
+    }
+}
+
+const char* CommissioningTimeline::outcomeName(AttemptOutcome outcome) {
+    switch (outcome) {
+        case AttemptOutcome::IN_PROGRESS: return "IN_PROGRESS";
+        case AttemptOutcome::COMPLETE: return "COMPLETE";
+        case AttemptOutcome::TIMEOUT: return "TIMEOUT";
+        case AttemptOutcome::CANCELLED: return "CANCELLED";
+        case AttemptOutcome::FAILED: return "FAILED";
+        default: return "UNKNOWN";
+    }
+}
+
+CommissioningStage CommissioningTimeline::slowestStage(const CommissioningAttempt& attempt,
+                                                       uint32_t* gap_ms) {
+    CommissioningStage slowest = CommissioningStage::COUNT;
+    uint32_t slowest_gap = 0;
+    uint32_t prev_ms = 0;
+
+    /* Stages can arrive out of order (attach before complete): walk by time */
+    uint8_t pending = attempt.reached & ~(1U << static_cast<uint8_t>(CommissioningStage::WINDOW_OPEN));
+    while (pending) {
+        size_t next = STAGE_COUNT;
+        for (size_t i = 0; i < STAGE_COUNT; i++) {
+            if ((pending & (1U << i)) &&
+                (next == STAGE_COUNT || attempt.stage_ms[i] < attempt.stage_ms[next])) {
+                next = i;
+            }
+        }
+        pending &= ~(1U << next);
+
+        uint32_t gap = attempt.stage_ms[next] - prev_ms;
+        if (slowest == CommissioningStage::COUNT || gap > slowest_gap) {
+            slowest = static_cast<CommissioningStage>(next);
+            slowest_gap = gap;
+        }
+        prev_ms = attempt.stage_ms[next];
+    }
+
+    if (gap_ms) {
+        *gap_ms = slowest_gap;
+    }
+    return slowest;
+}
+
+int CommissioningTimeline::format(const CommissioningAttempt& attempt, char* buf, size_t len) {
+    if (len == 0) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    auto append = [&](int n) {
+        if (n > 0) {
+            pos += static_cast<size_t>(n);
+            if (pos >= len) {
+                pos = len - 1;
+            }
+        }
+    };
+
+    append(snprintf(buf, len, "#%u %s", (unsigned)attempt.seq,
+                    outcomeName(static_cast<AttemptOutcome>(attempt.outcome))));
+
+    for (size_t i = 1; i < STAGE_COUNT; i++) {
+        if (attempt.reached & (1U << i)) {
+            append(snprintf(buf + pos, len - pos, " %s=%u", STAGE_KEYS[i],
+                            (unsigned)attempt.stage_ms[i]));
+        } else {
+            append(snprintf(buf + pos, len - pos, " %s=-", STAGE_KEYS[i]));
+        }
+    }
+
+    uint32_t gap = 0;
+    CommissioningStage slowest = slowestStage(attempt, &gap);
+    if (slowest != CommissioningStage::COUNT) {
+        append(snprintf(buf + pos, len - pos, " slowest=%s/%u",
+                        STAGE_KEYS[static_cast<size_t>(slowest)], (unsigned)gap));
+    }
+
+    return static_cast<int>(pos);
+}
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
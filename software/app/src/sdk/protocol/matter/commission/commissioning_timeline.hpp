@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Commissioning Timeline - per-stage timing of commissioning attempts
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "chip_config.hpp"
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/**
+ * Commissioning stages, in the order they normally happen
+ */
+enum class CommissioningStage : uint8_t {
+    WINDOW_OPEN = 0,        ///< openCommissioningWindow()
+    ADV_STARTED = 1,        ///< NET core acknowledged BLE_ADV_START
+    BLE_CONNECTED = 2,      ///< First BLE connection from the commissioner
+    PASE_ESTABLISHED = 3,   ///< Passcode session up
+    FABRIC_ADDED = 4,       ///< Operational credentials installed
+    THREAD_ATTACHED = 5,    ///< Attached to the Thread network
+    COMPLETE = 6,           ///< onCommissioningComplete()
+    FIRST_OPERATIONAL = 7,  ///< First message over the operational session
+    COUNT = 8
+};
+
+enum class AttemptOutcome : uint8_t {
+    IN_PROGRESS = 0,
+    COMPLETE = 1,
+    TIMEOUT = 2,            ///< Window expired
+    CANCELLED = 3,          ///< Window closed, or a new one opened
+    FAILED = 4
+};
+
+/**
+ * One attempt: offsets from WINDOW_OPEN of the first time each stage was
+ * reached. 40 bytes, the ring of them is persisted as is.
+ */
+struct CommissioningAttempt {
+    uint32_t seq;                       ///< Attempt number, counts across reboots
+    uint8_t outcome;                    ///< AttemptOutcome
+    uint8_t reached;                    ///< Bit per CommissioningStage
+    uint16_t reserved;
+    uint32_t stage_ms[static_cast<size_t>(CommissioningStage::COUNT)];
+};
+
+static_assert(sizeof(CommissioningAttempt) == 40, "CommissioningAttempt is persisted");
+
+/**
+ * Commissioning Timeline
+ *
+ * Records the attempt in progress and keeps the last
+ * COMMISSIONING_HISTORY_DEPTH attempts in a ring:
+ *
+ *   begin ─▶ mark(ADV_STARTED) ─▶ ... ─▶ finish(COMPLETE) ─▶ mark(FIRST_OPERATIONAL)
+ *   └──────────── window open ──────────┘ └── still tracking ──┘
+ *
+ * A completed attempt keeps tracking until the first operational message,
+ * since Thread attach and that message can follow the window. Pure logic
+ * with caller-supplied time; the owner locks and persists getHistory().
+ */
+class CommissioningTimeline {
+public:
+    static constexpr uint8_t DEPTH = COMMISSIONING_HISTORY_DEPTH;
+    static constexpr uint16_t HISTORY_VERSION = 1;
+
+    /// Persisted form
+    struct History {
+        uint16_t version;
+        uint8_t head;                   ///< Next slot to use
+        uint8_t count;
+        uint32_t next_seq;
+        CommissioningAttempt attempts[DEPTH];
+    };
+
+    CommissioningTimeline();
+
+    /**
+     * Start an attempt at WINDOW_OPEN; one still in progress ends CANCELLED
+     */
+    void begin(uint32_t now_ms);
+
+    /**
+     * Record a stage of the tracked attempt
+     *
+     * @return true if this is the first time the stage is reached
+     */
+    bool mark(CommissioningStage stage, uint32_t now_ms);
+
+    /**
+     * Set the outcome when the window closes
+     *
+     * @return true if an attempt was in progress
+     */
+    bool finish(AttemptOutcome outcome);
+
+    /// An attempt accepts marks
+    bool isTracking() const { return tracking_; }
+
+    /**
+     * @param age 0 = newest (possibly in progress)
+     * @return Attempt, or nullptr past the recorded ones
+     */
+    const CommissioningAttempt* get(uint8_t age) const;
+    uint8_t size() const { return history_.count; }
+
+    const History& getHistory() const { return history_; }
+
+    /**
+     * Load a persisted history
+     *
+     * @return false (history cleared) if it has another version or size
+     */
+    bool restore(const void* data, size_t len);
+
+    void clear();
+
+    static const char* stageName(CommissioningStage stage);
+    static const char* outcomeName(AttemptOutcome outcome);
+
+    /**
+     * Stage reached with the longest wait after the stage before it
+     *
+     * @return The stage, COUNT if fewer than two stages were reached
+     */
+    static CommissioningStage slowestStage(const CommissioningAttempt& attempt, uint32_t* gap_ms);
+
+    /**
+     * Render one attempt as a line into a caller buffer, e.g.
+     * "#3 COMPLETE adv=40 ble=5210 pase=6102 fabric=8830 attach=11020 done=11480 op=- slowest=ble/5170"
+     *
+     * @return Characters written (excluding NUL), truncated to len - 1
+     */
+    static int format(const CommissioningAttempt& attempt, char* buf, size_t len);
+
+private:
+    CommissioningAttempt* current();
+
+    History history_;
+    uint32_t start_ms_;
+    bool tracking_;
+};
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
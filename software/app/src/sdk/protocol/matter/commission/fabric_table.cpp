@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fabric Table Implementation
+ */
+
+#include "fabric_table.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <cstdio>
+#include <cstring>
+
+LOG_MODULE_REGISTER(fabric_table, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define FABRIC_KEY_ROOT "matter/fabric"
+#define FABRIC_NEXT_KEY FABRIC_KEY_ROOT "/next"
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/* Slots are single digits in the storage keys */
+static_assert(FabricTable::CAPACITY > 0 && FabricTable::CAPACITY <= 10, "slot keys are one digit");
+
+enum CertKind : uint8_t { CERT_NOC = 0, CERT_ICAC = 1, CERT_RCAC = 2, CERT_COUNT = 3 };
+
+static const char* const CERT_LEAVES[CERT_COUNT] = { "noc", "icac", "rcac" };
+
+static void slotKey(char* buf, size_t len, uint8_t slot, const char* leaf) {
+    if (leaf) {
+        snprintf(buf, len, FABRIC_KEY_ROOT "/%u/%s", slot, leaf);
+    } else {
+        snprintf(buf, len, FABRIC_KEY_ROOT "/%u", slot);
+    }
+}
+
+static void deleteChain(uint8_t slot) {
+    char key[32];
+
+    for (uint8_t i = 0; i < CERT_COUNT; i++) {
+        slotKey(key, sizeof(key), slot, CERT_LEAVES[i]);
+        settings_delete(key);
+    }
+}
+
+/*=============================================================================
+ * Loading
+ *===========================================================================*/
+
+struct RecordLoad {
+    FabricRecord* records;
+    uint8_t next_index;
+};
+
+static int recordLoadCb(const char* key, size_t len, settings_read_cb read_cb,
+                        void* cb_arg, void* param) {
+    RecordLoad* load = static_cast<RecordLoad*>(param);
+
+    if (key == nullptr) {
+        return 0;
+    }
+
+    if (strcmp(key, "next") == 0 && len == sizeof(load->next_index)) {
+        ssize_t rd = read_cb(cb_arg, &load->next_index, len);
+        return (rd < 0) ? (int)rd : 0;
+    }
+
+    /* "<slot>" only; "<slot>/noc" and the rest wait for a session */
+    if (key[0] >= '0' && key[0] < '0' + FabricTable::CAPACITY && key[1] == '\0' &&
+        len == sizeof(FabricRecord)) {
+        ssize_t rd = read_cb(cb_arg, &load->records[key[0] - '0'], len);
+        return (rd < 0) ? (int)rd : 0;
+    }
+    return 0;
+}
+
+struct ChainLoad {
+    FabricCredentials* creds;
+    uint8_t found;                      ///< Bit per CertKind
+};
+
+static int chainLoadCb(const char* key, size_t len, settings_read_cb read_cb,
+                       void* cb_arg, void* param) {
+    ChainLoad* load = static_cast<ChainLoad*>(param);
+
+    if (key == nullptr || len > FABRIC_CERT_MAX_LEN) {
+        return 0;
+    }
+
+    uint8_t* dest[CERT_COUNT] = { load->creds->noc, load->creds->icac, load->creds->rcac };
+    uint16_t* dest_len[CERT_COUNT] = { &load->creds->noc_len, &load->creds->icac_len,
+                                       &load->creds->rcac_len };
+
+    for (uint8_t i = 0; i < CERT_COUNT; i++) {
+        if (strcmp(key, CERT_LEAVES[i]) == 0) {
+            ssize_t rd = read_cb(cb_arg, dest[i], len);
+            if (rd < 0) {
+                return (int)rd;
+            }
+            *dest_len[i] = (uint16_t)rd;
+            load->found |= 1U << i;
+            break;
+        }
+    }
+    return 0;
+}
+
+/*=============================================================================
+ * Table
+ *===========================================================================*/
+
+FabricTable::FabricTable()
+    : use_clock_(0)
+    , next_index_(MIN_INDEX)
+    , count_(0)
+    , stats_{}
+{
+    memset(records_, 0, sizeof(records_));
+    memset(cache_stamp_, 0, sizeof(cache_stamp_));
+    for (uint8_t i = 0; i < CACHE_SLOTS; i++) {
+        cache_[i].fabric_index = 0;
+    }
+}
+
+int FabricTable::load() {
+    RecordLoad load = { records_, 0 };
+
+    memset(records_, 0, sizeof(records_));
+    count_ = 0;
+
+    int ret = settings_load_subtree_direct(FABRIC_KEY_ROOT, recordLoadCb, &load);
+    if (ret < 0) {
+        return ret;
+    }
+
+    uint8_t highest = 0;
+    for (uint8_t slot = 0; slot < CAPACITY; slot++) {
+        FabricRecord& rec = records_[slot];
+        if (rec.fabric_index == 0) {
+            continue;
+        }
+
+        bool valid = rec.version == RECORD_VERSION &&
+                     rec.fabric_index <= MAX_INDEX &&
+                     slotOf(rec.fabric_index) == slot &&
+                     rec.noc_len > 0 && rec.noc_len <= FABRIC_CERT_MAX_LEN &&
+                     rec.icac_len <= FABRIC_CERT_MAX_LEN &&
+                     rec.rcac_len > 0 && rec.rcac_len <= FABRIC_CERT_MAX_LEN &&
+                     memchr(rec.label, '\0', sizeof(rec.label)) != nullptr;
+        if (!valid) {
+            LOG_WRN("Ignoring fabric record in slot %u", slot);
+            memset(&rec, 0, sizeof(rec));
+            continue;
+        }
+
+        count_++;
+        if (rec.fabric_index > highest) {
+            highest = rec.fabric_index;
+        }
+    }
+
+    if (load.next_index >= MIN_INDEX && load.next_index <= MAX_INDEX) {
+        next_index_ = load.next_index;
+    } else {
+        next_index_ = (highest == 0 || highest == MAX_INDEX) ? MIN_INDEX : highest + 1;
+    }
+
+    return count_;
+}
+
+int FabricTable::allocateIndex() const {
+    uint8_t index = next_index_;
+
+    /* A free slot is at most CAPACITY indices away (one more across the wrap) */
+    for (uint16_t tries = 0; tries < MAX_INDEX; tries++) {
+        if (records_[slotOf(index)].fabric_index == 0) {
+            return index;
+        }
+        index = (index == MAX_INDEX) ? MIN_INDEX : index + 1;
+    }
+    return -ENOSPC;
+}
+
+int FabricTable::add(const FabricDescriptor& fabric, const CertificateChain& chain) {
+    if (!chain.noc || chain.noc_len == 0 || chain.noc_len > FABRIC_CERT_MAX_LEN ||
+        !chain.rcac || chain.rcac_len == 0 || chain.rcac_len > FABRIC_CERT_MAX_LEN ||
+        (chain.icac_len > 0 && !chain.icac) || chain.icac_len > FABRIC_CERT_MAX_LEN) {
+        return -EINVAL;
+    }
+
+    /* The compressed ID is derived from the root key and the fabric ID */
+    for (uint8_t slot = 0; slot < CAPACITY; slot++) {
+        if (records_[slot].fabric_index != 0 &&
+            records_[slot].compressed_fabric_id == fabric.compressed_fabric_id) {
+            return -EEXIST;
+        }
+    }
+
+    int index = allocateIndex();
+    if (isFull() || index < 0) {
+        return -ENOSPC;
+    }
+
+    uint8_t slot = slotOf(index);
+    const uint8_t* certs[CERT_COUNT] = { chain.noc, chain.icac, chain.rcac };
+    uint16_t lens[CERT_COUNT] = { chain.noc_len, chain.icac_len, chain.rcac_len };
+    char key[32];
+    int ret = 0;
+
+    /* Chain first: the record is the commit point */
+    for (uint8_t i = 0; i < CERT_COUNT && ret == 0; i++) {
+        slotKey(key, sizeof(key), slot, CERT_LEAVES[i]);
+        if (lens[i] > 0) {
+            ret = settings_save_one(key, certs[i], lens[i]);
+        } else {
+            settings_delete(key);
+        }
+    }
+
+    FabricRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.fabric_id = fabric.fabric_id;
+    rec.node_id = fabric.node_id;
+    rec.compressed_fabric_id = fabric.compressed_fabric_id;
+    rec.fabric_index = (uint8_t)index;
+    rec.version = RECORD_VERSION;
+    rec.vendor_id = fabric.vendor_id;
+    rec.noc_len = chain.noc_len;
+    rec.icac_len = chain.icac_len;
+    rec.rcac_len = chain.rcac_len;
+    if (fabric.label) {
+        strncpy(rec.label, fabric.label, FABRIC_LABEL_MAX_LEN);
+    }
+
+    if (ret == 0) {
+        slotKey(key, sizeof(key), slot, nullptr);
+        ret = settings_save_one(key, &rec, sizeof(rec));
+    }
+    if (ret < 0) {
+        deleteChain(slot);
+        return ret;
+    }
+
+    records_[slot] = rec;
+    count_++;
+    dropCached((uint8_t)index);
+
+    next_index_ = (index == MAX_INDEX) ? MIN_INDEX : index + 1;
+    if (settings_save_one(FABRIC_NEXT_KEY, &next_index_, sizeof(next_index_)) < 0) {
+        /* Rebuilt from the highest index at the next load */
+        LOG_WRN("Failed to save next fabric index");
+    }
+
+    return index;
+}
+
+int FabricTable::remove(uint8_t fabric_index) {
+    if (!find(fabric_index)) {
+        return -ENOENT;
+    }
+
+    uint8_t slot = slotOf(fabric_index);
+    char key[32];
+
+    slotKey(key, sizeof(key), slot, nullptr);
+    int ret = settings_delete(key);
+    if (ret < 0 && ret != -ENOENT) {
+        return ret;
+    }
+    deleteChain(slot);
+
+    memset(&records_[slot], 0, sizeof(records_[slot]));
+    count_--;
+    dropCached(fabric_index);
+    return 0;
+}
+
+void FabricTable::clear() {
+    for (uint8_t slot = 0; slot < CAPACITY; slot++) {
+        if (records_[slot].fabric_index != 0) {
+            remove(records_[slot].fabric_index);
+        }
+    }
+    settings_delete(FABRIC_NEXT_KEY);
+    next_index_ = MIN_INDEX;
+}
+
+const FabricRecord* FabricTable::find(uint8_t fabric_index) const {
+    if (fabric_index < MIN_INDEX || fabric_index > MAX_INDEX) {
+        return nullptr;
+    }
+
+    const FabricRecord* rec = &records_[slotOf(fabric_index)];
+    return (rec->fabric_index == fabric_index) ? rec : nullptr;
+}
+
+const FabricRecord* FabricTable::findByCompressedId(uint64_t compressed_fabric_id,
+                                                    uint64_t node_id) const {
+    for (uint8_t slot = 0; slot < CAPACITY; slot++) {
+        const FabricRecord* rec = &records_[slot];
+        if (rec->fabric_index != 0 && rec->compressed_fabric_id == compressed_fabric_id &&
+            rec->node_id == node_id) {
+            return rec;
+        }
+    }
+    return nullptr;
+}
+
+const FabricRecord* FabricTable::at(uint8_t slot) const {
+    if (slot >= CAPACITY || records_[slot].fabric_index == 0) {
+        return nullptr;
+    }
+    return &records_[slot];
+}
+
+/*=============================================================================
+ * Credential Cache
+ *===========================================================================*/
+
+FabricCredentials* FabricTable::cacheSlotFor(uint8_t fabric_index) {
+    uint8_t victim = 0;
+
+    for (uint8_t i = 0; i < CACHE_SLOTS; i++) {
+        if (cache_[i].fabric_index == fabric_index) {
+            cache_stamp_[i] = ++use_clock_;
+            stats_.credential_hits++;
+            return &cache_[i];
+        }
+        if (cache_[i].fabric_index == 0 ||
+            (cache_[victim].fabric_index != 0 && cache_stamp_[i] < cache_stamp_[victim])) {
+            victim = i;
+        }
+    }
+
+    cache_stamp_[victim] = ++use_clock_;
+    cache_[victim].fabric_index = 0;
+    return &cache_[victim];
+}
+
+void FabricTable::dropCached(uint8_t fabric_index) {
+    for (uint8_t i = 0; i < CACHE_SLOTS; i++) {
+        if (cache_[i].fabric_index == fabric_index) {
+            cache_[i].fabric_index = 0;
+        }
+    }
+}
+
+const FabricCredentials* FabricTable::getCredentials(uint8_t fabric_index) {
+    const FabricRecord* rec = find(fabric_index);
+    if (!rec) {
+        return nullptr;
+    }
+
+    FabricCredentials* creds = cacheSlotFor(fabric_index);
+    if (creds->fabric_index == fabric_index) {
+        return creds;
+    }
+
+    ChainLoad load = { creds, 0 };
+    creds->noc_len = creds->icac_len = creds->rcac_len = 0;
+
+    char key[32];
+    slotKey(key, sizeof(key), slotOf(fabric_index), nullptr);
+    int ret = settings_load_subtree_direct(key, chainLoadCb, &load);
+
+    uint8_t needed = (1U << CERT_NOC) | (1U << CERT_RCAC) | (rec->icac_len ? (1U << CERT_ICAC) : 0);
+    if (ret < 0 || (load.found & needed) != needed ||
+        creds->noc_len != rec->noc_len || creds->icac_len != rec->icac_len ||
+        creds->rcac_len != rec->rcac_len) {
+        LOG_ERR("Certificates of fabric %u unreadable (%d)", fabric_index, ret);
+        return nullptr;
+    }
+
+    creds->fabric_index = fabric_index;
+    stats_.credential_loads++;
+    return creds;
+}
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fabric Table - fixed-capacity store of the fabrics the device belongs to
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "chip_config.hpp"
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/**
+ * One fabric, as persisted. 72 bytes; the certificates are stored under
+ * their own keys and only their lengths are kept here.
+ */
+struct FabricRecord {
+    uint64_t fabric_id;
+    uint64_t node_id;
+    uint64_t compressed_fabric_id;      ///< Names the fabric in CASE and DNS-SD
+    uint8_t fabric_index;               ///< 1..254, 0 = free slot
+    uint8_t version;
+    uint16_t vendor_id;                 ///< Of the commissioner's root
+    uint16_t noc_len;
+    uint16_t icac_len;                  ///< 0 without an intermediate CA
+    uint16_t rcac_len;
+    char label[FABRIC_LABEL_MAX_LEN + 1];
+    uint8_t reserved[5];
+};
+
+static_assert(sizeof(FabricRecord) == 72, "FabricRecord is persisted");
+
+/**
+ * What AddNOC installs besides the certificates
+ */
+struct FabricDescriptor {
+    uint64_t fabric_id;
+    uint64_t node_id;
+    uint64_t compressed_fabric_id;
+    uint16_t vendor_id;
+    const char* label;                  ///< nullptr = empty
+};
+
+/**
+ * Certificate chain handed to add(), borrowed for the call
+ */
+struct CertificateChain {
+    const uint8_t* noc;
+    uint16_t noc_len;
+    const uint8_t* icac;                ///< nullptr without an intermediate CA
+    uint16_t icac_len;
+    const uint8_t* rcac;
+    uint16_t rcac_len;
+};
+
+/**
+ * Certificates of one fabric, loaded for its sessions
+ */
+struct FabricCredentials {
+    uint8_t fabric_index;               ///< 0 = cache slot empty
+    uint16_t noc_len;
+    uint16_t icac_len;
+    uint16_t rcac_len;
+    uint8_t noc[FABRIC_CERT_MAX_LEN];
+    uint8_t icac[FABRIC_CERT_MAX_LEN];
+    uint8_t rcac[FABRIC_CERT_MAX_LEN];
+};
+
+/**
+ * Fabric Table
+ *
+ * FABRIC_TABLE_CAPACITY records stay in RAM (72 bytes each); certificate
+ * chains (up to 1.2 KB a fabric) are read from settings only when a session
+ * for their fabric is established, into FABRIC_CREDENTIAL_CACHE_SLOTS
+ * least-recently-used slots.
+ *
+ * Fabric indices are allocated so that slot = (index - 1) % CAPACITY:
+ * lookup by index is one comparison, with no map to keep. Indices still
+ * grow monotonically (1..254, wrapping) and are never shared by two live
+ * fabrics.
+ *
+ * Storage keys: "matter/fabric/<slot>" for the record,
+ * "matter/fabric/<slot>/{noc,icac,rcac}" for the chain and
+ * "matter/fabric/next" for the allocator. The record is written last, so
+ * a fabric exists only once its chain is stored.
+ *
+ * Not thread-safe; the owner (CommissioningDelegate) locks around calls.
+ */
+class FabricTable {
+public:
+    static constexpr uint8_t CAPACITY = FABRIC_TABLE_CAPACITY;
+    static constexpr uint8_t CACHE_SLOTS = FABRIC_CREDENTIAL_CACHE_SLOTS;
+    static constexpr uint8_t RECORD_VERSION = 1;
+    static constexpr uint8_t MIN_INDEX = 1;
+    static constexpr uint8_t MAX_INDEX = 254;
+
+    struct Stats {
+        uint32_t credential_loads;      ///< Chains read from storage
+        uint32_t credential_hits;       ///< Served from the cache
+    };
+
+    FabricTable();
+
+    FabricTable(const FabricTable&) = delete;
+    FabricTable& operator=(const FabricTable&) = delete;
+
+    /**
+     * Read the records (not the certificates) in one settings pass
+     *
+     * @return Number of fabrics, or negative errno
+     */
+    int load();
+
+    /**
+     * Install a fabric and persist it
+     *
+     * @return Fabric index (> 0), -ENOSPC when full, -EEXIST if the fabric
+     *         is already installed, -EINVAL for a bad chain, or a settings
+     *         error (nothing is left behind)
+     */
+    int add(const FabricDescriptor& fabric, const CertificateChain& chain);
+
+    /**
+     * Remove a fabric and its stored chain
+     *
+     * @return 0, -ENOENT for an unknown index
+     */
+    int remove(uint8_t fabric_index);
+
+    /**
+     * Remove every fabric
+     */
+    void clear();
+
+    /**
+     * @return Record of an installed fabric, nullptr otherwise; O(1)
+     */
+    const FabricRecord* find(uint8_t fabric_index) const;
+
+    /**
+     * Fabric a CASE Sigma1 destination or an operational DNS-SD name refers to
+     */
+    const FabricRecord* findByCompressedId(uint64_t compressed_fabric_id, uint64_t node_id) const;
+
+    /**
+     * Certificates of a fabric, read from storage on first use
+     *
+     * Call when a session for the fabric is established. The pointer stays
+     * valid until CACHE_SLOTS other fabrics have been loaded since.
+     *
+     * @return Credentials, nullptr for an unknown index or a storage error
+     */
+    const FabricCredentials* getCredentials(uint8_t fabric_index);
+
+    /**
+     * @param slot 0..CAPACITY-1
+     * @return Record in the slot, nullptr if the slot is free
+     */
+    const FabricRecord* at(uint8_t slot) const;
+
+    uint8_t size() const { return count_; }
+    bool isFull() const { return count_ == CAPACITY; }
+    const Stats& getStats() const { return stats_; }
+
+    static uint8_t slotOf(uint8_t fabric_index) { return (fabric_index - 1) % CAPACITY; }
+
+private:
+    int allocateIndex() const;
+    FabricCredentials* cacheSlotFor(uint8_t fabric_index);
+    void dropCached(uint8_t fabric_index);
+
+    FabricRecord records_[CAPACITY];
+    FabricCredentials cache_[CACHE_SLOTS];
+    uint32_t cache_stamp_[CACHE_SLOTS];     ///< Last use, for LRU eviction
+    uint32_t use_clock_;
+    uint8_t next_index_;
+    uint8_t count_;
+    Stats stats_;
+};
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
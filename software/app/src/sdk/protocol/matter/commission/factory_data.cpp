@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Factory Data Implementation
+ */
+
+#include "factory_data.hpp"
+#include "chip_config.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <cstring>
+
+LOG_MODULE_REGISTER(factory_data, CONFIG_LOG_DEFAULT_LEVEL);
+
+#if FIXED_PARTITION_EXISTS(factory_partition)
+#define FACTORY_AREA_ID FIXED_PARTITION_ID(factory_partition)
+#ifdef CONFIG_XIP
+/* Partition offset is relative to the flash device it lives on */
+#define FACTORY_AREA_ADDR (DT_REG_ADDR(DT_GPARENT(DT_NODELABEL(factory_partition))) + \
+                           FIXED_PARTITION_OFFSET(factory_partition))
+#endif
+#endif
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/*=============================================================================
+ * Validation
+ *===========================================================================*/
+
+bool isValidPasscode(uint32_t passcode) {
+    switch (passcode) {
+    case 0: case 11111111: case 22222222: case 33333333:
+    case 44444444: case 55555555: case 66666666: case 77777777:
+    case 88888888: case 99999999: case 12345678: case 87654321:
+        return false;
+    default:
+        return passcode <= 99999998;
+    }
+}
+
+static bool isTerminated(const char* str, size_t size) {
+    return memchr(str, '\0', size) != nullptr;
+}
+
+static bool isManualCode(const char* code) {
+    for (size_t i = 0; i < 11; i++) {
+        if (code[i] < '0' || code[i] > '9') {
+            return false;
+        }
+    }
+    return code[11] == '\0';
+}
+
+int validateFactoryRecord(const void* data, size_t len) {
+    if (len < sizeof(FactoryRecord)) {
+        return -ENOENT;
+    }
+
+    const FactoryRecord* rec = static_cast<const FactoryRecord*>(data);
+
+    if (rec->magic != FACTORY_MAGIC) {
+        return -ENOENT;
+    }
+    if (rec->version != FACTORY_VERSION || rec->length != sizeof(FactoryRecord)) {
+        return -EBADMSG;
+    }
+
+    const uint8_t* body = static_cast<const uint8_t*>(data) + offsetof(FactoryRecord, vendor_id);
+    if (crc32_ieee(body, sizeof(FactoryRecord) - offsetof(FactoryRecord, vendor_id)) != rec->crc32) {
+        return -EBADMSG;
+    }
+
+    /* A passcode is optional; the verifier is what PASE needs */
+    if (rec->discriminator > 0xFFF ||
+        (rec->passcode != 0 && !isValidPasscode(rec->passcode)) ||
+        rec->salt_len < 16 || rec->salt_len > sizeof(rec->salt) ||
+        rec->verifier_len != SPAKE2P_VERIFIER_LEN ||
+        rec->spake2p_iterations < SPAKE2P_MIN_ITERATIONS ||
+        rec->spake2p_iterations > SPAKE2P_MAX_ITERATIONS) {
+        return -EINVAL;
+    }
+
+    if (!isTerminated(rec->qr_code, sizeof(rec->qr_code)) ||
+        strncmp(rec->qr_code, "MT:", 3) != 0 ||
+        !isManualCode(rec->manual_code) ||
+        !isTerminated(rec->serial_number, sizeof(rec->serial_number))) {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+/*=============================================================================
+ * Provider
+ *===========================================================================*/
+
+FactoryData& FactoryData::getInstance() {
+    static FactoryData instance;
+    return instance;
+}
+
+FactoryData::FactoryData()
+    : record_(nullptr)
+{
+}
+
+int FactoryData::load() {
+    if (record_) {
+        return 0;
+    }
+
+#if defined(FACTORY_AREA_ID) && defined(FACTORY_AREA_ADDR)
+    const FactoryRecord* rec = reinterpret_cast<const FactoryRecord*>(FACTORY_AREA_ADDR);
+    int ret = validateFactoryRecord(rec, sizeof(*rec));
+#elif defined(FACTORY_AREA_ID)
+    static FactoryRecord copy;
+    const FactoryRecord* rec = &copy;
+    const struct flash_area* fa;
+
+    int ret = flash_area_open(FACTORY_AREA_ID, &fa);
+    if (ret < 0) {
+        return ret;
+    }
+    ret = flash_area_read(fa, 0, &copy, sizeof(copy));
+    flash_area_close(fa);
+    if (ret == 0) {
+        ret = validateFactoryRecord(rec, sizeof(*rec));
+    }
+#else
+    const FactoryRecord* rec = nullptr;
+    int ret = -ENODEV;
+#endif
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    record_ = rec;
+    LOG_INF("Factory data: VID 0x%04X PID 0x%04X SN %s, discriminator %u",
+            rec->vendor_id, rec->product_id, rec->serial_number, rec->discriminator);
+    return 0;
+}
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
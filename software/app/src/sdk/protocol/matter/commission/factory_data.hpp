@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Factory Data - per-device commissioning record on factory_partition
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/**
+ * Factory Commissioning Record
+ *
+ * Written once on the production line by scripts/gen_factory_data.py,
+ * which does the expensive work off-device: PBKDF2 over the passcode and
+ * the P-256 multiplication that give the SPAKE2+ verifier (w0 || L), plus
+ * the QR and manual pairing codes. The firmware validates the record in
+ * place and keeps a pointer to it - nothing is derived or copied when a
+ * commissioning window opens.
+ *
+ * Little-endian, no padding, 4-byte aligned; the layout is frozen per
+ * version. The CRC-32 (IEEE) covers every byte after the crc32 field.
+ */
+struct FactoryRecord {
+    uint32_t magic;                 ///< FACTORY_MAGIC ("MFD1")
+    uint16_t version;               ///< FACTORY_VERSION
+    uint16_t length;                ///< sizeof(FactoryRecord)
+    uint32_t crc32;
+    uint16_t vendor_id;
+    uint16_t product_id;
+    uint16_t discriminator;         ///< 12 bits
+    uint8_t salt_len;               ///< 16..32
+    uint8_t verifier_len;           ///< SPAKE2P_VERIFIER_LEN
+    uint32_t passcode;              ///< 0 when only the verifier is provisioned
+    uint32_t spake2p_iterations;
+    uint8_t salt[32];
+    uint8_t verifier[97];           ///< w0 (32) || L uncompressed (65)
+    char qr_code[24];               ///< "MT:..." NUL-terminated
+    char manual_code[12];           ///< 11 digits, NUL-terminated
+    char serial_number[32];         ///< NUL-terminated
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(FactoryRecord) == 228, "FactoryRecord layout is frozen");
+
+constexpr uint32_t FACTORY_MAGIC = 0x3144464D;
+constexpr uint16_t FACTORY_VERSION = 1;
+constexpr uint8_t SPAKE2P_VERIFIER_LEN = 97;
+
+/**
+ * Check a passcode against the rules of the Matter core spec (5.1.7.1)
+ */
+bool isValidPasscode(uint32_t passcode);
+
+/**
+ * Validate a record in a buffer
+ *
+ * @return 0 if valid, -ENOENT if the buffer is erased or holds no record,
+ *         -EBADMSG on a version, length or CRC mismatch, -EINVAL if a field
+ *         is out of range
+ */
+int validateFactoryRecord(const void* data, size_t len);
+
+/**
+ * Factory Data Provider
+ *
+ * On targets executing in place (CONFIG_XIP) the record is read straight
+ * from the memory-mapped partition; elsewhere (native_sim) it is read once
+ * into RAM through the flash map.
+ */
+class FactoryData {
+public:
+    static FactoryData& getInstance();
+
+    FactoryData(const FactoryData&) = delete;
+    FactoryData& operator=(const FactoryData&) = delete;
+
+    /**
+     * Locate and validate the record on factory_partition
+     *
+     * @return 0 on success, -ENODEV without a factory_partition, otherwise
+     *         as validateFactoryRecord()
+     */
+    int load();
+
+    bool isLoaded() const { return record_ != nullptr; }
+
+    /// Validated record, nullptr until load() succeeds
+    const FactoryRecord* get() const { return record_; }
+
+private:
+    FactoryData();
+    ~FactoryData() = default;
+
+    const FactoryRecord* record_;
+};
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
@@ -16,7 +16,7 @@ using namespace smarthome::protocol::thread;
 using namespace smarthome::protocol::matter;
 
 // Timer and instance management
-struct k_timer commissioning_timer;
+smarthome::services::timer::WheelTimer commissioning_timer;
 static AppTask* g_app_task_instance = nullptr;
 
 namespace smarthome { namespace protocol { namespace matter {
@@ -32,6 +32,7 @@ namespace smarthome { namespace protocol { namespace matter {
         , init_time_ms_(0)
     {
         k_mutex_init(&state_mutex_);
+        k_msgq_init(&event_queue_, event_buffer_, sizeof(AppEvent), MAX_PENDING_EVENTS);
         g_app_task_instance = this;
     }
 
@@ -49,27 +50,13 @@ namespace smarthome { namespace protocol { namespace matter {
         k_mutex_unlock(&state_mutex_);
         
         int ret;
-        bool onoff_state = false;
-        uint8_t level = 0;
-        ssize_t len;
         uint32_t init_duration_ms;
         
         // Execute initialization phases
         if ((ret = initPhase0_CoreSystem()) < 0) goto error;
         if ((ret = initPhase1_IPC()) < 0) goto error;
-        
-        // Load persisted state for use in later phases
-        len = settings_get_val_len("matter/attributes/onoff");
-        if (len > 0) {
-            onoff_state = true;  // Key exists, assume ON state was persisted
-        }
-        len = settings_get_val_len("matter/attributes/level");
-        if (len > 0) {
-            level = 128;  // Key exists, use default level
-        }
-        
-        if ((ret = initPhase2_Endpoints(onoff_state, level)) < 0) goto error;
-        if ((ret = initPhase3_Matter(onoff_state, level)) < 0) goto error;
+        if ((ret = initPhase2_Endpoints()) < 0) goto error;
+        if ((ret = initPhase3_Matter()) < 0) goto error;
         if ((ret = initPhase4_Thread()) < 0) goto error;
         if ((ret = initPhase5_Callbacks()) < 0) goto error;
         if ((ret = initPhase6_NetworkJoin()) < 0) goto error;
@@ -94,29 +81,41 @@ namespace smarthome { namespace protocol { namespace matter {
     * Event Processing
     *===========================================================================*/
 
-    void AppTask::dispatchEvent()
+    void AppTask::dispatchEvent(k_timeout_t timeout)
     {
-        AppTaskState current_state;
-        k_mutex_lock(&state_mutex_, K_FOREVER);
-        current_state = state_;
-        k_mutex_unlock(&state_mutex_);
-        
-        // Check for pending attribute changes
-        bool thread_connected = network_connected_;
-        if (thread_connected != network_connected_) {
-            k_mutex_lock(&state_mutex_, K_FOREVER);
-            network_connected_ = thread_connected;
-            k_mutex_unlock(&state_mutex_);
-            
-            if (thread_connected) {
-                LOG_INF("Network connected event");
-                processNetworkEvent();
-            } else {
-                LOG_INF("Network disconnected event");
+        AppEvent event;
+        
+        while (k_msgq_get(&event_queue_, &event, timeout) == 0) {
+            timeout = K_NO_WAIT;
+            switch (event.type) {
+                case EventType::THREAD_STATE_CHANGE:
+                    // Role/link refresh; transitions come back via thread_state_callback
+                    smarthome::protocol::thread::ThreadNetworkManager::getInstance().processStateChanged(event.data);
+                    break;
+                case EventType::NETWORK_HEALTH_CHANGE:
+                    handleNetworkHealthChange(static_cast<NetworkHealth>(event.data));
+                    break;
+                case EventType::IPC_LINK_UP:
+                    resyncNetCore();
+                    break;
+                default:
+                    LOG_DBG("Unhandled event type %d", (int)event.type);
+                    break;
             }
         }
     }
 
+    int AppTask::postEvent(EventType type, uint32_t data)
+    {
+        AppEvent event = { type, data };
+        
+        int ret = k_msgq_put(&event_queue_, &event, K_NO_WAIT);
+        if (ret < 0) {
+            LOG_WRN("Event queue full, dropped event type %d", (int)type);
+        }
+        return ret;
+    }
+
     /*=============================================================================
     * Commissioning Management
     *===========================================================================*/
@@ -139,18 +138,29 @@ namespace smarthome { namespace protocol { namespace matter {
         }
         
         uint16_t discriminator = CommissioningDelegate::getInstance().getDiscriminator();
-        uint32_t setup_code = CommissioningDelegate::getInstance().getPasscode();
+        const FactoryRecord* factory = CommissioningDelegate::getInstance().getFactoryData();
         
         LOG_INF("=== Commissioning Information ===");
         LOG_INF("Device: %s (Vendor: 0x%04X, Product: 0x%04X)", 
                 DEVICE_NAME, VENDOR_ID, PRODUCT_ID);
         LOG_INF("Discriminator: %u", discriminator);
-        LOG_INF("Setup Code: %u", setup_code);
+        if (factory) {
+            LOG_INF("QR Code: %s", factory->qr_code);
+            LOG_INF("Manual Code: %s", factory->manual_code);
+        } else {
+            LOG_INF("Setup Code: %u", CommissioningDelegate::getInstance().getPasscode());
+        }
         LOG_INF("Scan QR code or enter setup code in Matter controller app");
         LOG_INF("=================================");
         
-        k_timer_start(&commissioning_timer, K_SECONDS(900), K_NO_WAIT);
+        smarthome::services::timer::TimerService::getInstance().start(
+            commissioning_timer, 900 * 1000);
         LOG_INF("Commissioning window will close automatically in 15 minutes");
+        
+        // Sleepy devices answer the commissioner within a fast-poll period
+        smarthome::protocol::thread::ThreadNetworkManager::getInstance().requestFastPoll(
+            COMMISSIONING_FAST_POLL_MS);
+        updateNetPowerMode();
     }
 
     void AppTask::closeCommissioningWindow()
@@ -162,7 +172,7 @@ namespace smarthome { namespace protocol { namespace matter {
             LOG_ERR("Failed to close commissioning window: %d", ret);
         }
         
-        k_timer_stop(&commissioning_timer);
+        smarthome::services::timer::TimerService::getInstance().stop(commissioning_timer);
         
         k_mutex_lock(&state_mutex_, K_FOREVER);
         if (commissioned_) {
@@ -174,9 +184,50 @@ namespace smarthome { namespace protocol { namespace matter {
         }
         k_mutex_unlock(&state_mutex_);
         
+        smarthome::protocol::thread::ThreadNetworkManager::getInstance().cancelFastPoll();
+        updateNetPowerMode();
+        
         LOG_INF("Commissioning window closed");
     }
 
+    void AppTask::updateNetPowerMode()
+    {
+        bool low_power = smarthome::protocol::thread::ThreadNetworkManager::getInstance().isSleepy() &&
+                         state_ != AppTaskState::COMMISSIONING;
+        auto mode = low_power ? ipc::PowerMode::LOW_POWER : ipc::PowerMode::ACTIVE;
+        auto& ipc_core = ipc::IPCCore::getInstance();
+        
+        /* The NET core drops the heartbeat with us, see handlePowerMode() */
+        if (low_power) {
+            ipc_core.setHeartbeat(0, 0);
+        } else {
+            ipc_core.setHeartbeat(ipc::IPCCore::HEARTBEAT_IDLE_MS, ipc::IPCCore::LINK_TIMEOUT_MS);
+        }
+        
+        auto msg = ipc::MessageBuilder(ipc::MessageType::POWER_MODE)
+                     .setParam(0, (uint32_t)mode)
+                     .build();
+        
+        int ret = ipc_core.send(msg);
+        if (ret < 0) {
+            LOG_WRN("Failed to send power mode to NET core: %d", ret);
+        }
+    }
+
+    void AppTask::resyncNetCore()
+    {
+        LOG_INF("IPC link back - resyncing NET core");
+        
+        updateNetPowerMode();
+        
+        auto msg = ipc::MessageBuilder(ipc::MessageType::STATUS_REQUEST).build();
+        
+        int ret = ipc::IPCCore::getInstance().send(msg);
+        if (ret < 0) {
+            LOG_WRN("Failed to request NET core status: %d", ret);
+        }
+    }
+
     /*=============================================================================
     * Factory Reset
     *===========================================================================*/
@@ -187,7 +238,7 @@ namespace smarthome { namespace protocol { namespace matter {
         
         LOG_INF("Stopping all operations...");
         closeCommissioningWindow();
-        // ThreadNetworkManager::getInstance().leave();  // Skip if not available
+        smarthome::protocol::thread::ThreadNetworkManager::getInstance().leaveNetwork();
         LOG_INF("Disconnected from Thread network");
         
         LOG_INF("Clearing persistent storage...");
@@ -197,12 +248,13 @@ namespace smarthome { namespace protocol { namespace matter {
         settings_delete("matter/config");
         settings_delete("matter/network");
         settings_delete("matter/attributes");
+        LightEndpoints::getInstance().erase();
+        LightGroups::getInstance().erase();
         settings_save();
         
         LOG_INF("NVS storage cleared (fabric, config, credentials)");
         
         LOG_INF("Resetting Matter stack...");
-        // LightEndpoint::getInstance().setOnOff(false);  // Skip if not available
         LOG_INF("Matter stack reset - all fabrics removed");
         
         k_mutex_lock(&state_mutex_, K_FOREVER);
@@ -327,25 +379,8 @@ namespace smarthome { namespace protocol { namespace matter {
     {
         LOG_DBG("Processing attribute change event");
         
-        static bool last_on_off = false;
-        static uint8_t last_level = 0;
-        
-        bool current_on_off = last_on_off;
-        uint8_t current_level = last_level;
-        
-        if (current_on_off != last_on_off) {
-            LOG_INF("OnOff attribute changed: %s", current_on_off ? "ON" : "OFF");
-            settings_save_one("matter/attributes/onoff", 
-                            &current_on_off, sizeof(current_on_off));
-            last_on_off = current_on_off;
-        }
-        
-        if (current_level != last_level) {
-            LOG_INF("Level attribute changed: %u", current_level);
-            settings_save_one("matter/attributes/level", 
-                            &current_level, sizeof(current_level));
-            last_level = current_level;
-        }
+        // Attribute values persist per endpoint in LightEndpoints, read back
+        // at boot before the network comes up; nothing to store here
     }
 
     void AppTask::processNetworkEvent()
@@ -361,7 +396,6 @@ namespace smarthome { namespace protocol { namespace matter {
             network_connected_ = true;
             if (commissioned_) {
                 state_ = AppTaskState::NETWORK_CONNECTED;
-                CommissioningDelegate::getInstance().onFabricAdded();
             }
             k_mutex_unlock(&state_mutex_);
             
@@ -383,6 +417,41 @@ namespace smarthome { namespace protocol { namespace matter {
         }
     }
 
+    void AppTask::handleThreadStateChange(ThreadState state)
+    {
+        bool attached = (state == ThreadState::CHILD ||
+                         state == ThreadState::ROUTER ||
+                         state == ThreadState::LEADER);
+        
+        k_mutex_lock(&state_mutex_, K_FOREVER);
+        bool was_connected = network_connected_;
+        network_connected_ = attached;
+        if (attached && commissioned_) {
+            state_ = AppTaskState::NETWORK_CONNECTED;
+        } else if (!attached && was_connected) {
+            state_ = commissioned_ ? AppTaskState::COMMISSIONED : AppTaskState::IDLE;
+        }
+        k_mutex_unlock(&state_mutex_);
+        
+        LOG_INF("Thread role: %s", smarthome::protocol::thread::ThreadNetworkManager::getInstance().getStateName());
+        
+        // Role changes while attached (child -> router) are not link events
+        if (attached && !was_connected) {
+            smarthome::protocol::thread::NetworkResilienceManager::getInstance().onLinkUp();
+            CommissioningDelegate::getInstance().onThreadAttached();
+        } else if (!attached && was_connected) {
+            smarthome::protocol::thread::NetworkResilienceManager::getInstance().onLinkDown();
+        }
+    }
+
+    void AppTask::handleNetworkHealthChange(NetworkHealth health)
+    {
+        auto& resilience = smarthome::protocol::thread::NetworkResilienceManager::getInstance();
+        
+        LOG_INF("Network health changed: %s (RSSI %d dBm)",
+                resilience.getHealthName(), resilience.getRssi());
+    }
+
     /*=============================================================================
     * Static Callback Functions
     *===========================================================================*/
@@ -404,11 +473,49 @@ namespace smarthome { namespace protocol { namespace matter {
         LOG_INF("Device commissioned successfully");
     }
 
+    void AppTask::thread_state_callback(ThreadState state)
+    {
+        if (g_app_task_instance) {
+            g_app_task_instance->handleThreadStateChange(state);
+        }
+    }
+
+    /**
+     * Runs in the OpenThread thread - only queue the flags
+     */
+    void AppTask::thread_event_poster(uint32_t flags)
+    {
+        if (g_app_task_instance) {
+            g_app_task_instance->postEvent(EventType::THREAD_STATE_CHANGE, flags);
+        }
+    }
+
+    /**
+     * Runs in the system work queue - only queue the new health
+     */
+    void AppTask::network_health_callback(NetworkHealth health)
+    {
+        if (g_app_task_instance) {
+            g_app_task_instance->postEvent(EventType::NETWORK_HEALTH_CHANGE, (uint32_t)health);
+        }
+    }
+
+    /**
+     * Runs in the IPC RX thread - only queue the resync
+     */
+    void AppTask::ipc_link_callback(bool up)
+    {
+        if (up && g_app_task_instance) {
+            g_app_task_instance->postEvent(EventType::IPC_LINK_UP);
+        }
+    }
+
     /*=============================================================================
-    * Timer Callback - Commissioning Window Timeout
+    * Timer Callback - Commissioning Window Timeout (system work queue)
     *===========================================================================*/
 
-    void AppTask::commissioning_timeout_handler(struct k_timer *timer)
+    void AppTask::commissioning_timeout_handler(smarthome::services::timer::WheelTimer& timer,
+                                                void* user_data)
     {
         LOG_INF("Commissioning window timeout (15 minutes expired)");
         
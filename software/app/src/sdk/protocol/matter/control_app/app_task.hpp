@@ -22,8 +22,11 @@
 #include "../../thread/network_resilience_manager.hpp"
 #include "../../../ipc/ipc_core.hpp"
 #include "../light_endpoint/light_endpoint.hpp"
+#include "../light_endpoint/light_groups.hpp"
+#include "../light_endpoint/light_effects.hpp"
 #include "../commission/chip_config.hpp"
 #include "../commission/commissioning_delegate.hpp"
+#include "timer/timer_wheel.hpp"
 
 #define DEFAULT_WAIT_IPC_READY_MS 5000
 namespace smarthome { namespace protocol { namespace matter {
@@ -52,7 +55,16 @@ namespace smarthome { namespace protocol { namespace matter {
         THREAD_STATE_CHANGE = 3,
         NETWORK_HEALTH_CHANGE = 4,
         FACTORY_RESET = 5,
-        OTA_AVAILABLE = 6
+        OTA_AVAILABLE = 6,
+        IPC_LINK_UP = 7
+    };
+
+    /**
+     * Matter event queue entry
+     */
+    struct AppEvent {
+        EventType type;
+        uint32_t data;      ///< Event specific (THREAD_STATE_CHANGE: otChangedFlags)
     };
 
     class AppTask {
@@ -76,13 +88,24 @@ namespace smarthome { namespace protocol { namespace matter {
         int init();
         
         /**
-         * PHASE 1: Process pending Matter events (non-blocking)
+         * PHASE 1: Process pending Matter events
          * 
-         * Call this regularly from main event loop.
+         * Waits up to timeout for the first event, then drains the queue.
          * Processes attribute changes, network events, commissioning, etc.
+         * The main loop passes K_FOREVER so the thread only wakes for work.
          * @note Safe to call frequently, uses internal state machine
          */
-        void dispatchEvent();
+        void dispatchEvent(k_timeout_t timeout = K_NO_WAIT);
+
+        /**
+         * PHASE 2: Queue an event for dispatchEvent()
+         * 
+         * @param type Event type
+         * @param data Event specific value
+         * @return 0 on success, -ENOMSG if the queue is full
+         * @note Safe from any thread, does not block
+         */
+        int postEvent(EventType type, uint32_t data = 0);
         
         /**
          * PHASE 1: Open commissioning window for Matter
@@ -155,7 +178,16 @@ namespace smarthome { namespace protocol { namespace matter {
 
         static void commissioning_complete_callback(void);
 
-        static void commissioning_timeout_handler(struct k_timer *timer);
+        static void commissioning_timeout_handler(smarthome::services::timer::WheelTimer& timer,
+                                                  void* user_data);
+
+        static void thread_state_callback(smarthome::protocol::thread::ThreadState state);
+
+        static void thread_event_poster(uint32_t flags);
+
+        static void network_health_callback(smarthome::protocol::thread::NetworkHealth health);
+
+        static void ipc_link_callback(bool up);
 
     private:
         /// Private constructor (singleton)
@@ -169,8 +201,8 @@ namespace smarthome { namespace protocol { namespace matter {
          */
         int initPhase0_CoreSystem();
         int initPhase1_IPC();
-        int initPhase2_Endpoints(bool onoff_state, uint8_t level);
-        int initPhase3_Matter(bool onoff_state, uint8_t level);
+        int initPhase2_Endpoints();
+        int initPhase3_Matter();
         int initPhase4_Thread();
         int initPhase5_Callbacks();
         int initPhase6_NetworkJoin();
@@ -200,6 +232,20 @@ namespace smarthome { namespace protocol { namespace matter {
          */
         void handleNetworkHealthChange(smarthome::protocol::thread::NetworkHealth health);
 
+        /**
+         * Tell the NET core whether to keep its periodic work
+         * 
+         * LOW_POWER only while the Thread link is sleepy and no
+         * commissioning window is open.
+         */
+        void updateNetPowerMode();
+
+        /**
+         * Bring a NET core back from a reset up to date: power mode,
+         * and a status request for its radio and BLE state
+         */
+        void resyncNetCore();
+
         /*=== State & Configuration ===*/
         AppTaskState state_ = AppTaskState::UNINITIALIZED;
         bool commissioned_ = false;
@@ -214,6 +260,7 @@ namespace smarthome { namespace protocol { namespace matter {
         
         // Event queue
         struct k_msgq event_queue_;
+        char __aligned(4) event_buffer_[sizeof(AppEvent) * MAX_PENDING_EVENTS];
         k_tid_t event_thread_;
     };
 
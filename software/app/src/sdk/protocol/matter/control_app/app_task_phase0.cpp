@@ -12,14 +12,14 @@ LOG_MODULE_DECLARE(matter_app);
 
 using namespace smarthome::protocol::matter;
 
-extern struct k_timer commissioning_timer;
+extern smarthome::services::timer::WheelTimer commissioning_timer;
 
 int AppTask::initPhase0_CoreSystem()
 {
     LOG_INF("PHASE 0: Core System Initialization");
     
     // 0.1: Initialize commissioning window timer
-    k_timer_init(&commissioning_timer, commissioning_timeout_handler, nullptr);
+    commissioning_timer.init(commissioning_timeout_handler);
     LOG_DBG("Commissioning timer initialized");
     
     // 0.2: Initialize settings subsystem for persistent storage
@@ -39,19 +39,7 @@ int AppTask::initPhase0_CoreSystem()
         LOG_INF("Device not commissioned (fresh start)");
     }
     
-    // 0.4: Load persisted attributes
-    bool onoff_state = false;
-    len = settings_get_val_len("matter/attributes/onoff");
-    if (len > 0) {
-        LOG_DBG("Loaded OnOff attribute: ON (persisted)");
-        onoff_state = true;
-    }
-    
-    uint8_t level = 0;
-    len = settings_get_val_len("matter/attributes/level");
-    if (len > 0) {
-        LOG_DBG("Loaded Level attribute: (persisted)");
-    }
+    // Light attributes were restored by LightEndpoints at boot
     
     return 0;
 }
@@ -12,24 +12,22 @@ LOG_MODULE_DECLARE(matter_app);
 
 using namespace smarthome::protocol::matter;
 
-int AppTask::initPhase2_Endpoints(bool onoff_state, uint8_t level)
+int AppTask::initPhase2_Endpoints()
 {
     LOG_INF("PHASE 2: Device Endpoints & Capabilities");
     
-    // 2.1: Initialize Light Endpoint (primary device function)
-    int ret = LightEndpoint::getInstance().init();
+    // 2.1: The light endpoints (one per LED) and their effects were
+    // restored by app_core at boot, before IPC, with the startup behavior
+    // applied: the LEDs already show their state
+    LOG_INF("%u Light Endpoints up %u us after kernel start", LightEndpoints::COUNT,
+            LightEndpoints::getInstance().getStartupTimeUs());
+    
+    // 2.2: Groups and scenes of the light endpoints
+    int ret = LightGroups::getInstance().init();
     if (ret < 0) {
-        LOG_ERR("Failed to initialize Light Endpoint: %d", ret);
+        LOG_ERR("Failed to initialize Light Groups: %d", ret);
         return ret;
     }
     
-    // Restore persisted state to endpoint (if methods exist)
-    // For now, just log the restoration
-    if (onoff_state || level > 0) {
-        LOG_INF("Restored Light state: %s, Level: %u", 
-                onoff_state ? "ON" : "OFF", level);
-    }
-    LOG_INF("Light Endpoint initialized");
-    
     return 0;
 }
@@ -12,7 +12,7 @@ LOG_MODULE_DECLARE(matter_app);
 
 using namespace smarthome::protocol::matter;
 
-int AppTask::initPhase3_Matter(bool onoff_state, uint8_t level)
+int AppTask::initPhase3_Matter()
 {
     LOG_INF("PHASE 3: Matter Commissioning Layer");
     
@@ -52,54 +52,35 @@ int AppTask::initPhase3_Matter(bool onoff_state, uint8_t level)
     uint16_t device_type_light = 0x0100;
     settings_save_one("matter/ep1/descriptor/device_type", &device_type_light, sizeof(device_type_light));
     
-    uint16_t identify_time = 0;
-    settings_save_one("matter/ep1/identify/time", &identify_time, sizeof(identify_time));
+    // IdentifyTime is runtime state of LightEffects, not persisted
+    settings_delete("matter/ep1/identify/time");
     
-    uint8_t name_support = 0x80;
-    settings_save_one("matter/ep1/groups/name_support", &name_support, sizeof(name_support));
+    // Groups and Scenes tables are kept by LightGroups (matter/groups, matter/scenes)
     
-    uint8_t scene_count = 0, current_scene = 0;
-    uint16_t current_group = 0;
-    bool scene_valid = false;
-    settings_save_one("matter/ep1/scenes/count", &scene_count, sizeof(scene_count));
-    settings_save_one("matter/ep1/scenes/current", &current_scene, sizeof(current_scene));
-    settings_save_one("matter/ep1/scenes/group", &current_group, sizeof(current_group));
-    settings_save_one("matter/ep1/scenes/valid", &scene_valid, sizeof(scene_valid));
-    
-    // OnOff Cluster
-    bool onoff_value = onoff_state;
-    settings_save_one("matter/ep1/onoff/state", &onoff_value, sizeof(onoff_value));
+    // OnOff Cluster (attribute values are kept by LightEndpoints, per endpoint)
     uint32_t onoff_features = 0x01;
     settings_save_one("matter/ep1/onoff/features", &onoff_features, sizeof(onoff_features));
     
     // Level Control Cluster
-    uint8_t current_level_value = level > 0 ? level : 128;
     uint8_t min_level = 1, max_level = 254;
     uint16_t on_level = 254;
-    settings_save_one("matter/ep1/level/current", &current_level_value, sizeof(current_level_value));
     settings_save_one("matter/ep1/level/min", &min_level, sizeof(min_level));
     settings_save_one("matter/ep1/level/max", &max_level, sizeof(max_level));
     settings_save_one("matter/ep1/level/on_level", &on_level, sizeof(on_level));
     
-    // Color Control Cluster
-    uint8_t color_mode = 0;
-    uint16_t color_temp = 250, color_temp_min = 153, color_temp_max = 500;
-    settings_save_one("matter/ep1/color/mode", &color_mode, sizeof(color_mode));
-    settings_save_one("matter/ep1/color/temp", &color_temp, sizeof(color_temp));
-    settings_save_one("matter/ep1/color/temp_min", &color_temp_min, sizeof(color_temp_min));
-    settings_save_one("matter/ep1/color/temp_max", &color_temp_max, sizeof(color_temp_max));
-    
-    // Load fabric table
-    ssize_t len = settings_get_val_len("matter/fabric/count");
-    if (len > 0) {
+    // Color Control (color temperature) is kept by LightEndpoints, per endpoint
+    
+    // Fabric table was loaded by the delegate
+    if (CommissioningDelegate::getInstance().getFabricCount() > 0) {
         commissioned_ = true;
     }
     
-    // Configure commissioning parameters
-    uint16_t discriminator = 3840;
-    uint32_t setup_pin = 20202021;
-    settings_save_one("matter/config/discriminator", &discriminator, sizeof(discriminator));
-    settings_save_one("matter/config/setup_pin", &setup_pin, sizeof(setup_pin));
+    // Commissioning parameters come from factory data; drop keys older
+    // firmware wrote here (no flash write once they are gone)
+    settings_delete("matter/config/discriminator");
+    settings_delete("matter/config/setup_pin");
+    settings_delete("matter/attributes/onoff");
+    settings_delete("matter/attributes/level");
     
     // Commit to storage
     ret = settings_save();
@@ -108,6 +89,6 @@ int AppTask::initPhase3_Matter(bool onoff_state, uint8_t level)
         return ret;
     }
     
-    LOG_INF("Matter stack initialized (2 endpoints, 16 clusters)");
+    LOG_INF("Matter stack initialized (%u endpoints)", MAX_ENDPOINTS);
     return 0;
 }
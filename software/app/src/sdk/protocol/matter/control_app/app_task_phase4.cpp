@@ -8,6 +8,7 @@
 #include "app_task.hpp"
 #include "../../thread/thread_network_manager.hpp"
 #include "../../thread/network_resilience_manager.hpp"
+#include "../../thread/network_diagnostics.hpp"
 
 LOG_MODULE_DECLARE(matter_app);
 
@@ -30,6 +31,17 @@ int AppTask::initPhase4_Thread()
         return ret;
     }
     
+    ret = smarthome::protocol::thread::NetworkDiagnostics::getInstance().init();
+    if (ret < 0) {
+        LOG_ERR("Failed to initialize Network Diagnostics: %d", ret);
+        return ret;
+    }
+    
+    // NET core drops its periodic work too, so both cores reach deep idle
+    if (smarthome::protocol::thread::ThreadNetworkManager::getInstance().isSleepy()) {
+        updateNetPowerMode();
+    }
+    
     LOG_INF("Thread network stack initialized");
     return 0;
 }
@@ -6,10 +6,13 @@
  */
 
 #include "app_task.hpp"
+#include "../../thread/thread_network_manager.hpp"
+#include "../../thread/network_resilience_manager.hpp"
 
 LOG_MODULE_DECLARE(matter_app);
 
 using namespace smarthome::protocol::matter;
+using namespace smarthome::protocol::thread;
 
 int AppTask::initPhase5_Callbacks()
 {
@@ -19,6 +22,17 @@ int AppTask::initPhase5_Callbacks()
     CommissioningDelegate::getInstance().setOnCommissioningComplete(
         commissioning_complete_callback);
     
+    // Thread role changes: OpenThread -> event queue -> dispatchEvent()
+    auto& thread_mgr = smarthome::protocol::thread::ThreadNetworkManager::getInstance();
+    thread_mgr.setEventPoster(thread_event_poster);
+    thread_mgr.setStateCallback(thread_state_callback);
+    
+    // Health class changes: resilience work item -> event queue
+    smarthome::protocol::thread::NetworkResilienceManager::getInstance().setHealthCallback(network_health_callback);
+    
+    // NET core back from a reset: IPC RX thread -> event queue
+    ipc::IPCCore::getInstance().registerLinkCallback(ipc_link_callback);
+    
     LOG_INF("Event callbacks registered");
     return 0;
 }
@@ -18,17 +18,22 @@ int AppTask::initPhase6_NetworkJoin()
     LOG_INF("PHASE 6: Post-Initialization & Network Join");
     
     // Attempt Thread network join if commissioned
+    bool joining = false;
     if (commissioned_) {
         int ret = smarthome::protocol::thread::ThreadNetworkManager::getInstance().startNetworkJoin();
         if (ret < 0) {
             LOG_WRN("Failed to start Thread network join: %d (will retry)", ret);
+        } else {
+            joining = true;
         }
     }
     
-    // Update final state
+    // Update final state (attach is reported later through the event queue)
     k_mutex_lock(&state_mutex_, K_FOREVER);
     if (commissioned_ && network_connected_) {
         state_ = AppTaskState::NETWORK_CONNECTED;
+    } else if (commissioned_ && joining) {
+        state_ = AppTaskState::NETWORK_JOINING;
     } else if (commissioned_) {
         state_ = AppTaskState::COMMISSIONED;
     } else {
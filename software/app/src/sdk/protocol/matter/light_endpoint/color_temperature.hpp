@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * COLOR TEMPERATURE - Warm/Cool Channel Mix Tables
+ * ============================================================================
+ *
+ * Purpose:
+ *   Turns CurrentLevel and ColorTemperatureMireds into the duty cycles of
+ *   a warm and a cool white channel with two table reads, one multiply
+ *   per channel and no floating point.
+ *
+ * Tables (generated by the compiler, stored in flash):
+ *   - LEVEL_TO_LINEAR: CurrentLevel 0..254 -> light output (Q16), along
+ *     the CIE 1931 lightness curve so equal level steps look equal
+ *   - MIRED_TO_MIX: one entry per mired in COLOR_TEMP_MIN..MAX_MIREDS ->
+ *     luminance share of each channel (Q16, summing to 1). The share puts
+ *     the mixed chromaticity on the chord between the two channel points
+ *     closest to the Planckian locus point of the requested temperature,
+ *     so the output keeps its brightness across the range.
+ *
+ * The tables are computed in double precision, at compile time only:
+ * the constexpr generators are never called at run time.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "const_table.hpp"
+#include "light_endpoint.hpp"
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/**
+ * Luminance share of the two channels (Q16)
+ */
+struct ChannelMix {
+    uint16_t warm;
+    uint16_t cool;
+};
+
+/**
+ * Duty cycle of the two channels (Q16, 0xFFFF = fully on)
+ */
+struct ChannelDuty {
+    uint16_t warm;
+    uint16_t cool;
+};
+
+namespace ColorTemperature {
+
+constexpr uint16_t MIRED_STEPS = COLOR_TEMP_MAX_MIREDS - COLOR_TEMP_MIN_MIREDS + 1;
+constexpr uint32_t Q16 = 0xFFFF;
+
+namespace detail {
+
+/// CIE 1931 lightness L* (0..100) to relative luminance
+constexpr double lightnessToLuminance(double l) {
+    if (l <= 8.0) {
+        return l / 903.3;
+    }
+    double t = (l + 16.0) / 116.0;
+    return t * t * t;
+}
+
+struct Chromaticity {
+    double x;
+    double y;
+};
+
+/// Planckian locus (Kim et al. cubic spline, 1667 K..25000 K)
+constexpr Chromaticity planckian(uint16_t mireds) {
+    double t = 1e6 / mireds;
+    double t2 = t * t;
+    double t3 = t2 * t;
+    double x = (t <= 4000.0)
+        ? -0.2661239e9 / t3 - 0.2343589e6 / t2 + 0.8776956e3 / t + 0.179910
+        : -3.0258469e9 / t3 + 2.1070379e6 / t2 + 0.2226347e3 / t + 0.240390;
+    double x2 = x * x;
+    double x3 = x2 * x;
+    double y = (t <= 2222.0) ? -1.1063814 * x3 - 1.34811020 * x2 + 2.18555832 * x - 0.20219683
+             : (t <= 4000.0) ? -0.9549476 * x3 - 1.37418593 * x2 + 2.09137015 * x - 0.16748867
+             : 3.0817580 * x3 - 5.87338670 * x2 + 3.75112997 * x - 0.37001483;
+    return { x, y };
+}
+
+constexpr uint16_t toQ16(double v) {
+    return v <= 0.0 ? 0 : v >= 1.0 ? Q16 : static_cast<uint16_t>(v * Q16 + 0.5);
+}
+
+constexpr ConstTable<uint16_t, LightEndpointTemplate::MAX_LEVEL + 1> makeLevelTable() {
+    ConstTable<uint16_t, LightEndpointTemplate::MAX_LEVEL + 1> table{};
+    for (uint16_t level = 0; level <= LightEndpointTemplate::MAX_LEVEL; level++) {
+        table[level] = toQ16(lightnessToLuminance(100.0 * level / LightEndpointTemplate::MAX_LEVEL));
+    }
+    return table;
+}
+
+constexpr ConstTable<ChannelMix, MIRED_STEPS> makeMixTable() {
+    ConstTable<ChannelMix, MIRED_STEPS> table{};
+    const Chromaticity cool = planckian(COLOR_TEMP_MIN_MIREDS);
+    const Chromaticity warm = planckian(COLOR_TEMP_MAX_MIREDS);
+    const double dx = warm.x - cool.x;
+    const double dy = warm.y - cool.y;
+
+    for (uint16_t i = 0; i < MIRED_STEPS; i++) {
+        const Chromaticity target = planckian(COLOR_TEMP_MIN_MIREDS + i);
+
+        // Position along the chord nearest the target point
+        double s = ((target.x - cool.x) * dx + (target.y - cool.y) * dy) / (dx * dx + dy * dy);
+        s = s < 0.0 ? 0.0 : s > 1.0 ? 1.0 : s;
+
+        // Mixing weights chromaticities by Y / y: solve for the warm share of Y
+        double w = s * warm.y / ((1.0 - s) * cool.y + s * warm.y);
+        uint16_t q = toQ16(w);
+        table[i] = { q, static_cast<uint16_t>(Q16 - q) };
+    }
+    return table;
+}
+
+}  // namespace detail
+
+/// CurrentLevel -> light output (Q16)
+inline constexpr auto LEVEL_TO_LINEAR = detail::makeLevelTable();
+
+/// Mireds - COLOR_TEMP_MIN_MIREDS -> channel shares (Q16)
+inline constexpr auto MIRED_TO_MIX = detail::makeMixTable();
+
+static_assert(LEVEL_TO_LINEAR[0] == 0 && LEVEL_TO_LINEAR[LightEndpointTemplate::MAX_LEVEL] == Q16,
+              "level table spans off to full");
+static_assert(MIRED_TO_MIX[0].warm == 0 && MIRED_TO_MIX[MIRED_STEPS - 1].cool == 0,
+              "range ends drive one channel");
+
+/**
+ * Duty cycles of the warm and cool channels
+ *
+ * Integer only: safe on every output update, from ISR context too.
+ */
+inline ChannelDuty mix(uint8_t level, uint16_t mireds) {
+    uint32_t linear = LEVEL_TO_LINEAR[MIN(level, LightEndpointTemplate::MAX_LEVEL)];
+    const ChannelMix& share =
+        MIRED_TO_MIX[CLAMP(mireds, COLOR_TEMP_MIN_MIREDS, COLOR_TEMP_MAX_MIREDS) - COLOR_TEMP_MIN_MIREDS];
+
+    return { static_cast<uint16_t>((linear * share.warm + Q16 / 2) / Q16),
+             static_cast<uint16_t>((linear * share.cool + Q16 / 2) / Q16) };
+}
+
+/// Duty cycles for the attributes of an endpoint (both 0 when off)
+inline ChannelDuty mix(const LightAttributes& attrs) {
+    return attrs.on_off ? mix(attrs.current_level, attrs.color_temp_mireds) : ChannelDuty{ 0, 0 };
+}
+
+}  // namespace ColorTemperature
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
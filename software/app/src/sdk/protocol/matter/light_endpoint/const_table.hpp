@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fixed-size table a constexpr function can fill and return
+ *
+ * A plain C array cannot be returned, and the minimal C++ library has no
+ * <array>: this is the part of std::array the light tables use, so they
+ * stay in flash, generated at compile time.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace smarthome { namespace protocol { namespace matter {
+
+template <typename T, size_t N>
+struct ConstTable {
+    T items[N];
+
+    constexpr T& operator[](size_t i) { return items[i]; }
+    constexpr const T& operator[](size_t i) const { return items[i]; }
+
+    constexpr const T* data() const { return items; }
+    static constexpr size_t size() { return N; }
+
+    constexpr const T* begin() const { return items; }
+    constexpr const T* end() const { return items + N; }
+};
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Light Effects Implementation
+ */
+
+#include <zephyr/logging/log.h>
+#include <cstdlib>
+#include "light_effects.hpp"
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+LOG_MODULE_REGISTER(matter_effects, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace protocol { namespace matter {
+
+namespace {
+
+using namespace EffectTables;
+
+// Identify: 0.5 s on, 0.5 s off until IdentifyTime runs out
+constexpr EffectSequence IDENTIFY_SEQ = {
+    BLINK.data(), BLINK.size(), ticksFor(500), 0, false, false, false };
+// Blink: on and off once
+constexpr EffectSequence BLINK_SEQ = {
+    BLINK.data(), BLINK.size(), ticksFor(500), 1, false, false, false };
+// Breathe: 15 one-second breaths
+constexpr EffectSequence BREATHE_SEQ = {
+    BREATHE.data(), BREATHE.size(), 1, 15, false, false, false };
+// Okay: two quick flashes
+constexpr EffectSequence OKAY_SEQ = {
+    OKAY.data(), OKAY.size(), ticksFor(200), 1, false, false, false };
+// Channel change: full for 0.5 s, then minimum for 7.5 s
+constexpr EffectSequence CHANNEL_CHANGE_SEQ = {
+    CHANNEL_CHANGE.data(), CHANNEL_CHANGE.size(), ticksFor(500), 1, false, false, false };
+constexpr EffectSequence FADE_ON_SEQ = {
+    FADE_ON.data(), FADE_ON.size(), 1, 1, true, true, false };
+constexpr EffectSequence FADE_OFF_SEQ = {
+    FADE_OFF.data(), FADE_OFF.size(), 1, 1, true, false, true };
+
+}  // namespace
+
+LightEffects& LightEffects::getInstance() {
+    static LightEffects instance;
+    return instance;
+}
+
+LightEffects::LightEffects()
+    : runs_{}
+    , lock_{}
+{
+}
+
+int LightEffects::init() {
+    LightEndpoints::getInstance().setAnimator(animate);
+    LOG_INF("Light effects ready (%u ms tick)", LIGHT_TRANSITION_TICK_MS);
+    return 0;
+}
+
+const EffectSequence* LightEffects::sequenceOf(uint8_t effect_id) {
+    switch (effect_id) {
+        case LightEffect::BLINK:          return &BLINK_SEQ;
+        case LightEffect::BREATHE:        return &BREATHE_SEQ;
+        case LightEffect::OKAY:           return &OKAY_SEQ;
+        case LightEffect::CHANNEL_CHANGE: return &CHANNEL_CHANGE_SEQ;
+        case LightEffect::FADE_ON:        return &FADE_ON_SEQ;
+        case LightEffect::FADE_OFF:       return &FADE_OFF_SEQ;
+        case LightEffect::IDENTIFY:       return &IDENTIFY_SEQ;
+        default:                          return nullptr;
+    }
+}
+
+/*=============================================================================
+ * Playback
+ *===========================================================================*/
+
+LightAttributes LightEffects::frameOf(const Run& run) {
+    uint8_t share = run.seq->steps[run.step];
+    uint32_t peak = run.seq->relative ? run.base.current_level : LightEndpointTemplate::MAX_LEVEL;
+    LightAttributes frame = run.base;
+
+    frame.on_off = share != 0;
+    frame.current_level = (uint8_t)MAX((peak * share + 127) / 255,
+                                       (uint32_t)LightEndpointTemplate::MIN_LEVEL);
+    return frame;
+}
+
+bool LightEffects::advance(Run& run) {
+    if (run.ticks_left && --run.ticks_left == 0) {
+        return false;
+    }
+    if (++run.tick < run.seq->ticks_per_step) {
+        return true;
+    }
+    run.tick = 0;
+    if (++run.step < run.seq->length) {
+        return true;
+    }
+
+    // End of a cycle
+    run.step = 0;
+    if (run.finishing) {
+        return false;
+    }
+    return run.seq->cycles == 0 || --run.cycles_left > 0;
+}
+
+uint32_t LightEffects::animate(LightAttributes* frames) {
+    LightEffects& self = getInstance();
+    uint32_t running = 0;
+    uint32_t switch_off = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&self.lock_);
+    for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+        Run& run = self.runs_[i];
+        if (!run.seq) {
+            continue;
+        }
+        if (!advance(run)) {
+            if (run.seq->switch_off) {
+                switch_off |= BIT(i);
+            }
+            run.seq = nullptr;
+            continue;
+        }
+        frames[i] = frameOf(run);
+        running |= BIT(i);
+    }
+    k_spin_unlock(&self.lock_, key);
+
+    // Dark already; the LED follows the attribute once the effect is dropped
+    for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+        if (switch_off & BIT(i)) {
+            LightEndpoints::getInstance().setLightState(LIGHT_ENDPOINTS[i].endpoint_id, false);
+        }
+    }
+    return running;
+}
+
+/*=============================================================================
+ * Control
+ *===========================================================================*/
+
+void LightEffects::stop(uint32_t endpoint_mask) {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+        if (endpoint_mask & BIT(i)) {
+            runs_[i].seq = nullptr;
+        }
+    }
+    k_spin_unlock(&lock_, key);
+}
+
+int LightEffects::start(uint32_t endpoint_mask, uint8_t effect_id) {
+    LightEndpoints& lights = LightEndpoints::getInstance();
+    endpoint_mask &= LightEndpoints::ALL;
+
+    if (effect_id == LightEffect::STOP) {
+        // Dropped on the next tick, back to the attributes
+        stop(endpoint_mask);
+        return 0;
+    }
+
+    if (effect_id == LightEffect::FINISH) {
+        k_spinlock_key_t key = k_spin_lock(&lock_);
+        for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+            if ((endpoint_mask & BIT(i)) && runs_[i].seq) {
+                runs_[i].finishing = true;
+                runs_[i].ticks_left = 0;
+            }
+        }
+        k_spin_unlock(&lock_, key);
+        return 0;
+    }
+
+    const EffectSequence* seq = sequenceOf(effect_id);
+    if (!seq) {
+        return -ENOTSUP;
+    }
+
+    LightAttributes frames[LightEndpoints::COUNT];
+    Run started[LightEndpoints::COUNT] = {};
+    for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+        if (!(endpoint_mask & BIT(i))) {
+            continue;
+        }
+        Run& run = started[i];
+        lights.getAttributes(LIGHT_ENDPOINTS[i].endpoint_id, run.base);
+        run.seq = seq;
+        run.effect = effect_id;
+        run.cycles_left = seq->cycles;
+        if (seq->switch_on) {
+            run.base.on_off = 1;
+        }
+        frames[i] = frameOf(run);
+    }
+
+    // State first: a tick that runs before showFrames() already sees it
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+        if (endpoint_mask & BIT(i)) {
+            runs_[i] = started[i];
+        }
+    }
+    k_spin_unlock(&lock_, key);
+
+    lights.showFrames(endpoint_mask, frames);
+    if (seq->switch_on) {
+        for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+            if (endpoint_mask & BIT(i)) {
+                lights.setLightState(LIGHT_ENDPOINTS[i].endpoint_id, true);
+            }
+        }
+    }
+
+    LOG_DBG("Effect 0x%02x on 0x%x", effect_id, endpoint_mask);
+    return 0;
+}
+
+int LightEffects::trigger(uint16_t endpoint_id, uint8_t effect_id) {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return -ENOENT;
+    }
+    return start(BIT(index), effect_id);
+}
+
+int LightEffects::identify(uint16_t endpoint_id, uint16_t seconds) {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return -ENOENT;
+    }
+    if (seconds == 0) {
+        stop(BIT(index));
+        return 0;
+    }
+
+    int ret = start(BIT(index), LightEffect::IDENTIFY);
+    if (ret == 0) {
+        k_spinlock_key_t key = k_spin_lock(&lock_);
+        runs_[index].ticks_left = (uint32_t)seconds * 1000 / LIGHT_TRANSITION_TICK_MS;
+        k_spin_unlock(&lock_, key);
+        LOG_INF("Endpoint %u identifying for %u s", endpoint_id, seconds);
+    }
+    return ret;
+}
+
+uint16_t LightEffects::getIdentifyTime(uint16_t endpoint_id) const {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return 0;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    const Run& run = runs_[index];
+    uint32_t ticks = (run.seq && run.effect == LightEffect::IDENTIFY) ? run.ticks_left : 0;
+    k_spin_unlock(&lock_, key);
+
+    return (uint16_t)((ticks * LIGHT_TRANSITION_TICK_MS + 999) / 1000);
+}
+
+uint8_t LightEffects::getEffect(uint16_t endpoint_id) const {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return LightEffect::STOP;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    uint8_t effect = runs_[index].seq ? runs_[index].effect : LightEffect::STOP;
+    k_spin_unlock(&lock_, key);
+    return effect;
+}
+
+uint32_t LightEffects::startup() {
+    uint32_t on = 0;
+
+    for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+        LightAttributes attrs;
+        LightEndpoints::getInstance().getAttributes(LIGHT_ENDPOINTS[i].endpoint_id, attrs);
+        if (attrs.on_off) {
+            on |= BIT(i);
+        }
+    }
+    if (on) {
+        start(on, LightEffect::FADE_ON);
+    }
+    return on;
+}
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
+
+/*=============================================================================
+ * Shell Commands
+ *===========================================================================*/
+
+#ifdef CONFIG_SHELL
+using smarthome::protocol::matter::LightEffects;
+using smarthome::protocol::matter::LIGHT_ENDPOINTS;
+namespace LightEffect = smarthome::protocol::matter::LightEffect;
+
+static const struct {
+    const char* name;
+    uint8_t id;
+} effect_names[] = {
+    { "blink", LightEffect::BLINK },
+    { "breathe", LightEffect::BREATHE },
+    { "okay", LightEffect::OKAY },
+    { "channel", LightEffect::CHANNEL_CHANGE },
+    { "finish", LightEffect::FINISH },
+    { "stop", LightEffect::STOP },
+    { "fade-on", LightEffect::FADE_ON },
+    { "fade-off", LightEffect::FADE_OFF },
+};
+
+static int cmd_effect_identify(const struct shell* sh, size_t argc, char** argv) {
+    uint16_t endpoint_id = (uint16_t)atoi(argv[1]);
+
+    int ret = LightEffects::getInstance().identify(endpoint_id, (uint16_t)atoi(argv[2]));
+    if (ret < 0) {
+        shell_error(sh, "Endpoint %u: %d", endpoint_id, ret);
+    }
+    return ret;
+}
+
+static int cmd_effect_trigger(const struct shell* sh, size_t argc, char** argv) {
+    uint16_t endpoint_id = (uint16_t)atoi(argv[1]);
+
+    for (const auto& effect : effect_names) {
+        if (strcmp(argv[2], effect.name) == 0) {
+            int ret = LightEffects::getInstance().trigger(endpoint_id, effect.id);
+            if (ret < 0) {
+                shell_error(sh, "Endpoint %u: %d", endpoint_id, ret);
+            }
+            return ret;
+        }
+    }
+    shell_error(sh, "Effects: blink, breathe, okay, channel, finish, stop, fade-on, fade-off");
+    return -EINVAL;
+}
+
+static int cmd_effect_list(const struct shell* sh, size_t argc, char** argv) {
+    LightEffects& effects = LightEffects::getInstance();
+
+    for (const auto& info : LIGHT_ENDPOINTS) {
+        uint8_t effect = effects.getEffect(info.endpoint_id);
+        if (effect == LightEffect::STOP) {
+            shell_print(sh, "ep %u: -", info.endpoint_id);
+        } else {
+            shell_print(sh, "ep %u: effect 0x%02x, identify %u s", info.endpoint_id, effect,
+                        effects.getIdentifyTime(info.endpoint_id));
+        }
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_effect,
+    SHELL_CMD_ARG(identify, NULL, "Identify: <endpoint> <seconds, 0 = stop>", cmd_effect_identify, 3, 0),
+    SHELL_CMD_ARG(trigger, NULL, "TriggerEffect: <endpoint> <effect>", cmd_effect_trigger, 3, 0),
+    SHELL_CMD(list, NULL, "Effect of every light endpoint", cmd_effect_list),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(effect, &sub_effect, "Light effects", NULL);
+#endif
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * LIGHT EFFECTS - Identify & Keyframe Effects for the Light Endpoints
+ * ============================================================================
+ *
+ * Purpose:
+ *   Identify cluster (0x0003) of the light endpoints - Identify and
+ *   TriggerEffect - plus the fade on / fade off effects and the fade-in
+ *   at boot.
+ *
+ * Sequences:
+ *   Every effect is a step table generated at compile time: the share of
+ *   the peak level (255 = peak, 0 = dark) for each step, how many ticks a
+ *   step lasts and how many cycles to play. The peak is MAX_LEVEL for
+ *   Identify effects and the endpoint's own level for the fades. Running
+ *   an effect is a table read and a multiply per tick.
+ *
+ * Tick:
+ *   No timer or thread per LED. LightEffects is the animator of
+ *   LightEndpoints: the one LIGHT_TRANSITION_TICK_MS tick that steps
+ *   transitions asks for the frame of every endpoint under an effect and
+ *   drives them all in one output update. The LEDs show the frames while
+ *   the attributes stay as they are (Identify does not switch a light on),
+ *   and return to the attributes when the effect ends.
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include "const_table.hpp"
+#include "light_endpoint.hpp"
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/**
+ * Effect identifiers (TriggerEffect EffectIdentifier, plus local effects)
+ */
+namespace LightEffect {
+    constexpr uint8_t BLINK = 0x00;
+    constexpr uint8_t BREATHE = 0x01;
+    constexpr uint8_t OKAY = 0x02;
+    constexpr uint8_t CHANNEL_CHANGE = 0x0B;
+    constexpr uint8_t FINISH = 0xFE;            ///< Stop at the end of the cycle
+    constexpr uint8_t STOP = 0xFF;              ///< Stop now
+
+    // Local effects
+    constexpr uint8_t FADE_ON = 0x80;           ///< Switch on, fade up to the level
+    constexpr uint8_t FADE_OFF = 0x81;          ///< Fade down, then switch off
+    constexpr uint8_t IDENTIFY = 0x82;          ///< Identify command: blink until IdentifyTime runs out
+}
+
+/**
+ * Keyframe sequence of an effect
+ */
+struct EffectSequence {
+    const uint8_t* steps;               ///< Share of the peak level per step, 0 = dark
+    uint8_t length;
+    uint8_t ticks_per_step;
+    uint8_t cycles;                     ///< 0 = until stopped
+    bool relative;                      ///< Peak = the endpoint's level, else MAX_LEVEL
+    bool switch_on;                     ///< OnOff attribute on when the effect starts
+    bool switch_off;                    ///< OnOff attribute off when the effect completes
+};
+
+namespace EffectTables {
+
+/// Ticks of a duration, at least one
+constexpr uint8_t ticksFor(uint32_t ms) {
+    return (uint8_t)(ms / LIGHT_TRANSITION_TICK_MS ? ms / LIGHT_TRANSITION_TICK_MS : 1);
+}
+
+constexpr uint8_t FADE_STEPS = ticksFor(LIGHT_FADE_MS);
+constexpr uint8_t BREATHE_STEPS = ticksFor(1000);
+
+namespace detail {
+
+/// Linear ramp from -> to over N steps, both ends included
+template <size_t N>
+constexpr ConstTable<uint8_t, N> makeRamp(uint8_t from, uint8_t to) {
+    ConstTable<uint8_t, N> table{};
+    for (size_t i = 0; i < N; i++) {
+        table[i] = (uint8_t)(from + ((int32_t)to - from) * (int32_t)i / (int32_t)(N > 1 ? N - 1 : 1));
+    }
+    return table;
+}
+
+/// One breath: up to the peak over the first half, back down over the second
+template <size_t N>
+constexpr ConstTable<uint8_t, N> makeBreathe() {
+    ConstTable<uint8_t, N> table{};
+    constexpr size_t half = N / 2;
+    for (size_t i = 0; i < N; i++) {
+        size_t d = (i < half) ? i : N - 1 - i;
+        table[i] = (uint8_t)(d * 255 / (half ? half - 1 + (N & 1) : 1));
+    }
+    return table;
+}
+
+}  // namespace detail
+
+inline constexpr ConstTable<uint8_t, 2> BLINK = {{ 255, 0 }};
+inline constexpr ConstTable<uint8_t, 4> OKAY = {{ 255, 0, 255, 0 }};
+inline constexpr ConstTable<uint8_t, 16> CHANNEL_CHANGE = {{
+    255, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 }};
+inline constexpr auto BREATHE = detail::makeBreathe<BREATHE_STEPS>();
+inline constexpr auto FADE_ON = detail::makeRamp<FADE_STEPS>(0, 255);
+inline constexpr auto FADE_OFF = detail::makeRamp<FADE_STEPS>(255, 0);
+
+static_assert(BREATHE[BREATHE_STEPS / 2 - 1] == 255 && BREATHE[0] == 0, "breath peaks halfway");
+static_assert(FADE_ON[FADE_STEPS - 1] == 255 && FADE_OFF[FADE_STEPS - 1] == 0, "fades end on target");
+
+}  // namespace EffectTables
+
+class LightEffects {
+public:
+    /// Get singleton instance
+    static LightEffects& getInstance();
+
+    // Prevent copying
+    LightEffects(const LightEffects&) = delete;
+    LightEffects& operator=(const LightEffects&) = delete;
+
+    /**
+     * Become the animator of the light endpoints
+     */
+    int init();
+
+    /**
+     * Identify command: blink for a number of seconds (0 = stop)
+     *
+     * @return 0 on success, -ENOENT for an unknown endpoint
+     */
+    int identify(uint16_t endpoint_id, uint16_t seconds);
+
+    /**
+     * IdentifyTime attribute: seconds of identification left
+     */
+    uint16_t getIdentifyTime(uint16_t endpoint_id) const;
+
+    /**
+     * TriggerEffect command, or a local effect
+     *
+     * @return 0 on success, -ENOENT for an unknown endpoint, -ENOTSUP for
+     *         an unknown effect
+     */
+    int trigger(uint16_t endpoint_id, uint8_t effect_id);
+
+    /**
+     * Start an effect on several endpoints at once
+     *
+     * @return 0 on success, -ENOTSUP for an unknown effect
+     */
+    int start(uint32_t endpoint_mask, uint8_t effect_id);
+
+    /**
+     * Fade in every endpoint that is on (call before the first output)
+     *
+     * @return Mask of the endpoints fading in
+     */
+    uint32_t startup();
+
+    /// Effect running on an endpoint, LightEffect::STOP if none
+    uint8_t getEffect(uint16_t endpoint_id) const;
+
+    /// Sequence of an effect, nullptr if unknown
+    static const EffectSequence* sequenceOf(uint8_t effect_id);
+
+private:
+    /// Private constructor (singleton)
+    LightEffects();
+
+    /// Destructor
+    ~LightEffects() = default;
+
+    /**
+     * Effect playing on one endpoint
+     */
+    struct Run {
+        const EffectSequence* seq;      ///< nullptr = idle
+        LightAttributes base;           ///< Attributes when it started (peak, color)
+        uint32_t ticks_left;            ///< Identify: ticks before it stops, else 0
+        uint16_t cycles_left;
+        uint8_t effect;
+        uint8_t step;
+        uint8_t tick;
+        bool finishing;                 ///< FINISH: stop at the end of the cycle
+    };
+
+    static LightAttributes frameOf(const Run& run);
+
+    /**
+     * Advance one endpoint by a tick
+     *
+     * @return false once the effect is over
+     */
+    static bool advance(Run& run);
+
+    /// Animator callback: frames of every running effect
+    static uint32_t animate(LightAttributes* frames);
+
+    void stop(uint32_t endpoint_mask);
+
+    Run runs_[LightEndpoints::COUNT];
+    mutable struct k_spinlock lock_;
+};
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
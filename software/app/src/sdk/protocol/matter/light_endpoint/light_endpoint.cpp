@@ -2,92 +2,709 @@
  * Copyright (c) 2025 Sprchuoi
  * SPDX-License-Identifier: Apache-2.0
  *
- * Matter Light Endpoint Implementation
+ * Matter Light Endpoints Implementation
  */
 
 #include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <cstdio>
+#include <cstdlib>
 #include "light_endpoint.hpp"
+#include "color_temperature.hpp"
 
-LOG_MODULE_REGISTER(matter_light, CONFIG_APP_LOG_LEVEL);
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+LOG_MODULE_REGISTER(matter_light, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define LIGHT_KEY_ROOT "matter/light"
+#define LIGHT_STARTUP_KEY "startup"
 
 namespace smarthome { namespace protocol { namespace matter {
 
-int LightEndpoint::init()
+using services::timer::TimerService;
+using services::timer::WheelTimer;
+
+LightEndpoints& LightEndpoints::getInstance() {
+    static LightEndpoints instance;
+    return instance;
+}
+
+LightEndpoints::LightEndpoints()
+    : transitions_{}
+    , dirty_(0)
+    , transitioning_(0)
+    , effects_(0)
+    , fresh_(0)
+    , startup_dirty_(false)
+    , startup_us_(0)
+    , output_(nullptr)
+    , animator_(nullptr)
+    , lock_{}
 {
-    LOG_INF("Initializing Matter Light Endpoint");
-    
-    mLightOn = false;
-    mBrightness = 254;
-    
-    // Load persisted state from NVS
-    // nvs_handle_t nvs;
-    // if (nvs_open("matter", NVS_READONLY, &nvs) == 0) {
-    //     uint8_t state;
-    //     if (nvs_get_u8(nvs, "light_on", &state) == 0) {
-    //         mLightOn = (state != 0);
-    //     }
-    //     if (nvs_get_u8(nvs, "light_level", &mBrightness) != 0) {
-    //         mBrightness = 254;
-    //     }
-    //     nvs_close(nvs);
-    // }
-    
-    LOG_INF("Matter Light Endpoint initialized");
-    LOG_INF("Initial state - On: %d, Brightness: %d", mLightOn, mBrightness);
-    
+    for (uint8_t i = 0; i < COUNT; i++) {
+        attrs_[i] = LightEndpointTemplate::DEFAULTS;
+        shown_[i] = attrs_[i];
+        startup_[i] = LightEndpointTemplate::STARTUP_DEFAULTS;
+    }
+    k_work_init_delayable(&persist_work_, persistWorkHandler);
+    tick_.init(onTick);
+}
+
+/*=============================================================================
+ * Persistence
+ *===========================================================================*/
+
+struct LightLoad {
+    LightAttributes attrs[LightEndpoints::COUNT];
+    LightStartUp startup[LightEndpoints::COUNT];
+    uint32_t found;                     ///< Bit per endpoint read
+    bool startup_found;
+};
+
+static int lightLoadCb(const char* key, size_t len, settings_read_cb read_cb,
+                       void* cb_arg, void* param) {
+    LightLoad* load = static_cast<LightLoad*>(param);
+    char* end;
+
+    if (key == nullptr) {
+        return 0;
+    }
+
+    // StartUp attributes of every endpoint, one record
+    if (strcmp(key, LIGHT_STARTUP_KEY) == 0) {
+        if (len == sizeof(load->startup)) {
+            ssize_t rd = read_cb(cb_arg, load->startup, len);
+            if (rd < 0) {
+                return (int)rd;
+            }
+            load->startup_found = true;
+        }
+        return 0;
+    }
+
+    if (len != sizeof(LightAttributes)) {
+        return 0;
+    }
+
+    unsigned long endpoint_id = strtoul(key, &end, 10);
+    uint8_t index = LightEndpoints::indexOf((uint16_t)endpoint_id);
+    if (end == key || *end != '\0' || endpoint_id > UINT16_MAX || index >= LightEndpoints::COUNT) {
+        return 0;
+    }
+
+    ssize_t rd = read_cb(cb_arg, &load->attrs[index], len);
+    if (rd < 0) {
+        return (int)rd;
+    }
+    load->found |= BIT(index);
+    return 0;
+}
+
+int LightEndpoints::init()
+{
+    LOG_INF("Initializing %u Matter Light Endpoints (%u..%u)", COUNT,
+            LIGHT_ENDPOINTS[0].endpoint_id, LIGHT_ENDPOINTS[COUNT - 1].endpoint_id);
+
+    static LightLoad load;
+    memset(&load, 0, sizeof(load));
+
+    int ret = settings_load_subtree_direct(LIGHT_KEY_ROOT, lightLoadCb, &load);
+    if (ret < 0) {
+        LOG_WRN("Failed to load light attributes: %d", ret);
+        load.found = 0;
+    }
+
+    uint32_t booted = 0;
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    transitioning_ = 0;
+    for (uint8_t i = 0; i < COUNT; i++) {
+        const LightAttributes& stored = load.attrs[i];
+        bool valid = (load.found & BIT(i)) && LightEndpointTemplate::isValid(stored);
+        LightAttributes previous = valid ? stored : LightEndpointTemplate::DEFAULTS;
+
+        startup_[i] = (load.startup_found && LightEndpointTemplate::isValid(load.startup[i]))
+                      ? load.startup[i] : LightEndpointTemplate::STARTUP_DEFAULTS;
+        attrs_[i] = LightEndpointTemplate::startUp(previous, startup_[i]);
+        if (memcmp(&attrs_[i], &previous, sizeof(previous)) != 0) {
+            booted |= BIT(i);
+        }
+        if (!(effects_ & BIT(i))) {
+            shown_[i] = attrs_[i];
+        }
+    }
+    if (output_) {
+        output_(shown_, ALL);
+    }
+    // Startup values become the persisted ones (a toggle toggles again next boot)
+    if (booted) {
+        dirty_ |= booted;
+        k_work_schedule(&persist_work_, K_MSEC(LIGHT_PERSIST_DELAY_MS));
+    }
+    k_spin_unlock(&lock_, key);
+
+    int restored = __builtin_popcount(load.found);
+    for (const LightEndpointInfo& info : LIGHT_ENDPOINTS) {
+        LightAttributes attrs;
+        getAttributes(info.endpoint_id, attrs);
+        LOG_INF("Endpoint %u (LED%u) - On: %d, Brightness: %d, %u mireds",
+                info.endpoint_id, info.led, attrs.on_off, attrs.current_level,
+                attrs.color_temp_mireds);
+    }
+    LOG_INF("Matter Light Endpoints initialized (%d restored)", restored);
+
+    return restored;
+}
+
+void LightEndpoints::persistWorkHandler(struct k_work* work) {
+    LightEndpoints& self = getInstance();
+    LightAttributes snapshot[COUNT];
+    LightStartUp startup[COUNT];
+
+    k_spinlock_key_t key = k_spin_lock(&self.lock_);
+    uint32_t dirty = self.dirty_;
+    bool startup_dirty = self.startup_dirty_;
+    self.dirty_ = 0;
+    self.startup_dirty_ = false;
+    for (uint8_t i = 0; i < COUNT; i++) {
+        // Mid-transition values are not worth a flash write: keep the target
+        snapshot[i] = (self.transitioning_ & BIT(i)) ? self.transitions_[i].to : self.attrs_[i];
+        startup[i] = self.startup_[i];
+    }
+    k_spin_unlock(&self.lock_, key);
+
+    if (startup_dirty) {
+        int ret = settings_save_one(LIGHT_KEY_ROOT "/" LIGHT_STARTUP_KEY, startup, sizeof(startup));
+        if (ret < 0) {
+            LOG_WRN("Failed to save startup behavior: %d", ret);
+        }
+    }
+
+    for (uint8_t i = 0; i < COUNT; i++) {
+        if (!(dirty & BIT(i))) {
+            continue;
+        }
+
+        char name[24];
+        snprintf(name, sizeof(name), LIGHT_KEY_ROOT "/%u", LIGHT_ENDPOINTS[i].endpoint_id);
+        int ret = settings_save_one(name, &snapshot[i], sizeof(snapshot[i]));
+        if (ret < 0) {
+            LOG_WRN("Failed to save endpoint %u: %d", LIGHT_ENDPOINTS[i].endpoint_id, ret);
+        }
+    }
+}
+
+void LightEndpoints::flush() {
+    k_work_cancel_delayable(&persist_work_);
+    persistWorkHandler(nullptr);
+}
+
+void LightEndpoints::erase() {
+    k_work_cancel_delayable(&persist_work_);
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    dirty_ = 0;
+    startup_dirty_ = false;
+    k_spin_unlock(&lock_, key);
+
+    for (const LightEndpointInfo& info : LIGHT_ENDPOINTS) {
+        char name[24];
+        snprintf(name, sizeof(name), LIGHT_KEY_ROOT "/%u", info.endpoint_id);
+        settings_delete(name);
+    }
+    settings_delete(LIGHT_KEY_ROOT "/" LIGHT_STARTUP_KEY);
+}
+
+/*=============================================================================
+ * Attributes
+ *===========================================================================*/
+
+void LightEndpoints::setOutput(OutputCallback output) {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    output_ = output;
+    if (output_) {
+        output_(shown_, ALL);
+        if (startup_us_ == 0) {
+            startup_us_ = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+        }
+    }
+    k_spin_unlock(&lock_, key);
+}
+
+void LightEndpoints::setAnimator(Animator animator) {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    animator_ = animator;
+    k_spin_unlock(&lock_, key);
+}
+
+void LightEndpoints::showFrames(uint32_t mask, const LightAttributes* frames) {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    mask &= ALL;
+    for (uint8_t i = 0; i < COUNT; i++) {
+        if (mask & BIT(i)) {
+            shown_[i] = frames[i];
+        }
+    }
+    effects_ |= mask;
+    fresh_ |= mask;
+    if (output_ && mask) {
+        output_(shown_, mask);
+    }
+    startTick();
+    k_spin_unlock(&lock_, key);
+}
+
+void LightEndpoints::startTick() {
+    // Stopped by onTick() under the same lock: a request is never lost
+    TimerService& timers = TimerService::getInstance();
+    if (!timers.isRunning(tick_)) {
+        timers.start(tick_, LIGHT_TRANSITION_TICK_MS, LIGHT_TRANSITION_TICK_MS);
+    }
+}
+
+void LightEndpoints::changed(uint32_t mask) {
+    // LEDs under an effect pick the new attributes up when it ends
+    uint32_t drive = mask & ~effects_;
+    for (uint8_t i = 0; i < COUNT; i++) {
+        if (drive & BIT(i)) {
+            shown_[i] = attrs_[i];
+        }
+    }
+    if (output_ && drive) {
+        output_(shown_, drive);
+    }
+    record(mask);
+}
+
+void LightEndpoints::record(uint32_t mask) {
+    for (uint8_t i = 0; i < COUNT; i++) {
+        if (mask & BIT(i)) {
+            reportAttributes(i, attrs_[i]);
+        }
+    }
+
+    // Bounded delay: a burst of changes does not push the write back
+    dirty_ |= mask;
+    k_work_schedule(&persist_work_, K_MSEC(LIGHT_PERSIST_DELAY_MS));
+}
+
+int LightEndpoints::applyCommand(LightAttributes& attrs, const ClusterCommand& cmd) {
+    int ret = 0;
+
+    switch (cmd.cluster_id) {
+        case ON_OFF_CLUSTER_ID:
+            switch (cmd.command_id) {
+                case LightCommand::OFF:    attrs.on_off = 0; break;
+                case LightCommand::ON:     attrs.on_off = 1; break;
+                case LightCommand::TOGGLE: attrs.on_off = !attrs.on_off; break;
+                default:                   ret = -ENOTSUP; break;
+            }
+            break;
+
+        case COLOR_CONTROL_CLUSTER_ID:
+            if (cmd.command_id != LightCommand::MOVE_TO_COLOR_TEMPERATURE) {
+                ret = -ENOTSUP;
+                break;
+            }
+            attrs.color_temp_mireds = CLAMP(cmd.color_temp_mireds,
+                                            COLOR_TEMP_MIN_MIREDS, COLOR_TEMP_MAX_MIREDS);
+            break;
+
+        case LEVEL_CONTROL_CLUSTER_ID:
+            if (cmd.command_id != LightCommand::MOVE_TO_LEVEL &&
+                cmd.command_id != LightCommand::MOVE_TO_LEVEL_WITH_ON_OFF) {
+                ret = -ENOTSUP;
+                break;
+            }
+            if (cmd.level > LightEndpointTemplate::MAX_LEVEL) {
+                ret = -EINVAL;
+                break;
+            }
+            // WithOnOff: level 0 turns the light off, any other level on
+            if (cmd.command_id == LightCommand::MOVE_TO_LEVEL_WITH_ON_OFF) {
+                attrs.on_off = cmd.level > 0;
+            }
+            attrs.current_level = MAX(cmd.level, LightEndpointTemplate::MIN_LEVEL);
+            break;
+
+        default:
+            ret = -ENOTSUP;
+            break;
+    }
+
+    return ret;
+}
+
+int LightEndpoints::dispatch(const ClusterCommand& cmd) {
+    uint8_t index = indexOf(cmd.endpoint_id);
+    if (index >= COUNT) {
+        return -ENOENT;
+    }
+    return dispatchMask(BIT(index), cmd);
+}
+
+int LightEndpoints::dispatchMask(uint32_t endpoint_mask, const ClusterCommand& cmd) {
+    // Errors depend on the command only: check before touching anything
+    LightAttributes probe = LightEndpointTemplate::DEFAULTS;
+    int ret = applyCommand(probe, cmd);
+    if (ret < 0) {
+        return ret;
+    }
+
+    uint32_t changed_mask = 0;
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    for (uint8_t i = 0; i < COUNT; i++) {
+        if (!(endpoint_mask & BIT(i))) {
+            continue;
+        }
+        // Relative commands (Toggle) act on where a transition is heading
+        LightAttributes target = (transitioning_ & BIT(i)) ? transitions_[i].to : attrs_[i];
+        applyCommand(target, cmd);
+        if (moveTo(i, target, cmd.transition_time)) {
+            changed_mask |= BIT(i);
+        }
+    }
+    if (changed_mask) {
+        changed(changed_mask);
+    }
+    if (transitioning_) {
+        startTick();
+    }
+    k_spin_unlock(&lock_, key);
+
     return 0;
 }
 
-void LightEndpoint::setLightState(bool on)
+bool LightEndpoints::moveTo(uint8_t index, const LightAttributes& target, uint16_t transition_time) {
+    LightAttributes& current = attrs_[index];
+    uint32_t ticks = (uint32_t)transition_time * 100 / LIGHT_TRANSITION_TICK_MS;
+
+    if (ticks <= 1 || memcmp(&current, &target, sizeof(target)) == 0) {
+        transitioning_ &= ~BIT(index);
+        if (memcmp(&current, &target, sizeof(target)) == 0) {
+            return false;
+        }
+        current = target;
+        return true;
+    }
+
+    Transition& t = transitions_[index];
+    t.from = current;
+    t.to = target;
+    t.ticks = (uint16_t)MIN(ticks, UINT16_MAX);
+    t.elapsed = 0;
+    transitioning_ |= BIT(index);
+
+    // Turning on fades up from the minimum level; turning off stays on
+    // until the level is down
+    if (!current.on_off && target.on_off) {
+        t.from.current_level = LightEndpointTemplate::MIN_LEVEL;
+        current.on_off = 1;
+        current.current_level = LightEndpointTemplate::MIN_LEVEL;
+        return true;
+    }
+    return false;
+}
+
+void LightEndpoints::onTick(WheelTimer& timer, void* user_data) {
+    LightEndpoints& self = getInstance();
+    LightAttributes frames[COUNT];
+    uint32_t changed_mask = 0;
+    uint32_t shown_mask = 0;
+
+    // Frames first, outside the lock: the animator takes its own
+    Animator animator = self.animator_;
+    uint32_t effects = animator ? (animator(frames) & ALL) : 0;
+
+    k_spinlock_key_t key = k_spin_lock(&self.lock_);
+    for (uint8_t i = 0; i < COUNT; i++) {
+        if (!(self.transitioning_ & BIT(i))) {
+            continue;
+        }
+
+        Transition& t = self.transitions_[i];
+        LightAttributes next = t.to;
+        if (++t.elapsed < t.ticks) {
+            next.on_off = t.from.on_off | t.to.on_off;
+            next.current_level = (uint8_t)(t.from.current_level +
+                ((int32_t)t.to.current_level - t.from.current_level) * t.elapsed / t.ticks);
+            next.color_temp_mireds = (uint16_t)(t.from.color_temp_mireds +
+                ((int32_t)t.to.color_temp_mireds - t.from.color_temp_mireds) * t.elapsed / t.ticks);
+        } else {
+            self.transitioning_ &= ~BIT(i);
+        }
+
+        if (memcmp(&next, &self.attrs_[i], sizeof(next)) != 0) {
+            self.attrs_[i] = next;
+            changed_mask |= BIT(i);
+        }
+    }
+
+    // Started after the animator ran: keep the first frame until next tick
+    uint32_t fresh = self.fresh_ & ~effects;
+    uint32_t ended = self.effects_ & ~(effects | fresh);
+    self.effects_ = effects | fresh;
+    self.fresh_ = 0;
+
+    // Effect frames, attributes back where an effect ended, moved attributes
+    for (uint8_t i = 0; i < COUNT; i++) {
+        const LightAttributes* shown = (effects & BIT(i)) ? &frames[i]
+                                     : (fresh & BIT(i)) ? nullptr
+                                     : ((ended | changed_mask) & BIT(i)) ? &self.attrs_[i]
+                                     : nullptr;
+        if (shown && memcmp(shown, &self.shown_[i], sizeof(*shown)) != 0) {
+            self.shown_[i] = *shown;
+            shown_mask |= BIT(i);
+        }
+    }
+
+    // Every endpoint that moved on this tick, in one output update
+    if (self.output_ && shown_mask) {
+        self.output_(self.shown_, shown_mask);
+    }
+    if (changed_mask) {
+        self.record(changed_mask);
+    }
+    if (!self.transitioning_ && !self.effects_) {
+        TimerService::getInstance().stop(timer);
+    }
+    k_spin_unlock(&self.lock_, key);
+}
+
+void LightEndpoints::applyAttributes(uint32_t endpoint_mask, const LightAttributes* values) {
+    uint32_t changed_mask = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    transitioning_ &= ~endpoint_mask;
+    for (uint8_t i = 0; i < COUNT; i++) {
+        if ((endpoint_mask & BIT(i)) && memcmp(&attrs_[i], &values[i], sizeof(values[i])) != 0) {
+            attrs_[i] = values[i];
+            changed_mask |= BIT(i);
+        }
+    }
+    if (changed_mask) {
+        changed(changed_mask);
+    }
+    k_spin_unlock(&lock_, key);
+}
+
+int LightEndpoints::setLightState(uint16_t endpoint_id, bool on)
 {
-    if (mLightOn == on) {
-        return;  // No change
-    }
-    
-    mLightOn = on;
-    LOG_INF("Light state changed: %s", on ? "ON" : "OFF");
-    
-    // Save to NVS
-    // nvs_handle_t nvs;
-    // if (nvs_open("matter", NVS_READWRITE, &nvs) == 0) {
-    //     nvs_set_u8(nvs, "light_on", on ? 1 : 0);
-    //     nvs_commit(nvs);
-    //     nvs_close(nvs);
-    // }
-    
-    updateAttributes();
-}
-
-void LightEndpoint::setBrightness(uint8_t brightness)
+    ClusterCommand cmd = { endpoint_id, ON_OFF_CLUSTER_ID,
+                           on ? LightCommand::ON : LightCommand::OFF, 0 };
+    return dispatch(cmd);
+}
+
+int LightEndpoints::toggle(uint16_t endpoint_id)
 {
-    if (brightness > 254) {
-        brightness = 254;
-    }
-    
-    if (mBrightness == brightness) {
-        return;  // No change
-    }
-    
-    mBrightness = brightness;
-    LOG_INF("Brightness set to: %d", brightness);
-    
-    // Save to NVS
-    // nvs_handle_t nvs;
-    // if (nvs_open("matter", NVS_READWRITE, &nvs) == 0) {
-    //     nvs_set_u8(nvs, "light_level", brightness);
-    //     nvs_commit(nvs);
-    //     nvs_close(nvs);
-    // }
-    
-    updateAttributes();
-}
-
-void LightEndpoint::updateAttributes()
+    ClusterCommand cmd = { endpoint_id, ON_OFF_CLUSTER_ID, LightCommand::TOGGLE, 0 };
+    return dispatch(cmd);
+}
+
+int LightEndpoints::setBrightness(uint16_t endpoint_id, uint8_t brightness)
+{
+    ClusterCommand cmd = { endpoint_id, LEVEL_CONTROL_CLUSTER_ID, LightCommand::MOVE_TO_LEVEL,
+                           MIN(brightness, LightEndpointTemplate::MAX_LEVEL) };
+    return dispatch(cmd);
+}
+
+int LightEndpoints::setColorTemperature(uint16_t endpoint_id, uint16_t mireds, uint16_t transition_time)
+{
+    ClusterCommand cmd = { endpoint_id, COLOR_CONTROL_CLUSTER_ID,
+                           LightCommand::MOVE_TO_COLOR_TEMPERATURE, 0, 0, 0, mireds, transition_time };
+    return dispatch(cmd);
+}
+
+bool LightEndpoints::inTransition(uint16_t endpoint_id) const {
+    uint8_t index = indexOf(endpoint_id);
+    if (index >= COUNT) {
+        return false;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    bool active = transitioning_ & BIT(index);
+    k_spin_unlock(&lock_, key);
+    return active;
+}
+
+int LightEndpoints::setStartUp(uint16_t endpoint_id, const LightStartUp& startup) {
+    uint8_t index = indexOf(endpoint_id);
+    if (index >= COUNT) {
+        return -ENOENT;
+    }
+    if (!LightEndpointTemplate::isValid(startup)) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    if (memcmp(&startup_[index], &startup, sizeof(startup)) != 0) {
+        startup_[index] = startup;
+        startup_dirty_ = true;
+        k_work_schedule(&persist_work_, K_MSEC(LIGHT_PERSIST_DELAY_MS));
+    }
+    k_spin_unlock(&lock_, key);
+    return 0;
+}
+
+bool LightEndpoints::getStartUp(uint16_t endpoint_id, LightStartUp& out) const {
+    uint8_t index = indexOf(endpoint_id);
+    if (index >= COUNT) {
+        return false;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    out = startup_[index];
+    k_spin_unlock(&lock_, key);
+    return true;
+}
+
+bool LightEndpoints::getAttributes(uint16_t endpoint_id, LightAttributes& out) const {
+    uint8_t index = indexOf(endpoint_id);
+    if (index >= COUNT) {
+        return false;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    out = attrs_[index];
+    k_spin_unlock(&lock_, key);
+    return true;
+}
+
+void LightEndpoints::reportAttributes(uint8_t index, const LightAttributes& attrs)
 {
     /* TODO: Send attribute reports to Matter controller */
-    LOG_DBG("Updating Matter attributes - On: %d, Brightness: %d", mLightOn, mBrightness);
+    LOG_DBG("Endpoint %u attributes - On: %d, Brightness: %d, %u mireds",
+            LIGHT_ENDPOINTS[index].endpoint_id, attrs.on_off, attrs.current_level,
+            attrs.color_temp_mireds);
 }
 
 }  // namespace matter
 }  // namespace protocol
 }  // namespace smarthome
+
+/*=============================================================================
+ * Shell Commands
+ *===========================================================================*/
+
+#ifdef CONFIG_SHELL
+using smarthome::protocol::matter::ChannelDuty;
+using smarthome::protocol::matter::ClusterCommand;
+using smarthome::protocol::matter::LightAttributes;
+using smarthome::protocol::matter::LightEndpoints;
+using smarthome::protocol::matter::LightEndpointTemplate;
+using smarthome::protocol::matter::LightStartUp;
+using smarthome::protocol::matter::LIGHT_ENDPOINTS;
+namespace LightCommand = smarthome::protocol::matter::LightCommand;
+
+static int cmd_light_list(const struct shell* sh, size_t argc, char** argv) {
+    for (const auto& info : LIGHT_ENDPOINTS) {
+        LightAttributes attrs;
+        LightEndpoints::getInstance().getAttributes(info.endpoint_id, attrs);
+        ChannelDuty duty = smarthome::protocol::matter::ColorTemperature::mix(attrs);
+        shell_print(sh, "ep %u (LED%u): %s, level %u, %u mireds (warm %u, cool %u /65535)%s",
+                    info.endpoint_id, info.led, attrs.on_off ? "on" : "off",
+                    attrs.current_level, attrs.color_temp_mireds, duty.warm, duty.cool,
+                    LightEndpoints::getInstance().inTransition(info.endpoint_id) ? ", moving" : "");
+    }
+    shell_print(sh, "Restored state shown %u us after kernel start",
+                LightEndpoints::getInstance().getStartupTimeUs());
+    return 0;
+}
+
+static int cmd_light_onoff(const struct shell* sh, size_t argc, char** argv) {
+    ClusterCommand cmd = { (uint16_t)atoi(argv[1]), smarthome::protocol::matter::ON_OFF_CLUSTER_ID, 0, 0 };
+
+    if (strcmp(argv[2], "on") == 0) {
+        cmd.command_id = LightCommand::ON;
+    } else if (strcmp(argv[2], "off") == 0) {
+        cmd.command_id = LightCommand::OFF;
+    } else if (strcmp(argv[2], "toggle") == 0) {
+        cmd.command_id = LightCommand::TOGGLE;
+    } else {
+        shell_error(sh, "Expected on, off or toggle");
+        return -EINVAL;
+    }
+
+    int ret = LightEndpoints::getInstance().dispatch(cmd);
+    if (ret < 0) {
+        shell_error(sh, "Endpoint %u: %d", cmd.endpoint_id, ret);
+    }
+    return ret;
+}
+
+static int cmd_light_level(const struct shell* sh, size_t argc, char** argv) {
+    ClusterCommand cmd = { (uint16_t)atoi(argv[1]), smarthome::protocol::matter::LEVEL_CONTROL_CLUSTER_ID,
+                           LightCommand::MOVE_TO_LEVEL_WITH_ON_OFF, (uint8_t)atoi(argv[2]) };
+    cmd.transition_time = (argc > 3) ? (uint16_t)atoi(argv[3]) : 0;
+
+    int ret = LightEndpoints::getInstance().dispatch(cmd);
+    if (ret < 0) {
+        shell_error(sh, "Endpoint %u: %d", cmd.endpoint_id, ret);
+    }
+    return ret;
+}
+
+static int cmd_light_ct(const struct shell* sh, size_t argc, char** argv) {
+    uint16_t endpoint_id = (uint16_t)atoi(argv[1]);
+    uint16_t transition_time = (argc > 3) ? (uint16_t)atoi(argv[3]) : 0;
+
+    int ret = LightEndpoints::getInstance().setColorTemperature(endpoint_id, (uint16_t)atoi(argv[2]),
+                                                                transition_time);
+    if (ret < 0) {
+        shell_error(sh, "Endpoint %u: %d", endpoint_id, ret);
+    }
+    return ret;
+}
+
+static int cmd_light_startup(const struct shell* sh, size_t argc, char** argv) {
+    static const char* const on_off_names[] = { "off", "on", "toggle" };
+    uint16_t endpoint_id = (uint16_t)atoi(argv[1]);
+    LightStartUp startup;
+
+    if (!LightEndpoints::getInstance().getStartUp(endpoint_id, startup)) {
+        shell_error(sh, "Endpoint %u: %d", endpoint_id, -ENOENT);
+        return -ENOENT;
+    }
+
+    if (argc > 2) {
+        startup.on_off = smarthome::protocol::matter::StartUpOnOff::PREVIOUS;
+        for (uint8_t i = 0; i < ARRAY_SIZE(on_off_names); i++) {
+            if (strcmp(argv[2], on_off_names[i]) == 0) {
+                startup.on_off = i;
+            }
+        }
+        startup.current_level = (argc > 3 && strcmp(argv[3], "previous") != 0)
+                                ? (uint8_t)atoi(argv[3])
+                                : LightEndpointTemplate::STARTUP_PREVIOUS;
+
+        int ret = LightEndpoints::getInstance().setStartUp(endpoint_id, startup);
+        if (ret < 0) {
+            shell_error(sh, "Endpoint %u: %d", endpoint_id, ret);
+            return ret;
+        }
+    }
+
+    char level[12] = "previous";
+    if (startup.current_level != LightEndpointTemplate::STARTUP_PREVIOUS) {
+        snprintf(level, sizeof(level), "%u", startup.current_level);
+    }
+    shell_print(sh, "ep %u: StartUpOnOff %s, StartUpCurrentLevel %s", endpoint_id,
+                startup.on_off < ARRAY_SIZE(on_off_names) ? on_off_names[startup.on_off] : "previous",
+                level);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_light,
+    SHELL_CMD(list, NULL, "Attributes of every light endpoint", cmd_light_list),
+    SHELL_CMD_ARG(onoff, NULL, "OnOff command: <endpoint> on|off|toggle", cmd_light_onoff, 3, 0),
+    SHELL_CMD_ARG(level, NULL, "MoveToLevelWithOnOff: <endpoint> <0-254> [tenths]", cmd_light_level, 3, 1),
+    SHELL_CMD_ARG(ct, NULL, "MoveToColorTemperature: <endpoint> <153-500 mireds> [tenths]",
+                  cmd_light_ct, 3, 1),
+    SHELL_CMD_ARG(startup, NULL, "StartUp behavior: <endpoint> [off|on|toggle|previous [level|previous]]",
+                  cmd_light_startup, 2, 2),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(light, &sub_light, "Light endpoints", NULL);
+#endif
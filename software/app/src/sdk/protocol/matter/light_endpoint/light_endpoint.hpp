@@ -3,104 +3,466 @@
  * SPDX-License-Identifier: Apache-2.0
  *
  * ============================================================================
- * MATTER LIGHT ENDPOINT - Cluster Attributes & State Machine
+ * MATTER LIGHT ENDPOINTS - Cluster Attributes & State Machine
  * ============================================================================
  *
  * Purpose:
- *   Implements Matter Light Device clusters (OnOff, Level Control)
- *   Manages attribute state and reflects changes to physical hardware
- *   Handles both local (button) and remote (Matter) control
+ *   Implements Matter Light Device clusters (OnOff, Level Control, Color
+ *   Control in color temperature mode) on one endpoint per LED. Manages attribute state and reflects changes to
+ *   physical hardware. Handles both local (button) and remote (Matter)
+ *   control.
  *
  * Matter Clusters:
- *   - OnOff (0x0006):       on/off attribute, on/off command
- *   - Level Control (0x0008): currentLevel attribute (0-254)
+ *   - OnOff (0x0006):       on/off attribute, Off/On/Toggle commands
+ *   - Level Control (0x0008): currentLevel attribute (1-254),
+ *                             MoveToLevel[WithOnOff] commands
+ *   - Color Control (0x0300): colorTemperatureMireds attribute (153-500),
+ *                             MoveToColorTemperature command
+ *
+ * Transitions & Effects:
+ *   A command with a transition time moves CurrentLevel and the color
+ *   temperature together, in integer steps every LIGHT_TRANSITION_TICK_MS
+ *   from one WheelTimer on the TimerService. The same tick asks the
+ *   animator (LightEffects) for the frames of the endpoints under an
+ *   effect: those LEDs show the frame instead of their attributes until
+ *   the effect ends. Every endpoint in transition or effect is stepped
+ *   on the same tick and driven in one output update; the timer stops
+ *   when nothing moves. The channel duties of a step come from the tables
+ *   in color_temperature.hpp.
+ *
+ * Endpoints:
+ *   Every light endpoint is an instance of one template (device type and
+ *   cluster list). The instances are generated at compile time:
+ *   LIGHT_ENDPOINT_COUNT endpoints with consecutive IDs starting at
+ *   LIGHT_ENDPOINT_ID, endpoint n driving LED n - LIGHT_ENDPOINT_ID.
+ *   Attributes of all endpoints sit in one contiguous array indexed by
+ *   endpoint ID - LIGHT_ENDPOINT_ID, so routing a command is a subtraction
+ *   and a bounds check.
+ *
+ * Persistence:
+ *   One 4-byte record per endpoint under "matter/light/<endpoint>" and the
+ *   StartUpOnOff / StartUpCurrentLevel of every endpoint under
+ *   "matter/light/startup", all read in one settings pass at init.
+ *   Changes are written from the system work queue LIGHT_PERSIST_DELAY_MS
+ *   later, one write per changed endpoint however often it toggled in
+ *   between. An endpoint in transition persists its target.
+ *
+ * Startup:
+ *   init() applies the StartUp attributes to the restored values (off,
+ *   on, toggle or previous; a fixed level or the previous one) before the
+ *   first output, so the LEDs come up in their final state without
+ *   waiting for IPC or Matter. The time from kernel start to that first
+ *   output is kept for `light list`.
  *
  * State Synchronization:
  *   Button/App -> Matter Attributes -> Matter Controllers
  *   (GPIO change) (onOff, level)    (Google Home, etc)
  *
  * Thread Safety:
- *   - All state changes are atomic
- *   - Safe for concurrent button + Matter commands
+ *   - Attributes are guarded by a spinlock
+ *   - Safe from the button ISR and concurrent Matter commands
  */
 
 #pragma once
 
+#include <zephyr/kernel.h>
+#include <cstddef>
 #include <stdint.h>
 #include <string.h>
+#include "../commission/chip_config.hpp"
+#include "const_table.hpp"
+#include "timer/timer_wheel.hpp"
 
 namespace smarthome { namespace protocol { namespace matter {
 
-class LightEndpoint {
+/**
+ * Cluster commands the light endpoints accept
+ */
+namespace LightCommand {
+    // OnOff cluster
+    constexpr uint8_t OFF = 0x00;
+    constexpr uint8_t ON = 0x01;
+    constexpr uint8_t TOGGLE = 0x02;
+
+    // Level Control cluster
+    constexpr uint8_t MOVE_TO_LEVEL = 0x00;
+    constexpr uint8_t MOVE_TO_LEVEL_WITH_ON_OFF = 0x04;
+
+    // Color Control cluster
+    constexpr uint8_t MOVE_TO_COLOR_TEMPERATURE = 0x0A;
+
+    // Scenes cluster (handled by LightGroups)
+    constexpr uint8_t RECALL_SCENE = 0x05;
+}
+
+/**
+ * Attributes of one light endpoint (contiguous per endpoint, persisted)
+ */
+struct LightAttributes {
+    uint8_t on_off;                     ///< OnOff cluster, 0/1
+    uint8_t current_level;              ///< Level Control, 1..254
+    uint16_t color_temp_mireds;         ///< Color Control, COLOR_TEMP_MIN..MAX_MIREDS
+};
+
+static_assert(sizeof(LightAttributes) == 4, "LightAttributes is persisted");
+
+/**
+ * StartUpOnOff (OnOff 0x4003) values
+ */
+namespace StartUpOnOff {
+    constexpr uint8_t OFF = 0x00;
+    constexpr uint8_t ON = 0x01;
+    constexpr uint8_t TOGGLE = 0x02;
+    constexpr uint8_t PREVIOUS = 0xFF;          ///< null: keep the persisted value
+}
+
+/**
+ * Startup behavior of one endpoint (persisted with the attributes)
+ */
+struct LightStartUp {
+    uint8_t on_off;                     ///< StartUpOnOff
+    uint8_t current_level;              ///< StartUpCurrentLevel: 0 = minimum, 1..254, 0xFF = previous
+};
+
+/**
+ * Cluster command routed to an endpoint
+ */
+struct ClusterCommand {
+    uint16_t endpoint_id;
+    uint16_t cluster_id;
+    uint8_t command_id;
+    uint8_t level;                      ///< MoveToLevel* argument
+    uint16_t group_id;                  ///< RecallScene arguments
+    uint8_t scene_id;
+    uint16_t color_temp_mireds;         ///< MoveToColorTemperature argument
+    uint16_t transition_time;           ///< Tenths of a second, 0 = at once
+};
+
+/**
+ * One instance of the light endpoint template
+ */
+struct LightEndpointInfo {
+    uint16_t endpoint_id;
+    uint8_t led;                        ///< LED index driven by the endpoint
+};
+
+/**
+ * Light endpoint template: what every instance exposes
+ */
+struct LightEndpointTemplate {
+    static constexpr uint16_t DEVICE_TYPE = 0x010C;     ///< Color Temperature Light
+    static constexpr uint16_t CLUSTERS[] = { IDENTIFY_CLUSTER_ID, GROUPS_CLUSTER_ID,
+                                             SCENES_CLUSTER_ID, ON_OFF_CLUSTER_ID,
+                                             LEVEL_CONTROL_CLUSTER_ID, COLOR_CONTROL_CLUSTER_ID };
+    static constexpr uint8_t MIN_LEVEL = 1;
+    static constexpr uint8_t MAX_LEVEL = 254;
+    static constexpr LightAttributes DEFAULTS = { 0, MAX_LEVEL, COLOR_TEMP_DEFAULT_MIREDS };
+    static constexpr uint8_t STARTUP_PREVIOUS = 0xFF;
+    static constexpr LightStartUp STARTUP_DEFAULTS = { StartUpOnOff::PREVIOUS, STARTUP_PREVIOUS };
+
+    /// Attributes within range (restored from storage)
+    static constexpr bool isValid(const LightAttributes& attrs) {
+        return attrs.on_off <= 1 &&
+               attrs.current_level >= MIN_LEVEL && attrs.current_level <= MAX_LEVEL &&
+               attrs.color_temp_mireds >= COLOR_TEMP_MIN_MIREDS &&
+               attrs.color_temp_mireds <= COLOR_TEMP_MAX_MIREDS;
+    }
+
+    /// StartUp attributes within range
+    static constexpr bool isValid(const LightStartUp& startup) {
+        return (startup.on_off <= StartUpOnOff::TOGGLE || startup.on_off == StartUpOnOff::PREVIOUS) &&
+               (startup.current_level <= MAX_LEVEL || startup.current_level == STARTUP_PREVIOUS);
+    }
+
+    /// Attributes an endpoint boots with, from the persisted ones
+    static constexpr LightAttributes startUp(LightAttributes attrs, const LightStartUp& startup) {
+        if (startup.on_off == StartUpOnOff::TOGGLE) {
+            attrs.on_off = !attrs.on_off;
+        } else if (startup.on_off != StartUpOnOff::PREVIOUS) {
+            attrs.on_off = startup.on_off;
+        }
+        if (startup.current_level != STARTUP_PREVIOUS) {
+            attrs.current_level = startup.current_level < MIN_LEVEL ? MIN_LEVEL : startup.current_level;
+        }
+        return attrs;
+    }
+};
+
+namespace detail {
+constexpr ConstTable<LightEndpointInfo, LIGHT_ENDPOINT_COUNT> makeLightEndpoints() {
+    ConstTable<LightEndpointInfo, LIGHT_ENDPOINT_COUNT> table{};
+    for (uint8_t i = 0; i < LIGHT_ENDPOINT_COUNT; i++) {
+        table[i] = { static_cast<uint16_t>(LIGHT_ENDPOINT_ID + i), i };
+    }
+    return table;
+}
+}  // namespace detail
+
+/// Every light endpoint, fixed at compile time
+inline constexpr auto LIGHT_ENDPOINTS = detail::makeLightEndpoints();
+
+static_assert(LIGHT_ENDPOINTS[LIGHT_ENDPOINT_COUNT - 1].endpoint_id ==
+              LIGHT_ENDPOINT_ID + LIGHT_ENDPOINT_COUNT - 1, "endpoint IDs are consecutive");
+
+class LightEndpoints {
 public:
+    static constexpr uint8_t COUNT = LIGHT_ENDPOINT_COUNT;
+
+    static constexpr uint32_t ALL = (COUNT == 32) ? UINT32_MAX : (1UL << COUNT) - 1;
+
+    /**
+     * Drives the hardware: every LED of changed_mask in one update
+     *
+     * @param attrs What every LED shows, LED n at index n: the attributes
+     *        of the endpoint, or the effect frame while an effect runs
+     * @param changed_mask Bit per endpoint index to update
+     * @note May be called from ISR context (button presses)
+     */
+    using OutputCallback = void (*)(const LightAttributes* attrs, uint32_t changed_mask);
+
+    /**
+     * Supplies effect frames, once per tick (work queue context)
+     *
+     * @param frames Filled for the endpoints under an effect
+     * @return Bit per endpoint index under an effect, 0 when none is left
+     */
+    using Animator = uint32_t (*)(LightAttributes* frames);
+
     /// Get singleton instance
-    static LightEndpoint& getInstance() {
-        static LightEndpoint instance;
-        return instance;
-    }
-    
+    static LightEndpoints& getInstance();
+
     // Prevent copying
-    LightEndpoint(const LightEndpoint&) = delete;
-    LightEndpoint& operator=(const LightEndpoint&) = delete;
-    
+    LightEndpoints(const LightEndpoints&) = delete;
+    LightEndpoints& operator=(const LightEndpoints&) = delete;
+
     /**
-     * Initialize Matter light endpoint
-     * 
-     * Registers clusters and sets initial attribute values
-     * @return 0 on success, negative error code on failure
+     * Initialize the light endpoints
+     *
+     * Loads the persisted attributes and StartUp attributes of every
+     * endpoint in one settings pass (defaults for endpoints never saved),
+     * applies the startup behavior and drives the outputs. Runs at boot,
+     * before IPC and Matter.
+     * @return Number of endpoints restored from storage, negative error
+     *         code on failure
      */
     int init();
-    
+
+    /**
+     * Set the hardware output, called for every endpoint right away
+     *
+     * @param output nullptr = attributes only
+     */
+    void setOutput(OutputCallback output);
+
+    /**
+     * Set the effect source asked for frames on every tick
+     */
+    void setAnimator(Animator animator);
+
+    /**
+     * Start effects: the endpoints of mask show their first frame now and
+     * the animator's frames on every tick until it drops them. The tick
+     * stops by itself once no transition or effect is left. ISR-safe.
+     *
+     * @param frames First frame, indexed by endpoint index
+     */
+    void showFrames(uint32_t mask, const LightAttributes* frames);
+
+    /**
+     * Route a cluster command to its endpoint
+     *
+     * A command with a transition time starts a transition from the
+     * current attributes; one without stops any transition in progress.
+     *
+     * @return 0 on success, -ENOENT for an unknown endpoint (UNSUPPORTED_ENDPOINT),
+     *         -ENOTSUP for an unknown cluster or command, -EINVAL for a bad level
+     */
+    int dispatch(const ClusterCommand& cmd);
+
+    /**
+     * Apply one command to several endpoints (group fan-out)
+     *
+     * All endpoints change together, with one output update.
+     *
+     * @param endpoint_mask Bit per endpoint index; cmd.endpoint_id is ignored
+     * @return 0 on success, -ENOTSUP / -EINVAL as dispatch() (nothing applied)
+     */
+    int dispatchMask(uint32_t endpoint_mask, const ClusterCommand& cmd);
+
+    /**
+     * Set the attributes of several endpoints at once (scene recall),
+     * stopping their transitions
+     *
+     * @param endpoint_mask Bit per endpoint index to set
+     * @param values Attributes indexed by endpoint index; only masked
+     *        entries are read
+     */
+    void applyAttributes(uint32_t endpoint_mask, const LightAttributes* values);
+
     /**
      * Set light power state
-     * 
+     *
+     * @param endpoint_id Light endpoint
      * @param on true = on, false = off
-     * Synchronizes Matter OnOff cluster attribute
-     * Updates physical LED immediately
+     * @return 0 on success, -ENOENT for an unknown endpoint
      */
-    void setLightState(bool on);
-    
+    int setLightState(uint16_t endpoint_id, bool on);
+
     /**
-     * Get current light power state
-     * @return true if light is on, false if off
+     * Toggle light power state
+     *
+     * @return 0 on success, -ENOENT for an unknown endpoint
      */
-    bool getLightState() const { return mLightOn; }
-    
+    int toggle(uint16_t endpoint_id);
+
     /**
-     * Set brightness level (0-254)
-     * 
-     * @param brightness 0 = off, 254 = full brightness
-     * Maps to Matter Level Control cluster currentLevel
-     * Triggers PWM update on LED pin
+     * Set brightness level (1-254, clamped)
+     *
+     * @return 0 on success, -ENOENT for an unknown endpoint
      */
-    void setBrightness(uint8_t brightness);
-    
+    int setBrightness(uint16_t endpoint_id, uint8_t brightness);
+
     /**
-     * Get current brightness level
-     * @return brightness 0-254
+     * Move to a color temperature (mireds, clamped to the supported range)
+     *
+     * @param transition_time Tenths of a second, 0 = at once
+     * @return 0 on success, -ENOENT for an unknown endpoint
      */
-    uint8_t getBrightness() const { return mBrightness; }
-    
+    int setColorTemperature(uint16_t endpoint_id, uint16_t mireds, uint16_t transition_time = 0);
+
+    /// True while the endpoint is in a transition
+    bool inTransition(uint16_t endpoint_id) const;
+
     /**
-     * Update Matter attributes in fabric
-     * 
-     * Reports current state to all connected Matter controllers
-     * Called after local changes or remote commands
+     * Set StartUpOnOff / StartUpCurrentLevel, applied at the next boot
+     *
+     * @return 0 on success, -ENOENT for an unknown endpoint, -EINVAL for
+     *         a value out of range
+     */
+    int setStartUp(uint16_t endpoint_id, const LightStartUp& startup);
+
+    /**
+     * Copy the StartUp attributes of an endpoint
+     *
+     * @return false for an unknown endpoint
+     */
+    bool getStartUp(uint16_t endpoint_id, LightStartUp& out) const;
+
+    /**
+     * Microseconds from kernel start to the first output of the restored
+     * state, 0 before it
+     */
+    uint32_t getStartupTimeUs() const { return startup_us_; }
+
+    /**
+     * Copy the attributes of an endpoint
+     *
+     * @return false for an unknown endpoint
      */
-    void updateAttributes();
+    bool getAttributes(uint16_t endpoint_id, LightAttributes& out) const;
+
+    /**
+     * Write pending changes now instead of after LIGHT_PERSIST_DELAY_MS
+     * (e.g. before a reboot)
+     */
+    void flush();
+
+    /**
+     * Forget the persisted attributes (factory reset); RAM state is kept
+     * until reboot
+     */
+    void erase();
+
+    /// Attribute slot of an endpoint, COUNT if it is not a light endpoint
+    static constexpr uint8_t indexOf(uint16_t endpoint_id) {
+        return (uint16_t)(endpoint_id - LIGHT_ENDPOINT_ID) < COUNT
+               ? (uint8_t)(endpoint_id - LIGHT_ENDPOINT_ID) : COUNT;
+    }
+
+    /// Endpoint driving an LED
+    static constexpr uint16_t endpointForLed(uint8_t led) {
+        return LIGHT_ENDPOINT_ID + led;
+    }
 
 private:
     /// Private constructor (singleton)
-    LightEndpoint() = default;
-    
+    LightEndpoints();
+
     /// Destructor
-    ~LightEndpoint() = default;
-    
-    // State variables
-    bool mLightOn = false;           ///< OnOff cluster state
-    uint8_t mBrightness = 254;       ///< Level Control (0-254)
+    ~LightEndpoints() = default;
+
+    /**
+     * Transition of one endpoint: attributes interpolated from -> to
+     */
+    struct Transition {
+        LightAttributes from;
+        LightAttributes to;
+        uint16_t ticks;                 ///< Length in LIGHT_TRANSITION_TICK_MS steps
+        uint16_t elapsed;
+    };
+
+    /**
+     * Apply a command to one attribute set
+     *
+     * @return 0, -ENOTSUP or -EINVAL (attrs untouched)
+     */
+    static int applyCommand(LightAttributes& attrs, const ClusterCommand& cmd);
+
+    /**
+     * Set an endpoint to target, directly or through a transition.
+     * Called with the lock held.
+     *
+     * @return true if the current attributes changed
+     */
+    bool moveTo(uint8_t index, const LightAttributes& target, uint16_t transition_time);
+
+    /**
+     * Apply changes to endpoints: drive the outputs, report and schedule
+     * persistence. Called with the lock held.
+     */
+    void changed(uint32_t mask);
+
+    /**
+     * Report and schedule persistence of changed attributes, without
+     * driving the outputs. Called with the lock held.
+     */
+    void record(uint32_t mask);
+
+    /// Start the animation tick if it is not running. Called with the lock held.
+    void startTick();
+
+    /// Step transitions and effects, one output update
+    static void onTick(services::timer::WheelTimer& timer, void* user_data);
+
+    /**
+     * Update Matter attributes in fabric
+     *
+     * Reports current state to all connected Matter controllers
+     */
+    void reportAttributes(uint8_t index, const LightAttributes& attrs);
+
+    static void persistWorkHandler(struct k_work* work);
+
+    // Attributes of every endpoint, indexed by indexOf()
+    LightAttributes attrs_[COUNT];
+    LightAttributes shown_[COUNT];      ///< What the outputs show
+    Transition transitions_[COUNT];
+    uint32_t dirty_;                    ///< Bit per endpoint not yet persisted
+    uint32_t transitioning_;            ///< Bit per endpoint in transition
+    uint32_t effects_;                  ///< Bit per endpoint showing an effect frame
+    uint32_t fresh_;                    ///< Effects started since the last tick
+    LightStartUp startup_[COUNT];
+    bool startup_dirty_;                ///< startup_ not yet persisted
+    uint32_t startup_us_;               ///< First output after boot, us since kernel start
+    OutputCallback output_;
+    Animator animator_;
+    mutable struct k_spinlock lock_;
+    struct k_work_delayable persist_work_;
+    services::timer::WheelTimer tick_;
 };
 
+static_assert(LightEndpoints::COUNT <= 32, "dirty_ has one bit per endpoint");
+
 }  // namespace matter
 }  // namespace protocol
 }  // namespace smarthome
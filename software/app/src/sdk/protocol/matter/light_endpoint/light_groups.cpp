@@ -0,0 +1,621 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Light Groups & Scenes Implementation
+ */
+
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <cstdlib>
+#include "light_groups.hpp"
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+LOG_MODULE_REGISTER(matter_groups, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define GROUPS_KEY "matter/groups"
+#define SCENES_KEY "matter/scenes"
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/* Scene table record: a version byte, then the entries */
+static constexpr uint8_t SCENES_VERSION = 1;
+
+struct SceneRecord {
+    uint8_t version;
+    uint8_t reserved;
+    SceneEntry scenes[LightGroups::SCENE_CAPACITY];
+};
+
+LightGroups& LightGroups::getInstance() {
+    static LightGroups instance;
+    return instance;
+}
+
+LightGroups::LightGroups()
+    : latency_{}
+{
+    memset(groups_, 0, sizeof(groups_));
+    memset(scenes_, FREE, sizeof(scenes_));
+    memset(buckets_, 0, sizeof(buckets_));
+    k_mutex_init(&mutex_);
+    k_work_init(&persist_work_, persistWorkHandler);
+}
+
+/*=============================================================================
+ * Group Index
+ *===========================================================================*/
+
+uint8_t LightGroups::bucketOf(uint16_t group_id) {
+    return (uint8_t)((group_id ^ (group_id >> 4)) & (BUCKETS - 1));
+}
+
+int LightGroups::findGroup(uint16_t group_id) const {
+    // Fewer groups than buckets: an empty bucket always ends the probe
+    for (uint8_t b = bucketOf(group_id); buckets_[b] != 0; b = (b + 1) & (BUCKETS - 1)) {
+        uint8_t slot = buckets_[b] - 1;
+        if (groups_[slot].group_id == group_id) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+void LightGroups::rebuildIndex() {
+    memset(buckets_, 0, sizeof(buckets_));
+    for (uint8_t slot = 0; slot < CAPACITY; slot++) {
+        if (groups_[slot].group_id == 0) {
+            continue;
+        }
+        uint8_t b = bucketOf(groups_[slot].group_id);
+        while (buckets_[b] != 0) {
+            b = (b + 1) & (BUCKETS - 1);
+        }
+        buckets_[b] = slot + 1;
+    }
+}
+
+int LightGroups::findScene(uint8_t endpoint, uint16_t group_id, uint8_t scene_id) const {
+    for (uint8_t i = 0; i < SCENE_CAPACITY; i++) {
+        const SceneEntry& s = scenes_[i];
+        if (s.endpoint == endpoint && s.group_id == group_id && s.scene_id == scene_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void LightGroups::dropScenes(uint8_t endpoint, uint16_t group_id) {
+    for (SceneEntry& s : scenes_) {
+        if (s.endpoint == endpoint && s.group_id == group_id) {
+            memset(&s, FREE, sizeof(s));
+        }
+    }
+}
+
+/*=============================================================================
+ * Persistence
+ *===========================================================================*/
+
+static int blobLoadCb(const char* key, size_t len, settings_read_cb read_cb,
+                      void* cb_arg, void* param) {
+    if (key != nullptr) {
+        return 0;
+    }
+    ssize_t rd = read_cb(cb_arg, param, len);
+    return (rd < 0) ? (int)rd : 0;
+}
+
+/* Stored scene table, FREE entries if none or not of this version */
+static void loadScenes(SceneRecord* record) {
+    ssize_t len = settings_get_val_len(SCENES_KEY);
+    int ret = -ENOENT;
+
+    if (len == sizeof(*record)) {
+        ret = settings_load_subtree_direct(SCENES_KEY, blobLoadCb, record);
+        if (ret < 0) {
+            LOG_WRN("Failed to load scenes: %d", ret);
+        } else if (record->version != SCENES_VERSION) {
+            LOG_WRN("Stored scenes have version %u - discarded", record->version);
+            ret = -EINVAL;
+        }
+    } else if (len > 0) {
+        LOG_WRN("Stored scenes are %d bytes - discarded", (int)len);
+        ret = -EINVAL;
+    }
+
+    if (ret < 0) {
+        memset(record->scenes, LightGroups::FREE, sizeof(record->scenes));
+    }
+}
+
+int LightGroups::init() {
+    static GroupEntry groups[CAPACITY];
+    static SceneRecord scenes;
+
+    memset(groups, 0, sizeof(groups));
+
+    if (settings_get_val_len(GROUPS_KEY) == sizeof(groups) &&
+        settings_load_subtree_direct(GROUPS_KEY, blobLoadCb, groups) < 0) {
+        memset(groups, 0, sizeof(groups));
+    }
+    loadScenes(&scenes);
+
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    // Drop what does not fit this build: members past COUNT, duplicates
+    memset(groups_, 0, sizeof(groups_));
+    memset(buckets_, 0, sizeof(buckets_));
+    for (uint8_t slot = 0; slot < CAPACITY; slot++) {
+        GroupEntry g = groups[slot];
+        g.endpoints &= LightEndpoints::ALL;
+        if (g.group_id == 0 || g.endpoints == 0 || findGroup(g.group_id) >= 0) {
+            continue;
+        }
+        groups_[slot] = g;
+        rebuildIndex();
+    }
+
+    uint8_t dropped = 0;
+    for (uint8_t i = 0; i < SCENE_CAPACITY; i++) {
+        const SceneEntry& s = scenes.scenes[i];
+        bool valid = s.endpoint < LightEndpoints::COUNT && LightEndpointTemplate::isValid(s.attrs);
+        if (valid && s.group_id != 0) {
+            int slot = findGroup(s.group_id);
+            valid = slot >= 0 && (groups_[slot].endpoints & BIT(s.endpoint));
+        }
+        if (valid) {
+            scenes_[i] = s;
+        } else {
+            dropped += (s.endpoint != FREE);
+            memset(&scenes_[i], FREE, sizeof(scenes_[i]));
+        }
+    }
+
+    k_mutex_unlock(&mutex_);
+
+    if (dropped > 0) {
+        LOG_WRN("%u stored scenes do not fit this build - dropped", dropped);
+    }
+
+    int groups_loaded = getGroupCount();
+    LOG_INF("Groups: %d, scenes: %u", groups_loaded, getSceneCount());
+    return groups_loaded;
+}
+
+void LightGroups::persistWorkHandler(struct k_work* work) {
+    LightGroups& self = getInstance();
+    static GroupEntry groups[CAPACITY];
+    static SceneRecord record;
+
+    k_mutex_lock(&self.mutex_, K_FOREVER);
+    memcpy(groups, self.groups_, sizeof(groups));
+    memcpy(record.scenes, self.scenes_, sizeof(record.scenes));
+    k_mutex_unlock(&self.mutex_);
+
+    record.version = SCENES_VERSION;
+    record.reserved = 0;
+
+    int ret = settings_save_one(GROUPS_KEY, groups, sizeof(groups));
+    if (ret == 0) {
+        ret = settings_save_one(SCENES_KEY, &record, sizeof(record));
+    }
+    if (ret < 0) {
+        LOG_WRN("Failed to save groups/scenes: %d", ret);
+    }
+}
+
+void LightGroups::erase() {
+    k_mutex_lock(&mutex_, K_FOREVER);
+    memset(groups_, 0, sizeof(groups_));
+    memset(scenes_, FREE, sizeof(scenes_));
+    memset(buckets_, 0, sizeof(buckets_));
+    k_mutex_unlock(&mutex_);
+
+    settings_delete(GROUPS_KEY);
+    settings_delete(SCENES_KEY);
+}
+
+/*=============================================================================
+ * Groups
+ *===========================================================================*/
+
+int LightGroups::addGroup(uint16_t endpoint_id, uint16_t group_id) {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return -ENOENT;
+    }
+    if (group_id == 0) {
+        return -EINVAL;
+    }
+
+    int ret = 0;
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    int slot = findGroup(group_id);
+    if (slot >= 0) {
+        if (groups_[slot].endpoints & BIT(index)) {
+            k_mutex_unlock(&mutex_);
+            return 0;
+        }
+        groups_[slot].endpoints |= BIT(index);
+    } else {
+        for (slot = 0; slot < CAPACITY && groups_[slot].group_id != 0; slot++) {
+        }
+        if (slot == CAPACITY) {
+            ret = -ENOSPC;
+        } else {
+            groups_[slot] = { group_id, (uint16_t)BIT(index) };
+            rebuildIndex();
+        }
+    }
+
+    k_mutex_unlock(&mutex_);
+
+    if (ret == 0) {
+        LOG_INF("Endpoint %u joined group 0x%04x", endpoint_id, group_id);
+        k_work_submit(&persist_work_);
+    }
+    return ret;
+}
+
+int LightGroups::removeGroup(uint16_t endpoint_id, uint16_t group_id) {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return -ENOENT;
+    }
+
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    int slot = findGroup(group_id);
+    if (slot < 0 || !(groups_[slot].endpoints & BIT(index))) {
+        k_mutex_unlock(&mutex_);
+        return -ENOENT;
+    }
+
+    groups_[slot].endpoints &= ~BIT(index);
+    dropScenes(index, group_id);
+    if (groups_[slot].endpoints == 0) {
+        groups_[slot].group_id = 0;
+        rebuildIndex();
+    }
+
+    k_mutex_unlock(&mutex_);
+
+    LOG_INF("Endpoint %u left group 0x%04x", endpoint_id, group_id);
+    k_work_submit(&persist_work_);
+    return 0;
+}
+
+void LightGroups::removeAllGroups(uint16_t endpoint_id) {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return;
+    }
+
+    bool removed = false;
+    k_mutex_lock(&mutex_, K_FOREVER);
+    for (GroupEntry& g : groups_) {
+        if (g.group_id == 0 || !(g.endpoints & BIT(index))) {
+            continue;
+        }
+        g.endpoints &= ~BIT(index);
+        dropScenes(index, g.group_id);
+        if (g.endpoints == 0) {
+            g.group_id = 0;
+        }
+        removed = true;
+    }
+    if (removed) {
+        rebuildIndex();
+    }
+    k_mutex_unlock(&mutex_);
+
+    if (removed) {
+        k_work_submit(&persist_work_);
+    }
+}
+
+uint32_t LightGroups::getMembers(uint16_t group_id) const {
+    k_mutex_lock(&mutex_, K_FOREVER);
+    int slot = findGroup(group_id);
+    uint32_t members = (slot >= 0) ? groups_[slot].endpoints : 0;
+    k_mutex_unlock(&mutex_);
+    return members;
+}
+
+bool LightGroups::isMember(uint16_t endpoint_id, uint16_t group_id) const {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    return index < LightEndpoints::COUNT && (getMembers(group_id) & BIT(index));
+}
+
+uint8_t LightGroups::getGroupCount() const {
+    uint8_t count = 0;
+    k_mutex_lock(&mutex_, K_FOREVER);
+    for (const GroupEntry& g : groups_) {
+        count += (g.group_id != 0);
+    }
+    k_mutex_unlock(&mutex_);
+    return count;
+}
+
+bool LightGroups::getGroup(uint8_t slot, GroupEntry& out) const {
+    if (slot >= CAPACITY) {
+        return false;
+    }
+    k_mutex_lock(&mutex_, K_FOREVER);
+    out = groups_[slot];
+    k_mutex_unlock(&mutex_);
+    return out.group_id != 0;
+}
+
+/*=============================================================================
+ * Scenes
+ *===========================================================================*/
+
+int LightGroups::storeScene(uint16_t endpoint_id, uint16_t group_id, uint8_t scene_id) {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    LightAttributes attrs;
+    if (!LightEndpoints::getInstance().getAttributes(endpoint_id, attrs)) {
+        return -ENOENT;
+    }
+
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    if (group_id != 0) {
+        int slot = findGroup(group_id);
+        if (slot < 0 || !(groups_[slot].endpoints & BIT(index))) {
+            k_mutex_unlock(&mutex_);
+            return -EINVAL;
+        }
+    }
+
+    // Overwrite the same scene, else take a free entry
+    int i = findScene(index, group_id, scene_id);
+    if (i < 0) {
+        i = findScene(FREE, 0xFFFF, FREE);
+    }
+    if (i < 0) {
+        k_mutex_unlock(&mutex_);
+        return -ENOSPC;
+    }
+    scenes_[i] = { group_id, scene_id, index, attrs };
+
+    k_mutex_unlock(&mutex_);
+
+    k_work_submit(&persist_work_);
+    return 0;
+}
+
+int LightGroups::removeScene(uint16_t endpoint_id, uint16_t group_id, uint8_t scene_id) {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return -ENOENT;
+    }
+
+    k_mutex_lock(&mutex_, K_FOREVER);
+    int i = findScene(index, group_id, scene_id);
+    if (i >= 0) {
+        memset(&scenes_[i], FREE, sizeof(scenes_[i]));
+    }
+    k_mutex_unlock(&mutex_);
+
+    if (i < 0) {
+        return -ENOENT;
+    }
+    k_work_submit(&persist_work_);
+    return 0;
+}
+
+uint8_t LightGroups::getSceneCount() const {
+    uint8_t count = 0;
+    k_mutex_lock(&mutex_, K_FOREVER);
+    for (const SceneEntry& s : scenes_) {
+        count += (s.endpoint != FREE);
+    }
+    k_mutex_unlock(&mutex_);
+    return count;
+}
+
+int LightGroups::recall(uint32_t endpoint_mask, uint16_t group_id, uint8_t scene_id) {
+    LightAttributes values[LightEndpoints::COUNT];
+    uint32_t found = 0;
+
+    // Collect every member's values first, then apply them in one go
+    k_mutex_lock(&mutex_, K_FOREVER);
+    for (const SceneEntry& s : scenes_) {
+        if (s.endpoint < LightEndpoints::COUNT && (endpoint_mask & BIT(s.endpoint)) &&
+            s.group_id == group_id && s.scene_id == scene_id) {
+            values[s.endpoint] = s.attrs;
+            found |= BIT(s.endpoint);
+        }
+    }
+    k_mutex_unlock(&mutex_);
+
+    if (found == 0) {
+        return -ENOENT;
+    }
+    LightEndpoints::getInstance().applyAttributes(found, values);
+    return 0;
+}
+
+int LightGroups::recallScene(uint16_t endpoint_id, uint16_t group_id, uint8_t scene_id) {
+    uint8_t index = LightEndpoints::indexOf(endpoint_id);
+    if (index >= LightEndpoints::COUNT) {
+        return -ENOENT;
+    }
+    return recall(BIT(index), group_id, scene_id);
+}
+
+/*=============================================================================
+ * Group Commands
+ *===========================================================================*/
+
+int LightGroups::onGroupCommand(uint16_t group_id, const ClusterCommand& cmd, uint32_t rx_cycles) {
+    uint32_t members = getMembers(group_id);
+    if (members == 0) {
+        return -ENOENT;
+    }
+
+    int ret;
+    if (cmd.cluster_id == SCENES_CLUSTER_ID) {
+        ret = (cmd.command_id == LightCommand::RECALL_SCENE)
+              ? recall(members, cmd.group_id, cmd.scene_id) : -ENOTSUP;
+    } else {
+        ret = LightEndpoints::getInstance().dispatchMask(members, cmd);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    // Output callback ran synchronously: the LEDs have changed by now
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - rx_cycles);
+
+    k_mutex_lock(&mutex_, K_FOREVER);
+    latency_.commands++;
+    latency_.last_us = us;
+    latency_.max_us = MAX(latency_.max_us, us);
+    latency_.total_us += us;
+    k_mutex_unlock(&mutex_);
+
+    LOG_DBG("Group 0x%04x: cluster 0x%04x cmd 0x%02x to 0x%x in %u us",
+            group_id, cmd.cluster_id, cmd.command_id, members, us);
+    return 0;
+}
+
+void LightGroups::getLatency(LatencyStats& out) const {
+    k_mutex_lock(&mutex_, K_FOREVER);
+    out = latency_;
+    k_mutex_unlock(&mutex_);
+}
+
+void LightGroups::resetLatency() {
+    k_mutex_lock(&mutex_, K_FOREVER);
+    latency_ = {};
+    k_mutex_unlock(&mutex_);
+}
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
+
+/*=============================================================================
+ * Shell Commands
+ *===========================================================================*/
+
+#ifdef CONFIG_SHELL
+using smarthome::protocol::matter::ClusterCommand;
+using smarthome::protocol::matter::GroupEntry;
+using smarthome::protocol::matter::LightGroups;
+namespace LightCommand = smarthome::protocol::matter::LightCommand;
+
+static int cmd_group_add(const struct shell* sh, size_t argc, char** argv) {
+    int ret = LightGroups::getInstance().addGroup((uint16_t)atoi(argv[1]),
+                                                  (uint16_t)strtoul(argv[2], NULL, 0));
+    if (ret < 0) {
+        shell_error(sh, "AddGroup failed: %d", ret);
+    }
+    return ret;
+}
+
+static int cmd_group_remove(const struct shell* sh, size_t argc, char** argv) {
+    int ret = LightGroups::getInstance().removeGroup((uint16_t)atoi(argv[1]),
+                                                     (uint16_t)strtoul(argv[2], NULL, 0));
+    if (ret < 0) {
+        shell_error(sh, "RemoveGroup failed: %d", ret);
+    }
+    return ret;
+}
+
+static int cmd_group_list(const struct shell* sh, size_t argc, char** argv) {
+    LightGroups& groups = LightGroups::getInstance();
+
+    for (uint8_t slot = 0; slot < LightGroups::CAPACITY; slot++) {
+        GroupEntry g;
+        if (groups.getGroup(slot, g)) {
+            shell_print(sh, "group 0x%04x: endpoints 0x%02x", g.group_id, g.endpoints);
+        }
+    }
+    shell_print(sh, "%u/%u groups, %u/%u scenes", groups.getGroupCount(), LightGroups::CAPACITY,
+                groups.getSceneCount(), LightGroups::SCENE_CAPACITY);
+    return 0;
+}
+
+static int cmd_group_send(const struct shell* sh, size_t argc, char** argv) {
+    uint32_t rx = k_cycle_get_32();
+    uint16_t group_id = (uint16_t)strtoul(argv[1], NULL, 0);
+    ClusterCommand cmd = { 0, smarthome::protocol::matter::ON_OFF_CLUSTER_ID, 0, 0 };
+
+    if (strcmp(argv[2], "on") == 0) {
+        cmd.command_id = LightCommand::ON;
+    } else if (strcmp(argv[2], "off") == 0) {
+        cmd.command_id = LightCommand::OFF;
+    } else if (strcmp(argv[2], "toggle") == 0) {
+        cmd.command_id = LightCommand::TOGGLE;
+    } else {
+        cmd.cluster_id = smarthome::protocol::matter::LEVEL_CONTROL_CLUSTER_ID;
+        cmd.command_id = LightCommand::MOVE_TO_LEVEL_WITH_ON_OFF;
+        cmd.level = (uint8_t)atoi(argv[2]);
+    }
+
+    int ret = LightGroups::getInstance().onGroupCommand(group_id, cmd, rx);
+    if (ret < 0) {
+        shell_error(sh, "Group 0x%04x: %d", group_id, ret);
+    }
+    return ret;
+}
+
+static int cmd_group_store(const struct shell* sh, size_t argc, char** argv) {
+    int ret = LightGroups::getInstance().storeScene((uint16_t)atoi(argv[1]),
+                                                    (uint16_t)strtoul(argv[2], NULL, 0),
+                                                    (uint8_t)atoi(argv[3]));
+    if (ret < 0) {
+        shell_error(sh, "StoreScene failed: %d", ret);
+    }
+    return ret;
+}
+
+static int cmd_group_recall(const struct shell* sh, size_t argc, char** argv) {
+    uint32_t rx = k_cycle_get_32();
+    uint16_t group_id = (uint16_t)strtoul(argv[1], NULL, 0);
+    ClusterCommand cmd = { 0, smarthome::protocol::matter::SCENES_CLUSTER_ID,
+                           LightCommand::RECALL_SCENE, 0, group_id, (uint8_t)atoi(argv[2]) };
+
+    int ret = LightGroups::getInstance().onGroupCommand(group_id, cmd, rx);
+    if (ret < 0) {
+        shell_error(sh, "RecallScene failed: %d", ret);
+    }
+    return ret;
+}
+
+static int cmd_group_stats(const struct shell* sh, size_t argc, char** argv) {
+    LightGroups::LatencyStats stats;
+
+    LightGroups::getInstance().getLatency(stats);
+    shell_print(sh, "Group commands: %u", stats.commands);
+    if (stats.commands) {
+        shell_print(sh, "Receipt to LED: last %u us, avg %u us, max %u us", stats.last_us,
+                    (uint32_t)(stats.total_us / stats.commands), stats.max_us);
+    }
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        LightGroups::getInstance().resetLatency();
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_group,
+    SHELL_CMD_ARG(add, NULL, "AddGroup: <endpoint> <group>", cmd_group_add, 3, 0),
+    SHELL_CMD_ARG(remove, NULL, "RemoveGroup: <endpoint> <group>", cmd_group_remove, 3, 0),
+    SHELL_CMD(list, NULL, "Group table", cmd_group_list),
+    SHELL_CMD_ARG(send, NULL, "Group command: <group> on|off|toggle|<level>", cmd_group_send, 3, 0),
+    SHELL_CMD_ARG(store, NULL, "StoreScene: <endpoint> <group> <scene>", cmd_group_store, 4, 0),
+    SHELL_CMD_ARG(recall, NULL, "Group RecallScene: <group> <scene>", cmd_group_recall, 3, 0),
+    SHELL_CMD_ARG(stats, NULL, "Command latency [reset]", cmd_group_stats, 1, 1),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(group, &sub_group, "Light groups and scenes", NULL);
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * LIGHT GROUPS - Groups & Scenes Clusters for the Light Endpoints
+ * ============================================================================
+ *
+ * Purpose:
+ *   Whole-room control: a controller addresses one group ID and every
+ *   light endpoint in the group reacts, in one LED update.
+ *
+ * Groups (0x0004):
+ *   GROUP_TABLE_CAPACITY group entries, each holding the membership
+ *   bitmap of the light endpoints (bit n = endpoint LIGHT_ENDPOINT_ID + n).
+ *   A 16-bucket open-addressing index finds a group ID in O(1), so a
+ *   multicast command costs one lookup and one masked dispatch whatever
+ *   the number of members.
+ *
+ * Scenes (0x0005):
+ *   SCENE_TABLE_CAPACITY 8-byte entries (group, scene, endpoint and the
+ *   OnOff/CurrentLevel/ColorTemperatureMireds values). A recall collects the values of every
+ *   member endpoint first and applies them together: one attribute
+ *   change, one LED update, no endpoint seen half-recalled.
+ *
+ * Persistence:
+ *   "matter/groups" and "matter/scenes", each one blob written from the
+ *   system work queue after a change. The index is rebuilt at load.
+ *
+ * Latency:
+ *   onGroupCommand() records the time from command receipt (cycle stamp
+ *   taken by the caller when the frame arrived) to the LED update -
+ *   shown by "group stats".
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include "light_endpoint.hpp"
+
+namespace smarthome { namespace protocol { namespace matter {
+
+/**
+ * Group with its light endpoint members (persisted)
+ */
+struct GroupEntry {
+    uint16_t group_id;                  ///< 0 = free entry
+    uint16_t endpoints;                 ///< Membership bitmap, bit per endpoint index
+};
+
+static_assert(sizeof(GroupEntry) == 4, "GroupEntry is persisted");
+
+/**
+ * Scene of one endpoint (persisted)
+ */
+struct SceneEntry {
+    uint16_t group_id;                  ///< 0 = scene outside any group
+    uint8_t scene_id;
+    uint8_t endpoint;                   ///< Endpoint index, FREE = free entry
+    LightAttributes attrs;
+};
+
+static_assert(sizeof(SceneEntry) == 8, "SceneEntry is persisted");
+static_assert(LightEndpoints::COUNT <= 16, "GroupEntry::endpoints has one bit per endpoint");
+
+class LightGroups {
+public:
+    static constexpr uint8_t CAPACITY = GROUP_TABLE_CAPACITY;
+    static constexpr uint8_t SCENE_CAPACITY = SCENE_TABLE_CAPACITY;
+    static constexpr uint8_t BUCKETS = 16;          ///< Power of two, > CAPACITY
+    static constexpr uint8_t FREE = 0xFF;
+
+    static_assert(BUCKETS > CAPACITY && (BUCKETS & (BUCKETS - 1)) == 0, "index load");
+
+    struct LatencyStats {
+        uint32_t commands;              ///< Group commands applied
+        uint32_t last_us;               ///< Receipt to LED update
+        uint32_t max_us;
+        uint64_t total_us;
+    };
+
+    /// Get singleton instance
+    static LightGroups& getInstance();
+
+    // Prevent copying
+    LightGroups(const LightGroups&) = delete;
+    LightGroups& operator=(const LightGroups&) = delete;
+
+    /**
+     * Load the group and scene tables
+     *
+     * @return Number of groups, negative error code on failure
+     */
+    int init();
+
+    /**
+     * Add an endpoint to a group (AddGroup)
+     *
+     * @return 0 on success (also if already a member), -ENOENT for an
+     *         unknown endpoint, -EINVAL for group 0, -ENOSPC when the
+     *         table is full
+     */
+    int addGroup(uint16_t endpoint_id, uint16_t group_id);
+
+    /**
+     * Remove an endpoint from a group with its scenes in the group (RemoveGroup)
+     *
+     * @return 0 on success, -ENOENT if the endpoint is not a member
+     */
+    int removeGroup(uint16_t endpoint_id, uint16_t group_id);
+
+    /**
+     * Remove an endpoint from every group (RemoveAllGroups)
+     */
+    void removeAllGroups(uint16_t endpoint_id);
+
+    /**
+     * Members of a group; O(1)
+     *
+     * @return Bitmap of endpoint indices, 0 if nobody is in the group
+     */
+    uint32_t getMembers(uint16_t group_id) const;
+
+    bool isMember(uint16_t endpoint_id, uint16_t group_id) const;
+
+    /**
+     * Store the current attributes of an endpoint as a scene (StoreScene)
+     *
+     * @return 0 on success, -ENOENT for an unknown endpoint, -EINVAL if the
+     *         endpoint is not in the group, -ENOSPC when the table is full
+     */
+    int storeScene(uint16_t endpoint_id, uint16_t group_id, uint8_t scene_id);
+
+    /**
+     * @return 0 on success, -ENOENT if the scene is not stored
+     */
+    int removeScene(uint16_t endpoint_id, uint16_t group_id, uint8_t scene_id);
+
+    /**
+     * Recall a scene on one endpoint (unicast RecallScene)
+     *
+     * @return 0 on success, -ENOENT if the scene is not stored
+     */
+    int recallScene(uint16_t endpoint_id, uint16_t group_id, uint8_t scene_id);
+
+    /**
+     * Apply a group-addressed command to every member endpoint
+     *
+     * OnOff and Level Control commands fan out through
+     * LightEndpoints::dispatchMask(); RecallScene recalls the scene on
+     * every member that has it. Either way the LEDs change in one update.
+     *
+     * @param rx_cycles k_cycle_get_32() when the command arrived, for the
+     *        latency statistics
+     * @return 0 on success, -ENOENT if no endpoint is in the group (the
+     *         command is not for this node) or has the scene, -ENOTSUP /
+     *         -EINVAL for a bad command
+     */
+    int onGroupCommand(uint16_t group_id, const ClusterCommand& cmd, uint32_t rx_cycles);
+
+    uint8_t getGroupCount() const;
+    uint8_t getSceneCount() const;
+
+    /**
+     * Copy a group entry
+     *
+     * @param slot 0..CAPACITY-1
+     * @return false if the slot is free
+     */
+    bool getGroup(uint8_t slot, GroupEntry& out) const;
+
+    void getLatency(LatencyStats& out) const;
+    void resetLatency();
+
+    /**
+     * Drop every group and scene, in RAM and storage (factory reset)
+     */
+    void erase();
+
+private:
+    /// Private constructor (singleton)
+    LightGroups();
+
+    /// Destructor
+    ~LightGroups() = default;
+
+    static uint8_t bucketOf(uint16_t group_id);
+    int findGroup(uint16_t group_id) const;
+    int findScene(uint8_t endpoint, uint16_t group_id, uint8_t scene_id) const;
+    void rebuildIndex();
+    void dropScenes(uint8_t endpoint, uint16_t group_id);
+    int recall(uint32_t endpoint_mask, uint16_t group_id, uint8_t scene_id);
+    static void persistWorkHandler(struct k_work* work);
+
+    GroupEntry groups_[CAPACITY];
+    SceneEntry scenes_[SCENE_CAPACITY];
+    uint8_t buckets_[BUCKETS];          ///< Group slot + 1, 0 = empty bucket
+    LatencyStats latency_;
+    mutable struct k_mutex mutex_;
+    struct k_work persist_work_;
+};
+
+}  // namespace matter
+}  // namespace protocol
+}  // namespace smarthome
@@ -114,7 +114,8 @@ int RadioManager::disable() {
 
 int RadioManager::transmit(uint8_t channel, int8_t power_dbm,
                           const uint8_t* data, size_t len) {
-    if (!data || len == 0 || len > 127) {
+    if (!data || len == 0 || len > MAX_PACKET_LEN ||
+        channel < CHANNEL_MIN || channel > CHANNEL_MAX) {
         return -EINVAL;
     }
     
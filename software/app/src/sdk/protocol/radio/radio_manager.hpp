@@ -28,6 +28,11 @@ enum class RadioState : uint8_t {
 
 class RadioManager {
 public:
+    /* 802.15.4 channels in the 2.4 GHz band, and the largest PSDU */
+    static constexpr uint8_t CHANNEL_MIN = 11;
+    static constexpr uint8_t CHANNEL_MAX = 26;
+    static constexpr size_t MAX_PACKET_LEN = 127;
+    
     static RadioManager& getInstance();
     
     RadioManager(const RadioManager&) = delete;
@@ -54,6 +59,8 @@ public:
      * @param power_dbm Transmit power in dBm
      * @param data Packet data
      * @param len Packet length (max 127)
+     * @return 0 on success, -EINVAL for a channel or length out of range,
+     *         -ENOTSUP while the radio is disabled
      */
     int transmit(uint8_t channel, int8_t power_dbm, 
                 const uint8_t* data, size_t len);
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "diag_snapshot.hpp"
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <string.h>
+
+namespace smarthome { namespace protocol { namespace thread {
+
+int encodeDiagRecord(const DiagSnapshot& snapshot, uint8_t* buf, size_t len) {
+    uint8_t neighbors = MIN(snapshot.neighbor_count, DIAG_MAX_NEIGHBORS);
+    uint8_t routes = MIN(snapshot.route_count, DIAG_MAX_ROUTES);
+    size_t size = DIAG_RECORD_HEADER_SIZE + DIAG_RECORD_ENTRY_SIZE * (neighbors + routes);
+
+    if (len < size) {
+        return -ENOBUFS;
+    }
+
+    buf[0] = DIAG_RECORD_VERSION;
+    buf[1] = snapshot.role;
+    sys_put_le16(snapshot.rloc16, &buf[2]);
+    sys_put_le16(snapshot.parent_rloc16, &buf[4]);
+    buf[6] = snapshot.channel;
+    buf[7] = (uint8_t)snapshot.parent_rssi;
+    sys_put_le32(snapshot.partition_id, &buf[8]);
+    memcpy(&buf[12], snapshot.ext_addr, sizeof(snapshot.ext_addr));
+    sys_put_le32(snapshot.uptime_s, &buf[20]);
+    buf[24] = snapshot.leader_router_id;
+    buf[25] = snapshot.leader_weight;
+    buf[26] = snapshot.data_version;
+    buf[27] = snapshot.stable_data_version;
+    buf[28] = neighbors;
+    buf[29] = routes;
+    buf[30] = snapshot.neighbors_dropped;
+    buf[31] = 0;
+
+    uint8_t* p = &buf[DIAG_RECORD_HEADER_SIZE];
+    for (uint8_t i = 0; i < neighbors; i++, p += DIAG_RECORD_ENTRY_SIZE) {
+        sys_put_le16(snapshot.neighbors[i].rloc16, &p[0]);
+        p[2] = (uint8_t)snapshot.neighbors[i].avg_rssi;
+        p[3] = snapshot.neighbors[i].flags;
+    }
+    for (uint8_t i = 0; i < routes; i++, p += DIAG_RECORD_ENTRY_SIZE) {
+        p[0] = snapshot.routes[i].router_id;
+        p[1] = snapshot.routes[i].next_hop;
+        p[2] = snapshot.routes[i].path_cost;
+        p[3] = snapshot.routes[i].link_quality;
+    }
+
+    return (int)size;
+}
+
+int decodeDiagRecord(const uint8_t* buf, size_t len, DiagSnapshot& snapshot) {
+    if (len < DIAG_RECORD_HEADER_SIZE) {
+        return -EINVAL;
+    }
+    if (buf[0] != DIAG_RECORD_VERSION) {
+        return -ENOTSUP;
+    }
+
+    uint8_t neighbors = buf[28];
+    uint8_t routes = buf[29];
+    if (neighbors > DIAG_MAX_NEIGHBORS || routes > DIAG_MAX_ROUTES ||
+        len < DIAG_RECORD_HEADER_SIZE + DIAG_RECORD_ENTRY_SIZE * (neighbors + routes)) {
+        return -EINVAL;
+    }
+
+    snapshot.role = buf[1];
+    snapshot.rloc16 = sys_get_le16(&buf[2]);
+    snapshot.parent_rloc16 = sys_get_le16(&buf[4]);
+    snapshot.channel = buf[6];
+    snapshot.parent_rssi = (int8_t)buf[7];
+    snapshot.partition_id = sys_get_le32(&buf[8]);
+    memcpy(snapshot.ext_addr, &buf[12], sizeof(snapshot.ext_addr));
+    snapshot.uptime_s = sys_get_le32(&buf[20]);
+    snapshot.leader_router_id = buf[24];
+    snapshot.leader_weight = buf[25];
+    snapshot.data_version = buf[26];
+    snapshot.stable_data_version = buf[27];
+    snapshot.neighbor_count = neighbors;
+    snapshot.route_count = routes;
+    snapshot.neighbors_dropped = buf[30];
+
+    const uint8_t* p = &buf[DIAG_RECORD_HEADER_SIZE];
+    for (uint8_t i = 0; i < neighbors; i++, p += DIAG_RECORD_ENTRY_SIZE) {
+        snapshot.neighbors[i].rloc16 = sys_get_le16(&p[0]);
+        snapshot.neighbors[i].avg_rssi = (int8_t)p[2];
+        snapshot.neighbors[i].flags = p[3];
+    }
+    for (uint8_t i = 0; i < routes; i++, p += DIAG_RECORD_ENTRY_SIZE) {
+        snapshot.routes[i].router_id = p[0];
+        snapshot.routes[i].next_hop = p[1];
+        snapshot.routes[i].path_cost = p[2];
+        snapshot.routes[i].link_quality = p[3];
+    }
+
+    return 0;
+}
+
+/*=============================================================================
+ * History
+ *===========================================================================*/
+
+void DiagHistory::commit() {
+    head_ = (head_ + 1) % DEPTH;
+    if (count_ < DEPTH) {
+        count_++;
+    }
+    total_++;
+}
+
+const DiagSnapshot* DiagHistory::get(uint8_t age) const {
+    if (age >= count_) {
+        return nullptr;
+    }
+    return &entries_[(head_ + DEPTH - 1 - age) % DEPTH];
+}
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
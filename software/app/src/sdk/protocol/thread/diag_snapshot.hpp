@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Diagnostics Snapshot - compact Thread topology record and history ring
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "../matter/commission/chip_config.hpp"
+
+namespace smarthome { namespace protocol { namespace thread {
+
+constexpr uint8_t DIAG_MAX_NEIGHBORS = 10;
+constexpr uint8_t DIAG_MAX_ROUTES = 8;
+
+/// DiagNeighbor::flags
+constexpr uint8_t DIAG_NEIGHBOR_CHILD = 1U << 0;
+constexpr uint8_t DIAG_NEIGHBOR_RX_ON = 1U << 1;    ///< rx-on-when-idle (not sleepy)
+constexpr uint8_t DIAG_NEIGHBOR_LQI_SHIFT = 2;      ///< Bits 2-3: incoming link quality
+
+struct DiagNeighbor {
+    uint16_t rloc16;
+    int8_t avg_rssi;
+    uint8_t flags;
+};
+
+struct DiagRoute {
+    uint8_t router_id;
+    uint8_t next_hop;       ///< Router ID, 63 = none
+    uint8_t path_cost;
+    uint8_t link_quality;   ///< In (bits 0-1) and out (bits 2-3)
+};
+
+/**
+ * One diagnostics collection: identity, role, leader data, neighbor table
+ * and route table, bounded to fixed-size arrays
+ */
+struct DiagSnapshot {
+    uint32_t uptime_s;
+    uint8_t ext_addr[8];
+    uint8_t role;                   ///< otDeviceRole
+    uint8_t channel;
+    uint16_t rloc16;
+    uint16_t parent_rloc16;         ///< 0xFFFF unless a child
+    int8_t parent_rssi;
+    uint32_t partition_id;
+    uint8_t leader_router_id;
+    uint8_t leader_weight;
+    uint8_t data_version;
+    uint8_t stable_data_version;
+    uint8_t neighbor_count;         ///< Entries used in neighbors[]
+    uint8_t route_count;            ///< Entries used in routes[]
+    uint8_t neighbors_dropped;      ///< Table entries that did not fit
+    DiagNeighbor neighbors[DIAG_MAX_NEIGHBORS];
+    DiagRoute routes[DIAG_MAX_ROUTES];
+};
+
+constexpr uint8_t DIAG_RECORD_VERSION = 1;
+constexpr size_t DIAG_RECORD_HEADER_SIZE = 32;
+constexpr size_t DIAG_RECORD_ENTRY_SIZE = 4;
+constexpr size_t DIAG_RECORD_MAX_SIZE = DIAG_RECORD_HEADER_SIZE +
+    DIAG_RECORD_ENTRY_SIZE * (DIAG_MAX_NEIGHBORS + DIAG_MAX_ROUTES);
+
+/**
+ * Encode a snapshot as a little-endian record (IPC/MQTT export)
+ *
+ * Layout (offset: field):
+ *   0: version   1: role   2: rloc16   4: parent_rloc16   6: channel
+ *   7: parent_rssi   8: partition_id   12: ext_addr[8]   20: uptime_s
+ *  24: leader_router_id   25: leader_weight   26: data_version
+ *  27: stable_data_version   28: neighbor_count   29: route_count
+ *  30: neighbors_dropped   31: reserved
+ *  32: neighbors (rloc16, avg_rssi, flags) x neighbor_count
+ *      routes (router_id, next_hop, path_cost, link_quality) x route_count
+ *
+ * @return Encoded length, or -ENOBUFS if len is too small
+ */
+int encodeDiagRecord(const DiagSnapshot& snapshot, uint8_t* buf, size_t len);
+
+/**
+ * Decode a record produced by encodeDiagRecord()
+ *
+ * @return 0 on success, -EINVAL if truncated or counts exceed the tables,
+ *         -ENOTSUP for another version
+ */
+int decodeDiagRecord(const uint8_t* buf, size_t len, DiagSnapshot& snapshot);
+
+/**
+ * Fixed-depth ring of the most recent snapshots
+ */
+class DiagHistory {
+public:
+    static constexpr uint8_t DEPTH = matter::NETWORK_DIAG_HISTORY_DEPTH;
+
+    DiagHistory() : head_(0), count_(0), total_(0) {}
+
+    /// Slot for the next snapshot (fill in place, then commit())
+    DiagSnapshot& next() { return entries_[head_]; }
+    void commit();
+
+    /**
+     * @param age 0 = newest
+     * @return Snapshot, nullptr if fewer than age + 1 are stored
+     */
+    const DiagSnapshot* get(uint8_t age) const;
+
+    uint8_t size() const { return count_; }
+    uint32_t getTotal() const { return total_; }    ///< Snapshots ever committed
+    void clear() { head_ = 0; count_ = 0; }
+
+private:
+    DiagSnapshot entries_[DEPTH];
+    uint8_t head_;
+    uint8_t count_;
+    uint32_t total_;
+};
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "link_quality_estimator.hpp"
+#include "network_resilience_manager.hpp"
+#include <string.h>
+
+namespace smarthome { namespace protocol { namespace thread {
+
+static constexpr int16_t toQ4(int16_t value) {
+    return (int16_t)(value * (1 << LinkQualityEstimator::Q_SHIFT));
+}
+
+LinkQualityEstimator::LinkQualityEstimator() {
+    reset();
+}
+
+void LinkQualityEstimator::reset() {
+    rssi_q4_ = 0;
+    lqi_q4_ = 0;
+    link_seeded_ = false;
+    last_ack_requested_ = 0;
+    last_acked_ = 0;
+    counters_seeded_ = false;
+    memset(window_requested_, 0, sizeof(window_requested_));
+    memset(window_lost_, 0, sizeof(window_lost_));
+    window_pos_ = 0;
+    sum_requested_ = 0;
+    sum_lost_ = 0;
+    rssi_class_ = NetworkHealth::UNKNOWN;
+    loss_degraded_ = false;
+}
+
+void LinkQualityEstimator::addLinkSample(int8_t rssi, uint8_t lqi) {
+    int16_t rssi_sample = toQ4(rssi);
+    int16_t lqi_sample = toQ4(lqi);
+
+    if (!link_seeded_) {
+        rssi_q4_ = rssi_sample;
+        lqi_q4_ = (uint8_t)lqi_sample;
+        link_seeded_ = true;
+        return;
+    }
+
+    /* x += (sample - x) / 8, arithmetic shift keeps the sign */
+    rssi_q4_ += (int16_t)((rssi_sample - rssi_q4_) >> EWMA_SHIFT);
+    lqi_q4_ = (uint8_t)(lqi_q4_ + ((lqi_sample - (int16_t)lqi_q4_) >> EWMA_SHIFT));
+}
+
+void LinkQualityEstimator::addCounterSample(uint32_t tx_ack_requested, uint32_t tx_acked) {
+    if (!counters_seeded_) {
+        last_ack_requested_ = tx_ack_requested;
+        last_acked_ = tx_acked;
+        counters_seeded_ = true;
+        return;
+    }
+
+    /* Unsigned deltas survive counter wrap */
+    uint32_t requested = tx_ack_requested - last_ack_requested_;
+    uint32_t acked = tx_acked - last_acked_;
+    uint32_t lost = requested > acked ? requested - acked : 0;
+    last_ack_requested_ = tx_ack_requested;
+    last_acked_ = tx_acked;
+
+    requested = requested > UINT16_MAX ? UINT16_MAX : requested;
+    lost = lost > requested ? requested : lost;
+
+    /* Slide the window: replace the oldest interval */
+    sum_requested_ -= window_requested_[window_pos_];
+    sum_lost_ -= window_lost_[window_pos_];
+    window_requested_[window_pos_] = (uint16_t)requested;
+    window_lost_[window_pos_] = (uint16_t)lost;
+    sum_requested_ += requested;
+    sum_lost_ += lost;
+    window_pos_ = (uint8_t)((window_pos_ + 1) % LOSS_WINDOW);
+}
+
+int8_t LinkQualityEstimator::getRssi() const {
+    /* Round half away from zero */
+    int16_t half = 1 << (Q_SHIFT - 1);
+    int16_t rounded = rssi_q4_ >= 0 ? (int16_t)(rssi_q4_ + half) : (int16_t)(rssi_q4_ - half);
+    return (int8_t)(rounded / (1 << Q_SHIFT));
+}
+
+uint16_t LinkQualityEstimator::getLossPermille() const {
+    if (sum_requested_ == 0) {
+        return 0;
+    }
+    return (uint16_t)((sum_lost_ * 1000U) / sum_requested_);
+}
+
+NetworkHealth LinkQualityEstimator::classifyRssi(int16_t rssi_q4) {
+    if (rssi_q4 < toQ4(-95)) {
+        return NetworkHealth::POOR;
+    } else if (rssi_q4 < toQ4(-80)) {
+        return NetworkHealth::FAIR;
+    } else if (rssi_q4 < toQ4(-65)) {
+        return NetworkHealth::GOOD;
+    }
+    return NetworkHealth::EXCELLENT;
+}
+
+NetworkHealth LinkQualityEstimator::evaluate() {
+    if (!link_seeded_) {
+        return NetworkHealth::UNKNOWN;
+    }
+
+    /* RSSI class moves only once the EWMA is HYSTERESIS_DB past a threshold */
+    NetworkHealth raw = classifyRssi(rssi_q4_);
+    if (rssi_class_ == NetworkHealth::UNKNOWN) {
+        rssi_class_ = raw;
+    } else if (raw > rssi_class_) {
+        NetworkHealth up = classifyRssi((int16_t)(rssi_q4_ - toQ4(HYSTERESIS_DB)));
+        if (up > rssi_class_) {
+            rssi_class_ = up;
+        }
+    } else if (raw < rssi_class_) {
+        NetworkHealth down = classifyRssi((int16_t)(rssi_q4_ + toQ4(HYSTERESIS_DB)));
+        if (down < rssi_class_) {
+            rssi_class_ = down;
+        }
+    }
+
+    /* Loss downgrade with separate enter/exit levels */
+    uint16_t loss = getLossPermille();
+    if (!loss_degraded_ && loss > LOSS_DEGRADE_PERMILLE) {
+        loss_degraded_ = true;
+    } else if (loss_degraded_ && loss < LOSS_RECOVER_PERMILLE) {
+        loss_degraded_ = false;
+    }
+
+    if (loss_degraded_ && rssi_class_ > NetworkHealth::POOR) {
+        return static_cast<NetworkHealth>(static_cast<uint8_t>(rssi_class_) - 1);
+    }
+    return rssi_class_;
+}
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Link Quality Estimator - EWMA link metrics and MAC packet loss
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace smarthome { namespace protocol { namespace thread {
+
+enum class NetworkHealth : uint8_t;
+
+/**
+ * Link Quality Estimator
+ * 
+ * Integer-only smoothing of periodic link samples:
+ *  - RSSI and LQI as EWMA in Q4 fixed point (1/16 units), alpha = 1/8
+ *  - Packet loss from cumulative MAC counters (ack requested vs acked),
+ *    summed over a sliding window of LOSS_WINDOW sample intervals
+ *  - Health class with a dead band of HYSTERESIS_DB around each RSSI
+ *    threshold and separate enter/exit levels for the loss downgrade,
+ *    so a link sitting on a boundary does not flap
+ */
+class LinkQualityEstimator {
+public:
+    static constexpr uint8_t Q_SHIFT = 4;           ///< Q4: 16 = 1 dB / 1 LQI step
+    static constexpr uint8_t EWMA_SHIFT = 3;        ///< alpha = 1/8
+    static constexpr uint8_t LOSS_WINDOW = 6;       ///< Sample intervals in the loss window
+    static constexpr uint8_t HYSTERESIS_DB = 3;
+    static constexpr uint16_t LOSS_DEGRADE_PERMILLE = 100;  ///< > 10% drops one class
+    static constexpr uint16_t LOSS_RECOVER_PERMILLE = 70;   ///< < 7% restores it
+
+    LinkQualityEstimator();
+
+    /**
+     * Drop all history (new parent / link up)
+     */
+    void reset();
+
+    /**
+     * Add an RSSI/LQI sample of the current link
+     */
+    void addLinkSample(int8_t rssi, uint8_t lqi);
+
+    /**
+     * Add cumulative MAC counters; the first call only sets the baseline
+     * 
+     * @param tx_ack_requested Unicast frames sent with ack request
+     * @param tx_acked Of those, frames that were acknowledged
+     */
+    void addCounterSample(uint32_t tx_ack_requested, uint32_t tx_acked);
+
+    /**
+     * Re-evaluate the health class from the smoothed metrics
+     * 
+     * @return New health, UNKNOWN until the first link sample
+     */
+    NetworkHealth evaluate();
+
+    bool hasLink() const { return link_seeded_; }
+
+    int16_t getRssiQ4() const { return rssi_q4_; }
+    int8_t getRssi() const;                         ///< Rounded dBm
+    uint8_t getLqiQ4() const { return lqi_q4_; }    ///< 0 (none) to 48 (LQI 3)
+    uint16_t getLossPermille() const;
+
+    /**
+     * RSSI class without hysteresis (< -95 POOR, < -80 FAIR, < -65 GOOD)
+     */
+    static NetworkHealth classifyRssi(int16_t rssi_q4);
+
+private:
+    int16_t rssi_q4_;
+    uint8_t lqi_q4_;
+    bool link_seeded_;
+
+    uint32_t last_ack_requested_;
+    uint32_t last_acked_;
+    bool counters_seeded_;
+
+    uint16_t window_requested_[LOSS_WINDOW];
+    uint16_t window_lost_[LOSS_WINDOW];
+    uint8_t window_pos_;
+    uint32_t sum_requested_;
+    uint32_t sum_lost_;
+
+    NetworkHealth rssi_class_;
+    bool loss_degraded_;
+};
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "network_diagnostics.hpp"
+#include "thread_network_manager.hpp"
+#include "../matter/commission/chip_config.hpp"
+#include <zephyr/logging/log.h>
+#include <stdlib.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+LOG_MODULE_REGISTER(net_diag, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace protocol { namespace thread {
+
+NetworkDiagnostics& NetworkDiagnostics::getInstance() {
+    static NetworkDiagnostics instance;
+    return instance;
+}
+
+NetworkDiagnostics::NetworkDiagnostics() {
+    k_mutex_init(&history_mutex_);
+    k_work_init_delayable(&collect_work_, collectWorkHandler);
+}
+
+NetworkDiagnostics::~NetworkDiagnostics() {
+}
+
+int NetworkDiagnostics::init() {
+    ipc::IPCCore::getInstance().registerCallback(ipc::MessageType::THREAD_DIAG_REQUEST,
+                                                 onIpcRequest);
+
+    k_work_schedule(&collect_work_, K_SECONDS(matter::NETWORK_DIAG_INTERVAL_SEC));
+
+    LOG_INF("Diagnostics every %u s, %u snapshots kept",
+            matter::NETWORK_DIAG_INTERVAL_SEC, DiagHistory::DEPTH);
+    return 0;
+}
+
+void NetworkDiagnostics::setExportCallback(ExportCallback callback) {
+    export_callback_ = callback;
+}
+
+/*=============================================================================
+ * Collection (system work queue)
+ *===========================================================================*/
+
+void NetworkDiagnostics::collectWorkHandler(struct k_work* work) {
+    getInstance().collectNow();
+}
+
+int NetworkDiagnostics::collectNow() {
+    k_work_reschedule(&collect_work_, K_SECONDS(matter::NETWORK_DIAG_INTERVAL_SEC));
+
+    /* Collect outside history_mutex_ - this takes the OpenThread lock */
+    DiagSnapshot snapshot;
+    int ret = ThreadNetworkManager::getInstance().collectDiagnostics(snapshot);
+    if (ret < 0) {
+        return ret;
+    }
+    snapshot.uptime_s = (uint32_t)(k_uptime_get() / 1000);
+
+    k_mutex_lock(&history_mutex_, K_FOREVER);
+    history_.next() = snapshot;
+    history_.commit();
+    k_mutex_unlock(&history_mutex_);
+
+    LOG_DBG("Snapshot %u: RLOC16 0x%04x, %u neighbors, %u routes",
+            history_.getTotal(), snapshot.rloc16, snapshot.neighbor_count, snapshot.route_count);
+
+    if (export_callback_) {
+        uint8_t record[DIAG_RECORD_MAX_SIZE];
+        int len = encodeDiagRecord(snapshot, record, sizeof(record));
+        if (len > 0) {
+            export_callback_(record, len);
+        }
+    }
+
+    return 0;
+}
+
+int NetworkDiagnostics::getSnapshot(uint8_t age, DiagSnapshot& snapshot) const {
+    k_mutex_lock(&history_mutex_, K_FOREVER);
+    const DiagSnapshot* stored = history_.get(age);
+    if (stored) {
+        snapshot = *stored;
+    }
+    k_mutex_unlock(&history_mutex_);
+
+    return stored ? 0 : -ENOENT;
+}
+
+int NetworkDiagnostics::encodeSnapshot(uint8_t age, uint8_t* buf, size_t len) const {
+    k_mutex_lock(&history_mutex_, K_FOREVER);
+    const DiagSnapshot* stored = history_.get(age);
+    int ret = stored ? encodeDiagRecord(*stored, buf, len) : -ENOENT;
+    k_mutex_unlock(&history_mutex_);
+
+    return ret;
+}
+
+/*=============================================================================
+ * IPC Export (IPC RX thread)
+ *===========================================================================*/
+
+void NetworkDiagnostics::onIpcRequest(const ipc::Message& msg) {
+    uint8_t age = (uint8_t)MIN(msg.payload.params.param1, UINT8_MAX);
+    uint8_t record[DIAG_RECORD_MAX_SIZE];
+    int len = getInstance().encodeSnapshot(age, record, sizeof(record));
+
+    auto header = ipc::MessageBuilder(ipc::MessageType::THREAD_DIAG_REPORT)
+                    .setParam(0, (uint32_t)MIN(len, 0))
+                    .setParam(1, age)
+                    .build();
+
+    int ret = (len > 0) ? ipc::IPCCore::getInstance().sendLarge(header, record, len)
+                        : ipc::IPCCore::getInstance().send(header);
+    if (ret < 0) {
+        LOG_WRN("Diag report not sent: %d", ret);
+    }
+}
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
+
+/*=============================================================================
+ * Shell Commands
+ *===========================================================================*/
+
+#ifdef CONFIG_SHELL
+using smarthome::protocol::thread::DiagSnapshot;
+using smarthome::protocol::thread::NetworkDiagnostics;
+
+static void print_snapshot(const struct shell* sh, const DiagSnapshot& s) {
+    shell_print(sh, "t=%u s role %u RLOC16 0x%04x ch %u partition 0x%08x",
+                s.uptime_s, s.role, s.rloc16, s.channel, s.partition_id);
+    shell_print(sh, "leader %u weight %u data v%u/%u parent 0x%04x %d dBm",
+                s.leader_router_id, s.leader_weight, s.data_version,
+                s.stable_data_version, s.parent_rloc16, s.parent_rssi);
+
+    for (uint8_t i = 0; i < s.neighbor_count; i++) {
+        const auto& n = s.neighbors[i];
+        shell_print(sh, "  nbr 0x%04x %d dBm lq %u %s%s", n.rloc16, n.avg_rssi,
+                    n.flags >> smarthome::protocol::thread::DIAG_NEIGHBOR_LQI_SHIFT,
+                    (n.flags & smarthome::protocol::thread::DIAG_NEIGHBOR_CHILD) ? "child" : "router",
+                    (n.flags & smarthome::protocol::thread::DIAG_NEIGHBOR_RX_ON) ? "" : " sleepy");
+    }
+    if (s.neighbors_dropped) {
+        shell_print(sh, "  (+%u neighbors not stored)", s.neighbors_dropped);
+    }
+    for (uint8_t i = 0; i < s.route_count; i++) {
+        const auto& r = s.routes[i];
+        shell_print(sh, "  route %u via %u cost %u lq %u/%u", r.router_id, r.next_hop,
+                    r.path_cost, r.link_quality & 0x3, r.link_quality >> 2);
+    }
+}
+
+static int cmd_netdiag_show(const struct shell* sh, size_t argc, char** argv) {
+    uint8_t age = (argc > 1) ? (uint8_t)strtoul(argv[1], nullptr, 0) : 0;
+    DiagSnapshot snapshot;
+
+    if (NetworkDiagnostics::getInstance().getSnapshot(age, snapshot) < 0) {
+        shell_error(sh, "No snapshot %u", age);
+        return -ENOENT;
+    }
+    print_snapshot(sh, snapshot);
+    return 0;
+}
+
+static int cmd_netdiag_history(const struct shell* sh, size_t argc, char** argv) {
+    auto& diag = NetworkDiagnostics::getInstance();
+    DiagSnapshot snapshot;
+
+    shell_print(sh, "%u stored, %u collected", diag.getHistorySize(), diag.getCollections());
+    for (uint8_t age = 0; diag.getSnapshot(age, snapshot) == 0; age++) {
+        shell_print(sh, "[%u] t=%u s role %u RLOC16 0x%04x parent 0x%04x %u nbr %u routes",
+                    age, snapshot.uptime_s, snapshot.role, snapshot.rloc16,
+                    snapshot.parent_rloc16, snapshot.neighbor_count + snapshot.neighbors_dropped,
+                    snapshot.route_count);
+    }
+    return 0;
+}
+
+static int cmd_netdiag_collect(const struct shell* sh, size_t argc, char** argv) {
+    int ret = NetworkDiagnostics::getInstance().collectNow();
+    if (ret < 0) {
+        shell_error(sh, "Collection failed: %d", ret);
+        return ret;
+    }
+    return cmd_netdiag_show(sh, 1, argv);
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_netdiag,
+    SHELL_CMD_ARG(show, NULL, "Show snapshot [age]", cmd_netdiag_show, 1, 1),
+    SHELL_CMD(history, NULL, "List stored snapshots", cmd_netdiag_history),
+    SHELL_CMD(collect, NULL, "Take a snapshot now", cmd_netdiag_collect),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(netdiag, &sub_netdiag, "Thread network diagnostics", NULL);
+#endif
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Network Diagnostics - periodic Thread topology snapshots
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <zephyr/kernel.h>
+#include "diag_snapshot.hpp"
+#include "ipc/ipc_core.hpp"
+
+namespace smarthome { namespace protocol { namespace thread {
+
+/**
+ * Network Diagnostics Collector
+ *
+ * Every NETWORK_DIAG_INTERVAL_SEC (system work queue) the identity, leader
+ * data, neighbor table and route table are snapshotted through
+ * ThreadNetworkManager::collectDiagnostics() into a DiagHistory ring of
+ * NETWORK_DIAG_HISTORY_DEPTH entries. Nothing is logged per collection;
+ * snapshots leave the device as compact records (encodeDiagRecord):
+ *
+ *   - IPC: THREAD_DIAG_REQUEST (param1 = age) is answered with a
+ *          THREAD_DIAG_REPORT large message carrying the record
+ *   - Export callback: every new record, for an uplink (MQTT, gateway)
+ *   - Shell: "netdiag show [age] | history | collect" (CONFIG_SHELL)
+ */
+class NetworkDiagnostics {
+public:
+    /// Singleton instance getter
+    static NetworkDiagnostics& getInstance();
+
+    /// Delete copy/move constructors
+    NetworkDiagnostics(const NetworkDiagnostics&) = delete;
+    NetworkDiagnostics& operator=(const NetworkDiagnostics&) = delete;
+    NetworkDiagnostics(NetworkDiagnostics&&) = delete;
+    NetworkDiagnostics& operator=(NetworkDiagnostics&&) = delete;
+
+    /**
+     * Register the IPC request handler and start periodic collection
+     *
+     * The first snapshot is taken one interval after init.
+     *
+     * @return 0 on success
+     */
+    int init();
+
+    /**
+     * Take a snapshot now (also re-arms the periodic collection)
+     *
+     * @return 0 on success, -ENOTSUP without OpenThread
+     */
+    int collectNow();
+
+    /**
+     * Copy a stored snapshot
+     *
+     * @param age 0 = newest
+     * @return 0 on success, -ENOENT if the history is shorter
+     */
+    int getSnapshot(uint8_t age, DiagSnapshot& snapshot) const;
+
+    /**
+     * Encode a stored snapshot as a diag record
+     *
+     * @return Record length, -ENOENT if the history is shorter,
+     *         -ENOBUFS if len < record size
+     */
+    int encodeSnapshot(uint8_t age, uint8_t* buf, size_t len) const;
+
+    uint8_t getHistorySize() const { return history_.size(); }
+    uint32_t getCollections() const { return history_.getTotal(); }
+
+    /**
+     * Register callback receiving each new encoded record
+     *
+     * @note Called from the collecting thread; data is valid during the call
+     */
+    using ExportCallback = void (*)(const uint8_t* record, size_t len);
+    void setExportCallback(ExportCallback callback);
+
+private:
+    NetworkDiagnostics();
+    ~NetworkDiagnostics();
+
+    static void collectWorkHandler(struct k_work* work);
+    static void onIpcRequest(const ipc::Message& msg);
+
+    DiagHistory history_;
+    ExportCallback export_callback_ = nullptr;
+    struct k_work_delayable collect_work_;
+    mutable struct k_mutex history_mutex_;
+};
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
@@ -6,11 +6,20 @@
  */
 
 #include "network_resilience_manager.hpp"
+#include "thread_network_manager.hpp"
 #include "../matter/commission/chip_config.hpp"
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <stdio.h>
 
+#ifdef CONFIG_APP_NET_STATS
+#include <zephyr/storage/flash_map.h>
+
+#if FIXED_PARTITION_EXISTS(net_stats_partition)
+#define NET_STATS_AREA_ID FIXED_PARTITION_ID(net_stats_partition)
+#endif
+#endif
 
 LOG_MODULE_REGISTER(net_resilience, CONFIG_LOG_DEFAULT_LEVEL);
 
@@ -24,7 +33,7 @@ NetworkResilienceManager& NetworkResilienceManager::getInstance() {
 NetworkResilienceManager::NetworkResilienceManager()
     : current_health_(NetworkHealth::UNKNOWN)
     , current_rssi_(0)
-    , current_packet_loss_(0.0f)
+    , loss_permille_(0)
     , disconnect_count_(0)
     , reconnect_attempts_(0)
     , last_link_down_time_(0)
@@ -33,15 +42,30 @@ NetworkResilienceManager::NetworkResilienceManager()
     , boot_time_(0)
 {
     k_mutex_init(&stats_mutex_);
-    k_timer_init(&health_check_timer_, nullptr, nullptr);
-    k_timer_init(&link_down_timeout_timer_, nullptr, nullptr);
+    health_check_timer_.init(healthCheckTimerHandler, nullptr, matter::NETWORK_HEALTH_CHECK_SLACK_MS);
+    link_down_timer_.init(linkDownTimeoutHandler);
+    k_work_init(&sample_work_, sampleWorkHandler);
+    k_work_init(&notify_work_, notifyWorkHandler);
+    k_work_init(&disconnect_work_, disconnectWorkHandler);
+    k_work_init_delayable(&checkpoint_work_, checkpointWorkHandler);
+
+    ParentFailover::Config failover = {
+        .poor_window_ms = matter::PARENT_SWITCH_POOR_WINDOW_MS,
+        .search_window_ms = matter::PARENT_SEARCH_WINDOW_MS,
+        .max_searches = matter::PARENT_SWITCH_MAX_SEARCHES,
+    };
+    failover_.init(failover);
 }
 
 NetworkResilienceManager::~NetworkResilienceManager() {
 }
 
 const char* NetworkResilienceManager::getHealthName() const {
-    switch (current_health_) {
+    return healthName(current_health_);
+}
+
+const char* NetworkResilienceManager::healthName(NetworkHealth health) {
+    switch (health) {
         case NetworkHealth::UNKNOWN: return "UNKNOWN";
         case NetworkHealth::POOR: return "POOR";
         case NetworkHealth::FAIR: return "FAIR";
@@ -56,15 +80,24 @@ int NetworkResilienceManager::init() {
     
     boot_time_ = k_uptime_get_32();
     
+    // Lifetime counters from the previous boots
+    loadStatistics();
+    
+    ThreadNetworkManager::getInstance().setParentCandidateCallback(onParentCandidate);
+    
     // Start periodic health monitoring
-    k_timer_start(&health_check_timer_,
-                  K_SECONDS(matter::NETWORK_HEALTH_CHECK_INTERVAL_SEC),
-                  K_SECONDS(matter::NETWORK_HEALTH_CHECK_INTERVAL_SEC));
+    services::timer::TimerService::getInstance().start(health_check_timer_,
+        matter::NETWORK_HEALTH_CHECK_INTERVAL_SEC * 1000,
+        matter::NETWORK_HEALTH_CHECK_INTERVAL_SEC * 1000);
     
     LOG_INF("Resilience manager initialized");
     LOG_INF("Boot time: %d ms", boot_time_);
     LOG_INF("Health check interval: %d seconds", matter::NETWORK_HEALTH_CHECK_INTERVAL_SEC);
     
+#ifdef CONFIG_APP_NET_STATS
+    k_work_schedule(&checkpoint_work_, K_MINUTES(CONFIG_APP_NET_STATS_CHECKPOINT_INTERVAL_MIN));
+#endif
+    
     return 0;
 }
 
@@ -76,113 +109,185 @@ void NetworkResilienceManager::setDisconnectCallback(DisconnectCallback callback
     disconnect_callback_ = callback;
 }
 
+/*=============================================================================
+ * Link Sampling (system work queue)
+ *===========================================================================*/
+
+void NetworkResilienceManager::healthCheckTimerHandler(services::timer::WheelTimer& timer,
+                                                       void* user_data) {
+    getInstance().sampleLink();
+}
+
+void NetworkResilienceManager::sampleWorkHandler(struct k_work* work) {
+    getInstance().sampleLink();
+}
+
+void NetworkResilienceManager::sampleLink() {
+    auto& thread_mgr = ThreadNetworkManager::getInstance();
+
+    if (!thread_mgr.isAttached()) {
+        return;
+    }
+
+    /* Query outside stats_mutex_ - these take the OpenThread lock */
+    int8_t rssi = thread_mgr.getLinkQuality();
+    uint8_t lqi = thread_mgr.getLinkQualityIndicator();
+    ThreadNetworkManager::LinkCounters counters;
+    bool have_counters = (thread_mgr.getLinkCounters(counters) == 0);
+    uint16_t parent = thread_mgr.getParentRloc16();
+    bool is_child = (thread_mgr.getState() == ThreadState::CHILD);
+
+    k_mutex_lock(&stats_mutex_, K_FOREVER);
+    if (parent != parent_rloc16_) {
+        if (parent_rloc16_ != ThreadNetworkManager::RLOC16_NONE &&
+            parent != ThreadNetworkManager::RLOC16_NONE) {
+            // New parent: the old averages describe another link
+            LOG_INF("Parent changed: 0x%04x -> 0x%04x", parent_rloc16_, parent);
+            estimator_.reset();
+            failover_.onParentChanged();
+        }
+        parent_rloc16_ = parent;
+    }
+    if (rssi != ThreadNetworkManager::RSSI_NO_LINK) {
+        estimator_.addLinkSample(rssi, lqi);
+    }
+    if (have_counters) {
+        estimator_.addCounterSample(counters.tx_ack_requested, counters.tx_acked);
+    }
+    current_rssi_ = estimator_.getRssi();
+    loss_permille_ = estimator_.getLossPermille();
+    k_mutex_unlock(&stats_mutex_);
+
+    LOG_DBG("Link sample: RSSI %d (avg %d) dBm, LQI %u, loss %u/1000",
+            rssi, current_rssi_, lqi, loss_permille_);
+
+    NetworkHealth health = updateHealth();
+
+    if (is_child) {
+        runFailover(health, (int8_t)MAX(current_rssi_ - thread_mgr.getRxSensitivity(), 0));
+    } else {
+        // Routers have no parent to switch
+        k_mutex_lock(&stats_mutex_, K_FOREVER);
+        failover_.reset();
+        k_mutex_unlock(&stats_mutex_);
+    }
+}
+
+/*=============================================================================
+ * Proactive Parent Switching
+ *===========================================================================*/
+
+void NetworkResilienceManager::runFailover(NetworkHealth health, int8_t parent_margin) {
+    k_mutex_lock(&stats_mutex_, K_FOREVER);
+    uint16_t recoveries = failover_.getStats().recoveries;
+    bool was_searching = failover_.isSearching();
+    ParentFailover::Action action = failover_.update(health, parent_margin, k_uptime_get_32());
+    ParentFailover::Stats stats = failover_.getStats();
+    int8_t best = failover_.getBestCandidate();
+    bool search_over = was_searching && !failover_.isSearching();
+    k_mutex_unlock(&stats_mutex_);
+
+    if (search_over && best != ParentFailover::NO_CANDIDATE) {
+        LOG_INF("Parent search over: best candidate margin %d dB vs parent %d dB",
+                best, parent_margin);
+    }
+
+    if (stats.recoveries != recoveries) {
+        LOG_INF("Recovered from POOR in %u ms (detach timeout alone: %u ms), "
+                "%u/%u recoveries via a new parent",
+                stats.last_recovery_ms, matter::LINK_DOWN_TIMEOUT_MS,
+                stats.parent_switches, stats.recoveries);
+    }
+
+    // Thread calls outside stats_mutex_ - candidates arrive under the OT lock
+    auto& thread_mgr = ThreadNetworkManager::getInstance();
+
+    if (action == ParentFailover::Action::SEARCH) {
+        LOG_WRN("Link POOR for %u ms (margin %d dB) - searching for a better parent",
+                matter::PARENT_SWITCH_POOR_WINDOW_MS, parent_margin);
+        thread_mgr.searchForBetterParent();
+    }
+}
+
+void NetworkResilienceManager::onParentCandidate(uint16_t rloc16, int8_t margin_db) {
+    auto& self = getInstance();
+
+    k_mutex_lock(&self.stats_mutex_, K_FOREVER);
+    self.failover_.addCandidate(margin_db);
+    k_mutex_unlock(&self.stats_mutex_);
+}
+
+ParentFailover::Stats NetworkResilienceManager::getFailoverStats() {
+    k_mutex_lock(&stats_mutex_, K_FOREVER);
+    ParentFailover::Stats stats = failover_.getStats();
+    k_mutex_unlock(&stats_mutex_);
+    return stats;
+}
+
+void NetworkResilienceManager::notifyWorkHandler(struct k_work* work) {
+    auto& self = getInstance();
+    if (self.health_callback_) {
+        self.health_callback_(self.current_health_);
+    }
+}
+
+void NetworkResilienceManager::disconnectWorkHandler(struct k_work* work) {
+    auto& self = getInstance();
+    if (self.disconnect_callback_) {
+        self.disconnect_callback_();
+    }
+}
+
 NetworkHealth NetworkResilienceManager::updateHealth() {
     k_mutex_lock(&stats_mutex_, K_FOREVER);
     
     NetworkHealth prev_health = current_health_;
     
-    // Get link quality from Thread manager
-    // current_rssi_ = ThreadNetworkManager::getInstance().getLinkQuality();
-    
-    // Assess health based on RSSI
-    if (current_rssi_ < -95) {
-        current_health_ = NetworkHealth::POOR;
-    } else if (current_rssi_ < -80) {
-        current_health_ = NetworkHealth::FAIR;
-    } else if (current_rssi_ < -65) {
-        current_health_ = NetworkHealth::GOOD;
-    } else if (current_rssi_ > -65) {
-        current_health_ = NetworkHealth::EXCELLENT;
-    } else {
-        current_health_ = NetworkHealth::UNKNOWN;
+    // Smoothed RSSI class with hysteresis, lowered on sustained packet loss
+    if (estimator_.hasLink()) {
+        current_health_ = estimator_.evaluate();
     }
+    NetworkHealth health = current_health_;
     
-    // Factor in packet loss
-    if (current_packet_loss_ > 10.0f && current_health_ > NetworkHealth::POOR) {
-        current_health_ = static_cast<NetworkHealth>(
-            static_cast<uint8_t>(current_health_) - 1
-        );
-    }
+    k_mutex_unlock(&stats_mutex_);
     
-    if (prev_health != current_health_) {
-        LOG_INF("Network health: %s (RSSI: %d dBm, Loss: %.1f%%)",
-                getHealthName(), current_rssi_, current_packet_loss_);
+    if (prev_health != health) {
+        LOG_INF("Network health: %s (RSSI: %d dBm, Loss: %u.%u%%)",
+                getHealthName(), current_rssi_,
+                loss_permille_ / 10, loss_permille_ % 10);
         
-        if (health_callback_) {
-            health_callback_(current_health_);
-        }
+        k_work_submit(&notify_work_);
     }
     
-    k_mutex_unlock(&stats_mutex_);
-    
-    return current_health_;
+    return health;
 }
 
 void NetworkResilienceManager::onLinkDown() {
-    /*
-     * TODO: Implement link down handling (3-4 hours)
-     * 
-     * STEP 1: Record Timestamp (1 hour)
-     *  - Set last_link_down_time_ = k_uptime_get_32()
-     *  - Increment disconnect_count_
-     * 
-     * STEP 2: Update Health (1 hour)
-     *  - Set current_health_ = NetworkHealth::POOR
-     *  - Trigger health callback
-     * 
-     * STEP 3: Start Timeout Timer (1 hour)
-     *  - k_timer_start(&link_down_timeout_timer_,
-     *                  K_MSEC(LINK_DOWN_TIMEOUT_MS),
-     *                  K_NO_WAIT);
-     *  - If timer expires, trigger rejoin logic
-     * 
-     * STEP 4: Notify Callbacks (30 min)
-     *  - Call disconnect_callback_ if set
-     *  - Log disconnect event
-     * 
-     * STEP 5: Save Statistics (30 min)
-     *  - saveStatistics() to NVS
-     */
-    
     LOG_WRN("=== LINK DOWN DETECTED ===");
     
     k_mutex_lock(&stats_mutex_, K_FOREVER);
     last_link_down_time_ = k_uptime_get_32();
     disconnect_count_++;
+    bool changed = (current_health_ != NetworkHealth::POOR);
     current_health_ = NetworkHealth::POOR;
     k_mutex_unlock(&stats_mutex_);
     
-    if (disconnect_callback_) {
-        disconnect_callback_();
+    if (changed) {
+        k_work_submit(&notify_work_);
     }
+    k_work_submit(&disconnect_work_);
+    services::timer::TimerService::getInstance().start(link_down_timer_,
+                                                       matter::LINK_DOWN_TIMEOUT_MS);
+    requestCheckpoint();
     
     LOG_INF("Disconnect count: %d", disconnect_count_);
 }
 
 void NetworkResilienceManager::onLinkUp() {
-    /*
-     * TODO: Implement link up handling (2-3 hours)
-     * 
-     * STEP 1: Calculate Downtime (1 hour)
-     *  - uint32_t downtime_ms = k_uptime_get_32() - last_link_down_time_
-     *  - total_downtime_ms_ += downtime_ms
-     *  - Log downtime duration
-     * 
-     * STEP 2: Update Health (1 hour)
-     *  - Assess new link quality
-     *  - Update current_health_
-     *  - Trigger updateHealth()
-     * 
-     * STEP 3: Cancel Timers (30 min)
-     *  - k_timer_stop(&link_down_timeout_timer_)
-     *  - Reset rejoin backoff
-     * 
-     * STEP 4: Save Statistics (30 min)
-     *  - Update NVS with latest stats
-     */
-    
     LOG_INF("=== LINK UP DETECTED ===");
     
+    services::timer::TimerService::getInstance().stop(link_down_timer_);
+    
     k_mutex_lock(&stats_mutex_, K_FOREVER);
     if (last_link_down_time_ > 0) {
         uint32_t downtime_ms = k_uptime_get_32() - last_link_down_time_;
@@ -191,16 +296,37 @@ void NetworkResilienceManager::onLinkUp() {
         last_link_down_time_ = 0;
     }
     network_connect_time_ = k_uptime_get_32();
+    // Possibly a new parent - start the averages over
+    estimator_.reset();
     k_mutex_unlock(&stats_mutex_);
     
-    // Trigger health update
-    updateHealth();
+    // Sample now rather than waiting a full interval
+    k_work_submit(&sample_work_);
+    requestCheckpoint();
+}
+
+void NetworkResilienceManager::linkDownTimeoutHandler(services::timer::WheelTimer& timer,
+                                                      void* user_data) {
+    auto& self = getInstance();
+
+    /* System work queue - down for LINK_DOWN_TIMEOUT_MS without a link up */
+    k_mutex_lock(&self.stats_mutex_, K_FOREVER);
+    self.reconnect_attempts_++;
+    k_mutex_unlock(&self.stats_mutex_);
+
+    LOG_WRN("Link down for %u ms - rejoining", matter::LINK_DOWN_TIMEOUT_MS);
+    ThreadNetworkManager::getInstance().scheduleNetworkRejoin();
+    self.requestCheckpoint();
 }
 
 uint32_t NetworkResilienceManager::getUptimeSec() const {
     return (k_uptime_get_32() - boot_time_) / 1000;
 }
 
+uint32_t NetworkResilienceManager::getLifetimeUptimeSec() const {
+    return base_uptime_s_ + getUptimeSec();
+}
+
 uint32_t NetworkResilienceManager::getNetworkConnectedTimeSec() const {
     if (network_connect_time_ == 0) {
         return 0;
@@ -208,68 +334,223 @@ uint32_t NetworkResilienceManager::getNetworkConnectedTimeSec() const {
     return (k_uptime_get_32() - network_connect_time_) / 1000;
 }
 
+/*=============================================================================
+ * Statistics Persistence (checkpoint ring on net_stats_partition)
+ *===========================================================================*/
+
+void NetworkResilienceManager::loadStatistics() {
+#if defined(CONFIG_APP_NET_STATS) && defined(NET_STATS_AREA_ID)
+    int ret = stats_ring_.init(NET_STATS_AREA_ID, sizeof(NetStatsRecord));
+    if (ret < 0) {
+        LOG_WRN("Statistics partition unusable (%d) - not persisted", ret);
+    } else {
+        NetStatsRecord rec;
+        ret = stats_ring_.load(&rec, sizeof(rec));
+        if (ret == 0 && rec.version == NET_STATS_VERSION) {
+            k_mutex_lock(&stats_mutex_, K_FOREVER);
+            boot_count_ = rec.boot_count;
+            disconnect_count_ = rec.disconnects;
+            reconnect_attempts_ = rec.reconnects;
+            base_uptime_s_ = rec.uptime_s;
+            base_downtime_s_ = rec.downtime_s;
+            k_mutex_unlock(&stats_mutex_);
+
+            LOG_INF("Restored statistics: boot %u, %u disconnects, %u s down / %u s up",
+                    boot_count_, disconnect_count_, base_downtime_s_, base_uptime_s_);
+        } else if (ret != -ENOENT) {
+            LOG_WRN("Discarding stored statistics (%d, version %u)", ret,
+                    ret == 0 ? rec.version : 0);
+        }
+    }
+#elif defined(CONFIG_APP_NET_STATS)
+    LOG_WRN("No net_stats_partition - statistics are not persisted");
+#endif
+
+    boot_count_++;
+}
+
+void NetworkResilienceManager::requestCheckpoint() {
+#ifdef CONFIG_APP_NET_STATS
+    // Significant change: write soon, but not more often than the minimum interval
+    uint32_t since_ms = k_uptime_get_32() - last_checkpoint_ms_;
+    uint32_t min_ms = CONFIG_APP_NET_STATS_MIN_WRITE_INTERVAL_SEC * 1000U;
+    uint32_t delay_ms = (since_ms >= min_ms) ? 0 : min_ms - since_ms;
+
+    if (k_ticks_to_ms_floor32(k_work_delayable_remaining_get(&checkpoint_work_)) > delay_ms) {
+        k_work_reschedule(&checkpoint_work_, K_MSEC(delay_ms));
+    }
+#endif
+}
+
+void NetworkResilienceManager::checkpointWorkHandler(struct k_work* work) {
+#ifdef CONFIG_APP_NET_STATS
+    auto& self = getInstance();
+
+    int ret = self.saveStatistics();
+    if (ret < 0 && ret != -ENODEV) {
+        LOG_WRN("Statistics checkpoint failed: %d", ret);
+    }
+
+    k_work_schedule(&self.checkpoint_work_,
+                    K_MINUTES(CONFIG_APP_NET_STATS_CHECKPOINT_INTERVAL_MIN));
+#endif
+}
+
 int NetworkResilienceManager::saveStatistics() {
-    /*
-     * TODO: Implement NVS save (2-3 hours)
-     * 
-     *  1. Open NVS:
-     *     nvs_handle_t nvs = nvs_open("resilience", NVS_READWRITE);
-     * 
-     *  2. Write statistics:
-     *     nvs_set_u16(nvs, "disconnect_count", disconnect_count_);
-     *     nvs_set_u16(nvs, "reconnect_attempts", reconnect_attempts_);
-     *     nvs_set_u32(nvs, "total_downtime_ms", total_downtime_ms_);
-     * 
-     *  3. Commit and close:
-     *     nvs_commit(nvs);
-     *     nvs_close(nvs);
-     * 
-     *  4. Handle errors gracefully
-     */
-    
-    LOG_DBG("Saving resilience statistics to NVS");
-    return 0;
+#ifdef CONFIG_APP_NET_STATS
+    if (!stats_ring_.isOpen()) {
+        return -ENODEV;
+    }
+
+    NetStatsRecord rec = {};
+
+    // The ring is not reentrant - the mutex also serialises the flash write
+    k_mutex_lock(&stats_mutex_, K_FOREVER);
+
+    uint32_t now = k_uptime_get_32();
+    uint32_t downtime_ms = total_downtime_ms_;
+    if (last_link_down_time_ != 0) {
+        downtime_ms += now - last_link_down_time_;
+    }
+
+    rec.version = NET_STATS_VERSION;
+    rec.boot_count = boot_count_;
+    rec.disconnects = disconnect_count_;
+    rec.reconnects = reconnect_attempts_;
+    rec.uptime_s = base_uptime_s_ + (now - boot_time_) / 1000;
+    rec.downtime_s = base_downtime_s_ + downtime_ms / 1000;
+
+    int ret = stats_ring_.save(&rec, sizeof(rec));
+    if (ret == 0) {
+        last_checkpoint_ms_ = now;
+    }
+
+    k_mutex_unlock(&stats_mutex_);
+
+    LOG_DBG("Statistics checkpoint %u: %d", stats_ring_.getSequence(), ret);
+    return ret;
+#else
+    return -ENOTSUP;
+#endif
 }
 
 void NetworkResilienceManager::resetStatistics() {
-    /*
-     * TODO: Implement reset (1 hour)
-     * 
-     *  1. Lock mutex
-     *  2. Clear all counters
-     *  3. Reset health to UNKNOWN
-     *  4. Clear NVS
-     */
-    
     LOG_INF("Resetting resilience statistics");
     
     k_mutex_lock(&stats_mutex_, K_FOREVER);
     disconnect_count_ = 0;
     reconnect_attempts_ = 0;
     total_downtime_ms_ = 0;
+    base_downtime_s_ = 0;
+    base_uptime_s_ = 0;
+    boot_count_ = 1;
     k_mutex_unlock(&stats_mutex_);
+    
+    // Overwrite the persisted lifetime counters as well
+    saveStatistics();
 }
 
-const char* NetworkResilienceManager::getHealthReport() {
-    static char report[256];
-    
+/*=============================================================================
+ * Health Snapshot / Export
+ *===========================================================================*/
+
+void NetworkResilienceManager::getSnapshot(HealthSnapshot& snapshot) {
     k_mutex_lock(&stats_mutex_, K_FOREVER);
-    
-    snprintf(report, sizeof(report),
-             "Health: %s | RSSI: %d dBm | Loss: %.1f%% | "
-             "Uptime: %d s | Connected: %d s | "
-             "Disconnects: %d | Reconnects: %d",
-             getHealthName(),
-             current_rssi_,
-             current_packet_loss_,
-             getUptimeSec(),
-             getNetworkConnectedTimeSec(),
-             disconnect_count_,
-             reconnect_attempts_);
-    
+
+    uint32_t now = k_uptime_get_32();
+    uint32_t downtime_ms = total_downtime_ms_;
+    bool link_up = (network_connect_time_ != 0 && last_link_down_time_ == 0);
+
+    if (last_link_down_time_ != 0) {
+        downtime_ms += now - last_link_down_time_;
+    }
+
+    snapshot.health = current_health_;
+    snapshot.rssi_q4 = estimator_.getRssiQ4();
+    snapshot.lqi_q4 = estimator_.getLqiQ4();
+    snapshot.flags = (link_up ? HEALTH_FLAG_LINK_UP : 0) |
+                     (estimator_.hasLink() ? HEALTH_FLAG_SAMPLED : 0);
+    snapshot.loss_permille = loss_permille_;
+    snapshot.uptime_s = (now - boot_time_) / 1000;
+    snapshot.connected_s = link_up ? (now - network_connect_time_) / 1000 : 0;
+    snapshot.downtime_s = base_downtime_s_ + downtime_ms / 1000;
+    snapshot.disconnects = disconnect_count_;
+    snapshot.reconnects = reconnect_attempts_;
+
     k_mutex_unlock(&stats_mutex_);
-    
-    return report;
+}
+
+int NetworkResilienceManager::encodeHealthRecord(const HealthSnapshot& snapshot,
+                                                 uint8_t* buf, size_t len) {
+    if (len < HEALTH_RECORD_SIZE) {
+        return -ENOBUFS;
+    }
+
+    buf[0] = HEALTH_RECORD_VERSION;
+    buf[1] = (uint8_t)snapshot.health;
+    sys_put_le16((uint16_t)snapshot.rssi_q4, &buf[2]);
+    buf[4] = snapshot.lqi_q4;
+    buf[5] = snapshot.flags;
+    sys_put_le16(snapshot.loss_permille, &buf[6]);
+    sys_put_le32(snapshot.uptime_s, &buf[8]);
+    sys_put_le32(snapshot.connected_s, &buf[12]);
+    sys_put_le32(snapshot.downtime_s, &buf[16]);
+    sys_put_le16(snapshot.disconnects, &buf[20]);
+    sys_put_le16(snapshot.reconnects, &buf[22]);
+
+    return HEALTH_RECORD_SIZE;
+}
+
+int NetworkResilienceManager::decodeHealthRecord(const uint8_t* buf, size_t len,
+                                                 HealthSnapshot& snapshot) {
+    if (len < HEALTH_RECORD_SIZE) {
+        return -EINVAL;
+    }
+    if (buf[0] != HEALTH_RECORD_VERSION) {
+        return -ENOTSUP;
+    }
+
+    snapshot.health = (NetworkHealth)buf[1];
+    snapshot.rssi_q4 = (int16_t)sys_get_le16(&buf[2]);
+    snapshot.lqi_q4 = buf[4];
+    snapshot.flags = buf[5];
+    snapshot.loss_permille = sys_get_le16(&buf[6]);
+    snapshot.uptime_s = sys_get_le32(&buf[8]);
+    snapshot.connected_s = sys_get_le32(&buf[12]);
+    snapshot.downtime_s = sys_get_le32(&buf[16]);
+    snapshot.disconnects = sys_get_le16(&buf[20]);
+    snapshot.reconnects = sys_get_le16(&buf[22]);
+
+    return 0;
+}
+
+int NetworkResilienceManager::formatHealthReport(const HealthSnapshot& snapshot,
+                                                 char* buf, size_t len) {
+    // Q4 → one decimal without float: |x| / 16 whole, (|x| % 16) * 10 / 16 tenths
+    uint16_t rssi_abs = (snapshot.rssi_q4 < 0) ? -snapshot.rssi_q4 : snapshot.rssi_q4;
+
+    if (!(snapshot.flags & HEALTH_FLAG_SAMPLED)) {
+        return snprintf(buf, len,
+                        "Health: %s | RSSI: n/a | Loss: %u.%u%% | "
+                        "Uptime: %u s | Connected: %u s | Downtime: %u s | "
+                        "Disconnects: %u | Reconnects: %u",
+                        healthName(snapshot.health),
+                        snapshot.loss_permille / 10, snapshot.loss_permille % 10,
+                        snapshot.uptime_s, snapshot.connected_s, snapshot.downtime_s,
+                        snapshot.disconnects, snapshot.reconnects);
+    }
+
+    return snprintf(buf, len,
+                    "Health: %s | RSSI: %s%u.%u dBm | LQI: %u.%u | Loss: %u.%u%% | "
+                    "Uptime: %u s | Connected: %u s | Downtime: %u s | "
+                    "Disconnects: %u | Reconnects: %u",
+                    healthName(snapshot.health),
+                    (snapshot.rssi_q4 < 0) ? "-" : "",
+                    rssi_abs >> 4, ((rssi_abs & 0xF) * 10U) >> 4,
+                    snapshot.lqi_q4 >> 4, ((snapshot.lqi_q4 & 0xFU) * 10U) >> 4,
+                    snapshot.loss_permille / 10, snapshot.loss_permille % 10,
+                    snapshot.uptime_s, snapshot.connected_s, snapshot.downtime_s,
+                    snapshot.disconnects, snapshot.reconnects);
 }
 
 }  // namespace thread
@@ -7,8 +7,16 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <zephyr/kernel.h>
+#include "link_quality_estimator.hpp"
+#include "parent_failover.hpp"
+#include "timer/timer_wheel.hpp"
+
+#ifdef CONFIG_APP_NET_STATS
+#include "persist/checkpoint_ring.hpp"
+#endif
 
 namespace smarthome { namespace protocol { namespace thread {
 
@@ -23,6 +31,31 @@ enum class NetworkHealth : uint8_t {
     EXCELLENT = 4      ///< Optimal network conditions
 };
 
+/**
+ * Health snapshot flags
+ */
+constexpr uint8_t HEALTH_FLAG_LINK_UP = 1U << 0;    ///< Attached, no outage running
+constexpr uint8_t HEALTH_FLAG_SAMPLED = 1U << 1;    ///< RSSI/LQI hold a real sample
+
+/**
+ * Point-in-time health metrics, all fixed point
+ */
+struct HealthSnapshot {
+    NetworkHealth health;
+    int16_t rssi_q4;            ///< Smoothed RSSI, 1/16 dBm
+    uint8_t lqi_q4;             ///< Smoothed LQI, 1/16 step (0-48)
+    uint8_t flags;              ///< HEALTH_FLAG_*
+    uint16_t loss_permille;     ///< MAC packet loss, 1/1000
+    uint32_t uptime_s;
+    uint32_t connected_s;       ///< Since the last link up
+    uint32_t downtime_s;        ///< Lifetime, including an outage in progress
+    uint16_t disconnects;       ///< Lifetime (persisted with CONFIG_APP_NET_STATS)
+    uint16_t reconnects;        ///< Lifetime
+};
+
+constexpr uint8_t HEALTH_RECORD_VERSION = 1;
+constexpr size_t HEALTH_RECORD_SIZE = 24;
+
 /**
  * Network Resilience Manager
  * 
@@ -47,12 +80,14 @@ public:
     /**
      * Initialize resilience manager
      * 
-     * TODO:
-     *  1. Initialize health monitoring state
-     *  2. Setup periodic health check timer
-     *  3. Initialize statistics counters
-     *  4. Register with Thread network manager
-     *  5. Load previous statistics from NVS (uptime, disconnects, etc.)
+     * Starts the link sampling timer (NETWORK_HEALTH_CHECK_INTERVAL_SEC).
+     * Each tick queues a sample on the system work queue: parent RSSI/LQI
+     * and MAC counters from ThreadNetworkManager feed the
+     * LinkQualityEstimator, then the health class is re-evaluated.
+     * 
+     * With CONFIG_APP_NET_STATS, lifetime counters (disconnects,
+     * reconnects, downtime, uptime, boots) are restored from the newest
+     * checkpoint on net_stats_partition.
      */
     int init();
 
@@ -61,6 +96,7 @@ public:
      * 
      * @param callback Function to call when health status changes
      *                 Parameter: new NetworkHealth status
+     * @note Called from the system work queue, never under stats_mutex_
      */
     using HealthChangeCallback = void (*)(NetworkHealth);
     void setHealthCallback(HealthChangeCallback callback);
@@ -69,6 +105,7 @@ public:
      * Register callback for disconnection events
      * 
      * @param callback Function to call when network disconnects
+     * @note Called from the system work queue
      */
     using DisconnectCallback = void (*)(void);
     void setDisconnectCallback(DisconnectCallback callback);
@@ -76,16 +113,16 @@ public:
     /**
      * Check current network health
      * 
+     * Classifies the smoothed link metrics (see LinkQualityEstimator):
+     *  - RSSI < -95dBm → POOR
+     *  - RSSI -95 to -80dBm → FAIR
+     *  - RSSI -80 to -65dBm → GOOD
+     *  - RSSI >= -65dBm → EXCELLENT
+     *  - Packet loss > 10% → one class lower
+     * A change queues the health callback.
+     * 
      * TODO:
-     *  1. Query Thread network for link quality (RSSI)
-     *  2. Measure packet loss rate
-     *  3. Check neighbor count and routing tables
-     *  4. Determine health level:
-     *     - RSSI < -95dBm → POOR
-     *     - RSSI -95 to -80dBm → FAIR
-     *     - RSSI -80 to -65dBm → GOOD
-     *     - RSSI > -65dBm → EXCELLENT
-     *  5. Return calculated health status
+     *  1. Check neighbor count and routing tables
      */
     NetworkHealth updateHealth();
 
@@ -94,21 +131,39 @@ public:
      */
     NetworkHealth getHealth() const { return current_health_; }
 
+    /**
+     * Get smoothed RSSI in dBm (0 before the first sample)
+     */
+    int8_t getRssi() const { return current_rssi_; }
+
+    /**
+     * Get packet loss over the sampling window, in 1/1000
+     */
+    uint16_t getPacketLossPermille() const { return loss_permille_; }
+
     /**
      * Get health status name (for logging)
      */
     const char* getHealthName() const;
 
+    /**
+     * Get proactive parent switching counters and recovery times
+     * 
+     * While a child stays POOR for PARENT_SWITCH_POOR_WINDOW_MS the manager
+     * starts a better-parent search, and OpenThread moves to a better
+     * responder without detaching. The time from POOR onset until health
+     * recovers is recorded and logged against LINK_DOWN_TIMEOUT_MS.
+     */
+    ParentFailover::Stats getFailoverStats();
+
     /**
      * Handle network link down event
      * 
      * Called by Thread manager when link goes down
      * 
-     * TODO:
-     *  1. Record timestamp of link down
-     *  2. Start link down timeout timer
-     *  3. Update health to POOR
-     *  4. Trigger disconnect callbacks
+     * Health drops to POOR and the disconnect callback runs from the work
+     * queue. If the link is still down after LINK_DOWN_TIMEOUT_MS, a rejoin
+     * is scheduled and counted in getReconnectAttempts().
      */
     void onLinkDown();
 
@@ -117,12 +172,8 @@ public:
      * 
      * Called by Thread manager when link recovers
      * 
-     * TODO:
-     *  1. Record recovery timestamp
-     *  2. Calculate downtime duration
-     *  3. Update disconnect statistics
-     *  4. Clear link down timer
-     *  5. Restart health monitoring
+     * Closes the outage into the downtime total, stops the link down
+     * timeout and samples the (possibly new) link at once.
      */
     void onLinkUp();
 
@@ -161,57 +212,126 @@ public:
     uint16_t getReconnectAttempts() const { return reconnect_attempts_; }
 
     /**
-     * Save statistics to NVS for persistence
+     * Get uptime summed over all boots (restored + this boot), in seconds
+     */
+    uint32_t getLifetimeUptimeSec() const;
+
+    /**
+     * Get number of boots recorded in the persisted statistics
+     */
+    uint16_t getBootCount() const { return boot_count_; }
+
+    /**
+     * Checkpoint statistics to flash now
      * 
-     * TODO:
-     *  1. Write disconnect count to NVS
-     *  2. Write reconnect attempts to NVS
-     *  3. Write last disconnection time to NVS
+     * Writes one NetStatsRecord to the next slot of the checkpoint ring.
+     * Normally driven by the checkpoint work item: every
+     * CONFIG_APP_NET_STATS_CHECKPOINT_INTERVAL_MIN, or early after a
+     * disconnect/reconnect (rate limited to
+     * CONFIG_APP_NET_STATS_MIN_WRITE_INTERVAL_SEC).
+     * 
+     * @return 0 on success, -ENOTSUP without CONFIG_APP_NET_STATS,
+     *         -ENODEV if no stats partition is available
      */
     int saveStatistics();
 
     /**
-     * Reset all statistics
-     * 
-     * TODO:
-     *  1. Clear disconnect counter
-     *  2. Clear reconnection attempts
-     *  3. Reset uptime tracking
+     * Reset all statistics, including the persisted lifetime counters
      */
     void resetStatistics();
 
     /**
-     * Get detailed health report
+     * Take a consistent copy of the health metrics
      * 
-     * Returns formatted string with:
-     *  - Current health status
-     *  - RSSI value
-     *  - Uptime
-     *  - Disconnect count
-     *  - Last disconnect duration
-     *  - Neighbor count
+     * All values are integers (RSSI/LQI in Q4, loss in 1/1000), captured
+     * together under stats_mutex_.
+     */
+    void getSnapshot(HealthSnapshot& snapshot);
+
+    /**
+     * Encode a snapshot as a HEALTH_RECORD_SIZE byte little-endian record
      * 
-     * TODO:
-     *  1. Query all health metrics
-     *  2. Format as human-readable string
-     *  3. Return for logging/display
+     * Layout (offset: field):
+     *   0: version   1: health    2: rssi_q4 (s16)   4: lqi_q4   5: flags
+     *   6: loss_permille (u16)    8: uptime_s (u32)  12: connected_s (u32)
+     *  16: downtime_s (u32)      20: disconnects (u16) 22: reconnects (u16)
+     * 
+     * Fits one IPC message payload; also used for BLE/MQTT export.
+     * 
+     * @return HEALTH_RECORD_SIZE, or -ENOBUFS if len is too small
+     */
+    static int encodeHealthRecord(const HealthSnapshot& snapshot, uint8_t* buf, size_t len);
+
+    /**
+     * Decode a record produced by encodeHealthRecord()
+     * 
+     * @return 0 on success, -EINVAL if truncated, -ENOTSUP for another version
      */
-    const char* getHealthReport();
+    static int decodeHealthRecord(const uint8_t* buf, size_t len, HealthSnapshot& snapshot);
+
+    /**
+     * Render a snapshot as one human-readable line
+     * 
+     * Integer formatting only, into a caller-provided buffer, so it is
+     * reentrant and needs no float printf support. Output is always
+     * NUL-terminated when len > 0.
+     * 
+     * @return Length of the full line (as snprintf); >= len means truncated
+     */
+    static int formatHealthReport(const HealthSnapshot& snapshot, char* buf, size_t len);
+
+    /**
+     * Get name of a health status (for logging)
+     */
+    static const char* healthName(NetworkHealth health);
 
 private:
     NetworkResilienceManager();
     ~NetworkResilienceManager();
 
+    void sampleLink();
+    static void healthCheckTimerHandler(services::timer::WheelTimer& timer, void* user_data);
+    static void linkDownTimeoutHandler(services::timer::WheelTimer& timer, void* user_data);
+    static void sampleWorkHandler(struct k_work* work);
+    static void notifyWorkHandler(struct k_work* work);
+    static void disconnectWorkHandler(struct k_work* work);
+    static void checkpointWorkHandler(struct k_work* work);
+    static void onParentCandidate(uint16_t rloc16, int8_t margin_db);
+    void runFailover(NetworkHealth health, int8_t parent_margin);
+
+    /**
+     * Persisted lifetime counters (one checkpoint ring slot)
+     */
+    struct NetStatsRecord {
+        uint8_t version;
+        uint8_t reserved;
+        uint16_t boot_count;
+        uint16_t disconnects;
+        uint16_t reconnects;
+        uint32_t uptime_s;
+        uint32_t downtime_s;
+    };
+    static constexpr uint8_t NET_STATS_VERSION = 1;
+
+    void loadStatistics();
+    void requestCheckpoint();
+
     // Health tracking
     NetworkHealth current_health_ = NetworkHealth::UNKNOWN;
     int8_t current_rssi_ = 0;
-    float current_packet_loss_ = 0.0f;
+    uint16_t loss_permille_ = 0;
+    LinkQualityEstimator estimator_;
+    ParentFailover failover_;
+    uint16_t parent_rloc16_ = 0xFFFF;
 
     // Disconnect tracking
     uint16_t disconnect_count_ = 0;
     uint16_t reconnect_attempts_ = 0;
     uint32_t last_link_down_time_ = 0;
-    uint32_t total_downtime_ms_ = 0;
+    uint32_t total_downtime_ms_ = 0;       ///< This boot, closed outages
+    uint32_t base_downtime_s_ = 0;         ///< Restored from previous boots
+    uint32_t base_uptime_s_ = 0;           ///< Restored from previous boots
+    uint16_t boot_count_ = 0;
 
     // Network timing
     uint32_t network_connect_time_ = 0;
@@ -221,9 +341,19 @@ private:
     HealthChangeCallback health_callback_ = nullptr;
     DisconnectCallback disconnect_callback_ = nullptr;
 
-    // Monitoring
-    struct k_timer health_check_timer_;
-    struct k_timer link_down_timeout_timer_;
+    // Monitoring (wheel timer samples; callbacks → notify/disconnect work)
+    services::timer::WheelTimer health_check_timer_;
+    services::timer::WheelTimer link_down_timer_;   ///< LINK_DOWN_TIMEOUT_MS, one-shot
+    struct k_work sample_work_;
+    struct k_work notify_work_;
+    struct k_work disconnect_work_;
+
+    // Persistence (CONFIG_APP_NET_STATS)
+#ifdef CONFIG_APP_NET_STATS
+    services::persist::CheckpointRing stats_ring_;
+#endif
+    struct k_work_delayable checkpoint_work_;
+    uint32_t last_checkpoint_ms_ = 0;
 
     // Synchronization
     struct k_mutex stats_mutex_;
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "parent_failover.hpp"
+#include "network_resilience_manager.hpp"
+#include <string.h>
+
+namespace smarthome { namespace protocol { namespace thread {
+
+/* Time comparisons survive the 32-bit uptime wrap */
+static bool reached(uint32_t now_ms, uint32_t deadline_ms) {
+    return (int32_t)(now_ms - deadline_ms) >= 0;
+}
+
+ParentFailover::ParentFailover()
+    : config_{}
+    , stats_{}
+{
+    reset();
+}
+
+void ParentFailover::init(const Config& config) {
+    config_ = config;
+    memset(&stats_, 0, sizeof(stats_));
+    reset();
+}
+
+void ParentFailover::reset() {
+    in_episode_ = false;
+    searching_ = false;
+    parent_changed_ = false;
+    episode_searches_ = 0;
+    poor_since_ms_ = 0;
+    next_search_ms_ = 0;
+    search_started_ms_ = 0;
+    best_candidate_ = NO_CANDIDATE;
+}
+
+ParentFailover::Action ParentFailover::update(NetworkHealth health, int8_t parent_margin,
+                                              uint32_t now_ms) {
+    if (health != NetworkHealth::POOR) {
+        if (in_episode_ && health != NetworkHealth::UNKNOWN) {
+            uint32_t recovery_ms = now_ms - poor_since_ms_;
+            stats_.recoveries++;
+            stats_.last_recovery_ms = recovery_ms;
+            if (recovery_ms > stats_.max_recovery_ms) {
+                stats_.max_recovery_ms = recovery_ms;
+            }
+            if (parent_changed_) {
+                stats_.parent_switches++;
+            }
+            reset();
+        }
+        return Action::NONE;
+    }
+
+    if (!in_episode_) {
+        in_episode_ = true;
+        poor_since_ms_ = now_ms;
+        next_search_ms_ = now_ms + config_.poor_window_ms;
+        stats_.episodes++;
+        return Action::NONE;
+    }
+
+    if (searching_) {
+        if (!reached(now_ms, search_started_ms_ + config_.search_window_ms)) {
+            return Action::NONE;
+        }
+
+        /* Search over: the stack kept its parent unless it found better */
+        searching_ = false;
+        next_search_ms_ = now_ms + config_.poor_window_ms;
+        return Action::NONE;
+    }
+
+    if (episode_searches_ < config_.max_searches && reached(now_ms, next_search_ms_)) {
+        searching_ = true;
+        search_started_ms_ = now_ms;
+        best_candidate_ = NO_CANDIDATE;
+        episode_searches_++;
+        stats_.searches++;
+        return Action::SEARCH;
+    }
+
+    return Action::NONE;
+}
+
+void ParentFailover::addCandidate(int8_t margin_db) {
+    if (searching_ && margin_db > best_candidate_) {
+        best_candidate_ = margin_db;
+    }
+}
+
+void ParentFailover::onParentChanged() {
+    if (in_episode_) {
+        parent_changed_ = true;
+    }
+}
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Parent Failover - proactive parent switching on sustained POOR health
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace smarthome { namespace protocol { namespace thread {
+
+enum class NetworkHealth : uint8_t;
+
+/**
+ * Parent Failover Policy
+ *
+ * Decides, from the periodic health samples of a child, when to look for
+ * another parent instead of waiting for the link to fail completely:
+ *
+ *   POOR for poor_window_ms ──▶ SEARCH (better-parent search)
+ *        │                         │ the stack moves to a better responder
+ *        │                         ▼ by itself, staying attached meanwhile
+ *        │                  search_window_ms over, still POOR
+ *        │                         │
+ *        └──────── wait another poor_window_ms, at most max_searches
+ *
+ * Candidates heard during a search are kept by link margin for the log;
+ * choosing among them is left to OpenThread, which switches without
+ * detaching from the current parent first.
+ *
+ * An episode ends when health leaves POOR; its duration is the recovery
+ * time, reported against the detach timeout it avoided. Pure logic with
+ * caller-supplied time, so scripted scenarios run without a radio.
+ */
+class ParentFailover {
+public:
+    enum class Action : uint8_t {
+        NONE = 0,
+        SEARCH          ///< Ask the stack for a better parent
+    };
+
+    struct Config {
+        uint32_t poor_window_ms;    ///< POOR this long before searching
+        uint32_t search_window_ms;  ///< Candidate collection time
+        uint8_t max_searches;       ///< Per POOR episode
+    };
+
+    struct Stats {
+        uint16_t episodes;          ///< POOR episodes started
+        uint16_t searches;
+        uint16_t recoveries;        ///< Episodes that ended in better health
+        uint16_t parent_switches;   ///< Recoveries that came with a new parent
+        uint32_t last_recovery_ms;  ///< POOR onset → health above POOR
+        uint32_t max_recovery_ms;
+    };
+
+    /// Reported by candidates that never answered
+    static constexpr int8_t NO_CANDIDATE = INT8_MIN;
+
+    ParentFailover();
+
+    void init(const Config& config);
+
+    /**
+     * Forget the running episode (not a child any more, failover off)
+     */
+    void reset();
+
+    /**
+     * Feed one health sample
+     *
+     * @param health Current health class
+     * @param parent_margin Link margin to the current parent (dB)
+     * @param now_ms Monotonic time
+     * @return Action for the caller to carry out
+     */
+    Action update(NetworkHealth health, int8_t parent_margin, uint32_t now_ms);
+
+    /**
+     * Report a candidate parent heard during a search
+     */
+    void addCandidate(int8_t margin_db);
+
+    /**
+     * The stack attached to a different parent
+     */
+    void onParentChanged();
+
+    bool inEpisode() const { return in_episode_; }
+    bool isSearching() const { return searching_; }
+    int8_t getBestCandidate() const { return best_candidate_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    Config config_;
+    Stats stats_;
+
+    bool in_episode_;
+    bool searching_;
+    bool parent_changed_;
+    uint8_t episode_searches_;
+    uint32_t poor_since_ms_;
+    uint32_t next_search_ms_;
+    uint32_t search_started_ms_;
+    int8_t best_candidate_;
+};
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "poll_scheduler.hpp"
+#include <string.h>
+
+namespace smarthome { namespace protocol { namespace thread {
+
+/* Time comparisons survive the 32-bit uptime wrap */
+static bool reached(uint32_t now_ms, uint32_t deadline_ms) {
+    return (int32_t)(now_ms - deadline_ms) >= 0;
+}
+
+PollScheduler::PollScheduler()
+    : config_{}
+    , stats_{}
+    , fast_(false)
+    , burst_start_ms_(0)
+    , deadline_ms_(0)
+{
+}
+
+void PollScheduler::init(const Config& config) {
+    config_ = config;
+    memset(&stats_, 0, sizeof(stats_));
+    fast_ = false;
+}
+
+bool PollScheduler::requestFastPoll(uint32_t duration_ms, uint32_t now_ms) {
+    if (duration_ms > config_.max_burst_ms) {
+        duration_ms = config_.max_burst_ms;
+    }
+    uint32_t deadline_ms = now_ms + duration_ms;
+
+    if (fast_) {
+        stats_.extensions++;
+        if (!reached(deadline_ms_, deadline_ms)) {
+            deadline_ms_ = deadline_ms;
+        }
+        return false;
+    }
+
+    if (duration_ms == 0 || config_.fast_period_ms >= config_.slow_period_ms) {
+        return false;
+    }
+
+    fast_ = true;
+    burst_start_ms_ = now_ms;
+    deadline_ms_ = deadline_ms;
+    stats_.bursts++;
+    return true;
+}
+
+bool PollScheduler::cancelFastPoll(uint32_t now_ms) {
+    if (!fast_) {
+        return false;
+    }
+    endBurst(now_ms);
+    return true;
+}
+
+bool PollScheduler::update(uint32_t now_ms) {
+    if (!fast_ || !reached(now_ms, deadline_ms_)) {
+        return false;
+    }
+    endBurst(now_ms);
+    return true;
+}
+
+uint32_t PollScheduler::getRemainingMs(uint32_t now_ms) const {
+    if (!fast_ || reached(now_ms, deadline_ms_)) {
+        return 0;
+    }
+    return deadline_ms_ - now_ms;
+}
+
+void PollScheduler::endBurst(uint32_t now_ms) {
+    fast_ = false;
+    stats_.fast_ms += now_ms - burst_start_ms_;
+}
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Poll Scheduler - data poll period of a Sleepy End Device
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace smarthome { namespace protocol { namespace thread {
+
+/**
+ * Sleepy End Device Poll Policy
+ *
+ * A sleepy child keeps its receiver off and polls the parent for queued
+ * frames every slow period. Commissioning and commands need round trips
+ * in well under a second, so they request a fast-poll burst:
+ *
+ *   slow ──requestFastPoll(d)──▶ fast ──deadline reached──▶ slow
+ *                                 │ ▲
+ *                                 └─┘ overlapping requests extend the
+ *                                     deadline, never shorten it
+ *
+ * Pure logic with caller-supplied time, like ParentFailover; the caller
+ * applies getPeriodMs() to the stack whenever a call returns true.
+ */
+class PollScheduler {
+public:
+    struct Config {
+        uint32_t slow_period_ms;    ///< Idle poll period
+        uint32_t fast_period_ms;    ///< Poll period during a burst
+        uint32_t max_burst_ms;      ///< Cap on a single request
+    };
+
+    struct Stats {
+        uint32_t bursts;            ///< Slow → fast transitions
+        uint32_t extensions;        ///< Requests landing in a running burst
+        uint32_t fast_ms;           ///< Time spent fast polling (ended bursts)
+    };
+
+    PollScheduler();
+
+    void init(const Config& config);
+
+    /**
+     * Ask for fast polling for duration_ms from now
+     *
+     * @return true if the poll period changed
+     */
+    bool requestFastPoll(uint32_t duration_ms, uint32_t now_ms);
+
+    /**
+     * End any burst immediately
+     *
+     * @return true if the poll period changed
+     */
+    bool cancelFastPoll(uint32_t now_ms);
+
+    /**
+     * Expire the burst once its deadline is reached
+     *
+     * @return true if the poll period changed
+     */
+    bool update(uint32_t now_ms);
+
+    bool isFastPolling() const { return fast_; }
+    uint32_t getPeriodMs() const { return fast_ ? config_.fast_period_ms : config_.slow_period_ms; }
+
+    /// Time until the burst ends, 0 when slow polling
+    uint32_t getRemainingMs(uint32_t now_ms) const;
+
+    const Config& getConfig() const { return config_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    void endBurst(uint32_t now_ms);
+
+    Config config_;
+    Stats stats_;
+    bool fast_;
+    uint32_t burst_start_ms_;
+    uint32_t deadline_ms_;
+};
+
+}  // namespace thread
+}  // namespace protocol
+}  // namespace smarthome
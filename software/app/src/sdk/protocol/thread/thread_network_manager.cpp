@@ -8,6 +8,16 @@
 #include "network_resilience_manager.hpp"
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <string.h>
+
+#ifdef CONFIG_OPENTHREAD
+#include <openthread/dataset.h>
+#include <openthread/instance.h>
+#include <openthread/ip6.h>
+#include <openthread/link.h>
+#include <openthread/thread.h>
+#include <openthread/platform/radio.h>
+#endif
 
 LOG_MODULE_REGISTER(thread_mgr, CONFIG_LOG_DEFAULT_LEVEL);
 
@@ -20,20 +30,39 @@ ThreadNetworkManager& ThreadNetworkManager::getInstance() {
 
 ThreadNetworkManager::ThreadNetworkManager()
     : current_state_(ThreadState::DISABLED)
-    , rejoin_attempts_(0)
     , last_rejoin_time_(0)
-    , current_rssi_(0)
+    , rx_sensitivity_(DEFAULT_RX_SENSITIVITY_DBM)
 {
     k_mutex_init(&state_mutex_);
-    k_timer_init(&rejoin_timer_, nullptr, nullptr);
-    k_timer_init(&health_check_timer_, nullptr, nullptr);
+    k_mutex_init(&poll_mutex_);
+    k_work_init_delayable(&poll_work_, pollWorkHandler);
+    k_work_init(&fast_poll_work_, fastPollWorkHandler);
+
+    services::retry::RetryPolicy policy = {
+        .initial_delay_ms = matter::INITIAL_RECONNECT_DELAY_MS,
+        .max_delay_ms = matter::MAX_RECONNECT_DELAY_MS,
+        .multiplier_q8 = matter::RECONNECT_BACKOFF_MULTIPLIER_Q8,
+        .max_attempts = matter::MAX_RECONNECT_ATTEMPTS,
+        .full_jitter = true,
+        .equal_jitter = true,
+    };
+    rejoin_.init(policy, onRejoin, this);
+
+#ifdef CONFIG_APP_THREAD_SED
+    PollScheduler::Config poll = {
+        .slow_period_ms = CONFIG_APP_THREAD_SED_SLOW_POLL_MS,
+        .fast_period_ms = CONFIG_APP_THREAD_SED_FAST_POLL_MS,
+        .max_burst_ms = matter::COMMISSIONING_FAST_POLL_MS,
+    };
+    poll_.init(poll);
+#endif
 }
 
 ThreadNetworkManager::~ThreadNetworkManager() {
 }
 
-const char* ThreadNetworkManager::getStateName() const {
-    switch (current_state_) {
+const char* ThreadNetworkManager::stateName(ThreadState state) {
+    switch (state) {
         case ThreadState::DISABLED: return "DISABLED";
         case ThreadState::INITIALIZING: return "INITIALIZING";
         case ThreadState::IDLE: return "IDLE";
@@ -47,6 +76,60 @@ const char* ThreadNetworkManager::getStateName() const {
     }
 }
 
+const char* ThreadNetworkManager::getStateName() const {
+    return stateName(current_state_);
+}
+
+ThreadState ThreadNetworkManager::roleToState(uint8_t role) {
+    /* otDeviceRole values - checked against the OpenThread headers below */
+    switch (role) {
+        case 0: return ThreadState::IDLE;       // OT_DEVICE_ROLE_DISABLED
+        case 1: return ThreadState::JOINING;    // OT_DEVICE_ROLE_DETACHED
+        case 2: return ThreadState::CHILD;      // OT_DEVICE_ROLE_CHILD
+        case 3: return ThreadState::ROUTER;     // OT_DEVICE_ROLE_ROUTER
+        case 4: return ThreadState::LEADER;     // OT_DEVICE_ROLE_LEADER
+        default: return ThreadState::ERROR;
+    }
+}
+
+#ifdef CONFIG_OPENTHREAD
+static_assert(OT_DEVICE_ROLE_DISABLED == 0 && OT_DEVICE_ROLE_DETACHED == 1 &&
+              OT_DEVICE_ROLE_CHILD == 2 && OT_DEVICE_ROLE_ROUTER == 3 &&
+              OT_DEVICE_ROLE_LEADER == 4, "otDeviceRole layout changed");
+
+/* Flags worth waking the application for */
+static constexpr otChangedFlags OT_EVENT_FLAGS =
+    OT_CHANGED_THREAD_ROLE | OT_CHANGED_THREAD_PARTITION_ID |
+    OT_CHANGED_THREAD_RLOC_ADDED | OT_CHANGED_PARENT_LINK_QUALITY;
+#endif
+
+void ThreadNetworkManager::setState(ThreadState new_state) {
+    k_mutex_lock(&state_mutex_, K_FOREVER);
+    ThreadState prev_state = current_state_;
+    current_state_ = new_state;
+    k_mutex_unlock(&state_mutex_);
+
+    if (prev_state == new_state) {
+        return;
+    }
+
+    LOG_INF("Thread state: %s -> %s", stateName(prev_state), stateName(new_state));
+
+    bool was_attached = (prev_state == ThreadState::CHILD ||
+                         prev_state == ThreadState::ROUTER ||
+                         prev_state == ThreadState::LEADER);
+    if (isAttached()) {
+        rejoin_.reset();
+    } else if (was_attached && new_state == ThreadState::JOINING) {
+        /* Lost the parent - OpenThread reattaches on its own, back it up */
+        scheduleNetworkRejoin();
+    }
+
+    if (state_callback_) {
+        state_callback_(new_state);
+    }
+}
+
 int ThreadNetworkManager::init() {
     LOG_INF("=== Initializing Thread Network Manager ===");
     LOG_INF("Channel: %d, PAN ID: 0x%04x", matter::THREAD_CHANNEL, matter::THREAD_PAN_ID);
@@ -57,12 +140,54 @@ int ThreadNetworkManager::init() {
     current_state_ = ThreadState::INITIALIZING;
     k_mutex_unlock(&state_mutex_);
     
-    // OpenThread initialization will be done when CONFIG_OPENTHREAD is available
-    // For now, set state to IDLE to indicate ready for join
-    
-    k_mutex_lock(&state_mutex_, K_FOREVER);
-    current_state_ = ThreadState::IDLE;
-    k_mutex_unlock(&state_mutex_);
+#ifdef CONFIG_OPENTHREAD
+    otInstance* instance = openthread_get_default_instance();
+    if (!instance) {
+        LOG_ERR("No OpenThread instance");
+        setState(ThreadState::ERROR);
+        return -ENODEV;
+    }
+
+    ot_state_cb_.otCallback = onOtStateChanged;
+    ot_state_cb_.user_data = this;
+    int ret = openthread_state_changed_callback_register(&ot_state_cb_);
+    if (ret < 0) {
+        LOG_ERR("Failed to register OpenThread state callback: %d", ret);
+        setState(ThreadState::ERROR);
+        return ret;
+    }
+
+    openthread_mutex_lock();
+
+    /* Commissioned credentials win; otherwise use the build defaults */
+    if (!otDatasetIsCommissioned(instance) &&
+        otThreadGetDeviceRole(instance) == OT_DEVICE_ROLE_DISABLED) {
+        otLinkSetChannel(instance, matter::THREAD_CHANNEL);
+        otLinkSetPanId(instance, matter::THREAD_PAN_ID);
+        otThreadSetNetworkName(instance, matter::THREAD_NETWORK_NAME);
+    }
+
+    otPlatRadioSetTransmitPower(instance, matter::THREAD_TX_POWER);
+    rx_sensitivity_ = otPlatRadioGetReceiveSensitivity(instance);
+    uint8_t role = otThreadGetDeviceRole(instance);
+
+#ifdef CONFIG_APP_THREAD_PARENT_CANDIDATES
+    otThreadRegisterParentResponseCallback(instance, onParentResponse, this);
+#endif
+
+    openthread_mutex_unlock();
+
+#ifdef CONFIG_APP_THREAD_SED
+    /* Before attaching, so the parent learns the mode in the Child ID Request */
+    setSleepy(true);
+#endif
+
+    /* The L2 may already have started Thread from a stored dataset */
+    setState(roleToState(role));
+#else
+    LOG_WRN("Built without CONFIG_OPENTHREAD - Thread stays idle");
+    setState(ThreadState::IDLE);
+#endif
     
     LOG_INF("Thread Network Manager initialized");
     return 0;
@@ -71,59 +196,78 @@ int ThreadNetworkManager::init() {
 int ThreadNetworkManager::startNetworkJoin() {
     LOG_INF("Starting Thread network join");
     
-    if (current_state_ == ThreadState::CHILD ||
-        current_state_ == ThreadState::ROUTER ||
-        current_state_ == ThreadState::LEADER) {
+    if (isAttached()) {
         LOG_INF("Already attached to Thread network");
         return 0;
     }
     
-    k_mutex_lock(&state_mutex_, K_FOREVER);
-    current_state_ = ThreadState::JOINING;
-    k_mutex_unlock(&state_mutex_);
-    
-    // Reset rejoin attempts
-    rejoin_attempts_ = 0;
-    
-    // OpenThread join logic will be added when OpenThread SDK is integrated
-    // otThreadSetEnabled(instance, true);
-    // otIp6SetEnabled(instance, true);
-    
-    LOG_INF("Thread join initiated");
-    
-    // Simulate successful join for testing
-    k_mutex_lock(&state_mutex_, K_FOREVER);
-    current_state_ = ThreadState::CHILD;
-    k_mutex_unlock(&state_mutex_);
+    // Fresh join: restart the backoff
+    rejoin_.reset();
     
-    if (state_callback_) {
-        state_callback_(ThreadState::CHILD);
+    int ret = enableThread(false);
+    if (ret == -EIO) {
+        scheduleNetworkRejoin();
     }
-    
+    return ret;
+}
+
+int ThreadNetworkManager::enableThread(bool restart) {
+#ifdef CONFIG_OPENTHREAD
+    /* Before enabling, so a fast attach event cannot be overwritten */
+    setState(ThreadState::JOINING);
+
+    otInstance* instance = openthread_get_default_instance();
+
+    openthread_mutex_lock();
+    if (restart) {
+        otThreadSetEnabled(instance, false);
+    }
+    otError error = otIp6SetEnabled(instance, true);
+    if (error == OT_ERROR_NONE) {
+        error = otThreadSetEnabled(instance, true);
+    }
+    openthread_mutex_unlock();
+
+    if (error != OT_ERROR_NONE) {
+        LOG_ERR("Failed to enable Thread: %s", otThreadErrorToString(error));
+        setState(ThreadState::ERROR);
+        return -EIO;
+    }
+
+    LOG_INF("Thread join initiated, waiting for attach");
     return 0;
+#else
+    ARG_UNUSED(restart);
+    return -ENOTSUP;
+#endif
 }
 
 int ThreadNetworkManager::leaveNetwork() {
     LOG_INF("Leaving Thread network");
     
-    k_mutex_lock(&state_mutex_, K_FOREVER);
     ThreadState prev_state = current_state_;
-    current_state_ = ThreadState::DETACHING;
-    k_mutex_unlock(&state_mutex_);
     
     // Cancel any pending rejoin
-    k_timer_stop(&rejoin_timer_);
+    rejoin_.reset();
     
-    // OpenThread detach logic
-    // otThreadSetEnabled(instance, false);
-    
-    k_mutex_lock(&state_mutex_, K_FOREVER);
-    current_state_ = ThreadState::IDLE;
-    k_mutex_unlock(&state_mutex_);
-    
-    if (state_callback_ && prev_state != ThreadState::IDLE) {
-        state_callback_(ThreadState::IDLE);
+#ifdef CONFIG_OPENTHREAD
+    setState(ThreadState::DETACHING);
+
+    openthread_mutex_lock();
+    otError error = otThreadSetEnabled(openthread_get_default_instance(), false);
+    openthread_mutex_unlock();
+
+    if (error != OT_ERROR_NONE) {
+        LOG_ERR("Failed to disable Thread: %s", otThreadErrorToString(error));
+        setState(prev_state);
+        return -EIO;
+    }
+    /* IDLE follows with the DISABLED role event */
+#else
+    if (prev_state != ThreadState::IDLE) {
+        setState(ThreadState::IDLE);
     }
+#endif
     
     LOG_INF("Thread network left");
     return 0;
@@ -133,58 +277,494 @@ void ThreadNetworkManager::setStateCallback(StateChangeCallback callback) {
     state_callback_ = callback;
 }
 
+void ThreadNetworkManager::setEventPoster(StateEventPoster poster) {
+    event_poster_ = poster;
+}
+
+#ifdef CONFIG_OPENTHREAD
+void ThreadNetworkManager::onOtStateChanged(otChangedFlags flags, void* user_data) {
+    auto* self = static_cast<ThreadNetworkManager*>(user_data);
+
+    if ((flags & OT_EVENT_FLAGS) == 0) {
+        return;
+    }
+
+    /* OpenThread thread: hand off, do not touch the stack from here */
+    if (self->event_poster_) {
+        self->event_poster_(flags);
+    } else {
+        self->processStateChanged(flags);
+    }
+}
+#endif
+
+void ThreadNetworkManager::processStateChanged(uint32_t flags) {
+#ifdef CONFIG_OPENTHREAD
+    otInstance* instance = openthread_get_default_instance();
+
+    openthread_mutex_lock();
+    uint8_t role = otThreadGetDeviceRole(instance);
+    openthread_mutex_unlock();
+
+    if (flags & OT_CHANGED_THREAD_PARTITION_ID) {
+        LOG_INF("Thread partition changed");
+    }
+
+    setState(roleToState(role));
+#else
+    ARG_UNUSED(flags);
+#endif
+}
+
+int ThreadNetworkManager::readLink(int8_t* rssi, uint8_t* lqi) const {
+#ifdef CONFIG_OPENTHREAD
+    otInstance* instance = openthread_get_default_instance();
+    int ret = -ENOTCONN;
+
+    openthread_mutex_lock();
+
+    switch (otThreadGetDeviceRole(instance)) {
+        case OT_DEVICE_ROLE_CHILD: {
+            otRouterInfo parent;
+            int8_t avg;
+            if (otThreadGetParentInfo(instance, &parent) == OT_ERROR_NONE &&
+                otThreadGetParentAverageRssi(instance, &avg) == OT_ERROR_NONE) {
+                *rssi = avg;
+                *lqi = parent.mLinkQualityIn;
+                ret = 0;
+            }
+            break;
+        }
+        case OT_DEVICE_ROLE_ROUTER:
+        case OT_DEVICE_ROLE_LEADER: {
+            /* No parent: report the best neighbor router link */
+            otNeighborInfoIterator it = OT_NEIGHBOR_INFO_ITERATOR_INIT;
+            otNeighborInfo info;
+            while (otThreadGetNextNeighborInfo(instance, &it, &info) == OT_ERROR_NONE) {
+                if (info.mIsChild) {
+                    continue;
+                }
+                if (ret < 0 || info.mAverageRssi > *rssi) {
+                    *rssi = info.mAverageRssi;
+                    *lqi = info.mLinkQualityIn;
+                    ret = 0;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    openthread_mutex_unlock();
+    return ret;
+#else
+    ARG_UNUSED(rssi);
+    ARG_UNUSED(lqi);
+    return -ENOTSUP;
+#endif
+}
+
 int8_t ThreadNetworkManager::getLinkQuality() const {
-    // OpenThread RSSI query will be added
-    // const otRouterInfo *parentInfo = otThreadGetParent(instance);
-    // if (parentInfo) {
-    //     return parent RSSI value
-    // }
-    return current_rssi_;
+    int8_t rssi = RSSI_NO_LINK;
+    uint8_t lqi = 0;
+    readLink(&rssi, &lqi);
+    return rssi;
+}
+
+uint8_t ThreadNetworkManager::getLinkQualityIndicator() const {
+    int8_t rssi = RSSI_NO_LINK;
+    uint8_t lqi = 0;
+    readLink(&rssi, &lqi);
+    return lqi;
+}
+
+int ThreadNetworkManager::getLinkCounters(LinkCounters& counters) const {
+#ifdef CONFIG_OPENTHREAD
+    openthread_mutex_lock();
+    const otMacCounters* mac = otLinkGetCounters(openthread_get_default_instance());
+    counters.tx_ack_requested = mac->mTxAckRequested;
+    counters.tx_acked = mac->mTxAcked;
+    counters.tx_retry = mac->mTxRetry;
+    openthread_mutex_unlock();
+    return 0;
+#else
+    ARG_UNUSED(counters);
+    return -ENOTSUP;
+#endif
+}
+
+/*=============================================================================
+ * Parent Selection
+ *===========================================================================*/
+
+uint16_t ThreadNetworkManager::getParentRloc16() const {
+#ifdef CONFIG_OPENTHREAD
+    otInstance* instance = openthread_get_default_instance();
+    uint16_t rloc16 = RLOC16_NONE;
+    otRouterInfo parent;
+
+    openthread_mutex_lock();
+    if (otThreadGetDeviceRole(instance) == OT_DEVICE_ROLE_CHILD &&
+        otThreadGetParentInfo(instance, &parent) == OT_ERROR_NONE) {
+        rloc16 = parent.mRloc16;
+    }
+    openthread_mutex_unlock();
+
+    return rloc16;
+#else
+    return RLOC16_NONE;
+#endif
+}
+
+int ThreadNetworkManager::searchForBetterParent() {
+#ifdef CONFIG_OPENTHREAD
+    otInstance* instance = openthread_get_default_instance();
+
+    otRouterInfo parent;
+    otError error = OT_ERROR_INVALID_STATE;
+
+    openthread_mutex_lock();
+    if (otThreadGetDeviceRole(instance) == OT_DEVICE_ROLE_CHILD &&
+        otThreadGetParentInfo(instance, &parent) == OT_ERROR_NONE) {
+        search_parent_rloc16_ = parent.mRloc16;
+        error = otThreadSearchForBetterParent(instance);
+    }
+    openthread_mutex_unlock();
+
+    if (error == OT_ERROR_INVALID_STATE) {
+        return -EINVAL;
+    }
+    if (error != OT_ERROR_NONE) {
+        LOG_ERR("Parent search failed: %s", otThreadErrorToString(error));
+        return -EIO;
+    }
+
+    LOG_INF("Searching for a better parent");
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
+
+void ThreadNetworkManager::setParentCandidateCallback(ParentCandidateCallback callback) {
+    candidate_callback_ = callback;
+}
+
+#ifdef CONFIG_APP_THREAD_PARENT_CANDIDATES
+void ThreadNetworkManager::onParentResponse(otThreadParentResponseInfo* info, void* user_data) {
+    auto* self = static_cast<ThreadNetworkManager*>(user_data);
+    int8_t margin = (int8_t)MAX(info->mRssi - self->rx_sensitivity_, 0);
+
+    LOG_DBG("Parent candidate 0x%04x: RSSI %d dBm, margin %d dB",
+            info->mRloc16, info->mRssi, margin);
+
+    /* The current parent answers too - only others are candidates */
+    if (self->candidate_callback_ && info->mRloc16 != self->search_parent_rloc16_) {
+        self->candidate_callback_(info->mRloc16, margin);
+    }
+}
+#endif
+
+/*=============================================================================
+ * Sleepy End Device
+ *===========================================================================*/
+
+int ThreadNetworkManager::setSleepy(bool sleepy) {
+#if defined(CONFIG_OPENTHREAD) && defined(CONFIG_APP_THREAD_SED)
+    otInstance* instance = openthread_get_default_instance();
+    uint32_t child_timeout_s = MAX(matter::THREAD_CHILD_TIMEOUT_SEC,
+                                   4 * CONFIG_APP_THREAD_SED_SLOW_POLL_MS / 1000);
+
+    k_mutex_lock(&poll_mutex_, K_FOREVER);
+    if (!sleepy) {
+        poll_.cancelFastPoll(k_uptime_get_32());
+        k_work_cancel_delayable(&poll_work_);
+    }
+
+    openthread_mutex_lock();
+    otLinkModeConfig mode = otThreadGetLinkMode(instance);
+    mode.mRxOnWhenIdle = !sleepy;
+    otError error = otThreadSetLinkMode(instance, mode);
+    if (error == OT_ERROR_NONE && sleepy) {
+        /* The parent must not time us out between two slow polls */
+        otThreadSetChildTimeout(instance, child_timeout_s);
+        error = otLinkSetPollPeriod(instance, poll_.getPeriodMs());
+    }
+#if CONFIG_APP_THREAD_SSED_CSL_PERIOD_MS > 0
+    if (error == OT_ERROR_NONE) {
+        error = otLinkSetCslPeriod(instance, sleepy ? CONFIG_APP_THREAD_SSED_CSL_PERIOD_MS * 1000 : 0);
+    }
+#endif
+    openthread_mutex_unlock();
+
+    if (error == OT_ERROR_NONE) {
+        sleepy_ = sleepy;
+    }
+    k_mutex_unlock(&poll_mutex_);
+
+    if (error != OT_ERROR_NONE) {
+        LOG_ERR("Failed to set link mode: %s", otThreadErrorToString(error));
+        return -EIO;
+    }
+
+    LOG_INF("Link mode: %s, poll period %u ms", sleepy ? "sleepy" : "rx-on-when-idle",
+            getPollPeriodMs());
+    return 0;
+#else
+    return sleepy ? -ENOTSUP : 0;
+#endif
+}
+
+int ThreadNetworkManager::requestFastPoll(uint32_t duration_ms) {
+    int ret = 0;
+
+    if (k_is_in_isr()) {
+        /* Keep the longest of the requests made before the work runs */
+        atomic_val_t pending = atomic_get(&isr_fast_poll_ms_);
+        while ((atomic_val_t)duration_ms > pending &&
+               !atomic_cas(&isr_fast_poll_ms_, pending, (atomic_val_t)duration_ms)) {
+            pending = atomic_get(&isr_fast_poll_ms_);
+        }
+        k_work_submit(&fast_poll_work_);
+        return 0;
+    }
+
+    k_mutex_lock(&poll_mutex_, K_FOREVER);
+    if (sleepy_) {
+        uint32_t now = k_uptime_get_32();
+        if (poll_.requestFastPoll(duration_ms, now)) {
+            ret = applyPollPeriod();
+        }
+        if (poll_.isFastPolling()) {
+            k_work_reschedule(&poll_work_, K_MSEC(poll_.getRemainingMs(now)));
+        }
+    }
+    k_mutex_unlock(&poll_mutex_);
+
+    return ret;
+}
+
+void ThreadNetworkManager::cancelFastPoll() {
+    k_mutex_lock(&poll_mutex_, K_FOREVER);
+    if (poll_.cancelFastPoll(k_uptime_get_32())) {
+        k_work_cancel_delayable(&poll_work_);
+        applyPollPeriod();
+    }
+    k_mutex_unlock(&poll_mutex_);
+}
+
+uint32_t ThreadNetworkManager::getPollPeriodMs() const {
+    return sleepy_ ? poll_.getPeriodMs() : 0;
+}
+
+void ThreadNetworkManager::pollWorkHandler(struct k_work* work) {
+    auto& self = getInstance();
+
+    /* System work queue - the burst deadline passed (or was extended) */
+    k_mutex_lock(&self.poll_mutex_, K_FOREVER);
+    uint32_t now = k_uptime_get_32();
+    if (self.poll_.update(now)) {
+        self.applyPollPeriod();
+    } else if (self.poll_.isFastPolling()) {
+        k_work_reschedule(&self.poll_work_, K_MSEC(self.poll_.getRemainingMs(now)));
+    }
+    k_mutex_unlock(&self.poll_mutex_);
+}
+
+void ThreadNetworkManager::fastPollWorkHandler(struct k_work* work) {
+    auto& self = getInstance();
+
+    /* System work queue - a request made from an ISR */
+    uint32_t duration_ms = (uint32_t)atomic_clear(&self.isr_fast_poll_ms_);
+    if (duration_ms > 0) {
+        self.requestFastPoll(duration_ms);
+    }
+}
+
+int ThreadNetworkManager::applyPollPeriod() {
+#ifdef CONFIG_OPENTHREAD
+    /* poll_mutex_ held */
+    openthread_mutex_lock();
+    otError error = otLinkSetPollPeriod(openthread_get_default_instance(), poll_.getPeriodMs());
+    openthread_mutex_unlock();
+
+    if (error != OT_ERROR_NONE) {
+        LOG_ERR("Failed to set poll period: %s", otThreadErrorToString(error));
+        return -EIO;
+    }
+
+    LOG_DBG("Poll period %u ms", poll_.getPeriodMs());
+#endif
+    return 0;
+}
+
+/*=============================================================================
+ * Diagnostics
+ *===========================================================================*/
+
+int ThreadNetworkManager::collectDiagnostics(DiagSnapshot& snapshot) const {
+#ifdef CONFIG_OPENTHREAD
+    otInstance* instance = openthread_get_default_instance();
+
+    snapshot.parent_rloc16 = RLOC16_NONE;
+    snapshot.parent_rssi = RSSI_NO_LINK;
+    snapshot.partition_id = 0;
+    snapshot.leader_router_id = 0;
+    snapshot.leader_weight = 0;
+    snapshot.data_version = 0;
+    snapshot.stable_data_version = 0;
+    snapshot.neighbor_count = 0;
+    snapshot.route_count = 0;
+    snapshot.neighbors_dropped = 0;
+
+    openthread_mutex_lock();
+
+    otDeviceRole role = otThreadGetDeviceRole(instance);
+    snapshot.role = (uint8_t)role;
+    snapshot.channel = otLinkGetChannel(instance);
+    snapshot.rloc16 = otThreadGetRloc16(instance);
+    memcpy(snapshot.ext_addr, otLinkGetExtendedAddress(instance)->m8, sizeof(snapshot.ext_addr));
+
+    if (role >= OT_DEVICE_ROLE_CHILD) {
+        otLeaderData leader;
+        if (otThreadGetLeaderData(instance, &leader) == OT_ERROR_NONE) {
+            snapshot.partition_id = leader.mPartitionId;
+            snapshot.leader_router_id = leader.mLeaderRouterId;
+            snapshot.leader_weight = leader.mWeighting;
+            snapshot.data_version = leader.mDataVersion;
+            snapshot.stable_data_version = leader.mStableDataVersion;
+        }
+    }
+
+    if (role == OT_DEVICE_ROLE_CHILD) {
+        otRouterInfo parent;
+        if (otThreadGetParentInfo(instance, &parent) == OT_ERROR_NONE) {
+            snapshot.parent_rloc16 = parent.mRloc16;
+        }
+        otThreadGetParentAverageRssi(instance, &snapshot.parent_rssi);
+    }
+
+    otNeighborInfoIterator it = OT_NEIGHBOR_INFO_ITERATOR_INIT;
+    otNeighborInfo neighbor;
+    while (otThreadGetNextNeighborInfo(instance, &it, &neighbor) == OT_ERROR_NONE) {
+        if (snapshot.neighbor_count == DIAG_MAX_NEIGHBORS) {
+            snapshot.neighbors_dropped++;
+            continue;
+        }
+        DiagNeighbor& entry = snapshot.neighbors[snapshot.neighbor_count++];
+        entry.rloc16 = neighbor.mRloc16;
+        entry.avg_rssi = neighbor.mAverageRssi;
+        entry.flags = (neighbor.mIsChild ? DIAG_NEIGHBOR_CHILD : 0) |
+                      (neighbor.mRxOnWhenIdle ? DIAG_NEIGHBOR_RX_ON : 0) |
+                      (neighbor.mLinkQualityIn << DIAG_NEIGHBOR_LQI_SHIFT);
+    }
+
+    /* Routing table only exists on routers */
+    if (role >= OT_DEVICE_ROLE_ROUTER) {
+        uint8_t max_id = otThreadGetMaxRouterId(instance);
+        for (uint8_t id = 0; id <= max_id && snapshot.route_count < DIAG_MAX_ROUTES; id++) {
+            otRouterInfo router;
+            if (otThreadGetRouterInfo(instance, id, &router) != OT_ERROR_NONE ||
+                !router.mAllocated) {
+                continue;
+            }
+            DiagRoute& entry = snapshot.routes[snapshot.route_count++];
+            entry.router_id = router.mRouterId;
+            entry.next_hop = router.mNextHop;
+            entry.path_cost = router.mPathCost;
+            entry.link_quality = router.mLinkQualityIn | (router.mLinkQualityOut << 2);
+        }
+    }
+
+    openthread_mutex_unlock();
+    return 0;
+#else
+    ARG_UNUSED(snapshot);
+    return -ENOTSUP;
+#endif
 }
 
 void ThreadNetworkManager::getNetworkDiagnostics() {
-    LOG_INF("=== Thread Network Diagnostics ===");
-    LOG_INF("State: %s", getStateName());
-    LOG_INF("RSSI: %d dBm", current_rssi_);
-    LOG_INF("Rejoin attempts: %d", rejoin_attempts_);
-    
-    // Additional OpenThread diagnostics:
-    // - Extended address
-    // - Short address (RLOC16)
-    // - Leader data
-    // - Neighbor count
-    // - Route table size
+    LOG_INF("State: %s, rejoin attempts: %u", getStateName(), rejoin_.getAttempts());
+
+    DiagSnapshot snapshot;
+    if (collectDiagnostics(snapshot) < 0) {
+        return;
+    }
+
+    LOG_INF("RLOC16 0x%04x ch %u partition 0x%08x leader %u | parent 0x%04x %d dBm | "
+            "%u neighbors, %u routes",
+            snapshot.rloc16, snapshot.channel, snapshot.partition_id,
+            snapshot.leader_router_id, snapshot.parent_rloc16, snapshot.parent_rssi,
+            snapshot.neighbor_count + snapshot.neighbors_dropped, snapshot.route_count);
 }
 
 int ThreadNetworkManager::scheduleNetworkRejoin() {
-    k_mutex_lock(&state_mutex_, K_FOREVER);
-    rejoin_attempts_++;
-    k_mutex_unlock(&state_mutex_);
-    
-    if (rejoin_attempts_ > matter::MAX_RECONNECT_ATTEMPTS) {
+    int ret = rejoin_.schedule();
+    if (ret == -EALREADY) {
+        return 0;
+    }
+    if (ret == -ETIMEDOUT) {
         LOG_ERR("Max rejoin attempts (%d) reached", matter::MAX_RECONNECT_ATTEMPTS);
-        return -ETIMEDOUT;
+        setState(ThreadState::ERROR);
+        return ret;
     }
-    
-    // Calculate exponential backoff delay
-    uint32_t delay_ms = matter::INITIAL_RECONNECT_DELAY_MS;
-    for (uint8_t i = 1; i < rejoin_attempts_; i++) {
-        delay_ms = (uint32_t)(delay_ms * matter::RECONNECT_BACKOFF_MULTIPLIER);
-        if (delay_ms > matter::MAX_RECONNECT_DELAY_MS) {
-            delay_ms = matter::MAX_RECONNECT_DELAY_MS;
-            break;
-        }
+    if (ret < 0) {
+        LOG_ERR("Failed to schedule rejoin: %d", ret);
+        return ret;
     }
     
-    LOG_INF("Scheduling rejoin attempt %d/%d in %d ms",
-            rejoin_attempts_, matter::MAX_RECONNECT_ATTEMPTS, delay_ms);
+    LOG_INF("Scheduling rejoin attempt %d/%d in %u ms",
+            rejoin_.getAttempts(), matter::MAX_RECONNECT_ATTEMPTS, rejoin_.getLastDelayMs());
     
-    k_timer_start(&rejoin_timer_, K_MSEC(delay_ms), K_NO_WAIT);
     last_rejoin_time_ = k_uptime_get_32();
     
     return 0;
 }
 
+void ThreadNetworkManager::onRejoin(services::retry::RetryScheduler& scheduler, void* user_data) {
+    auto* self = static_cast<ThreadNetworkManager*>(user_data);
+
+    /* System work queue */
+    if (self->isAttached()) {
+        scheduler.reset();
+        return;
+    }
+
+    if (self->stackAttaching()) {
+        /* A restart would abort the MLE attach OpenThread is running */
+        LOG_INF("Rejoin attempt %u skipped, OpenThread is attaching", scheduler.getAttempts());
+    } else {
+        LOG_INF("Rejoin attempt %u", scheduler.getAttempts());
+
+        if (self->enableThread(true) == -ENOTSUP) {
+            return;
+        }
+    }
+
+    /* Next attempt unless the attach event resets the backoff first */
+    self->scheduleNetworkRejoin();
+}
+
+bool ThreadNetworkManager::stackAttaching() {
+#ifdef CONFIG_OPENTHREAD
+    otInstance* instance = openthread_get_default_instance();
+
+    openthread_mutex_lock();
+    otDeviceRole role = otThreadGetDeviceRole(instance);
+    uint16_t attempts = otThreadGetMleCounters(instance)->mAttachAttempts;
+    openthread_mutex_unlock();
+
+    /* Detached, with parent requests sent since the last look */
+    bool attaching = role == OT_DEVICE_ROLE_DETACHED && attempts != attach_attempts_;
+    attach_attempts_ = attempts;
+    return attaching;
+#else
+    return false;
+#endif
+}
+
 int ThreadNetworkManager::scanAndJoin() {
     LOG_INF("Scanning for Thread networks");
     
@@ -200,14 +780,26 @@ void ThreadNetworkManager::setTxPower(int8_t power_dbm) {
     if (power_dbm < -20) power_dbm = -20;
     if (power_dbm > 20) power_dbm = 20;
     
-    // otPlatRadioSetTransmitPower(instance, power_dbm);
+#ifdef CONFIG_OPENTHREAD
+    openthread_mutex_lock();
+    otError error = otPlatRadioSetTransmitPower(openthread_get_default_instance(), power_dbm);
+    openthread_mutex_unlock();
+
+    if (error != OT_ERROR_NONE) {
+        LOG_ERR("Failed to set TX power: %s", otThreadErrorToString(error));
+        return;
+    }
+#endif
     
     LOG_INF("Thread TX power set to %d dBm", power_dbm);
 }
 
 const char* ThreadNetworkManager::getThreadVersion() const {
-    // return otGetVersionString();
-    return "OpenThread 1.3.0";
+#ifdef CONFIG_OPENTHREAD
+    return otGetVersionString();
+#else
+    return "OpenThread (disabled)";
+#endif
 }
 
 }  // namespace thread
@@ -9,6 +9,13 @@
 
 #include <cstdint>
 #include <zephyr/kernel.h>
+#include "retry/retry_scheduler.hpp"
+#include "diag_snapshot.hpp"
+#include "poll_scheduler.hpp"
+
+#ifdef CONFIG_OPENTHREAD
+#include <zephyr/net/openthread.h>
+#endif
 
 namespace smarthome { namespace protocol { namespace thread {
 
@@ -30,6 +37,18 @@ enum class ThreadState : uint8_t {
 /**
  * Thread Network Manager - OpenThread Stack Management
  * 
+ * State changes are event driven: the OpenThread state-changed callback runs
+ * in the OpenThread thread and only forwards the changed flags to the event
+ * poster (the AppTask event queue). processStateChanged() then reads the
+ * device role and parent link from the application thread.
+ * 
+ *   OT role     ThreadState
+ *   DISABLED -> IDLE
+ *   DETACHED -> JOINING (attach in progress)
+ *   CHILD    -> CHILD
+ *   ROUTER   -> ROUTER
+ *   LEADER   -> LEADER
+ * 
  * Responsibilities:
  *  - OpenThread stack initialization
  *  - Thread network join/leave
@@ -51,49 +70,32 @@ public:
     /**
      * Initialize OpenThread stack
      * 
-     * TODO:
-     *  1. Configure OpenThread - set channel, pan ID, network name
-     *  2. Initialize radio subsystem (via RadioManager)
-     *  3. Setup OpenThread callbacks:
-     *     - Link state change callback
-     *     - Role change callback (child/router/leader)
-     *     - Network data callback
-     *  4. Create worker thread for monitoring
-     *  5. Register with CHIP stack connectivity manager
-     *  6. Setup network diagnostics collector
+     * Registers the state-changed callback, applies channel, PAN ID and
+     * network name from chip_config.hpp when no dataset is commissioned and
+     * sets the TX power. Thread itself is started by startNetworkJoin().
+     * 
+     * @return 0 on success, -ENODEV if there is no OpenThread instance
      */
     int init();
 
     /**
      * Start Thread network join process
      * 
-     * @return 0 on success
+     * Enables IPv6 and Thread and moves to JOINING. The attached role is
+     * reported later through the state-changed event, never assumed here.
      * 
-     * TODO:
-     *  1. Check if already attached to Thread
-     *  2. Load Thread network credentials from NVS (if available)
-     *  3. If credentials exist:
-     *     - Restore network config
-     *     - Attempt attach with stored credentials
-     *  4. If no credentials:
-     *     - Wait for CHIP stack to provide credentials (post-commissioning)
-     *  5. Setup join timeout (fail if not attached in 60 seconds)
-     *  6. Update state to JOINING
-     *  7. Start link quality monitoring
+     * @return 0 on success, -EIO if OpenThread refused,
+     *         -ENOTSUP when built without CONFIG_OPENTHREAD
      */
     int startNetworkJoin();
 
     /**
      * Leave Thread network
      * 
-     * @return 0 on success
+     * Cancels a pending rejoin and disables Thread. The state settles on
+     * IDLE once OpenThread reports the DISABLED role.
      * 
-     * TODO:
-     *  1. Stop any pending join attempts
-     *  2. Detach from Thread network
-     *  3. Clear network state
-     *  4. Update state to IDLE
-     *  5. Cancel monitoring timers
+     * @return 0 on success
      */
     int leaveNetwork();
 
@@ -106,6 +108,32 @@ public:
     using StateChangeCallback = void (*)(ThreadState);
     void setStateCallback(StateChangeCallback callback);
 
+    /**
+     * Register the event poster for OpenThread state changes
+     * 
+     * @param poster Called from the OpenThread thread with the changed flags;
+     *               must queue them for processStateChanged(). Without a
+     *               poster the flags are processed in the OpenThread thread.
+     */
+    using StateEventPoster = void (*)(uint32_t flags);
+    void setEventPoster(StateEventPoster poster);
+
+    /**
+     * Process OpenThread state-changed flags
+     * 
+     * Reads the device role and parent link quality and invokes the state
+     * callback on a transition. Call from the thread that drains the event
+     * queue (AppTask::dispatchEvent).
+     * 
+     * @param flags otChangedFlags from the state-changed callback
+     */
+    void processStateChanged(uint32_t flags);
+
+    /**
+     * Map an OpenThread device role (otDeviceRole) to ThreadState
+     */
+    static ThreadState roleToState(uint8_t role);
+
     /**
      * Get current Thread state
      */
@@ -125,46 +153,161 @@ public:
                current_state_ == ThreadState::LEADER;
     }
 
+    /// RSSI reported when there is no parent or neighbor router
+    static constexpr int8_t RSSI_NO_LINK = INT8_MIN;
+
     /**
      * Get link quality indicator (RSSI)
      * 
-     * @return Average RSSI in dBm
+     * As a child this is the average RSSI of the parent; as a router or
+     * leader it is the best average RSSI among neighbor routers.
      * 
-     * TODO:
-     *  1. Query OpenThread for current RSSI
-     *  2. Return average link quality metric
+     * @return Average RSSI in dBm, RSSI_NO_LINK when detached
      */
     int8_t getLinkQuality() const;
 
     /**
-     * Get network diagnostics
+     * Get incoming link quality (LQI) of the same link as getLinkQuality()
      * 
-     * Contains:
-     *  - Extended address (64-bit unique ID)
-     *  - Short address
-     *  - Leader data (leader ID, partition ID, version)
-     *  - Neighbor table
-     *  - Route table
-     *  - Security material version
+     * @return 0 (no link) to 3 (best)
+     */
+    uint8_t getLinkQualityIndicator() const;
+
+    /**
+     * MAC transmit counters (cumulative since boot, wrap at 2^32)
+     */
+    struct LinkCounters {
+        uint32_t tx_ack_requested;  ///< Unicast frames sent with ack request
+        uint32_t tx_acked;          ///< Of those, acknowledged (after retries)
+        uint32_t tx_retry;          ///< MAC retransmissions
+    };
+
+    /**
+     * Read the MAC counters
      * 
-     * TODO:
-     *  1. Query OpenThread diagnostics
-     *  2. Format and return diagnostic info
-     *  3. Include link quality, neighbor count, leader info
+     * @return 0 on success, -ENOTSUP without OpenThread
+     */
+    int getLinkCounters(LinkCounters& counters) const;
+
+    /// RLOC16 reported when there is no parent
+    static constexpr uint16_t RLOC16_NONE = 0xFFFF;
+
+    /// Receive sensitivity assumed without a radio to ask (dBm)
+    static constexpr int8_t DEFAULT_RX_SENSITIVITY_DBM = -100;
+
+    /**
+     * Get RLOC16 of the current parent
+     * 
+     * @return Parent RLOC16, RLOC16_NONE unless attached as a child
+     */
+    uint16_t getParentRloc16() const;
+
+    /**
+     * Get radio receive sensitivity, read once at init
+     * 
+     * Link margin = RSSI - receive sensitivity, as OpenThread computes it.
+     */
+    int8_t getRxSensitivity() const { return rx_sensitivity_; }
+
+    /**
+     * Ask OpenThread to look for a better parent
+     * 
+     * Sends a Parent Request while staying attached; the stack moves to a
+     * responder only if its link is better. Responses are reported through
+     * the parent candidate callback (CONFIG_APP_THREAD_PARENT_CANDIDATES).
+     * 
+     * @return 0 on success, -EINVAL unless a child, -ENOTSUP without
+     *         OpenThread, -EIO on stack error
+     */
+    int searchForBetterParent();
+
+    /**
+     * Register callback for parent candidates heard during a search
+     * 
+     * @param callback Receives the responder's RLOC16 and link margin (dB)
+     * @note Called from the OpenThread thread with the stack lock held
+     */
+    using ParentCandidateCallback = void (*)(uint16_t rloc16, int8_t margin_db);
+    void setParentCandidateCallback(ParentCandidateCallback callback);
+
+    /**
+     * Switch between rx-on-when-idle and Sleepy End Device link mode
+     * 
+     * A sleepy child turns its receiver off and polls the parent every
+     * CONFIG_APP_THREAD_SED_SLOW_POLL_MS (or receives on the CSL schedule
+     * with CONFIG_APP_THREAD_SSED_CSL_PERIOD_MS). init() enters sleepy mode
+     * when CONFIG_APP_THREAD_SED is set.
+     * 
+     * @return 0 on success, -ENOTSUP without SED support, -EIO on stack error
+     */
+    int setSleepy(bool sleepy);
+
+    bool isSleepy() const { return sleepy_; }
+
+    /**
+     * Poll fast for duration_ms (commissioning, commands awaiting replies)
+     * 
+     * Overlapping requests extend the burst; the slow period is restored
+     * from the system work queue when the last one ends. No-op unless sleepy.
+     * 
+     * May be called from an ISR (button callbacks): the request is then
+     * handed to the system work queue, since it takes the poll mutex and
+     * the OpenThread lock.
+     * 
+     * @return 0 on success (or deferred), -EIO on stack error
+     */
+    int requestFastPoll(uint32_t duration_ms);
+
+    /**
+     * End a fast-poll burst early
+     */
+    void cancelFastPoll();
+
+    /**
+     * Current data poll period
+     * 
+     * @return Period in ms, 0 when not sleepy (receiver always on)
+     */
+    uint32_t getPollPeriodMs() const;
+
+    const PollScheduler::Stats& getPollStats() const { return poll_.getStats(); }
+
+    /**
+     * Snapshot identity, leader data, neighbor table and route table
+     * 
+     * Tables are truncated to DIAG_MAX_NEIGHBORS / DIAG_MAX_ROUTES; the
+     * number of neighbors left out is counted in neighbors_dropped.
+     * 
+     * @param snapshot Filled in (uptime_s is left to the caller)
+     * @return 0 on success, -ENOTSUP without OpenThread
+     */
+    int collectDiagnostics(DiagSnapshot& snapshot) const;
+
+    /**
+     * Get network diagnostics
+     * 
+     * Logs a one-line summary of collectDiagnostics() plus the rejoin state.
      */
     void getNetworkDiagnostics();
 
     /**
      * Attempt network rejoin with exponential backoff
      * 
-     * TODO:
-     *  1. Check if link is down
-     *  2. Calculate backoff delay based on attempt count
-     *  3. Schedule rejoin attempt
-     *  4. Cap attempts at MAX_RECONNECT_ATTEMPTS
+     * Arms the rejoin scheduler (jittered backoff, MAX_RECONNECT_ATTEMPTS).
+     * Each attempt restarts Thread from the system work queue and arms the
+     * next one; attaching resets the backoff. An attempt that finds
+     * OpenThread still attaching on its own leaves it running. Called
+     * automatically when an attached device detaches or a join cannot be
+     * started.
+     * 
+     * @return 0 on success (or already pending), -ETIMEDOUT when attempts
+     *         are exhausted
      */
     int scheduleNetworkRejoin();
 
+    /// Rejoin attempts since the last attach (or fresh join)
+    uint8_t getRejoinAttempts() const { return rejoin_.getAttempts(); }
+
     /**
      * Force Thread network scan
      * 
@@ -195,17 +338,45 @@ private:
     ThreadNetworkManager();
     ~ThreadNetworkManager();
 
+    void setState(ThreadState new_state);
+    static const char* stateName(ThreadState state);
+    int readLink(int8_t* rssi, uint8_t* lqi) const;
+    int enableThread(bool restart);
+    static void onRejoin(services::retry::RetryScheduler& scheduler, void* user_data);
+    bool stackAttaching();
+    int applyPollPeriod();
+    static void pollWorkHandler(struct k_work* work);
+    static void fastPollWorkHandler(struct k_work* work);
+
+#ifdef CONFIG_OPENTHREAD
+    static void onOtStateChanged(otChangedFlags flags, void* user_data);
+    struct openthread_state_changed_callback ot_state_cb_;
+#endif
+#ifdef CONFIG_APP_THREAD_PARENT_CANDIDATES
+    static void onParentResponse(otThreadParentResponseInfo* info, void* user_data);
+#endif
+
     ThreadState current_state_ = ThreadState::DISABLED;
     StateChangeCallback state_callback_ = nullptr;
+    StateEventPoster event_poster_ = nullptr;
+    ParentCandidateCallback candidate_callback_ = nullptr;
 
     // Network joining state
-    uint8_t rejoin_attempts_ = 0;
     uint32_t last_rejoin_time_ = 0;
-    struct k_timer rejoin_timer_;
+    services::retry::RetryScheduler rejoin_;
+    uint16_t attach_attempts_ = 0;                  ///< MLE attach counter at the last rejoin
+
+    // Link quality monitoring (RSSI/LQI are read from the stack on demand)
+    int8_t rx_sensitivity_ = DEFAULT_RX_SENSITIVITY_DBM;
+    uint16_t search_parent_rloc16_ = RLOC16_NONE;   ///< Parent when the search began
 
-    // Link quality monitoring
-    int8_t current_rssi_ = 0;
-    struct k_timer health_check_timer_;
+    // Sleepy End Device (poll_mutex_ before the OpenThread lock)
+    bool sleepy_ = false;
+    PollScheduler poll_;
+    struct k_work_delayable poll_work_;
+    struct k_mutex poll_mutex_;
+    struct k_work fast_poll_work_;          ///< Requests made from an ISR
+    atomic_t isr_fast_poll_ms_ = ATOMIC_INIT(0);  ///< Longest pending ISR request
 
     // Synchronization
     struct k_mutex state_mutex_;
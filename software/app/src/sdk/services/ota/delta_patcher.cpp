@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "delta_patcher.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(ota_delta, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace services { namespace ota {
+
+DeltaPatcher::DeltaPatcher()
+    : source_(nullptr)
+    , sink_(nullptr)
+    , user_data_(nullptr)
+    , state_(State::HEADER)
+    , hdr_len_(0)
+    , new_size_(0)
+    , old_size_(0)
+    , produced_(0)
+    , diff_left_(0)
+    , extra_left_(0)
+    , seek_(0)
+    , old_pos_(0)
+{
+}
+
+void DeltaPatcher::begin(DeltaSourceRead source, DeltaSink sink, void* user_data) {
+    source_ = source;
+    sink_ = sink;
+    user_data_ = user_data;
+    state_ = State::HEADER;
+    hdr_len_ = 0;
+    new_size_ = 0;
+    old_size_ = 0;
+    produced_ = 0;
+    diff_left_ = 0;
+    extra_left_ = 0;
+    seek_ = 0;
+    old_pos_ = 0;
+}
+
+/*=============================================================================
+ * Streaming Parser
+ *===========================================================================*/
+
+int DeltaPatcher::feed(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        size_t used = 0;
+        int ret = 0;
+
+        switch (state_) {
+            case State::HEADER:
+                used = collect(data, len, HEADER_SIZE);
+                if (hdr_len_ == HEADER_SIZE) {
+                    ret = parseHeader();
+                }
+                break;
+
+            case State::CONTROL:
+                used = collect(data, len, CONTROL_SIZE);
+                if (hdr_len_ == CONTROL_SIZE) {
+                    ret = parseControl();
+                }
+                break;
+
+            case State::DIFF:
+                used = MIN(len, (size_t)diff_left_);
+                ret = applyDiff(data, used);
+                break;
+
+            case State::EXTRA:
+                used = MIN(len, (size_t)extra_left_);
+                ret = emitExtra(data, used);
+                break;
+
+            case State::DONE:
+                LOG_WRN("Ignoring %u trailing patch bytes", (unsigned)len);
+                return 0;
+
+            case State::ERROR:
+            default:
+                return -EBADMSG;
+        }
+
+        if (ret < 0) {
+            state_ = State::ERROR;
+            return ret;
+        }
+
+        data += used;
+        len -= used;
+    }
+
+    return 0;
+}
+
+size_t DeltaPatcher::collect(const uint8_t* data, size_t len, size_t want) {
+    size_t take = MIN(len, want - hdr_len_);
+    memcpy(&hdr_buf_[hdr_len_], data, take);
+    hdr_len_ += take;
+    return take;
+}
+
+int DeltaPatcher::parseHeader() {
+    if (sys_get_le32(&hdr_buf_[0]) != MAGIC || hdr_buf_[4] != VERSION) {
+        LOG_ERR("Bad delta header (magic 0x%08x, version %u)",
+                sys_get_le32(&hdr_buf_[0]), hdr_buf_[4]);
+        return -EBADMSG;
+    }
+
+    new_size_ = sys_get_le32(&hdr_buf_[8]);
+    old_size_ = sys_get_le32(&hdr_buf_[12]);
+    hdr_len_ = 0;
+
+    LOG_INF("Delta patch: old %u bytes -> new %u bytes", old_size_, new_size_);
+
+    state_ = (new_size_ == 0) ? State::DONE : State::CONTROL;
+    return 0;
+}
+
+int DeltaPatcher::parseControl() {
+    uint32_t diff_word = sys_get_le32(&hdr_buf_[0]);
+    bool copy = (diff_word & COPY_FLAG) != 0;
+    diff_left_ = diff_word & ~COPY_FLAG;
+    extra_left_ = sys_get_le32(&hdr_buf_[4]);
+    seek_ = (int32_t)sys_get_le32(&hdr_buf_[8]);
+    hdr_len_ = 0;
+
+    /* Reject records that would overrun the declared output size */
+    uint64_t total = (uint64_t)produced_ + diff_left_ + extra_left_;
+    if (total > new_size_) {
+        LOG_ERR("Delta record overruns image (%u + %u + %u > %u)",
+                produced_, diff_left_, extra_left_, new_size_);
+        return -EBADMSG;
+    }
+
+    state_ = State::DIFF;
+    if (copy) {
+        /* Diff bytes are not in the stream, produce the copy right away */
+        return applyDiff(nullptr, diff_left_);
+    }
+    finishRecordIfDone();
+    return 0;
+}
+
+int DeltaPatcher::applyDiff(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        size_t chunk = MIN(len, SCRATCH_SIZE);
+
+        /* Old bytes outside [0, old_size) contribute zero, as in bsdiff */
+        memset(scratch_, 0, chunk);
+        int64_t start = old_pos_;
+        int64_t end = old_pos_ + (int64_t)chunk;
+        int64_t lo = MAX(start, (int64_t)0);
+        int64_t hi = MIN(end, (int64_t)old_size_);
+        if (hi > lo) {
+            int ret = source_(static_cast<uint32_t>(lo), &scratch_[lo - start],
+                              static_cast<size_t>(hi - lo), user_data_);
+            if (ret < 0) {
+                LOG_ERR("Old image read failed at %u: %d", (uint32_t)lo, ret);
+                return ret;
+            }
+        }
+
+        if (data) {
+            for (size_t i = 0; i < chunk; i++) {
+                scratch_[i] = (uint8_t)(scratch_[i] + data[i]);
+            }
+            data += chunk;
+        }
+
+        int ret = sink_(scratch_, chunk, user_data_);
+        if (ret < 0) {
+            return ret;
+        }
+
+        produced_ += chunk;
+        old_pos_ += chunk;
+        diff_left_ -= chunk;
+        len -= chunk;
+    }
+
+    finishRecordIfDone();
+    return 0;
+}
+
+int DeltaPatcher::emitExtra(const uint8_t* data, size_t len) {
+    int ret = sink_(data, len, user_data_);
+    if (ret < 0) {
+        return ret;
+    }
+
+    produced_ += len;
+    extra_left_ -= len;
+
+    finishRecordIfDone();
+    return 0;
+}
+
+void DeltaPatcher::finishRecordIfDone() {
+    if (state_ == State::DIFF && diff_left_ == 0) {
+        state_ = State::EXTRA;
+    }
+
+    if (state_ == State::EXTRA && extra_left_ == 0) {
+        old_pos_ += seek_;
+        state_ = (produced_ >= new_size_) ? State::DONE : State::CONTROL;
+    }
+}
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * DELTA PATCHER - Streaming bsdiff-style Image Reconstruction
+ * ============================================================================
+ *
+ * Purpose:
+ *   Rebuilds a new firmware image from the running (primary slot) image and
+ *   a delta patch, one HTTP fragment at a time. The patch is never buffered
+ *   as a whole: control records are parsed incrementally and the produced
+ *   bytes are handed straight to a sink (normally OtaImageWriter).
+ *
+ * Patch Format (little-endian, uncompressed bsdiff control/diff/extra):
+ *   Header  (16 bytes): magic "SHDL" | version u8 | reserved[3] |
+ *                       new_size u32 | old_size u32
+ *   Record  (repeated until new_size bytes are produced):
+ *     control (12 bytes): diff_len u32 | extra_len u32 | seek s32
+ *     diff_len bytes    : new[i] = old[old_pos + i] + diff[i]
+ *                         (omitted when diff_len has COPY_FLAG set: the
+ *                          old bytes are copied unchanged)
+ *     extra_len bytes   : copied verbatim into new image
+ *     old_pos += diff_len + seek
+ *
+ * Memory:
+ *   - 256 byte scratch buffer for old-image reads
+ *   - No dynamic allocation
+ *
+ * Generate patches with scripts/ota_tool.py diff.
+ */
+
+#ifndef OTA_DELTA_PATCHER_HPP
+#define OTA_DELTA_PATCHER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace smarthome { namespace services { namespace ota {
+
+/**
+ * @brief Receives reconstructed image bytes
+ * @return 0 on success, negative errno to abort patching
+ */
+using DeltaSink = int (*)(const uint8_t* data, size_t len, void* user_data);
+
+/**
+ * @brief Reads bytes of the old (currently running) image
+ * @return 0 on success, negative errno on failure
+ */
+using DeltaSourceRead = int (*)(uint32_t offset, uint8_t* buf, size_t len, void* user_data);
+
+class DeltaPatcher {
+public:
+    static constexpr uint32_t MAGIC = 0x4C444853;      // "SHDL"
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t CONTROL_SIZE = 12;
+    static constexpr size_t SCRATCH_SIZE = 256;
+    static constexpr uint32_t COPY_FLAG = 0x80000000;  // diff_len: all-zero diff, not sent
+
+    DeltaPatcher();
+
+    /**
+     * @brief Reset parser state for a new patch
+     * @param source Reader for the old image
+     * @param sink Consumer of reconstructed bytes
+     * @param user_data Passed through to source and sink
+     */
+    void begin(DeltaSourceRead source, DeltaSink sink, void* user_data);
+
+    /**
+     * @brief Feed the next fragment of patch data
+     * @return 0 on success, -EBADMSG on malformed patch, or sink/source error
+     */
+    int feed(const uint8_t* data, size_t len);
+
+    /**
+     * @brief True once new_size bytes have been produced
+     */
+    bool isComplete() const { return state_ == State::DONE; }
+
+    /**
+     * @brief Size of the reconstructed image (valid after header parsed)
+     */
+    uint32_t getNewSize() const { return new_size_; }
+
+    /**
+     * @brief Number of reconstructed bytes handed to the sink
+     */
+    uint32_t getBytesProduced() const { return produced_; }
+
+private:
+    enum class State : uint8_t {
+        HEADER = 0,
+        CONTROL = 1,
+        DIFF = 2,
+        EXTRA = 3,
+        DONE = 4,
+        ERROR = 5
+    };
+
+    /* Accumulate fixed-size header/control bytes; returns bytes consumed */
+    size_t collect(const uint8_t* data, size_t len, size_t want);
+
+    int parseHeader();
+    int parseControl();
+    int applyDiff(const uint8_t* data, size_t len);
+    int emitExtra(const uint8_t* data, size_t len);
+    void finishRecordIfDone();
+
+    DeltaSourceRead source_;
+    DeltaSink sink_;
+    void* user_data_;
+
+    State state_;
+    uint8_t hdr_buf_[HEADER_SIZE];
+    size_t hdr_len_;
+
+    uint32_t new_size_;
+    uint32_t old_size_;
+    uint32_t produced_;
+
+    /* Current control record */
+    uint32_t diff_left_;
+    uint32_t extra_left_;
+    int32_t seek_;
+    int64_t old_pos_;
+
+    uint8_t scratch_[SCRATCH_SIZE];
+};
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
+
+#endif  // OTA_DELTA_PATCHER_HPP
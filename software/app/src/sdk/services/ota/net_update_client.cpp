@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "net_update_client.hpp"
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(net_update_client, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace services { namespace ota {
+
+using ipc::IPCCore;
+using ipc::Message;
+using ipc::MessageBuilder;
+using ipc::MessageType;
+
+NetUpdateClient& NetUpdateClient::getInstance() {
+    static NetUpdateClient instance;
+    return instance;
+}
+
+NetUpdateClient::NetUpdateClient()
+    : image_{}
+    , phase_(netdfu::Phase::IDLE)
+    , progress_callback_(nullptr)
+    , stats_{}
+    , acked_offset_(0)
+    , rewind_offset_(0)
+    , rewind_pending_(false)
+    , remote_error_(0)
+    , epoch_(ATOMIC_INIT(0))
+    , cancel_requested_(false)
+    , reply_type_(MessageType::NET_DFU_STATUS)
+    , reply_result_(0)
+    , thread_started_(false)
+{
+    k_sem_init(&reply_sem_, 0, 1);
+    k_sem_init(&credits_, netdfu::WINDOW, netdfu::WINDOW);
+    k_sem_init(&start_sem_, 0, 1);
+}
+
+/*=============================================================================
+ * Public API
+ *===========================================================================*/
+
+int NetUpdateClient::init() {
+    IPCCore::getInstance().registerCallback(MessageType::NET_DFU_STATUS, onStatus);
+
+    if (!thread_started_) {
+        k_thread_create(&thread_, stack_, K_KERNEL_STACK_SIZEOF(stack_),
+                        threadEntry, this, nullptr, nullptr,
+                        K_PRIO_PREEMPT(10), 0, K_NO_WAIT);
+        k_thread_name_set(&thread_, "net_update");
+        thread_started_ = true;
+    }
+
+    LOG_INF("NET update client ready");
+    return 0;
+}
+
+int NetUpdateClient::start(const NetUpdateImage& image) {
+    if (!image.source || image.size == 0) {
+        return -EINVAL;
+    }
+
+    if (phase_ == netdfu::Phase::RECEIVING || phase_ == netdfu::Phase::VERIFYING) {
+        return -EBUSY;
+    }
+
+    /* NET image built without CONFIG_APP_NET_UPDATE: fail now, not on a timeout */
+    if (!IPCCore::getInstance().peerSupports(MessageType::NET_DFU_BEGIN) ||
+        IPCCore::getInstance().maxLargePayload() < netdfu::CHUNK_SIZE) {
+        return -ENOTSUP;
+    }
+
+    image_ = image;
+    cancel_requested_ = false;
+    phase_ = netdfu::Phase::RECEIVING;
+    k_sem_give(&start_sem_);
+    return 0;
+}
+
+void NetUpdateClient::cancel() {
+    cancel_requested_ = true;
+}
+
+/*=============================================================================
+ * Transfer Thread
+ *===========================================================================*/
+
+void NetUpdateClient::threadEntry(void* p1, void* p2, void* p3) {
+    static_cast<NetUpdateClient*>(p1)->threadLoop();
+}
+
+void NetUpdateClient::threadLoop() {
+    while (1) {
+        k_sem_take(&start_sem_, K_FOREVER);
+        runTransfer();
+    }
+}
+
+int NetUpdateClient::runTransfer() {
+    memset(&stats_, 0, sizeof(stats_));
+    acked_offset_ = 0;
+    rewind_pending_ = false;
+    remote_error_ = 0;
+    atomic_set(&epoch_, 0);
+
+    /* Full window for the new session */
+    k_sem_reset(&credits_);
+    for (uint8_t i = 0; i < netdfu::WINDOW; i++) {
+        k_sem_give(&credits_);
+    }
+
+    LOG_INF("Sending NET image: %u bytes (%u byte chunks, window %u)",
+            image_.size, (unsigned)netdfu::CHUNK_SIZE, netdfu::WINDOW);
+
+    uint32_t start_ms = k_uptime_get_32();
+    setPhase(netdfu::Phase::RECEIVING);
+
+    int ret = sendBegin();
+    if (ret == 0) {
+        ret = sendChunks();
+    }
+    if (ret == 0) {
+        setPhase(netdfu::Phase::VERIFYING);
+        ret = sendEnd();
+    }
+
+    stats_.elapsed_ms = k_uptime_get_32() - start_ms;
+    if (stats_.elapsed_ms > 0) {
+        stats_.throughput_bps = (uint32_t)(((uint64_t)acked_offset_ * 1000U) / stats_.elapsed_ms);
+    }
+
+    if (ret < 0) {
+        LOG_ERR("NET update failed: %d at %u/%u bytes", ret, acked_offset_, image_.size);
+        /* Best effort - NET drops its session */
+        IPCCore::getInstance().send(MessageBuilder(MessageType::NET_DFU_ABORT).build());
+        setPhase(netdfu::Phase::ERROR);
+        return ret;
+    }
+
+    LOG_INF("NET image sent: %u bytes in %u ms (%u B/s)",
+            image_.size, stats_.elapsed_ms, stats_.throughput_bps);
+    LOG_INF("  chunks %u, retransmits %u, rewinds %u, timeouts %u, credit wait %u ms",
+            stats_.chunks_sent, stats_.retransmits, stats_.rewinds,
+            stats_.timeouts, stats_.credit_wait_ms);
+
+    setPhase(netdfu::Phase::READY);
+    return 0;
+}
+
+int NetUpdateClient::sendBegin() {
+    netdfu::BeginInfo info;
+    info.image_size = image_.size;
+    memcpy(info.sha256, image_.sha256, SHA256_LEN);
+
+    reply_type_ = MessageType::NET_DFU_BEGIN;
+    k_sem_reset(&reply_sem_);
+
+    auto header = MessageBuilder(MessageType::NET_DFU_BEGIN)
+                    .setPriority(ipc::Priority::HIGH)
+                    .build();
+
+    int ret = IPCCore::getInstance().sendLarge(header, &info, sizeof(info));
+    if (ret < 0) {
+        return ret;
+    }
+
+    return awaitReply(MessageType::NET_DFU_BEGIN, CONFIG_APP_NET_UPDATE_CHUNK_TIMEOUT_MS);
+}
+
+int NetUpdateClient::sendChunks() {
+    auto& ipc = IPCCore::getInstance();
+    uint32_t offset = 0;
+    uint32_t sent_max = 0;
+    uint32_t last_acked = 0;
+    uint8_t held = 0;
+    uint8_t retries = 0;
+    uint8_t last_percent = 0;
+
+    while (true) {
+        if (cancel_requested_) {
+            return -ECANCELED;
+        }
+        if (remote_error_ < 0) {
+            return remote_error_;
+        }
+
+        if (rewind_pending_) {
+            rewind_pending_ = false;
+            offset = rewind_offset_;
+            stats_.rewinds++;
+            LOG_WRN("NET requested rewind to %u", offset);
+        }
+
+        /* Progress - reset the retry budget and report */
+        uint32_t acked = acked_offset_;
+        if (acked > last_acked) {
+            last_acked = acked;
+            retries = 0;
+
+            uint8_t percent = (uint8_t)(((uint64_t)acked * 100U) / image_.size);
+            if (percent / 10 != last_percent / 10) {
+                last_percent = percent;
+                LOG_INF("NET update: %u%%", percent);
+            }
+            if (progress_callback_) {
+                progress_callback_(phase_, acked, image_.size);
+            }
+        }
+
+        if (offset < image_.size) {
+            /* Sending again - hand back credits collected while draining */
+            while (held > 0) {
+                k_sem_give(&credits_);
+                held--;
+            }
+        } else if (held == netdfu::WINDOW) {
+            /* Every chunk sent has been answered */
+            if (acked_offset_ >= image_.size) {
+                return 0;
+            }
+            offset = acked_offset_;
+            continue;
+        }
+
+        uint32_t wait_start = k_uptime_get_32();
+        int ret = k_sem_take(&credits_, K_MSEC(CONFIG_APP_NET_UPDATE_CHUNK_TIMEOUT_MS));
+        stats_.credit_wait_ms += k_uptime_get_32() - wait_start;
+
+        if (ret < 0) {
+            stats_.timeouts++;
+            if (++retries > CONFIG_APP_NET_UPDATE_MAX_RETRIES) {
+                return -ETIMEDOUT;
+            }
+            /* Assume frames or answers were lost: restart from the last ack */
+            LOG_WRN("No credit for %d ms, resending from %u",
+                    CONFIG_APP_NET_UPDATE_CHUNK_TIMEOUT_MS, acked_offset_);
+            atomic_inc(&epoch_);
+            k_sem_reset(&credits_);
+            for (uint8_t i = 0; i < netdfu::WINDOW; i++) {
+                k_sem_give(&credits_);
+            }
+            held = 0;
+            offset = acked_offset_;
+            continue;
+        }
+
+        if (offset >= image_.size) {
+            /* Draining: collect the window back */
+            held++;
+            continue;
+        }
+
+        if (rewind_pending_) {
+            k_sem_give(&credits_);
+            continue;
+        }
+
+        size_t len = MIN(netdfu::CHUNK_SIZE, (size_t)(image_.size - offset));
+        ret = image_.source(offset, chunk_buf_, len, image_.user_data);
+        if (ret < 0) {
+            LOG_ERR("Image source read failed at %u: %d", offset, ret);
+            return ret;
+        }
+
+        auto header = MessageBuilder(MessageType::NET_DFU_CHUNK)
+                        .setParam(0, offset)
+                        .setParam(1, (uint32_t)atomic_get(&epoch_))
+                        .build();
+
+        ret = ipc.sendLarge(header, chunk_buf_, len);
+        if (ret < 0) {
+            return ret;
+        }
+
+        if (offset < sent_max) {
+            stats_.retransmits++;
+        }
+        offset += len;
+        sent_max = MAX(sent_max, offset);
+        stats_.chunks_sent++;
+        stats_.bytes_sent += len;
+    }
+}
+
+int NetUpdateClient::sendEnd() {
+    reply_type_ = MessageType::NET_DFU_END;
+    k_sem_reset(&reply_sem_);
+
+    auto msg = MessageBuilder(MessageType::NET_DFU_END)
+                 .setPriority(ipc::Priority::HIGH)
+                 .build();
+
+    int ret = IPCCore::getInstance().send(msg);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* NET flushes the block buffer and finalises the digest */
+    return awaitReply(MessageType::NET_DFU_END, 2 * CONFIG_APP_NET_UPDATE_CHUNK_TIMEOUT_MS);
+}
+
+int NetUpdateClient::awaitReply(MessageType request, uint32_t timeout_ms) {
+    if (k_sem_take(&reply_sem_, K_MSEC(timeout_ms)) < 0) {
+        LOG_ERR("No NET answer to 0x%02x", (uint8_t)request);
+        return -ETIMEDOUT;
+    }
+    return reply_result_;
+}
+
+/*=============================================================================
+ * Status Handling (IPC RX thread)
+ *===========================================================================*/
+
+void NetUpdateClient::onStatus(const Message& msg) {
+    getInstance().handleStatus(msg);
+}
+
+void NetUpdateClient::handleStatus(const Message& msg) {
+    int result = (int32_t)msg.payload.params.param1;
+    uint32_t next_offset = msg.payload.params.param2;
+    MessageType answered = (MessageType)msg.payload.params.param4;
+    uint32_t epoch = msg.payload.params.param5;
+
+    if (answered != MessageType::NET_DFU_CHUNK) {
+        if (answered == reply_type_) {
+            reply_result_ = result;
+            k_sem_give(&reply_sem_);
+        }
+        return;
+    }
+
+    /* NET's expected offset is authoritative whatever the frame's epoch */
+    if ((result == 0 || result == -EILSEQ) && next_offset > acked_offset_) {
+        acked_offset_ = next_offset;
+    }
+
+    if (result == -EILSEQ) {
+        /* Only the first gap report of an epoch triggers a rewind */
+        if (epoch == (uint32_t)atomic_get(&epoch_)) {
+            rewind_offset_ = next_offset;
+            rewind_pending_ = true;
+            atomic_inc(&epoch_);
+        }
+    } else if (result < 0) {
+        remote_error_ = result;
+    }
+
+    k_sem_give(&credits_);
+}
+
+void NetUpdateClient::setPhase(netdfu::Phase phase) {
+    phase_ = phase;
+    if (progress_callback_) {
+        progress_callback_(phase, acked_offset_, image_.size);
+    }
+}
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * NET UPDATE CLIENT - APP Core Side of the IPC Firmware Transfer
+ * ============================================================================
+ *
+ * Purpose:
+ *   Pushes a NET core image to the network core over the IPC large-payload
+ *   path. The image is pulled chunk by chunk from a caller-supplied source
+ *   (e.g. a flash area the OTA download was stored in), so it is never held
+ *   in RAM.
+ *
+ * Flow:
+ *   start() → BEGIN → CHUNK x N (credit window) → END → READY
+ *                                                    ↘ ERROR
+ *
+ * Measurements:
+ *   Elapsed time, throughput, retransmitted chunks and time spent waiting
+ *   for credits are recorded per transfer and logged on completion.
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include "net_update_protocol.hpp"
+
+namespace smarthome { namespace services { namespace ota {
+
+/**
+ * @brief Reads bytes of the NET image to send
+ * @return 0 on success, negative errno on failure
+ */
+using NetImageSource = int (*)(uint32_t offset, uint8_t* buf, size_t len, void* user_data);
+
+/**
+ * @brief Progress callback (called from the client thread)
+ * @param phase Current phase
+ * @param done Bytes acknowledged by the NET core
+ * @param total Image size
+ */
+using NetUpdateProgressCallback = void (*)(netdfu::Phase phase, uint32_t done, uint32_t total);
+
+struct NetUpdateImage {
+    NetImageSource source;
+    void* user_data;
+    uint32_t size;
+    uint8_t sha256[SHA256_LEN];
+};
+
+class NetUpdateClient {
+public:
+    /// Singleton instance getter
+    static NetUpdateClient& getInstance();
+
+    /// Delete copy/move constructors
+    NetUpdateClient(const NetUpdateClient&) = delete;
+    NetUpdateClient& operator=(const NetUpdateClient&) = delete;
+    NetUpdateClient(NetUpdateClient&&) = delete;
+    NetUpdateClient& operator=(NetUpdateClient&&) = delete;
+
+    /**
+     * @brief Register the status handler and start the transfer thread
+     * @return 0 on success
+     */
+    int init();
+
+    /**
+     * @brief Start pushing an image to the NET core
+     * @return 0 if accepted, -EBUSY if a transfer is running, -ENOTSUP if
+     *         the NET core takes no updates
+     */
+    int start(const NetUpdateImage& image);
+
+    /**
+     * @brief Abort the running transfer
+     */
+    void cancel();
+
+    netdfu::Phase getPhase() const { return phase_; }
+
+    void setProgressCallback(NetUpdateProgressCallback callback) { progress_callback_ = callback; }
+
+    /**
+     * @brief Transfer measurements (last transfer)
+     */
+    struct Statistics {
+        uint32_t bytes_sent;        ///< Chunk bytes sent, including resends
+        uint32_t chunks_sent;
+        uint32_t retransmits;       ///< Chunks resent after a rewind or timeout
+        uint32_t rewinds;           ///< -EILSEQ rewinds
+        uint32_t timeouts;          ///< Credit waits that timed out
+        uint32_t credit_wait_ms;    ///< Time blocked on the credit window
+        uint32_t elapsed_ms;        ///< BEGIN sent → END acknowledged
+        uint32_t throughput_bps;    ///< Image bytes per second
+    };
+
+    const Statistics& getStats() const { return stats_; }
+
+private:
+    NetUpdateClient();
+    ~NetUpdateClient() = default;
+
+    static void threadEntry(void* p1, void* p2, void* p3);
+    void threadLoop();
+    int runTransfer();
+    int sendBegin();
+    int sendChunks();
+    int sendEnd();
+    int awaitReply(ipc::MessageType request, uint32_t timeout_ms);
+
+    static void onStatus(const ipc::Message& msg);
+    void handleStatus(const ipc::Message& msg);
+
+    void setPhase(netdfu::Phase phase);
+
+    NetUpdateImage image_;
+    netdfu::Phase phase_;
+    NetUpdateProgressCallback progress_callback_;
+    Statistics stats_;
+
+    /* Updated from the IPC RX thread */
+    volatile uint32_t acked_offset_;
+    volatile uint32_t rewind_offset_;
+    volatile bool rewind_pending_;
+    volatile int remote_error_;
+    atomic_t epoch_;                ///< Bumped on every rewind
+    volatile bool cancel_requested_;
+
+    /* Reply to BEGIN/END */
+    ipc::MessageType reply_type_;
+    int reply_result_;
+    struct k_sem reply_sem_;
+
+    struct k_sem credits_;
+    struct k_sem start_sem_;
+    uint8_t chunk_buf_[netdfu::CHUNK_SIZE];
+
+    struct k_thread thread_;
+    bool thread_started_;
+    K_KERNEL_STACK_MEMBER(stack_, 2048);
+};
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
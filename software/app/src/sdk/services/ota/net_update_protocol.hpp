@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * NET UPDATE PROTOCOL - APP → NET Firmware Transfer over IPC
+ * ============================================================================
+ *
+ * Messages (MessageType::NET_DFU_*):
+ *   BEGIN  (large, APP→NET): data = BeginInfo {image_size, sha256}
+ *   CHUNK  (large, APP→NET): params.param1 = offset, param2 = epoch,
+ *                            data = up to CHUNK_SIZE image bytes
+ *   END    (small, APP→NET): flush + verify digest
+ *   ABORT  (small, APP→NET): drop session
+ *   STATUS (small, NET→APP): one per request, see StatusParams
+ *
+ * Flow Control:
+ *   Credit window of WINDOW chunks. The NET side answers every CHUNK with a
+ *   STATUS, which returns one credit. WINDOW equals the receiver's large RX
+ *   queue depth, so chunks can never be dropped for lack of queue space.
+ *
+ * Recovery:
+ *   A chunk arriving beyond the expected offset is answered with -EILSEQ and
+ *   the expected offset. The sender rewinds there and bumps its epoch, so the
+ *   -EILSEQ answers for frames already in flight are ignored. Chunks below
+ *   the expected offset are duplicates and are acknowledged without writing.
+ */
+
+#pragma once
+
+#include "../../ipc/ipc_core.hpp"
+#include "ota_image_writer.hpp"
+
+namespace smarthome { namespace services { namespace ota {
+
+namespace netdfu {
+
+constexpr size_t CHUNK_SIZE = ipc::IPCCore::MAX_LARGE_PAYLOAD;
+constexpr uint8_t WINDOW = ipc::IPCCore::LARGE_RX_QUEUE_DEPTH;
+
+enum class Phase : uint8_t {
+    IDLE = 0,
+    RECEIVING = 1,
+    VERIFYING = 2,
+    READY = 3,
+    ERROR = 4
+};
+
+#pragma pack(push, 1)
+struct BeginInfo {
+    uint32_t image_size;
+    uint8_t sha256[SHA256_LEN];
+};
+#pragma pack(pop)
+
+/*
+ * STATUS payload.params layout:
+ *   param1 = result (int32_t, 0 or negative errno)
+ *   param2 = next expected image offset (bytes accepted by NET)
+ *   param3 = Phase
+ *   param4 = MessageType being answered
+ *   param5 = epoch echoed from CHUNK
+ *   param6 = bytes flushed to flash
+ */
+
+}  // namespace netdfu
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
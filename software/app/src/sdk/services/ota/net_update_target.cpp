@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "net_update_target.hpp"
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <string.h>
+
+#ifdef CONFIG_BOOTLOADER_MCUBOOT
+#include <zephyr/dfu/mcuboot.h>
+#endif
+
+LOG_MODULE_REGISTER(net_update, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace services { namespace ota {
+
+using ipc::IPCCore;
+using ipc::Message;
+using ipc::MessageBuilder;
+using ipc::MessageType;
+
+#define NET_UPDATE_SLOT_ID FIXED_PARTITION_ID(slot1_partition)
+
+/* Something applies the staged image at the next reset */
+static constexpr bool CAN_APPLY = IS_ENABLED(CONFIG_BOOTLOADER_MCUBOOT);
+
+NetUpdateTarget& NetUpdateTarget::getInstance() {
+    static NetUpdateTarget instance;
+    return instance;
+}
+
+NetUpdateTarget::NetUpdateTarget()
+    : phase_(netdfu::Phase::IDLE)
+    , image_size_(0)
+    , next_offset_(0)
+    , start_ms_(0)
+    , sha256_{}
+    , stats_{}
+{
+}
+
+int NetUpdateTarget::init() {
+    auto& ipc = IPCCore::getInstance();
+
+    ipc.registerLargeCallback(MessageType::NET_DFU_BEGIN, onBegin);
+    ipc.registerLargeCallback(MessageType::NET_DFU_CHUNK, onChunk);
+    ipc.registerCallback(MessageType::NET_DFU_END, onEnd);
+    ipc.registerCallback(MessageType::NET_DFU_ABORT, onAbort);
+
+    LOG_INF("NET update target ready (chunk %u bytes, window %u)",
+            (unsigned)netdfu::CHUNK_SIZE, netdfu::WINDOW);
+    if (!CAN_APPLY) {
+        LOG_WRN("No bootloader on this core - %s",
+                IS_ENABLED(CONFIG_APP_NET_UPDATE_STAGE_ONLY) ?
+                "images are staged only" : "updates are refused");
+    }
+    return 0;
+}
+
+/*=============================================================================
+ * IPC Trampolines
+ *===========================================================================*/
+
+void NetUpdateTarget::onBegin(const Message& header, const uint8_t* data, size_t len) {
+    getInstance().handleBegin(data, len);
+}
+
+void NetUpdateTarget::onChunk(const Message& header, const uint8_t* data, size_t len) {
+    getInstance().handleChunk(header, data, len);
+}
+
+void NetUpdateTarget::onEnd(const Message& msg) {
+    getInstance().handleEnd();
+}
+
+void NetUpdateTarget::onAbort(const Message& msg) {
+    getInstance().handleAbort();
+}
+
+/*=============================================================================
+ * Request Handlers
+ *===========================================================================*/
+
+void NetUpdateTarget::handleBegin(const uint8_t* data, size_t len) {
+    if (len != sizeof(netdfu::BeginInfo)) {
+        sendStatus(MessageType::NET_DFU_BEGIN, -EINVAL);
+        return;
+    }
+
+    if (!CAN_APPLY && !IS_ENABLED(CONFIG_APP_NET_UPDATE_STAGE_ONLY)) {
+        LOG_ERR("NET update refused: no bootloader to apply the image");
+        stats_.errors++;
+        sendStatus(MessageType::NET_DFU_BEGIN, -ENOTSUP);
+        return;
+    }
+
+    netdfu::BeginInfo info;
+    memcpy(&info, data, sizeof(info));
+
+    /* A new BEGIN always restarts the session */
+    writer_.abort();
+
+    int ret = writer_.begin(NET_UPDATE_SLOT_ID, 0);
+    if (ret < 0) {
+        phase_ = netdfu::Phase::ERROR;
+        stats_.errors++;
+        sendStatus(MessageType::NET_DFU_BEGIN, ret);
+        return;
+    }
+
+    image_size_ = info.image_size;
+    memcpy(sha256_, info.sha256, SHA256_LEN);
+    next_offset_ = 0;
+    start_ms_ = k_uptime_get_32();
+    phase_ = netdfu::Phase::RECEIVING;
+    stats_.sessions++;
+
+    LOG_INF("NET update started: %u bytes", image_size_);
+    sendStatus(MessageType::NET_DFU_BEGIN, 0);
+}
+
+void NetUpdateTarget::handleChunk(const Message& header, const uint8_t* data, size_t len) {
+    uint32_t offset = header.payload.params.param1;
+    uint32_t epoch = header.payload.params.param2;
+
+    if (phase_ != netdfu::Phase::RECEIVING) {
+        sendStatus(MessageType::NET_DFU_CHUNK, -EPERM, epoch);
+        return;
+    }
+
+    if (offset < next_offset_) {
+        /* Resent after a rewind - already on flash */
+        stats_.duplicates++;
+        sendStatus(MessageType::NET_DFU_CHUNK, 0, epoch);
+        return;
+    }
+
+    if (offset > next_offset_) {
+        stats_.gaps++;
+        LOG_WRN("Chunk gap: got %u, expected %u", offset, next_offset_);
+        sendStatus(MessageType::NET_DFU_CHUNK, -EILSEQ, epoch);
+        return;
+    }
+
+    if (offset + len > image_size_) {
+        sendStatus(MessageType::NET_DFU_CHUNK, -EFBIG, epoch);
+        return;
+    }
+
+    int ret = writer_.write(data, len);
+    if (ret < 0) {
+        phase_ = netdfu::Phase::ERROR;
+        stats_.errors++;
+        writer_.abort();
+        sendStatus(MessageType::NET_DFU_CHUNK, ret, epoch);
+        return;
+    }
+
+    next_offset_ += len;
+    stats_.chunks++;
+    sendStatus(MessageType::NET_DFU_CHUNK, 0, epoch);
+}
+
+void NetUpdateTarget::handleEnd() {
+    if (phase_ != netdfu::Phase::RECEIVING) {
+        sendStatus(MessageType::NET_DFU_END, -EPERM);
+        return;
+    }
+
+    if (next_offset_ != image_size_) {
+        sendStatus(MessageType::NET_DFU_END, -ENODATA);
+        return;
+    }
+
+    phase_ = netdfu::Phase::VERIFYING;
+    int ret = writer_.finish(sha256_);
+
+#ifdef CONFIG_BOOTLOADER_MCUBOOT
+    if (ret == 0) {
+        ret = boot_request_upgrade(BOOT_UPGRADE_TEST);
+    }
+#endif
+
+    stats_.last_duration_ms = k_uptime_get_32() - start_ms_;
+
+    if (ret < 0) {
+        phase_ = netdfu::Phase::ERROR;
+        stats_.errors++;
+        LOG_ERR("NET update failed: %d", ret);
+    } else {
+        phase_ = netdfu::Phase::READY;
+        LOG_INF("NET image staged: %u bytes in %u ms", image_size_, stats_.last_duration_ms);
+        if (!CAN_APPLY) {
+            LOG_WRN("Staged only - no bootloader applies it");
+        }
+    }
+
+    sendStatus(MessageType::NET_DFU_END, ret);
+}
+
+void NetUpdateTarget::handleAbort() {
+    LOG_INF("NET update aborted at %u/%u", next_offset_, image_size_);
+    writer_.abort();
+    phase_ = netdfu::Phase::IDLE;
+    sendStatus(MessageType::NET_DFU_ABORT, 0);
+}
+
+/*=============================================================================
+ * Status Reporting
+ *===========================================================================*/
+
+void NetUpdateTarget::sendStatus(MessageType answered, int result, uint32_t epoch) {
+    auto msg = MessageBuilder(MessageType::NET_DFU_STATUS)
+                 .setPriority(ipc::Priority::HIGH)
+                 .setParam(0, (uint32_t)result)
+                 .setParam(1, next_offset_)
+                 .setParam(2, (uint32_t)phase_)
+                 .setParam(3, (uint32_t)answered)
+                 .setParam(4, epoch)
+                 .setParam(5, writer_.isActive() ? writer_.getBytesFlushed() : next_offset_)
+                 .build();
+
+    int ret = IPCCore::getInstance().send(msg);
+    if (ret < 0) {
+        LOG_ERR("Failed to send NET update status: %d", ret);
+    }
+}
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * NET UPDATE TARGET - NET Core Side of the IPC Firmware Transfer
+ * ============================================================================
+ *
+ * Purpose:
+ *   Receives image chunks from the APP core over the IPC large-payload path
+ *   and streams them into the NET core update slot with OtaImageWriter.
+ *   Every request is answered with a NET_DFU_STATUS message carrying the
+ *   result and the next expected offset (see net_update_protocol.hpp).
+ *
+ * Context:
+ *   Handlers run in the IPC RX thread. Flash writes therefore block other
+ *   IPC traffic for the duration of a page erase; the credit window keeps
+ *   the large RX queue from overflowing meanwhile.
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include "net_update_protocol.hpp"
+
+namespace smarthome { namespace services { namespace ota {
+
+class NetUpdateTarget {
+public:
+    /// Singleton instance getter
+    static NetUpdateTarget& getInstance();
+
+    /// Delete copy/move constructors
+    NetUpdateTarget(const NetUpdateTarget&) = delete;
+    NetUpdateTarget& operator=(const NetUpdateTarget&) = delete;
+    NetUpdateTarget(NetUpdateTarget&&) = delete;
+    NetUpdateTarget& operator=(NetUpdateTarget&&) = delete;
+
+    /**
+     * @brief Register IPC handlers (IPCCore must be initialized)
+     * @return 0 on success
+     */
+    int init();
+
+    netdfu::Phase getPhase() const { return phase_; }
+
+    struct Statistics {
+        uint32_t sessions;          ///< BEGIN requests accepted
+        uint32_t chunks;            ///< Chunks written
+        uint32_t duplicates;        ///< Chunks below expected offset (ignored)
+        uint32_t gaps;              ///< Chunks beyond expected offset (-EILSEQ)
+        uint32_t errors;            ///< Write/verify failures
+        uint32_t last_duration_ms;  ///< BEGIN → END of the last session
+    };
+
+    const Statistics& getStats() const { return stats_; }
+
+private:
+    NetUpdateTarget();
+    ~NetUpdateTarget() = default;
+
+    static void onBegin(const ipc::Message& header, const uint8_t* data, size_t len);
+    static void onChunk(const ipc::Message& header, const uint8_t* data, size_t len);
+    static void onEnd(const ipc::Message& msg);
+    static void onAbort(const ipc::Message& msg);
+
+    void handleBegin(const uint8_t* data, size_t len);
+    void handleChunk(const ipc::Message& header, const uint8_t* data, size_t len);
+    void handleEnd();
+    void handleAbort();
+
+    void sendStatus(ipc::MessageType answered, int result, uint32_t epoch = 0);
+
+    OtaImageWriter writer_;
+    netdfu::Phase phase_;
+    uint32_t image_size_;
+    uint32_t next_offset_;
+    uint32_t start_ms_;
+    uint8_t sha256_[SHA256_LEN];
+    Statistics stats_;
+};
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
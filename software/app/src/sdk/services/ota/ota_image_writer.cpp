@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_image_writer.hpp"
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/drivers/flash.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(ota_writer, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace services { namespace ota {
+
+/* Read-back chunk used when rebuilding the digest of a resumed image */
+static constexpr size_t REHASH_CHUNK = 256;
+
+OtaImageWriter::OtaImageWriter()
+    : ctx_{}
+    , sha_{}
+    , bytes_accepted_(0)
+    , active_(false)
+{
+}
+
+OtaImageWriter::~OtaImageWriter() {
+    abort();
+}
+
+/*=============================================================================
+ * Session Control
+ *===========================================================================*/
+
+int OtaImageWriter::begin(uint8_t area_id, uint32_t resume_offset) {
+    if (active_) {
+        abort();
+    }
+
+    int ret = flash_img_init_id(&ctx_, area_id);
+    if (ret < 0) {
+        LOG_ERR("flash_img_init_id(%u) failed: %d", area_id, ret);
+        return ret;
+    }
+
+    mbedtls_sha256_init(&sha_);
+    mbedtls_sha256_starts(&sha_, 0);
+    bytes_accepted_ = 0;
+
+    if (resume_offset > 0) {
+        if (resume_offset > ctx_.flash_area->fa_size) {
+            LOG_ERR("Resume offset %u beyond slot size %u",
+                    resume_offset, (uint32_t)ctx_.flash_area->fa_size);
+            mbedtls_sha256_free(&sha_);
+            return -EINVAL;
+        }
+
+        ret = rehashExisting(resume_offset);
+        if (ret < 0) {
+            mbedtls_sha256_free(&sha_);
+            return ret;
+        }
+
+        /* Continue the stream after the already-programmed prefix */
+        ctx_.stream.bytes_written = resume_offset;
+        bytes_accepted_ = resume_offset;
+        LOG_INF("Resuming image write at offset %u", resume_offset);
+    }
+
+    active_ = true;
+    return 0;
+}
+
+int OtaImageWriter::write(const uint8_t* data, size_t len) {
+    if (!active_) {
+        return -EPERM;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    int ret = flash_img_buffered_write(&ctx_, data, len, false);
+    if (ret < 0) {
+        LOG_ERR("Slot write failed at %u: %d", bytes_accepted_, ret);
+        return ret;
+    }
+
+    mbedtls_sha256_update(&sha_, data, len);
+    bytes_accepted_ += len;
+    return 0;
+}
+
+int OtaImageWriter::finish(const uint8_t expected_sha256[SHA256_LEN]) {
+    if (!active_) {
+        return -EPERM;
+    }
+
+    int ret = flash_img_buffered_write(&ctx_, nullptr, 0, true);
+    if (ret < 0) {
+        LOG_ERR("Final flush failed: %d", ret);
+        abort();
+        return ret;
+    }
+
+    uint8_t digest[SHA256_LEN];
+    mbedtls_sha256_finish(&sha_, digest);
+    mbedtls_sha256_free(&sha_);
+    active_ = false;
+
+    if (memcmp(digest, expected_sha256, SHA256_LEN) != 0) {
+        LOG_ERR("Image digest mismatch (%u bytes)", bytes_accepted_);
+        return -EBADMSG;
+    }
+
+    LOG_INF("Image verified (%u bytes, SHA-256 OK)", bytes_accepted_);
+    return 0;
+}
+
+void OtaImageWriter::abort() {
+    if (!active_) {
+        return;
+    }
+
+    mbedtls_sha256_free(&sha_);
+    active_ = false;
+    LOG_DBG("Image write aborted at %u bytes", bytes_accepted_);
+}
+
+uint32_t OtaImageWriter::getBytesFlushed() {
+    return static_cast<uint32_t>(flash_img_bytes_written(&ctx_));
+}
+
+/*=============================================================================
+ * Resume Helpers
+ *===========================================================================*/
+
+int OtaImageWriter::alignResumeOffset(uint8_t area_id, uint32_t offset, uint32_t* aligned) {
+    const struct flash_area* fa;
+    int ret = flash_area_open(area_id, &fa);
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (offset >= fa->fa_size) {
+        flash_area_close(fa);
+        *aligned = 0;
+        return -EINVAL;
+    }
+
+    struct flash_pages_info page;
+    ret = flash_get_page_info_by_offs(flash_area_get_device(fa),
+                                      fa->fa_off + offset, &page);
+    if (ret == 0) {
+        *aligned = static_cast<uint32_t>(page.start_offset - fa->fa_off);
+    }
+
+    flash_area_close(fa);
+    return ret;
+}
+
+int OtaImageWriter::rehashExisting(uint32_t len) {
+    uint8_t buf[REHASH_CHUNK];
+    uint32_t off = 0;
+
+    while (off < len) {
+        size_t chunk = MIN((size_t)(len - off), sizeof(buf));
+        int ret = flash_area_read(ctx_.flash_area, off, buf, chunk);
+        if (ret < 0) {
+            LOG_ERR("Read-back failed at %u: %d", off, ret);
+            return ret;
+        }
+        mbedtls_sha256_update(&sha_, buf, chunk);
+        off += chunk;
+    }
+
+    return 0;
+}
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
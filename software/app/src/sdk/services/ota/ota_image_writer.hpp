@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * OTA IMAGE WRITER - Direct-to-Slot Streaming Flash Writer
+ * ============================================================================
+ *
+ * Purpose:
+ *   Writes an incoming firmware image straight into the MCUboot secondary
+ *   slot through Zephyr's flash_img/stream_flash layer. Data is staged in
+ *   the CONFIG_IMG_BLOCK_BUF_SIZE block buffer and flushed in
+ *   write-block aligned units; pages are erased progressively, so a resumed
+ *   download never wipes what is already on flash.
+ *
+ * Integrity:
+ *   SHA-256 is updated on every write, so verification at the end costs one
+ *   hash finalisation rather than a full read-back of the slot. When a
+ *   download is resumed after reboot, the already-written prefix is re-hashed
+ *   from flash once to rebuild the digest state.
+ */
+
+#ifndef OTA_IMAGE_WRITER_HPP
+#define OTA_IMAGE_WRITER_HPP
+
+#include <zephyr/kernel.h>
+#include <zephyr/dfu/flash_img.h>
+#include <mbedtls/sha256.h>
+#include <stdint.h>
+
+namespace smarthome { namespace services { namespace ota {
+
+constexpr size_t SHA256_LEN = 32;
+
+class OtaImageWriter {
+public:
+    OtaImageWriter();
+    ~OtaImageWriter();
+
+    OtaImageWriter(const OtaImageWriter&) = delete;
+    OtaImageWriter& operator=(const OtaImageWriter&) = delete;
+
+    /**
+     * @brief Open the target slot and prepare for streaming
+     * @param area_id Flash area of the update slot
+     * @param resume_offset Bytes already on flash (must be page aligned, 0 = fresh)
+     * @return 0 on success, negative errno on failure
+     */
+    int begin(uint8_t area_id, uint32_t resume_offset);
+
+    /**
+     * @brief Append image data (buffered, flushed per write block)
+     * @return 0 on success, negative errno on failure
+     */
+    int write(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Flush remaining data and compare the running digest
+     * @param expected_sha256 Expected SHA-256 of the full image
+     * @return 0 if image matches, -EBADMSG on mismatch, negative errno on I/O error
+     */
+    int finish(const uint8_t expected_sha256[SHA256_LEN]);
+
+    /**
+     * @brief Drop buffered data and release the hash context
+     */
+    void abort();
+
+    /**
+     * @brief Bytes accepted so far (on flash + staged in the block buffer)
+     */
+    uint32_t getBytesAccepted() const { return bytes_accepted_; }
+
+    /**
+     * @brief Bytes durably written to flash (safe resume point before alignment)
+     */
+    uint32_t getBytesFlushed();
+
+    bool isActive() const { return active_; }
+
+    /**
+     * @brief Round an offset down to the start of its flash page
+     *
+     * Resume must restart on a page boundary: progressive erase wipes the
+     * page containing the first write, so a mid-page restart would destroy
+     * the already-written head of that page.
+     */
+    static int alignResumeOffset(uint8_t area_id, uint32_t offset, uint32_t* aligned);
+
+private:
+    int rehashExisting(uint32_t len);
+
+    struct flash_img_context ctx_;
+    mbedtls_sha256_context sha_;
+    uint32_t bytes_accepted_;
+    bool active_;
+};
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
+
+#endif  // OTA_IMAGE_WRITER_HPP
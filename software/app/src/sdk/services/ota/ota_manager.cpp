@@ -0,0 +1,500 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_manager.hpp"
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/dfu/mcuboot.h>
+#include <stdio.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(ota_manager, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace services { namespace ota {
+
+static constexpr const char* RESUME_KEY = "ota/resume";
+static constexpr int32_t HTTP_TIMEOUT_MS = 10000;
+
+#define OTA_PRIMARY_ID   FIXED_PARTITION_ID(slot0_partition)
+#define OTA_SECONDARY_ID FIXED_PARTITION_ID(slot1_partition)
+
+OtaManager& OtaManager::getInstance() {
+    static OtaManager instance;
+    return instance;
+}
+
+OtaManager::OtaManager()
+    : state_(OtaState::IDLE)
+    , request_{}
+    , progress_callback_(nullptr)
+    , stats_{}
+    , old_area_(nullptr)
+    , body_offset_(0)
+    , discard_left_(0)
+    , last_checkpoint_(0)
+    , last_percent_(0)
+    , status_checked_(false)
+    , transfer_error_(0)
+    , cancel_requested_(false)
+    , thread_started_(false)
+{
+    k_mutex_init(&mutex_);
+    k_sem_init(&start_sem_, 0, 1);
+}
+
+const char* OtaManager::getStateName() const {
+    switch (state_) {
+        case OtaState::IDLE: return "IDLE";
+        case OtaState::DOWNLOADING: return "DOWNLOADING";
+        case OtaState::VERIFYING: return "VERIFYING";
+        case OtaState::READY: return "READY";
+        case OtaState::ERROR: return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+/*=============================================================================
+ * Public API
+ *===========================================================================*/
+
+int OtaManager::init() {
+    LOG_INF("=== Initializing OTA Manager ===");
+
+    /* A test-swapped image that reached this point is healthy enough to keep */
+    if (!boot_is_img_confirmed()) {
+        int ret = boot_write_img_confirmed();
+        if (ret < 0) {
+            LOG_ERR("Failed to confirm running image: %d", ret);
+        } else {
+            LOG_INF("Running image confirmed");
+        }
+    }
+
+    if (!thread_started_) {
+        k_thread_create(&thread_, stack_, K_KERNEL_STACK_SIZEOF(stack_),
+                        threadEntry, this, nullptr, nullptr,
+                        K_PRIO_PREEMPT(10), 0, K_NO_WAIT);
+        k_thread_name_set(&thread_, "ota");
+        thread_started_ = true;
+    }
+
+    LOG_INF("OTA manager ready (delta: %s)",
+            IS_ENABLED(CONFIG_APP_OTA_DELTA) ? "yes" : "no");
+    return 0;
+}
+
+int OtaManager::start(const OtaRequest& request) {
+    if (request.is_delta && !IS_ENABLED(CONFIG_APP_OTA_DELTA)) {
+        LOG_ERR("Delta images not enabled");
+        return -ENOTSUP;
+    }
+
+    if (request.body_size == 0) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&mutex_, K_FOREVER);
+    if (state_ == OtaState::DOWNLOADING || state_ == OtaState::VERIFYING) {
+        k_mutex_unlock(&mutex_);
+        LOG_WRN("OTA already in progress");
+        return -EBUSY;
+    }
+
+    request_ = request;
+    request_.host[sizeof(request_.host) - 1] = '\0';
+    request_.path[sizeof(request_.path) - 1] = '\0';
+    cancel_requested_ = false;
+    state_ = OtaState::DOWNLOADING;
+    k_mutex_unlock(&mutex_);
+
+    LOG_INF("OTA requested: http://%s:%u%s (%u bytes, %s)",
+            request_.host, request_.port, request_.path, request_.body_size,
+            request_.is_delta ? "delta" : "full");
+
+    k_sem_give(&start_sem_);
+    return 0;
+}
+
+void OtaManager::cancel() {
+    if (state_ == OtaState::DOWNLOADING) {
+        LOG_INF("OTA cancel requested");
+        cancel_requested_ = true;
+    }
+}
+
+uint8_t OtaManager::getProgressPercent() const {
+    if (request_.body_size == 0) {
+        return 0;
+    }
+    return (uint8_t)(((uint64_t)body_offset_ * 100U) / request_.body_size);
+}
+
+/*=============================================================================
+ * Worker Thread
+ *===========================================================================*/
+
+void OtaManager::threadEntry(void* p1, void* p2, void* p3) {
+    static_cast<OtaManager*>(p1)->threadLoop();
+}
+
+void OtaManager::threadLoop() {
+    while (1) {
+        k_sem_take(&start_sem_, K_FOREVER);
+
+        int ret = runUpdate();
+        if (ret < 0) {
+            LOG_ERR("OTA failed: %d (received %u/%u bytes)",
+                    ret, body_offset_, request_.body_size);
+            setState(OtaState::ERROR);
+        }
+    }
+}
+
+int OtaManager::runUpdate() {
+    uint32_t resume = request_.is_delta ? 0 : loadResumeOffset();
+
+    int ret = writer_.begin(OTA_SECONDARY_ID, resume);
+    if (ret < 0 && resume > 0) {
+        LOG_WRN("Resume at %u failed (%d), restarting", resume, ret);
+        clearCheckpoint();
+        resume = 0;
+        ret = writer_.begin(OTA_SECONDARY_ID, 0);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (request_.is_delta) {
+        ret = flash_area_open(OTA_PRIMARY_ID, &old_area_);
+        if (ret < 0) {
+            writer_.abort();
+            return ret;
+        }
+        patcher_.begin(readOldImage, writeNewImage, this);
+    }
+
+    body_offset_ = resume;
+    last_checkpoint_ = resume;
+    last_percent_ = 0xFF;
+
+    for (int attempt = 0; attempt <= CONFIG_APP_OTA_MAX_RETRIES; attempt++) {
+        if (attempt > 0) {
+            LOG_WRN("Retrying download from %u (attempt %d/%d)",
+                    body_offset_, attempt, CONFIG_APP_OTA_MAX_RETRIES);
+            k_sleep(K_MSEC(CONFIG_APP_OTA_RETRY_DELAY_MS));
+        }
+
+        ret = fetchFrom(body_offset_);
+        if (body_offset_ >= request_.body_size || cancel_requested_) {
+            break;
+        }
+        /* Fatal protocol errors are not worth retrying */
+        if (ret == -EBADMSG || ret == -ENOENT) {
+            break;
+        }
+    }
+
+    if (old_area_) {
+        flash_area_close(old_area_);
+        old_area_ = nullptr;
+    }
+
+    if (cancel_requested_) {
+        saveCheckpoint(true);
+        writer_.abort();
+        setState(OtaState::IDLE);
+        LOG_INF("OTA cancelled at %u bytes", body_offset_);
+        return 0;
+    }
+
+    if (body_offset_ < request_.body_size) {
+        /* Keep whatever reached flash for the next attempt */
+        saveCheckpoint(true);
+        writer_.abort();
+        return (ret < 0) ? ret : -EIO;
+    }
+
+    setState(OtaState::VERIFYING);
+
+    if (request_.is_delta && !patcher_.isComplete()) {
+        LOG_ERR("Delta patch ended early (%u/%u bytes produced)",
+                patcher_.getBytesProduced(), patcher_.getNewSize());
+        writer_.abort();
+        return -EBADMSG;
+    }
+
+    ret = writer_.finish(request_.sha256);
+    clearCheckpoint();
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = boot_request_upgrade(BOOT_UPGRADE_TEST);
+    if (ret < 0) {
+        LOG_ERR("boot_request_upgrade failed: %d", ret);
+        return ret;
+    }
+
+    setState(OtaState::READY);
+    LOG_INF("OTA complete: %u requests, %u resumes - reboot to apply",
+            stats_.http_requests, stats_.resumes);
+    return 0;
+}
+
+/*=============================================================================
+ * HTTP Transfer
+ *===========================================================================*/
+
+int OtaManager::fetchFrom(uint32_t offset) {
+    struct zsock_addrinfo hints = {};
+    struct zsock_addrinfo* res = nullptr;
+    char port_str[6];
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(port_str, sizeof(port_str), "%u", request_.port);
+
+    int ret = zsock_getaddrinfo(request_.host, port_str, &hints, &res);
+    if (ret != 0 || !res) {
+        LOG_ERR("Cannot resolve %s: %d", request_.host, ret);
+        return -EHOSTUNREACH;
+    }
+
+    int sock = zsock_socket(res->ai_family, SOCK_STREAM, IPPROTO_TCP);
+    if (sock < 0) {
+        zsock_freeaddrinfo(res);
+        return -errno;
+    }
+
+    ret = zsock_connect(sock, res->ai_addr, res->ai_addrlen);
+    zsock_freeaddrinfo(res);
+    if (ret < 0) {
+        ret = -errno;
+        LOG_ERR("Connect to %s:%u failed: %d", request_.host, request_.port, ret);
+        zsock_close(sock);
+        return ret;
+    }
+
+    char range[40];
+    const char* headers[] = { range, nullptr };
+    snprintf(range, sizeof(range), "Range: bytes=%u-\r\n", offset);
+
+    struct http_request req = {};
+    req.method = HTTP_GET;
+    req.url = request_.path;
+    req.host = request_.host;
+    req.protocol = "HTTP/1.1";
+    req.response = onHttpResponse;
+    req.recv_buf = recv_buf_;
+    req.recv_buf_len = sizeof(recv_buf_);
+    req.header_fields = (offset > 0) ? headers : nullptr;
+
+    status_checked_ = false;
+    discard_left_ = 0;
+    transfer_error_ = 0;
+    stats_.http_requests++;
+    if (offset > 0) {
+        stats_.resumes++;
+    }
+
+    ret = http_client_req(sock, &req, HTTP_TIMEOUT_MS, this);
+    zsock_close(sock);
+
+    if (transfer_error_ < 0) {
+        return transfer_error_;
+    }
+    return (ret < 0) ? ret : 0;
+}
+
+int OtaManager::onHttpResponse(struct http_response* rsp, enum http_final_call final_data,
+                               void* user_data) {
+    OtaManager* self = static_cast<OtaManager*>(user_data);
+
+    if (self->cancel_requested_) {
+        self->transfer_error_ = -ECANCELED;
+        return -ECANCELED;
+    }
+
+    if (!self->status_checked_ && rsp->http_status_code != 0) {
+        self->status_checked_ = true;
+
+        if (rsp->http_status_code == 200 && self->body_offset_ > 0) {
+            LOG_WRN("Server ignored Range, skipping %u bytes", self->body_offset_);
+            self->discard_left_ = self->body_offset_;
+        } else if (rsp->http_status_code == 404) {
+            self->transfer_error_ = -ENOENT;
+            return -ENOENT;
+        } else if (rsp->http_status_code != 200 && rsp->http_status_code != 206) {
+            LOG_ERR("Unexpected HTTP status %u", rsp->http_status_code);
+            self->transfer_error_ = -EIO;
+            return -EIO;
+        }
+    }
+
+    if (rsp->body_found && rsp->body_frag_start && rsp->body_frag_len > 0) {
+        int ret = self->consumeBody(rsp->body_frag_start, rsp->body_frag_len);
+        if (ret < 0) {
+            self->transfer_error_ = ret;
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+int OtaManager::consumeBody(const uint8_t* data, size_t len) {
+    if (discard_left_ > 0) {
+        size_t skip = MIN(len, (size_t)discard_left_);
+        discard_left_ -= skip;
+        data += skip;
+        len -= skip;
+    }
+
+    len = MIN(len, (size_t)(request_.body_size - body_offset_));
+    if (len == 0) {
+        return 0;
+    }
+
+    int ret = request_.is_delta ? patcher_.feed(data, len) : writer_.write(data, len);
+    if (ret < 0) {
+        return ret;
+    }
+
+    body_offset_ += len;
+    stats_.bytes_received += len;
+
+    if (!request_.is_delta) {
+        saveCheckpoint(false);
+    }
+    reportProgress();
+    return 0;
+}
+
+/*=============================================================================
+ * Delta Plumbing
+ *===========================================================================*/
+
+int OtaManager::readOldImage(uint32_t offset, uint8_t* buf, size_t len, void* user_data) {
+    OtaManager* self = static_cast<OtaManager*>(user_data);
+    return flash_area_read(self->old_area_, offset, buf, len);
+}
+
+int OtaManager::writeNewImage(const uint8_t* data, size_t len, void* user_data) {
+    OtaManager* self = static_cast<OtaManager*>(user_data);
+    return self->writer_.write(data, len);
+}
+
+/*=============================================================================
+ * Resume Checkpoints
+ *===========================================================================*/
+
+static int resumeLoadCb(const char* key, size_t len, settings_read_cb read_cb,
+                        void* cb_arg, void* param) {
+    if (key != nullptr) {
+        return 0;
+    }
+    ssize_t rd = read_cb(cb_arg, param, len);
+    return (rd < 0) ? (int)rd : 0;
+}
+
+uint32_t OtaManager::loadResumeOffset() {
+    ResumeRecord rec = {};
+
+    if (settings_get_val_len(RESUME_KEY) != sizeof(rec)) {
+        return 0;
+    }
+
+    if (settings_load_subtree_direct(RESUME_KEY, resumeLoadCb, &rec) < 0) {
+        return 0;
+    }
+
+    if (rec.body_size != request_.body_size ||
+        memcmp(rec.sha256, request_.sha256, SHA256_LEN) != 0) {
+        LOG_INF("Resume record belongs to another image, starting fresh");
+        clearCheckpoint();
+        return 0;
+    }
+
+    uint32_t aligned = 0;
+    if (rec.offset == 0 ||
+        OtaImageWriter::alignResumeOffset(OTA_SECONDARY_ID, rec.offset, &aligned) < 0) {
+        return 0;
+    }
+
+    LOG_INF("Found resume checkpoint at %u (page aligned: %u)", rec.offset, aligned);
+    return aligned;
+}
+
+void OtaManager::saveCheckpoint(bool force) {
+    if (request_.is_delta) {
+        return;
+    }
+
+    uint32_t flushed = writer_.getBytesFlushed();
+    if (flushed <= last_checkpoint_) {
+        return;
+    }
+    if (!force && flushed - last_checkpoint_ < CONFIG_APP_OTA_CHECKPOINT_INTERVAL) {
+        return;
+    }
+
+    ResumeRecord rec = {};
+    memcpy(rec.sha256, request_.sha256, SHA256_LEN);
+    rec.body_size = request_.body_size;
+    rec.offset = flushed;
+
+    int ret = settings_save_one(RESUME_KEY, &rec, sizeof(rec));
+    if (ret < 0) {
+        LOG_WRN("Failed to save OTA checkpoint: %d", ret);
+        return;
+    }
+
+    last_checkpoint_ = flushed;
+    stats_.checkpoints++;
+    LOG_DBG("OTA checkpoint at %u", flushed);
+}
+
+void OtaManager::clearCheckpoint() {
+    settings_delete(RESUME_KEY);
+    last_checkpoint_ = 0;
+}
+
+/*=============================================================================
+ * State & Progress
+ *===========================================================================*/
+
+void OtaManager::setState(OtaState state) {
+    k_mutex_lock(&mutex_, K_FOREVER);
+    state_ = state;
+    k_mutex_unlock(&mutex_);
+
+    LOG_INF("OTA state: %s", getStateName());
+
+    if (progress_callback_) {
+        progress_callback_(state, body_offset_, request_.body_size);
+    }
+}
+
+void OtaManager::reportProgress() {
+    uint8_t percent = getProgressPercent();
+    if (percent == last_percent_) {
+        return;
+    }
+
+    last_percent_ = percent;
+    if (percent % 10 == 0) {
+        LOG_INF("OTA progress: %u%% (%u/%u)", percent, body_offset_, request_.body_size);
+    }
+
+    if (progress_callback_) {
+        progress_callback_(state_, body_offset_, request_.body_size);
+    }
+}
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
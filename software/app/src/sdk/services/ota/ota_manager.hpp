@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * OTA MANAGER - Resumable Streaming Firmware Download
+ * ============================================================================
+ *
+ * Purpose:
+ *   Downloads a firmware image (or a delta patch) over HTTP and streams the
+ *   response body directly into the MCUboot secondary slot. No part of the
+ *   image is held in RAM beyond the HTTP receive buffer and the flash block
+ *   buffer.
+ *
+ * Resume:
+ *   - Within one boot: a dropped connection is retried with
+ *     "Range: bytes=<received>-" and the in-RAM writer/patcher state
+ *     simply continues.
+ *   - Across reboots (full images only): a checkpoint record
+ *     {sha256, size, flushed offset} is saved to settings every
+ *     CONFIG_APP_OTA_CHECKPOINT_INTERVAL bytes. At the next start() for the
+ *     same image the download restarts from the page-aligned checkpoint.
+ *   - Servers that ignore Range (200 instead of 206) are handled by
+ *     discarding the already-received prefix.
+ *
+ * Flow:
+ *   start() → DOWNLOADING → VERIFYING → READY (upgrade requested, reboot to apply)
+ *                                     ↘ ERROR
+ */
+
+#ifndef OTA_MANAGER_HPP
+#define OTA_MANAGER_HPP
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/http/client.h>
+#include <stdint.h>
+
+#include "ota_image_writer.hpp"
+#include "delta_patcher.hpp"
+
+namespace smarthome { namespace services { namespace ota {
+
+enum class OtaState : uint8_t {
+    IDLE = 0,           ///< No update in progress
+    DOWNLOADING = 1,    ///< Streaming body into secondary slot
+    VERIFYING = 2,      ///< Finalising digest
+    READY = 3,          ///< Image verified, MCUboot test swap requested
+    ERROR = 4           ///< Last update failed (resume record kept if possible)
+};
+
+/**
+ * Update request - copied by value, no pointers retained
+ */
+struct OtaRequest {
+    char host[64];                  ///< Server host name or address
+    uint16_t port;                  ///< Server TCP port
+    char path[128];                 ///< Resource path, e.g. "/fw/app_update.bin"
+    uint32_t body_size;             ///< Size of the HTTP body (patch size for delta)
+    uint8_t sha256[SHA256_LEN];     ///< SHA-256 of the resulting slot image
+    bool is_delta;                  ///< Body is a DeltaPatcher patch against slot 0
+};
+
+/**
+ * Progress callback
+ * @param state Current state
+ * @param done Body bytes received so far
+ * @param total Total body bytes
+ */
+using OtaProgressCallback = void (*)(OtaState state, uint32_t done, uint32_t total);
+
+class OtaManager {
+public:
+    /// Singleton instance getter
+    static OtaManager& getInstance();
+
+    /// Delete copy/move constructors
+    OtaManager(const OtaManager&) = delete;
+    OtaManager& operator=(const OtaManager&) = delete;
+    OtaManager(OtaManager&&) = delete;
+    OtaManager& operator=(OtaManager&&) = delete;
+
+    /**
+     * Initialize OTA manager
+     *
+     * Confirms the running image if MCUboot booted it in test mode and
+     * starts the download thread.
+     */
+    int init();
+
+    /**
+     * Start (or resume) an update
+     *
+     * @return 0 if accepted, -EBUSY if an update is running,
+     *         -ENOTSUP for delta when CONFIG_APP_OTA_DELTA is disabled
+     */
+    int start(const OtaRequest& request);
+
+    /**
+     * Request cancellation of the running download
+     */
+    void cancel();
+
+    /**
+     * Get current state
+     */
+    OtaState getState() const { return state_; }
+
+    /**
+     * Get state name (for logging)
+     */
+    const char* getStateName() const;
+
+    /**
+     * Get progress 0-100
+     */
+    uint8_t getProgressPercent() const;
+
+    void setProgressCallback(OtaProgressCallback callback) { progress_callback_ = callback; }
+
+    /**
+     * Download statistics
+     */
+    struct Statistics {
+        uint32_t bytes_received;    ///< Body bytes received (all attempts)
+        uint32_t http_requests;     ///< HTTP requests issued
+        uint32_t resumes;           ///< Requests that used a Range header
+        uint32_t checkpoints;       ///< Resume records written
+    };
+
+    const Statistics& getStats() const { return stats_; }
+
+private:
+    OtaManager();
+    ~OtaManager() = default;
+
+    /* Persistent resume checkpoint (full images only) */
+    struct ResumeRecord {
+        uint8_t sha256[SHA256_LEN];
+        uint32_t body_size;
+        uint32_t offset;
+    };
+
+    /* Worker thread */
+    static void threadEntry(void* p1, void* p2, void* p3);
+    void threadLoop();
+    int runUpdate();
+
+    /* HTTP transfer */
+    int fetchFrom(uint32_t offset);
+    static int onHttpResponse(struct http_response* rsp, enum http_final_call final_data,
+                              void* user_data);
+    int consumeBody(const uint8_t* data, size_t len);
+
+    /* Delta plumbing */
+    static int readOldImage(uint32_t offset, uint8_t* buf, size_t len, void* user_data);
+    static int writeNewImage(const uint8_t* data, size_t len, void* user_data);
+
+    /* Resume record */
+    uint32_t loadResumeOffset();
+    void saveCheckpoint(bool force);
+    void clearCheckpoint();
+
+    void setState(OtaState state);
+    void reportProgress();
+
+    OtaState state_;
+    OtaRequest request_;
+    OtaProgressCallback progress_callback_;
+    Statistics stats_;
+
+    OtaImageWriter writer_;
+    DeltaPatcher patcher_;
+    const struct flash_area* old_area_;
+
+    /* Per-session transfer state */
+    uint32_t body_offset_;          ///< Body bytes consumed (next Range start)
+    uint32_t discard_left_;         ///< Prefix to drop when server ignored Range
+    uint32_t last_checkpoint_;      ///< Flushed offset at last checkpoint
+    uint8_t last_percent_;
+    bool status_checked_;
+    int transfer_error_;
+    volatile bool cancel_requested_;
+
+    uint8_t recv_buf_[CONFIG_APP_OTA_RECV_BUF_SIZE];
+
+    struct k_mutex mutex_;
+    struct k_sem start_sem_;
+    struct k_thread thread_;
+    bool thread_started_;
+    K_KERNEL_STACK_MEMBER(stack_, CONFIG_APP_OTA_THREAD_STACK_SIZE);
+};
+
+}  // namespace ota
+}  // namespace services
+}  // namespace smarthome
+
+#endif  // OTA_MANAGER_HPP
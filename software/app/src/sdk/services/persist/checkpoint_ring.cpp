@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "checkpoint_ring.hpp"
+#include <zephyr/logging/log.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/sys/crc.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(checkpoint_ring, CONFIG_LOG_DEFAULT_LEVEL);
+
+namespace smarthome { namespace services { namespace persist {
+
+/* Sequence numbers compare with serial arithmetic, so wrap is harmless */
+static bool seqNewer(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) > 0;
+}
+
+CheckpointRing::CheckpointRing()
+    : fa_(nullptr)
+    , record_len_(0)
+    , slot_size_(0)
+    , page_size_(0)
+    , slots_per_page_(0)
+    , slot_count_(0)
+    , next_slot_(0)
+    , latest_slot_(-1)
+    , seq_(0)
+    , page_erases_(0)
+    , erased_val_(0xFF)
+    , buf_{}
+{
+}
+
+CheckpointRing::~CheckpointRing() {
+    if (fa_) {
+        flash_area_close(fa_);
+    }
+}
+
+/*=============================================================================
+ * Open / Scan
+ *===========================================================================*/
+
+int CheckpointRing::init(uint8_t area_id, size_t record_len) {
+    if (fa_) {
+        flash_area_close(fa_);
+        fa_ = nullptr;
+    }
+
+    if (record_len == 0 || record_len > MAX_RECORD_SIZE) {
+        return -EINVAL;
+    }
+
+    const struct flash_area* fa;
+    int ret = flash_area_open(area_id, &fa);
+    if (ret < 0) {
+        return ret;
+    }
+
+    struct flash_pages_info page;
+    ret = flash_get_page_info_by_offs(flash_area_get_device(fa), fa->fa_off, &page);
+    if (ret < 0) {
+        flash_area_close(fa);
+        return ret;
+    }
+
+    size_t align = MAX(flash_area_align(fa), 1U);
+    slot_size_ = ROUND_UP(HEADER_SIZE + record_len, align);
+    page_size_ = page.size;
+
+    if (slot_size_ > MAX_SLOT_SIZE || slot_size_ > page_size_ ||
+        fa->fa_size < 2 * page_size_) {
+        LOG_ERR("Area %u unusable: %u byte slots, %u byte pages, %u bytes",
+                area_id, (unsigned)slot_size_, (unsigned)page_size_,
+                (unsigned)fa->fa_size);
+        flash_area_close(fa);
+        return -EINVAL;
+    }
+
+    fa_ = fa;
+    record_len_ = record_len;
+    erased_val_ = flash_area_erased_val(fa);
+    slots_per_page_ = page_size_ / slot_size_;
+    slot_count_ = (fa->fa_size / page_size_) * slots_per_page_;
+    latest_slot_ = -1;
+    seq_ = 0;
+    page_erases_ = 0;
+
+    /* One pass over the headers: newest valid record wins */
+    SlotHeader header;
+    for (uint16_t slot = 0; slot < slot_count_; slot++) {
+        if (!readSlot(slot, header)) {
+            continue;
+        }
+        if (latest_slot_ < 0 || seqNewer(header.seq, seq_)) {
+            latest_slot_ = slot;
+            seq_ = header.seq;
+        }
+    }
+
+    next_slot_ = (latest_slot_ < 0) ? 0 : (latest_slot_ + 1) % slot_count_;
+
+    LOG_INF("Checkpoint ring: %u slots of %u bytes, %s (seq %u)",
+            slot_count_, (unsigned)slot_size_,
+            (latest_slot_ < 0) ? "empty" : "restored", seq_);
+    return 0;
+}
+
+off_t CheckpointRing::slotOffset(uint16_t slot) const {
+    return (off_t)(slot / slots_per_page_) * page_size_ +
+           (off_t)(slot % slots_per_page_) * slot_size_;
+}
+
+bool CheckpointRing::readSlot(uint16_t slot, SlotHeader& header) {
+    if (flash_area_read(fa_, slotOffset(slot), buf_, HEADER_SIZE + record_len_) < 0) {
+        return false;
+    }
+
+    memcpy(&header, buf_, HEADER_SIZE);
+    if (header.magic != MAGIC || header.len != record_len_) {
+        return false;
+    }
+
+    uint32_t crc = crc32_ieee(&buf_[offsetof(SlotHeader, seq)],
+                              HEADER_SIZE - offsetof(SlotHeader, seq) + record_len_);
+    return crc == header.crc;
+}
+
+bool CheckpointRing::isSlotBlank(uint16_t slot) {
+    if (flash_area_read(fa_, slotOffset(slot), buf_, slot_size_) < 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < slot_size_; i++) {
+        if (buf_[i] != erased_val_) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*=============================================================================
+ * Load / Save
+ *===========================================================================*/
+
+int CheckpointRing::load(void* record, size_t len) {
+    if (!fa_) {
+        return -ENODEV;
+    }
+    if (len != record_len_) {
+        return -EMSGSIZE;
+    }
+    if (latest_slot_ < 0) {
+        return -ENOENT;
+    }
+
+    SlotHeader header;
+    if (!readSlot(latest_slot_, header)) {
+        return -EIO;
+    }
+
+    memcpy(record, &buf_[HEADER_SIZE], record_len_);
+    return 0;
+}
+
+int CheckpointRing::prepareSlot(uint16_t slot) {
+    if (slot % slots_per_page_ == 0) {
+        /* Entering a page: the newest record is in another one */
+        int ret = flash_area_erase(fa_, slotOffset(slot), page_size_);
+        if (ret < 0) {
+            return ret;
+        }
+        page_erases_++;
+        return 0;
+    }
+
+    /* Mid-page slots were erased with their page unless a write was torn */
+    return isSlotBlank(slot) ? 0 : -EAGAIN;
+}
+
+int CheckpointRing::save(const void* record, size_t len) {
+    if (!fa_) {
+        return -ENODEV;
+    }
+    if (len != record_len_) {
+        return -EMSGSIZE;
+    }
+
+    /* Skip to the next page boundary past a dirty slot (at most once per page) */
+    int ret;
+    while ((ret = prepareSlot(next_slot_)) == -EAGAIN) {
+        next_slot_ = ((next_slot_ / slots_per_page_ + 1) * slots_per_page_) % slot_count_;
+    }
+    if (ret < 0) {
+        LOG_ERR("Erase for slot %u failed: %d", next_slot_, ret);
+        return ret;
+    }
+
+    SlotHeader header = {};
+    header.magic = MAGIC;
+    header.seq = seq_ + 1;
+    header.len = record_len_;
+
+    memset(buf_, erased_val_, slot_size_);
+    memcpy(buf_, &header, HEADER_SIZE);
+    memcpy(&buf_[HEADER_SIZE], record, record_len_);
+    header.crc = crc32_ieee(&buf_[offsetof(SlotHeader, seq)],
+                            HEADER_SIZE - offsetof(SlotHeader, seq) + record_len_);
+    memcpy(&buf_[offsetof(SlotHeader, crc)], &header.crc, sizeof(header.crc));
+
+    ret = flash_area_write(fa_, slotOffset(next_slot_), buf_, slot_size_);
+    if (ret < 0) {
+        LOG_ERR("Write of slot %u failed: %d", next_slot_, ret);
+        return ret;
+    }
+
+    latest_slot_ = next_slot_;
+    seq_ = header.seq;
+    next_slot_ = (next_slot_ + 1) % slot_count_;
+
+    LOG_DBG("Checkpoint %u -> slot %d", seq_, latest_slot_);
+    return 0;
+}
+
+}  // namespace persist
+}  // namespace services
+}  // namespace smarthome
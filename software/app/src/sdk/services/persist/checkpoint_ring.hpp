@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * CHECKPOINT RING - Wear-Levelled Record Store on a Flash Area
+ * ============================================================================
+ *
+ * Purpose:
+ *   Keeps the latest copy of one small fixed-size record (statistics,
+ *   counters) on a dedicated flash area. Every save goes to the next slot,
+ *   round-robin over the whole area, so each page is erased once per
+ *   (slots per page x pages) saves instead of once per save.
+ *
+ * Layout:
+ *   The area is cut into write-block aligned slots that never straddle an
+ *   erase page. Each slot holds a header (magic, CRC-32, sequence, length)
+ *   followed by the record; the CRC covers sequence, length and record, so
+ *   a write torn by a reset is simply skipped at the next scan.
+ *
+ *   | page 0: slot slot slot ... | page 1: slot slot slot ... | ...
+ *
+ *   A page is erased only when the writer enters it, and the newest record
+ *   always lives in another page, so at least two pages are required.
+ *
+ * Restore:
+ *   init() scans every slot header once and remembers the valid slot with
+ *   the highest sequence number; load() returns it.
+ */
+
+#ifndef CHECKPOINT_RING_HPP
+#define CHECKPOINT_RING_HPP
+
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <stdint.h>
+
+namespace smarthome { namespace services { namespace persist {
+
+class CheckpointRing {
+public:
+    static constexpr uint32_t MAGIC = 0x52504B43;   ///< "CKPR"
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t MAX_SLOT_SIZE = 64;     ///< Header + record, aligned
+    static constexpr size_t MAX_RECORD_SIZE = MAX_SLOT_SIZE - HEADER_SIZE;
+
+    CheckpointRing();
+    ~CheckpointRing();
+
+    CheckpointRing(const CheckpointRing&) = delete;
+    CheckpointRing& operator=(const CheckpointRing&) = delete;
+
+    /**
+     * @brief Open the flash area and find the newest valid record
+     * @param area_id Flash area reserved for this ring
+     * @param record_len Size of the record saved/loaded (<= MAX_RECORD_SIZE)
+     * @return 0 on success, -EINVAL if the area is too small (< 2 pages) or
+     *         the record does not fit a slot, negative errno on I/O error
+     */
+    int init(uint8_t area_id, size_t record_len);
+
+    /**
+     * @brief Copy the newest valid record
+     * @return 0 on success, -ENOENT if the ring holds no valid record,
+     *         -EMSGSIZE if it was saved with another record length
+     */
+    int load(void* record, size_t len);
+
+    /**
+     * @brief Write the record to the next slot (erasing its page on entry)
+     * @return 0 on success, negative errno on failure
+     */
+    int save(const void* record, size_t len);
+
+    bool isOpen() const { return fa_ != nullptr; }
+    uint32_t getSequence() const { return seq_; }
+    uint16_t getSlotCount() const { return slot_count_; }
+    uint32_t getPageErases() const { return page_erases_; }   ///< Since init()
+
+private:
+    struct SlotHeader {
+        uint32_t magic;
+        uint32_t crc;       ///< CRC-32 (IEEE) of seq, len, reserved and record
+        uint32_t seq;
+        uint16_t len;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(SlotHeader) == HEADER_SIZE, "slot header layout");
+
+    off_t slotOffset(uint16_t slot) const;
+    bool readSlot(uint16_t slot, SlotHeader& header);
+    bool isSlotBlank(uint16_t slot);
+    int prepareSlot(uint16_t slot);
+
+    const struct flash_area* fa_;
+    size_t record_len_;
+    size_t slot_size_;
+    size_t page_size_;
+    uint16_t slots_per_page_;
+    uint16_t slot_count_;
+    uint16_t next_slot_;
+    int32_t latest_slot_;       ///< -1 while the ring is empty
+    uint32_t seq_;
+    uint32_t page_erases_;
+    uint8_t erased_val_;
+    uint8_t buf_[MAX_SLOT_SIZE];
+};
+
+}  // namespace persist
+}  // namespace services
+}  // namespace smarthome
+
+#endif  // CHECKPOINT_RING_HPP
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "power_meter.hpp"
+#include <stdlib.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+namespace smarthome { namespace services { namespace power {
+
+uint32_t estimateCurrentNa(const PowerProfile& profile, uint32_t wakeups, uint32_t polls,
+                           uint32_t window_ms, bool rx_on_when_idle) {
+    uint64_t current_na = profile.sleep_na;
+
+    if (rx_on_when_idle) {
+        current_na += profile.rx_idle_na;
+    }
+
+    /* nC / ms = uA, so x1000 for nA */
+    if (window_ms > 0) {
+        uint64_t charge_nc = (uint64_t)wakeups * profile.wakeup_nc +
+                             (uint64_t)polls * profile.poll_nc;
+        current_na += charge_nc * 1000U / window_ms;
+    }
+
+    return (current_na > UINT32_MAX) ? UINT32_MAX : (uint32_t)current_na;
+}
+
+PowerMeter& PowerMeter::getInstance() {
+    static PowerMeter instance;
+    return instance;
+}
+
+PowerMeter::PowerMeter()
+    : wakeups_(ATOMIC_INIT(0))
+    , polls_(ATOMIC_INIT(0))
+    , start_ms_(0)
+{
+}
+
+void PowerMeter::start() {
+    atomic_set(&wakeups_, 0);
+    atomic_set(&polls_, 0);
+    start_ms_ = k_uptime_get();
+}
+
+void PowerMeter::sample(PowerSample& out, const PowerProfile& profile,
+                        bool rx_on_when_idle) const {
+    out.window_ms = (uint32_t)(k_uptime_get() - start_ms_);
+    out.wakeups = (uint32_t)atomic_get(&wakeups_);
+    out.polls = (uint32_t)atomic_get(&polls_);
+    out.wakeups_per_s_x10 = (out.window_ms > 0) ?
+        (uint32_t)((uint64_t)out.wakeups * 10000U / out.window_ms) : 0;
+    out.current_na = estimateCurrentNa(profile, out.wakeups, out.polls,
+                                       out.window_ms, rx_on_when_idle);
+}
+
+}  // namespace power
+}  // namespace services
+}  // namespace smarthome
+
+#ifdef CONFIG_TRACING_USER
+/* Every idle-thread entry ends one wakeup */
+extern "C" void sys_trace_idle_user(void) {
+    smarthome::services::power::PowerMeter::getInstance().recordWakeup();
+}
+#endif
+
+/*=============================================================================
+ * Shell Commands
+ *===========================================================================*/
+
+#ifdef CONFIG_SHELL
+using smarthome::services::power::PowerMeter;
+using smarthome::services::power::PowerSample;
+
+static int cmd_power_start(const struct shell* sh, size_t argc, char** argv) {
+    PowerMeter::getInstance().start();
+    shell_print(sh, "Window started");
+    return 0;
+}
+
+static int cmd_power_show(const struct shell* sh, size_t argc, char** argv) {
+    /* With a poll period the device is sleepy; polls not reported are estimated */
+    uint32_t poll_ms = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 0;
+    PowerSample s;
+
+    PowerMeter::getInstance().sample(s, smarthome::services::power::NRF5340_PROFILE, poll_ms == 0);
+    if (poll_ms > 0 && s.polls == 0) {
+        s.polls = s.window_ms / poll_ms;
+        s.current_na = smarthome::services::power::estimateCurrentNa(
+            smarthome::services::power::NRF5340_PROFILE, s.wakeups, s.polls, s.window_ms, false);
+    }
+
+    shell_print(sh, "window %u ms: %u wakeups (%u.%u/s), %u polls, ~%u.%u uA",
+                s.window_ms, s.wakeups, s.wakeups_per_s_x10 / 10, s.wakeups_per_s_x10 % 10,
+                s.polls, s.current_na / 1000, (s.current_na % 1000) / 100);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_power,
+    SHELL_CMD(start, NULL, "Start a measurement window", cmd_power_start),
+    SHELL_CMD_ARG(show, NULL, "Show window [poll period ms if sleepy]", cmd_power_show, 1, 1),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(power, &sub_power, "Wakeup count and current estimate", NULL);
+#endif
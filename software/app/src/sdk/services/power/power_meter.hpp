@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * POWER METER - Wakeup Counting and Average Current Estimate
+ * ============================================================================
+ *
+ * Purpose:
+ *   Battery life of a sleepy device is set by how often it leaves deep idle
+ *   and how often the radio runs, not by what the CPU does while awake. The
+ *   meter counts both over a window and turns them into an average current
+ *   with a per-board charge profile:
+ *
+ *     I_avg = I_sleep (+ I_rx when the receiver is always on)
+ *           + wakeups x Q_wakeup / window + polls x Q_poll / window
+ *
+ * Counting:
+ *   Wakeups are idle-thread entries, counted through the user tracing hook
+ *   (CONFIG_TRACING_USER) - every return to idle ends one wakeup. Radio
+ *   polls are reported by the caller with recordPoll().
+ *
+ * All arithmetic is integer (nA, nC); the estimate is a budget for
+ * comparing configurations, not a substitute for a current probe.
+ */
+
+#ifndef POWER_METER_HPP
+#define POWER_METER_HPP
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <stdint.h>
+
+namespace smarthome { namespace services { namespace power {
+
+/**
+ * Charge model of a board
+ */
+struct PowerProfile {
+    uint32_t sleep_na;          ///< Both cores in deep idle, RAM retained
+    uint32_t rx_idle_na;        ///< Extra for a receiver left on (rx-on-when-idle)
+    uint32_t wakeup_nc;         ///< One CPU wakeup (clock start, ISR, back to idle)
+    uint32_t poll_nc;           ///< One 802.15.4 data poll (TX, ack, RX window)
+};
+
+/**
+ * nRF5340 typical figures at 3 V with DC/DC: ~3 uA System ON idle for
+ * both cores, 2.6 mA 802.15.4 RX, ~3 mA for ~100 us per wakeup and ~4 mA
+ * for ~4 ms per data poll including HFXO start-up
+ */
+constexpr PowerProfile NRF5340_PROFILE = {
+    .sleep_na = 3000,
+    .rx_idle_na = 2600000,
+    .wakeup_nc = 300,
+    .poll_nc = 16000,
+};
+
+struct PowerSample {
+    uint32_t window_ms;
+    uint32_t wakeups;
+    uint32_t polls;
+    uint32_t wakeups_per_s_x10;     ///< Wakeup rate, one decimal
+    uint32_t current_na;            ///< Estimated average current
+};
+
+/**
+ * Estimate the average current over a window
+ *
+ * @return Current in nA (I_sleep for an empty window)
+ */
+uint32_t estimateCurrentNa(const PowerProfile& profile, uint32_t wakeups, uint32_t polls,
+                           uint32_t window_ms, bool rx_on_when_idle);
+
+class PowerMeter {
+public:
+    static PowerMeter& getInstance();
+
+    PowerMeter(const PowerMeter&) = delete;
+    PowerMeter& operator=(const PowerMeter&) = delete;
+
+    /**
+     * @brief Reset the counters and start a new window
+     */
+    void start();
+
+    /**
+     * @brief Count one radio data poll
+     */
+    void recordPoll() { atomic_inc(&polls_); }
+
+    /**
+     * @brief Count one wakeup (called from the idle tracing hook)
+     */
+    void recordWakeup() { atomic_inc(&wakeups_); }
+
+    /**
+     * @brief Read the window so far
+     * @param rx_on_when_idle Receiver always on (non-sleepy Thread device)
+     */
+    void sample(PowerSample& out, const PowerProfile& profile, bool rx_on_when_idle) const;
+
+private:
+    PowerMeter();
+    ~PowerMeter() = default;
+
+    atomic_t wakeups_;
+    atomic_t polls_;
+    int64_t start_ms_;
+};
+
+}  // namespace power
+}  // namespace services
+}  // namespace smarthome
+
+#endif  // POWER_METER_HPP
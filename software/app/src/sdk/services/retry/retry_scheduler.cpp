@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "retry_scheduler.hpp"
+#include <zephyr/random/random.h>
+
+namespace smarthome { namespace services { namespace retry {
+
+RetryScheduler::RetryScheduler()
+    : policy_{}
+    , handler_(nullptr)
+    , user_data_(nullptr)
+    , queue_(&k_sys_work_q)
+    , random_(sys_rand32_get)
+    , attempts_(ATOMIC_INIT(0))
+    , last_delay_ms_(0)
+{
+    k_work_init_delayable(&work_, workHandler);
+}
+
+void RetryScheduler::init(const RetryPolicy& policy, Handler handler, void* user_data,
+                          struct k_work_q* queue) {
+    reset();
+    policy_ = policy;
+    handler_ = handler;
+    user_data_ = user_data;
+    queue_ = queue ? queue : &k_sys_work_q;
+}
+
+uint32_t RetryScheduler::backoffCeilingMs(const RetryPolicy& policy, uint8_t attempt) {
+    uint32_t delay = policy.initial_delay_ms;
+
+    for (uint8_t i = 1; i < attempt && delay < policy.max_delay_ms; i++) {
+        delay = (uint32_t)(((uint64_t)delay * policy.multiplier_q8) >> 8);
+    }
+
+    return MIN(delay, policy.max_delay_ms);
+}
+
+int RetryScheduler::schedule() {
+    /* Not RUNNING: the handler arms the next attempt from inside itself */
+    if (k_work_delayable_busy_get(&work_) & (K_WORK_DELAYED | K_WORK_QUEUED)) {
+        return -EALREADY;
+    }
+
+    uint8_t attempt = (uint8_t)atomic_get(&attempts_) + 1;
+    if (policy_.max_attempts != 0 && attempt > policy_.max_attempts) {
+        return -ETIMEDOUT;
+    }
+    atomic_set(&attempts_, attempt);
+
+    uint32_t ceiling = backoffCeilingMs(policy_, attempt);
+    uint32_t floor = policy_.equal_jitter ? ceiling / 2 : 0;
+    uint32_t delay = policy_.full_jitter ? floor + random_() % (ceiling - floor + 1) : ceiling;
+    last_delay_ms_ = delay;
+
+    int ret = k_work_schedule_for_queue(queue_, &work_, K_MSEC(delay));
+    return ret < 0 ? ret : 0;
+}
+
+void RetryScheduler::reset() {
+    k_work_cancel_delayable(&work_);
+    atomic_set(&attempts_, 0);
+}
+
+void RetryScheduler::workHandler(struct k_work* work) {
+    struct k_work_delayable* dwork = k_work_delayable_from_work(work);
+    RetryScheduler* self = CONTAINER_OF(dwork, RetryScheduler, work_);
+
+    if (self->handler_) {
+        self->handler_(*self, self->user_data_);
+    }
+}
+
+}  // namespace retry
+}  // namespace services
+}  // namespace smarthome
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * RETRY SCHEDULER - Jittered Exponential Backoff on a Work Queue
+ * ============================================================================
+ *
+ * Purpose:
+ *   Schedules retries of a failed operation (network rejoin, reconnect)
+ *   without blocking the caller. Each schedule() arms a delayable work item;
+ *   the handler runs in work queue context and either succeeds (reset()) or
+ *   asks for the next attempt (schedule()).
+ *
+ * Backoff:
+ *   ceiling(n) = min(initial * multiplier^(n-1), max), integer only, with
+ *   the multiplier in Q8.8 fixed point (384 = 1.5x, 512 = 2x).
+ *   With full jitter the actual delay is uniform in [0, ceiling(n)], so
+ *   devices that lost the network at the same moment (power cut) do not
+ *   retry in lockstep. Equal jitter keeps it in [ceiling(n)/2, ceiling(n)]
+ *   for retries that must not fire before some work in progress is done.
+ */
+
+#ifndef RETRY_SCHEDULER_HPP
+#define RETRY_SCHEDULER_HPP
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+namespace smarthome { namespace services { namespace retry {
+
+struct RetryPolicy {
+    uint32_t initial_delay_ms;  ///< Ceiling of the first attempt
+    uint32_t max_delay_ms;      ///< Ceiling cap
+    uint16_t multiplier_q8;     ///< Backoff multiplier, Q8.8 (256 = 1x)
+    uint8_t max_attempts;       ///< 0 = unlimited
+    bool full_jitter;           ///< Uniform delay in [0, ceiling]
+    bool equal_jitter;          ///< With full_jitter: in [ceiling / 2, ceiling]
+};
+
+class RetryScheduler {
+public:
+    /**
+     * @brief Retry handler (work queue context)
+     * @param scheduler Scheduler that fired; call reset() or schedule() on it
+     * @param user_data Value given to init()
+     */
+    using Handler = void (*)(RetryScheduler& scheduler, void* user_data);
+
+    /// Random source for jitter (defaults to sys_rand32_get)
+    using RandomSource = uint32_t (*)(void);
+
+    RetryScheduler();
+
+    RetryScheduler(const RetryScheduler&) = delete;
+    RetryScheduler& operator=(const RetryScheduler&) = delete;
+
+    /**
+     * @brief Configure the scheduler
+     * @param queue Work queue for the handler, nullptr = system work queue
+     */
+    void init(const RetryPolicy& policy, Handler handler, void* user_data,
+              struct k_work_q* queue = nullptr);
+
+    void setRandomSource(RandomSource source) { random_ = source; }
+
+    /**
+     * @brief Arm the next attempt
+     *
+     * May be called from the handler: an attempt that is running does not
+     * count as pending.
+     *
+     * @return 0 on success, -EALREADY if an attempt is waiting to run,
+     *         -ETIMEDOUT if max_attempts is used up
+     */
+    int schedule();
+
+    /**
+     * @brief Cancel a pending attempt and clear the attempt count (on success)
+     */
+    void reset();
+
+    /// Attempts made since the last reset()
+    uint8_t getAttempts() const { return (uint8_t)atomic_get(&attempts_); }
+
+    /// Delay chosen for the most recent attempt
+    uint32_t getLastDelayMs() const { return last_delay_ms_; }
+
+    bool isPending() const { return k_work_delayable_is_pending(&work_); }
+
+    /**
+     * @brief Backoff ceiling for an attempt (1-based), before jitter
+     */
+    static uint32_t backoffCeilingMs(const RetryPolicy& policy, uint8_t attempt);
+
+private:
+    static void workHandler(struct k_work* work);
+
+    RetryPolicy policy_;
+    Handler handler_;
+    void* user_data_;
+    struct k_work_q* queue_;
+    RandomSource random_;
+    atomic_t attempts_;
+    uint32_t last_delay_ms_;
+    struct k_work_delayable work_;
+};
+
+}  // namespace retry
+}  // namespace services
+}  // namespace smarthome
+
+#endif  // RETRY_SCHEDULER_HPP
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "timer_wheel.hpp"
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+namespace smarthome { namespace services { namespace timer {
+
+/*=============================================================================
+ * Wheel
+ *===========================================================================*/
+
+TimerWheel::TimerWheel(uint64_t now_ms) {
+    reset(now_ms);
+}
+
+void TimerWheel::reset(uint64_t now_ms) {
+    for (uint8_t level = 0; level < LEVELS; level++) {
+        for (uint8_t slot = 0; slot < SLOTS; slot++) {
+            sys_dlist_init(&slots_[level][slot]);
+        }
+        occupied_[level] = 0;
+    }
+    sys_dlist_init(&due_);
+    clock_ = now_ms;
+    count_ = 0;
+    stats_ = {};
+}
+
+uint64_t TimerWheel::alignDeadline(uint64_t deadline_ms, uint32_t slack_ms) {
+    if (slack_ms < 2) {
+        return deadline_ms;
+    }
+
+    uint64_t grain = 1ULL << (31 - __builtin_clz(slack_ms));
+    return (deadline_ms + grain - 1) & ~(grain - 1);
+}
+
+void TimerWheel::insert(WheelTimer& timer) {
+    if (timer.expires <= clock_) {
+        timer.level = LEVELS;
+        sys_dlist_append(&due_, &timer.node);
+        return;
+    }
+
+    /* Past the horizon: park in the top level and re-queue on cascade */
+    uint64_t expires = timer.expires;
+    uint64_t delta = expires - clock_;
+    if (delta >= HORIZON_MS) {
+        delta = HORIZON_MS - 1;
+        expires = clock_ + delta;
+    }
+
+    uint8_t level = 0;
+    while (delta >= (1ULL << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    timer.level = level;
+    timer.slot = (expires >> (SLOT_BITS * level)) & (SLOTS - 1);
+    sys_dlist_append(&slots_[level][timer.slot], &timer.node);
+    occupied_[level] |= BIT64(timer.slot);
+}
+
+void TimerWheel::start(WheelTimer& timer, uint64_t now_ms, uint32_t delay_ms, uint32_t period_ms) {
+    cancel(timer);
+
+    timer.deadline = now_ms + delay_ms;
+    timer.expires = alignDeadline(timer.deadline, timer.slack_ms);
+    timer.period_ms = period_ms;
+    timer.active = true;
+    count_++;
+    insert(timer);
+}
+
+bool TimerWheel::cancel(WheelTimer& timer) {
+    if (!timer.active) {
+        return false;
+    }
+
+    sys_dlist_remove(&timer.node);
+    if (timer.level < LEVELS && sys_dlist_is_empty(&slots_[timer.level][timer.slot])) {
+        occupied_[timer.level] &= ~BIT64(timer.slot);
+    }
+    timer.active = false;
+    count_--;
+    return true;
+}
+
+uint8_t TimerWheel::firstSlot(uint8_t level, uint64_t* begins) const {
+    /* Slots after the current one, in the order their spans begin */
+    uint8_t shift = SLOT_BITS * level;
+    uint64_t block = clock_ >> shift;
+    uint8_t first = (block + 1) & (SLOTS - 1);
+    uint64_t map = occupied_[level];
+    uint64_t rotated = first ? (map >> first) | (map << (SLOTS - first)) : map;
+    uint8_t ahead = __builtin_ctzll(rotated);
+
+    *begins = (block + ahead + 1) << shift;
+    return (first + ahead) & (SLOTS - 1);
+}
+
+uint64_t TimerWheel::nextEvent() const {
+    if (!sys_dlist_is_empty(&due_)) {
+        return clock_;
+    }
+
+    uint64_t next = NEVER;
+    for (uint8_t level = 0; level < LEVELS; level++) {
+        if (occupied_[level]) {
+            uint64_t begins;
+            firstSlot(level, &begins);
+            next = MIN(next, begins);
+        }
+    }
+    return next;
+}
+
+uint64_t TimerWheel::nextExpiry() const {
+    if (!sys_dlist_is_empty(&due_)) {
+        return clock_;
+    }
+
+    uint64_t next = NEVER;
+    for (uint8_t level = 0; level < LEVELS; level++) {
+        if (!occupied_[level]) {
+            continue;
+        }
+
+        uint64_t begins;
+        uint8_t slot = firstSlot(level, &begins);
+        if (level == 0) {
+            next = MIN(next, begins);
+            continue;
+        }
+
+        /*
+         * Earlier slots of a level expire first; only this one is scanned.
+         * A timer parked past the horizon wakes the wheel at the cascade.
+         */
+        uint64_t ends = begins + (1ULL << (SLOT_BITS * level));
+        sys_dlist_t* list = const_cast<sys_dlist_t*>(&slots_[level][slot]);
+        WheelTimer* timer;
+        SYS_DLIST_FOR_EACH_CONTAINER(list, timer, node) {
+            next = MIN(next, timer->expires < ends ? timer->expires : begins);
+        }
+    }
+    return next;
+}
+
+void TimerWheel::process(uint64_t tick) {
+    /* Upper levels first: a cascade can refill the slot below */
+    for (uint8_t level = LEVELS - 1; level > 0; level--) {
+        uint8_t shift = SLOT_BITS * level;
+        if (tick & ((1ULL << shift) - 1)) {
+            continue;
+        }
+
+        uint8_t slot = (tick >> shift) & (SLOTS - 1);
+        if (!(occupied_[level] & BIT64(slot))) {
+            continue;
+        }
+
+        occupied_[level] &= ~BIT64(slot);
+        sys_dnode_t* node;
+        while ((node = sys_dlist_get(&slots_[level][slot])) != nullptr) {
+            insert(*CONTAINER_OF(node, WheelTimer, node));
+            stats_.cascaded++;
+        }
+    }
+
+    uint8_t slot = tick & (SLOTS - 1);
+    if (occupied_[0] & BIT64(slot)) {
+        occupied_[0] &= ~BIT64(slot);
+        sys_dnode_t* node;
+        while ((node = sys_dlist_get(&slots_[0][slot])) != nullptr) {
+            CONTAINER_OF(node, WheelTimer, node)->level = LEVELS;
+            sys_dlist_append(&due_, node);
+        }
+    }
+
+    if (!sys_dlist_is_empty(&due_)) {
+        stats_.expiries++;
+    }
+}
+
+WheelTimer* TimerWheel::expire(uint64_t now_ms) {
+    for (;;) {
+        sys_dnode_t* node = sys_dlist_get(&due_);
+        if (node) {
+            WheelTimer* timer = CONTAINER_OF(node, WheelTimer, node);
+            stats_.fired++;
+
+            if (timer->period_ms) {
+                /* Keep the phase; periods missed while busy are dropped */
+                timer->deadline += timer->period_ms;
+                if (timer->deadline <= now_ms) {
+                    timer->deadline = now_ms + timer->period_ms;
+                }
+                timer->expires = alignDeadline(timer->deadline, timer->slack_ms);
+                insert(*timer);
+            } else {
+                timer->active = false;
+                count_--;
+            }
+            return timer;
+        }
+
+        if (clock_ >= now_ms) {
+            return nullptr;
+        }
+
+        uint64_t next = nextEvent();
+        if (next > now_ms) {
+            clock_ = now_ms;
+            return nullptr;
+        }
+
+        clock_ = next;
+        process(next);
+    }
+}
+
+/*=============================================================================
+ * Service
+ *===========================================================================*/
+
+TimerService& TimerService::getInstance() {
+    static TimerService instance;
+    return instance;
+}
+
+TimerService::TimerService()
+    : wheel_(k_uptime_get())
+    , lock_{}
+    , queue_(&k_sys_work_q)
+    , armed_for_(TimerWheel::NEVER)
+    , wakeups_(0)
+{
+    k_work_init_delayable(&work_, workHandler);
+}
+
+void TimerService::init(struct k_work_q* queue) {
+    queue_ = queue ? queue : &k_sys_work_q;
+}
+
+void TimerService::rearm(uint64_t now_ms) {
+    uint64_t next = wheel_.nextExpiry();
+    if (next == armed_for_) {
+        return;
+    }
+
+    armed_for_ = next;
+    if (next == TimerWheel::NEVER) {
+        k_work_cancel_delayable(&work_);
+        return;
+    }
+    k_work_reschedule_for_queue(queue_, &work_, K_MSEC(next > now_ms ? next - now_ms : 0));
+}
+
+void TimerService::start(WheelTimer& timer, uint32_t delay_ms, uint32_t period_ms) {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    uint64_t now = k_uptime_get();
+    wheel_.start(timer, now, delay_ms, period_ms);
+    rearm(now);
+    k_spin_unlock(&lock_, key);
+}
+
+bool TimerService::stop(WheelTimer& timer) {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    bool stopped = wheel_.cancel(timer);
+    if (stopped) {
+        rearm(k_uptime_get());
+    }
+    k_spin_unlock(&lock_, key);
+    return stopped;
+}
+
+uint32_t TimerService::getRemainingMs(const WheelTimer& timer) const {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    uint64_t now = k_uptime_get();
+    uint64_t left = (timer.active && timer.expires > now) ? timer.expires - now : 0;
+    k_spin_unlock(&lock_, key);
+    return (uint32_t)MIN(left, (uint64_t)UINT32_MAX);
+}
+
+void TimerService::getStats(Stats& out) const {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    const TimerWheel::Stats& wheel = wheel_.getStats();
+    out.wakeups = wakeups_;
+    out.fired = wheel.fired;
+    out.expiries = wheel.expiries;
+    out.cascaded = wheel.cascaded;
+    out.armed = wheel_.size();
+    k_spin_unlock(&lock_, key);
+}
+
+void TimerService::workHandler(struct k_work* work) {
+    TimerService& self = getInstance();
+
+    k_spinlock_key_t key = k_spin_lock(&self.lock_);
+    uint64_t now = k_uptime_get();
+    self.wakeups_++;
+    self.armed_for_ = TimerWheel::NEVER;
+
+    /* Callbacks run unlocked; they may start and stop timers */
+    WheelTimer* timer;
+    while ((timer = self.wheel_.expire(now)) != nullptr) {
+        WheelTimer::Callback callback = timer->callback;
+        void* user_data = timer->user_data;
+
+        k_spin_unlock(&self.lock_, key);
+        if (callback) {
+            callback(*timer, user_data);
+        }
+        key = k_spin_lock(&self.lock_);
+    }
+
+    self.rearm(k_uptime_get());
+    k_spin_unlock(&self.lock_, key);
+}
+
+}  // namespace timer
+}  // namespace services
+}  // namespace smarthome
+
+/*=============================================================================
+ * Shell Commands
+ *===========================================================================*/
+
+#ifdef CONFIG_SHELL
+static int cmd_timer_stats(const struct shell* sh, size_t argc, char** argv) {
+    smarthome::services::timer::TimerService::Stats s;
+    smarthome::services::timer::TimerService::getInstance().getStats(s);
+
+    shell_print(sh, "armed %u, fired %u in %u expiries over %u wakeups, cascaded %u",
+                s.armed, s.fired, s.expiries, s.wakeups, s.cascaded);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_timer,
+    SHELL_CMD(stats, NULL, "Wheel counters", cmd_timer_stats),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(timer, &sub_timer, "Timer wheel", NULL);
+#endif
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ============================================================================
+ * TIMER WHEEL - Shared Software Timers on One Work Item
+ * ============================================================================
+ *
+ * Purpose:
+ *   Replaces per-manager k_timer instances. Every timer lives in one
+ *   hierarchical wheel driven by a single delayable work item, so expiry
+ *   callbacks run in work queue context (they may lock mutexes, send IPC,
+ *   touch settings) and the CPU wakes once per distinct deadline instead of
+ *   once per timer.
+ *
+ * Wheel:
+ *   4 levels of 64 slots, 1 ms per level-0 slot:
+ *
+ *     level 0   1 ms slots     < 64 ms ahead
+ *     level 1   64 ms slots    < 4.1 s ahead
+ *     level 2   4.1 s slots    < 4.4 min ahead
+ *     level 3   4.4 min slots  < 4.7 h ahead (further deadlines re-queue)
+ *
+ *   Insert and cancel are O(1) on intrusive lists. A slot of a higher
+ *   level is cascaded down when its span begins, so deadlines stay exact
+ *   to the millisecond. A 64-bit occupancy map per level finds the first
+ *   occupied slot without scanning the wheel; the work item is armed for
+ *   the earliest deadline and cascades on the way when it runs - there is
+ *   no periodic tick.
+ *
+ * Coalescing:
+ *   A timer may declare slack, the lateness it tolerates. Its deadline is
+ *   rounded up to a multiple of the largest power of two not above the
+ *   slack, so timers with overlapping windows land on the same millisecond
+ *   and expire in the same wakeup.
+ */
+
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+#include <stdint.h>
+
+namespace smarthome { namespace services { namespace timer {
+
+/**
+ * Timer node, embedded in its owner; init() once, then start through the
+ * TimerService
+ */
+struct WheelTimer {
+    /**
+     * @brief Expiry callback (work queue context)
+     * @param timer Timer that expired; may be restarted from the callback
+     * @param user_data Value given to init()
+     */
+    using Callback = void (*)(WheelTimer& timer, void* user_data);
+
+    void init(Callback cb, void* data = nullptr, uint32_t slack = 0) {
+        sys_dnode_init(&node);
+        callback = cb;
+        user_data = data;
+        slack_ms = slack;
+        period_ms = 0;
+        active = false;
+    }
+
+    sys_dnode_t node;
+    Callback callback;
+    void* user_data;
+    uint64_t deadline;          ///< Requested expiry, ms of uptime
+    uint64_t expires;           ///< Deadline after slack alignment
+    uint32_t period_ms;         ///< 0 = one-shot
+    uint32_t slack_ms;          ///< Tolerated lateness
+    uint8_t level;              ///< Wheel level, LEVELS = due list
+    uint8_t slot;
+    bool active;
+};
+
+/**
+ * Hierarchical timing wheel
+ *
+ * Pure logic with caller-supplied time; the caller serializes access and
+ * runs the callbacks of what expire() returns.
+ */
+class TimerWheel {
+public:
+    static constexpr uint8_t LEVELS = 4;
+    static constexpr uint8_t SLOT_BITS = 6;
+    static constexpr uint8_t SLOTS = 1U << SLOT_BITS;
+    static constexpr uint64_t HORIZON_MS = 1ULL << (LEVELS * SLOT_BITS);
+    static constexpr uint64_t NEVER = UINT64_MAX;
+
+    struct Stats {
+        uint32_t fired;             ///< Timers returned by expire()
+        uint32_t expiries;          ///< Distinct milliseconds that had timers due
+        uint32_t cascaded;          ///< Timers moved down a level
+    };
+
+    explicit TimerWheel(uint64_t now_ms = 0);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Drop all timers and restart the wheel clock
+     */
+    void reset(uint64_t now_ms);
+
+    /**
+     * @brief Arm (or re-arm) a timer
+     * @param delay_ms First expiry, from now_ms
+     * @param period_ms Re-arm interval after each expiry, 0 = one-shot
+     */
+    void start(WheelTimer& timer, uint64_t now_ms, uint32_t delay_ms, uint32_t period_ms = 0);
+
+    /**
+     * @brief Disarm a timer
+     * @return true if it was armed
+     */
+    bool cancel(WheelTimer& timer);
+
+    /**
+     * @brief Advance to now_ms and pop the next due timer
+     *
+     * Periodic timers are re-armed before they are returned, so the
+     * callback may cancel them. Call until nullptr, then arm a wakeup for
+     * nextExpiry().
+     *
+     * @return Due timer, nullptr when none is left at now_ms
+     */
+    WheelTimer* expire(uint64_t now_ms);
+
+    /**
+     * @brief Earliest deadline, what to arm the wakeup for
+     *
+     * Cascades in between are done by expire() on the way, they need no
+     * wakeup of their own. Scans the first occupied slot of each level.
+     *
+     * @return ms of uptime, NEVER when the wheel is empty
+     */
+    uint64_t nextExpiry() const;
+
+    uint16_t size() const { return count_; }
+    const Stats& getStats() const { return stats_; }
+
+    /**
+     * @brief Round a deadline up to share a wakeup, within slack_ms
+     */
+    static uint64_t alignDeadline(uint64_t deadline_ms, uint32_t slack_ms);
+
+private:
+    void insert(WheelTimer& timer);
+    void process(uint64_t tick);
+    uint8_t firstSlot(uint8_t level, uint64_t* begins) const;
+    uint64_t nextEvent() const;     ///< Next expiry or cascade
+
+    sys_dlist_t slots_[LEVELS][SLOTS];
+    uint64_t occupied_[LEVELS];     ///< Bit per non-empty slot
+    sys_dlist_t due_;               ///< Expired, not yet returned
+    uint64_t clock_;                ///< Last processed millisecond
+    uint16_t count_;
+    Stats stats_;
+};
+
+/**
+ * Timer Service
+ *
+ * Owns the wheel of the application core and the work item that drives
+ * it. All methods are ISR-safe; callbacks run on the work queue given to
+ * init() (the system work queue by default), one after the other.
+ */
+class TimerService {
+public:
+    static TimerService& getInstance();
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    /**
+     * @brief Select the work queue for callbacks, before the first start()
+     * @param queue nullptr = system work queue
+     */
+    void init(struct k_work_q* queue);
+
+    void start(WheelTimer& timer, uint32_t delay_ms, uint32_t period_ms = 0);
+    bool stop(WheelTimer& timer);
+
+    bool isRunning(const WheelTimer& timer) const { return timer.active; }
+
+    /// Time left before the timer expires, 0 if it is not running
+    uint32_t getRemainingMs(const WheelTimer& timer) const;
+
+    struct Stats {
+        uint32_t wakeups;           ///< Work item runs
+        uint32_t fired;
+        uint32_t expiries;
+        uint32_t cascaded;
+        uint16_t armed;             ///< Timers currently running
+    };
+
+    void getStats(Stats& out) const;
+
+private:
+    TimerService();
+    ~TimerService() = default;
+
+    static void workHandler(struct k_work* work);
+    void rearm(uint64_t now_ms);
+
+    TimerWheel wheel_;
+    mutable struct k_spinlock lock_;
+    struct k_work_q* queue_;
+    struct k_work_delayable work_;
+    uint64_t armed_for_;            ///< Expiry the work item is scheduled for
+    uint32_t wakeups_;
+};
+
+}  // namespace timer
+}  // namespace services
+}  // namespace smarthome
+
+#endif  // TIMER_WHEEL_HPP
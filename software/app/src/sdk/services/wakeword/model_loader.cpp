@@ -25,7 +25,7 @@ public:
 
     int infer(const float* input, size_t input_size,
               float* output, size_t output_size) override {
-        if (!loaded_ || !input || !output || output_size < 1) {
+        if (!loaded_ || !input || input_size == 0 || !output || output_size < 1) {
             return -EINVAL;
         }
 
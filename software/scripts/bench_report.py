@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Sprchuoi
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Collect the BENCH lines of the sdk test suites.
+
+Reads twister logs (handler.log under a twister-out directory, or any
+log files given) and writes the benchmark results as JSON or CSV. With
+--baseline, compares ns_per_op against an earlier JSON report and exits
+with status 1 when a case got slower than the threshold allows.
+
+Only clock=cycles results (qemu_cortex_m3, instruction counted) are
+compared by default; host clock results from native_sim vary with the
+machine and are reported but not gated unless --all-clocks is given.
+
+  bench_report.py twister-out -o bench.json
+  bench_report.py twister-out --baseline main.json --threshold 10
+"""
+
+import argparse
+import csv
+import json
+import os
+import re
+import sys
+
+LINE = re.compile(r"BENCH((?:\s+\w+=\S+)+)")
+FIELDS = ["suite", "case", "board", "clock", "samples", "ops",
+          "ns_per_op", "min_ns", "max_ns"]
+
+
+def log_files(paths):
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                if "handler.log" in files:
+                    yield os.path.join(root, "handler.log")
+        else:
+            yield path
+
+
+def parse(paths):
+    results = {}
+    for path in log_files(paths):
+        with open(path, errors="replace") as log:
+            for line in log:
+                match = LINE.search(line)
+                if not match:
+                    continue
+                entry = dict(kv.split("=", 1) for kv in match.group(1).split())
+                for key in ("samples", "ops", "ns_per_op", "min_ns", "max_ns"):
+                    entry[key] = int(entry.get(key, 0))
+                results[key_of(entry)] = entry
+    return [results[k] for k in sorted(results)]
+
+
+def key_of(entry):
+    return (entry.get("board", ""), entry.get("suite", ""), entry.get("case", ""))
+
+
+def compare(results, baseline_path, threshold, all_clocks):
+    with open(baseline_path) as f:
+        baseline = {key_of(e): e for e in json.load(f)}
+
+    regressions = 0
+    for entry in results:
+        old = baseline.get(key_of(entry))
+        if not old or old["ns_per_op"] == 0:
+            continue
+        if entry.get("clock") != "cycles" and not all_clocks:
+            continue
+        change = 100.0 * (entry["ns_per_op"] - old["ns_per_op"]) / old["ns_per_op"]
+        mark = ""
+        if change > threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        print(f"{entry['board']:<16} {entry['suite']}.{entry['case']:<28} "
+              f"{old['ns_per_op']:>10} -> {entry['ns_per_op']:>10} ns/op "
+              f"{change:+6.1f}%{mark}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("paths", nargs="+", help="twister-out directory or log files")
+    parser.add_argument("-o", "--output", help="write results here (.json or .csv)")
+    parser.add_argument("--baseline", help="earlier JSON report to compare with")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent (default 10)")
+    parser.add_argument("--all-clocks", action="store_true",
+                        help="also gate host clock (native_sim) results")
+    args = parser.parse_args()
+
+    results = parse(args.paths)
+    if not results:
+        print("no BENCH lines found", file=sys.stderr)
+        return 1
+
+    if args.output and args.output.endswith(".csv"):
+        with open(args.output, "w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=FIELDS, extrasaction="ignore")
+            writer.writeheader()
+            writer.writerows(results)
+    elif args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    else:
+        json.dump(results, sys.stdout, indent=2)
+        print()
+
+    if args.baseline:
+        regressions = compare(results, args.baseline, args.threshold, args.all_clocks)
+        if regressions:
+            print(f"{regressions} benchmark(s) slower than {args.threshold}%", file=sys.stderr)
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Sprchuoi
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Run a fleet of simulated devices and add up their metrics.
+
+Starts the native_sim fleet runner (tests/sim/fleet) once per device,
+each in a directory of its own (the simulated flash lives in the working
+directory), and combines the FLEET lines: operations, failures and the
+latency histograms of every step summed across devices, the fleet p50 /
+p99 taken from the summed histogram, queue and timer peaks as maxima.
+
+Link profiles (--links) are handed out round robin, so one run mixes
+devices on a clean link with devices on a lossy one.
+
+  west build -b native_sim tests/sim/fleet -d build/fleet
+  fleet_sim.py -n 64 --scenario building
+  fleet_sim.py -n 200 --steps "toggle:400@100" --links 0/0/0,20/10/50 -o fleet.json
+
+Exits 1 when a device failed operations, 2 when one crashed or printed
+no results.
+"""
+
+import argparse
+import concurrent.futures
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+LINE = re.compile(r"FLEET((?:\s+\w+=\S+)+)$")
+DONE = re.compile(r"FLEET device=\d+ done failed=\d+")
+PEAKS = ("max_ms", "app_rx_peak", "net_rx_peak", "armed_peak", "dispatch_max_us")
+HIST_BUCKETS = 16
+
+
+def run_device(binary, device, options, timeout):
+    with tempfile.TemporaryDirectory(prefix=f"fleet{device}-") as cwd:
+        cmd = [binary, f"--device={device}"] + options
+        try:
+            proc = subprocess.run(cmd, cwd=cwd, capture_output=True, text=True,
+                                  timeout=timeout)
+        except subprocess.TimeoutExpired:
+            return device, None, "timeout"
+    if not DONE.search(proc.stdout):
+        return device, None, proc.returncode
+    lines = []
+    for line in proc.stdout.splitlines():
+        match = LINE.search(line)
+        if match:
+            lines.append(dict(kv.split("=", 1) for kv in match.group(1).split()))
+    return device, lines, proc.returncode
+
+
+def percentile(hist, max_ms, pct):
+    done = sum(hist)
+    if done == 0:
+        return 0
+    rank = (done * pct + 99) // 100
+    seen = 0
+    for bucket, count in enumerate(hist):
+        seen += count
+        if seen >= rank:
+            return min((1 << bucket) - 1 if bucket else 0, max_ms)
+    return max_ms
+
+
+def aggregate(results):
+    steps = {}
+    totals = {"devices": 0, "crashed": 0, "failed_devices": 0}
+
+    for device, lines, status in results:
+        totals["devices"] += 1
+        if lines is None:
+            totals["crashed"] += 1
+            print(f"device {device}: no results ({status})", file=sys.stderr)
+            continue
+        if status == 1:
+            totals["failed_devices"] += 1
+
+        for ln in lines:
+            if "step" not in ln:
+                continue
+            key = (int(ln["index"]), ln["step"])
+            agg = steps.setdefault(key, {"step": ln["step"], "index": key[0],
+                                         "devices": 0, "ops_per_s": 0,
+                                         "hist": [0] * HIST_BUCKETS})
+            agg["devices"] += 1
+            agg["ops_per_s"] += int(ln["ops_per_s"])
+            for i, count in enumerate(ln["hist"].split(",")):
+                agg["hist"][i] += int(count)
+            for name, value in ln.items():
+                if name in ("device", "index", "step", "hist", "ops_per_s",
+                            "elapsed_ms", "p50_ms", "p99_ms"):
+                    continue
+                value = int(value)
+                if name in PEAKS:
+                    agg[name] = max(agg.get(name, 0), value)
+                else:
+                    agg[name] = agg.get(name, 0) + value
+
+    report = []
+    for key in sorted(steps):
+        agg = steps[key]
+        agg["p50_ms"] = percentile(agg["hist"], agg.get("max_ms", 0), 50)
+        agg["p99_ms"] = percentile(agg["hist"], agg.get("max_ms", 0), 99)
+        report.append(agg)
+    return totals, report
+
+
+def print_report(totals, report):
+    print(f"{totals['devices']} devices, {totals['failed_devices']} with failures, "
+          f"{totals['crashed']} without results")
+    print(f"{'step':<16} {'ops':>8} {'failed':>7} {'ops/s':>9} {'p50':>6} {'p99':>6} "
+          f"{'max':>6}  extra")
+    for agg in report:
+        extra = " ".join(f"{k}={v}" for k, v in agg.items()
+                         if k not in ("step", "index", "devices", "hist", "ops", "failed",
+                                      "ops_per_s", "p50_ms", "p99_ms", "max_ms"))
+        print(f"{agg['index']}:{agg['step']:<14} {agg.get('ops', 0):>8} "
+              f"{agg.get('failed', 0):>7} {agg['ops_per_s']:>9} {agg['p50_ms']:>6} "
+              f"{agg['p99_ms']:>6} {agg.get('max_ms', 0):>6}  {extra}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-n", "--devices", type=int, default=8, help="fleet size (default 8)")
+    parser.add_argument("--binary", default="build/fleet/zephyr/zephyr.exe",
+                        help="fleet runner image (default build/fleet/zephyr/zephyr.exe)")
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument("--scenario", default="smoke",
+                       help="preset script of the runner (default smoke)")
+    group.add_argument("--steps", help="workload script, see tests/sim/fleet/src/workloads.h")
+    parser.add_argument("--links", default="",
+                        help="comma separated latency/jitter/loss profiles, round robin")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(),
+                        help="devices simulated at once (default: CPUs)")
+    parser.add_argument("--timeout", type=int, default=600, help="seconds per device")
+    parser.add_argument("-o", "--output", help="write the report here as JSON")
+    args = parser.parse_args()
+
+    links = [p for p in args.links.split(",") if p]
+    binary = os.path.abspath(args.binary)
+
+    def options_of(device):
+        options = [f"--steps={args.steps}" if args.steps else f"--scenario={args.scenario}"]
+        if links:
+            options.append(f"--link={links[device % len(links)]}")
+        return options
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = [pool.submit(run_device, binary, d, options_of(d), args.timeout)
+                   for d in range(args.devices)]
+        results = [f.result() for f in futures]
+
+    totals, report = aggregate(results)
+    print_report(totals, report)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump({"totals": totals, "steps": report}, f, indent=2)
+
+    if totals["crashed"]:
+        return 2
+    return 1 if totals["failed_devices"] else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
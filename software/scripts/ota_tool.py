@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Sprchuoi
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Host helper for OtaManager.
+
+Subcommands:
+  info   Print size and SHA-256 of an image (the values OtaRequest needs)
+  diff   Build a delta patch (DeltaPatcher format) from an old and new image
+  serve  Serve a directory over HTTP with Range support, optionally
+         dropping connections to exercise resume
+"""
+
+import argparse
+import hashlib
+import http.server
+import os
+import struct
+import sys
+
+MAGIC = 0x4C444853  # "SHDL"
+VERSION = 1
+BLOCK = 32
+COPY_FLAG = 0x80000000
+
+
+def cmd_info(args):
+    data = open(args.image, "rb").read()
+    print(f"size:   {len(data)}")
+    print(f"sha256: {hashlib.sha256(data).hexdigest()}")
+
+
+def find_matches(old, new):
+    """Greedy exact block matching; returns [(new_pos, old_pos, length)]."""
+    index = {}
+    for off in range(0, len(old) - BLOCK + 1, BLOCK):
+        index.setdefault(old[off:off + BLOCK], off)
+
+    matches = []
+    i = 0
+    while i + BLOCK <= len(new):
+        o = index.get(new[i:i + BLOCK])
+        if o is None:
+            i += 1
+            continue
+        length = BLOCK
+        while (i + length < len(new) and o + length < len(old)
+               and new[i + length] == old[o + length]):
+            length += 1
+        matches.append((i, o, length))
+        i += length
+    return matches
+
+
+def cmd_diff(args):
+    old = open(args.old, "rb").read()
+    new = open(args.new, "rb").read()
+    matches = find_matches(old, new)
+
+    out = bytearray(struct.pack("<IB3xII", MAGIC, VERSION, len(new), len(old)))
+
+    def record(diff, extra, seek):
+        if diff and not any(diff):
+            # Unchanged run: only the length goes on the wire
+            out.extend(struct.pack("<IIi", len(diff) | COPY_FLAG, len(extra), seek))
+        else:
+            out.extend(struct.pack("<IIi", len(diff), len(extra), seek))
+            out.extend(diff)
+        out.extend(extra)
+
+    if not matches:
+        record(b"", new, 0)
+    else:
+        first_n, first_o, _ = matches[0]
+        if first_n > 0 or first_o > 0:
+            record(b"", new[:first_n], first_o)
+        for k, (n, o, length) in enumerate(matches):
+            diff = bytes((new[n + j] - old[o + j]) & 0xFF for j in range(length))
+            if k + 1 < len(matches):
+                next_n, next_o, _ = matches[k + 1]
+            else:
+                next_n, next_o = len(new), o + length
+            record(diff, new[n + length:next_n], next_o - (o + length))
+
+    open(args.output, "wb").write(out)
+    print(f"patch:  {len(out)} bytes ({100 * len(out) // max(len(new), 1)}% of new image)")
+    print(f"size:   {len(out)}  (OtaRequest.body_size)")
+    print(f"sha256: {hashlib.sha256(new).hexdigest()}  (OtaRequest.sha256)")
+
+
+class RangeHandler(http.server.SimpleHTTPRequestHandler):
+    drop_after = 0
+
+    def do_GET(self):
+        path = self.translate_path(self.path)
+        if not os.path.isfile(path):
+            self.send_error(404)
+            return
+
+        data = open(path, "rb").read()
+        start = 0
+        rng = self.headers.get("Range")
+        if rng and rng.startswith("bytes="):
+            start = int(rng[6:].split("-")[0] or 0)
+            self.send_response(206)
+            self.send_header("Content-Range", f"bytes {start}-{len(data) - 1}/{len(data)}")
+        else:
+            self.send_response(200)
+
+        body = data[start:]
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+
+        if self.drop_after and len(body) > self.drop_after:
+            self.wfile.write(body[:self.drop_after])
+            self.log_message("dropping connection after %d bytes", self.drop_after)
+            self.close_connection = True
+            return
+        self.wfile.write(body)
+
+
+def cmd_serve(args):
+    os.chdir(args.directory)
+    RangeHandler.drop_after = args.drop_after
+    server = http.server.ThreadingHTTPServer(("", args.port), RangeHandler)
+    print(f"Serving {args.directory} on port {args.port}")
+    server.serve_forever()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("info")
+    p.add_argument("image")
+    p.set_defaults(func=cmd_info)
+
+    p = sub.add_parser("diff")
+    p.add_argument("old", help="image currently in the primary slot")
+    p.add_argument("new", help="image to install")
+    p.add_argument("-o", "--output", required=True)
+    p.set_defaults(func=cmd_diff)
+
+    p = sub.add_parser("serve")
+    p.add_argument("directory")
+    p.add_argument("-p", "--port", type=int, default=8080)
+    p.add_argument("--drop-after", type=int, default=0,
+                   help="close each response after N body bytes (resume testing)")
+    p.set_defaults(func=cmd_serve)
+
+    args = parser.parse_args()
+    args.func(args)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
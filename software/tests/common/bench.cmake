@@ -0,0 +1,11 @@
+# Copyright (c) 2025 Sprchuoi
+# SPDX-License-Identifier: Apache-2.0
+#
+# Benchmark support for a suite: bench.h, and on native_sim the host
+# clock it reads, built into the native simulator runner.
+
+target_include_directories(app PRIVATE ${CMAKE_CURRENT_LIST_DIR})
+
+if(CONFIG_ARCH_POSIX)
+  target_sources(native_simulator INTERFACE ${CMAKE_CURRENT_LIST_DIR}/bench_host.c)
+endif()
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Benchmark cases for the sdk suites
+ *
+ * A benchmark times samples of an operation and prints one line per case
+ * for scripts/bench_report.py to collect from the twister logs:
+ *
+ *   BENCH suite=ipc case=echo_round_trip board=qemu_cortex_m3 clock=cycles
+ *         samples=200 ops=200 ns_per_op=.. min_ns=.. max_ns=..
+ *
+ * On qemu_cortex_m3 the cycle counter follows the instruction count, so
+ * the numbers repeat from run to run. native_sim time stands still while
+ * code runs; there the host monotonic clock is read instead (bench_host.c,
+ * built into the native simulator runner), which is real but noisy.
+ * Suites pull both in with include(../../common/bench.cmake).
+ */
+
+#ifndef TESTS_COMMON_BENCH_H
+#define TESTS_COMMON_BENCH_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#ifdef CONFIG_ARCH_POSIX
+extern "C" uint64_t bench_host_ns(void);
+#define BENCH_CLOCK "host"
+#else
+#define BENCH_CLOCK "cycles"
+#endif
+
+struct bench {
+	const char *suite;
+	const char *name;
+	uint32_t samples;
+	uint32_t ops;
+	uint64_t total_ns;
+	uint32_t min_ns;            /* Per op, over the samples */
+	uint32_t max_ns;
+	uint64_t start;
+};
+
+static inline uint64_t bench_now(void)
+{
+#ifdef CONFIG_ARCH_POSIX
+	return bench_host_ns();
+#else
+	return k_cycle_get_32();
+#endif
+}
+
+static inline uint64_t bench_elapsed_ns(uint64_t start)
+{
+#ifdef CONFIG_ARCH_POSIX
+	return bench_host_ns() - start;
+#else
+	return k_cyc_to_ns_floor64((uint32_t)(k_cycle_get_32() - (uint32_t)start));
+#endif
+}
+
+static inline void bench_init(struct bench *b, const char *suite, const char *name)
+{
+	*b = {};
+	b->suite = suite;
+	b->name = name;
+	b->min_ns = UINT32_MAX;
+}
+
+static inline void bench_begin(struct bench *b)
+{
+	b->start = bench_now();
+}
+
+/* End a sample that ran ops operations */
+static inline void bench_end(struct bench *b, uint32_t ops)
+{
+	uint64_t ns = bench_elapsed_ns(b->start);
+	uint32_t per_op = (uint32_t)(ns / (ops ? ops : 1));
+
+	b->samples++;
+	b->ops += ops;
+	b->total_ns += ns;
+	b->min_ns = MIN(b->min_ns, per_op);
+	b->max_ns = MAX(b->max_ns, per_op);
+}
+
+static inline void bench_report(const struct bench *b)
+{
+	TC_PRINT("BENCH suite=%s case=%s board=%s clock=%s samples=%u ops=%u "
+		 "ns_per_op=%u min_ns=%u max_ns=%u\n",
+		 b->suite, b->name, CONFIG_BOARD, BENCH_CLOCK, b->samples, b->ops,
+		 (uint32_t)(b->total_ns / (b->ops ? b->ops : 1)),
+		 b->samples ? b->min_ns : 0, b->max_ns);
+}
+
+#endif /* TESTS_COMMON_BENCH_H */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Host clock for benchmarks on native_sim
+ *
+ * Built into the native simulator runner, against the host C library:
+ * the embedded side cannot see host time, and simulated time does not
+ * move while code runs.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+uint64_t bench_host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
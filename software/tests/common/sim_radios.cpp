@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file NET core radios without a controller
+ *
+ * BLEManager and RadioManager for native_sim, which has neither a
+ * Bluetooth controller nor an 802.15.4 radio: the same state keeping as
+ * the real managers and their argument checks, with every operation that
+ * passes them succeeding. Connections are reported through
+ * BLEManager::onConnectionChanged() as on hardware. Shared by the
+ * single-process NET core builds (tests/sdk/dualcore, tests/sim/fleet,
+ * tests/fuzz/ipc).
+ */
+
+#include <zephyr/kernel.h>
+
+#include "ble/ble_manager.hpp"
+#include "radio/radio_manager.hpp"
+
+namespace smarthome { namespace protocol { namespace ble {
+
+BLEManager& BLEManager::getInstance()
+{
+	static BLEManager instance;
+	return instance;
+}
+
+BLEManager::BLEManager()
+	: m_state(BLEState::DISABLED)
+	, m_enabled(false)
+	, m_advertising(false)
+	, m_adv_interval_ms(0)
+	, m_conn_callback(nullptr)
+{
+	k_mutex_init(&m_mutex);
+}
+
+const char* BLEManager::getStateString() const
+{
+	return "SIM";
+}
+
+int BLEManager::init()
+{
+	m_enabled = true;
+	m_state = BLEState::IDLE;
+	return 0;
+}
+
+int BLEManager::startAdvertising(uint16_t interval_ms)
+{
+	if (interval_ms < ADV_INTERVAL_MIN_MS || interval_ms > ADV_INTERVAL_MAX_MS) {
+		return -EINVAL;
+	}
+	m_adv_interval_ms = interval_ms;
+	m_advertising = true;
+	m_state = BLEState::ADVERTISING;
+	return 0;
+}
+
+int BLEManager::stopAdvertising()
+{
+	m_advertising = false;
+	m_state = BLEState::IDLE;
+	return 0;
+}
+
+void BLEManager::onConnectionChanged(bool connected)
+{
+	m_state = connected ? BLEState::CONNECTED
+			    : (m_advertising ? BLEState::ADVERTISING : BLEState::IDLE);
+	if (m_conn_callback) {
+		m_conn_callback(connected);
+	}
+}
+
+} } } // namespace smarthome::protocol::ble
+
+namespace smarthome { namespace protocol { namespace radio {
+
+RadioManager& RadioManager::getInstance()
+{
+	static RadioManager instance;
+	return instance;
+}
+
+RadioManager::RadioManager()
+	: m_state(RadioState::DISABLED)
+	, m_enabled(false)
+	, m_current_channel(15)
+	, m_current_power(0)
+	, m_tx_count(0)
+	, m_rx_count(0)
+{
+	k_mutex_init(&m_mutex);
+}
+
+const char* RadioManager::getStateString() const
+{
+	return "SIM";
+}
+
+int RadioManager::init()
+{
+	return enable();
+}
+
+int RadioManager::enable()
+{
+	m_enabled = true;
+	m_state = RadioState::IDLE;
+	return 0;
+}
+
+int RadioManager::disable()
+{
+	m_enabled = false;
+	m_state = RadioState::DISABLED;
+	return 0;
+}
+
+int RadioManager::transmit(uint8_t channel, int8_t power_dbm, const uint8_t* data, size_t len)
+{
+	if (!data || len == 0 || len > MAX_PACKET_LEN ||
+	    channel < CHANNEL_MIN || channel > CHANNEL_MAX) {
+		return -EINVAL;
+	}
+	if (!m_enabled) {
+		return -ENOTSUP;
+	}
+	m_current_channel = channel;
+	m_current_power = power_dbm;
+	m_tx_count++;
+	return 0;
+}
+
+} } } // namespace smarthome::protocol::radio
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Sprchuoi
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Write the seed corpus of the IPC fuzz target.
+
+One input per request the NET core handles, valid and at the limits of
+its checks, and a few sequences and broken frames. Inputs are records of
+a length and a frame (see src/main.cpp).
+
+  make_corpus.py [corpus directory]
+"""
+
+import os
+import struct
+import sys
+
+RADIO_ENABLE, RADIO_DISABLE, RADIO_TX = 0x01, 0x02, 0x03
+BLE_ADV_START, BLE_ADV_STOP = 0x10, 0x11
+STATUS_REQUEST, ACK, NACK, POWER_MODE, HELLO, PING = 0x30, 0x32, 0x33, 0x34, 0x35, 0x36
+USER_MSG = 0x40
+MSG_FLAG_LARGE, MSG_FLAG_BATCH, MSG_FLAG_REPLY = 0x01, 0x02, 0x04
+IPC_CAP_HEARTBEAT = 0x04
+
+
+def message(mtype, payload=b"", priority=1, flags=0, seq=0):
+    """32-byte Message: type, priority, flags, sequence, timestamp, payload."""
+    return struct.pack("<BBBBI", mtype, priority, flags, seq, 0) + payload.ljust(24, b"\0")
+
+
+def radio(channel, power, data):
+    return struct.pack("<BBH", channel, power & 0xFF, len(data)) + data.ljust(20, b"\0")
+
+
+def ble(interval_ms, adv_type=0, data=b""):
+    return struct.pack("<HBB", interval_ms, adv_type, len(data)) + data.ljust(20, b"\0")
+
+
+def hello(major=1, minor=0, max_payload=448, caps=0x03, types=b"\xff" * 16):
+    return struct.pack("<BBHI", major, minor, max_payload, caps) + types
+
+
+def params(*values):
+    return struct.pack(f"<{len(values)}I", *values)
+
+
+def record(frame):
+    n = len(frame)
+    header = bytes([n]) if n < 0x80 else bytes([0x80 | n >> 8, n & 0xFF])
+    return header + frame
+
+
+def inputs():
+    yield "status", [message(STATUS_REQUEST)]
+    yield "radio_tx", [message(RADIO_TX, radio(15, 0, b"\x01\x02\x03\x04"))]
+    yield "radio_tx_full", [message(RADIO_TX, radio(26, -20, bytes(range(20))))]
+    yield "radio_tx_channel", [message(RADIO_TX, radio(10, 0, b"\xaa"))]
+    yield "radio_off_tx_on", [message(RADIO_DISABLE),
+                              message(RADIO_TX, radio(11, 4, b"\x55")),
+                              message(RADIO_ENABLE)]
+    yield "adv_start_stop", [message(BLE_ADV_START, ble(100), priority=2, flags=0x06),
+                             message(BLE_ADV_STOP)]
+    yield "adv_limits", [message(BLE_ADV_START, ble(20)), message(BLE_ADV_STOP),
+                         message(BLE_ADV_START, ble(10240, 0, b"\x02\x01\x06")),
+                         message(BLE_ADV_STOP)]
+    yield "power_mode", [message(POWER_MODE, params(1)), message(POWER_MODE, params(0))]
+    yield "ack_nack", [message(ACK, params(RADIO_TX)), message(NACK, params(BLE_ADV_START))]
+    yield "user", [message(USER_MSG, bytes(range(24)), priority=3)]
+    yield "invalid", [message(0x00), message(0xFF), message(STATUS_REQUEST, priority=4)]
+    yield "short", [message(STATUS_REQUEST)[:31], b"\x30"]
+    yield "long", [message(STATUS_REQUEST) + b"\0" * 8]
+    yield "large", [message(USER_MSG, flags=MSG_FLAG_LARGE) + bytes(range(256)) + bytes(44)]
+    yield "large_oversize", [message(USER_MSG, flags=MSG_FLAG_LARGE) + bytes(range(256)) * 2]
+    yield "hello", [message(HELLO, hello(), flags=MSG_FLAG_REPLY), message(STATUS_REQUEST)]
+    yield "hello_refused", [message(HELLO, hello(major=2)), message(STATUS_REQUEST),
+                            message(HELLO, hello(caps=0, max_payload=0))]
+    yield "heartbeat", [message(HELLO, hello(minor=1, caps=0x03 | IPC_CAP_HEARTBEAT)),
+                        message(PING), message(STATUS_REQUEST),
+                        message(HELLO, hello(minor=1), flags=MSG_FLAG_REPLY)]
+    yield "batch", [b"".join(message(STATUS_REQUEST if i % 2 else RADIO_TX,
+                                     radio(15, 0, b"\x01"), flags=MSG_FLAG_BATCH, seq=i)
+                             for i in range(8))]
+    yield "batch_ragged", [message(STATUS_REQUEST, flags=MSG_FLAG_BATCH) + bytes(40)]
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), "corpus")
+    os.makedirs(out, exist_ok=True)
+    for name, frames in inputs():
+        with open(os.path.join(out, name), "wb") as f:
+            f.write(b"".join(record(frame) for frame in frames))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
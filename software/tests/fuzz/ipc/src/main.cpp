@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file libFuzzer target: frames from the APP core into the NET core
+ *
+ * Every input is split into frames handed to IPCCore the way the RPMsg
+ * endpoint does (the transport's received callback), so they take the
+ * whole NET path: onMessageReceived, the RX queues and thread, dispatch
+ * and the NetCoreManager handlers, whose replies go to a transport that
+ * only counts them. The transport answers the HELLO of NetCoreManager::init
+ * as an APP core of the same protocol would; later HELLOs come from inputs.
+ *
+ * The kernel, IPCCore and NetCoreManager come up once; libFuzzer raises
+ * CONFIG_ARCH_POSIX_FUZZ_IRQ per input and the kernel runs for
+ * CONFIG_ARCH_POSIX_FUZZ_TICKS after it, so state carries over from one
+ * input to the next as on a running device.
+ *
+ * Input: records of a length and that many bytes. The length is one byte,
+ * or two (big endian, top bit set in the first) for large frames:
+ *
+ *   20 <32-byte message> 81 2c <300-byte large frame> ...
+ *
+ *   west build -b native_sim/native/64 tests/fuzz/ipc -d build/fuzz \
+ *       -- -DZEPHYR_TOOLCHAIN_VARIANT=llvm
+ *   build/fuzz/zephyr/zephyr.exe -dict=tests/fuzz/ipc/ipc.dict \
+ *       -max_total_time=600 corpus/ tests/fuzz/ipc/corpus
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/irq.h>
+#include <string.h>
+
+#include "ipc_core.hpp"
+#include "ipc_transport.hpp"
+#include "net_core.hpp"
+
+using namespace smarthome::ipc;
+
+/* Set by the POSIX arch for every input */
+extern "C" const uint8_t *posix_fuzz_buf;
+extern "C" size_t posix_fuzz_sz;
+
+/* Longer than any frame the NET core takes, to reach the length checks */
+#define MAX_RECORD 512
+
+class FuzzTransport : public IpcTransport {
+public:
+	int open(const TransportCallbacks &cb, void *priv) override
+	{
+		cb_ = cb;
+		priv_ = priv;
+		cb_.bound(priv_);
+		return 0;
+	}
+
+	int send(const void *data, size_t len) override
+	{
+		const Message *msg = static_cast<const Message *>(data);
+
+		sent_++;
+		if (msg->type == MessageType::HELLO && (msg->flags & MSG_FLAG_REPLY)) {
+			Message hello = MessageBuilder(MessageType::HELLO).build();
+
+			hello.payload.hello.version_major = IPC_PROTOCOL_MAJOR;
+			hello.payload.hello.version_minor = IPC_PROTOCOL_MINOR;
+			hello.payload.hello.max_payload = IPCCore::MAX_LARGE_PAYLOAD;
+			hello.payload.hello.caps = IPC_CAP_LARGE | IPC_CAP_BATCH;
+			receive(reinterpret_cast<const uint8_t *>(&hello), sizeof(hello));
+		}
+		return (int)len;
+	}
+
+	const char *name() const override
+	{
+		return "fuzz";
+	}
+
+	void receive(const uint8_t *data, size_t len)
+	{
+		/*
+		 * Ends the copy at the end of the buffer: reading past the
+		 * frame is past a global, which ASan catches, and not into
+		 * the next record.
+		 */
+		uint8_t *frame = frame_ + sizeof(frame_) - len;
+
+		memcpy(frame, data, len);
+		cb_.received(frame, len, priv_);
+	}
+
+private:
+	TransportCallbacks cb_;
+	void *priv_;
+	uint32_t sent_;
+	uint8_t frame_[MAX_RECORD];
+};
+
+static FuzzTransport transport;
+static K_SEM_DEFINE(fuzz_sem, 0, 1);
+
+static void fuzz_isr(const void *arg)
+{
+	/* Take the input on a thread, as the mailbox ISR hands frames on */
+	k_sem_give(&fuzz_sem);
+}
+
+static void run_input(const uint8_t *data, size_t size)
+{
+	while (size > 0) {
+		size_t len = data[0];
+		size_t header = 1;
+
+		if ((len & 0x80) && size > 1) {
+			len = ((len & 0x7F) << 8) | data[1];
+			header = 2;
+		}
+		data += header;
+		size -= header;
+
+		len = MIN(len, MIN(size, (size_t)MAX_RECORD));
+		if (len > 0) {
+			transport.receive(data, len);
+		}
+		data += len;
+		size -= len;
+	}
+}
+
+int main(void)
+{
+	IPCCore::bindThread(Core::NET);
+	IPCCore::getInstance().setTransport(transport);
+
+	if (net::NetCoreManager::getInstance().init() < 0) {
+		k_panic();
+	}
+
+	IRQ_CONNECT(CONFIG_ARCH_POSIX_FUZZ_IRQ, 0, fuzz_isr, NULL, 0);
+	irq_enable(CONFIG_ARCH_POSIX_FUZZ_IRQ);
+
+	while (true) {
+		k_sem_take(&fuzz_sem, K_FOREVER);
+		run_input(posix_fuzz_buf, posix_fuzz_sz);
+	}
+	return 0;
+}
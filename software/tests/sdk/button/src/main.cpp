@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Button manager tests
+ *
+ * ButtonManager on four emulated active-low buttons: press callbacks on
+ * the edge to active only, pressed state, the debounce window per
+ * button and callback registration.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <string.h>
+
+#include "hw/button/button_manager.hpp"
+
+using namespace smarthome::hw;
+
+static const struct gpio_dt_spec keys[MAX_BUTTONS] = {
+	GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios),
+	GPIO_DT_SPEC_GET(DT_ALIAS(sw1), gpios),
+	GPIO_DT_SPEC_GET(DT_ALIAS(sw2), gpios),
+	GPIO_DT_SPEC_GET(DT_ALIAS(sw3), gpios),
+};
+
+static uint32_t presses[MAX_BUTTONS];
+static uint8_t last_id;
+
+static void on_press(uint8_t button_id)
+{
+	presses[button_id]++;
+	last_id = button_id;
+}
+
+/* Active low: the pin reads 0 while the button is held */
+static void press(uint8_t id)
+{
+	zassert_ok(gpio_emul_input_set(keys[id].port, keys[id].pin, 0));
+}
+
+static void release(uint8_t id)
+{
+	zassert_ok(gpio_emul_input_set(keys[id].port, keys[id].pin, 1));
+}
+
+static void *button_setup(void)
+{
+	ButtonManager &buttons = ButtonManager::getInstance();
+
+	zassert_ok(buttons.init());
+	zassert_equal(buttons.getButtonCount(), MAX_BUTTONS);
+
+	for (uint8_t i = 0; i < MAX_BUTTONS; i++) {
+		release(i);
+		zassert_ok(buttons.registerCallback(i, on_press));
+	}
+	return NULL;
+}
+
+static void button_before(void *fixture)
+{
+	for (uint8_t i = 0; i < MAX_BUTTONS; i++) {
+		release(i);
+	}
+
+	/* Out of every debounce window */
+	k_sleep(K_MSEC(DEBOUNCE_MS));
+	memset(presses, 0, sizeof(presses));
+}
+
+ZTEST(button_manager, test_press_calls_back)
+{
+	ButtonManager &buttons = ButtonManager::getInstance();
+
+	press(2);
+	zassert_equal(presses[2], 1);
+	zassert_equal(last_id, 2);
+	zassert_true(buttons.isPressed(2));
+	zassert_false(buttons.isPressed(1));
+
+	/* Letting go is not a press */
+	release(2);
+	zassert_false(buttons.isPressed(2));
+	zassert_equal(presses[2], 1);
+}
+
+ZTEST(button_manager, test_debounce)
+{
+	/* Contact bounce inside the window is one press */
+	press(0);
+	release(0);
+	k_sleep(K_MSEC(DEBOUNCE_MS / 2));
+	press(0);
+	release(0);
+	zassert_equal(presses[0], 1);
+
+	/* Measured from the accepted press, not the bounce */
+	k_sleep(K_MSEC(DEBOUNCE_MS / 2));
+	press(0);
+	zassert_equal(presses[0], 2);
+}
+
+ZTEST(button_manager, test_buttons_independent)
+{
+	/* One button's window does not hold back another */
+	press(0);
+	press(1);
+	press(3);
+	zassert_equal(presses[0], 1);
+	zassert_equal(presses[1], 1);
+	zassert_equal(presses[2], 0);
+	zassert_equal(presses[3], 1);
+}
+
+ZTEST(button_manager, test_registration)
+{
+	ButtonManager &buttons = ButtonManager::getInstance();
+
+	zassert_equal(buttons.registerCallback(MAX_BUTTONS, on_press), -EINVAL);
+	zassert_false(buttons.isPressed(MAX_BUTTONS));
+
+	/* No callback: the press is debounced and dropped */
+	zassert_ok(buttons.registerCallback(1, nullptr));
+	press(1);
+	zassert_equal(presses[1], 0);
+	zassert_ok(buttons.registerCallback(1, on_press));
+}
+
+ZTEST_SUITE(button_manager, NULL, button_setup, button_before, NULL, NULL);
@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file APP and NET core in one process
+ *
+ * Both IPCCore instances linked by the loopback transport. The NET side
+ * is the real NetCoreManager, started on a work queue tagged as the NET
+ * core; the APP side is the test thread and CommissioningDelegate. Covers
+ * the AppTask phase 1 status handshake, what the HELLO exchange agreed on
+ * and batch frames to the NET handlers, the commissioning window driving
+ * BLE advertising and the connection event back, requests the NET core
+ * must refuse, injected latency, jitter and loss, TX back-pressure, a link
+ * outage caught by the heartbeat with state resynced after it, the
+ * heartbeat dropped in LOW_POWER, and a round trip benchmark. The net_update variant (net_update.conf) also times a
+ * full NET image transfer.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+
+#include "ipc_core.hpp"
+#include "ipc_loopback.hpp"
+#include "net_core.hpp"
+#include "ble/ble_manager.hpp"
+#include "matter/commission/commissioning_delegate.hpp"
+#include "bench.h"
+
+#ifdef CONFIG_APP_NET_UPDATE
+#include <mbedtls/sha256.h>
+#include "ota/net_update_client.hpp"
+
+using smarthome::services::ota::NetUpdateClient;
+using smarthome::services::ota::NetUpdateImage;
+namespace netdfu = smarthome::services::ota::netdfu;
+#endif
+
+using namespace smarthome::ipc;
+using smarthome::protocol::ble::BLEManager;
+using smarthome::protocol::matter::CommissioningAttempt;
+using smarthome::protocol::matter::CommissioningDelegate;
+using smarthome::protocol::matter::CommissioningStage;
+
+static LoopbackTransport app_end;
+static LoopbackTransport net_end;
+
+/* NET core context: a work queue whose thread is tagged Core::NET */
+static K_THREAD_STACK_DEFINE(net_stack, 4096);
+static struct k_work_q net_q;
+static struct k_work net_work;
+static struct k_sem net_done;
+static void (*net_fn)(void);
+
+/* What the APP core received */
+K_MSGQ_DEFINE(app_rx, sizeof(Message), 16, 4);
+
+static int net_init_ret;
+
+static void net_work_handler(struct k_work *work)
+{
+	net_fn();
+	k_sem_give(&net_done);
+}
+
+static void net_submit(void (*fn)(void))
+{
+	net_fn = fn;
+	k_work_submit_to_queue(&net_q, &net_work);
+}
+
+/* Run fn on the NET core and wait for it */
+static void net_run(void (*fn)(void))
+{
+	net_submit(fn);
+	zassert_ok(k_sem_take(&net_done, K_SECONDS(1)));
+}
+
+static void net_bind(void)
+{
+	IPCCore::bindThread(Core::NET);
+}
+
+static void net_boot(void)
+{
+	net_init_ret = net::NetCoreManager::getInstance().init();
+}
+
+static void net_ble_connect(void)
+{
+	BLEManager::getInstance().onConnectionChanged(true);
+}
+
+static void net_ble_disconnect(void)
+{
+	BLEManager::getInstance().onConnectionChanged(false);
+}
+
+/* What a NET core reset loses */
+static void net_ble_reset(void)
+{
+	BLEManager::getInstance().stopAdvertising();
+}
+
+static void on_app_msg(const Message &msg)
+{
+	(void)k_msgq_put(&app_rx, &msg, K_NO_WAIT);
+}
+
+/* Next message of a type on the APP core, others skipped */
+static int expect(MessageType type, Message *out, uint32_t timeout_ms)
+{
+	int64_t deadline = k_uptime_get() + timeout_ms;
+
+	while (k_uptime_get() < deadline) {
+		if (k_msgq_get(&app_rx, out, K_MSEC(deadline - k_uptime_get())) < 0) {
+			break;
+		}
+		if (out->type == type) {
+			return 0;
+		}
+	}
+	return -ETIMEDOUT;
+}
+
+static Message radio_tx(void)
+{
+	Message msg = MessageBuilder(MessageType::RADIO_TX).build();
+
+	msg.payload.radio.channel = 15;
+	msg.payload.radio.data_len = 4;
+	return msg;
+}
+
+static void configure(const LoopbackConfig &app, const LoopbackConfig &net)
+{
+	app_end.configure(app);
+	net_end.configure(net);
+}
+
+static void *dualcore_setup(void)
+{
+	IPCCore &app = IPCCore::getInstance(Core::APP);
+	IPCCore &net_ipc = IPCCore::getInstance(Core::NET);
+
+	zassert_ok(settings_subsys_init());
+	k_sem_init(&net_done, 0, 1);
+	k_work_init(&net_work, net_work_handler);
+	k_work_queue_start(&net_q, net_stack, K_THREAD_STACK_SIZEOF(net_stack),
+			   K_PRIO_PREEMPT(1), NULL);
+	net_run(net_bind);
+
+	LoopbackTransport::connect(app_end, net_end);
+	zassert_ok(app.setTransport(app_end));
+	zassert_ok(net_ipc.setTransport(net_end));
+
+	/* Idle PINGs would show in the frame counts; test_link_outage turns them on */
+	zassert_ok(app.setHeartbeat(0, 0));
+	zassert_ok(net_ipc.setHeartbeat(0, 0));
+
+	/* NET boots and waits for the link while the APP core brings it up */
+	net_submit(net_boot);
+	zassert_ok(app.init());
+	zassert_ok(k_sem_take(&net_done, K_SECONDS(1)));
+	zassert_ok(net_init_ret);
+	zassert_equal(app.setTransport(app_end), -EBUSY);
+
+	/* Untagged threads are the APP core */
+	zassert_equal(&IPCCore::getInstance(), &app);
+
+	zassert_ok(CommissioningDelegate::getInstance().init());
+	app.registerCallback(MessageType::STATUS_RESPONSE, on_app_msg);
+	app.registerCallback(MessageType::ACK, on_app_msg);
+	app.registerCallback(MessageType::NACK, on_app_msg);
+	app.registerCallback(MessageType::BLE_CONNECT, on_app_msg);
+#ifdef CONFIG_APP_NET_UPDATE
+	zassert_ok(NetUpdateClient::getInstance().init());
+#endif
+	return NULL;
+}
+
+static void dualcore_before(void *fixture)
+{
+	configure({}, {});
+	CommissioningDelegate::getInstance().closeCommissioningWindow();
+	k_sleep(K_MSEC(10));
+
+	app_end.resetStats();
+	net_end.resetStats();
+	IPCCore::getInstance(Core::APP).resetStats();
+	IPCCore::getInstance(Core::NET).resetStats();
+	k_msgq_purge(&app_rx);
+}
+
+/*=============================================================================
+ * APP <-> NET
+ *===========================================================================*/
+
+ZTEST(dual_core, test_phase1_handshake)
+{
+	IPCCore &app = IPCCore::getInstance();
+	IPCCore &net_ipc = IPCCore::getInstance(Core::NET);
+	Message rsp;
+
+	zassert_true(app.isReady());
+	zassert_true(net_ipc.isReady());
+	zassert_equal(app.getCore(), Core::APP);
+	zassert_equal(net_ipc.getCore(), Core::NET);
+
+	/* AppTask::initPhase1_IPC: status request once IPC is up */
+	zassert_ok(app.send(MessageBuilder(MessageType::STATUS_REQUEST).build()));
+	zassert_ok(expect(MessageType::STATUS_RESPONSE, &rsp, 100));
+	zassert_equal(rsp.payload.params.param1, (uint32_t)net::NetCoreState::OPERATING);
+	zassert_equal(rsp.payload.params.param2, 1, "BLE enabled");
+	zassert_equal(rsp.payload.params.param3, 1, "radio enabled");
+
+	/* One frame each way, counted by the instance of each core */
+	zassert_equal(app.getStats().tx_count, 1);
+	zassert_equal(app.getStats().rx_count, 1);
+	zassert_equal(net_ipc.getStats().tx_count, 1);
+	zassert_equal(net_ipc.getStats().rx_count, 1);
+	zassert_equal(app_end.getStats().sent, 1);
+	zassert_equal(net_end.getStats().delivered, 1);
+}
+
+ZTEST(dual_core, test_link_negotiation)
+{
+	IPCCore &app = IPCCore::getInstance();
+	IPCCore &net_ipc = IPCCore::getInstance(Core::NET);
+	Message batch[6];
+	Message msg;
+
+	/* Same build on both sides: everything on offer is taken */
+	zassert_equal(app.getPeerInfo().version_major, IPC_PROTOCOL_MAJOR);
+	zassert_true(app.linkHas(IPC_CAP_LARGE | IPC_CAP_BATCH));
+	zassert_true(net_ipc.linkHas(IPC_CAP_BATCH));
+	zassert_equal(app.maxLargePayload(), IPCCore::MAX_LARGE_PAYLOAD);
+
+	/* NET registers before its HELLO, APP announces late handlers again */
+	zassert_true(app.peerSupports(MessageType::RADIO_TX));
+	zassert_true(app.peerSupports(MessageType::BLE_ADV_START));
+	zassert_equal(app.peerSupports(MessageType::NET_DFU_CHUNK),
+		      IS_ENABLED(CONFIG_APP_NET_UPDATE));
+	zassert_true(net_ipc.peerSupports(MessageType::BLE_CONNECT));
+	zassert_true(net_ipc.peerSupports(MessageType::STATUS_RESPONSE));
+	zassert_false(net_ipc.peerSupports(MessageType::RADIO_TX));
+
+	/* Six requests in one frame, each handled and acknowledged */
+	for (size_t i = 0; i < ARRAY_SIZE(batch); i++) {
+		batch[i] = radio_tx();
+	}
+	zassert_ok(app.sendBatch(batch, ARRAY_SIZE(batch)));
+	for (size_t i = 0; i < ARRAY_SIZE(batch); i++) {
+		zassert_ok(expect(MessageType::ACK, &msg, 100));
+		zassert_equal(msg.payload.params.param1, (uint32_t)MessageType::RADIO_TX);
+	}
+	zassert_equal(app_end.getStats().sent, 1);
+	zassert_equal(net_ipc.getStats().batch_rx_count, 1);
+	zassert_equal(net_ipc.getStats().rx_count, ARRAY_SIZE(batch));
+}
+
+ZTEST(dual_core, test_commissioning_window)
+{
+	CommissioningDelegate &delegate = CommissioningDelegate::getInstance();
+	BLEManager &ble = BLEManager::getInstance();
+	CommissioningAttempt attempt;
+	Message msg;
+
+	/* BLE_ADV_START: the NET core advertises and acknowledges */
+	zassert_ok(delegate.openCommissioningWindow(60));
+	zassert_ok(expect(MessageType::ACK, &msg, 100));
+	zassert_equal(msg.payload.params.param1, (uint32_t)MessageType::BLE_ADV_START);
+	zassert_true(ble.isAdvertising());
+	zassert_true(delegate.getAttempt(0, attempt));
+	zassert_true(attempt.reached & BIT((int)CommissioningStage::ADV_STARTED));
+
+	/* A commissioner connects on the NET core */
+	net_run(net_ble_connect);
+	zassert_ok(expect(MessageType::BLE_CONNECT, &msg, 100));
+	zassert_true(delegate.getAttempt(0, attempt));
+	zassert_true(attempt.reached & BIT((int)CommissioningStage::BLE_CONNECTED));
+
+	net_run(net_ble_disconnect);
+	zassert_ok(delegate.closeCommissioningWindow());
+	zassert_ok(expect(MessageType::ACK, &msg, 100));
+	zassert_equal(msg.payload.params.param1, (uint32_t)MessageType::BLE_ADV_STOP);
+	zassert_false(ble.isAdvertising());
+}
+
+ZTEST(dual_core, test_untrusted_requests)
+{
+	IPCCore &app = IPCCore::getInstance();
+	Message req = radio_tx();
+	Message msg;
+
+	/* The NET core refuses what the message can not hold or the radio can not do */
+	zassert_ok(app.send(req));
+	zassert_ok(expect(MessageType::ACK, &msg, 100));
+	zassert_equal(msg.payload.params.param1, (uint32_t)MessageType::RADIO_TX);
+
+	req.payload.radio.data_len = sizeof(req.payload.radio.data) + 1;
+	zassert_ok(app.send(req));
+	zassert_ok(expect(MessageType::NACK, &msg, 100));
+	zassert_equal(msg.payload.params.param1, (uint32_t)MessageType::RADIO_TX);
+
+	req = radio_tx();
+	req.payload.radio.channel = 5;
+	zassert_ok(app.send(req));
+	zassert_ok(expect(MessageType::NACK, &msg, 100));
+
+	req = MessageBuilder(MessageType::BLE_ADV_START).build();
+	req.payload.ble.adv_interval_ms = 0xFFFF;
+	zassert_ok(app.send(req));
+	zassert_ok(expect(MessageType::NACK, &msg, 100));
+	zassert_equal(msg.payload.params.param1, (uint32_t)MessageType::BLE_ADV_START);
+
+	req.payload.ble.adv_interval_ms = 100;
+	req.payload.ble.adv_data_len = 200;
+	zassert_ok(app.send(req));
+	zassert_ok(expect(MessageType::NACK, &msg, 100));
+	zassert_false(BLEManager::getInstance().isAdvertising());
+}
+
+/*=============================================================================
+ * Fault injection
+ *===========================================================================*/
+
+ZTEST(dual_core, test_latency)
+{
+	IPCCore &app = IPCCore::getInstance();
+	LoopbackConfig cfg = {};
+	Message rsp;
+
+	/* Paid once each way */
+	cfg.latency_ms = 20;
+	configure(cfg, cfg);
+
+	int64_t start = k_uptime_get();
+
+	zassert_ok(app.sendSync(radio_tx(), 200));
+	int64_t rtt = k_uptime_get() - start;
+
+	zassert_true(rtt >= 40 && rtt < 50, "round trip %lld ms", rtt);
+
+	/* Jitter delays frames but never reorders them */
+	cfg.jitter_ms = 15;
+	cfg.seed = 7;
+	configure(cfg, cfg);
+
+	for (int i = 0; i < 6; i++) {
+		zassert_ok(app.send(MessageBuilder(MessageType::STATUS_REQUEST).build()));
+	}
+
+	zassert_ok(expect(MessageType::STATUS_RESPONSE, &rsp, 200));
+	uint8_t seq = rsp.sequence_id;
+
+	for (int i = 1; i < 6; i++) {
+		zassert_ok(expect(MessageType::STATUS_RESPONSE, &rsp, 200));
+		zassert_equal(rsp.sequence_id, (uint8_t)(seq + i));
+	}
+}
+
+ZTEST(dual_core, test_loss)
+{
+	IPCCore &app = IPCCore::getInstance();
+	LoopbackConfig app_cfg = {};
+	LoopbackConfig net_cfg = {};
+
+	/* Every request lost: the exchange times out, nothing reaches NET */
+	app_cfg.loss_permille = 1000;
+	configure(app_cfg, net_cfg);
+	zassert_equal(app.sendSync(radio_tx(), 50), -ETIMEDOUT);
+	zassert_equal(app_end.getStats().lost, 1);
+	zassert_equal(IPCCore::getInstance(Core::NET).getStats().rx_count, 0);
+
+	/* 30 % each way: an exchange fails when its request or its ACK is lost */
+	app_cfg.loss_permille = 300;
+	app_cfg.seed = 1;
+	net_cfg.loss_permille = 300;
+	net_cfg.seed = 2;
+	configure(app_cfg, net_cfg);
+	app_end.resetStats();
+
+	int ok = 0;
+
+	for (int i = 0; i < 40; i++) {
+		if (app.sendSync(radio_tx(), 20) == 0) {
+			ok++;
+		}
+	}
+
+	uint32_t lost = app_end.getStats().lost + net_end.getStats().lost;
+
+	zassert_equal(ok + lost, 40);
+	zassert_true(ok > 0 && lost > 0, "ok %d lost %u", ok, lost);
+}
+
+ZTEST(dual_core, test_back_pressure)
+{
+	IPCCore &app = IPCCore::getInstance();
+	LoopbackConfig cfg = {};
+	Message msg = MessageBuilder(MessageType::USER_MSG).build();
+
+	/* Frames hold their slot until the NET core has taken them */
+	cfg.latency_ms = 50;
+	configure(cfg, {});
+
+	for (int i = 0; i < LoopbackTransport::QUEUE_DEPTH; i++) {
+		zassert_ok(app.send(msg));
+	}
+	zassert_equal(app.send(msg), -ENOMEM);
+	zassert_equal(app_end.getStats().busy, 1);
+	zassert_equal(app.getStats().tx_errors, 1);
+
+	k_sleep(K_MSEC(60));
+	zassert_equal(net_end.getStats().delivered, LoopbackTransport::QUEUE_DEPTH);
+	zassert_ok(app.send(msg));
+}
+
+ZTEST(dual_core, test_link_outage)
+{
+	IPCCore &app = IPCCore::getInstance();
+	IPCCore &net_ipc = IPCCore::getInstance(Core::NET);
+	CommissioningDelegate &delegate = CommissioningDelegate::getInstance();
+	BLEManager &ble = BLEManager::getInstance();
+	LoopbackConfig cfg = {};
+	Message msg;
+
+	zassert_ok(app.setHeartbeat(50, 200));
+	zassert_ok(net_ipc.setHeartbeat(50, 200));
+	k_sleep(K_MSEC(10));
+	zassert_true(app.linkHas(IPC_CAP_HEARTBEAT));
+	zassert_true(net_ipc.linkHas(IPC_CAP_HEARTBEAT));
+
+	zassert_ok(delegate.openCommissioningWindow(60));
+	zassert_ok(expect(MessageType::ACK, &msg, 100));
+	zassert_true(ble.isAdvertising());
+
+	/* Idle link: PINGs both ways keep it up */
+	k_sleep(K_MSEC(400));
+	zassert_true(app.isReady());
+	zassert_true(net_ipc.isReady());
+	zassert_true(app.getStats().heartbeats > 0);
+	zassert_true(net_ipc.getStats().heartbeats > 0);
+	zassert_equal(app.getStats().link_outages, 0);
+
+	/* The NET core goes silent and comes back without its BLE state */
+	cfg.loss_permille = 1000;
+	configure(cfg, cfg);
+	net_run(net_ble_reset);
+	k_sleep(K_MSEC(200 + 25 + 25));
+	zassert_false(app.isReady());
+	zassert_false(net_ipc.isReady());
+	zassert_equal(app.send(radio_tx()), -ENOTCONN);
+
+	/* Link back: re-bound by the HELLO retries, advertising restored */
+	configure({}, {});
+	k_sleep(K_MSEC(IPCCore::HELLO_RETRY_MS + 100));
+	zassert_true(app.isReady());
+	zassert_true(net_ipc.isReady());
+	zassert_true(ble.isAdvertising());
+	zassert_equal(app.getStats().link_outages, 1);
+	zassert_equal(net_ipc.getStats().link_outages, 1);
+	zassert_true(app.getStats().link_down_ms > 0);
+	zassert_ok(app.sendSync(radio_tx(), 100));
+
+	zassert_ok(app.setHeartbeat(0, 0));
+	zassert_ok(net_ipc.setHeartbeat(0, 0));
+	zassert_ok(delegate.closeCommissioningWindow());
+	k_sleep(K_MSEC(10));
+	zassert_false(ble.isAdvertising());
+}
+
+static Message power_mode(PowerMode mode)
+{
+	return MessageBuilder(MessageType::POWER_MODE).setParam(0, (uint32_t)mode).build();
+}
+
+ZTEST(dual_core, test_low_power_heartbeat)
+{
+	IPCCore &app = IPCCore::getInstance();
+	IPCCore &net_ipc = IPCCore::getInstance(Core::NET);
+
+	/* AppTask::updateNetPowerMode() for a sleepy device */
+	zassert_ok(app.setHeartbeat(0, 0));
+	zassert_ok(app.send(power_mode(PowerMode::LOW_POWER)));
+	k_sleep(K_MSEC(10));
+	zassert_false(net_ipc.linkHas(IPC_CAP_HEARTBEAT));
+	zassert_false(app.linkHas(IPC_CAP_HEARTBEAT));
+
+	/* Idle for many heartbeat periods: no PING either way */
+	k_sleep(K_MSEC(IPCCore::LINK_TIMEOUT_MS * 2));
+	zassert_equal(app.getStats().heartbeats, 0);
+	zassert_equal(net_ipc.getStats().heartbeats, 0);
+	zassert_equal(app_end.getStats().sent, 2, "HELLO and POWER_MODE only");
+	zassert_true(app.isReady());
+
+	/* ACTIVE again: both announce the heartbeat, PINGs resume */
+	zassert_ok(app.setHeartbeat(IPCCore::HEARTBEAT_IDLE_MS, IPCCore::LINK_TIMEOUT_MS));
+	zassert_ok(app.send(power_mode(PowerMode::ACTIVE)));
+	k_sleep(K_MSEC(10));
+	zassert_true(app.linkHas(IPC_CAP_HEARTBEAT));
+	zassert_true(net_ipc.linkHas(IPC_CAP_HEARTBEAT));
+
+	k_sleep(K_MSEC(IPCCore::HEARTBEAT_IDLE_MS * 2));
+	zassert_true(app.getStats().heartbeats > 0);
+	zassert_true(app.isReady());
+
+	/* Back to the quiet link of the other tests */
+	zassert_ok(app.setHeartbeat(0, 0));
+	zassert_ok(net_ipc.setHeartbeat(0, 0));
+	k_sleep(K_MSEC(10));
+}
+
+ZTEST(dual_core, test_bench_round_trip)
+{
+	IPCCore &app = IPCCore::getInstance();
+	struct bench b;
+
+	/* RADIO_TX to the NET handler and its ACK back */
+	bench_init(&b, "dualcore", "radio_tx_round_trip");
+	for (int i = 0; i < 200; i++) {
+		bench_begin(&b);
+		zassert_ok(app.sendSync(radio_tx(), 100));
+		bench_end(&b, 1);
+	}
+	bench_report(&b);
+}
+
+#ifdef CONFIG_APP_NET_UPDATE
+/* About the size of the nRF5340 NET image (BLE controller and 802.15.4) */
+#define NET_IMAGE_SIZE (192 * 1024)
+
+static uint8_t net_image[NET_IMAGE_SIZE];
+static struct k_sem update_sem;
+static netdfu::Phase update_phase;
+
+static int net_image_source(uint32_t offset, uint8_t *buf, size_t len, void *user_data)
+{
+	memcpy(buf, &net_image[offset], len);
+	return 0;
+}
+
+static void on_update_progress(netdfu::Phase phase, uint32_t done, uint32_t total)
+{
+	if (phase == netdfu::Phase::READY || phase == netdfu::Phase::ERROR) {
+		update_phase = phase;
+		k_sem_give(&update_sem);
+	}
+}
+
+ZTEST(dual_core, test_bench_net_update)
+{
+	NetUpdateClient &client = NetUpdateClient::getInstance();
+	NetUpdateImage image = {};
+	uint32_t seed = 3;
+	struct bench b;
+
+	for (size_t i = 0; i < sizeof(net_image); i++) {
+		seed = seed * 1103515245U + 12345U;
+		net_image[i] = (uint8_t)(seed >> 16);
+	}
+	image.source = net_image_source;
+	image.size = sizeof(net_image);
+	mbedtls_sha256(net_image, sizeof(net_image), image.sha256, 0);
+
+	k_sem_init(&update_sem, 0, 1);
+	client.setProgressCallback(on_update_progress);
+
+	/* The whole image into the NET slot: ns per image byte */
+	bench_init(&b, "dualcore", "net_update_192k");
+	bench_begin(&b);
+	zassert_ok(client.start(image));
+	zassert_ok(k_sem_take(&update_sem, K_SECONDS(60)));
+	bench_end(&b, sizeof(net_image));
+	bench_report(&b);
+
+	const NetUpdateClient::Statistics &stats = client.getStats();
+
+	zassert_equal(update_phase, netdfu::Phase::READY);
+	zassert_equal(stats.chunks_sent, DIV_ROUND_UP(sizeof(net_image), netdfu::CHUNK_SIZE));
+	zassert_equal(stats.retransmits, 0);
+	TC_PRINT("NET image: %u bytes in %u ms simulated (%u B/s), credit wait %u ms\n",
+		 (unsigned)sizeof(net_image), stats.elapsed_ms, stats.throughput_bps,
+		 stats.credit_wait_ms);
+	client.setProgressCallback(NULL);
+}
+#endif
+
+ZTEST_SUITE(dual_core, NULL, dualcore_setup, dualcore_before, NULL, NULL);
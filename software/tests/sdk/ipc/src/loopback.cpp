@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ipc/ipc_service.h>
+#include <string.h>
+
+#include "ipc_core.hpp"
+#include "loopback.h"
+
+using namespace smarthome::ipc;
+
+/* Largest frame on the link: header + large payload */
+#define LOOPBACK_MTU (sizeof(Message) + IPCCore::MAX_LARGE_PAYLOAD)
+
+/* Frames in flight towards this core; a full queue is -ENOMEM like RPMsg */
+#define LOOPBACK_DEPTH 8
+
+struct frame {
+	uint16_t len;
+	uint8_t data[LOOPBACK_MTU];
+};
+
+K_MSGQ_DEFINE(peer_tx, sizeof(struct frame), LOOPBACK_DEPTH, 4);
+
+static struct ipc_ept *bound_ept;
+static const struct ipc_ept_cfg *bound_cfg;
+
+static enum loopback_mode mode;
+static uint32_t fail_count;
+static int fail_err;
+static uint32_t sent;
+static struct frame last;
+static struct k_spinlock lock;
+
+/* The peer's HELLO: this protocol, every capability, every type handled */
+static Message peer_hello(void)
+{
+	Message hello = MessageBuilder(MessageType::HELLO).build();
+
+	hello.payload.hello.version_major = IPC_PROTOCOL_MAJOR;
+	hello.payload.hello.version_minor = IPC_PROTOCOL_MINOR;
+	hello.payload.hello.max_payload = IPCCore::MAX_LARGE_PAYLOAD;
+	hello.payload.hello.caps = IPC_CAP_LARGE | IPC_CAP_BATCH;
+	memset(hello.payload.hello.types, 0xFF, sizeof(hello.payload.hello.types));
+	return hello;
+}
+
+static void bind_handler(struct k_work *work)
+{
+	if (bound_cfg->cb.bound) {
+		bound_cfg->cb.bound(bound_cfg->priv);
+	}
+}
+
+static void peer_handler(struct k_work *work)
+{
+	static struct frame frame;
+
+	while (k_msgq_get(&peer_tx, &frame, K_NO_WAIT) == 0) {
+		loopback_deliver(frame.data, frame.len);
+	}
+}
+
+static K_WORK_DEFINE(bind_work, bind_handler);
+static K_WORK_DEFINE(peer_work, peer_handler);
+
+/*=============================================================================
+ * Test control
+ *===========================================================================*/
+
+void loopback_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	mode = LOOPBACK_SILENT;
+	fail_count = 0;
+	sent = 0;
+	last.len = 0;
+	k_msgq_purge(&peer_tx);
+	k_spin_unlock(&lock, key);
+}
+
+void loopback_set_mode(enum loopback_mode new_mode)
+{
+	mode = new_mode;
+}
+
+void loopback_fail_sends(uint32_t count, int err)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	fail_count = count;
+	fail_err = err;
+	k_spin_unlock(&lock, key);
+}
+
+void loopback_deliver(const void *data, size_t len)
+{
+	if (bound_cfg && bound_cfg->cb.received) {
+		bound_cfg->cb.received(data, len, bound_cfg->priv);
+	}
+}
+
+uint32_t loopback_sent(void)
+{
+	return sent;
+}
+
+size_t loopback_last_sent(void *buf, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	size_t n = MIN(len, (size_t)last.len);
+
+	memcpy(buf, last.data, n);
+	k_spin_unlock(&lock, key);
+	return n;
+}
+
+/*=============================================================================
+ * ipc_service backend
+ *===========================================================================*/
+
+int ipc_service_open_instance(const struct device *instance)
+{
+	return 0;
+}
+
+int ipc_service_register_endpoint(const struct device *instance, struct ipc_ept *ept,
+				  const struct ipc_ept_cfg *cfg)
+{
+	if (!ept || !cfg) {
+		return -EINVAL;
+	}
+	if (bound_ept) {
+		return -EALREADY;
+	}
+
+	bound_ept = ept;
+	bound_cfg = cfg;
+	k_work_submit(&bind_work);
+	return 0;
+}
+
+int ipc_service_deregister_endpoint(struct ipc_ept *ept)
+{
+	if (!ept || ept != bound_ept) {
+		return -ENOENT;
+	}
+
+	bound_ept = NULL;
+	return 0;
+}
+
+int ipc_service_send(struct ipc_ept *ept, const void *data, size_t len)
+{
+	static struct frame reply;
+	k_spinlock_key_t key;
+
+	if (ept != bound_ept) {
+		return -ENOENT;
+	}
+	if (len == 0 || len > LOOPBACK_MTU) {
+		return -EBADMSG;
+	}
+
+	key = k_spin_lock(&lock);
+	if (fail_count > 0) {
+		fail_count--;
+		k_spin_unlock(&lock, key);
+		return fail_err;
+	}
+	/* The handshake is answered in every mode, and never echoed */
+	if (static_cast<const Message *>(data)->type == MessageType::HELLO) {
+		bool want_reply = static_cast<const Message *>(data)->flags & MSG_FLAG_REPLY;
+
+		sent++;
+		last.len = (uint16_t)len;
+		memcpy(last.data, data, len);
+		k_spin_unlock(&lock, key);
+
+		if (want_reply) {
+			Message hello = peer_hello();
+
+			reply.len = sizeof(hello);
+			memcpy(reply.data, &hello, sizeof(hello));
+			k_msgq_put(&peer_tx, &reply, K_NO_WAIT);
+			k_work_submit(&peer_work);
+		}
+		return (int)len;
+	}
+	if (mode != LOOPBACK_SILENT && k_msgq_num_free_get(&peer_tx) == 0) {
+		k_spin_unlock(&lock, key);
+		return -ENOMEM;
+	}
+	sent++;
+	last.len = (uint16_t)len;
+	memcpy(last.data, data, len);
+	k_spin_unlock(&lock, key);
+
+	/* Callers hold the IPCCore TX mutex, so reply is not shared */
+	switch (mode) {
+	case LOOPBACK_ECHO:
+		reply.len = (uint16_t)len;
+		memcpy(reply.data, data, len);
+		break;
+	case LOOPBACK_ACK: {
+		Message ack = MessageBuilder(MessageType::ACK)
+			.setParam(0, (uint8_t)static_cast<const Message *>(data)->type)
+			.build();
+
+		reply.len = sizeof(ack);
+		memcpy(reply.data, &ack, sizeof(ack));
+		break;
+	}
+	default:
+		return (int)len;
+	}
+
+	k_msgq_put(&peer_tx, &reply, K_NO_WAIT);
+	k_work_submit(&peer_work);
+	return (int)len;
+}
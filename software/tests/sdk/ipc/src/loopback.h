@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Loopback IPC service backend
+ *
+ * Stands in for the OpenAMP backend at link time: ipc_service_open_instance,
+ * ipc_service_register_endpoint and ipc_service_send are implemented here
+ * and the other end of the link is a scripted peer. The endpoint binds as
+ * soon as it is registered. Frames the peer sends back arrive from the
+ * system work queue, like the mailbox interrupt on the nRF5340. The peer
+ * answers a HELLO asking for a reply with a HELLO of the same protocol,
+ * all capabilities and every type, whatever the mode.
+ */
+
+#ifndef TESTS_IPC_LOOPBACK_H
+#define TESTS_IPC_LOOPBACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* What the peer does with each frame it receives */
+enum loopback_mode {
+	LOOPBACK_SILENT,        /* Swallow it */
+	LOOPBACK_ECHO,          /* Send the same frame back */
+	LOOPBACK_ACK,           /* Answer ACK (param1: acknowledged type) */
+};
+
+/* Silent peer, no failures, counters cleared */
+void loopback_reset(void);
+
+void loopback_set_mode(enum loopback_mode mode);
+
+/* Fail the next count sends with err (-ENOMEM: no free TX buffer) */
+void loopback_fail_sends(uint32_t count, int err);
+
+/* Peer to this core: hand a frame to the endpoint, in the caller's context */
+void loopback_deliver(const void *data, size_t len);
+
+/* Frames the endpoint sent successfully */
+uint32_t loopback_sent(void);
+
+/* Copy of the last frame sent, returns its length */
+size_t loopback_last_sent(void *buf, size_t len);
+
+#endif /* TESTS_IPC_LOOPBACK_H */
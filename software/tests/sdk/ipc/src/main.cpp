@@ -0,0 +1,624 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file IPCCore tests
+ *
+ * IPCCore over the loopback backend: binding (a peer answering only after
+ * init() timed out), dispatch of echoed messages, sequence numbers,
+ * rejected messages and malformed frames, sendSync against ACKs and
+ * timeouts (ACKs dispatched as well), large frames with TX buffer
+ * back-pressure, RX queue overflow, the HELLO handshake (announced types,
+ * refused and downgraded peers), batch frames, link monitoring (idle
+ * PINGs, a silent peer taking the link down, re-binding), and round trip
+ * benchmarks.
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+
+#include "ipc_core.hpp"
+#include "loopback.h"
+#include "bench.h"
+
+using namespace smarthome::ipc;
+
+static struct k_sem rx_sem;
+static Message rx_msg;
+static uint32_t rx_calls;
+
+static struct k_sem large_sem;
+static Message large_header;
+static uint8_t large_data[IPCCore::MAX_LARGE_PAYLOAD];
+static size_t large_len;
+
+static struct k_sem gate;
+
+static uint32_t link_ups;
+static uint32_t link_downs;
+
+static uint8_t block[IPCCore::MAX_LARGE_PAYLOAD];
+
+static void on_user(const Message &msg)
+{
+	rx_msg = msg;
+	rx_calls++;
+	k_sem_give(&rx_sem);
+}
+
+static void on_chunk(const Message &header, const uint8_t *data, size_t len)
+{
+	large_header = header;
+	large_len = len;
+	memcpy(large_data, data, len);
+	k_sem_give(&large_sem);
+}
+
+static void on_blocking(const Message &msg)
+{
+	k_sem_take(&gate, K_FOREVER);
+}
+
+static void on_link(bool up)
+{
+	if (up) {
+		link_ups++;
+	} else {
+		link_downs++;
+	}
+}
+
+static Message user_msg(uint32_t param)
+{
+	return MessageBuilder(MessageType::USER_MSG).setParam(0, param).build();
+}
+
+static Message hello(uint8_t major, uint32_t caps, uint16_t max_payload)
+{
+	Message msg = MessageBuilder(MessageType::HELLO).build();
+
+	msg.payload.hello.version_major = major;
+	msg.payload.hello.max_payload = max_payload;
+	msg.payload.hello.caps = caps;
+	memset(msg.payload.hello.types, 0xFF, sizeof(msg.payload.hello.types));
+	return msg;
+}
+
+static bool announces(const Message &msg, MessageType type)
+{
+	uint8_t t = (uint8_t)type;
+
+	return msg.payload.hello.types[t >> 3] & (1U << (t & 7));
+}
+
+static void *ipc_setup(void)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+
+	k_sem_init(&rx_sem, 0, K_SEM_MAX_LIMIT);
+	k_sem_init(&large_sem, 0, K_SEM_MAX_LIMIT);
+	k_sem_init(&gate, 0, K_SEM_MAX_LIMIT);
+	for (size_t i = 0; i < sizeof(block); i++) {
+		block[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	/* Nothing goes out before the endpoint is bound */
+	zassert_false(ipc.isReady());
+	zassert_equal(ipc.send(user_msg(0)), -ENOTCONN);
+	zassert_equal(ipc.sendLarge(user_msg(0), block, 16), -ENOTCONN);
+
+	/*
+	 * The peer answers only after init() gave up: the RX thread keeps
+	 * asking and the link comes up monitored (see test_link_heartbeat_and_rebind)
+	 */
+	loopback_fail_sends(UINT32_MAX, -EIO);
+	zassert_equal(ipc.init(), -ETIMEDOUT);
+	zassert_false(ipc.isReady());
+
+	loopback_fail_sends(0, 0);
+	k_sleep(K_MSEC(IPCCore::HELLO_RETRY_MS + 20));
+	zassert_true(ipc.isReady());
+	zassert_ok(ipc.init(), "init once ready is a no-op");
+
+	ipc.registerCallback(MessageType::USER_MSG, on_user);
+	ipc.registerLargeCallback(MessageType::NET_DFU_CHUNK, on_chunk);
+	ipc.registerLinkCallback(on_link);
+	return NULL;
+}
+
+static void ipc_before(void *fixture)
+{
+	loopback_reset();
+	IPCCore::getInstance().resetStats();
+	k_sem_reset(&rx_sem);
+	k_sem_reset(&large_sem);
+	rx_calls = 0;
+	link_ups = 0;
+	link_downs = 0;
+}
+
+/*=============================================================================
+ * Messages
+ *===========================================================================*/
+
+ZTEST(ipc_core, test_echo_dispatch)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message msg = MessageBuilder(MessageType::USER_MSG)
+		.setParam(0, 0x1234)
+		.setParam(5, 0xCAFE)
+		.build();
+
+	loopback_set_mode(LOOPBACK_ECHO);
+
+	zassert_ok(ipc.send(msg));
+	zassert_ok(k_sem_take(&rx_sem, K_MSEC(100)));
+	zassert_equal(rx_msg.type, MessageType::USER_MSG);
+	zassert_equal(rx_msg.payload.params.param1, 0x1234);
+	zassert_equal(rx_msg.payload.params.param6, 0xCAFE);
+
+	/* Each send takes the next sequence number */
+	uint8_t seq = rx_msg.sequence_id;
+
+	zassert_ok(ipc.send(msg));
+	zassert_ok(k_sem_take(&rx_sem, K_MSEC(100)));
+	zassert_equal(rx_msg.sequence_id, (uint8_t)(seq + 1));
+
+	/* A type without a handler is received and dropped */
+	zassert_ok(ipc.send(MessageBuilder(MessageType::STATUS_REQUEST).build()));
+	k_sleep(K_MSEC(10));
+	zassert_equal(rx_calls, 2);
+
+	const IPCCore::Statistics &stats = ipc.getStats();
+
+	zassert_equal(stats.tx_count, 3);
+	zassert_equal(stats.rx_count, 3);
+	zassert_equal(stats.tx_errors + stats.rx_errors, 0);
+}
+
+ZTEST(ipc_core, test_invalid_messages)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message msg = user_msg(1);
+
+	msg.type = (MessageType)0;
+	zassert_equal(ipc.send(msg), -EINVAL);
+	msg.type = (MessageType)0xFF;
+	zassert_equal(ipc.send(msg), -EINVAL);
+	msg = user_msg(1);
+	msg.priority = (Priority)4;
+	zassert_equal(ipc.send(msg), -EINVAL);
+	zassert_equal(loopback_sent(), 0);
+
+	/* Frames of the wrong size are counted and dropped */
+	uint8_t junk[sizeof(Message) + 8] = {};
+
+	junk[0] = (uint8_t)MessageType::USER_MSG;
+	loopback_deliver(junk, sizeof(Message) - 1);
+	loopback_deliver(junk, sizeof(junk));   /* Long, but not flagged large */
+	k_sleep(K_MSEC(10));
+	zassert_equal(ipc.getStats().rx_errors, 2);
+	zassert_equal(rx_calls, 0);
+
+	/* What the sender would have refused is dropped on receipt too */
+	msg = user_msg(1);
+	msg.priority = (Priority)4;
+	loopback_deliver(&msg, sizeof(msg));
+	msg = user_msg(1);
+	msg.type = (MessageType)0xFF;
+	loopback_deliver(&msg, sizeof(msg));
+	k_sleep(K_MSEC(10));
+	zassert_equal(ipc.getStats().rx_errors, 4);
+	zassert_equal(ipc.getStats().rx_count, 0);
+	zassert_equal(rx_calls, 0);
+
+	/* A transport error reaches the caller */
+	loopback_fail_sends(1, -EIO);
+	zassert_equal(ipc.send(user_msg(1)), -EIO);
+	zassert_equal(ipc.getStats().tx_errors, 1);
+	zassert_ok(ipc.send(user_msg(1)));
+}
+
+ZTEST(ipc_core, test_send_sync)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message sent;
+
+	ipc.registerCallback(MessageType::ACK, on_user);
+	loopback_set_mode(LOOPBACK_ACK);
+	zassert_ok(ipc.sendSync(user_msg(7), 100));
+	zassert_equal(loopback_last_sent(&sent, sizeof(sent)), sizeof(Message));
+	zassert_equal(sent.type, MessageType::USER_MSG);
+	zassert_equal(sent.payload.params.param1, 7);
+
+	/* Handlers see the ACK too, param1 names the request */
+	zassert_ok(k_sem_take(&rx_sem, K_MSEC(100)));
+	zassert_equal(rx_msg.type, MessageType::ACK);
+	zassert_equal(rx_msg.payload.params.param1, (uint32_t)MessageType::USER_MSG);
+	ipc.unregisterCallback(MessageType::ACK);
+
+	/* No answer: times out after the given time */
+	loopback_set_mode(LOOPBACK_SILENT);
+	int64_t start = k_uptime_get();
+
+	zassert_equal(ipc.sendSync(user_msg(8), 50), -ETIMEDOUT);
+	zassert_true(k_uptime_get() - start >= 50);
+
+	/* A late ACK does not complete the next exchange */
+	Message ack = MessageBuilder(MessageType::ACK)
+		.setParam(0, (uint8_t)MessageType::USER_MSG)
+		.build();
+
+	loopback_deliver(&ack, sizeof(ack));
+	k_sleep(K_MSEC(10));
+	zassert_equal(ipc.sendSync(user_msg(9), 50), -ETIMEDOUT);
+}
+
+/*=============================================================================
+ * Large frames
+ *===========================================================================*/
+
+ZTEST(ipc_core, test_large_frames)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message header = MessageBuilder(MessageType::NET_DFU_CHUNK).setParam(0, 3).build();
+
+	loopback_set_mode(LOOPBACK_ECHO);
+
+	zassert_ok(ipc.sendLarge(header, block, sizeof(block)));
+	zassert_ok(k_sem_take(&large_sem, K_MSEC(100)));
+	zassert_true(large_header.flags & MSG_FLAG_LARGE);
+	zassert_equal(large_header.payload.params.param1, 3);
+	zassert_equal(large_len, sizeof(block));
+	zassert_mem_equal(large_data, block, sizeof(block));
+
+	/* Small blocks keep their length */
+	zassert_ok(ipc.sendLarge(header, block, 1));
+	zassert_ok(k_sem_take(&large_sem, K_MSEC(100)));
+	zassert_equal(large_len, 1);
+
+	zassert_equal(ipc.sendLarge(header, block, sizeof(block) + 1), -EMSGSIZE);
+	zassert_equal(ipc.getStats().large_tx_count, 2);
+	zassert_equal(ipc.getStats().large_rx_count, 2);
+}
+
+ZTEST(ipc_core, test_large_waits_for_tx_buffer)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message header = MessageBuilder(MessageType::NET_DFU_CHUNK).build();
+
+	/* All TX buffers in flight for a while: the send waits and goes out */
+	loopback_fail_sends(3, -ENOMEM);
+	zassert_ok(ipc.sendLarge(header, block, 64, 100));
+	zassert_equal(ipc.getStats().tx_busy_retries, 3);
+	zassert_equal(loopback_sent(), 1);
+
+	/* Never free: -EAGAIN once the timeout is spent */
+	loopback_fail_sends(UINT32_MAX, -ENOMEM);
+	zassert_equal(ipc.sendLarge(header, block, 64, 20), -EAGAIN);
+	zassert_equal(ipc.getStats().tx_errors, 1);
+	zassert_equal(loopback_sent(), 1);
+}
+
+/*=============================================================================
+ * RX path
+ *===========================================================================*/
+
+ZTEST(ipc_core, test_rx_queue_overflow)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message msg = MessageBuilder(MessageType::STATUS_RESPONSE).build();
+
+	ipc.registerCallback(MessageType::STATUS_RESPONSE, on_blocking);
+	k_sem_reset(&gate);
+
+	/* The RX thread takes the first one and parks in the handler */
+	loopback_deliver(&msg, sizeof(msg));
+	k_sleep(K_MSEC(1));
+
+	for (int i = 0; i < IPCCore::MAX_MESSAGE_QUEUE; i++) {
+		loopback_deliver(&msg, sizeof(msg));
+	}
+	zassert_equal(ipc.getStats().dropped_messages, 0);
+	loopback_deliver(&msg, sizeof(msg));
+	zassert_equal(ipc.getStats().dropped_messages, 1);
+
+	for (int i = 0; i <= IPCCore::MAX_MESSAGE_QUEUE; i++) {
+		k_sem_give(&gate);
+	}
+	k_sleep(K_MSEC(10));
+	zassert_equal(ipc.getStats().rx_count, IPCCore::MAX_MESSAGE_QUEUE + 1);
+	ipc.unregisterCallback(MessageType::STATUS_RESPONSE);
+}
+
+/*=============================================================================
+ * Handshake
+ *===========================================================================*/
+
+ZTEST(ipc_core, test_hello_announces_types)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message sent;
+
+	/* Agreed on at init with the scripted peer */
+	zassert_equal(ipc.getPeerInfo().version_major, IPC_PROTOCOL_MAJOR);
+	zassert_true(ipc.linkHas(IPC_CAP_LARGE));
+	zassert_true(ipc.linkHas(IPC_CAP_BATCH));
+	zassert_equal(ipc.maxLargePayload(), IPCCore::MAX_LARGE_PAYLOAD);
+	zassert_true(ipc.peerSupports(MessageType::USER_MSG));
+
+	/* A type handled from now on goes to the peer in a HELLO */
+	ipc.registerCallback(MessageType::THREAD_DIAG_REPORT, on_user);
+	zassert_equal(loopback_sent(), 1);
+	zassert_equal(loopback_last_sent(&sent, sizeof(sent)), sizeof(Message));
+	zassert_equal(sent.type, MessageType::HELLO);
+	zassert_false(sent.flags & MSG_FLAG_REPLY);
+	zassert_equal(sent.payload.hello.version_major, IPC_PROTOCOL_MAJOR);
+	zassert_equal(sent.payload.hello.caps,
+		      IPC_CAP_LARGE | IPC_CAP_BATCH | IPC_CAP_HEARTBEAT);
+	zassert_true(announces(sent, MessageType::THREAD_DIAG_REPORT));
+	zassert_true(announces(sent, MessageType::USER_MSG));
+	zassert_true(announces(sent, MessageType::NET_DFU_CHUNK));
+	zassert_true(announces(sent, MessageType::ACK));
+	zassert_false(announces(sent, MessageType::RADIO_TX));
+
+	/* Types already announced, and handlers still left, send nothing */
+	ipc.registerCallback(MessageType::THREAD_DIAG_REPORT, on_user);
+	ipc.registerCallback(MessageType::ACK, on_user);
+	ipc.unregisterCallback(MessageType::THREAD_DIAG_REPORT);
+	ipc.unregisterCallback(MessageType::ACK);
+	zassert_equal(loopback_sent(), 1);
+
+	ipc.unregisterCallback(MessageType::THREAD_DIAG_REPORT);
+	zassert_equal(loopback_sent(), 2);
+	zassert_equal(loopback_last_sent(&sent, sizeof(sent)), sizeof(Message));
+	zassert_false(announces(sent, MessageType::THREAD_DIAG_REPORT));
+}
+
+ZTEST(ipc_core, test_hello_refused_and_downgraded_peer)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message peer = hello(IPC_PROTOCOL_MAJOR + 1, IPC_CAP_LARGE | IPC_CAP_BATCH,
+			     IPCCore::MAX_LARGE_PAYLOAD);
+
+	/* Another protocol major: the link goes down, nothing is parsed */
+	loopback_deliver(&peer, sizeof(peer));
+	k_sleep(K_MSEC(10));
+	zassert_false(ipc.isReady());
+	zassert_equal(ipc.getStats().refused_peers, 1);
+	zassert_false(ipc.peerSupports(MessageType::USER_MSG));
+	zassert_equal(ipc.send(user_msg(1)), -ENOTCONN);
+
+	Message msg = user_msg(1);
+
+	loopback_deliver(&msg, sizeof(msg));
+	k_sleep(K_MSEC(10));
+	zassert_equal(rx_calls, 0);
+	zassert_equal(ipc.getStats().rx_errors, 1);
+
+	/* Same major, older peer: no batch frames, smaller blocks */
+	peer = hello(IPC_PROTOCOL_MAJOR, IPC_CAP_LARGE, 64);
+	memset(peer.payload.hello.types, 0, sizeof(peer.payload.hello.types));
+	peer.payload.hello.types[(uint8_t)MessageType::USER_MSG >> 3] =
+		1U << ((uint8_t)MessageType::USER_MSG & 7);
+	loopback_deliver(&peer, sizeof(peer));
+	k_sleep(K_MSEC(10));
+	zassert_true(ipc.isReady());
+	zassert_true(ipc.peerSupports(MessageType::USER_MSG));
+	zassert_false(ipc.peerSupports(MessageType::NET_DFU_CHUNK));
+	zassert_false(ipc.linkHas(IPC_CAP_BATCH));
+	zassert_equal(ipc.maxLargePayload(), 64);
+
+	Message header = MessageBuilder(MessageType::NET_DFU_CHUNK).build();
+	Message batch[3] = { user_msg(1), user_msg(2), user_msg(3) };
+
+	zassert_equal(ipc.sendLarge(header, block, 65), -EMSGSIZE);
+	zassert_ok(ipc.sendLarge(header, block, 64));
+	zassert_ok(ipc.sendBatch(batch, ARRAY_SIZE(batch)));
+	zassert_equal(loopback_sent(), 1 + ARRAY_SIZE(batch), "one frame each");
+	zassert_equal(ipc.getStats().batch_tx_count, 0);
+
+	/* Without large frames */
+	peer.payload.hello.caps = 0;
+	loopback_deliver(&peer, sizeof(peer));
+	k_sleep(K_MSEC(10));
+	zassert_equal(ipc.sendLarge(header, block, 16), -ENOTSUP);
+
+	/* Back to the peer of the other tests */
+	peer = hello(IPC_PROTOCOL_MAJOR, IPC_CAP_LARGE | IPC_CAP_BATCH,
+		     IPCCore::MAX_LARGE_PAYLOAD);
+	loopback_deliver(&peer, sizeof(peer));
+	k_sleep(K_MSEC(10));
+	zassert_true(ipc.linkHas(IPC_CAP_BATCH));
+	zassert_equal(ipc.maxLargePayload(), IPCCore::MAX_LARGE_PAYLOAD);
+}
+
+/*=============================================================================
+ * Link monitoring
+ *===========================================================================*/
+
+ZTEST(ipc_core, test_link_heartbeat_and_rebind)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message peer = hello(IPC_PROTOCOL_MAJOR,
+			     IPC_CAP_LARGE | IPC_CAP_BATCH | IPC_CAP_HEARTBEAT,
+			     IPCCore::MAX_LARGE_PAYLOAD);
+	Message sent;
+
+	zassert_equal(ipc.setHeartbeat(50, 50), -EINVAL);
+	zassert_ok(ipc.setHeartbeat(20, 100));
+	zassert_equal(loopback_sent(), 1, "announced in a HELLO");
+
+	/* Monitored once the peer sends heartbeats as well */
+	loopback_deliver(&peer, sizeof(peer));
+	k_sleep(K_MSEC(5));
+	zassert_true(ipc.linkHas(IPC_CAP_HEARTBEAT));
+
+	/* Nothing to send: a PING goes out */
+	k_sleep(K_MSEC(30));
+	zassert_true(ipc.getStats().heartbeats >= 1);
+	zassert_equal(loopback_last_sent(&sent, sizeof(sent)), sizeof(Message));
+	zassert_equal(sent.type, MessageType::PING);
+
+	/* Any traffic from the peer keeps the link up */
+	for (uint32_t i = 0; i < 15; i++) {
+		Message msg = user_msg(i);
+
+		loopback_deliver(&msg, sizeof(msg));
+		k_sleep(K_MSEC(10));
+	}
+	zassert_true(ipc.isReady());
+	zassert_equal(rx_calls, 15);
+	zassert_equal(ipc.getStats().link_outages, 0);
+
+	/* The peer resets: down within timeout + idle / 2, until it answers */
+	loopback_fail_sends(UINT32_MAX, -EIO);
+	k_sleep(K_MSEC(100 + 10 + 5));
+	zassert_false(ipc.isReady());
+	zassert_equal(ipc.send(user_msg(1)), -ENOTCONN);
+	zassert_equal(ipc.getStats().link_outages, 1);
+	zassert_equal(link_downs, 1);
+
+	k_sleep(K_MSEC(200));
+	zassert_false(ipc.isReady());
+	zassert_equal(link_ups, 0);
+
+	/* Back: the next HELLO is answered, link callbacks resync */
+	loopback_fail_sends(0, 0);
+	k_sleep(K_MSEC(IPCCore::HELLO_RETRY_MS + 20));
+	zassert_true(ipc.isReady());
+	zassert_equal(link_ups, 1);
+	zassert_true(ipc.getStats().link_down_ms >= 200);
+	zassert_false(ipc.linkHas(IPC_CAP_HEARTBEAT), "scripted peer has none");
+
+	/* A peer that restarted on a live link asks for our HELLO again */
+	peer.flags = MSG_FLAG_REPLY;
+	loopback_deliver(&peer, sizeof(peer));
+	k_sleep(K_MSEC(5));
+	zassert_true(ipc.isReady());
+	zassert_equal(ipc.getStats().rebinds, 1);
+	zassert_equal(ipc.getStats().link_outages, 1);
+	zassert_equal(link_ups, 2);
+	zassert_equal(loopback_last_sent(&sent, sizeof(sent)), sizeof(Message));
+	zassert_equal(sent.type, MessageType::HELLO);
+	zassert_false(sent.flags & MSG_FLAG_REPLY);
+
+	/* Back to the peer of the other tests */
+	zassert_ok(ipc.setHeartbeat(IPCCore::HEARTBEAT_IDLE_MS, IPCCore::LINK_TIMEOUT_MS));
+	peer = hello(IPC_PROTOCOL_MAJOR, IPC_CAP_LARGE | IPC_CAP_BATCH,
+		     IPCCore::MAX_LARGE_PAYLOAD);
+	loopback_deliver(&peer, sizeof(peer));
+	k_sleep(K_MSEC(10));
+	zassert_false(ipc.linkHas(IPC_CAP_HEARTBEAT));
+}
+
+/*=============================================================================
+ * Batch frames
+ *===========================================================================*/
+
+ZTEST(ipc_core, test_batch)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message batch[IPCCore::MAX_BATCH + 1];
+	uint8_t frame[IPCCore::MAX_BATCH * sizeof(Message)];
+
+	for (size_t i = 0; i < ARRAY_SIZE(batch); i++) {
+		batch[i] = user_msg(i);
+	}
+
+	loopback_set_mode(LOOPBACK_ECHO);
+
+	/* One frame, handled one by one and in order on the other side */
+	zassert_ok(ipc.sendBatch(batch, 5));
+	zassert_equal(loopback_sent(), 1);
+	zassert_equal(loopback_last_sent(frame, sizeof(frame)), 5 * sizeof(Message));
+	for (uint32_t i = 0; i < 5; i++) {
+		zassert_ok(k_sem_take(&rx_sem, K_MSEC(100)));
+		zassert_equal(rx_msg.payload.params.param1, i);
+		zassert_true(rx_msg.flags & MSG_FLAG_BATCH);
+	}
+
+	/* Past MAX_BATCH: the rest in a frame of its own, alone unflagged */
+	zassert_ok(ipc.sendBatch(batch, ARRAY_SIZE(batch)));
+	zassert_equal(loopback_sent(), 3);
+	for (uint32_t i = 0; i < ARRAY_SIZE(batch); i++) {
+		zassert_ok(k_sem_take(&rx_sem, K_MSEC(100)));
+		zassert_equal(rx_msg.payload.params.param1, i);
+	}
+	zassert_false(rx_msg.flags & MSG_FLAG_BATCH);
+
+	const IPCCore::Statistics &stats = ipc.getStats();
+
+	zassert_equal(stats.tx_count, 5 + ARRAY_SIZE(batch));
+	zassert_equal(stats.rx_count, 5 + ARRAY_SIZE(batch));
+	zassert_equal(stats.batch_tx_count, 2);
+	zassert_equal(stats.batch_rx_count, 2);
+
+	/* One bad message and nothing goes out */
+	batch[2].priority = (Priority)4;
+	zassert_equal(ipc.sendBatch(batch, 3), -EINVAL);
+	zassert_equal(loopback_sent(), 3);
+
+	/* A batch frame that is not whole messages is dropped */
+	loopback_set_mode(LOOPBACK_SILENT);
+	memset(frame, 0, sizeof(frame));
+	((Message *)frame)->type = MessageType::USER_MSG;
+	((Message *)frame)->flags = MSG_FLAG_BATCH;
+	loopback_deliver(frame, sizeof(Message) + 8);
+	k_sleep(K_MSEC(10));
+	zassert_equal(ipc.getStats().rx_errors, 1);
+	zassert_equal(rx_calls, 5 + ARRAY_SIZE(batch));
+}
+
+/*=============================================================================
+ * Benchmarks
+ *===========================================================================*/
+
+ZTEST(ipc_core, test_bench_round_trip)
+{
+	IPCCore &ipc = IPCCore::getInstance();
+	Message header = MessageBuilder(MessageType::NET_DFU_CHUNK).build();
+	struct bench b;
+
+	loopback_set_mode(LOOPBACK_ECHO);
+
+	bench_init(&b, "ipc", "echo_round_trip");
+	for (int i = 0; i < 200; i++) {
+		bench_begin(&b);
+		zassert_ok(ipc.send(user_msg(i)));
+		zassert_ok(k_sem_take(&rx_sem, K_MSEC(100)));
+		bench_end(&b, 1);
+	}
+	bench_report(&b);
+
+	bench_init(&b, "ipc", "large_round_trip");
+	for (int i = 0; i < 100; i++) {
+		bench_begin(&b);
+		zassert_ok(ipc.sendLarge(header, block, sizeof(block)));
+		zassert_ok(k_sem_take(&large_sem, K_MSEC(100)));
+		bench_end(&b, 1);
+	}
+	bench_report(&b);
+
+	/* Peer bursts: time from the first frame in to the last one handled */
+	loopback_set_mode(LOOPBACK_SILENT);
+	bench_init(&b, "ipc", "rx_dispatch");
+	for (int i = 0; i < 50; i++) {
+		Message msg = user_msg(i);
+
+		bench_begin(&b);
+		for (int j = 0; j < IPCCore::MAX_MESSAGE_QUEUE; j++) {
+			loopback_deliver(&msg, sizeof(msg));
+		}
+		for (int j = 0; j < IPCCore::MAX_MESSAGE_QUEUE; j++) {
+			zassert_ok(k_sem_take(&rx_sem, K_MSEC(100)));
+		}
+		bench_end(&b, IPCCore::MAX_MESSAGE_QUEUE);
+	}
+	bench_report(&b);
+	zassert_equal(ipc.getStats().dropped_messages, 0);
+}
+
+ZTEST_SUITE(ipc_core, NULL, ipc_setup, ipc_before, NULL, NULL);
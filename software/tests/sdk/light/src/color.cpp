@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Color temperature tests
+ *
+ * Level and mired tables, the warm/cool mix, MoveToColorTemperature
+ * routing and clamping, transitions of level and color temperature (one
+ * output update per tick for every endpoint moving) and the persisted
+ * record (one of another size ignored).
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+
+#include "matter/light_endpoint/color_temperature.hpp"
+
+using namespace smarthome::protocol::matter;
+
+#define EP(n) ((uint16_t)(LIGHT_ENDPOINT_ID + (n)))
+
+/* Ticks in a transition of the given tenths of a second */
+#define TICKS(tenths) ((tenths) * 100 / LIGHT_TRANSITION_TICK_MS)
+
+static uint32_t updates;
+
+static void count_update(const LightAttributes *attrs, uint32_t changed_mask)
+{
+	updates++;
+}
+
+static LightAttributes attrs_of(uint16_t endpoint_id)
+{
+	LightAttributes attrs = {};
+
+	zassert_true(LightEndpoints::getInstance().getAttributes(endpoint_id, attrs));
+	return attrs;
+}
+
+static void *color_setup(void)
+{
+	zassert_ok(settings_subsys_init());
+	return NULL;
+}
+
+static void color_before(void *fixture)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+
+	lights.setOutput(nullptr);
+	lights.erase();
+	lights.init();
+	lights.setOutput(count_update);
+	updates = 0;
+}
+
+/*=============================================================================
+ * Tables
+ *===========================================================================*/
+
+ZTEST(light_color, test_tables)
+{
+	using namespace ColorTemperature;
+
+	for (uint16_t level = 1; level <= LightEndpointTemplate::MAX_LEVEL; level++) {
+		zassert_true(LEVEL_TO_LINEAR[level] > LEVEL_TO_LINEAR[level - 1], "level %u", level);
+	}
+
+	/* Warmer is more warm channel; the shares always add up to full */
+	for (uint16_t i = 0; i < MIRED_STEPS; i++) {
+		zassert_equal(MIRED_TO_MIX[i].warm + MIRED_TO_MIX[i].cool, Q16, "step %u", i);
+		if (i > 0) {
+			zassert_true(MIRED_TO_MIX[i].warm >= MIRED_TO_MIX[i - 1].warm, "step %u", i);
+		}
+	}
+	uint16_t mid = MIRED_TO_MIX[COLOR_TEMP_DEFAULT_MIREDS - COLOR_TEMP_MIN_MIREDS].warm;
+	zassert_true(mid > Q16 / 8 && mid < Q16 - Q16 / 8, "4000 K mixes both channels");
+}
+
+ZTEST(light_color, test_mix)
+{
+	ChannelDuty duty = ColorTemperature::mix(LightEndpointTemplate::MAX_LEVEL, COLOR_TEMP_MIN_MIREDS);
+
+	zassert_equal(duty.cool, ColorTemperature::Q16);
+	zassert_equal(duty.warm, 0);
+
+	duty = ColorTemperature::mix(LightEndpointTemplate::MAX_LEVEL, COLOR_TEMP_MAX_MIREDS);
+	zassert_equal(duty.warm, ColorTemperature::Q16);
+	zassert_equal(duty.cool, 0);
+
+	/* Same brightness at every temperature, within rounding */
+	for (uint16_t m = COLOR_TEMP_MIN_MIREDS; m <= COLOR_TEMP_MAX_MIREDS; m += 7) {
+		duty = ColorTemperature::mix(127, m);
+		zassert_within(duty.warm + duty.cool, ColorTemperature::LEVEL_TO_LINEAR[127], 1,
+			       "%u mireds", m);
+	}
+
+	/* Out of range mireds clamp; off is dark whatever the level */
+	duty = ColorTemperature::mix(LightEndpointTemplate::MAX_LEVEL, 1000);
+	zassert_equal(duty.warm, ColorTemperature::Q16);
+	LightAttributes off = { 0, LightEndpointTemplate::MAX_LEVEL, COLOR_TEMP_DEFAULT_MIREDS };
+	duty = ColorTemperature::mix(off);
+	zassert_equal(duty.warm + duty.cool, 0);
+}
+
+/*=============================================================================
+ * Commands
+ *===========================================================================*/
+
+ZTEST(light_color, test_move_to_color_temperature)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+
+	zassert_equal(attrs_of(EP(0)).color_temp_mireds, COLOR_TEMP_DEFAULT_MIREDS);
+	zassert_ok(lights.setColorTemperature(EP(0), 370));
+	zassert_equal(attrs_of(EP(0)).color_temp_mireds, 370);
+	zassert_equal(attrs_of(EP(1)).color_temp_mireds, COLOR_TEMP_DEFAULT_MIREDS);
+	zassert_equal(updates, 1);
+
+	zassert_ok(lights.setColorTemperature(EP(0), 20));
+	zassert_equal(attrs_of(EP(0)).color_temp_mireds, COLOR_TEMP_MIN_MIREDS, "clamped");
+	zassert_ok(lights.setColorTemperature(EP(0), 0xFFFF));
+	zassert_equal(attrs_of(EP(0)).color_temp_mireds, COLOR_TEMP_MAX_MIREDS, "clamped");
+
+	ClusterCommand hue = { EP(0), COLOR_CONTROL_CLUSTER_ID, 0x00, 0 };
+	zassert_equal(lights.dispatch(hue), -ENOTSUP, "MoveToHue");
+	zassert_equal(lights.setColorTemperature(ROOT_ENDPOINT_ID, 300), -ENOENT);
+}
+
+/*=============================================================================
+ * Transitions
+ *===========================================================================*/
+
+ZTEST(light_color, test_level_and_color_move_together)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	ClusterCommand level = { 0, LEVEL_CONTROL_CLUSTER_ID, LightCommand::MOVE_TO_LEVEL, 54 };
+	ClusterCommand ct = { 0, COLOR_CONTROL_CLUSTER_ID, LightCommand::MOVE_TO_COLOR_TEMPERATURE, 0 };
+
+	level.transition_time = 10;
+	ct.color_temp_mireds = 450;
+	ct.transition_time = 10;
+
+	lights.setLightState(EP(0), true);
+	lights.setLightState(EP(1), true);
+	updates = 0;
+
+	/* Both endpoints dim; endpoint 1 warms up over the same second */
+	zassert_ok(lights.dispatchMask(BIT(0) | BIT(1), level));
+	zassert_ok(lights.dispatchMask(BIT(1), ct));
+	zassert_equal(updates, 0, "nothing moves before the first tick");
+	zassert_true(lights.inTransition(EP(0)));
+
+	k_sleep(K_MSEC(500));
+	zassert_within(attrs_of(EP(0)).current_level, 154, 10);
+	zassert_within(attrs_of(EP(1)).current_level, 154, 10);
+	zassert_within(attrs_of(EP(1)).color_temp_mireds, 350, 20);
+	zassert_equal(attrs_of(EP(0)).color_temp_mireds, COLOR_TEMP_DEFAULT_MIREDS);
+	zassert_true(updates <= TICKS(5), "one output update per tick for both endpoints");
+
+	k_sleep(K_MSEC(600));
+	zassert_false(lights.inTransition(EP(0)));
+	zassert_false(lights.inTransition(EP(1)));
+	zassert_equal(attrs_of(EP(0)).current_level, 54);
+	zassert_equal(attrs_of(EP(1)).current_level, 54);
+	zassert_equal(attrs_of(EP(1)).color_temp_mireds, 450);
+	zassert_true(updates <= TICKS(10));
+}
+
+ZTEST(light_color, test_fade_on_and_off)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	ClusterCommand cmd = { EP(2), LEVEL_CONTROL_CLUSTER_ID,
+			       LightCommand::MOVE_TO_LEVEL_WITH_ON_OFF, 200 };
+
+	cmd.transition_time = 5;
+
+	/* On at once from the minimum level, then up */
+	zassert_ok(lights.dispatch(cmd));
+	zassert_true(attrs_of(EP(2)).on_off);
+	zassert_equal(attrs_of(EP(2)).current_level, LightEndpointTemplate::MIN_LEVEL);
+	k_sleep(K_MSEC(600));
+	zassert_equal(attrs_of(EP(2)).current_level, 200);
+
+	/* Off only once the level is down */
+	cmd.level = 0;
+	zassert_ok(lights.dispatch(cmd));
+	k_sleep(K_MSEC(300));
+	zassert_true(attrs_of(EP(2)).on_off);
+	zassert_true(attrs_of(EP(2)).current_level < 200);
+	k_sleep(K_MSEC(300));
+	zassert_false(attrs_of(EP(2)).on_off);
+	zassert_equal(attrs_of(EP(2)).current_level, LightEndpointTemplate::MIN_LEVEL);
+
+	/* A command without transition time stops the fade where it lands */
+	cmd.level = 200;
+	zassert_ok(lights.dispatch(cmd));
+	zassert_ok(lights.setLightState(EP(2), false));
+	zassert_false(lights.inTransition(EP(2)));
+	k_sleep(K_MSEC(600));
+	zassert_false(attrs_of(EP(2)).on_off);
+}
+
+/*=============================================================================
+ * Persistence
+ *===========================================================================*/
+
+ZTEST(light_color, test_persist_target)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+
+	/* Flushed mid-transition: the target is what comes back */
+	zassert_ok(lights.setColorTemperature(EP(3), 480, 20));
+	k_sleep(K_MSEC(200));
+	lights.flush();
+	lights.setOutput(nullptr);
+	zassert_equal(lights.init(), 1);
+	zassert_false(lights.inTransition(EP(3)));
+	zassert_equal(attrs_of(EP(3)).color_temp_mireds, 480);
+
+	/* Only records of this layout are taken */
+	const uint8_t other[2] = { 1, 99 };
+	zassert_ok(settings_save_one("matter/light/1", other, sizeof(other)));
+	zassert_equal(lights.init(), 1);
+	zassert_equal(attrs_of(EP(0)).current_level, LightEndpointTemplate::DEFAULTS.current_level);
+	zassert_equal(attrs_of(EP(3)).color_temp_mireds, 480);
+}
+
+ZTEST_SUITE(light_color, NULL, color_setup, color_before, NULL, NULL);
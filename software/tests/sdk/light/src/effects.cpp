@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Light effects tests
+ *
+ * Step tables, Identify (blink frames, IdentifyTime countdown, attributes
+ * left alone), effects on several endpoints in one output update per
+ * tick, FINISH and STOP, the fades and the fade-in at boot.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+
+#include "matter/light_endpoint/light_effects.hpp"
+
+using namespace smarthome::protocol::matter;
+
+#define EP(n) ((uint16_t)(LIGHT_ENDPOINT_ID + (n)))
+
+static uint32_t updates;
+static LightAttributes shown[LightEndpoints::COUNT];
+
+static void record_output(const LightAttributes *attrs, uint32_t changed_mask)
+{
+	updates++;
+	for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+		if (changed_mask & BIT(i)) {
+			shown[i] = attrs[i];
+		}
+	}
+}
+
+static LightAttributes attrs_of(uint16_t endpoint_id)
+{
+	LightAttributes attrs = {};
+
+	zassert_true(LightEndpoints::getInstance().getAttributes(endpoint_id, attrs));
+	return attrs;
+}
+
+static void *effects_setup(void)
+{
+	zassert_ok(settings_subsys_init());
+	zassert_ok(LightEffects::getInstance().init());
+	return NULL;
+}
+
+static void effects_before(void *fixture)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+
+	/* Drop whatever the previous test left running */
+	LightEffects::getInstance().start(LightEndpoints::ALL, LightEffect::STOP);
+	k_sleep(K_MSEC(2 * LIGHT_TRANSITION_TICK_MS));
+
+	lights.setOutput(nullptr);
+	lights.erase();
+	lights.init();
+	lights.setOutput(record_output);
+	updates = 0;
+}
+
+/*=============================================================================
+ * Tables
+ *===========================================================================*/
+
+ZTEST(light_effects, test_tables)
+{
+	zassert_not_null(LightEffects::sequenceOf(LightEffect::BLINK));
+	zassert_not_null(LightEffects::sequenceOf(LightEffect::BREATHE));
+	zassert_not_null(LightEffects::sequenceOf(LightEffect::IDENTIFY));
+	zassert_is_null(LightEffects::sequenceOf(0x42));
+
+	for (size_t i = 1; i < EffectTables::FADE_STEPS; i++) {
+		zassert_true(EffectTables::FADE_ON[i] >= EffectTables::FADE_ON[i - 1], "step %u", i);
+		zassert_true(EffectTables::FADE_OFF[i] <= EffectTables::FADE_OFF[i - 1], "step %u", i);
+	}
+	zassert_equal(EffectTables::FADE_STEPS, LIGHT_FADE_MS / LIGHT_TRANSITION_TICK_MS);
+}
+
+/*=============================================================================
+ * Identify
+ *===========================================================================*/
+
+ZTEST(light_effects, test_identify_blinks)
+{
+	LightEffects &effects = LightEffects::getInstance();
+
+	/* An off light blinks at full level without being switched on */
+	zassert_ok(effects.identify(EP(0), 3));
+	zassert_equal(effects.getEffect(EP(0)), LightEffect::IDENTIFY);
+	zassert_equal(effects.getIdentifyTime(EP(0)), 3);
+	zassert_true(shown[0].on_off);
+	zassert_equal(shown[0].current_level, LightEndpointTemplate::MAX_LEVEL);
+	zassert_false(attrs_of(EP(0)).on_off, "Identify does not touch the attributes");
+
+	k_sleep(K_MSEC(600));
+	zassert_false(shown[0].on_off, "second half of the blink is dark");
+	zassert_equal(effects.getIdentifyTime(EP(0)), 3);
+
+	k_sleep(K_MSEC(500));
+	zassert_true(shown[0].on_off);
+	zassert_equal(effects.getIdentifyTime(EP(0)), 2);
+
+	/* IdentifyTime runs out: back to the attributes */
+	k_sleep(K_MSEC(2000));
+	zassert_equal(effects.getIdentifyTime(EP(0)), 0);
+	zassert_equal(effects.getEffect(EP(0)), LightEffect::STOP);
+	zassert_false(shown[0].on_off);
+	zassert_false(attrs_of(EP(0)).on_off);
+
+	zassert_equal(effects.identify(ROOT_ENDPOINT_ID, 5), -ENOENT);
+}
+
+ZTEST(light_effects, test_identify_stop_and_commands)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightEffects &effects = LightEffects::getInstance();
+
+	zassert_ok(effects.identify(EP(1), 60));
+	k_sleep(K_MSEC(600));
+
+	/* Commands during Identify change the attributes, not the blink */
+	zassert_ok(lights.setBrightness(EP(1), 100));
+	zassert_ok(lights.setLightState(EP(1), true));
+	zassert_false(shown[1].on_off);
+	zassert_equal(attrs_of(EP(1)).current_level, 100);
+
+	/* Identify 0 stops it; the LED shows the new attributes */
+	zassert_ok(effects.identify(EP(1), 0));
+	k_sleep(K_MSEC(2 * LIGHT_TRANSITION_TICK_MS));
+	zassert_equal(effects.getIdentifyTime(EP(1)), 0);
+	zassert_true(shown[1].on_off);
+	zassert_equal(shown[1].current_level, 100);
+}
+
+/*=============================================================================
+ * TriggerEffect
+ *===========================================================================*/
+
+ZTEST(light_effects, test_one_update_per_tick)
+{
+	LightEffects &effects = LightEffects::getInstance();
+
+	/* Every endpoint breathes off the same tick */
+	zassert_ok(effects.start(LightEndpoints::ALL, LightEffect::BREATHE));
+	updates = 0;
+	k_sleep(K_MSEC(1000));
+	zassert_true(updates <= 1000 / LIGHT_TRANSITION_TICK_MS, "%u updates", updates);
+	zassert_true(updates >= 1000 / LIGHT_TRANSITION_TICK_MS - 2, "%u updates", updates);
+	for (uint8_t i = 1; i < LightEndpoints::COUNT; i++) {
+		zassert_equal(shown[i].current_level, shown[0].current_level);
+	}
+
+	/* FINISH lets the breath end; STOP is immediate */
+	zassert_ok(effects.trigger(EP(0), LightEffect::FINISH));
+	zassert_ok(effects.trigger(EP(1), LightEffect::STOP));
+	k_sleep(K_MSEC(2 * LIGHT_TRANSITION_TICK_MS));
+	zassert_equal(effects.getEffect(EP(0)), LightEffect::BREATHE);
+	zassert_equal(effects.getEffect(EP(1)), LightEffect::STOP);
+	zassert_false(shown[1].on_off);
+	k_sleep(K_MSEC(1000));
+	zassert_equal(effects.getEffect(EP(0)), LightEffect::STOP);
+	zassert_equal(effects.getEffect(EP(2)), LightEffect::BREATHE);
+
+	zassert_equal(effects.trigger(EP(0), 0x42), -ENOTSUP);
+	zassert_equal(effects.trigger(ROOT_ENDPOINT_ID, LightEffect::BLINK), -ENOENT);
+}
+
+/*=============================================================================
+ * Fades
+ *===========================================================================*/
+
+ZTEST(light_effects, test_fade_off_then_on)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightEffects &effects = LightEffects::getInstance();
+
+	zassert_ok(lights.setBrightness(EP(2), 200));
+	zassert_ok(lights.setLightState(EP(2), true));
+
+	/* Fade off: on while it dims, off at the end, level kept */
+	zassert_ok(effects.trigger(EP(2), LightEffect::FADE_OFF));
+	k_sleep(K_MSEC(LIGHT_FADE_MS / 2));
+	zassert_true(attrs_of(EP(2)).on_off);
+	zassert_true(shown[2].current_level < 200);
+	k_sleep(K_MSEC(LIGHT_FADE_MS));
+	zassert_false(attrs_of(EP(2)).on_off);
+	zassert_false(shown[2].on_off);
+	zassert_equal(attrs_of(EP(2)).current_level, 200);
+
+	/* Fade on: on at once, up to the level */
+	zassert_ok(effects.trigger(EP(2), LightEffect::FADE_ON));
+	zassert_true(attrs_of(EP(2)).on_off);
+	k_sleep(K_MSEC(LIGHT_FADE_MS / 2));
+	zassert_within(shown[2].current_level, 100, 15);
+	k_sleep(K_MSEC(LIGHT_FADE_MS));
+	zassert_equal(shown[2].current_level, 200);
+	zassert_equal(effects.getEffect(EP(2)), LightEffect::STOP);
+}
+
+ZTEST(light_effects, test_startup_fades_in)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+
+	zassert_ok(lights.setBrightness(EP(0), 150));
+	zassert_ok(lights.setLightState(EP(0), true));
+	zassert_ok(lights.setLightState(EP(3), true));
+	lights.flush();
+
+	/* Boot: restore, fade in; the first output is dark, not full on */
+	lights.setOutput(nullptr);
+	zassert_equal(lights.init(), 2);
+	zassert_equal(LightEffects::getInstance().startup(), BIT(0) | BIT(3));
+	lights.setOutput(record_output);
+	zassert_false(shown[0].on_off);
+	zassert_false(shown[1].on_off);
+
+	k_sleep(K_MSEC(LIGHT_FADE_MS / 2));
+	zassert_true(shown[0].on_off);
+	zassert_within(shown[0].current_level, 75, 15);
+
+	k_sleep(K_MSEC(LIGHT_FADE_MS + 2 * LIGHT_TRANSITION_TICK_MS));
+	zassert_equal(shown[0].current_level, 150);
+	zassert_equal(shown[3].current_level, LightEndpointTemplate::DEFAULTS.current_level);
+}
+
+ZTEST_SUITE(light_effects, NULL, effects_setup, effects_before, NULL, NULL);
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Light groups and scenes tests
+ *
+ * Group membership and lookup, table capacity, group commands reaching
+ * every member in one output update, scene recall applied atomically,
+ * the tables restored by init() (a scene table of another layout
+ * discarded), and dispatch benchmarks.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+#include <string.h>
+
+#include "matter/light_endpoint/light_groups.hpp"
+#include "bench.h"
+
+using namespace smarthome::protocol::matter;
+
+#define EP(n) ((uint16_t)(LIGHT_ENDPOINT_ID + (n)))
+
+#define SCENES_KEY "matter/scenes"
+
+static uint32_t updates;
+static uint32_t last_mask;
+
+static void record_update(const LightAttributes *attrs, uint32_t changed_mask)
+{
+	updates++;
+	last_mask = changed_mask;
+}
+
+static LightAttributes attrs_of(uint16_t endpoint_id)
+{
+	LightAttributes attrs = {};
+
+	zassert_true(LightEndpoints::getInstance().getAttributes(endpoint_id, attrs));
+	return attrs;
+}
+
+static void *groups_setup(void)
+{
+	zassert_ok(settings_subsys_init());
+	return NULL;
+}
+
+static void groups_before(void *fixture)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightGroups &groups = LightGroups::getInstance();
+
+	lights.setOutput(nullptr);
+	lights.erase();
+	lights.init();
+	groups.erase();
+	zassert_equal(groups.init(), 0, "nothing stored");
+	groups.resetLatency();
+	lights.setOutput(record_update);
+	updates = 0;
+	last_mask = 0;
+}
+
+/*=============================================================================
+ * Groups
+ *===========================================================================*/
+
+ZTEST(light_groups, test_membership)
+{
+	LightGroups &groups = LightGroups::getInstance();
+
+	zassert_ok(groups.addGroup(EP(0), 0x0101));
+	zassert_ok(groups.addGroup(EP(2), 0x0101));
+	zassert_ok(groups.addGroup(EP(2), 0x0101), "already a member");
+	zassert_ok(groups.addGroup(EP(1), 0x0202));
+
+	zassert_equal(groups.getGroupCount(), 2);
+	zassert_equal(groups.getMembers(0x0101), BIT(0) | BIT(2));
+	zassert_equal(groups.getMembers(0x0202), BIT(1));
+	zassert_equal(groups.getMembers(0x0303), 0);
+	zassert_true(groups.isMember(EP(2), 0x0101));
+	zassert_false(groups.isMember(EP(1), 0x0101));
+
+	zassert_equal(groups.addGroup(ROOT_ENDPOINT_ID, 0x0101), -ENOENT);
+	zassert_equal(groups.addGroup(EP(0), 0), -EINVAL);
+	zassert_equal(groups.removeGroup(EP(1), 0x0101), -ENOENT);
+
+	zassert_ok(groups.removeGroup(EP(0), 0x0101));
+	zassert_equal(groups.getMembers(0x0101), BIT(2));
+	zassert_ok(groups.removeGroup(EP(2), 0x0101));
+	zassert_equal(groups.getMembers(0x0101), 0);
+	zassert_equal(groups.getGroupCount(), 1, "empty group freed");
+
+	groups.removeAllGroups(EP(1));
+	zassert_equal(groups.getGroupCount(), 0);
+}
+
+ZTEST(light_groups, test_capacity_and_lookup)
+{
+	LightGroups &groups = LightGroups::getInstance();
+
+	/* IDs that share a bucket still resolve to their own entry */
+	for (uint16_t i = 0; i < LightGroups::CAPACITY; i++) {
+		zassert_ok(groups.addGroup(EP(i % LightEndpoints::COUNT), 0x1000 + i * 0x100));
+	}
+	zassert_equal(groups.addGroup(EP(0), 0x7777), -ENOSPC);
+	zassert_ok(groups.addGroup(EP(1), 0x1000), "joining an existing group needs no entry");
+
+	for (uint16_t i = 0; i < LightGroups::CAPACITY; i++) {
+		uint32_t expected = BIT(i % LightEndpoints::COUNT) | (i == 0 ? BIT(1) : 0);
+
+		zassert_equal(groups.getMembers(0x1000 + i * 0x100), expected, "group %u", i);
+	}
+
+	/* Removing an entry keeps the others reachable and frees its room */
+	zassert_ok(groups.removeGroup(EP(0), 0x1000));
+	zassert_ok(groups.removeGroup(EP(1), 0x1000));
+	zassert_ok(groups.addGroup(EP(0), 0x7777));
+	for (uint16_t i = 1; i < LightGroups::CAPACITY; i++) {
+		zassert_not_equal(groups.getMembers(0x1000 + i * 0x100), 0, "group %u", i);
+	}
+}
+
+ZTEST(light_groups, test_group_command_fan_out)
+{
+	LightGroups &groups = LightGroups::getInstance();
+	ClusterCommand on = { 0, ON_OFF_CLUSTER_ID, LightCommand::ON, 0 };
+	LightGroups::LatencyStats stats;
+
+	groups.addGroup(EP(0), 0x0100);
+	groups.addGroup(EP(1), 0x0100);
+	groups.addGroup(EP(3), 0x0100);
+
+	zassert_ok(groups.onGroupCommand(0x0100, on, k_cycle_get_32()));
+	zassert_equal(updates, 1, "one LED update for every member");
+	zassert_equal(last_mask, BIT(0) | BIT(1) | BIT(3));
+	zassert_true(attrs_of(EP(0)).on_off);
+	zassert_true(attrs_of(EP(3)).on_off);
+	zassert_false(attrs_of(EP(2)).on_off, "not a member");
+
+	ClusterCommand level = { 0, LEVEL_CONTROL_CLUSTER_ID, LightCommand::MOVE_TO_LEVEL, 80 };
+	zassert_ok(groups.onGroupCommand(0x0100, level, k_cycle_get_32()));
+	zassert_equal(updates, 2);
+	zassert_equal(attrs_of(EP(1)).current_level, 80);
+	zassert_equal(attrs_of(EP(2)).current_level, LightEndpointTemplate::MAX_LEVEL);
+
+	/* Not for this node, or a bad command: nothing moves */
+	zassert_equal(groups.onGroupCommand(0x0200, on, k_cycle_get_32()), -ENOENT);
+	level.level = 255;
+	zassert_equal(groups.onGroupCommand(0x0100, level, k_cycle_get_32()), -EINVAL);
+	zassert_equal(updates, 2);
+
+	groups.getLatency(stats);
+	zassert_equal(stats.commands, 2);
+	zassert_true(stats.max_us >= stats.last_us);
+}
+
+/*=============================================================================
+ * Scenes
+ *===========================================================================*/
+
+ZTEST(light_groups, test_scene_recall_is_atomic)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightGroups &groups = LightGroups::getInstance();
+
+	for (uint8_t i = 0; i < 3; i++) {
+		groups.addGroup(EP(i), 0x0100);
+	}
+
+	/* Scene 1: each member at its own level */
+	lights.setLightState(EP(0), true);
+	lights.setBrightness(EP(0), 20);
+	lights.setLightState(EP(1), true);
+	lights.setBrightness(EP(1), 120);
+	for (uint8_t i = 0; i < 3; i++) {
+		zassert_ok(groups.storeScene(EP(i), 0x0100, 1));
+	}
+	zassert_equal(groups.storeScene(EP(3), 0x0100, 1), -EINVAL, "not a member");
+	zassert_equal(groups.getSceneCount(), 3);
+
+	/* Everything off, then recall */
+	ClusterCommand off = { 0, ON_OFF_CLUSTER_ID, LightCommand::OFF, 0 };
+	groups.onGroupCommand(0x0100, off, k_cycle_get_32());
+	lights.setBrightness(EP(0), 200);
+	updates = 0;
+
+	ClusterCommand recall = { 0, SCENES_CLUSTER_ID, LightCommand::RECALL_SCENE, 0, 0x0100, 1 };
+	zassert_ok(groups.onGroupCommand(0x0100, recall, k_cycle_get_32()));
+	zassert_equal(updates, 1, "all members in one LED update");
+	zassert_equal(last_mask, BIT(0) | BIT(1));
+	zassert_true(attrs_of(EP(0)).on_off);
+	zassert_equal(attrs_of(EP(0)).current_level, 20);
+	zassert_equal(attrs_of(EP(1)).current_level, 120);
+	zassert_false(attrs_of(EP(2)).on_off);
+
+	recall.scene_id = 2;
+	zassert_equal(groups.onGroupCommand(0x0100, recall, k_cycle_get_32()), -ENOENT);
+
+	/* Leaving the group drops the member's scenes in it */
+	zassert_ok(groups.removeGroup(EP(1), 0x0100));
+	zassert_equal(groups.getSceneCount(), 2);
+	zassert_equal(groups.recallScene(EP(1), 0x0100, 1), -ENOENT);
+	zassert_ok(groups.removeScene(EP(0), 0x0100, 1));
+	zassert_equal(groups.removeScene(EP(0), 0x0100, 1), -ENOENT);
+}
+
+ZTEST(light_groups, test_scene_table_full)
+{
+	LightGroups &groups = LightGroups::getInstance();
+
+	for (uint8_t id = 0; id < LightGroups::SCENE_CAPACITY; id++) {
+		zassert_ok(groups.storeScene(EP(0), 0, id));
+	}
+	zassert_equal(groups.storeScene(EP(1), 0, 0), -ENOSPC);
+	zassert_ok(groups.storeScene(EP(0), 0, 3), "overwrite needs no entry");
+	zassert_equal(groups.getSceneCount(), LightGroups::SCENE_CAPACITY);
+}
+
+/*=============================================================================
+ * Persistence
+ *===========================================================================*/
+
+ZTEST(light_groups, test_reload)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightGroups &groups = LightGroups::getInstance();
+
+	groups.addGroup(EP(0), 0x0100);
+	groups.addGroup(EP(3), 0x0100);
+	groups.addGroup(EP(2), 0x0A0A);
+	lights.setBrightness(EP(3), 60);
+	groups.storeScene(EP(3), 0x0100, 7);
+	k_sleep(K_MSEC(100));
+
+	zassert_equal(groups.init(), 2);
+	zassert_equal(groups.getMembers(0x0100), BIT(0) | BIT(3));
+	zassert_equal(groups.getMembers(0x0A0A), BIT(2));
+	zassert_equal(groups.getSceneCount(), 1);
+
+	lights.setBrightness(EP(3), 200);
+	zassert_ok(groups.recallScene(EP(3), 0x0100, 7));
+	zassert_equal(attrs_of(EP(3)).current_level, 60);
+}
+
+ZTEST(light_groups, test_reload_unknown_layout)
+{
+	LightGroups &groups = LightGroups::getInstance();
+	uint8_t junk[5] = { 1, 2, 3, 4, 5 };
+
+	zassert_ok(settings_save_one(SCENES_KEY, junk, sizeof(junk)));
+	zassert_equal(groups.init(), 0);
+	zassert_equal(groups.getSceneCount(), 0);
+}
+
+/*=============================================================================
+ * Benchmarks
+ *===========================================================================*/
+
+ZTEST(light_groups, test_bench_dispatch)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightGroups &groups = LightGroups::getInstance();
+	ClusterCommand toggle = { EP(0), ON_OFF_CLUSTER_ID, LightCommand::TOGGLE, 0 };
+	struct bench b;
+
+	bench_init(&b, "light", "endpoint_toggle");
+	for (int i = 0; i < 200; i++) {
+		bench_begin(&b);
+		zassert_ok(lights.dispatch(toggle));
+		bench_end(&b, 1);
+	}
+	bench_report(&b);
+
+	/* One lookup and one masked dispatch, whatever the member count */
+	for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+		groups.addGroup(EP(i), 0x0100);
+	}
+	bench_init(&b, "light", "group_toggle_all");
+	for (int i = 0; i < 200; i++) {
+		bench_begin(&b);
+		zassert_ok(groups.onGroupCommand(0x0100, toggle, k_cycle_get_32()));
+		bench_end(&b, 1);
+	}
+	bench_report(&b);
+	zassert_equal(updates, 400, "one output update per command");
+}
+
+ZTEST_SUITE(light_groups, NULL, groups_setup, groups_before, NULL, NULL);
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Light endpoint tests
+ *
+ * Compile-time endpoint table, command routing by endpoint ID with the
+ * output of each LED kept apart, error codes for what is not routed,
+ * per-endpoint persistence (delayed, then restored by init()) and the
+ * StartUpOnOff / StartUpCurrentLevel behavior applied by init().
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+
+#include "matter/light_endpoint/light_endpoint.hpp"
+
+using namespace smarthome::protocol::matter;
+
+struct Output {
+	bool on;
+	uint8_t level;
+	uint32_t calls;
+};
+
+static Output outputs[LightEndpoints::COUNT];
+static uint32_t output_updates;
+
+static void record_output(const LightAttributes *attrs, uint32_t changed_mask)
+{
+	zassert_equal(changed_mask & ~LightEndpoints::ALL, 0);
+	for (uint8_t led = 0; led < LightEndpoints::COUNT; led++) {
+		if (changed_mask & BIT(led)) {
+			outputs[led].on = attrs[led].on_off;
+			outputs[led].level = attrs[led].current_level;
+			outputs[led].calls++;
+		}
+	}
+	output_updates++;
+}
+
+static LightAttributes attrs_of(uint16_t endpoint_id)
+{
+	LightAttributes attrs = {};
+
+	zassert_true(LightEndpoints::getInstance().getAttributes(endpoint_id, attrs));
+	return attrs;
+}
+
+static void *light_setup(void)
+{
+	zassert_ok(settings_subsys_init());
+	return NULL;
+}
+
+static void light_before(void *fixture)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+
+	lights.setOutput(nullptr);
+	lights.erase();
+	zassert_equal(lights.init(), 0, "nothing stored");
+	memset(outputs, 0, sizeof(outputs));
+	output_updates = 0;
+	lights.setOutput(record_output);
+}
+
+/*=============================================================================
+ * Routing
+ *===========================================================================*/
+
+ZTEST(light_endpoint, test_endpoint_table)
+{
+	for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+		zassert_equal(LIGHT_ENDPOINTS[i].endpoint_id, LIGHT_ENDPOINT_ID + i);
+		zassert_equal(LIGHT_ENDPOINTS[i].led, i);
+		zassert_equal(LightEndpoints::indexOf(LIGHT_ENDPOINTS[i].endpoint_id), i);
+		zassert_equal(LightEndpoints::endpointForLed(i), LIGHT_ENDPOINTS[i].endpoint_id);
+	}
+	zassert_equal(LightEndpoints::indexOf(ROOT_ENDPOINT_ID), LightEndpoints::COUNT);
+	zassert_equal(LightEndpoints::indexOf(LIGHT_ENDPOINT_ID + LightEndpoints::COUNT),
+		      LightEndpoints::COUNT);
+
+	/* setOutput() drove every LED with the defaults */
+	for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+		zassert_equal(outputs[i].calls, 1);
+		zassert_false(outputs[i].on);
+	}
+}
+
+ZTEST(light_endpoint, test_commands_reach_one_endpoint)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	ClusterCommand on = { LIGHT_ENDPOINT_ID + 2, ON_OFF_CLUSTER_ID, LightCommand::ON, 0 };
+
+	memset(outputs, 0, sizeof(outputs));
+	zassert_ok(lights.dispatch(on));
+	zassert_true(attrs_of(LIGHT_ENDPOINT_ID + 2).on_off);
+	zassert_true(outputs[2].on);
+	for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+		zassert_equal(outputs[i].calls, i == 2 ? 1 : 0, "LED %u", i);
+	}
+
+	/* Repeating a command changes nothing and drives nothing */
+	zassert_ok(lights.dispatch(on));
+	zassert_equal(outputs[2].calls, 1);
+
+	zassert_ok(lights.toggle(LIGHT_ENDPOINT_ID));
+	zassert_ok(lights.toggle(LIGHT_ENDPOINT_ID + 2));
+	zassert_true(attrs_of(LIGHT_ENDPOINT_ID).on_off);
+	zassert_false(attrs_of(LIGHT_ENDPOINT_ID + 2).on_off);
+	zassert_false(attrs_of(LIGHT_ENDPOINT_ID + 1).on_off);
+
+	/* MoveToLevelWithOnOff: 0 turns off at the minimum level */
+	ClusterCommand level = { LIGHT_ENDPOINT_ID + 3, LEVEL_CONTROL_CLUSTER_ID,
+				 LightCommand::MOVE_TO_LEVEL_WITH_ON_OFF, 100 };
+	zassert_ok(lights.dispatch(level));
+	zassert_true(outputs[3].on);
+	zassert_equal(outputs[3].level, 100);
+	level.level = 0;
+	zassert_ok(lights.dispatch(level));
+	zassert_false(attrs_of(LIGHT_ENDPOINT_ID + 3).on_off);
+	zassert_equal(attrs_of(LIGHT_ENDPOINT_ID + 3).current_level, 1);
+
+	/* MoveToLevel leaves OnOff alone */
+	zassert_ok(lights.setBrightness(LIGHT_ENDPOINT_ID + 3, 200));
+	zassert_false(attrs_of(LIGHT_ENDPOINT_ID + 3).on_off);
+	zassert_equal(attrs_of(LIGHT_ENDPOINT_ID + 3).current_level, 200);
+}
+
+ZTEST(light_endpoint, test_unrouted_commands)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	ClusterCommand cmd = { ROOT_ENDPOINT_ID, ON_OFF_CLUSTER_ID, LightCommand::ON, 0 };
+	LightAttributes attrs;
+
+	zassert_equal(lights.dispatch(cmd), -ENOENT);
+	cmd.endpoint_id = LIGHT_ENDPOINT_ID + LightEndpoints::COUNT;
+	zassert_equal(lights.dispatch(cmd), -ENOENT);
+	zassert_false(lights.getAttributes(cmd.endpoint_id, attrs));
+
+	cmd.endpoint_id = LIGHT_ENDPOINT_ID;
+	cmd.cluster_id = COLOR_CONTROL_CLUSTER_ID;
+	zassert_equal(lights.dispatch(cmd), -ENOTSUP);
+
+	cmd.cluster_id = ON_OFF_CLUSTER_ID;
+	cmd.command_id = 0x40;
+	zassert_equal(lights.dispatch(cmd), -ENOTSUP);
+
+	cmd.cluster_id = LEVEL_CONTROL_CLUSTER_ID;
+	cmd.command_id = LightCommand::MOVE_TO_LEVEL;
+	cmd.level = 255;
+	zassert_equal(lights.dispatch(cmd), -EINVAL);
+
+	zassert_false(attrs_of(LIGHT_ENDPOINT_ID).on_off);
+	zassert_equal(attrs_of(LIGHT_ENDPOINT_ID).current_level, LightEndpointTemplate::MAX_LEVEL);
+}
+
+/*=============================================================================
+ * Persistence
+ *===========================================================================*/
+
+ZTEST(light_endpoint, test_persist_per_endpoint)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+
+	zassert_ok(lights.setLightState(LIGHT_ENDPOINT_ID + 1, true));
+	zassert_ok(lights.setBrightness(LIGHT_ENDPOINT_ID + 1, 42));
+	for (int i = 0; i < 5; i++) {
+		zassert_ok(lights.toggle(LIGHT_ENDPOINT_ID + 3));
+	}
+
+	/* Written after the delay, not on every change */
+	k_sleep(K_MSEC(LIGHT_PERSIST_DELAY_MS / 2));
+	lights.setOutput(nullptr);
+	zassert_equal(lights.init(), 0);
+	zassert_false(attrs_of(LIGHT_ENDPOINT_ID + 1).on_off, "defaults until written");
+
+	zassert_ok(lights.setLightState(LIGHT_ENDPOINT_ID + 1, true));
+	zassert_ok(lights.setBrightness(LIGHT_ENDPOINT_ID + 1, 42));
+	zassert_ok(lights.setLightState(LIGHT_ENDPOINT_ID + 3, true));
+	k_sleep(K_MSEC(LIGHT_PERSIST_DELAY_MS + 100));
+
+	/* Restored with everything else at its default */
+	zassert_ok(lights.setLightState(LIGHT_ENDPOINT_ID, true));
+	lights.flush();
+	zassert_ok(lights.setLightState(LIGHT_ENDPOINT_ID, false));
+	zassert_equal(lights.init(), 3);
+	zassert_true(attrs_of(LIGHT_ENDPOINT_ID).on_off, "flushed value");
+	zassert_true(attrs_of(LIGHT_ENDPOINT_ID + 1).on_off);
+	zassert_equal(attrs_of(LIGHT_ENDPOINT_ID + 1).current_level, 42);
+	zassert_false(attrs_of(LIGHT_ENDPOINT_ID + 2).on_off);
+	zassert_true(attrs_of(LIGHT_ENDPOINT_ID + 3).on_off);
+	zassert_equal(attrs_of(LIGHT_ENDPOINT_ID + 3).current_level, LightEndpointTemplate::MAX_LEVEL);
+}
+
+ZTEST(light_endpoint, test_startup_behavior)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	const LightStartUp off = { StartUpOnOff::OFF, LightEndpointTemplate::STARTUP_PREVIOUS };
+	const LightStartUp toggle = { StartUpOnOff::TOGGLE, 100 };
+	const LightStartUp on_min = { StartUpOnOff::ON, 0 };
+	LightStartUp startup;
+
+	for (uint16_t ep = LIGHT_ENDPOINT_ID; ep < LIGHT_ENDPOINT_ID + 3; ep++) {
+		zassert_ok(lights.setLightState(ep, true));
+		zassert_ok(lights.setBrightness(ep, 42));
+	}
+	zassert_ok(lights.setStartUp(LIGHT_ENDPOINT_ID, off));
+	zassert_ok(lights.setStartUp(LIGHT_ENDPOINT_ID + 1, toggle));
+	zassert_ok(lights.setStartUp(LIGHT_ENDPOINT_ID + 2, on_min));
+	lights.flush();
+
+	/* Boot: startup values are in place before the first output */
+	lights.setOutput(nullptr);
+	zassert_equal(lights.init(), 3);
+	memset(outputs, 0, sizeof(outputs));
+	lights.setOutput(record_output);
+	zassert_false(outputs[0].on);
+	zassert_equal(attrs_of(LIGHT_ENDPOINT_ID).current_level, 42, "previous level");
+	zassert_false(outputs[1].on, "toggled");
+	zassert_equal(outputs[1].level, 100);
+	zassert_true(outputs[2].on);
+	zassert_equal(outputs[2].level, LightEndpointTemplate::MIN_LEVEL);
+	zassert_false(outputs[3].on, "never stored, never set");
+	zassert_true(lights.getStartUp(LIGHT_ENDPOINT_ID + 1, startup));
+	zassert_equal(startup.on_off, StartUpOnOff::TOGGLE);
+
+	/* The toggled value is what the next boot toggles */
+	k_sleep(K_MSEC(LIGHT_PERSIST_DELAY_MS + 100));
+	lights.setOutput(nullptr);
+	lights.init();
+	zassert_true(attrs_of(LIGHT_ENDPOINT_ID + 1).on_off);
+
+	const LightStartUp bad = { 3, LightEndpointTemplate::STARTUP_PREVIOUS };
+	zassert_equal(lights.setStartUp(LIGHT_ENDPOINT_ID, bad), -EINVAL);
+	zassert_equal(lights.setStartUp(ROOT_ENDPOINT_ID, off), -ENOENT);
+	zassert_false(lights.getStartUp(ROOT_ENDPOINT_ID, startup));
+}
+
+ZTEST_SUITE(light_endpoint, NULL, light_setup, light_before, NULL, NULL);
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Commissioning timeline tests
+ *
+ * Stage marks, outcomes, tracking after completion, the attempt ring,
+ * persistence round trip and the exported line.
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+
+#include "matter/commission/commissioning_timeline.hpp"
+
+using namespace smarthome::protocol::matter;
+
+static CommissioningTimeline timeline;
+
+static void timeline_before(void *fixture)
+{
+	timeline.clear();
+}
+
+ZTEST(commissioning_timeline, test_successful_attempt)
+{
+	timeline.begin(10000);
+	zassert_true(timeline.mark(CommissioningStage::ADV_STARTED, 10040));
+	zassert_true(timeline.mark(CommissioningStage::BLE_CONNECTED, 15250));
+	zassert_false(timeline.mark(CommissioningStage::BLE_CONNECTED, 16000), "first only");
+	zassert_true(timeline.mark(CommissioningStage::PASE_ESTABLISHED, 16100));
+	zassert_true(timeline.mark(CommissioningStage::FABRIC_ADDED, 18800));
+	zassert_true(timeline.mark(CommissioningStage::COMPLETE, 19500));
+	zassert_true(timeline.finish(AttemptOutcome::COMPLETE));
+
+	/* Attach and the first operational message come after the window */
+	zassert_true(timeline.isTracking());
+	zassert_true(timeline.mark(CommissioningStage::THREAD_ATTACHED, 21000));
+	zassert_true(timeline.mark(CommissioningStage::FIRST_OPERATIONAL, 22000));
+	zassert_false(timeline.isTracking());
+
+	const CommissioningAttempt *a = timeline.get(0);
+	zassert_not_null(a);
+	zassert_equal(a->seq, 1);
+	zassert_equal(a->outcome, (uint8_t)AttemptOutcome::COMPLETE);
+	zassert_equal(a->reached, 0xFF);
+	zassert_equal(a->stage_ms[(size_t)CommissioningStage::BLE_CONNECTED], 5250);
+	zassert_equal(a->stage_ms[(size_t)CommissioningStage::FIRST_OPERATIONAL], 12000);
+
+	uint32_t gap = 0;
+	zassert_equal(CommissioningTimeline::slowestStage(*a, &gap),
+		      CommissioningStage::BLE_CONNECTED);
+	zassert_equal(gap, 5210);
+}
+
+ZTEST(commissioning_timeline, test_outcomes)
+{
+	timeline.begin(0);
+	zassert_true(timeline.mark(CommissioningStage::ADV_STARTED, 30));
+	zassert_true(timeline.finish(AttemptOutcome::TIMEOUT));
+	zassert_false(timeline.isTracking());
+	zassert_false(timeline.mark(CommissioningStage::BLE_CONNECTED, 100));
+	zassert_false(timeline.finish(AttemptOutcome::CANCELLED), "outcome is set once");
+	zassert_equal(timeline.get(0)->outcome, (uint8_t)AttemptOutcome::TIMEOUT);
+
+	/* Reopening ends a running attempt */
+	timeline.begin(1000);
+	timeline.begin(2000);
+	zassert_equal(timeline.size(), 3);
+	zassert_equal(timeline.get(1)->outcome, (uint8_t)AttemptOutcome::CANCELLED);
+	zassert_equal(timeline.get(0)->outcome, (uint8_t)AttemptOutcome::IN_PROGRESS);
+}
+
+ZTEST(commissioning_timeline, test_ring_and_restore)
+{
+	for (uint32_t i = 0; i < CommissioningTimeline::DEPTH + 3; i++) {
+		timeline.begin(i * 1000);
+		timeline.finish(AttemptOutcome::CANCELLED);
+	}
+	zassert_equal(timeline.size(), CommissioningTimeline::DEPTH);
+	zassert_equal(timeline.get(0)->seq, CommissioningTimeline::DEPTH + 3);
+	zassert_equal(timeline.get(CommissioningTimeline::DEPTH - 1)->seq, 4);
+	zassert_is_null(timeline.get(CommissioningTimeline::DEPTH));
+
+	/* In progress at the reset */
+	timeline.begin(0);
+
+	CommissioningTimeline::History stored;
+	memcpy(&stored, &timeline.getHistory(), sizeof(stored));
+
+	static CommissioningTimeline restored;
+	zassert_true(restored.restore(&stored, sizeof(stored)));
+	zassert_equal(restored.size(), CommissioningTimeline::DEPTH);
+	zassert_equal(restored.get(0)->outcome, (uint8_t)AttemptOutcome::FAILED);
+	zassert_false(restored.isTracking());
+
+	/* Numbering continues across reboots */
+	restored.begin(0);
+	zassert_equal(restored.get(0)->seq, CommissioningTimeline::DEPTH + 5);
+
+	stored.version++;
+	zassert_false(restored.restore(&stored, sizeof(stored)));
+	zassert_equal(restored.size(), 0);
+}
+
+ZTEST(commissioning_timeline, test_format)
+{
+	char line[160];
+
+	timeline.begin(0);
+	timeline.mark(CommissioningStage::ADV_STARTED, 40);
+	timeline.mark(CommissioningStage::BLE_CONNECTED, 5250);
+	timeline.finish(AttemptOutcome::TIMEOUT);
+
+	int n = CommissioningTimeline::format(*timeline.get(0), line, sizeof(line));
+	zassert_equal(n, (int)strlen(line));
+	zassert_str_equal(line, "#1 TIMEOUT adv=40 ble=5250 pase=- fabric=- attach=- done=- op=- "
+				"slowest=ble/5210");
+
+	/* Truncates into small buffers */
+	n = CommissioningTimeline::format(*timeline.get(0), line, 8);
+	zassert_equal(n, 7);
+	zassert_str_equal(line, "#1 TIME");
+}
+
+ZTEST_SUITE(commissioning_timeline, NULL, NULL, timeline_before, NULL, NULL);
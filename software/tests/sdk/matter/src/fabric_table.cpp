@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Fabric table tests
+ *
+ * Capacity, index-to-slot mapping, duplicates, removal and index reuse,
+ * reload from settings, and certificates read only on first use with
+ * least-recently-used eviction.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+#include <string.h>
+
+#include "matter/commission/fabric_table.hpp"
+
+using namespace smarthome::protocol::matter;
+
+static FabricTable table;
+static FabricTable reloaded;
+
+static uint8_t noc[FABRIC_CERT_MAX_LEN];
+static uint8_t icac[FABRIC_CERT_MAX_LEN];
+static uint8_t rcac[FABRIC_CERT_MAX_LEN];
+
+/* Certificates carry the fabric ID so a mixed-up chain shows */
+static CertificateChain make_chain(uint64_t fabric_id, bool with_icac)
+{
+	memset(noc, (uint8_t)fabric_id, sizeof(noc));
+	memset(icac, (uint8_t)(fabric_id + 0x40), sizeof(icac));
+	memset(rcac, (uint8_t)(fabric_id + 0x80), sizeof(rcac));
+
+	CertificateChain chain = {
+		noc, (uint16_t)(200 + fabric_id),
+		with_icac ? icac : nullptr, (uint16_t)(with_icac ? 180 : 0),
+		rcac, 150,
+	};
+	return chain;
+}
+
+static int add_fabric(uint64_t fabric_id, bool with_icac = true)
+{
+	FabricDescriptor desc = {
+		fabric_id, 0x1000 + fabric_id, 0xC0FFEE00 + fabric_id, 0xFFF1, "Home",
+	};
+	return table.add(desc, make_chain(fabric_id, with_icac));
+}
+
+static void *fabric_setup(void)
+{
+	zassert_ok(settings_subsys_init());
+	return NULL;
+}
+
+static void fabric_before(void *fixture)
+{
+	table.load();
+	table.clear();
+}
+
+/*=============================================================================
+ * Records
+ *===========================================================================*/
+
+ZTEST(fabric_table, test_fill_to_capacity)
+{
+	for (uint64_t id = 1; id <= FabricTable::CAPACITY; id++) {
+		zassert_equal(add_fabric(id), (int)id);
+	}
+	zassert_true(table.isFull());
+	zassert_equal(add_fabric(99), -ENOSPC);
+
+	/* Each index maps straight to its slot */
+	for (uint8_t index = 1; index <= FabricTable::CAPACITY; index++) {
+		const FabricRecord *rec = table.find(index);
+
+		zassert_not_null(rec);
+		zassert_equal(rec, table.at(FabricTable::slotOf(index)));
+		zassert_equal(rec->fabric_id, index);
+		zassert_equal(rec->noc_len, 200 + index);
+		zassert_str_equal(rec->label, "Home");
+	}
+	zassert_is_null(table.find(0));
+	zassert_is_null(table.find(FabricTable::CAPACITY + 1));
+
+	zassert_equal(table.findByCompressedId(0xC0FFEE03, 0x1003)->fabric_index, 3);
+	zassert_is_null(table.findByCompressedId(0xC0FFEE03, 0x1004), "other node");
+}
+
+ZTEST(fabric_table, test_rejects_duplicates_and_bad_chains)
+{
+	zassert_equal(add_fabric(7), 1);
+	zassert_equal(add_fabric(7), -EEXIST);
+
+	FabricDescriptor desc = { 8, 8, 8, 0xFFF1, nullptr };
+	CertificateChain chain = make_chain(8, false);
+
+	chain.rcac = nullptr;
+	zassert_equal(table.add(desc, chain), -EINVAL, "RCAC is required");
+	chain = make_chain(8, false);
+	chain.noc_len = FABRIC_CERT_MAX_LEN + 1;
+	zassert_equal(table.add(desc, chain), -EINVAL);
+	zassert_equal(table.size(), 1);
+}
+
+ZTEST(fabric_table, test_remove_and_reuse)
+{
+	for (uint64_t id = 1; id <= FabricTable::CAPACITY; id++) {
+		add_fabric(id);
+	}
+
+	zassert_ok(table.remove(2));
+	zassert_equal(table.remove(2), -ENOENT);
+	zassert_is_null(table.find(2));
+	zassert_false(table.isFull());
+
+	/* Indices keep growing; the next free slot is the one index 2 left */
+	int index = add_fabric(42);
+	zassert_equal(index, 7);
+	zassert_equal(FabricTable::slotOf(index), FabricTable::slotOf(2));
+	zassert_equal(table.find(7)->fabric_id, 42);
+	zassert_is_null(table.find(2), "old index stays invalid");
+}
+
+ZTEST(fabric_table, test_reload)
+{
+	add_fabric(1);
+	add_fabric(2, false);
+	add_fabric(3);
+	table.remove(1);
+
+	zassert_equal(reloaded.load(), 2);
+	for (uint8_t slot = 0; slot < FabricTable::CAPACITY; slot++) {
+		const FabricRecord *a = table.at(slot);
+		const FabricRecord *b = reloaded.at(slot);
+
+		zassert_equal(a == nullptr, b == nullptr, "slot %u", slot);
+		if (a) {
+			zassert_mem_equal(a, b, sizeof(*a));
+		}
+	}
+
+	/* The allocator carries on where it was */
+	zassert_equal(reloaded.getStats().credential_loads, 0, "records only");
+	FabricDescriptor desc = { 9, 9, 9, 0xFFF1, nullptr };
+	zassert_equal(reloaded.add(desc, make_chain(9, true)), 4);
+	reloaded.clear();
+}
+
+/*=============================================================================
+ * Credentials
+ *===========================================================================*/
+
+ZTEST(fabric_table, test_credentials_load_lazily)
+{
+	add_fabric(1);
+	add_fabric(2, false);
+	add_fabric(3);
+	zassert_equal(reloaded.load(), 3);
+
+	const FabricCredentials *creds = reloaded.getCredentials(2);
+	zassert_not_null(creds);
+	zassert_equal(creds->fabric_index, 2);
+	zassert_equal(creds->noc_len, 202);
+	zassert_equal(creds->icac_len, 0);
+	zassert_equal(creds->rcac_len, 150);
+	zassert_equal(creds->noc[201], 2);
+	zassert_equal(creds->rcac[0], 0x82);
+
+	zassert_equal(reloaded.getCredentials(2), creds);
+	zassert_equal(reloaded.getStats().credential_loads, 1);
+	zassert_equal(reloaded.getStats().credential_hits, 1);
+
+	/* Two cache slots: loading 1 then 3 evicts 2, the least recently used */
+	zassert_not_null(reloaded.getCredentials(1));
+	reloaded.getCredentials(1);
+	creds = reloaded.getCredentials(3);
+	zassert_not_null(creds);
+	zassert_equal(creds->icac_len, 180);
+	zassert_equal(creds->icac[0], 0x43);
+	zassert_equal(reloaded.getStats().credential_loads, 3);
+
+	reloaded.getCredentials(1);
+	zassert_equal(reloaded.getStats().credential_loads, 3, "1 still cached");
+	reloaded.getCredentials(2);
+	zassert_equal(reloaded.getStats().credential_loads, 4, "2 was evicted");
+
+	/* Removal drops the cached copy */
+	zassert_ok(reloaded.remove(2));
+	zassert_is_null(reloaded.getCredentials(2));
+	zassert_is_null(reloaded.getCredentials(0));
+}
+
+ZTEST_SUITE(fabric_table, NULL, fabric_setup, fabric_before, NULL, NULL);
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Factory data tests
+ *
+ * Record validation against a golden record from scripts/gen_factory_data.py
+ * (Matter test credentials: passcode 20202021, discriminator 3840, salt
+ * "SPAKE2P Key Salt", 1000 iterations), so the script and FactoryRecord
+ * cannot drift apart, and FactoryData::load() from factory_partition on
+ * the simulated flash (boards/native_sim.overlay): erased, corrupted and
+ * programmed.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <string.h>
+
+#include "matter/commission/factory_data.hpp"
+
+using namespace smarthome::protocol::matter;
+
+static const uint8_t golden[sizeof(FactoryRecord)] __aligned(4) = {
+	0x4d, 0x46, 0x44, 0x31, 0x01, 0x00, 0xe4, 0x00, 0x78, 0x29, 0x94, 0xfc,
+	0xf1, 0xff, 0x01, 0x80, 0x00, 0x0f, 0x10, 0x61, 0x25, 0x42, 0x34, 0x01,
+	0xe8, 0x03, 0x00, 0x00, 0x53, 0x50, 0x41, 0x4b, 0x45, 0x32, 0x50, 0x20,
+	0x4b, 0x65, 0x79, 0x20, 0x53, 0x61, 0x6c, 0x74, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xb9, 0x61, 0x70, 0xaa, 0xe8, 0x03, 0x34, 0x68, 0x84, 0x72, 0x4f, 0xe9,
+	0xa3, 0xb2, 0x87, 0xc3, 0x03, 0x30, 0xc2, 0xa6, 0x60, 0x37, 0x5d, 0x17,
+	0xbb, 0x20, 0x5a, 0x8c, 0xf1, 0xae, 0xcb, 0x35, 0x04, 0x57, 0xf8, 0xab,
+	0x79, 0xee, 0x25, 0x3a, 0xb6, 0xa8, 0xe4, 0x6b, 0xb0, 0x9e, 0x54, 0x3a,
+	0xe4, 0x22, 0x73, 0x6d, 0xe5, 0x01, 0xe3, 0xdb, 0x37, 0xd4, 0x41, 0xfe,
+	0x34, 0x49, 0x20, 0xd0, 0x95, 0x48, 0xe4, 0xc1, 0x82, 0x40, 0x63, 0x0c,
+	0x4f, 0xf4, 0x91, 0x3c, 0x53, 0x51, 0x38, 0x39, 0xb7, 0xc0, 0x7f, 0xcc,
+	0x06, 0x27, 0xa1, 0xb8, 0x57, 0x3a, 0x14, 0x9f, 0xcd, 0x1f, 0xa4, 0x66,
+	0xcf, 0x4d, 0x54, 0x3a, 0x2d, 0x32, 0x34, 0x4a, 0x30, 0x34, 0x32, 0x43,
+	0x30, 0x30, 0x4b, 0x41, 0x30, 0x36, 0x34, 0x38, 0x47, 0x30, 0x30, 0x00,
+	0x00, 0x33, 0x34, 0x39, 0x37, 0x30, 0x31, 0x31, 0x32, 0x33, 0x33, 0x32,
+	0x00, 0x54, 0x45, 0x53, 0x54, 0x2d, 0x53, 0x4e, 0x2d, 0x30, 0x30, 0x30,
+	0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+/* First bytes of w0 in the CHIP SDK test verifier */
+static const uint8_t w0_prefix[] = { 0xb9, 0x61, 0x70, 0xaa, 0xe8, 0x03, 0x34, 0x68 };
+
+static FactoryRecord rec;
+
+static void reseal(void)
+{
+	const uint8_t *body = (const uint8_t *)&rec + offsetof(FactoryRecord, vendor_id);
+
+	rec.crc32 = crc32_ieee(body, sizeof(rec) - offsetof(FactoryRecord, vendor_id));
+}
+
+static void factory_before(void *fixture)
+{
+	memcpy(&rec, golden, sizeof(rec));
+}
+
+ZTEST(factory_data, test_golden_record)
+{
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), 0);
+
+	zassert_equal(rec.vendor_id, 0xFFF1);
+	zassert_equal(rec.product_id, 0x8001);
+	zassert_equal(rec.discriminator, 3840);
+	zassert_equal(rec.passcode, 20202021);
+	zassert_equal(rec.spake2p_iterations, 1000);
+	zassert_equal(rec.salt_len, 16);
+	zassert_mem_equal(rec.salt, "SPAKE2P Key Salt", 16);
+	zassert_mem_equal(rec.verifier, w0_prefix, sizeof(w0_prefix));
+	zassert_equal(rec.verifier[32], 0x04, "L must be uncompressed");
+	zassert_str_equal(rec.qr_code, "MT:-24J042C00KA0648G00");
+	zassert_str_equal(rec.manual_code, "34970112332");
+	zassert_str_equal(rec.serial_number, "TEST-SN-0001");
+}
+
+ZTEST(factory_data, test_erased_and_short)
+{
+	uint8_t erased[sizeof(FactoryRecord)] __aligned(4);
+
+	memset(erased, 0xFF, sizeof(erased));
+	zassert_equal(validateFactoryRecord(erased, sizeof(erased)), -ENOENT);
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec) - 1), -ENOENT);
+}
+
+ZTEST(factory_data, test_corruption)
+{
+	rec.verifier[40] ^= 0x01;
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), -EBADMSG);
+
+	memcpy(&rec, golden, sizeof(rec));
+	rec.version = 2;
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), -EBADMSG);
+}
+
+ZTEST(factory_data, test_field_ranges)
+{
+	rec.passcode = 12345678;
+	reseal();
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), -EINVAL);
+
+	/* Verifier-only records are fine */
+	rec.passcode = 0;
+	reseal();
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), 0);
+
+	rec.discriminator = 0x1000;
+	reseal();
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), -EINVAL);
+
+	memcpy(&rec, golden, sizeof(rec));
+	rec.spake2p_iterations = 999;
+	reseal();
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), -EINVAL);
+
+	memcpy(&rec, golden, sizeof(rec));
+	memset(rec.qr_code, 'A', sizeof(rec.qr_code));
+	reseal();
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), -EINVAL);
+
+	memcpy(&rec, golden, sizeof(rec));
+	rec.manual_code[3] = 'x';
+	reseal();
+	zassert_equal(validateFactoryRecord(&rec, sizeof(rec)), -EINVAL);
+}
+
+ZTEST(factory_data, test_passcode_rules)
+{
+	zassert_true(isValidPasscode(20202021));
+	zassert_true(isValidPasscode(1));
+	zassert_true(isValidPasscode(99999998));
+	zassert_false(isValidPasscode(0));
+	zassert_false(isValidPasscode(11111111));
+	zassert_false(isValidPasscode(12345678));
+	zassert_false(isValidPasscode(87654321));
+	zassert_false(isValidPasscode(99999999));
+	zassert_false(isValidPasscode(100000000));
+}
+
+/* What the production line does, through the flash map */
+static void program(const void *data, size_t len)
+{
+	const struct flash_area *fa;
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(factory_partition), &fa));
+	zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+	if (len > 0) {
+		zassert_ok(flash_area_write(fa, 0, data, len));
+	}
+	flash_area_close(fa);
+}
+
+ZTEST(factory_data, test_load_from_partition)
+{
+	FactoryData &factory = FactoryData::getInstance();
+
+	/* Erased: CommissioningDelegate falls back to development credentials */
+	program(NULL, 0);
+	zassert_equal(factory.load(), -ENOENT);
+	zassert_false(factory.isLoaded());
+	zassert_is_null(factory.get());
+
+	rec.verifier[40] ^= 0x01;
+	program(&rec, sizeof(rec));
+	zassert_equal(factory.load(), -EBADMSG);
+	zassert_false(factory.isLoaded());
+
+	program(golden, sizeof(golden));
+	zassert_ok(factory.load());
+	zassert_true(factory.isLoaded());
+	zassert_not_null(factory.get());
+	zassert_mem_equal(factory.get(), golden, sizeof(golden));
+	zassert_equal(factory.get()->passcode, 20202021);
+	zassert_equal(factory.get()->discriminator, 3840);
+
+	/* Read once per boot: a later erase does not drop the record */
+	program(NULL, 0);
+	zassert_ok(factory.load());
+	zassert_str_equal(factory.get()->serial_number, "TEST-SN-0001");
+}
+
+ZTEST_SUITE(factory_data, NULL, NULL, factory_before, NULL, NULL);
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "http_server.h"
+
+#define SERVER_STACK_SIZE 4096
+#define SEND_CHUNK        512
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static const uint8_t *body;
+static size_t body_len;
+static struct http_script script;
+static bool dropped;
+static uint32_t requests;
+static uint32_t last_range;
+
+static int send_all(int sock, const void *data, size_t len)
+{
+	const uint8_t *p = static_cast<const uint8_t *>(data);
+
+	while (len > 0) {
+		ssize_t n = zsock_send(sock, p, MIN(len, (size_t)SEND_CHUNK), 0);
+
+		if (n < 0) {
+			return -errno;
+		}
+		p += n;
+		len -= n;
+	}
+	return 0;
+}
+
+static void serve(int client)
+{
+	char req[512];
+	char header[160];
+	size_t len = 0;
+
+	/* The request line and headers, the body of a GET is empty */
+	req[0] = '\0';
+	while (!strstr(req, "\r\n\r\n")) {
+		ssize_t n = zsock_recv(client, &req[len], sizeof(req) - 1 - len, 0);
+
+		if (n <= 0 || len + n >= sizeof(req) - 1) {
+			return;
+		}
+		len += n;
+		req[len] = '\0';
+	}
+
+	requests++;
+
+	const char *range = strstr(req, "Range: bytes=");
+	uint32_t offset = range ? strtoul(range + strlen("Range: bytes="), NULL, 10) : 0;
+
+	last_range = offset;
+
+	if (script.not_found) {
+		len = snprintf(header, sizeof(header),
+			       "HTTP/1.1 404 Not Found\r\n"
+			       "Content-Length: 0\r\nConnection: close\r\n\r\n");
+		send_all(client, header, len);
+		return;
+	}
+
+	if (!range || script.ignore_range || offset >= body_len) {
+		offset = 0;
+		len = snprintf(header, sizeof(header),
+			       "HTTP/1.1 200 OK\r\n"
+			       "Content-Length: %u\r\nConnection: close\r\n\r\n",
+			       (unsigned)body_len);
+	} else {
+		len = snprintf(header, sizeof(header),
+			       "HTTP/1.1 206 Partial Content\r\n"
+			       "Content-Range: bytes %u-%u/%u\r\n"
+			       "Content-Length: %u\r\nConnection: close\r\n\r\n",
+			       offset, (unsigned)body_len - 1, (unsigned)body_len,
+			       (unsigned)(body_len - offset));
+	}
+	if (send_all(client, header, len) < 0) {
+		return;
+	}
+
+	size_t end = body_len;
+
+	if (script.drop_after > 0 && !dropped) {
+		end = MIN(end, offset + script.drop_after);
+		dropped = true;
+	}
+	send_all(client, &body[offset], end - offset);
+}
+
+static void server_loop(void *p1, void *p2, void *p3)
+{
+	struct sockaddr_in addr = {};
+	int sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	int one = 1;
+
+	__ASSERT_NO_MSG(sock >= 0);
+	zsock_setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(HTTP_SERVER_PORT);
+	zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	__ASSERT_NO_MSG(zsock_bind(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+	__ASSERT_NO_MSG(zsock_listen(sock, 1) == 0);
+
+	while (true) {
+		int client = zsock_accept(sock, NULL, NULL);
+
+		if (client < 0) {
+			continue;
+		}
+		serve(client);
+		zsock_close(client);
+	}
+}
+
+void http_server_start(void)
+{
+	k_thread_create(&server_thread, server_stack, K_THREAD_STACK_SIZEOF(server_stack),
+			server_loop, NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	k_thread_name_set(&server_thread, "http_server");
+	/* Listening before the first request */
+	k_sleep(K_MSEC(10));
+}
+
+void http_server_set_body(const uint8_t *data, size_t len)
+{
+	body = data;
+	body_len = len;
+}
+
+void http_server_script(const struct http_script *s)
+{
+	script = *s;
+	dropped = false;
+	requests = 0;
+	last_range = 0;
+}
+
+uint32_t http_server_requests(void)
+{
+	return requests;
+}
+
+uint32_t http_server_last_range(void)
+{
+	return last_range;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Local HTTP server for the OtaManager tests
+ *
+ * Serves one body on 127.0.0.1 (loopback interface), one request per
+ * connection. A "Range: bytes=<n>-" request is answered 206 from n unless
+ * the script says to ignore it. The first response of a script can be cut
+ * after some body bytes, as a dropped link would, with the full length
+ * still announced.
+ */
+
+#ifndef TESTS_OTA_HTTP_SERVER_H
+#define TESTS_OTA_HTTP_SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HTTP_SERVER_PORT 8080
+
+/* What the server does with the next requests */
+struct http_script {
+	uint32_t drop_after;    /* Close the first response after this many body bytes (0: never) */
+	bool ignore_range;      /* Answer 200 with the whole body, Range or not */
+	bool not_found;         /* Answer 404 */
+};
+
+/* Listen on HTTP_SERVER_PORT; the server thread runs until the test ends */
+void http_server_start(void);
+
+/* Body served from now on, not copied */
+void http_server_set_body(const uint8_t *body, size_t len);
+
+/* New script, request counters cleared */
+void http_server_script(const struct http_script *script);
+
+/* Requests served since the last script */
+uint32_t http_server_requests(void);
+
+/* Start of the last Range header, 0 if the last request had none */
+uint32_t http_server_last_range(void);
+
+#endif /* TESTS_OTA_HTTP_SERVER_H */
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file OTA streaming tests
+ *
+ * Exercises OtaImageWriter against the native_sim flash simulator
+ * (slot1_partition) and DeltaPatcher against in-memory images. The HTTP
+ * leg of OtaManager is in manager.cpp.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <mbedtls/sha256.h>
+#include <string.h>
+
+#include "ota/ota_image_writer.hpp"
+#include "ota/delta_patcher.hpp"
+
+using namespace smarthome::services::ota;
+
+#define SLOT_ID    FIXED_PARTITION_ID(slot1_partition)
+#define IMAGE_SIZE (12 * 1024 + 77)
+
+static uint8_t image[IMAGE_SIZE];
+static uint8_t readback[IMAGE_SIZE];
+
+static void fill_image(uint8_t* buf, size_t len, uint32_t seed)
+{
+	for (size_t i = 0; i < len; i++) {
+		seed = seed * 1103515245U + 12345U;
+		buf[i] = (uint8_t)(seed >> 16);
+	}
+}
+
+static void sha256_of(const uint8_t* buf, size_t len, uint8_t out[SHA256_LEN])
+{
+	mbedtls_sha256(buf, len, out, 0);
+}
+
+/* Write in uneven fragments, as HTTP delivers them */
+static int write_fragments(OtaImageWriter& writer, const uint8_t* buf, size_t len)
+{
+	static const size_t frags[] = { 1, 333, 1024, 7, 2048, 129 };
+	size_t off = 0;
+	size_t i = 0;
+
+	while (off < len) {
+		size_t n = MIN(frags[i++ % ARRAY_SIZE(frags)], len - off);
+		int ret = writer.write(&buf[off], n);
+		if (ret < 0) {
+			return ret;
+		}
+		off += n;
+	}
+	return 0;
+}
+
+static void verify_slot(size_t len)
+{
+	const struct flash_area* fa;
+
+	zassert_ok(flash_area_open(SLOT_ID, &fa));
+	zassert_ok(flash_area_read(fa, 0, readback, len));
+	flash_area_close(fa);
+	zassert_mem_equal(readback, image, len, "slot content differs");
+}
+
+/*=============================================================================
+ * OtaImageWriter
+ *===========================================================================*/
+
+ZTEST(ota_writer, test_full_write_verifies)
+{
+	OtaImageWriter writer;
+	uint8_t sha[SHA256_LEN];
+
+	fill_image(image, sizeof(image), 1);
+	sha256_of(image, sizeof(image), sha);
+
+	zassert_ok(writer.begin(SLOT_ID, 0));
+	zassert_ok(write_fragments(writer, image, sizeof(image)));
+	zassert_equal(writer.getBytesAccepted(), sizeof(image));
+	zassert_ok(writer.finish(sha));
+
+	verify_slot(sizeof(image));
+}
+
+ZTEST(ota_writer, test_digest_mismatch)
+{
+	OtaImageWriter writer;
+	uint8_t sha[SHA256_LEN];
+
+	fill_image(image, sizeof(image), 2);
+	sha256_of(image, sizeof(image), sha);
+	sha[0] ^= 0xFF;
+
+	zassert_ok(writer.begin(SLOT_ID, 0));
+	zassert_ok(write_fragments(writer, image, sizeof(image)));
+	zassert_equal(writer.finish(sha), -EBADMSG);
+}
+
+ZTEST(ota_writer, test_resume_after_interruption)
+{
+	OtaImageWriter writer;
+	uint8_t sha[SHA256_LEN];
+	uint32_t aligned = 0;
+
+	fill_image(image, sizeof(image), 3);
+	sha256_of(image, sizeof(image), sha);
+
+	/* First session dies part-way through, leaving data in the block buffer */
+	zassert_ok(writer.begin(SLOT_ID, 0));
+	zassert_ok(write_fragments(writer, image, 9000));
+	uint32_t flushed = writer.getBytesFlushed();
+	zassert_true(flushed > 0 && flushed <= 9000);
+	writer.abort();
+
+	zassert_ok(OtaImageWriter::alignResumeOffset(SLOT_ID, flushed, &aligned));
+	zassert_true(aligned <= flushed);
+
+	/* Second session resumes from the page boundary ("Range: bytes=aligned-") */
+	zassert_ok(writer.begin(SLOT_ID, aligned));
+	zassert_equal(writer.getBytesAccepted(), aligned);
+	zassert_ok(write_fragments(writer, &image[aligned], sizeof(image) - aligned));
+	zassert_ok(writer.finish(sha));
+
+	verify_slot(sizeof(image));
+}
+
+ZTEST(ota_writer, test_write_requires_begin)
+{
+	OtaImageWriter writer;
+	uint8_t byte = 0;
+
+	zassert_equal(writer.write(&byte, 1), -EPERM);
+}
+
+/*=============================================================================
+ * DeltaPatcher
+ *===========================================================================*/
+
+static uint8_t old_img[4096];
+static uint8_t new_img[4096 + 300];
+static uint8_t patch[sizeof(new_img) + 256];
+static uint8_t produced[sizeof(new_img)];
+static size_t produced_len;
+
+static int mem_source(uint32_t offset, uint8_t* buf, size_t len, void* user_data)
+{
+	if (offset + len > sizeof(old_img)) {
+		return -EINVAL;
+	}
+	memcpy(buf, &old_img[offset], len);
+	return 0;
+}
+
+static int mem_sink(const uint8_t* data, size_t len, void* user_data)
+{
+	if (produced_len + len > sizeof(produced)) {
+		return -ENOSPC;
+	}
+	memcpy(&produced[produced_len], data, len);
+	produced_len += len;
+	return 0;
+}
+
+static size_t put_header(uint8_t* p, uint32_t magic, uint32_t new_size, uint32_t old_size)
+{
+	memset(p, 0, DeltaPatcher::HEADER_SIZE);
+	sys_put_le32(magic, &p[0]);
+	p[4] = DeltaPatcher::VERSION;
+	sys_put_le32(new_size, &p[8]);
+	sys_put_le32(old_size, &p[12]);
+	return DeltaPatcher::HEADER_SIZE;
+}
+
+static size_t put_control(uint8_t* p, uint32_t diff, uint32_t extra, int32_t seek)
+{
+	sys_put_le32(diff, &p[0]);
+	sys_put_le32(extra, &p[4]);
+	sys_put_le32((uint32_t)seek, &p[8]);
+	return DeltaPatcher::CONTROL_SIZE;
+}
+
+/*
+ * new = old[0..2048) with a few patched bytes, 300 inserted bytes,
+ * then old[2048..4096) copied unchanged
+ */
+static size_t build_patch(void)
+{
+	fill_image(old_img, sizeof(old_img), 7);
+	memcpy(new_img, old_img, 2048);
+	new_img[10] ^= 0x5A;
+	new_img[2000] += 3;
+	fill_image(&new_img[2048], 300, 9);
+	memcpy(&new_img[2348], &old_img[2048], 2048);
+
+	size_t n = put_header(patch, DeltaPatcher::MAGIC, sizeof(new_img), sizeof(old_img));
+
+	n += put_control(&patch[n], 2048, 300, 0);
+	for (size_t i = 0; i < 2048; i++) {
+		patch[n++] = (uint8_t)(new_img[i] - old_img[i]);
+	}
+	memcpy(&patch[n], &new_img[2048], 300);
+	n += 300;
+
+	/* Unchanged tail travels as a copy record with no diff bytes */
+	n += put_control(&patch[n], 2048 | DeltaPatcher::COPY_FLAG, 0, 0);
+
+	return n;
+}
+
+static void patcher_before(void* fixture)
+{
+	produced_len = 0;
+}
+
+ZTEST(ota_delta, test_patch_in_fragments)
+{
+	DeltaPatcher patcher;
+	size_t len = build_patch();
+
+	patcher.begin(mem_source, mem_sink, nullptr);
+
+	/* Odd fragment size splits header and control records across feeds */
+	for (size_t off = 0; off < len; off += 7) {
+		zassert_ok(patcher.feed(&patch[off], MIN((size_t)7, len - off)));
+	}
+
+	zassert_true(patcher.isComplete());
+	zassert_equal(patcher.getNewSize(), sizeof(new_img));
+	zassert_equal(produced_len, sizeof(new_img));
+	zassert_mem_equal(produced, new_img, sizeof(new_img));
+}
+
+ZTEST(ota_delta, test_bad_magic)
+{
+	DeltaPatcher patcher;
+	uint8_t hdr[DeltaPatcher::HEADER_SIZE];
+
+	put_header(hdr, 0xDEADBEEF, 16, 16);
+	patcher.begin(mem_source, mem_sink, nullptr);
+	zassert_equal(patcher.feed(hdr, sizeof(hdr)), -EBADMSG);
+	zassert_false(patcher.isComplete());
+}
+
+ZTEST(ota_delta, test_overrun_rejected)
+{
+	DeltaPatcher patcher;
+	uint8_t buf[DeltaPatcher::HEADER_SIZE + DeltaPatcher::CONTROL_SIZE];
+
+	size_t n = put_header(buf, DeltaPatcher::MAGIC, 100, 100);
+	put_control(&buf[n], 80, 40, 0);
+
+	patcher.begin(mem_source, mem_sink, nullptr);
+	zassert_equal(patcher.feed(buf, sizeof(buf)), -EBADMSG);
+	zassert_equal(produced_len, 0);
+}
+
+ZTEST_SUITE(ota_writer, NULL, NULL, NULL, NULL, NULL);
+ZTEST_SUITE(ota_delta, NULL, NULL, patcher_before, NULL, NULL);
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file OtaManager against a local HTTP server
+ *
+ * The whole download path: sockets over the loopback interface, Zephyr's
+ * HTTP client, the body streamed into slot1_partition, the digest check
+ * and the MCUboot upgrade request. Covers a plain download, a dropped
+ * transfer resumed with a Range request, a server that ignores Range, and
+ * a missing image that is not retried.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/storage/flash_map.h>
+#include <mbedtls/sha256.h>
+#include <string.h>
+
+#include "ota/ota_manager.hpp"
+#include "http_server.h"
+
+using namespace smarthome::services::ota;
+
+#define SLOT_ID   FIXED_PARTITION_ID(slot1_partition)
+#define BODY_SIZE (24 * 1024 + 13)
+
+/* Cut well inside the body, past the first checkpoint interval */
+#define DROP_AFTER 5000
+
+static uint8_t body[BODY_SIZE];
+static uint8_t readback[BODY_SIZE];
+
+static struct k_sem done_sem;
+static OtaState final_state;
+
+static void on_progress(OtaState state, uint32_t done, uint32_t total)
+{
+	if (state == OtaState::READY || state == OtaState::ERROR) {
+		final_state = state;
+		k_sem_give(&done_sem);
+	}
+}
+
+static OtaRequest request(void)
+{
+	OtaRequest req = {};
+
+	strcpy(req.host, "127.0.0.1");
+	req.port = HTTP_SERVER_PORT;
+	strcpy(req.path, "/fw/app_update.bin");
+	req.body_size = sizeof(body);
+	mbedtls_sha256(body, sizeof(body), req.sha256, 0);
+	return req;
+}
+
+/* Start an update and wait for READY or ERROR */
+static OtaState run_update(void)
+{
+	zassert_ok(OtaManager::getInstance().start(request()));
+	zassert_ok(k_sem_take(&done_sem, K_SECONDS(30)), "update never ended");
+	return final_state;
+}
+
+static void verify_slot(void)
+{
+	const struct flash_area *fa;
+
+	zassert_ok(flash_area_open(SLOT_ID, &fa));
+	zassert_ok(flash_area_read(fa, 0, readback, sizeof(readback)));
+	flash_area_close(fa);
+	zassert_mem_equal(readback, body, sizeof(body), "slot content differs");
+}
+
+static void *manager_setup(void)
+{
+	uint32_t seed = 11;
+
+	for (size_t i = 0; i < sizeof(body); i++) {
+		seed = seed * 1103515245U + 12345U;
+		body[i] = (uint8_t)(seed >> 16);
+	}
+
+	zassert_ok(settings_subsys_init());
+	k_sem_init(&done_sem, 0, 1);
+
+	http_server_set_body(body, sizeof(body));
+	http_server_start();
+
+	zassert_ok(OtaManager::getInstance().init());
+	OtaManager::getInstance().setProgressCallback(on_progress);
+	return NULL;
+}
+
+static void manager_before(void *fixture)
+{
+	struct http_script script = {};
+
+	http_server_script(&script);
+	k_sem_reset(&done_sem);
+}
+
+ZTEST(ota_manager, test_download)
+{
+	OtaManager::Statistics before = OtaManager::getInstance().getStats();
+
+	zassert_equal(run_update(), OtaState::READY);
+	verify_slot();
+
+	const OtaManager::Statistics &stats = OtaManager::getInstance().getStats();
+
+	zassert_equal(http_server_requests(), 1);
+	zassert_equal(stats.http_requests - before.http_requests, 1);
+	zassert_equal(stats.resumes - before.resumes, 0);
+	zassert_equal(stats.bytes_received - before.bytes_received, sizeof(body));
+}
+
+ZTEST(ota_manager, test_resume_after_drop)
+{
+	struct http_script script = {};
+	OtaManager::Statistics before = OtaManager::getInstance().getStats();
+
+	/* Closed mid-body: asked again from where it stopped */
+	script.drop_after = DROP_AFTER;
+	http_server_script(&script);
+	zassert_equal(run_update(), OtaState::READY);
+	verify_slot();
+
+	const OtaManager::Statistics &stats = OtaManager::getInstance().getStats();
+
+	zassert_equal(http_server_requests(), 2);
+	zassert_equal(http_server_last_range(), DROP_AFTER);
+	zassert_equal(stats.resumes - before.resumes, 1);
+	zassert_equal(stats.bytes_received - before.bytes_received, sizeof(body),
+		      "nothing received twice");
+}
+
+ZTEST(ota_manager, test_server_ignores_range)
+{
+	struct http_script script = {};
+
+	/* 200 with the whole body again: the received prefix is skipped */
+	script.drop_after = DROP_AFTER;
+	script.ignore_range = true;
+	http_server_script(&script);
+	zassert_equal(run_update(), OtaState::READY);
+	verify_slot();
+	zassert_equal(http_server_requests(), 2);
+	zassert_equal(http_server_last_range(), DROP_AFTER);
+}
+
+ZTEST(ota_manager, test_not_found)
+{
+	struct http_script script = {};
+
+	/* Not worth retrying */
+	script.not_found = true;
+	http_server_script(&script);
+	zassert_equal(run_update(), OtaState::ERROR);
+	zassert_equal(http_server_requests(), 1);
+}
+
+ZTEST_SUITE(ota_manager, NULL, manager_setup, manager_before, NULL, NULL);
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Checkpoint ring tests
+ *
+ * Exercises CheckpointRing against the native_sim flash simulator
+ * (storage_partition): restore after re-open, page erase spreading over a
+ * full wrap, and recovery from a torn slot write.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/drivers/flash.h>
+#include <string.h>
+
+#include "persist/checkpoint_ring.hpp"
+
+using namespace smarthome::services::persist;
+
+#define AREA_ID FIXED_PARTITION_ID(storage_partition)
+
+struct TestRecord {
+	uint32_t counter;
+	uint32_t uptime;
+	uint16_t disconnects;
+	uint16_t pad;
+	uint32_t downtime;
+};
+
+static const struct flash_area* fa;
+static size_t page_size;
+static size_t slot_size;
+
+static TestRecord make_record(uint32_t n)
+{
+	TestRecord rec = {};
+
+	rec.counter = n;
+	rec.uptime = n * 1800;
+	rec.disconnects = (uint16_t)(n / 3);
+	rec.downtime = n * 7;
+	return rec;
+}
+
+static void ring_before(void* fixture)
+{
+	struct flash_pages_info page;
+
+	zassert_ok(flash_area_open(AREA_ID, &fa));
+	zassert_ok(flash_get_page_info_by_offs(flash_area_get_device(fa), fa->fa_off, &page));
+	page_size = page.size;
+	slot_size = ROUND_UP(CheckpointRing::HEADER_SIZE + sizeof(TestRecord),
+			     MAX(flash_area_align(fa), 1U));
+
+	zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+}
+
+static void ring_after(void* fixture)
+{
+	flash_area_close(fa);
+}
+
+ZTEST(checkpoint_ring, test_empty_area)
+{
+	CheckpointRing ring;
+	TestRecord rec;
+
+	zassert_ok(ring.init(AREA_ID, sizeof(rec)));
+	zassert_equal(ring.load(&rec, sizeof(rec)), -ENOENT);
+	zassert_equal(ring.getSlotCount(), (fa->fa_size / page_size) * (page_size / slot_size));
+}
+
+ZTEST(checkpoint_ring, test_restore_latest)
+{
+	TestRecord rec;
+
+	{
+		CheckpointRing ring;
+
+		zassert_ok(ring.init(AREA_ID, sizeof(rec)));
+		for (uint32_t n = 1; n <= 5; n++) {
+			rec = make_record(n);
+			zassert_ok(ring.save(&rec, sizeof(rec)));
+		}
+		zassert_equal(ring.getSequence(), 5);
+	}
+
+	/* Fresh instance, as after a reboot */
+	CheckpointRing ring;
+	TestRecord expected = make_record(5);
+
+	zassert_ok(ring.init(AREA_ID, sizeof(rec)));
+	zassert_equal(ring.getSequence(), 5);
+	zassert_ok(ring.load(&rec, sizeof(rec)));
+	zassert_mem_equal(&rec, &expected, sizeof(rec));
+
+	/* The next save continues after the restored slot */
+	rec = make_record(6);
+	zassert_ok(ring.save(&rec, sizeof(rec)));
+	zassert_equal(ring.getSequence(), 6);
+}
+
+ZTEST(checkpoint_ring, test_wrap_spreads_erases)
+{
+	CheckpointRing ring;
+	TestRecord rec;
+	uint32_t pages = fa->fa_size / page_size;
+
+	zassert_ok(ring.init(AREA_ID, sizeof(rec)));
+
+	uint32_t saves = 3U * ring.getSlotCount() + 1U;
+
+	for (uint32_t n = 1; n <= saves; n++) {
+		rec = make_record(n);
+		zassert_ok(ring.save(&rec, sizeof(rec)));
+	}
+
+	/* One erase per page entry: every page erased 3 times, then page 0 again */
+	zassert_equal(ring.getPageErases(), 3U * pages + 1U);
+
+	CheckpointRing reopened;
+	TestRecord expected = make_record(saves);
+
+	zassert_ok(reopened.init(AREA_ID, sizeof(rec)));
+	zassert_ok(reopened.load(&rec, sizeof(rec)));
+	zassert_mem_equal(&rec, &expected, sizeof(rec));
+}
+
+ZTEST(checkpoint_ring, test_torn_write_skipped)
+{
+	CheckpointRing ring;
+	TestRecord rec;
+	uint8_t garbage[CheckpointRing::MAX_SLOT_SIZE];
+
+	zassert_ok(ring.init(AREA_ID, sizeof(rec)));
+	for (uint32_t n = 1; n <= 2; n++) {
+		rec = make_record(n);
+		zassert_ok(ring.save(&rec, sizeof(rec)));
+	}
+
+	/* Reset mid-write of the third slot: magic present, CRC wrong */
+	memset(garbage, 0x5A, sizeof(garbage));
+	memcpy(garbage, &CheckpointRing::MAGIC, sizeof(CheckpointRing::MAGIC));
+	zassert_ok(flash_area_write(fa, 2 * slot_size, garbage, slot_size));
+
+	CheckpointRing reopened;
+	TestRecord expected = make_record(2);
+
+	zassert_ok(reopened.init(AREA_ID, sizeof(rec)));
+	zassert_ok(reopened.load(&rec, sizeof(rec)));
+	zassert_mem_equal(&rec, &expected, sizeof(rec));
+
+	/* The dirty slot is not written over: the save moves to the next page */
+	rec = make_record(3);
+	zassert_ok(reopened.save(&rec, sizeof(rec)));
+	zassert_equal(reopened.getPageErases(), 1);
+
+	CheckpointRing again;
+
+	expected = make_record(3);
+	zassert_ok(again.init(AREA_ID, sizeof(rec)));
+	zassert_ok(again.load(&rec, sizeof(rec)));
+	zassert_mem_equal(&rec, &expected, sizeof(rec));
+}
+
+ZTEST(checkpoint_ring, test_record_size_checked)
+{
+	CheckpointRing ring;
+	TestRecord rec = make_record(1);
+	uint8_t big[CheckpointRing::MAX_RECORD_SIZE + 1] = {};
+
+	zassert_equal(ring.init(AREA_ID, sizeof(big)), -EINVAL);
+
+	zassert_ok(ring.init(AREA_ID, sizeof(rec)));
+	zassert_ok(ring.save(&rec, sizeof(rec)));
+	zassert_equal(ring.save(&rec, sizeof(rec) - 1), -EMSGSIZE);
+
+	/* A record saved with another layout is not handed back */
+	CheckpointRing other;
+	uint32_t small;
+
+	zassert_ok(other.init(AREA_ID, sizeof(small)));
+	zassert_equal(other.load(&small, sizeof(small)), -ENOENT);
+}
+
+ZTEST_SUITE(checkpoint_ring, NULL, NULL, ring_before, ring_after, NULL);
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Wakeup and current harness
+ *
+ * The real NetCoreManager and both IPCCore instances, linked by the
+ * loopback transport as in tests/sdk/dualcore, with the
+ * NetworkResilienceManager health timer on the TimerService wheel. The
+ * power mode is switched as AppTask::updateNetPowerMode() does, and real
+ * idle-thread entries are counted through the tracing hook, together with
+ * the switches into the IPC RX threads and the NET worker. native_sim
+ * has no 802.15.4 radio, so data polls come from a PollScheduler-driven
+ * timer standing in for the sleepy OpenThread stack:
+ *
+ *   active    - ACTIVE mode, link heartbeat on, receiver always on
+ *   sed_idle  - LOW_POWER mode, slow data polls only
+ *   sed_burst - sed_idle with a command's fast-poll burst in the window
+ *
+ * Each scenario sets its own mode and prints one line for scripts:
+ *   POWER scenario=<name> window_ms=.. wakeups=.. wakeups_per_s=.. polls=.. current_ua=..
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+
+#include "ipc_core.hpp"
+#include "ipc_loopback.hpp"
+#include "net_core.hpp"
+#include "thread/network_resilience_manager.hpp"
+#include "thread/poll_scheduler.hpp"
+#include "power/power_meter.hpp"
+
+using namespace smarthome::ipc;
+using namespace smarthome::services::power;
+using smarthome::protocol::thread::NetworkResilienceManager;
+using smarthome::protocol::thread::PollScheduler;
+
+#define WINDOW_MS 60000
+#define SLOW_POLL_MS 5000
+#define FAST_POLL_MS 200
+#define BURST_AT_MS 10000
+#define BURST_MS 3000
+#define SETTLE_MS 100
+
+static LoopbackTransport app_end;
+static LoopbackTransport net_end;
+
+/* NET core context: a work queue whose thread is tagged Core::NET */
+static K_THREAD_STACK_DEFINE(net_stack, 4096);
+static struct k_work_q net_q;
+static struct k_work net_work;
+static struct k_sem net_done;
+static void (*net_fn)(void);
+
+static int net_init_ret;
+
+static struct k_timer poll_timer;
+static struct k_timer burst_timer;
+static PollScheduler poll;
+
+/* Switches into the threads the power mode is meant to quiet */
+static atomic_t ipc_rx_wakeups;
+static atomic_t worker_wakeups;
+
+extern "C" void sys_trace_thread_switched_in_user(void)
+{
+	const char *name = k_thread_name_get(k_current_get());
+
+	if (name == NULL) {
+		return;
+	}
+	if (strcmp(name, "ipc_rx") == 0) {
+		atomic_inc(&ipc_rx_wakeups);
+	} else if (strcmp(name, "net_core_worker") == 0) {
+		atomic_inc(&worker_wakeups);
+	}
+}
+
+static void net_work_handler(struct k_work *work)
+{
+	net_fn();
+	k_sem_give(&net_done);
+}
+
+static void net_submit(void (*fn)(void))
+{
+	net_fn = fn;
+	k_work_submit_to_queue(&net_q, &net_work);
+}
+
+static void net_bind(void)
+{
+	IPCCore::bindThread(Core::NET);
+}
+
+static void net_boot(void)
+{
+	net_init_ret = net::NetCoreManager::getInstance().init();
+}
+
+/* AppTask::updateNetPowerMode() */
+static void set_power_mode(PowerMode mode)
+{
+	IPCCore &app = IPCCore::getInstance();
+	bool low_power = (mode == PowerMode::LOW_POWER);
+
+	zassert_ok(app.setHeartbeat(low_power ? 0 : IPCCore::HEARTBEAT_IDLE_MS,
+				    low_power ? 0 : IPCCore::LINK_TIMEOUT_MS));
+	zassert_ok(app.send(MessageBuilder(MessageType::POWER_MODE)
+				    .setParam(0, (uint32_t)mode).build()));
+	k_sleep(K_MSEC(SETTLE_MS));
+	zassert_equal(IPCCore::getInstance(Core::NET).linkHas(IPC_CAP_HEARTBEAT), !low_power);
+}
+
+/*=============================================================================
+ * Radio
+ *===========================================================================*/
+
+static void poll_expiry(struct k_timer *timer)
+{
+	PowerMeter::getInstance().recordPoll();
+}
+
+static void restart_polls(void)
+{
+	k_timeout_t period = K_MSEC(poll.getPeriodMs());
+
+	k_timer_start(&poll_timer, period, period);
+}
+
+static void burst_expiry(struct k_timer *timer)
+{
+	if (poll.update(k_uptime_get_32())) {
+		restart_polls();
+	}
+}
+
+static void start_window(void)
+{
+	PowerMeter::getInstance().start();
+	atomic_clear(&ipc_rx_wakeups);
+	atomic_clear(&worker_wakeups);
+}
+
+static void report(const char *scenario, PowerSample &s, bool rx_on_when_idle)
+{
+	PowerMeter::getInstance().sample(s, NRF5340_PROFILE, rx_on_when_idle);
+
+	TC_PRINT("POWER scenario=%s window_ms=%u wakeups=%u wakeups_per_s=%u.%u "
+		 "polls=%u current_ua=%u.%u ipc_rx=%u worker=%u\n",
+		 scenario, s.window_ms, s.wakeups, s.wakeups_per_s_x10 / 10,
+		 s.wakeups_per_s_x10 % 10, s.polls, s.current_na / 1000,
+		 (s.current_na % 1000) / 100, (uint32_t)atomic_get(&ipc_rx_wakeups),
+		 (uint32_t)atomic_get(&worker_wakeups));
+}
+
+/*=============================================================================
+ * Scenarios
+ *===========================================================================*/
+
+static void *power_setup(void)
+{
+	IPCCore &app = IPCCore::getInstance(Core::APP);
+	IPCCore &net_ipc = IPCCore::getInstance(Core::NET);
+
+	k_sem_init(&net_done, 0, 1);
+	k_work_init(&net_work, net_work_handler);
+	k_work_queue_start(&net_q, net_stack, K_THREAD_STACK_SIZEOF(net_stack),
+			   K_PRIO_PREEMPT(1), NULL);
+	net_submit(net_bind);
+	zassert_ok(k_sem_take(&net_done, K_SECONDS(1)));
+
+	LoopbackTransport::connect(app_end, net_end);
+	zassert_ok(app.setTransport(app_end));
+	zassert_ok(net_ipc.setTransport(net_end));
+
+	/* NET boots and waits for the link while the APP core brings it up */
+	net_submit(net_boot);
+	zassert_ok(app.init());
+	zassert_ok(k_sem_take(&net_done, K_SECONDS(1)));
+	zassert_ok(net_init_ret);
+
+	zassert_ok(NetworkResilienceManager::getInstance().init());
+
+	k_timer_init(&poll_timer, poll_expiry, NULL);
+	k_timer_init(&burst_timer, burst_expiry, NULL);
+	return NULL;
+}
+
+static void power_before(void *fixture)
+{
+	PollScheduler::Config config = {
+		.slow_period_ms = SLOW_POLL_MS,
+		.fast_period_ms = FAST_POLL_MS,
+		.max_burst_ms = 60000,
+	};
+
+	poll.init(config);
+}
+
+static void power_after(void *fixture)
+{
+	k_timer_stop(&poll_timer);
+	k_timer_stop(&burst_timer);
+}
+
+ZTEST(power, test_active)
+{
+	PowerSample s;
+
+	set_power_mode(PowerMode::ACTIVE);
+
+	start_window();
+	k_sleep(K_MSEC(WINDOW_MS));
+	report("active", s, true);
+
+	/* Both RX threads check the link twice per heartbeat period */
+	zassert_true(atomic_get(&ipc_rx_wakeups) >= 2 * WINDOW_MS / IPCCore::HEARTBEAT_IDLE_MS,
+		     "%u", (uint32_t)atomic_get(&ipc_rx_wakeups));
+	zassert_true(s.wakeups_per_s_x10 >= 40, "%u", s.wakeups_per_s_x10);
+	zassert_true(s.current_na > NRF5340_PROFILE.rx_idle_na);
+}
+
+ZTEST(power, test_sed_idle)
+{
+	PowerSample s;
+
+	set_power_mode(PowerMode::LOW_POWER);
+	restart_polls();
+
+	start_window();
+	k_sleep(K_MSEC(WINDOW_MS));
+	report("sed_idle", s, false);
+
+	/* Only the health timer and the data polls are left */
+	zassert_equal(atomic_get(&ipc_rx_wakeups), 0);
+	zassert_equal(atomic_get(&worker_wakeups), 0);
+	zassert_within(s.polls, WINDOW_MS / SLOW_POLL_MS, 1);
+	zassert_true(s.wakeups_per_s_x10 <= 5, "%u", s.wakeups_per_s_x10);
+	zassert_true(s.current_na < 10000, "%u nA", s.current_na);
+}
+
+ZTEST(power, test_sed_burst)
+{
+	PowerSample s;
+
+	set_power_mode(PowerMode::LOW_POWER);
+	restart_polls();
+
+	start_window();
+	k_sleep(K_MSEC(BURST_AT_MS));
+
+	/* A command: poll fast until the reply window has passed */
+	uint32_t now = k_uptime_get_32();
+	zassert_true(poll.requestFastPoll(BURST_MS, now));
+	restart_polls();
+	k_timer_start(&burst_timer, K_MSEC(poll.getRemainingMs(now)), K_NO_WAIT);
+
+	k_sleep(K_MSEC(WINDOW_MS - BURST_AT_MS));
+	report("sed_burst", s, false);
+
+	zassert_false(poll.isFastPolling());
+	zassert_within(s.polls, WINDOW_MS / SLOW_POLL_MS + BURST_MS / FAST_POLL_MS, 2,
+		       "%u polls", s.polls);
+
+	/* The same window with slow polls only */
+	uint32_t idle_na = estimateCurrentNa(NRF5340_PROFILE, s.wakeups, WINDOW_MS / SLOW_POLL_MS,
+					     s.window_ms, false);
+	zassert_true(s.current_na > idle_na, "%u vs %u nA", s.current_na, idle_na);
+}
+
+ZTEST_SUITE(power, NULL, power_setup, power_before, power_after, NULL);
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Retry scheduler tests
+ *
+ * Backoff arithmetic and jitter windows, attempt budget and reset, plus a
+ * reconnect storm: 100 virtual devices lose the network at the same moment
+ * and retry against a parent that admits SLOT_CAPACITY attaches per
+ * SLOT_MS. Run once in lockstep (no jitter) and once with full jitter and
+ * compare the peak attempt rate and how many devices get back on.
+ */
+
+#include <zephyr/ztest.h>
+
+#include "retry/retry_scheduler.hpp"
+
+using namespace smarthome::services::retry;
+
+/*=============================================================================
+ * Backoff
+ *===========================================================================*/
+
+ZTEST(retry_scheduler, test_backoff_ceiling)
+{
+	/* 1 s, x1.5 as in chip_config, capped at 60 s */
+	const RetryPolicy policy = { 1000, 60000, 384, 15, false };
+	static const uint32_t expected[] = {
+		1000, 1500, 2250, 3375, 5062, 7593, 11389,
+		17083, 25624, 38436, 57654, 60000, 60000
+	};
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(expected); i++) {
+		zassert_equal(RetryScheduler::backoffCeilingMs(policy, i + 1), expected[i],
+			      "attempt %u", i + 1);
+	}
+}
+
+ZTEST(retry_scheduler, test_full_jitter_bounds)
+{
+	const RetryPolicy policy = { 8, 64, 512, 0, true };
+	static RetryScheduler retry;
+
+	retry.init(policy, nullptr, nullptr);
+
+	for (uint8_t attempt = 1; attempt <= 8; attempt++) {
+		uint32_t ceiling = RetryScheduler::backoffCeilingMs(policy, attempt);
+
+		zassert_ok(retry.schedule());
+		zassert_equal(retry.getAttempts(), attempt);
+		zassert_true(retry.getLastDelayMs() <= ceiling, "attempt %u", attempt);
+		zassert_equal(retry.schedule(), -EALREADY);
+
+		/* Let it fire before arming the next attempt */
+		k_sleep(K_MSEC(ceiling + 2));
+	}
+
+	retry.reset();
+}
+
+ZTEST(retry_scheduler, test_equal_jitter_bounds)
+{
+	const RetryPolicy policy = { 8, 64, 512, 0, true, true };
+	static RetryScheduler retry;
+
+	retry.init(policy, nullptr, nullptr);
+
+	for (uint8_t attempt = 1; attempt <= 8; attempt++) {
+		uint32_t ceiling = RetryScheduler::backoffCeilingMs(policy, attempt);
+
+		/* Never before half the ceiling */
+		zassert_ok(retry.schedule());
+		zassert_true(retry.getLastDelayMs() >= ceiling / 2, "attempt %u", attempt);
+		zassert_true(retry.getLastDelayMs() <= ceiling, "attempt %u", attempt);
+
+		k_sleep(K_MSEC(ceiling + 2));
+	}
+
+	retry.reset();
+}
+
+/*=============================================================================
+ * Attempt budget and reset
+ *===========================================================================*/
+
+K_SEM_DEFINE(budget_done, 0, 1);
+static uint8_t budget_calls;
+
+static void budget_handler(RetryScheduler& scheduler, void* user_data)
+{
+	budget_calls++;
+	if (scheduler.schedule() == -ETIMEDOUT) {
+		k_sem_give(&budget_done);
+	}
+}
+
+ZTEST(retry_scheduler, test_max_attempts)
+{
+	const RetryPolicy policy = { 5, 20, 512, 3, false };
+	static RetryScheduler retry;
+
+	budget_calls = 0;
+	retry.init(policy, budget_handler, nullptr);
+
+	zassert_ok(retry.schedule());
+	zassert_ok(k_sem_take(&budget_done, K_SECONDS(1)));
+	zassert_equal(budget_calls, 3);
+	zassert_equal(retry.schedule(), -ETIMEDOUT);
+
+	/* Success clears the budget */
+	retry.reset();
+	zassert_equal(retry.getAttempts(), 0);
+	zassert_ok(retry.schedule());
+	retry.reset();
+}
+
+static void never_handler(RetryScheduler& scheduler, void* user_data)
+{
+	ztest_test_fail();
+}
+
+ZTEST(retry_scheduler, test_reset_cancels_pending)
+{
+	const RetryPolicy policy = { 50, 50, 256, 0, false };
+	static RetryScheduler retry;
+
+	retry.init(policy, never_handler, nullptr);
+	zassert_ok(retry.schedule());
+	zassert_true(retry.isPending());
+
+	retry.reset();
+	zassert_false(retry.isPending());
+	k_sleep(K_MSEC(100));
+}
+
+/*=============================================================================
+ * Reconnect storm
+ *===========================================================================*/
+
+#define N_DEVICES     100
+#define SLOT_MS       20
+#define SLOT_CAPACITY 2
+
+struct StormStats {
+	uint32_t start_ms;
+	uint32_t slot;
+	uint32_t slot_attempts;
+	uint32_t peak;
+	uint32_t attempts;
+	uint32_t joined;
+	uint32_t exhausted;
+	uint32_t last_join_ms;
+};
+
+static RetryScheduler devices[N_DEVICES];
+static StormStats storm;
+K_SEM_DEFINE(storm_done, 0, N_DEVICES);
+static uint32_t lcg_state;
+
+static uint32_t lcg_rand(void)
+{
+	lcg_state = lcg_state * 1103515245U + 12345U;
+	return lcg_state;
+}
+
+/* Work queue context; handlers run one at a time in expiry order */
+static void device_attempt(RetryScheduler& scheduler, void* user_data)
+{
+	uint32_t now = k_uptime_get_32() - storm.start_ms;
+	uint32_t slot = now / SLOT_MS;
+
+	if (slot != storm.slot) {
+		storm.slot = slot;
+		storm.slot_attempts = 0;
+	}
+	storm.slot_attempts++;
+	storm.attempts++;
+	storm.peak = MAX(storm.peak, storm.slot_attempts);
+
+	if (storm.slot_attempts <= SLOT_CAPACITY) {
+		/* Parent admitted us */
+		storm.joined++;
+		storm.last_join_ms = now;
+		scheduler.reset();
+		k_sem_give(&storm_done);
+		return;
+	}
+
+	if (scheduler.schedule() == -ETIMEDOUT) {
+		storm.exhausted++;
+		k_sem_give(&storm_done);
+	}
+}
+
+static void run_storm(bool jitter)
+{
+	const RetryPolicy policy = { 100, 3200, 512, 15, jitter };
+
+	memset(&storm, 0, sizeof(storm));
+	k_sem_reset(&storm_done);
+	lcg_state = 1;
+
+	for (int i = 0; i < N_DEVICES; i++) {
+		devices[i].init(policy, device_attempt, nullptr);
+		devices[i].setRandomSource(lcg_rand);
+	}
+
+	/* Power restored: everyone notices the lost parent at once */
+	storm.start_ms = k_uptime_get_32();
+	for (int i = 0; i < N_DEVICES; i++) {
+		zassert_ok(devices[i].schedule());
+	}
+
+	for (int i = 0; i < N_DEVICES; i++) {
+		zassert_ok(k_sem_take(&storm_done, K_SECONDS(120)));
+	}
+
+	TC_PRINT("storm %-8s peak %3u/slot attempts %4u joined %3u exhausted %3u last join %u ms\n",
+		 jitter ? "jitter" : "lockstep", storm.peak, storm.attempts,
+		 storm.joined, storm.exhausted, storm.last_join_ms);
+}
+
+ZTEST(retry_scheduler, test_reconnect_storm)
+{
+	run_storm(false);
+	StormStats lockstep = storm;
+
+	run_storm(true);
+	StormStats jittered = storm;
+
+	/* Lockstep: every device hits the parent in the same slot */
+	zassert_equal(lockstep.peak, N_DEVICES);
+
+	/* Jitter spreads the load: everyone back on, with fewer attempts */
+	zassert_equal(jittered.joined, N_DEVICES);
+	zassert_equal(jittered.exhausted, 0);
+	zassert_true(jittered.peak * 2 < lockstep.peak);
+	zassert_true(jittered.attempts < lockstep.attempts);
+}
+
+ZTEST_SUITE(retry_scheduler, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Thread attach with the OpenThread stack
+ *
+ * Built with openthread.conf: the manager configures the stack from the
+ * build defaults, enables Thread and follows the role changes reported by
+ * OpenThread. A lone FTD hears no parent, forms its own partition and
+ * becomes leader, which is as far as attach goes without a second node.
+ * Detached on a live network, it reattaches on its own within seconds and
+ * the backup rejoin must not restart it meanwhile. Made router-ineligible,
+ * the same node can never attach, which drives the rejoin backoff through
+ * its whole attempt budget.
+ */
+
+#include <zephyr/ztest.h>
+#include <openthread/thread.h>
+
+#include "thread/thread_network_manager.hpp"
+#include "matter/commission/chip_config.hpp"
+
+using namespace smarthome::protocol::thread;
+using smarthome::protocol::matter::INITIAL_RECONNECT_DELAY_MS;
+using smarthome::protocol::matter::MAX_RECONNECT_ATTEMPTS;
+
+/* MLE parent requests and the leader election, with margin */
+#define ATTACH_TIMEOUT K_SECONDS(60)
+
+/* Sum of the backoff ceilings for MAX_RECONNECT_ATTEMPTS (~815 s), with margin */
+#define REJOIN_TIMEOUT K_SECONDS(900)
+
+/* OpenThread's own reattach of a lone FTD: parent requests, then leader */
+#define REATTACH_TIMEOUT_MS 5000
+
+K_SEM_DEFINE(attached_sem, 0, 1);
+K_SEM_DEFINE(error_sem, 0, 1);
+
+static ThreadState states[8];
+static int state_count;
+static int idle_count;
+
+static void on_state(ThreadState state)
+{
+	if (state_count < (int)ARRAY_SIZE(states)) {
+		states[state_count] = state;
+	}
+	state_count++;
+	if (state == ThreadState::IDLE) {
+		idle_count++;
+	}
+
+	if (state == ThreadState::CHILD || state == ThreadState::ROUTER ||
+	    state == ThreadState::LEADER) {
+		k_sem_give(&attached_sem);
+	} else if (state == ThreadState::ERROR) {
+		k_sem_give(&error_sem);
+	}
+}
+
+static void *attach_setup(void)
+{
+	auto& mgr = ThreadNetworkManager::getInstance();
+
+	mgr.setStateCallback(on_state);
+	zassert_ok(mgr.init());
+	return NULL;
+}
+
+ZTEST(thread_attach, test_init_leaves_stack_disabled)
+{
+	/* OPENTHREAD_MANUAL_START: nothing runs before the join */
+	zassert_equal(ThreadNetworkManager::getInstance().getState(), ThreadState::IDLE);
+	zassert_equal(otThreadGetDeviceRole(openthread_get_default_instance()),
+		      OT_DEVICE_ROLE_DISABLED);
+}
+
+ZTEST(thread_attach, test_join_attaches)
+{
+	auto& mgr = ThreadNetworkManager::getInstance();
+	int first = state_count;
+
+	zassert_ok(mgr.startNetworkJoin());
+	zassert_ok(k_sem_take(&attached_sem, ATTACH_TIMEOUT), "never attached");
+
+	zassert_true(mgr.isAttached());
+	zassert_equal(mgr.getState(), ThreadState::LEADER, "no other node to attach to");
+	zassert_equal(states[first], ThreadState::JOINING, "join not reported first");
+
+	/* The role the manager reports is the one the stack holds */
+	openthread_mutex_lock();
+	otDeviceRole role = otThreadGetDeviceRole(openthread_get_default_instance());
+	openthread_mutex_unlock();
+	zassert_equal(role, OT_DEVICE_ROLE_LEADER);
+}
+
+ZTEST(thread_attach, test_join_when_attached_is_a_noop)
+{
+	int before = state_count;
+
+	zassert_ok(ThreadNetworkManager::getInstance().startNetworkJoin());
+	zassert_equal(state_count, before, "attached node went back to JOINING");
+}
+
+ZTEST(thread_attach, test_leave_detaches)
+{
+	auto& mgr = ThreadNetworkManager::getInstance();
+
+	zassert_ok(mgr.leaveNetwork());
+	zassert_false(mgr.isAttached());
+
+	openthread_mutex_lock();
+	otDeviceRole role = otThreadGetDeviceRole(openthread_get_default_instance());
+	openthread_mutex_unlock();
+	zassert_equal(role, OT_DEVICE_ROLE_DISABLED);
+}
+
+ZTEST(thread_attach, test_reattach_without_restart)
+{
+	auto& mgr = ThreadNetworkManager::getInstance();
+	otInstance* instance = openthread_get_default_instance();
+
+	k_sem_reset(&attached_sem);
+	zassert_ok(mgr.startNetworkJoin());
+	zassert_ok(k_sem_take(&attached_sem, ATTACH_TIMEOUT), "never attached");
+
+	/* Parent lost: the backup rejoin is armed, OpenThread attaches again */
+	int idle_before = idle_count;
+	uint32_t start = k_uptime_get_32();
+
+	openthread_mutex_lock();
+	zassert_equal(otThreadBecomeDetached(instance), OT_ERROR_NONE);
+	openthread_mutex_unlock();
+
+	zassert_ok(k_sem_take(&attached_sem, K_MSEC(REATTACH_TIMEOUT_MS)), "no reattach");
+	TC_PRINT("reattached in %u ms\n", k_uptime_get_32() - start);
+
+	/* A restart passes through a disabled stack */
+	zassert_equal(idle_count, idle_before, "Thread restarted during the attach");
+	zassert_equal(mgr.getRejoinAttempts(), 0, "backoff not reset by the attach");
+	zassert_true(k_uptime_get_32() - start < INITIAL_RECONNECT_DELAY_MS / 2,
+		     "reattach as slow as the first rejoin");
+
+	zassert_ok(mgr.leaveNetwork());
+}
+
+ZTEST(thread_attach, test_rejoin_chain_runs_to_budget)
+{
+	auto& mgr = ThreadNetworkManager::getInstance();
+	otInstance* instance = openthread_get_default_instance();
+
+	/* A child-only node with no parent in range stays detached */
+	openthread_mutex_lock();
+	zassert_equal(otThreadSetRouterEligible(instance, false), OT_ERROR_NONE);
+	openthread_mutex_unlock();
+
+	/*
+	 * Each attempt restarts Thread, unless the stack is still sending
+	 * parent requests, and arms the next from the handler
+	 */
+	zassert_ok(mgr.scheduleNetworkRejoin());
+	zassert_ok(k_sem_take(&error_sem, REJOIN_TIMEOUT), "rejoin chain stalled at attempt %u",
+		   mgr.getRejoinAttempts());
+	zassert_equal(mgr.getRejoinAttempts(), MAX_RECONNECT_ATTEMPTS);
+	zassert_false(mgr.isAttached());
+
+	zassert_ok(mgr.leaveNetwork());
+	openthread_mutex_lock();
+	otThreadSetRouterEligible(instance, true);
+	openthread_mutex_unlock();
+}
+
+ZTEST_SUITE(thread_attach, NULL, attach_setup, NULL, NULL, NULL);
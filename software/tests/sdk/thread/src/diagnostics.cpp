@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Diagnostics snapshot tests
+ *
+ * Diag record layout, round trip and bounds, and history ring eviction.
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+
+#include "thread/diag_snapshot.hpp"
+
+using namespace smarthome::protocol::thread;
+
+static DiagSnapshot sample_snapshot(uint8_t neighbors, uint8_t routes)
+{
+	DiagSnapshot snap = {};
+
+	snap.uptime_s = 0x01020304;
+	for (uint8_t i = 0; i < sizeof(snap.ext_addr); i++) {
+		snap.ext_addr[i] = 0xA0 + i;
+	}
+	snap.role = 3;                  /* router */
+	snap.channel = 15;
+	snap.rloc16 = 0x4400;
+	snap.parent_rloc16 = 0xFFFF;
+	snap.parent_rssi = -128;
+	snap.partition_id = 0xCAFEF00D;
+	snap.leader_router_id = 17;
+	snap.leader_weight = 64;
+	snap.data_version = 9;
+	snap.stable_data_version = 4;
+	snap.neighbor_count = neighbors;
+	snap.route_count = routes;
+	snap.neighbors_dropped = 2;
+
+	for (uint8_t i = 0; i < neighbors; i++) {
+		snap.neighbors[i].rloc16 = 0x4401 + i;
+		snap.neighbors[i].avg_rssi = -40 - i;
+		snap.neighbors[i].flags = DIAG_NEIGHBOR_CHILD | (3 << DIAG_NEIGHBOR_LQI_SHIFT);
+	}
+	for (uint8_t i = 0; i < routes; i++) {
+		snap.routes[i].router_id = i;
+		snap.routes[i].next_hop = 63;
+		snap.routes[i].path_cost = i + 1;
+		snap.routes[i].link_quality = 0x0E;
+	}
+	return snap;
+}
+
+ZTEST(diagnostics, test_layout)
+{
+	DiagSnapshot snap = sample_snapshot(2, 1);
+	uint8_t buf[DIAG_RECORD_MAX_SIZE];
+
+	int len = encodeDiagRecord(snap, buf, sizeof(buf));
+	zassert_equal(len, (int)(DIAG_RECORD_HEADER_SIZE + 3 * DIAG_RECORD_ENTRY_SIZE));
+
+	zassert_equal(buf[0], DIAG_RECORD_VERSION);
+	zassert_equal(buf[1], 3);
+	zassert_equal(buf[2], 0x00);
+	zassert_equal(buf[3], 0x44);
+	zassert_equal(buf[7], 0x80);
+	zassert_equal(buf[8], 0x0D);
+	zassert_equal(buf[11], 0xCA);
+	zassert_equal(buf[12], 0xA0);
+	zassert_equal(buf[20], 0x04);
+	zassert_equal(buf[24], 17);
+	zassert_equal(buf[28], 2);
+	zassert_equal(buf[29], 1);
+	zassert_equal(buf[30], 2);
+
+	/* First neighbor, then the route after both neighbors */
+	zassert_equal(buf[32], 0x01);
+	zassert_equal(buf[33], 0x44);
+	zassert_equal((int8_t)buf[34], -40);
+	zassert_equal(buf[40], 0);
+	zassert_equal(buf[41], 63);
+	zassert_equal(buf[43], 0x0E);
+}
+
+ZTEST(diagnostics, test_round_trip)
+{
+	DiagSnapshot snap = sample_snapshot(DIAG_MAX_NEIGHBORS, DIAG_MAX_ROUTES);
+	DiagSnapshot out = {};
+	uint8_t buf[DIAG_RECORD_MAX_SIZE];
+
+	int len = encodeDiagRecord(snap, buf, sizeof(buf));
+	zassert_equal(len, (int)DIAG_RECORD_MAX_SIZE);
+	zassert_ok(decodeDiagRecord(buf, len, out));
+
+	zassert_equal(out.uptime_s, snap.uptime_s);
+	zassert_mem_equal(out.ext_addr, snap.ext_addr, sizeof(snap.ext_addr));
+	zassert_equal(out.rloc16, snap.rloc16);
+	zassert_equal(out.parent_rloc16, snap.parent_rloc16);
+	zassert_equal(out.parent_rssi, snap.parent_rssi);
+	zassert_equal(out.partition_id, snap.partition_id);
+	zassert_equal(out.stable_data_version, snap.stable_data_version);
+	zassert_equal(out.neighbor_count, DIAG_MAX_NEIGHBORS);
+	zassert_equal(out.route_count, DIAG_MAX_ROUTES);
+	zassert_equal(out.neighbors_dropped, 2);
+	zassert_mem_equal(out.neighbors, snap.neighbors, sizeof(snap.neighbors));
+	zassert_mem_equal(out.routes, snap.routes, sizeof(snap.routes));
+}
+
+ZTEST(diagnostics, test_bad_buffers)
+{
+	DiagSnapshot snap = sample_snapshot(1, 1);
+	uint8_t buf[DIAG_RECORD_MAX_SIZE];
+
+	zassert_equal(encodeDiagRecord(snap, buf, DIAG_RECORD_HEADER_SIZE + 4), -ENOBUFS);
+
+	int len = encodeDiagRecord(snap, buf, sizeof(buf));
+	zassert_equal(decodeDiagRecord(buf, len - 1, snap), -EINVAL);
+
+	buf[28] = DIAG_MAX_NEIGHBORS + 1;
+	zassert_equal(decodeDiagRecord(buf, sizeof(buf), snap), -EINVAL);
+
+	buf[0] = DIAG_RECORD_VERSION + 1;
+	zassert_equal(decodeDiagRecord(buf, sizeof(buf), snap), -ENOTSUP);
+}
+
+ZTEST(diagnostics, test_history_eviction)
+{
+	static DiagHistory history;
+
+	history.clear();
+	zassert_is_null(history.get(0));
+
+	for (uint32_t i = 1; i <= DiagHistory::DEPTH + 3; i++) {
+		history.next().uptime_s = i;
+		history.commit();
+	}
+
+	zassert_equal(history.size(), DiagHistory::DEPTH);
+	zassert_equal(history.get(0)->uptime_s, DiagHistory::DEPTH + 3);
+	zassert_equal(history.get(DiagHistory::DEPTH - 1)->uptime_s, 4);
+	zassert_is_null(history.get(DiagHistory::DEPTH));
+}
+
+ZTEST_SUITE(diagnostics, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Health record tests
+ *
+ * Binary record layout and round trip, and the integer-only text
+ * renderer writing into caller buffers.
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+
+#include "thread/network_resilience_manager.hpp"
+
+using namespace smarthome::protocol::thread;
+
+static HealthSnapshot sample_snapshot(void)
+{
+	HealthSnapshot snap = {};
+
+	snap.health = NetworkHealth::GOOD;
+	snap.rssi_q4 = -1045;          /* -65.3125 dBm */
+	snap.lqi_q4 = 40;              /* 2.5 */
+	snap.flags = HEALTH_FLAG_LINK_UP | HEALTH_FLAG_SAMPLED;
+	snap.loss_permille = 123;
+	snap.uptime_s = 0x01020304;
+	snap.connected_s = 3600;
+	snap.downtime_s = 42;
+	snap.disconnects = 7;
+	snap.reconnects = 0x0A0B;
+	return snap;
+}
+
+ZTEST(health_record, test_layout)
+{
+	HealthSnapshot snap = sample_snapshot();
+	uint8_t buf[HEALTH_RECORD_SIZE];
+
+	zassert_equal(NetworkResilienceManager::encodeHealthRecord(snap, buf, sizeof(buf)),
+		      (int)HEALTH_RECORD_SIZE);
+
+	zassert_equal(buf[0], HEALTH_RECORD_VERSION);
+	zassert_equal(buf[1], (uint8_t)NetworkHealth::GOOD);
+	zassert_equal(buf[2], 0xEB);    /* -1045 = 0xFBEB */
+	zassert_equal(buf[3], 0xFB);
+	zassert_equal(buf[4], 40);
+	zassert_equal(buf[5], HEALTH_FLAG_LINK_UP | HEALTH_FLAG_SAMPLED);
+	zassert_equal(buf[6], 123);
+	zassert_equal(buf[7], 0);
+	zassert_equal(buf[8], 0x04);
+	zassert_equal(buf[11], 0x01);
+	zassert_equal(buf[22], 0x0B);
+	zassert_equal(buf[23], 0x0A);
+}
+
+ZTEST(health_record, test_round_trip)
+{
+	HealthSnapshot snap = sample_snapshot();
+	HealthSnapshot out = {};
+	uint8_t buf[HEALTH_RECORD_SIZE];
+
+	NetworkResilienceManager::encodeHealthRecord(snap, buf, sizeof(buf));
+	zassert_ok(NetworkResilienceManager::decodeHealthRecord(buf, sizeof(buf), out));
+
+	zassert_equal(out.health, snap.health);
+	zassert_equal(out.rssi_q4, snap.rssi_q4);
+	zassert_equal(out.lqi_q4, snap.lqi_q4);
+	zassert_equal(out.flags, snap.flags);
+	zassert_equal(out.loss_permille, snap.loss_permille);
+	zassert_equal(out.uptime_s, snap.uptime_s);
+	zassert_equal(out.connected_s, snap.connected_s);
+	zassert_equal(out.downtime_s, snap.downtime_s);
+	zassert_equal(out.disconnects, snap.disconnects);
+	zassert_equal(out.reconnects, snap.reconnects);
+}
+
+ZTEST(health_record, test_bad_buffers)
+{
+	HealthSnapshot snap = sample_snapshot();
+	uint8_t buf[HEALTH_RECORD_SIZE];
+
+	zassert_equal(NetworkResilienceManager::encodeHealthRecord(snap, buf, sizeof(buf) - 1),
+		      -ENOBUFS);
+
+	NetworkResilienceManager::encodeHealthRecord(snap, buf, sizeof(buf));
+	zassert_equal(NetworkResilienceManager::decodeHealthRecord(buf, sizeof(buf) - 1, snap),
+		      -EINVAL);
+
+	buf[0] = HEALTH_RECORD_VERSION + 1;
+	zassert_equal(NetworkResilienceManager::decodeHealthRecord(buf, sizeof(buf), snap),
+		      -ENOTSUP);
+}
+
+ZTEST(health_record, test_render)
+{
+	HealthSnapshot snap = sample_snapshot();
+	char line[192];
+
+	int len = NetworkResilienceManager::formatHealthReport(snap, line, sizeof(line));
+
+	zassert_true(len > 0 && len < (int)sizeof(line));
+	zassert_equal(strlen(line), (size_t)len);
+	zassert_not_null(strstr(line, "Health: GOOD"));
+	zassert_not_null(strstr(line, "RSSI: -65.3 dBm"));
+	zassert_not_null(strstr(line, "LQI: 2.5"));
+	zassert_not_null(strstr(line, "Loss: 12.3%"));
+	zassert_not_null(strstr(line, "Reconnects: 2571"));
+
+	snap.flags = 0;
+	NetworkResilienceManager::formatHealthReport(snap, line, sizeof(line));
+	zassert_not_null(strstr(line, "RSSI: n/a"));
+}
+
+ZTEST(health_record, test_render_truncates)
+{
+	HealthSnapshot snap = sample_snapshot();
+	char full[192];
+	char small[16];
+
+	int len = NetworkResilienceManager::formatHealthReport(snap, full, sizeof(full));
+
+	memset(small, 'x', sizeof(small));
+	zassert_equal(NetworkResilienceManager::formatHealthReport(snap, small, sizeof(small)),
+		      len);
+	zassert_equal(small[sizeof(small) - 1], '\0');
+	zassert_mem_equal(small, full, sizeof(small) - 1);
+}
+
+ZTEST_SUITE(health_record, NULL, NULL, NULL, NULL, NULL);
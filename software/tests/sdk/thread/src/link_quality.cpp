@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Link quality estimator tests
+ *
+ * EWMA smoothing, sliding-window packet loss and the hysteresis on
+ * health class changes, fed with synthetic samples.
+ */
+
+#include <zephyr/ztest.h>
+
+#include "thread/link_quality_estimator.hpp"
+#include "thread/network_resilience_manager.hpp"
+
+using namespace smarthome::protocol::thread;
+
+static LinkQualityEstimator est;
+static uint32_t tx_requested;
+static uint32_t tx_acked;
+
+/* Feed enough samples for the EWMA to settle, evaluating each time */
+static NetworkHealth settle(int8_t rssi)
+{
+	NetworkHealth health = NetworkHealth::UNKNOWN;
+
+	for (int i = 0; i < 64; i++) {
+		est.addLinkSample(rssi, 3);
+		health = est.evaluate();
+	}
+	return health;
+}
+
+/* Fill the whole loss window with intervals of 100 frames, `lost` unacked */
+static void fill_loss(uint16_t lost)
+{
+	for (int i = 0; i < LinkQualityEstimator::LOSS_WINDOW; i++) {
+		tx_requested += 100;
+		tx_acked += 100 - lost;
+		est.addCounterSample(tx_requested, tx_acked);
+	}
+}
+
+static void before(void *fixture)
+{
+	est.reset();
+	tx_requested = 0xFFFFFF00; /* wraps during the test */
+	tx_acked = 0xFFFFFF00;
+	est.addCounterSample(tx_requested, tx_acked);
+}
+
+ZTEST(link_quality, test_ewma_smooths_outliers)
+{
+	est.addLinkSample(-60, 3);
+	zassert_equal(est.getRssi(), -60, "first sample seeds the average");
+
+	/* One deep fade moves the average by 1/8 of the step */
+	est.addLinkSample(-100, 0);
+	zassert_equal(est.getRssi(), -65);
+	zassert_equal(est.getLqiQ4(), 42);
+
+	settle(-90);
+	zassert_within(est.getRssi(), -90, 1);
+}
+
+ZTEST(link_quality, test_loss_window)
+{
+	fill_loss(20);
+	zassert_equal(est.getLossPermille(), 200);
+
+	/* Clean intervals push the lossy ones out of the window */
+	for (int i = 0; i < LinkQualityEstimator::LOSS_WINDOW - 1; i++) {
+		tx_requested += 100;
+		tx_acked += 100;
+		est.addCounterSample(tx_requested, tx_acked);
+	}
+	zassert_equal(est.getLossPermille(), 20 * 1000 / 600);
+
+	fill_loss(0);
+	zassert_equal(est.getLossPermille(), 0);
+}
+
+ZTEST(link_quality, test_rssi_hysteresis)
+{
+	zassert_equal(settle(-70), NetworkHealth::GOOD);
+
+	/* Just past the -80 dBm boundary: inside the dead band */
+	zassert_equal(settle(-82), NetworkHealth::GOOD);
+	zassert_equal(settle(-84), NetworkHealth::FAIR);
+
+	/* Back over the boundary, still inside the dead band */
+	zassert_equal(settle(-78), NetworkHealth::FAIR);
+	zassert_equal(settle(-76), NetworkHealth::GOOD);
+}
+
+ZTEST(link_quality, test_loss_downgrade_hysteresis)
+{
+	zassert_equal(settle(-70), NetworkHealth::GOOD);
+
+	fill_loss(15);
+	zassert_equal(est.evaluate(), NetworkHealth::FAIR);
+
+	/* 8% is below the enter level but above the exit level */
+	fill_loss(8);
+	zassert_equal(est.evaluate(), NetworkHealth::FAIR);
+
+	fill_loss(5);
+	zassert_equal(est.evaluate(), NetworkHealth::GOOD);
+}
+
+ZTEST_SUITE(link_quality, NULL, NULL, before, NULL, NULL);
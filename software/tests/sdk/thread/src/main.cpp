@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Thread network manager tests
+ *
+ * Built without CONFIG_OPENTHREAD: covers the role mapping and checks the
+ * manager never reports an attach it did not observe. Attach against the
+ * stack is in attach.cpp (sdk.thread.openthread).
+ */
+
+#include <zephyr/ztest.h>
+
+#include "thread/thread_network_manager.hpp"
+
+using namespace smarthome::protocol::thread;
+
+static ThreadState last_state;
+static int callback_count;
+
+static void on_state(ThreadState state)
+{
+	last_state = state;
+	callback_count++;
+}
+
+static void before(void *fixture)
+{
+	callback_count = 0;
+	last_state = ThreadState::DISABLED;
+}
+
+ZTEST(thread_manager, test_role_mapping)
+{
+	zassert_equal(ThreadNetworkManager::roleToState(0), ThreadState::IDLE);
+	zassert_equal(ThreadNetworkManager::roleToState(1), ThreadState::JOINING);
+	zassert_equal(ThreadNetworkManager::roleToState(2), ThreadState::CHILD);
+	zassert_equal(ThreadNetworkManager::roleToState(3), ThreadState::ROUTER);
+	zassert_equal(ThreadNetworkManager::roleToState(4), ThreadState::LEADER);
+	zassert_equal(ThreadNetworkManager::roleToState(9), ThreadState::ERROR);
+}
+
+ZTEST(thread_manager, test_init_reports_idle)
+{
+	auto& mgr = ThreadNetworkManager::getInstance();
+
+	mgr.setStateCallback(on_state);
+	zassert_equal(mgr.init(), 0);
+	zassert_equal(mgr.getState(), ThreadState::IDLE);
+	zassert_equal(callback_count, 1);
+	zassert_equal(last_state, ThreadState::IDLE);
+}
+
+ZTEST(thread_manager, test_join_without_stack_is_not_attached)
+{
+	auto& mgr = ThreadNetworkManager::getInstance();
+
+	mgr.setStateCallback(on_state);
+	zassert_equal(mgr.startNetworkJoin(), -ENOTSUP);
+	zassert_false(mgr.isAttached());
+	zassert_equal(callback_count, 0, "no state may be invented");
+	zassert_equal(mgr.getLinkQuality(), ThreadNetworkManager::RSSI_NO_LINK);
+	zassert_equal(mgr.getLinkQualityIndicator(), 0);
+}
+
+ZTEST_SUITE(thread_manager, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Parent failover tests
+ *
+ * Policy timing (POOR window, search window, search budget) and a scripted
+ * degradation run through LinkQualityEstimator, checking the device has
+ * moved to another parent before its old link dies.
+ */
+
+#include <zephyr/ztest.h>
+
+#include "thread/link_quality_estimator.hpp"
+#include "thread/network_resilience_manager.hpp"
+#include "thread/parent_failover.hpp"
+#include "matter/commission/chip_config.hpp"
+
+using namespace smarthome::protocol;
+using namespace smarthome::protocol::thread;
+
+#define SAMPLE_MS   (matter::NETWORK_HEALTH_CHECK_INTERVAL_SEC * 1000U)
+#define RX_SENSITIVITY (-100)
+
+static ParentFailover fo;
+
+static void failover_before(void *fixture)
+{
+	ParentFailover::Config config = {
+		.poor_window_ms = matter::PARENT_SWITCH_POOR_WINDOW_MS,
+		.search_window_ms = matter::PARENT_SEARCH_WINDOW_MS,
+		.max_searches = matter::PARENT_SWITCH_MAX_SEARCHES,
+	};
+
+	fo.init(config);
+}
+
+ZTEST(parent_failover, test_search_after_poor_window)
+{
+	uint32_t t = 0;
+
+	zassert_equal(fo.update(NetworkHealth::GOOD, 30, t), ParentFailover::Action::NONE);
+
+	/* POOR starts the episode; nothing happens inside the window */
+	t += SAMPLE_MS;
+	zassert_equal(fo.update(NetworkHealth::POOR, 3, t), ParentFailover::Action::NONE);
+	zassert_true(fo.inEpisode());
+	zassert_equal(fo.update(NetworkHealth::POOR, 3, t + matter::PARENT_SWITCH_POOR_WINDOW_MS - 1),
+		      ParentFailover::Action::NONE);
+
+	zassert_equal(fo.update(NetworkHealth::POOR, 3, t + matter::PARENT_SWITCH_POOR_WINDOW_MS),
+		      ParentFailover::Action::SEARCH);
+	zassert_true(fo.isSearching());
+	zassert_equal(fo.getStats().searches, 1);
+}
+
+ZTEST(parent_failover, test_best_candidate_kept)
+{
+	uint32_t t = 0;
+
+	fo.update(NetworkHealth::POOR, 3, t);
+	t += matter::PARENT_SWITCH_POOR_WINDOW_MS;
+	zassert_equal(fo.update(NetworkHealth::POOR, 3, t), ParentFailover::Action::SEARCH);
+
+	fo.addCandidate(5);
+	fo.addCandidate(20);
+	fo.addCandidate(12);
+	zassert_equal(fo.getBestCandidate(), 20);
+
+	/* Still collecting responses */
+	zassert_equal(fo.update(NetworkHealth::POOR, 3, t + 1), ParentFailover::Action::NONE);
+
+	/* The stack picks the parent; the policy only closes the search */
+	t += matter::PARENT_SEARCH_WINDOW_MS;
+	zassert_equal(fo.update(NetworkHealth::POOR, 3, t), ParentFailover::Action::NONE);
+	zassert_false(fo.isSearching());
+	zassert_equal(fo.getBestCandidate(), 20);
+}
+
+ZTEST(parent_failover, test_search_budget)
+{
+	uint32_t t = 0;
+	int8_t parent = 10;
+
+	fo.update(NetworkHealth::POOR, parent, t);
+
+	for (int i = 0; i < matter::PARENT_SWITCH_MAX_SEARCHES; i++) {
+		t += matter::PARENT_SWITCH_POOR_WINDOW_MS;
+		zassert_equal(fo.update(NetworkHealth::POOR, parent, t),
+			      ParentFailover::Action::SEARCH);
+
+		/* Nobody good enough: the stack keeps its parent */
+		fo.addCandidate(parent - 1);
+		t += matter::PARENT_SEARCH_WINDOW_MS;
+		zassert_equal(fo.update(NetworkHealth::POOR, parent, t),
+			      ParentFailover::Action::NONE);
+	}
+
+	/* Search budget for this episode is spent */
+	t += 10 * matter::PARENT_SWITCH_POOR_WINDOW_MS;
+	zassert_equal(fo.update(NetworkHealth::POOR, parent, t), ParentFailover::Action::NONE);
+	zassert_equal(fo.getStats().searches, matter::PARENT_SWITCH_MAX_SEARCHES);
+	zassert_equal(fo.getStats().recoveries, 0);
+}
+
+ZTEST(parent_failover, test_recovery_measured)
+{
+	fo.update(NetworkHealth::POOR, 3, 1000);
+	fo.onParentChanged();
+
+	/* UNKNOWN (fresh estimator) does not end the episode */
+	fo.update(NetworkHealth::UNKNOWN, 0, 20000);
+	zassert_true(fo.inEpisode());
+
+	fo.update(NetworkHealth::FAIR, 15, 23000);
+	zassert_false(fo.inEpisode());
+	zassert_equal(fo.getStats().recoveries, 1);
+	zassert_equal(fo.getStats().parent_switches, 1);
+	zassert_equal(fo.getStats().last_recovery_ms, 22000);
+
+	/* Next episode starts clean */
+	fo.update(NetworkHealth::POOR, 3, 30000);
+	fo.update(NetworkHealth::GOOD, 30, 32000);
+	zassert_equal(fo.getStats().recoveries, 2);
+	zassert_equal(fo.getStats().parent_switches, 1);
+	zassert_equal(fo.getStats().max_recovery_ms, 22000);
+}
+
+/*
+ * Scripted degradation: the parent link is solid, then drops to -92 dBm
+ * with 20% loss at DEGRADE_MS and dies at DEAD_MS. Another router answers
+ * Parent Requests at -75 dBm; like OpenThread, the child moves to it when
+ * its margin beats the parent's, ATTACH_MS after the search. Recovery is
+ * measured from the POOR onset and must end while the old link is still
+ * up, so the device never goes through a detach.
+ */
+#define DEGRADE_MS (60U * 1000U)
+#define DEAD_MS    (240U * 1000U)
+#define CANDIDATE_RSSI (-75)
+#define ATTACH_MS  2000U
+
+ZTEST(parent_failover, test_scripted_degradation)
+{
+	LinkQualityEstimator est;
+	uint32_t tx_requested = 0;
+	uint32_t tx_acked = 0;
+	uint32_t onset_ms = 0;
+	uint32_t switch_ms = 0;
+	bool switched = false;
+	uint32_t t = 0;
+
+	est.addCounterSample(tx_requested, tx_acked);
+
+	while (fo.getStats().recoveries == 0 && t < DEAD_MS) {
+		int8_t rssi;
+		uint8_t lost;
+
+		if (switch_ms != 0 && t >= switch_ms && !switched) {
+			/* Attached to the new parent; its link is judged afresh */
+			switched = true;
+			est.reset();
+			est.addCounterSample(tx_requested, tx_acked);
+			fo.onParentChanged();
+		}
+
+		if (switched) {
+			rssi = CANDIDATE_RSSI;
+			lost = 1;
+		} else if (t < DEGRADE_MS) {
+			rssi = -68;
+			lost = 1;
+		} else {
+			rssi = -92;
+			lost = 20;
+		}
+
+		tx_requested += 100;
+		tx_acked += 100 - lost;
+		est.addLinkSample(rssi, 1);
+		est.addCounterSample(tx_requested, tx_acked);
+
+		NetworkHealth health = est.evaluate();
+
+		if (health == NetworkHealth::POOR && onset_ms == 0) {
+			onset_ms = t;
+		}
+
+		int8_t margin = (int8_t)MAX(est.getRssi() - RX_SENSITIVITY, 0);
+		int8_t candidate = CANDIDATE_RSSI - RX_SENSITIVITY;
+
+		if (fo.update(health, margin, t) == ParentFailover::Action::SEARCH) {
+			/* The other router answers the Parent Request */
+			fo.addCandidate(candidate);
+			if (candidate > margin && switch_ms == 0) {
+				switch_ms = t + ATTACH_MS;
+			}
+		}
+		t += SAMPLE_MS;
+	}
+
+	const ParentFailover::Stats& stats = fo.getStats();
+
+	TC_PRINT("POOR at %u ms; parent switch recovered in %u ms, %u ms before the link died\n",
+		 onset_ms, stats.last_recovery_ms, DEAD_MS - (onset_ms + stats.last_recovery_ms));
+
+	zassert_true(onset_ms > DEGRADE_MS, "degradation never reached POOR");
+	zassert_equal(stats.recoveries, 1);
+	zassert_equal(stats.parent_switches, 1);
+	zassert_true(onset_ms + stats.last_recovery_ms < DEAD_MS, "old link died first");
+}
+
+ZTEST_SUITE(parent_failover, NULL, NULL, failover_before, NULL, NULL);
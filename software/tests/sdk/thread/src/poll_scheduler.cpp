@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Poll scheduler tests
+ *
+ * Fast-poll bursts of a sleepy end device: entry, extension, expiry,
+ * cancellation and the per-request cap, on caller-supplied time.
+ */
+
+#include <zephyr/ztest.h>
+
+#include "thread/poll_scheduler.hpp"
+
+using namespace smarthome::protocol::thread;
+
+static PollScheduler poll;
+
+static void poll_before(void *fixture)
+{
+	PollScheduler::Config config = {
+		.slow_period_ms = 5000,
+		.fast_period_ms = 200,
+		.max_burst_ms = 60000,
+	};
+
+	poll.init(config);
+}
+
+ZTEST(poll_scheduler, test_burst_and_expiry)
+{
+	zassert_equal(poll.getPeriodMs(), 5000);
+
+	zassert_true(poll.requestFastPoll(3000, 1000));
+	zassert_equal(poll.getPeriodMs(), 200);
+	zassert_equal(poll.getRemainingMs(1000), 3000);
+
+	zassert_false(poll.update(3999));
+	zassert_true(poll.isFastPolling());
+
+	zassert_true(poll.update(4000));
+	zassert_equal(poll.getPeriodMs(), 5000);
+	zassert_equal(poll.getRemainingMs(4000), 0);
+	zassert_equal(poll.getStats().bursts, 1);
+	zassert_equal(poll.getStats().fast_ms, 3000);
+}
+
+ZTEST(poll_scheduler, test_overlap_extends_never_shortens)
+{
+	zassert_true(poll.requestFastPoll(10000, 0));
+
+	/* Shorter request inside the burst: deadline stays at 10 s */
+	zassert_false(poll.requestFastPoll(1000, 2000));
+	zassert_equal(poll.getRemainingMs(2000), 8000);
+
+	/* Longer one moves it out */
+	zassert_false(poll.requestFastPoll(15000, 5000));
+	zassert_false(poll.update(10000));
+	zassert_true(poll.update(20000));
+
+	zassert_equal(poll.getStats().bursts, 1);
+	zassert_equal(poll.getStats().extensions, 2);
+}
+
+ZTEST(poll_scheduler, test_cancel_and_cap)
+{
+	zassert_false(poll.cancelFastPoll(0));
+
+	zassert_true(poll.requestFastPoll(UINT32_MAX, 0));
+	zassert_equal(poll.getRemainingMs(0), 60000);
+
+	zassert_true(poll.cancelFastPoll(500));
+	zassert_false(poll.isFastPolling());
+	zassert_equal(poll.getStats().fast_ms, 500);
+
+	zassert_false(poll.requestFastPoll(0, 1000));
+}
+
+ZTEST(poll_scheduler, test_uptime_wrap)
+{
+	uint32_t now = UINT32_MAX - 1000;
+
+	zassert_true(poll.requestFastPoll(3000, now));
+	zassert_false(poll.update(now + 2999));
+	zassert_true(poll.update(now + 3000));
+}
+
+ZTEST_SUITE(poll_scheduler, NULL, NULL, poll_before, NULL, NULL);
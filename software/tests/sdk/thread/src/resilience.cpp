@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Network resilience manager tests
+ *
+ * Link down/up bookkeeping: health and disconnect callbacks from the
+ * work queue, the outage counted into downtime while it runs and once it
+ * closes, the link down timeout, connected time, statistics reset and
+ * health names.
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+
+#include "thread/network_resilience_manager.hpp"
+#include "matter/commission/chip_config.hpp"
+
+using namespace smarthome::protocol::thread;
+using smarthome::protocol::matter::LINK_DOWN_TIMEOUT_MS;
+
+static struct k_sem health_sem;
+static struct k_sem disconnect_sem;
+static NetworkHealth notified;
+
+static void on_health(NetworkHealth health)
+{
+	notified = health;
+	k_sem_give(&health_sem);
+}
+
+static void on_disconnect(void)
+{
+	k_sem_give(&disconnect_sem);
+}
+
+static HealthSnapshot snapshot(void)
+{
+	HealthSnapshot snap;
+
+	NetworkResilienceManager::getInstance().getSnapshot(snap);
+	return snap;
+}
+
+static void *resilience_setup(void)
+{
+	NetworkResilienceManager &mgr = NetworkResilienceManager::getInstance();
+
+	k_sem_init(&health_sem, 0, K_SEM_MAX_LIMIT);
+	k_sem_init(&disconnect_sem, 0, K_SEM_MAX_LIMIT);
+	mgr.setHealthCallback(on_health);
+	mgr.setDisconnectCallback(on_disconnect);
+	return NULL;
+}
+
+static void resilience_before(void *fixture)
+{
+	NetworkResilienceManager &mgr = NetworkResilienceManager::getInstance();
+
+	/* Attached, counters cleared, callbacks drained */
+	mgr.onLinkUp();
+	mgr.resetStatistics();
+	k_sleep(K_MSEC(10));
+	k_sem_reset(&health_sem);
+	k_sem_reset(&disconnect_sem);
+}
+
+ZTEST(resilience, test_link_down_up)
+{
+	NetworkResilienceManager &mgr = NetworkResilienceManager::getInstance();
+	bool was_poor = (mgr.getHealth() == NetworkHealth::POOR);
+
+	mgr.onLinkDown();
+	zassert_equal(mgr.getHealth(), NetworkHealth::POOR);
+	zassert_equal(mgr.getDisconnectCount(), 1);
+	zassert_ok(k_sem_take(&disconnect_sem, K_MSEC(100)));
+	if (!was_poor) {
+		zassert_ok(k_sem_take(&health_sem, K_MSEC(100)));
+		zassert_equal(notified, NetworkHealth::POOR);
+	}
+
+	/* The running outage counts as downtime */
+	k_sleep(K_SECONDS(2));
+	HealthSnapshot snap = snapshot();
+
+	zassert_false(snap.flags & HEALTH_FLAG_LINK_UP);
+	zassert_equal(snap.downtime_s, 2);
+	zassert_equal(snap.connected_s, 0);
+	zassert_equal(snap.disconnects, 1);
+
+	/* Closed: downtime stays, connected time starts */
+	mgr.onLinkUp();
+	k_sleep(K_SECONDS(1));
+	snap = snapshot();
+	zassert_true(snap.flags & HEALTH_FLAG_LINK_UP);
+	zassert_equal(snap.downtime_s, 2);
+	zassert_equal(snap.connected_s, 1);
+	zassert_equal(mgr.getNetworkConnectedTimeSec(), 1);
+}
+
+ZTEST(resilience, test_outages_accumulate)
+{
+	NetworkResilienceManager &mgr = NetworkResilienceManager::getInstance();
+
+	for (int i = 0; i < 3; i++) {
+		mgr.onLinkDown();
+		k_sleep(K_MSEC(500));
+		mgr.onLinkUp();
+	}
+	zassert_equal(mgr.getDisconnectCount(), 3);
+	zassert_equal(snapshot().downtime_s, 1, "1.5 s in whole seconds");
+
+	/* An outage in progress counts too */
+	mgr.onLinkDown();
+	k_sleep(K_MSEC(500));
+	zassert_equal(snapshot().downtime_s, 2);
+	zassert_equal(mgr.getDisconnectCount(), 4);
+	mgr.onLinkUp();
+}
+
+ZTEST(resilience, test_link_down_timeout)
+{
+	NetworkResilienceManager &mgr = NetworkResilienceManager::getInstance();
+
+	/* Back before the timeout: nothing to rejoin */
+	mgr.onLinkDown();
+	k_sleep(K_MSEC(LINK_DOWN_TIMEOUT_MS - 100));
+	mgr.onLinkUp();
+	k_sleep(K_MSEC(200));
+	zassert_equal(mgr.getReconnectAttempts(), 0);
+
+	/* Still down at the timeout: one rejoin, once */
+	mgr.onLinkDown();
+	k_sleep(K_MSEC(LINK_DOWN_TIMEOUT_MS + 100));
+	zassert_equal(mgr.getReconnectAttempts(), 1);
+	k_sleep(K_MSEC(LINK_DOWN_TIMEOUT_MS));
+	zassert_equal(mgr.getReconnectAttempts(), 1);
+	mgr.onLinkUp();
+}
+
+ZTEST(resilience, test_reset_statistics)
+{
+	NetworkResilienceManager &mgr = NetworkResilienceManager::getInstance();
+
+	mgr.onLinkDown();
+	k_sleep(K_SECONDS(1));
+	mgr.onLinkUp();
+	zassert_equal(snapshot().downtime_s, 1);
+
+	mgr.resetStatistics();
+	HealthSnapshot snap = snapshot();
+
+	zassert_equal(snap.disconnects, 0);
+	zassert_equal(snap.reconnects, 0);
+	zassert_equal(snap.downtime_s, 0);
+	zassert_equal(mgr.getBootCount(), 1);
+
+	/* Nothing to checkpoint to without CONFIG_APP_NET_STATS */
+	zassert_equal(mgr.saveStatistics(), -ENOTSUP);
+}
+
+ZTEST(resilience, test_health_names)
+{
+	zassert_str_equal(NetworkResilienceManager::healthName(NetworkHealth::UNKNOWN), "UNKNOWN");
+	zassert_str_equal(NetworkResilienceManager::healthName(NetworkHealth::POOR), "POOR");
+	zassert_str_equal(NetworkResilienceManager::healthName(NetworkHealth::EXCELLENT),
+			  "EXCELLENT");
+	zassert_str_equal(NetworkResilienceManager::healthName((NetworkHealth)9), "INVALID");
+}
+
+ZTEST_SUITE(resilience, NULL, resilience_setup, resilience_before, NULL, NULL);
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Timer wheel tests
+ *
+ * The wheel is driven the way the service drives it - jump to nextExpiry(),
+ * drain expire() - and every timer must fire on its deadline to the
+ * millisecond, across cascades and past the horizon. Slack must merge
+ * nearby deadlines into one expiry. The service test runs real timers on
+ * the system work queue and counts its wakeups.
+ */
+
+#include <zephyr/ztest.h>
+
+#include "timer/timer_wheel.hpp"
+#include "bench.h"
+
+using namespace smarthome::services::timer;
+
+struct Probe {
+	uint64_t fired_at;
+	uint32_t count;
+};
+
+static TimerWheel wheel;
+static WheelTimer timers[64];
+static Probe probes[64];
+
+/* Fire everything due up to `until`, as the service work item does */
+static uint32_t drive(uint64_t until)
+{
+	uint32_t wakeups = 0;
+	uint64_t next;
+
+	while ((next = wheel.nextExpiry()) <= until) {
+		WheelTimer *timer;
+
+		wakeups++;
+		while ((timer = wheel.expire(next)) != nullptr) {
+			Probe *probe = static_cast<Probe *>(timer->user_data);
+
+			probe->fired_at = next;
+			probe->count++;
+		}
+	}
+	wheel.expire(until);
+	return wakeups;
+}
+
+static void wheel_before(void *fixture)
+{
+	wheel.reset(0);
+	for (size_t i = 0; i < ARRAY_SIZE(timers); i++) {
+		timers[i].init(nullptr, &probes[i]);
+		probes[i] = {};
+	}
+}
+
+/*=============================================================================
+ * Expiry
+ *===========================================================================*/
+
+ZTEST(timer_wheel, test_exact_across_levels)
+{
+	/* One deadline per level, on and off slot boundaries, and past the horizon */
+	static const uint32_t delays[] = {
+		1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 300001,
+		16777215, 16777216, 20000000
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(delays); i++) {
+		wheel.start(timers[i], 0, delays[i]);
+	}
+	zassert_equal(wheel.size(), ARRAY_SIZE(delays));
+
+	drive(20000000);
+
+	for (size_t i = 0; i < ARRAY_SIZE(delays); i++) {
+		zassert_equal(probes[i].count, 1, "delay %u", delays[i]);
+		zassert_equal(probes[i].fired_at, delays[i], "delay %u", delays[i]);
+		zassert_false(timers[i].active);
+	}
+	zassert_equal(wheel.size(), 0);
+	zassert_equal(wheel.nextExpiry(), TimerWheel::NEVER);
+	zassert_true(wheel.getStats().cascaded > 0);
+}
+
+ZTEST(timer_wheel, test_start_with_lagging_clock)
+{
+	/* The service only advances the wheel when it wakes */
+	wheel.start(timers[0], 0, 5000);
+	drive(1000);
+
+	wheel.start(timers[1], 3210, 70);
+	wheel.start(timers[2], 3210, 0);
+	drive(6000);
+
+	zassert_equal(probes[0].fired_at, 5000);
+	zassert_equal(probes[1].fired_at, 3280);
+	zassert_equal(probes[2].fired_at, 3210);
+}
+
+ZTEST(timer_wheel, test_cancel_and_restart)
+{
+	wheel.start(timers[0], 0, 100);
+	wheel.start(timers[1], 0, 100);
+	wheel.start(timers[2], 0, 5000);
+
+	zassert_true(wheel.cancel(timers[1]));
+	zassert_false(wheel.cancel(timers[1]), "already stopped");
+
+	/* Restarting moves the deadline */
+	wheel.start(timers[2], 0, 200);
+	zassert_equal(wheel.size(), 2);
+
+	drive(10000);
+	zassert_equal(probes[0].fired_at, 100);
+	zassert_equal(probes[1].count, 0);
+	zassert_equal(probes[2].count, 1);
+	zassert_equal(probes[2].fired_at, 200);
+
+	/* Cancel after it is due but before it is returned */
+	wheel.start(timers[3], 10000, 10);
+	wheel.start(timers[4], 10000, 10);
+	zassert_equal(wheel.expire(10010), &timers[3]);
+	zassert_true(wheel.cancel(timers[4]));
+	zassert_is_null(wheel.expire(10010));
+	zassert_equal(wheel.size(), 0);
+}
+
+ZTEST(timer_wheel, test_periodic)
+{
+	wheel.start(timers[0], 0, 1000, 1000);
+	drive(10500);
+	zassert_equal(probes[0].count, 10);
+	zassert_equal(probes[0].fired_at, 10000);
+	zassert_true(timers[0].active);
+
+	/* A late wakeup drops the missed periods and keeps going */
+	zassert_equal(wheel.expire(13700), &timers[0]);
+	zassert_is_null(wheel.expire(13700));
+	zassert_equal(timers[0].deadline, 14700);
+
+	zassert_true(wheel.cancel(timers[0]));
+	zassert_equal(wheel.nextExpiry(), TimerWheel::NEVER);
+}
+
+ZTEST(timer_wheel, test_random_schedule)
+{
+	uint32_t seed = 12345;
+	uint64_t deadline[ARRAY_SIZE(timers)];
+	bool cancelled[ARRAY_SIZE(timers)] = {};
+
+	for (size_t i = 0; i < ARRAY_SIZE(timers); i++) {
+		seed = seed * 1103515245U + 12345U;
+		uint32_t delay = (seed >> 8) % (1U << (4 + (i % 5) * 5));
+
+		wheel.start(timers[i], 0, delay);
+		deadline[i] = delay;
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(timers); i += 7) {
+		zassert_true(wheel.cancel(timers[i]));
+		cancelled[i] = true;
+	}
+
+	drive(1U << 25);
+
+	for (size_t i = 0; i < ARRAY_SIZE(timers); i++) {
+		if (cancelled[i]) {
+			zassert_equal(probes[i].count, 0, "timer %u", i);
+		} else {
+			zassert_equal(probes[i].count, 1, "timer %u", i);
+			zassert_equal(probes[i].fired_at, deadline[i], "timer %u", i);
+		}
+	}
+}
+
+/*=============================================================================
+ * Coalescing
+ *===========================================================================*/
+
+ZTEST(timer_wheel, test_slack_coalesces)
+{
+	static const uint32_t delays[] = { 1001, 1010, 1020, 1023 };
+
+	/* Exact deadlines: one expiry each */
+	for (size_t i = 0; i < ARRAY_SIZE(delays); i++) {
+		wheel.start(timers[i], 0, delays[i]);
+	}
+	zassert_equal(drive(2000), ARRAY_SIZE(delays));
+
+	/* 40 ms of slack rounds to 32 ms grains: all land on 3072 */
+	for (size_t i = 0; i < ARRAY_SIZE(delays); i++) {
+		timers[i].init(nullptr, &probes[i], 40);
+		wheel.start(timers[i], 2048, delays[i]);
+	}
+	zassert_equal(drive(4000), 1);
+
+	for (size_t i = 0; i < ARRAY_SIZE(delays); i++) {
+		zassert_equal(probes[i].fired_at, 3072);
+		zassert_true(probes[i].fired_at - (2048 + delays[i]) <= 40);
+	}
+	zassert_equal(wheel.getStats().fired, 2 * ARRAY_SIZE(delays));
+	zassert_equal(wheel.getStats().expiries, ARRAY_SIZE(delays) + 1);
+}
+
+ZTEST(timer_wheel, test_align_deadline)
+{
+	zassert_equal(TimerWheel::alignDeadline(1003, 0), 1003);
+	zassert_equal(TimerWheel::alignDeadline(1003, 1), 1003);
+	zassert_equal(TimerWheel::alignDeadline(1003, 100), 1024);
+	zassert_equal(TimerWheel::alignDeadline(1024, 100), 1024);
+	zassert_equal(TimerWheel::alignDeadline(10001, 1250), 10240);
+}
+
+/*=============================================================================
+ * Service
+ *===========================================================================*/
+
+static atomic_t service_fired;
+
+static void on_service_timer(WheelTimer &timer, void *user_data)
+{
+	zassert_false(k_is_in_isr(), "callbacks run on the work queue");
+	atomic_inc(&service_fired);
+}
+
+ZTEST(timer_wheel, test_service_one_wakeup)
+{
+	static WheelTimer a, b, c;
+	TimerService &service = TimerService::getInstance();
+	TimerService::Stats before, after;
+
+	a.init(on_service_timer, nullptr, 64);
+	b.init(on_service_timer, nullptr, 64);
+	c.init(on_service_timer, nullptr, 64);
+
+	/* Deadlines 10 ms apart, just before a 64 ms grain */
+	uint64_t now = k_uptime_get();
+	uint32_t to_grain = (uint32_t)(ROUND_UP(now + 100, 64) - now);
+
+	service.getStats(before);
+	service.start(a, to_grain - 30);
+	service.start(b, to_grain - 20);
+	service.start(c, to_grain - 10);
+	zassert_true(service.isRunning(b));
+	zassert_true(service.getRemainingMs(c) >= to_grain - 20);
+
+	k_sleep(K_MSEC(300));
+
+	service.getStats(after);
+	zassert_equal(atomic_get(&service_fired), 3);
+	zassert_equal(after.wakeups - before.wakeups, 1, "one wakeup for three timers");
+	zassert_false(service.isRunning(b));
+	zassert_equal(service.getRemainingMs(b), 0);
+
+	/* Stopped timers do not fire */
+	service.start(a, 50);
+	zassert_true(service.stop(a));
+	k_sleep(K_MSEC(100));
+	zassert_equal(atomic_get(&service_fired), 3);
+}
+
+/*=============================================================================
+ * Benchmarks
+ *===========================================================================*/
+
+ZTEST(timer_wheel, test_bench_wheel)
+{
+	struct bench b;
+
+	/* Arm and cancel all 64 timers over every level */
+	bench_init(&b, "timer", "wheel_start_cancel");
+	for (int round = 0; round < 50; round++) {
+		bench_begin(&b);
+		for (size_t i = 0; i < ARRAY_SIZE(timers); i++) {
+			wheel.start(timers[i], 0, 1U << (i % 20));
+		}
+		for (size_t i = 0; i < ARRAY_SIZE(timers); i++) {
+			wheel.cancel(timers[i]);
+		}
+		bench_end(&b, 2 * ARRAY_SIZE(timers));
+	}
+	bench_report(&b);
+
+	/* Fire them: per timer, cascades included */
+	bench_init(&b, "timer", "wheel_expire");
+	for (int round = 0; round < 20; round++) {
+		wheel.reset(0);
+		for (size_t i = 0; i < ARRAY_SIZE(timers); i++) {
+			wheel.start(timers[i], 0, 1U << (i % 20));
+		}
+		bench_begin(&b);
+		drive(1U << 20);
+		bench_end(&b, ARRAY_SIZE(timers));
+	}
+	bench_report(&b);
+}
+
+ZTEST_SUITE(timer_wheel, NULL, NULL, wheel_before, NULL, NULL);
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Wake-word model loader tests
+ *
+ * The loader createModelLoader() builds without a model configured: model
+ * info, load/unload, the energy confidence of the placeholder and its
+ * argument checks, and an inference benchmark over one window.
+ */
+
+#include <zephyr/ztest.h>
+
+#include "wakeword/model_loader.hpp"
+#include "bench.h"
+
+#define WINDOW 512
+
+static ModelLoader *loader;
+static float window[WINDOW];
+
+static void fill(float level)
+{
+	for (size_t i = 0; i < WINDOW; i++) {
+		window[i] = (i & 1) ? level : -level;
+	}
+}
+
+static float confidence(void)
+{
+	float out = -1.0f;
+
+	zassert_ok(loader->infer(window, WINDOW, &out, 1));
+	return out;
+}
+
+static void *model_setup(void)
+{
+	loader = createModelLoader();
+	zassert_not_null(loader);
+	return NULL;
+}
+
+static void model_before(void *fixture)
+{
+	loader->unload();
+}
+
+ZTEST(model_loader, test_info)
+{
+	ModelLoader::ModelInfo info = loader->getInfo();
+
+	zassert_equal(info.type, ModelLoader::ModelType::PLACEHOLDER);
+	zassert_is_null(info.model_data);
+	zassert_equal(info.input_size, WINDOW);
+	zassert_equal(info.output_size, 1);
+	zassert_str_equal(info.version, "placeholder-1.0");
+}
+
+ZTEST(model_loader, test_load_unload)
+{
+	float out;
+
+	zassert_false(loader->isLoaded());
+	fill(0.1f);
+	zassert_equal(loader->infer(window, WINDOW, &out, 1), -EINVAL, "not loaded");
+
+	zassert_ok(loader->load());
+	zassert_true(loader->isLoaded());
+	zassert_ok(loader->infer(window, WINDOW, &out, 1));
+
+	loader->unload();
+	zassert_false(loader->isLoaded());
+	zassert_equal(loader->infer(window, WINDOW, &out, 1), -EINVAL);
+}
+
+ZTEST(model_loader, test_energy_confidence)
+{
+	zassert_ok(loader->load());
+
+	/* Twice the RMS level, clamped to 1 */
+	fill(0.0f);
+	zassert_within(confidence(), 0.0f, 1e-6f);
+	fill(0.1f);
+	zassert_within(confidence(), 0.2f, 1e-4f);
+	fill(0.25f);
+	zassert_within(confidence(), 0.5f, 1e-4f);
+	fill(0.9f);
+	zassert_within(confidence(), 1.0f, 1e-6f);
+
+	/* A burst in a quiet window raises it */
+	fill(0.01f);
+	float quiet = confidence();
+
+	for (size_t i = 0; i < WINDOW / 8; i++) {
+		window[i] = (i & 1) ? 0.5f : -0.5f;
+	}
+	zassert_true(confidence() > quiet);
+}
+
+ZTEST(model_loader, test_bad_arguments)
+{
+	float out;
+
+	zassert_ok(loader->load());
+	fill(0.1f);
+	zassert_equal(loader->infer(nullptr, WINDOW, &out, 1), -EINVAL);
+	zassert_equal(loader->infer(window, 0, &out, 1), -EINVAL);
+	zassert_equal(loader->infer(window, WINDOW, nullptr, 1), -EINVAL);
+	zassert_equal(loader->infer(window, WINDOW, &out, 0), -EINVAL);
+}
+
+ZTEST(model_loader, test_bench_inference)
+{
+	struct bench b;
+
+	zassert_ok(loader->load());
+	fill(0.3f);
+
+	bench_init(&b, "wakeword", "placeholder_infer_512");
+	for (int i = 0; i < 100; i++) {
+		bench_begin(&b);
+		(void)confidence();
+		bench_end(&b, 1);
+	}
+	bench_report(&b);
+}
+
+ZTEST_SUITE(model_loader, NULL, model_setup, model_before, NULL, NULL);
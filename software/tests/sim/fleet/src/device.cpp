@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+#include "device.h"
+#include "net_core.hpp"
+#include "matter/commission/commissioning_delegate.hpp"
+#include "matter/light_endpoint/light_groups.hpp"
+
+using namespace smarthome::ipc;
+using smarthome::protocol::matter::CommissioningDelegate;
+using smarthome::protocol::matter::LightAttributes;
+using smarthome::protocol::matter::LightEndpoints;
+using smarthome::protocol::matter::LightGroups;
+using smarthome::protocol::matter::LIGHT_ENDPOINT_ID;
+
+static LoopbackTransport app_end;
+static LoopbackTransport net_end;
+static LoopbackConfig link_app;
+static LoopbackConfig link_net;
+
+/* NET core context: a work queue whose thread is tagged Core::NET */
+static K_THREAD_STACK_DEFINE(net_stack, 4096);
+static struct k_work_q net_q;
+static struct k_work net_work;
+static struct k_sem net_done;
+static void (*net_fn)(void);
+static int net_init_ret;
+
+/* What the APP core received */
+K_MSGQ_DEFINE(app_inbox, sizeof(Message), 32, 4);
+
+static atomic_t output_updates;
+static int64_t last_output_ms;
+
+static void net_work_handler(struct k_work *work)
+{
+	net_fn();
+	k_sem_give(&net_done);
+}
+
+static void net_submit(void (*fn)(void))
+{
+	net_fn = fn;
+	k_work_submit_to_queue(&net_q, &net_work);
+}
+
+int device_net_run(void (*fn)(void))
+{
+	net_submit(fn);
+	return k_sem_take(&net_done, K_SECONDS(1)) ? -ETIMEDOUT : 0;
+}
+
+static void net_bind(void)
+{
+	IPCCore::bindThread(Core::NET);
+}
+
+static void net_boot(void)
+{
+	net_init_ret = net::NetCoreManager::getInstance().init();
+}
+
+static void on_app_msg(const Message &msg)
+{
+	(void)k_msgq_put(&app_inbox, &msg, K_NO_WAIT);
+}
+
+static void on_output(const LightAttributes *attrs, uint32_t changed_mask)
+{
+	atomic_inc(&output_updates);
+	last_output_ms = k_uptime_get();
+}
+
+/*=============================================================================
+ * Boot
+ *===========================================================================*/
+
+int device_boot(uint32_t device)
+{
+	IPCCore &app = IPCCore::getInstance(Core::APP);
+	IPCCore &net_ipc = IPCCore::getInstance(Core::NET);
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightGroups &groups = LightGroups::getInstance();
+	int ret;
+
+	ret = settings_subsys_init();
+	if (ret) {
+		return ret;
+	}
+
+	/* Same fleet number, same link faults */
+	link_app.seed = device * 2 + 1;
+	link_net.seed = device * 2 + 2;
+
+	/* Lights come back first, as in AppTask */
+	ret = lights.init();
+	if (ret < 0) {
+		return ret;
+	}
+	lights.setOutput(on_output);
+
+	ret = groups.init();
+	if (ret < 0) {
+		return ret;
+	}
+	for (uint8_t i = 0; i < LightEndpoints::COUNT; i++) {
+		ret = groups.addGroup(LIGHT_ENDPOINT_ID + i, FLEET_GROUP);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	k_sem_init(&net_done, 0, 1);
+	k_work_init(&net_work, net_work_handler);
+	k_work_queue_start(&net_q, net_stack, K_THREAD_STACK_SIZEOF(net_stack),
+			   K_PRIO_PREEMPT(1), NULL);
+	ret = device_net_run(net_bind);
+	if (ret) {
+		return ret;
+	}
+
+	LoopbackTransport::connect(app_end, net_end);
+	app_end.configure(link_app);
+	net_end.configure(link_net);
+	app.setTransport(app_end);
+	net_ipc.setTransport(net_end);
+
+	/* NET boots and waits for the link while the APP core brings it up */
+	net_submit(net_boot);
+	ret = app.init();
+	if (ret) {
+		return ret;
+	}
+	if (k_sem_take(&net_done, K_SECONDS(1))) {
+		return -ETIMEDOUT;
+	}
+	if (net_init_ret) {
+		return net_init_ret;
+	}
+
+	ret = CommissioningDelegate::getInstance().init();
+	if (ret) {
+		return ret;
+	}
+
+	app.registerCallback(MessageType::STATUS_RESPONSE, on_app_msg);
+	app.registerCallback(MessageType::ACK, on_app_msg);
+	app.registerCallback(MessageType::NACK, on_app_msg);
+	app.registerCallback(MessageType::BLE_CONNECT, on_app_msg);
+	return 0;
+}
+
+/*=============================================================================
+ * APP Core Inbox
+ *===========================================================================*/
+
+int device_expect(MessageType type, Message *out, uint32_t timeout_ms)
+{
+	int64_t deadline = k_uptime_get() + timeout_ms;
+
+	while (k_uptime_get() < deadline) {
+		if (k_msgq_get(&app_inbox, out, K_MSEC(deadline - k_uptime_get())) < 0) {
+			break;
+		}
+		if (out->type == type) {
+			return 0;
+		}
+	}
+	return -ETIMEDOUT;
+}
+
+void device_purge(void)
+{
+	k_msgq_purge(&app_inbox);
+}
+
+/*=============================================================================
+ * Link
+ *===========================================================================*/
+
+void device_link(uint32_t latency_ms, uint32_t jitter_ms, uint16_t loss_permille)
+{
+	link_app.latency_ms = link_net.latency_ms = latency_ms;
+	link_app.jitter_ms = link_net.jitter_ms = jitter_ms;
+	link_app.loss_permille = link_net.loss_permille = loss_permille;
+	app_end.configure(link_app);
+	net_end.configure(link_net);
+}
+
+void device_blackout(bool down)
+{
+	LoopbackConfig app_cfg = link_app;
+	LoopbackConfig net_cfg = link_net;
+
+	if (down) {
+		app_cfg.loss_permille = 1000;
+		net_cfg.loss_permille = 1000;
+	}
+	app_end.configure(app_cfg);
+	net_end.configure(net_cfg);
+}
+
+LoopbackTransport &device_app_end(void)
+{
+	return app_end;
+}
+
+LoopbackTransport &device_net_end(void)
+{
+	return net_end;
+}
+
+uint32_t device_output_updates(void)
+{
+	return (uint32_t)atomic_get(&output_updates);
+}
+
+int64_t device_last_output_ms(void)
+{
+	return last_output_ms;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file One simulated device: both cores of the nRF5340 in this process
+ *
+ * The firmware keeps its state in singletons (NetCoreManager, IPCCore per
+ * core, CommissioningDelegate, LightEndpoints, LightGroups, ...), as one
+ * image per core does on hardware, so a process is one device and a fleet
+ * is many processes (scripts/fleet_sim.py).
+ *
+ * The APP core is the main thread; the NET core is a work queue whose
+ * thread is tagged Core::NET, running the real NetCoreManager. The two
+ * IPCCore instances are linked by the loopback transport.
+ */
+
+#ifndef FLEET_DEVICE_H
+#define FLEET_DEVICE_H
+
+#include <stdint.h>
+
+#include "ipc_core.hpp"
+#include "ipc_loopback.hpp"
+
+/* Group every light endpoint of the device is in */
+#define FLEET_GROUP 0x0101
+
+/**
+ * Boot both cores, commissioning, lights and groups
+ *
+ * @param device Fleet number, seeds the link PRNG of both directions
+ * @return 0 on success, negative errno of the step that failed
+ */
+int device_boot(uint32_t device);
+
+/* Run fn on the NET core and wait for it, -ETIMEDOUT after 1 s */
+int device_net_run(void (*fn)(void));
+
+/* Next message of a type received by the APP core, others skipped */
+int device_expect(smarthome::ipc::MessageType type, smarthome::ipc::Message *out,
+		  uint32_t timeout_ms);
+
+/* Forget what the APP core received so far */
+void device_purge(void);
+
+/* Latency, jitter and loss of both directions */
+void device_link(uint32_t latency_ms, uint32_t jitter_ms, uint16_t loss_permille);
+
+/* Drop every frame both ways (NET core down), or restore the link */
+void device_blackout(bool down);
+
+smarthome::ipc::LoopbackTransport &device_app_end(void);
+smarthome::ipc::LoopbackTransport &device_net_end(void);
+
+/* Light output updates so far, and the uptime of the last one */
+uint32_t device_output_updates(void);
+int64_t device_last_output_ms(void);
+
+#endif /* FLEET_DEVICE_H */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Fleet runner options on the native simulator command line
+ *
+ *   zephyr.exe --device=3 --scenario=group_storm
+ *   zephyr.exe --steps="toggle:200@50" --link=10/5/20
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cmdline.h"
+#include "soc.h"
+#include "posix_board_if.h"
+#include "fleet_args.h"
+
+static char *scenario_arg;
+static char *steps_arg;
+static char *link_arg;
+static uint32_t device_arg;
+
+static void fleet_add_options(void)
+{
+	static struct args_struct_t options[] = {
+		{ .option = "scenario", .name = "name", .type = 's',
+		  .dest = (void *)&scenario_arg,
+		  .descript = "Preset workload script (smoke, commissioning, group_storm, "
+			      "flaky_link, reboot_loop, building)" },
+		{ .option = "steps", .name = "script", .type = 's',
+		  .dest = (void *)&steps_arg,
+		  .descript = "Workload script, overrides --scenario" },
+		{ .option = "link", .name = "latency/jitter/loss", .type = 's',
+		  .dest = (void *)&link_arg,
+		  .descript = "IPC link of both directions before the script (ms/ms/permille)" },
+		{ .option = "device", .name = "n", .type = 'u',
+		  .dest = (void *)&device_arg,
+		  .descript = "Device number in the fleet (reports, link seeds)" },
+		ARG_TABLE_ENDMARKER
+	};
+
+	native_add_command_line_opts(options);
+}
+
+NATIVE_TASK(fleet_add_options, PRE_BOOT_1, 10);
+
+const char *fleet_scenario(void)
+{
+	return scenario_arg;
+}
+
+const char *fleet_steps(void)
+{
+	return steps_arg;
+}
+
+const char *fleet_link(void)
+{
+	return link_arg;
+}
+
+uint32_t fleet_device(void)
+{
+	return device_arg;
+}
+
+void fleet_exit(int code)
+{
+	posix_exit(code);
+}
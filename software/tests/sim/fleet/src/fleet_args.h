@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Command line of the fleet runner
+ *
+ * Registered with the native simulator command line parser (fleet_args.c)
+ * and parsed before the kernel boots.
+ */
+
+#ifndef FLEET_ARGS_H
+#define FLEET_ARGS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --scenario=<name>: preset workload script, NULL = smoke */
+const char *fleet_scenario(void);
+
+/* --steps=<script>: workload script, overrides --scenario */
+const char *fleet_steps(void);
+
+/* --link=<latency>/<jitter>/<loss>: IPC link before the first step, NULL = clean */
+const char *fleet_link(void);
+
+/* --device=<n>: number in the fleet, in the reports and the link seeds */
+uint32_t fleet_device(void);
+
+/* End the process with the runner's exit code */
+void fleet_exit(int code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLEET_ARGS_H */
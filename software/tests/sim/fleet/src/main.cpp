@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Fleet scenario runner - one simulated device
+ *
+ * Boots both cores of one device in this process (device.h), runs a
+ * workload script (workloads.h) and prints a FLEET line per step, then
+ * the device totals. scripts/fleet_sim.py starts one process per device
+ * and adds the lines up across the fleet.
+ *
+ * Exits 0 when every operation succeeded, 1 when some failed (the
+ * results are still printed), 2 for a script that does not parse or a
+ * device that does not boot.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "device.h"
+#include "fleet_args.h"
+#include "metrics.h"
+#include "workloads.h"
+#include "timer/timer_wheel.hpp"
+
+using namespace smarthome::ipc;
+using smarthome::services::timer::TimerService;
+
+#define MAX_STEPS 16
+
+static const struct {
+	const char *name;
+	const char *steps;
+} scenarios[] = {
+	/* Every workload once, short - what CI runs */
+	{ "smoke", "ipc:50@100;burst:8;commission:3;toggle:40@20;flap:3@5;reboot:1;idle:100" },
+	/* A site commissioned at once, over a slow link */
+	{ "commissioning", "link:10/10/20;commission:20" },
+	/* Group commands faster than the transitions finish */
+	{ "group_storm", "toggle:400@20;toggle:400@100;toggle:400@500/10" },
+	{ "flaky_link", "link:5/20/100;ipc:300@50;burst:32;flap:20@4" },
+	{ "reboot_loop", "reboot:10/1000;ipc:100@50" },
+	/* A day in a building, compressed */
+	{ "building", "commission:5;ipc:200@50;toggle:400@50;burst:24;flap:10@4;reboot:3;"
+		      "toggle:200@100;idle:1000" },
+};
+
+static const char *script(void)
+{
+	const char *name = fleet_scenario() ? fleet_scenario() : "smoke";
+
+	if (fleet_steps()) {
+		return fleet_steps();
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(scenarios); i++) {
+		if (!strcmp(scenarios[i].name, name)) {
+			return scenarios[i].steps;
+		}
+	}
+	return NULL;
+}
+
+static int parse_script(const char *text, struct step *steps, size_t max)
+{
+	size_t count = 0;
+
+	while (text && *text) {
+		if (count == max || workload_parse(text, &steps[count]) < 0) {
+			return -EINVAL;
+		}
+		count++;
+
+		text = strchr(text, ';');
+		if (text) {
+			text++;
+		}
+	}
+	return (int)count;
+}
+
+int main(void)
+{
+	static struct step steps[MAX_STEPS];
+	static struct step_metrics m;
+	uint32_t device = fleet_device();
+	const char *text = script();
+	uint32_t ops = 0;
+	uint32_t failed = 0;
+	int count;
+	int ret;
+
+	count = parse_script(text, steps, ARRAY_SIZE(steps));
+
+	/* --link: a link step ahead of the script */
+	if (count > 0 && fleet_link()) {
+		char link[32];
+
+		snprintf(link, sizeof(link), "link:%s", fleet_link());
+		if (count == MAX_STEPS || workload_parse(link, &steps[count]) < 0) {
+			count = -EINVAL;
+		} else {
+			memmove(&steps[1], &steps[0], count * sizeof(steps[0]));
+			workload_parse(link, &steps[0]);
+			count++;
+		}
+	}
+
+	if (count <= 0) {
+		printk("FLEET device=%u error=script \"%s\"\n", device, text ? text : "");
+		fleet_exit(2);
+		return 0;
+	}
+
+	ret = device_boot(device);
+	if (ret) {
+		printk("FLEET device=%u error=boot ret=%d\n", device, ret);
+		fleet_exit(2);
+		return 0;
+	}
+	workloads_init();
+
+	printk("FLEET device=%u link=%s steps=%s\n", device,
+	       fleet_link() ? fleet_link() : "0/0/0", text);
+
+	for (int i = 0; i < count; i++) {
+		metrics_begin(&m, workload_name(steps[i].kind), i);
+		workload_run(&steps[i], &m);
+
+		/* link and idle change conditions, they have nothing to report */
+		if (steps[i].kind != STEP_LINK && steps[i].kind != STEP_IDLE) {
+			metrics_report(&m, device);
+		}
+		ops += m.ops;
+		failed += m.failed;
+	}
+
+	TimerService::Stats timers;
+
+	TimerService::getInstance().getStats(timers);
+	printk("FLEET device=%u uptime_ms=%u ops=%u timer_wakeups=%u timers_fired=%u "
+	       "cascaded=%u\n",
+	       device, (uint32_t)k_uptime_get(), ops, timers.wakeups, timers.fired,
+	       timers.cascaded);
+	printk("FLEET device=%u done failed=%u\n", device, failed);
+
+	fleet_exit(failed ? 1 : 0);
+	return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "metrics.h"
+
+void metrics_begin(struct step_metrics *m, const char *name, uint32_t index)
+{
+	memset(m, 0, sizeof(*m));
+	m->name = name;
+	m->index = index;
+	m->start_ms = k_uptime_get();
+}
+
+static uint8_t bucket_of(uint32_t ms)
+{
+	uint8_t bucket = 0;
+
+	while (ms && bucket < HIST_BUCKETS - 1) {
+		ms >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+void metrics_record(struct step_metrics *m, uint32_t latency_ms)
+{
+	m->ops++;
+	m->hist[bucket_of(latency_ms)]++;
+	if (latency_ms > m->max_ms) {
+		m->max_ms = latency_ms;
+	}
+}
+
+void metrics_fail(struct step_metrics *m)
+{
+	m->ops++;
+	m->failed++;
+}
+
+void metrics_extra(struct step_metrics *m, const char *key, uint32_t value)
+{
+	size_t used = strlen(m->extra);
+
+	snprintf(m->extra + used, sizeof(m->extra) - used, " %s=%u", key, value);
+}
+
+uint32_t metrics_percentile(const struct step_metrics *m, uint32_t pct)
+{
+	uint32_t done = m->ops - m->failed;
+	uint32_t rank = (done * pct + 99) / 100;
+	uint32_t seen = 0;
+
+	if (done == 0) {
+		return 0;
+	}
+
+	for (uint8_t b = 0; b < HIST_BUCKETS; b++) {
+		seen += m->hist[b];
+		if (seen >= rank) {
+			uint32_t upper = b ? (1U << b) - 1 : 0;
+
+			return MIN(upper, m->max_ms);
+		}
+	}
+	return m->max_ms;
+}
+
+void metrics_report(const struct step_metrics *m, uint32_t device)
+{
+	uint32_t elapsed = (uint32_t)(k_uptime_get() - m->start_ms);
+	uint32_t rate = elapsed ? (uint32_t)((uint64_t)m->ops * 1000 / elapsed) : 0;
+	char hist[HIST_BUCKETS * 11];
+	size_t used = 0;
+
+	for (uint8_t b = 0; b < HIST_BUCKETS; b++) {
+		used += snprintf(hist + used, sizeof(hist) - used, "%s%u", b ? "," : "", m->hist[b]);
+	}
+
+	printk("FLEET device=%u index=%u step=%s ops=%u failed=%u elapsed_ms=%u ops_per_s=%u "
+	       "p50_ms=%u p99_ms=%u max_ms=%u hist=%s%s\n",
+	       device, m->index, m->name, m->ops, m->failed, elapsed, rate,
+	       metrics_percentile(m, 50), metrics_percentile(m, 99), m->max_ms, hist, m->extra);
+}
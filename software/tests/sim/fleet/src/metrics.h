@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Per-step metrics of the fleet runner
+ *
+ * Latencies go into log2 buckets of simulated milliseconds (bucket 0 is
+ * 0 ms, bucket k is 2^(k-1)..2^k - 1 ms), so the histograms of a whole
+ * fleet add up bucket by bucket in scripts/fleet_sim.py. One FLEET line
+ * per step:
+ *
+ *   FLEET device=3 index=1 step=toggle ops=400 failed=0 elapsed_ms=8000
+ *         ops_per_s=50 p50_ms=255 p99_ms=500 max_ms=500 hist=0,...,0 <extra>
+ */
+
+#ifndef FLEET_METRICS_H
+#define FLEET_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HIST_BUCKETS 16
+#define EXTRA_LEN 160
+
+struct step_metrics {
+	const char *name;
+	uint32_t index;
+	uint32_t ops;
+	uint32_t failed;
+	uint32_t max_ms;
+	uint32_t hist[HIST_BUCKETS];
+	int64_t start_ms;
+	char extra[EXTRA_LEN];      /* key=value pairs of the workload */
+};
+
+void metrics_begin(struct step_metrics *m, const char *name, uint32_t index);
+
+/* One operation done, in latency_ms */
+void metrics_record(struct step_metrics *m, uint32_t latency_ms);
+
+/* One operation failed, it has no latency */
+void metrics_fail(struct step_metrics *m);
+
+/* Append key=value to the step's line */
+void metrics_extra(struct step_metrics *m, const char *key, uint32_t value);
+
+/* Upper bound of the bucket holding the pct percentile, capped at max_ms */
+uint32_t metrics_percentile(const struct step_metrics *m, uint32_t pct);
+
+void metrics_report(const struct step_metrics *m, uint32_t device);
+
+#endif /* FLEET_METRICS_H */
@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "workloads.h"
+#include "device.h"
+#include "ble/ble_manager.hpp"
+#include "matter/commission/commissioning_delegate.hpp"
+#include "matter/light_endpoint/light_groups.hpp"
+#include "thread/network_resilience_manager.hpp"
+#include "timer/timer_wheel.hpp"
+
+using namespace smarthome::ipc;
+using namespace smarthome::protocol::matter;
+using smarthome::protocol::ble::BLEManager;
+using smarthome::protocol::thread::NetworkHealth;
+using smarthome::protocol::thread::NetworkResilienceManager;
+using smarthome::services::timer::TimerService;
+
+static const struct {
+	const char *name;
+	enum step_kind kind;
+	uint32_t arg[2];            /* Defaults */
+} workloads[] = {
+	{ "link", STEP_LINK, { 0, 0 } },
+	{ "idle", STEP_IDLE, { 0, 0 } },
+	{ "ipc", STEP_IPC, { 0, 0 } },
+	{ "burst", STEP_BURST, { 0, 0 } },
+	{ "commission", STEP_COMMISSION, { 0, 0 } },
+	{ "toggle", STEP_TOGGLE, { 5, 0 } },
+	{ "flap", STEP_FLAP, { 100, 0 } },
+	{ "reboot", STEP_REBOOT, { 500, 0 } },
+};
+
+/* Request timeouts, well above any link latency a script sets */
+#define REPLY_TIMEOUT_MS 500
+#define POLL_PERIOD_MS 50
+#define RECOVERY_TIMEOUT_MS 2000
+
+static struct k_sem disconnect_sem;
+static atomic_t health_changes;
+
+static void on_disconnect(void)
+{
+	k_sem_give(&disconnect_sem);
+}
+
+static void on_health(NetworkHealth health)
+{
+	atomic_inc(&health_changes);
+}
+
+static void net_ble_connect(void)
+{
+	BLEManager::getInstance().onConnectionChanged(true);
+}
+
+static void net_ble_disconnect(void)
+{
+	BLEManager::getInstance().onConnectionChanged(false);
+}
+
+/*=============================================================================
+ * Script
+ *===========================================================================*/
+
+static int parse_number(const char **p, uint32_t *out)
+{
+	char *end;
+	unsigned long value = strtoul(*p, &end, 10);
+
+	if (end == *p) {
+		return -EINVAL;
+	}
+	*out = (uint32_t)value;
+	*p = end;
+	return 0;
+}
+
+int workload_parse(const char *text, struct step *out)
+{
+	const char *colon = strchr(text, ':');
+	const char *p;
+	size_t len;
+
+	if (!colon) {
+		return -EINVAL;
+	}
+	len = colon - text;
+
+	memset(out, 0, sizeof(*out));
+	for (size_t i = 0; i < ARRAY_SIZE(workloads); i++) {
+		if (strlen(workloads[i].name) == len && !strncmp(text, workloads[i].name, len)) {
+			out->kind = workloads[i].kind;
+			out->arg[0] = workloads[i].arg[0];
+			out->arg[1] = workloads[i].arg[1];
+			p = colon + 1;
+
+			if (parse_number(&p, &out->count)) {
+				return -EINVAL;
+			}
+			if (*p == '@') {
+				p++;
+				if (parse_number(&p, &out->rate_hz) || out->rate_hz == 0) {
+					return -EINVAL;
+				}
+			}
+			for (int a = 0; a < 2 && *p == '/'; a++) {
+				p++;
+				if (parse_number(&p, &out->arg[a])) {
+					return -EINVAL;
+				}
+			}
+			return (*p == '\0' || *p == ';') ? 0 : -EINVAL;
+		}
+	}
+	return -EINVAL;
+}
+
+const char *workload_name(enum step_kind kind)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(workloads); i++) {
+		if (workloads[i].kind == kind) {
+			return workloads[i].name;
+		}
+	}
+	return "?";
+}
+
+void workloads_init(void)
+{
+	NetworkResilienceManager &mgr = NetworkResilienceManager::getInstance();
+
+	k_sem_init(&disconnect_sem, 0, K_SEM_MAX_LIMIT);
+	mgr.setDisconnectCallback(on_disconnect);
+	mgr.setHealthCallback(on_health);
+	mgr.onLinkUp();
+}
+
+/*=============================================================================
+ * Pacing
+ *===========================================================================*/
+
+/*
+ * Wait for slot i of a step started at start. Returns true when the slot
+ * had already passed by a whole period: the device can not keep the rate.
+ */
+static bool pace(int64_t start, uint32_t i, uint32_t rate_hz)
+{
+	if (!rate_hz) {
+		return false;
+	}
+
+	int64_t due = start + (int64_t)i * 1000 / rate_hz;
+	int64_t wait = due - k_uptime_get();
+
+	if (wait > 0) {
+		k_sleep(K_MSEC(wait));
+	}
+	return -wait >= 1000 / rate_hz;
+}
+
+static Message radio_tx(void)
+{
+	Message msg = MessageBuilder(MessageType::RADIO_TX).build();
+
+	msg.payload.radio.channel = 15;
+	msg.payload.radio.data_len = 4;
+	return msg;
+}
+
+/* IPC counters of both cores, reset per step */
+static void ipc_reset(void)
+{
+	IPCCore::getInstance(Core::APP).resetStats();
+	IPCCore::getInstance(Core::NET).resetStats();
+	device_app_end().resetStats();
+	device_net_end().resetStats();
+}
+
+static void ipc_extra(struct step_metrics *m)
+{
+	const IPCCore::Statistics &app = IPCCore::getInstance(Core::APP).getStats();
+	const IPCCore::Statistics &net = IPCCore::getInstance(Core::NET).getStats();
+
+	metrics_extra(m, "app_rx_peak", app.rx_queue_peak);
+	metrics_extra(m, "net_rx_peak", net.rx_queue_peak);
+	metrics_extra(m, "dropped", app.dropped_messages + net.dropped_messages);
+	metrics_extra(m, "busy", device_app_end().getStats().busy + device_net_end().getStats().busy);
+	metrics_extra(m, "lost", device_app_end().getStats().lost + device_net_end().getStats().lost);
+	metrics_extra(m, "outages", app.link_outages + net.link_outages);
+}
+
+/*=============================================================================
+ * Workloads
+ *===========================================================================*/
+
+static void run_ipc(const struct step *s, struct step_metrics *m)
+{
+	IPCCore &app = IPCCore::getInstance();
+	int64_t start = k_uptime_get();
+	uint32_t late = 0;
+
+	ipc_reset();
+	for (uint32_t i = 0; i < s->count; i++) {
+		late += pace(start, i, s->rate_hz);
+
+		int64_t t0 = k_uptime_get();
+
+		if (app.sendSync(radio_tx(), REPLY_TIMEOUT_MS) == 0) {
+			metrics_record(m, (uint32_t)(k_uptime_get() - t0));
+		} else {
+			metrics_fail(m);
+		}
+	}
+	metrics_extra(m, "late", late);
+	ipc_extra(m);
+}
+
+static void run_burst(const struct step *s, struct step_metrics *m)
+{
+	IPCCore &app = IPCCore::getInstance();
+	int64_t t0 = k_uptime_get();
+	uint32_t sent = 0;
+	uint32_t refused = 0;
+	Message rsp;
+
+	ipc_reset();
+	device_purge();
+
+	/* No waiting between requests, as a burst of events on the APP core */
+	for (uint32_t i = 0; i < s->count; i++) {
+		if (app.send(MessageBuilder(MessageType::STATUS_REQUEST).build()) == 0) {
+			sent++;
+		} else {
+			refused++;
+			metrics_fail(m);
+		}
+	}
+
+	for (uint32_t i = 0; i < sent; i++) {
+		if (device_expect(MessageType::STATUS_RESPONSE, &rsp, REPLY_TIMEOUT_MS) == 0) {
+			metrics_record(m, (uint32_t)(k_uptime_get() - t0));
+		} else {
+			metrics_fail(m);
+		}
+	}
+	metrics_extra(m, "refused", refused);
+	ipc_extra(m);
+}
+
+static void run_commission(const struct step *s, struct step_metrics *m)
+{
+	CommissioningDelegate &delegate = CommissioningDelegate::getInstance();
+	int64_t start = k_uptime_get();
+	uint32_t late = 0;
+	Message msg;
+
+	ipc_reset();
+	for (uint32_t i = 0; i < s->count; i++) {
+		late += pace(start, i, s->rate_hz);
+		device_purge();
+
+		int64_t t0 = k_uptime_get();
+		bool ok = delegate.openCommissioningWindow(60) == 0 &&
+			  device_expect(MessageType::ACK, &msg, REPLY_TIMEOUT_MS) == 0 &&
+			  device_net_run(net_ble_connect) == 0 &&
+			  device_expect(MessageType::BLE_CONNECT, &msg, REPLY_TIMEOUT_MS) == 0;
+		uint32_t latency = (uint32_t)(k_uptime_get() - t0);
+
+		(void)device_net_run(net_ble_disconnect);
+		ok = delegate.closeCommissioningWindow() == 0 &&
+		     device_expect(MessageType::ACK, &msg, REPLY_TIMEOUT_MS) == 0 && ok;
+
+		if (ok) {
+			metrics_record(m, latency);
+		} else {
+			metrics_fail(m);
+		}
+	}
+	metrics_extra(m, "late", late);
+	ipc_extra(m);
+}
+
+/*
+ * Latency of a group command: arrival to the last output update of its
+ * transition. A command still transitioning when the next one arrives is
+ * preempted - under a storm the lights never settle.
+ */
+static void run_toggle(const struct step *s, struct step_metrics *m)
+{
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightGroups &groups = LightGroups::getInstance();
+	TimerService::Stats before, now;
+	LightGroups::LatencyStats latency;
+	uint32_t updates = device_output_updates();
+	int64_t start = k_uptime_get();
+	int64_t cmd_ms = -1;
+	uint32_t preempted = 0;
+	uint32_t armed_peak = 0;
+	uint32_t late = 0;
+
+	TimerService::getInstance().getStats(before);
+	groups.resetLatency();
+
+	for (uint32_t i = 0; i <= s->count; i++) {
+		if (i < s->count) {
+			late += pace(start, i, s->rate_hz);
+		} else {
+			/* Let the last transition finish */
+			k_sleep(K_MSEC(s->arg[0] * 100 + POLL_PERIOD_MS));
+		}
+
+		if (cmd_ms >= 0) {
+			if (lights.inTransition(LIGHT_ENDPOINT_ID)) {
+				preempted++;
+				metrics_fail(m);
+			} else {
+				metrics_record(m, (uint32_t)MAX(device_last_output_ms() - cmd_ms, 0));
+			}
+		}
+		if (i == s->count) {
+			break;
+		}
+
+		ClusterCommand cmd = {};
+
+		if (i & 1) {
+			cmd.cluster_id = LEVEL_CONTROL_CLUSTER_ID;
+			cmd.command_id = LightCommand::MOVE_TO_LEVEL_WITH_ON_OFF;
+			cmd.level = (uint8_t)(1 + (i * 37) % 254);
+			cmd.transition_time = (uint16_t)s->arg[0];
+		} else {
+			cmd.cluster_id = ON_OFF_CLUSTER_ID;
+			cmd.command_id = LightCommand::TOGGLE;
+		}
+
+		cmd_ms = k_uptime_get();
+		if (groups.onGroupCommand(FLEET_GROUP, cmd, k_cycle_get_32()) < 0) {
+			cmd_ms = -1;
+			metrics_fail(m);
+		}
+
+		TimerService::getInstance().getStats(now);
+		armed_peak = MAX(armed_peak, now.armed);
+	}
+
+	TimerService::getInstance().getStats(now);
+	groups.getLatency(latency);
+	metrics_extra(m, "preempted", preempted);
+	metrics_extra(m, "late", late);
+	metrics_extra(m, "updates", device_output_updates() - updates);
+	metrics_extra(m, "timer_wakeups", now.wakeups - before.wakeups);
+	metrics_extra(m, "timers_fired", now.fired - before.fired);
+	metrics_extra(m, "armed_peak", armed_peak);
+	metrics_extra(m, "dispatch_max_us", latency.max_us);
+}
+
+/* Latency: link down to the disconnect callback on the work queue */
+static void run_flap(const struct step *s, struct step_metrics *m)
+{
+	NetworkResilienceManager &mgr = NetworkResilienceManager::getInstance();
+	uint16_t disconnects = mgr.getDisconnectCount();
+	uint32_t health = (uint32_t)atomic_get(&health_changes);
+	int64_t start = k_uptime_get();
+	uint32_t late = 0;
+
+	k_sem_reset(&disconnect_sem);
+	for (uint32_t i = 0; i < s->count; i++) {
+		late += pace(start, i, s->rate_hz);
+
+		int64_t t0 = k_uptime_get();
+
+		mgr.onLinkDown();
+		if (k_sem_take(&disconnect_sem, K_MSEC(REPLY_TIMEOUT_MS)) == 0) {
+			metrics_record(m, (uint32_t)(k_uptime_get() - t0));
+		} else {
+			metrics_fail(m);
+		}
+
+		int64_t up = t0 + s->arg[0] - k_uptime_get();
+
+		if (up > 0) {
+			k_sleep(K_MSEC(up));
+		}
+		mgr.onLinkUp();
+	}
+
+	metrics_extra(m, "disconnects", (uint16_t)(mgr.getDisconnectCount() - disconnects));
+	metrics_extra(m, "health_changes", (uint32_t)atomic_get(&health_changes) - health);
+	metrics_extra(m, "late", late);
+}
+
+/*
+ * The NET core is gone for the down time (every frame lost both ways)
+ * while the APP core restarts its lights from storage and keeps polling.
+ * Latency: link back to the first exchange that succeeds.
+ */
+static void run_reboot(const struct step *s, struct step_metrics *m)
+{
+	IPCCore &app = IPCCore::getInstance();
+	LightEndpoints &lights = LightEndpoints::getInstance();
+	LightGroups &groups = LightGroups::getInstance();
+	uint32_t missed = 0;
+	uint32_t restored = 0;
+
+	ipc_reset();
+	for (uint32_t i = 0; i < s->count; i++) {
+		int64_t t0 = k_uptime_get();
+		bool ok = true;
+
+		device_blackout(true);
+
+		lights.flush();
+		int ret = lights.init();
+
+		if (ret >= 0) {
+			restored += ret;
+		}
+		ok = ret >= 0 && groups.init() >= 0 &&
+		     groups.getMembers(FLEET_GROUP) == LightEndpoints::ALL;
+
+		while (k_uptime_get() - t0 < s->arg[0]) {
+			int err = app.sendSync(radio_tx(), POLL_PERIOD_MS);
+
+			if (err != 0) {
+				missed++;
+			}
+			/* Link taken down by the heartbeat: fails at once */
+			if (err == -ENOTCONN) {
+				k_sleep(K_MSEC(POLL_PERIOD_MS));
+			}
+		}
+
+		device_blackout(false);
+
+		int64_t back = k_uptime_get();
+		bool recovered = false;
+
+		while (k_uptime_get() - back < RECOVERY_TIMEOUT_MS) {
+			int err = app.sendSync(radio_tx(), POLL_PERIOD_MS);
+
+			if (err == 0) {
+				recovered = true;
+				break;
+			}
+			if (err == -ENOTCONN) {
+				k_sleep(K_MSEC(POLL_PERIOD_MS));
+			}
+		}
+
+		if (ok && recovered) {
+			metrics_record(m, (uint32_t)(k_uptime_get() - back));
+		} else {
+			metrics_fail(m);
+		}
+	}
+	metrics_extra(m, "missed_polls", missed);
+	metrics_extra(m, "restored", restored);
+	ipc_extra(m);
+}
+
+void workload_run(const struct step *s, struct step_metrics *m)
+{
+	switch (s->kind) {
+	case STEP_LINK:
+		device_link(s->count, s->arg[0], (uint16_t)MIN(s->arg[1], 1000));
+		break;
+	case STEP_IDLE:
+		k_sleep(K_MSEC(s->count));
+		break;
+	case STEP_IPC:
+		run_ipc(s, m);
+		break;
+	case STEP_BURST:
+		run_burst(s, m);
+		break;
+	case STEP_COMMISSION:
+		run_commission(s, m);
+		break;
+	case STEP_TOGGLE:
+		run_toggle(s, m);
+		break;
+	case STEP_FLAP:
+		run_flap(s, m);
+		break;
+	case STEP_REBOOT:
+		run_reboot(s, m);
+		break;
+	}
+}
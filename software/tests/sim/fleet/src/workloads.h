@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Sprchuoi
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file Scripted workloads of the fleet runner
+ *
+ * A script is a list of steps separated by ';':
+ *
+ *   link:<latency>/<jitter>/<loss>  IPC link of both directions (ms, ms, permille)
+ *   idle:<ms>                       let timers and transitions run
+ *   ipc:<n>@<hz>                    RADIO_TX exchanges (sendSync), round trip latency
+ *   burst:<n>                       n STATUS_REQUESTs back to back, then the
+ *                                   responses - finds the queue depth limits
+ *   commission:<n>                  open the window, BLE connect on NET, close
+ *   toggle:<n>@<hz>/<tenths>        group Toggle / MoveToLevelWithOnOff with a
+ *                                   transition, alternating - timer load
+ *   flap:<n>@<hz>/<down ms>         Thread link down and up
+ *   reboot:<n>/<down ms>            NET core gone for down ms while the APP core
+ *                                   restarts its lights, then link recovery
+ *
+ * Without @<hz> operations run back to back.
+ */
+
+#ifndef FLEET_WORKLOADS_H
+#define FLEET_WORKLOADS_H
+
+#include <stdint.h>
+
+#include "metrics.h"
+
+enum step_kind {
+	STEP_LINK,
+	STEP_IDLE,
+	STEP_IPC,
+	STEP_BURST,
+	STEP_COMMISSION,
+	STEP_TOGGLE,
+	STEP_FLAP,
+	STEP_REBOOT,
+};
+
+struct step {
+	enum step_kind kind;
+	uint32_t count;             /* Operations, or the first argument */
+	uint32_t rate_hz;           /* 0 = back to back */
+	uint32_t arg[2];            /* After '/' */
+};
+
+/**
+ * Parse one step
+ *
+ * @param text Step text, up to ';' or the end
+ * @return 0 on success, -EINVAL for an unknown workload or bad numbers
+ */
+int workload_parse(const char *text, struct step *out);
+
+const char *workload_name(enum step_kind kind);
+
+/* Set up what the workloads hook into, once after device_boot() */
+void workloads_init(void);
+
+/* Run a step, its results in m (metrics_begin() done by the caller) */
+void workload_run(const struct step *s, struct step_metrics *m);
+
+#endif /* FLEET_WORKLOADS_H */